@@ -6,17 +6,36 @@
 #include "power.h"
 #include "wifi_manager.h"
 #include "mqtt_client.h"
+#include "mqtt_stream.h"
 #include "net.h"
 #include "system_manager.h"
 #include "state_manager.h"
 #include "metrics_diagnostics.h"
 #include "display_manager.h"
+#include "render_model.h"
 #include "crash_handler.h"
 #include "memory_tracking.h"
+#include "buffer_pool.h"
+#include "wake_arena.h"
+#include "rtc_state.h"
 #include "mqtt_batcher.h"
 #include "profiling.h"
+#include "wake_timeline.h"
+#include "energy_meter.h"
+#include "publish_policy.h"
+#include "topic_table.h"
+#include "telemetry_frame.h"
+#include "ulp_sampler.h"
+#include "cpu_freq.h"
+#include "idle_sleep.h"
+#include "ota_update.h"
+#include "espnow_link.h"
+#include "inside_stats.h"
+#include "phase_deadline.h"
 #include <ESPmDNS.h>
 #include <esp_task_wdt.h>  // Hardware watchdog
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 // Diagnostic test functions (from diagnostic_test.cpp)
 extern void diagnostic_test_init();
@@ -26,10 +45,299 @@ extern void show_boot_stage(int stage);
 // Track wake time for phase management  
 static uint32_t g_wake_time_ms = 0;
 
+// This wake's inside readings (NAN if the sensor phase failed)
+static InsideReadings g_wake_readings;
+
+// This wake's fuel gauge reading, taken once at boot
+static BatteryStatus g_wake_battery;
+
+#if USE_DISPLAY
+static bool g_display_initialized = false;
+#endif
+
+// Retained outside-data fetch time, published once the display is started
+static uint32_t g_retained_fetch_ms = 0;
+
+// Per-phase deadlines inside the wake budget (phase_deadline.h)
+static PhaseDeadline g_deadline;
+
 // Diagnostic mode tracking
 static uint32_t g_diagnostic_last_publish_ms = 0;
 #define DIAGNOSTIC_PUBLISH_INTERVAL_MS 30000
 
+// Boot fast path: timer (and ULP) wakes of a production build skip the
+// serial settle delays unless a USB host is attached, the status LED and
+// mDNS. Power-on, button wakes and dev/debug builds keep the slow path.
+static bool g_fast_boot = false;
+
+static bool choose_fast_boot() {
+  #if DEV_NO_SLEEP || defined(BOOT_DEBUG)
+  return false;
+  #else
+  if (esp_reset_reason() != ESP_RST_DEEPSLEEP || is_diagnostic_mode_active()) return false;
+  esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+  return cause == ESP_SLEEP_WAKEUP_TIMER || cause == ESP_SLEEP_WAKEUP_ULP;
+  #endif
+}
+
+static void boot_stage(int stage) {
+  if (!g_fast_boot) show_boot_stage(stage);
+}
+
+#if FEATURE_PIPELINED_BOOT
+// Background sensor task: runs while the main task waits on WiFi association.
+// The radio is idle-waiting most of that time, so the I2C init and forced
+// measurement overlap it even on the single-core S2.
+// The task is never deleted from outside: it may be inside a Wire call that
+// holds the bus mutex, which FreeRTOS would not release. A late join sets
+// g_pipeline_cancel instead and the task exits between transactions.
+static InsideReadings g_pipeline_readings;
+static SemaphoreHandle_t g_pipeline_done = nullptr;
+static volatile bool g_pipeline_cancel = false;
+static bool g_pipeline_abandoned = false;   // Still on the bus; skip sleep-path I2C
+
+static void sensor_pipeline_task(void* arg) {
+  (void)arg;
+  sensors_begin();
+  if (!g_pipeline_cancel) {
+    g_pipeline_readings = read_sensors_with_timeout(SENSOR_PHASE_TIMEOUT_MS, &g_pipeline_cancel);
+  }
+  xSemaphoreGive(g_pipeline_done);
+  vTaskDelete(nullptr);
+}
+
+// Wait for the sensor task; on a late join ask it to stop and wait for it to
+// exit. Returns true when it delivered readings in time.
+static bool join_sensor_pipeline() {
+  if (xSemaphoreTake(g_pipeline_done, pdMS_TO_TICKS(SENSOR_PIPELINE_JOIN_TIMEOUT_MS)) == pdTRUE) {
+    vSemaphoreDelete(g_pipeline_done);
+    g_pipeline_done = nullptr;
+    return true;
+  }
+  g_pipeline_cancel = true;
+  if (xSemaphoreTake(g_pipeline_done, pdMS_TO_TICKS(SENSOR_PIPELINE_STOP_TIMEOUT_MS)) == pdTRUE) {
+    vSemaphoreDelete(g_pipeline_done);
+  } else {
+    // Wedged inside a transaction: leave it the semaphore and keep off the bus
+    g_pipeline_abandoned = true;
+  }
+  g_pipeline_done = nullptr;
+  return false;
+}
+
+// Start the sensor task; returns false if it could not be created
+static bool start_sensor_pipeline() {
+  g_pipeline_done = xSemaphoreCreateBinary();
+  if (!g_pipeline_done) return false;
+
+  BaseType_t ok = xTaskCreate(sensor_pipeline_task, "sensor_pipe", 4096, nullptr,
+                              tskIDLE_PRIORITY + 1, nullptr);
+  if (ok != pdPASS) {
+    vSemaphoreDelete(g_pipeline_done);
+    g_pipeline_done = nullptr;
+    return false;
+  }
+  return true;
+}
+#endif
+
+// Puts the fuel gauge to sleep unless an abandoned sensor task may still hold
+// the Wire mutex, where any I2C call would block until the watchdog fires
+static void prepare_power_for_sleep() {
+  #if FEATURE_PIPELINED_BOOT
+  if (g_pipeline_abandoned) {
+    Serial.println("[Pipeline] Sensor task still on I2C, skipping fuel gauge sleep");
+    return;
+  }
+  #endif
+  power_prepare_sleep();
+}
+
+#if STORE_FORWARD_WAKES > 1 && !(FEATURE_SKIP_UNCHANGED_WAKES && FEATURE_OFFLINE_QUEUE)
+  #error "STORE_FORWARD_WAKES requires FEATURE_SKIP_UNCHANGED_WAKES and FEATURE_OFFLINE_QUEUE"
+#endif
+
+#if FEATURE_OFFLINE_QUEUE
+static bool g_wake_sample_queued = false;
+
+// Add this wake's reading to the RTC history ring (at most once per wake)
+static void queue_wake_sample(const InsideReadings& r) {
+  if (g_wake_sample_queued) return;
+
+  OfflineSample sample = { (uint32_t)time(nullptr), r.temperatureC, r.humidityPct,
+                           r.pressureHPa, isfinite(r.temperatureC),
+                           isfinite(r.humidityPct), isfinite(r.pressureHPa) };
+  if (!sample.hasTemp && !sample.hasRh && !sample.hasPressure) return;
+
+  OfflineQueue::getInstance().push(sample);
+  g_wake_sample_queued = true;
+  Serial.printf("Queued sample (%u pending)\n", (unsigned)OfflineQueue::getInstance().size());
+}
+#endif
+
+static void enter_phase(WakePhase phase, uint32_t budget_ms) {
+  phase_deadline_enter(g_deadline, phase, budget_ms, millis());
+}
+
+// End of a phase (or of one of its blocking steps): count a first overrun;
+// true once the wake is degraded
+static bool phase_overran() {
+  if (phase_deadline_check(g_deadline, millis())) {
+    increment_error_stat("phase_overrun");
+    Serial.printf("[Deadline] %s phase overran (%lu ms into the wake) - degrading\n",
+                  wake_phase_name(g_deadline.phase),
+                  (unsigned long)(millis() - g_deadline.wake_start_ms));
+  }
+  return phase_deadline_degraded(g_deadline);
+}
+
+// Degraded wake: no retained fetch, display or further publishes. A sample
+// not published yet is kept for replay, then straight to deep sleep.
+static void run_degraded_wake(bool sample_published) {
+  Serial.println("[Deadline] Degraded wake - going to sleep");
+  #if FEATURE_OFFLINE_QUEUE
+  if (!sample_published) queue_wake_sample(g_wake_readings);
+  #endif
+  (void)sample_published;
+  run_sleep_phase();
+}
+
+#if FEATURE_SKIP_UNCHANGED_WAKES
+// Readings taken before WiFi to decide whether this wake needs the radio
+static InsideReadings g_early_readings;
+static bool g_have_early_readings = false;
+
+// Only plain timer wakes may skip; first boot, button wakes and dev/diag
+// modes always connect
+static bool skip_policy_applies() {
+  #if DEV_NO_SLEEP
+  return false;
+  #else
+  if (is_diagnostic_mode_active()) return false;
+  #if FEATURE_OTA_DELTA
+  // An update in flight (or a new image to confirm) needs the broker
+  if (ota_update_in_progress()) return false;
+  #endif
+  return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+  #endif
+}
+
+// Read sensors and compare against the last transmitted snapshot
+// Returns true if this wake can go back to sleep without networking
+static bool evaluate_skip_network() {
+  CPU_PHASE(SENSOR);
+  #if FEATURE_ULP_SAMPLING
+  if (!ulp_sampler_take(g_early_readings))
+  #endif
+  {
+    sensors_init_all();
+    g_early_readings = read_sensors_with_timeout(SENSOR_PHASE_TIMEOUT_MS);
+  }
+  g_have_early_readings = true;
+
+  PublishSnapshot last_tx = { get_last_tx_inside_tempC(), get_last_tx_inside_rh(),
+                              get_last_tx_inside_pressureHPa() };
+  PublishSnapshot now = { g_early_readings.temperatureC, g_early_readings.humidityPct,
+                          g_early_readings.pressureHPa };
+  uint32_t since_tx = get_sec_since_last_tx();
+
+  PublishDecision d = evaluate_publish_policy(get_publish_policy(), last_tx, now, since_tx);
+  Serial.printf("[Skip] Decision: %s (%lu s since last publish)\n",
+                publish_decision_str(d), (unsigned long)since_tx);
+
+  #if STORE_FORWARD_WAKES > 1
+  // Store-and-forward: every sample goes to the history ring; the radio only
+  // comes up every Nth wake or when a reading leaves its deadband
+  queue_wake_sample(g_early_readings);
+  uint32_t wake_n = (uint32_t)get_wakes_since_last_tx() + 1;
+  Serial.printf("[Skip] Store-and-forward: wake %lu/%u, %u samples held\n",
+                (unsigned long)wake_n, (unsigned)STORE_FORWARD_WAKES,
+                (unsigned)OfflineQueue::getInstance().size());
+  return store_forward_skip(d, wake_n, STORE_FORWARD_WAKES);
+  #else
+  return d == PublishDecision::SKIP;
+  #endif
+}
+#endif
+
+// Sensor readings for this wake: the ULP's newest sample if it sampled
+// through the sleep, else joins the pipeline task if one was started,
+// otherwise reads synchronously
+static InsideReadings acquire_inside_readings() {
+  #if FEATURE_SKIP_UNCHANGED_WAKES
+  if (g_have_early_readings) {
+    g_have_early_readings = false;
+    return g_early_readings;
+  }
+  #endif
+  #if FEATURE_ULP_SAMPLING
+  InsideReadings ulp;
+  if (ulp_sampler_take(ulp)) return ulp;
+  #endif
+  #if FEATURE_PIPELINED_BOOT
+  if (g_pipeline_done) {
+    if (join_sensor_pipeline()) return g_pipeline_readings;
+    Serial.println("[Pipeline] Sensor task did not finish in time");
+    return InsideReadings();
+  }
+  #endif
+  return read_sensors_with_timeout(SENSOR_PHASE_TIMEOUT_MS);
+}
+
+// True if the skip-unchanged check already initialized and read the sensors
+static bool have_early_readings() {
+  #if FEATURE_SKIP_UNCHANGED_WAKES
+  return g_have_early_readings;
+  #else
+  return false;
+  #endif
+}
+
+// True if the ULP sampled through the sleep and its sample is waiting
+static bool ulp_sample_waiting() {
+  #if FEATURE_ULP_SAMPLING
+  return ulp_sampler_pending();
+  #else
+  return false;
+  #endif
+}
+
+static bool try_start_sensor_pipeline() {
+  #if FEATURE_PIPELINED_BOOT
+  return start_sensor_pipeline();
+  #else
+  return false;
+  #endif
+}
+
+// Leaves the sensors ready for acquire_inside_readings(): nothing to do when
+// readings are already in hand or the ULP has one, else the pipeline task
+// when allowed (it overlaps WiFi association), else a synchronous init
+static void ensure_sensors_ready(bool allow_pipeline) {
+  if (have_early_readings()) {
+    // Already initialized and read by the skip check
+    return;
+  }
+  if (ulp_sample_waiting()) {
+    Serial.println("[5] Using the ULP's last sample (no sensor init)");
+    return;
+  }
+  if (allow_pipeline && try_start_sensor_pipeline()) {
+    Serial.println("[5] Sensor task started (overlapping WiFi association)");
+    return;
+  }
+  Serial.println("[5] Initializing sensors...");
+  Serial.flush();
+  sensors_init_all();
+  // Note: We continue even if some sensors fail
+  // The sensors module will handle individual failures
+  Serial.println("[5] Sensors initialized (check logs for any failures)");
+}
+
+#if ESPNOW_TRANSPORT
+static bool send_espnow_report();
+#endif
+
 uint32_t get_wake_time_ms() {
   return g_wake_time_ms;
 }
@@ -41,13 +349,34 @@ bool is_first_boot() {
 // Main application setup orchestration
 void app_setup() {
   g_wake_time_ms = millis();
+  phase_deadline_begin(g_deadline, g_wake_time_ms, WAKE_BUDGET_MS);
+
+  // Validate RTC state once, before anything reads it
+  rtc_state_begin();
+  CPU_PHASE(BOOT);
+
+  // Local time zone and drift correction for the clock kept through sleep
+  wifi_time_restore();
+
+  // Collect what the ULP sampled while we slept; frees the I2C pins
+  #if FEATURE_ULP_SAMPLING
+  ulp_sampler_wake();
+  #endif
+
+  #if FEATURE_WAKE_TIMELINE
+  WakeTimeline::getInstance().begin();
+  #endif
   
-  // Initialize serial FIRST with longer delay
+  // Initialize serial FIRST; the settle delay is only worth paying when
+  // someone can read the output (USB CDC: a host has the port open)
+  g_fast_boot = choose_fast_boot();
   Serial.begin(115200);
-  delay(500);  // Longer delay for serial stability
+  bool serial_wait = !g_fast_boot || (bool)Serial;
+  if (serial_wait) delay(500);  // Longer delay for serial stability
   
   // Initialize hardware watchdog early (30 second timeout)
-  // This catches hangs in setup - will reboot if setup takes too long
+  // This catches hangs in setup - will reboot if setup takes too long. The
+  // phase deadlines (WAKE_BUDGET_MS) put a normal wake to sleep well before.
   esp_task_wdt_init(30, true);  // 30 sec timeout, panic (reboot) on timeout
   esp_task_wdt_add(NULL);       // Add current task to watchdog
   
@@ -59,16 +388,17 @@ void app_setup() {
   Serial.println("Flags: DEV_NO_SLEEP, FORCE_FULL_ONLY, BOOT_DEBUG");
   #endif
   Serial.flush();
-  delay(10);
-  Serial.println("[BOOT-1] Serial initialized");
+  if (serial_wait) delay(10);
+  Serial.println(g_fast_boot ? "[BOOT-1] Serial initialized (timer-wake fast path)"
+                             : "[BOOT-1] Serial initialized");
   Serial.flush();
-  show_boot_stage(1);  // Red for boot/serial
+  boot_stage(1);  // Red for boot/serial
 
   // Initialize crash handler and memory tracking early
   #if FEATURE_CRASH_HANDLER
   CrashHandler::getInstance().begin();
   // Check for crash info from previous boot
-  if (CrashHandler::getInstance().hasCrashInfo()) {
+  if (!g_fast_boot && CrashHandler::getInstance().hasCrashInfo()) {
     Serial.println("[BOOT-1a] ⚠️  Previous crash detected!");
     char report[256];
     CrashHandler::getInstance().formatCrashReport(report, sizeof(report));
@@ -83,15 +413,17 @@ void app_setup() {
 
   // Show we're alive with neopixel if available
   #ifdef NEOPIXEL_PIN
-  pinMode(NEOPIXEL_PIN, OUTPUT);
-  #ifdef NEOPIXEL_POWER
-  pinMode(NEOPIXEL_POWER, OUTPUT);
-  digitalWrite(NEOPIXEL_POWER, HIGH);
-  #endif
-  // Quick red flash to show boot
-  analogWrite(NEOPIXEL_PIN, 10);
-  delay(100);
-  analogWrite(NEOPIXEL_PIN, 0);
+  if (!g_fast_boot) {
+    pinMode(NEOPIXEL_PIN, OUTPUT);
+    #ifdef NEOPIXEL_POWER
+    pinMode(NEOPIXEL_POWER, OUTPUT);
+    digitalWrite(NEOPIXEL_POWER, HIGH);
+    #endif
+    // Quick red flash to show boot
+    analogWrite(NEOPIXEL_PIN, 10);
+    delay(100);
+    analogWrite(NEOPIXEL_PIN, 0);
+  }
   #endif
   
   Serial.println("[2] Starting initialization");
@@ -106,12 +438,15 @@ void app_setup() {
   #endif
   
   #ifdef BOOT_DEBUG
-  show_boot_stage(2);  // Yellow for display init
+  boot_stage(2);  // Yellow for display init
   #endif
   
-  #if USE_DISPLAY
+  // With unchanged-frame skipping the panel is brought up by the display
+  // phase instead, and only on wakes that draw something
+  #if USE_DISPLAY && (!DISPLAY_SKIP_UNCHANGED_FRAMES || DEV_NO_SLEEP || defined(BOOT_DEBUG))
   Serial.println("[BOOT-2c] Initializing display...");
   display_manager_init();  // This will show "12:34" test pattern in debug mode
+  g_display_initialized = true;
   Serial.println("[BOOT-2c] Display initialized");
   #endif
   
@@ -130,6 +465,7 @@ void app_setup() {
   
   // Check battery status
   BatteryStatus bs = read_battery_status();
+  g_wake_battery = bs;
   Serial.printf("[4] Battery: %d%% (%.2fV)\n", bs.percent, bs.voltage);
   
   // Check for critical battery - properly cleanup before emergency sleep
@@ -137,7 +473,7 @@ void app_setup() {
     Serial.println("Battery critical! Preparing for emergency deep sleep...");
     
     // Prepare hardware for sleep (puts fuel gauge to sleep)
-    power_prepare_sleep();
+    prepare_power_for_sleep();
     
     // Save any cached state to NVS
     nvs_end_cache();
@@ -147,18 +483,51 @@ void app_setup() {
     
     // Sleep for 1 hour to conserve remaining battery
     esp_sleep_enable_timer_wakeup(3600ULL * 1000000ULL);
+    rtc_state_seal();
     esp_deep_sleep_start();
   }
   
   Serial.println("[4] Power management OK");
+
+  // Last outside data seen, so frames drawn before (or without) the
+  // retained fetch still show it
+  bool have_outside_cache = mqtt_restore_outside_cache();
+  (void)have_outside_cache;
   
+  // Skip-network wake: readings within deadband and heartbeat not due, so
+  // update the display from RTC state and sleep without touching the radio
+  #if FEATURE_SKIP_UNCHANGED_WAKES
+  if (skip_policy_applies()) {
+    Serial.println("[5] Sensors read before network (skip check)");
+    if (evaluate_skip_network()) {
+      Serial.println("[5] No publish needed - skipping WiFi/MQTT this wake");
+      run_sensor_phase();
+      #if USE_DISPLAY
+      run_display_phase();
+      #endif
+      run_sleep_phase();
+      return;
+    }
+  }
+  #endif
+
+  // Warm wake with cached outside data: draw now so the waveform runs while
+  // WiFi associates; the display phase after the network phase then only
+  // redraws rects the fresh retained data actually changed
+  bool sensors_done = false;
+  #if USE_DISPLAY && DISPLAY_RENDER_BEFORE_NETWORK && !DEV_NO_SLEEP
+  if (have_outside_cache && !needs_full_refresh_on_boot()) {
+    Serial.println("[5] Drawing from cached outside data before network");
+    ensure_sensors_ready(false);   // Readings are needed now, no overlap
+    run_sensor_phase();
+    run_display_phase();
+    sensors_done = true;
+  }
+  #endif
+
   // Initialize sensors with error checking
-  Serial.println("[5] Initializing sensors...");
-  Serial.flush();
-  sensors_init_all();
-  // Note: We continue even if some sensors fail
-  // The sensors module will handle individual failures
-  Serial.println("[5] Sensors initialized (check logs for any failures)");
+  // Pipelined: init + measurement run on a second task while WiFi associates
+  if (!sensors_done) ensure_sensors_ready(true);
   Serial.flush();
   
   #ifdef BOOT_DEBUG
@@ -170,31 +539,68 @@ void app_setup() {
                 ESP.getFreeHeap(), ESP.getMinFreeHeap());
   #endif
   
+  // Report wake over ESP-NOW: no association, DHCP or broker; without an
+  // ack the wake carries on over WiFi with the readings already taken
+  #if ESPNOW_TRANSPORT
+  if (espnow_link_wake_applies()) {
+    if (!sensors_done) run_sensor_phase();
+    sensors_done = true;
+    if (send_espnow_report()) {
+      #if USE_DISPLAY
+      run_display_phase();
+      #endif
+      run_sleep_phase();
+      return;
+    }
+    Serial.println("[5] ESP-NOW report not acked - falling back to WiFi/MQTT");
+  }
+  #endif
+
+  // Sensors or the early frame already overran: don't start the radio
+  if (sensors_done && phase_deadline_degraded(g_deadline)) {
+    run_degraded_wake(false);
+    return;
+  }
+
   // Initialize network with exponential backoff
+  MEM_PHASE(CONNECT);
+  CPU_PHASE(CONNECT);
+  enter_phase(WakePhase::CONNECT, CONNECT_PHASE_TIMEOUT_MS);
   Serial.println("[BOOT-3] Attempting WiFi connection...");
-  show_boot_stage(3);  // Blue for WiFi
+  boot_stage(3);  // Blue for WiFi
   
-  // Use new exponential backoff connection
-  if (!wifi_connect_with_exponential_backoff(3, 1000)) {  // 3 attempts, 1s initial delay
+  // Use new exponential backoff connection, bounded by the connect deadline
+  uint32_t connect_left = phase_deadline_remaining(g_deadline, millis());
+  if (connect_left == 0 ||
+      !wifi_connect_with_exponential_backoff(3, 1000, connect_left)) {  // 3 attempts, 1s initial delay
     Serial.println("[BOOT-3] WiFi connection failed - continuing anyway");
     // Set time from compile timestamp as fallback (better than epoch)
     wifi_set_time_from_compile();
-    show_boot_stage(5);  // Purple for error
+    boot_stage(5);  // Purple for error
   } else {
+    WAKE_MARK(WIFI_ASSOCIATED);
     Serial.printf("[BOOT-4] WiFi connected - IP: %s, RSSI: %d\n", 
              wifi_get_ip().c_str(), wifi_get_rssi());
-    show_boot_stage(4);  // Green for ready
+    boot_stage(4);  // Green for ready
   }
   
-  // Initialize mDNS for device discovery
-  if (wifi_is_connected()) {
+  // Initialize mDNS for device discovery (once per power-on; timer wakes
+  // are not around long enough to answer queries)
+  bool connect_overran = phase_overran();
+  if (wifi_is_connected() && !g_fast_boot && !connect_overran) {
     // Create mDNS hostname from room name (convert spaces to dashes, lowercase)
-    String hostname = String(ROOM_NAME);
-    hostname.toLowerCase();
-    hostname.replace(" ", "-");
+    ScopedBuffer hostname(sizeof(ROOM_NAME), "mdns_host");
+    if (hostname) {
+      size_t i = 0;
+      for (; ROOM_NAME[i] && i + 1 < hostname.size(); i++) {
+        char c = ROOM_NAME[i];
+        hostname.get()[i] = (c == ' ') ? '-' : (char)tolower((unsigned char)c);
+      }
+      hostname.get()[i] = '\0';
+    }
 
-    if (MDNS.begin(hostname.c_str())) {
-      Serial.printf("[BOOT-4a] mDNS started: %s.local\n", hostname.c_str());
+    if (hostname && MDNS.begin(hostname.get())) {
+      Serial.printf("[BOOT-4a] mDNS started: %s.local\n", hostname.get());
 
       // Add service advertisement for device discovery
       MDNS.addService("espsensor", "tcp", 80);
@@ -208,18 +614,31 @@ void app_setup() {
   }
 
   // Initialize MQTT
-  if (wifi_is_connected()) {
+  if (wifi_is_connected() && !connect_overran) {
     mqtt_begin();
     ensure_mqtt_connected();
+    if (mqtt_is_connected()) {
+      WAKE_MARK(MQTT_CONNECTED);
+    }
   }
+  phase_overran();
   
-  // Run main phases
-  run_sensor_phase();
+  // Run main phases; a phase past its deadline sends the wake to sleep
+  if (!sensors_done) run_sensor_phase();
+  if (phase_deadline_degraded(g_deadline)) {
+    run_degraded_wake(false);
+    return;
+  }
   run_network_phase();
+  if (phase_deadline_degraded(g_deadline)) {
+    run_degraded_wake(true);
+    return;
+  }
   
   #if USE_DISPLAY
   run_display_phase();
   #endif
+  if (!phase_deadline_degraded(g_deadline)) run_deferred_publish_phase();
   
   run_sleep_phase();
 }
@@ -230,8 +649,11 @@ void app_loop() {
   esp_task_wdt_reset();
   
   #if DEV_NO_SLEEP
-  // In always-on mode, just print alive message periodically
+  // In always-on mode, keep the broker session up and print an alive
+  // message periodically; sleep in between (idle_sleep.h)
   static uint32_t last_print = 0;
+  idle_sleep_begin();
+  net_loop();
   if (millis() - last_print > 5000) {
     last_print = millis();
     Serial.print("[ALIVE] Uptime: ");
@@ -239,7 +661,7 @@ void app_loop() {
     Serial.println(" seconds");
     Serial.flush();
   }
-  delay(100);  // Small delay to prevent watchdog issues
+  idle_sleep_wait(5000 - (millis() - last_print));
   return;  // Don't run diagnostic mode logic in DEV_NO_SLEEP
   #endif
   
@@ -253,6 +675,8 @@ void app_loop() {
   
   // In diagnostic mode, stay awake and publish diagnostics periodically
   if (is_diagnostic_mode_active()) {
+    idle_sleep_begin();
+
     // Keep network alive
     net_loop();
     
@@ -324,7 +748,10 @@ void app_loop() {
       }
     }
     
-    delay(100);
+    // Sleep until MQTT or serial input, or the next diagnostics publish
+    uint32_t since_publish = millis() - g_diagnostic_last_publish_ms;
+    idle_sleep_wait(since_publish < DIAGNOSTIC_PUBLISH_INTERVAL_MS
+                        ? DIAGNOSTIC_PUBLISH_INTERVAL_MS - since_publish : 0);
   } else {
     // Normal mode: deep sleep from setup, shouldn't reach here
     delay(1000);
@@ -334,10 +761,15 @@ void app_loop() {
 // Sensor reading phase
 void run_sensor_phase() {
   PROFILE_SCOPE("run_sensor_phase");
+  CRASH_BREADCRUMB("run_sensor_phase");
+  MEM_PHASE(SENSOR);
+  CPU_PHASE(SENSOR);
   Serial.println("=== Sensor Phase ===");
   uint32_t phase_start = millis();
+  enter_phase(WakePhase::SENSOR, SENSOR_PHASE_TIMEOUT_MS + SENSOR_PIPELINE_JOIN_TIMEOUT_MS);
   
-  InsideReadings readings = read_sensors_with_timeout(SENSOR_PHASE_TIMEOUT_MS);
+  InsideReadings readings = acquire_inside_readings();
+  g_wake_readings = readings;
   
   if (isfinite(readings.temperatureC)) {
     Serial.printf("Sensors: %.1f°C, %.1f%% RH, %.1f hPa\n",
@@ -347,114 +779,334 @@ void run_sensor_phase() {
     set_last_published_inside_tempC(readings.temperatureC);
     set_last_published_inside_rh(readings.humidityPct);
     set_last_published_inside_pressureHPa(readings.pressureHPa);
+    #if FEATURE_INSIDE_STATS
+    inside_stats_record(readings);
+    #endif
   }
-  
+
+  WAKE_MARK(SENSOR_READY);
+  phase_overran();
   Serial.printf("Sensor phase took %lu ms\n", millis() - phase_start);
 }
 
 // Network and MQTT publishing phase
+#if MQTT_COMPACT_TELEMETRY || ESPNOW_TRANSPORT
+// This wake's readings and boot timeline as a binary frame (telemetry_frame.h)
+static size_t encode_telemetry_frame(float tempC, float rhPct, float pressHPa,
+                                     const BatteryStatus& bs, int rssiDbm,
+                                     uint8_t* frame, size_t frame_size) {
+  TelemetryValues v;
+  v.tempC = tempC;
+  v.rhPct = rhPct;
+  v.pressHPa = pressHPa;
+  v.batteryV = bs.percent >= 0 ? bs.voltage : NAN;
+  v.batteryPct = bs.percent;
+  v.rssiDbm = rssiDbm;
+  v.wakeCount = get_wake_count();
+  v.sensorMs = 0;
+  v.wifiMs = 0;
+  v.mqttMs = 0;
+  #if FEATURE_WAKE_TIMELINE
+  const WakeTimeline::Record& rec = WakeTimeline::getInstance().getCurrent();
+  v.sensorMs = rec.t_us[WakeTimeline::SENSOR_READY] / 1000;
+  v.wifiMs = rec.t_us[WakeTimeline::WIFI_ASSOCIATED] / 1000;
+  v.mqttMs = rec.t_us[WakeTimeline::MQTT_CONNECTED] / 1000;
+  #endif
+
+  return telemetry_encode(v, frame, frame_size);
+}
+#endif
+
+#if MQTT_COMPACT_TELEMETRY
+static void publish_telemetry_frame(PubSubClient* client, float tempC, float rhPct,
+                                    float pressHPa, const BatteryStatus& bs) {
+  uint8_t frame[TELEMETRY_FRAME_LEN];
+  size_t n = encode_telemetry_frame(tempC, rhPct, pressHPa, bs, WiFi.RSSI(), frame, sizeof(frame));
+  if (n > 0 && !client->publish(topic_get(TOPIC_TELEMETRY), frame, n, false)) {
+    Serial.println("[MQTT] Telemetry frame publish failed");
+  }
+}
+#endif
+
+#if ESPNOW_TRANSPORT
+// Report this wake to the gateway (espnow_link.h); false means use MQTT
+static bool send_espnow_report() {
+  float tempC = get_last_published_inside_tempC();
+  float rhPct = get_last_published_inside_rh();
+  float pressHPa = get_last_published_inside_pressureHPa();
+
+  uint8_t frame[TELEMETRY_FRAME_LEN];
+  size_t n = encode_telemetry_frame(tempC, rhPct, pressHPa, g_wake_battery, 0, frame, sizeof(frame));
+  if (n == 0 || !espnow_link_send(frame, n)) return false;
+
+  // The gateway has it: new baseline for skip-network wakes
+  if (isfinite(tempC)) {
+    set_last_tx_inside(tempC, rhPct, pressHPa);
+  }
+  return true;
+}
+#endif
+
 void run_network_phase() {
   PROFILE_SCOPE("run_network_phase");
+  CRASH_BREADCRUMB("run_network_phase");
+  MEM_PHASE(PUBLISH);
+  CPU_PHASE(PUBLISH);
   Serial.println("=== Network Phase ===");
   uint32_t phase_start = millis();
+  enter_phase(WakePhase::NETWORK, NETWORK_PHASE_TIMEOUT_MS);
 
   if (!mqtt_is_connected()) {
     Serial.println("MQTT not connected, skipping publish");
+    #if FEATURE_OFFLINE_QUEUE
+    // Keep this wake's reading for replay once the broker is reachable
+    queue_wake_sample(g_wake_readings);
+    #endif
     return;
   }
 
   // Use MQTTBatcher to batch sensor readings for efficient publishing
   MQTTBatcher& batcher = MQTTBatcher::getInstance();
   PubSubClient* client = mqtt_get_client();
-  const char* client_id = mqtt_get_client_id();
+
+  // Device prefix: queued topics are stored relative to it
+  batcher.setTopicPrefix(topic_device_prefix());
+  #if MQTT_PACKED_STATE
+  batcher.setPackedMode(true);
+  #endif
 
   // Queue sensor readings
   float tempC = get_last_published_inside_tempC();
   float rhPct = get_last_published_inside_rh();
   float pressHPa = get_last_published_inside_pressureHPa();
 
-  if (isfinite(tempC) && client_id && client_id[0]) {
-    // Build topics and payloads, then queue for batched publish
-    char topic[64], payload[32];
+  if (isfinite(tempC)) {
+    // Format payloads, then queue for batched publish
+    char payload[32];
 
     // Temperature (Celsius)
-    snprintf(topic, sizeof(topic), "espsensor/%s/inside/temperature", client_id);
     snprintf(payload, sizeof(payload), "%.1f", tempC);
-    batcher.queue(topic, payload, true);
+    batcher.queue(topic_get(TOPIC_INSIDE_TEMPERATURE), payload, true);
 
     // Humidity
-    snprintf(topic, sizeof(topic), "espsensor/%s/inside/humidity", client_id);
     snprintf(payload, sizeof(payload), "%.0f", rhPct);
-    batcher.queue(topic, payload, true);
+    batcher.queue(topic_get(TOPIC_INSIDE_HUMIDITY), payload, true);
 
     // Pressure
     if (isfinite(pressHPa)) {
-      snprintf(topic, sizeof(topic), "espsensor/%s/inside/pressure", client_id);
       snprintf(payload, sizeof(payload), "%.1f", pressHPa);
-      batcher.queue(topic, payload, true);
+      batcher.queue(topic_get(TOPIC_INSIDE_PRESSURE), payload, true);
     }
   }
 
   // Queue battery status
-  BatteryStatus bs = read_battery_status();
-  if (bs.percent >= 0 && client_id && client_id[0]) {
-    char topic[64], payload[32];
+  const BatteryStatus& bs = g_wake_battery;
+  if (bs.percent >= 0) {
+    char payload[32];
 
     // Battery voltage
-    snprintf(topic, sizeof(topic), "espsensor/%s/battery/voltage", client_id);
     snprintf(payload, sizeof(payload), "%.2f", bs.voltage);
-    batcher.queue(topic, payload, true);
+    batcher.queue(topic_get(TOPIC_BATTERY_VOLTAGE), payload, true);
 
     // Battery percent
-    snprintf(topic, sizeof(topic), "espsensor/%s/battery/percent", client_id);
     snprintf(payload, sizeof(payload), "%d", bs.percent);
-    batcher.queue(topic, payload, true);
+    batcher.queue(topic_get(TOPIC_BATTERY_PERCENT), payload, true);
   }
 
+  // Rolling 1 h / 24 h aggregates, nested in the packed document
+  #if FEATURE_INSIDE_STATS
+  char stats[224];
+  if (inside_stats_format_json(stats, sizeof(stats)) > 0) {
+    batcher.queueJson(topic_get(TOPIC_INSIDE_STATS), stats, true);
+  }
+  #endif
+
+  // Boot diagnostics go out in the same burst
+  queue_boot_diagnostics();
+
   // Flush all queued messages in batch
   size_t sent = batcher.flush(client);
+  WAKE_MARK(BATCH_FLUSHED);
+  publish_diag_document();
   Serial.printf("Batched publish: %u messages sent\n", sent);
 
-  // Publish diagnostics (these are less frequent, publish directly)
-  publish_boot_diagnostics();
+  // New baseline for skip-network wakes (only once the broker has it)
+  if (sent > 0 && isfinite(tempC)) {
+    set_last_tx_inside(tempC, rhPct, pressHPa);
+  }
+
+  // A new image has reached the broker: keep it (ota_update.h)
+  #if FEATURE_OTA_DELTA
+  if (sent > 0) ota_update_confirm_boot();
+  #endif
+
+  // Next full wake counted from here (espnow_link.h)
+  #if ESPNOW_TRANSPORT
+  if (sent > 0) espnow_link_note_mqtt_wake();
+  #endif
+
+  #if MQTT_COMPACT_TELEMETRY
+  if (remote_config_feature(g_rtc_state.config, RCFG_FEATURE_COMPACT_TELEMETRY, true)) {
+    publish_telemetry_frame(client, tempC, rhPct, pressHPa, bs);
+  }
+  #endif
 
-  // Fetch any retained outside data
-  pump_network_ms(FETCH_RETAINED_TIMEOUT_MS);
+  // Fetch any retained outside data (returns as soon as all expected topics
+  // arrive), unless the publish already used up the phase
+  if (!phase_overran()) {
+    uint32_t fetch_ms = phase_deadline_clamp(g_deadline, FETCH_RETAINED_TIMEOUT_MS, millis());
+    g_retained_fetch_ms = pump_network_until_retained(fetch_ms);
+    Serial.printf("Retained fetch: %lu ms (seen 0x%02X/0x%02X)\n", g_retained_fetch_ms,
+                  mqtt_retained_seen_mask(), mqtt_retained_expected_mask());
+    phase_overran();
+  }
 
   Serial.printf("Network phase took %lu ms\n", millis() - phase_start);
 }
 
+// Publishes the display does not depend on; run after the display phase so
+// they overlap the panel waveform
+void run_deferred_publish_phase() {
+  if (!mqtt_is_connected()) return;
+  PROFILE_SCOPE("run_deferred_publish_phase");
+  CRASH_BREADCRUMB("run_deferred_publish_phase");
+  MEM_PHASE(DEFERRED);
+  CPU_PHASE(PUBLISH);
+  uint32_t phase_start = millis();
+  enter_phase(WakePhase::DEFERRED, 0);   // Whatever is left of the wake budget
+  PubSubClient* client = mqtt_get_client();
+  const char* client_id = mqtt_get_client_id();
+
+  // Readings from wakes that could not reach the broker
+  #if FEATURE_OFFLINE_QUEUE
+  OfflineQueue::getInstance().replay(client, client_id);
+  #endif
+
+  // Timeline records from previous wakes (one compact payload)
+  #if FEATURE_WAKE_TIMELINE
+  WakeTimeline::getInstance().publishPending(client, client_id);
+  #endif
+
+  // Charge breakdown of the previous wake
+  #if FEATURE_ENERGY_METER
+  EnergyMeter::getInstance().publishPending(client, client_id);
+  #endif
+
+  // Profiling stats accumulated in RTC over the last summary interval
+  #if PROFILING_ENABLED
+  if (PerformanceMonitor::getInstance().summaryDue() && client_id && client_id[0]) {
+    char topic[96];
+    snprintf(topic, sizeof(topic), "espsensor/%s/debug/perf_summary", client_id);
+    PerformanceMonitor& perf = PerformanceMonitor::getInstance();
+    if (mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) { perf.writeHistoryJson(j); })) {
+      perf.resetHistory();
+    }
+  }
+  #endif
+
+  // Backtrace and breadcrumbs of a crash not reported yet (retained)
+  #if FEATURE_CRASH_HANDLER
+  if (CrashHandler::getInstance().hasPendingReport()) {
+    char report[CrashHandler::COMPACT_REPORT_MAX];
+    CrashHandler::getInstance().formatCompactReport(report, sizeof(report));
+    if (mqtt_publish_last_crash(report)) {
+      CrashHandler::getInstance().clearCrashInfo();
+    }
+  }
+  #endif
+
+  // Delta firmware update, a few KB of patch per wake (not on a low battery)
+  #if FEATURE_OTA_DELTA
+  uint32_t ota_ms = phase_deadline_clamp(g_deadline, OTA_WAKE_BUDGET_MS, millis());
+  if (ota_ms > 0 &&
+      (g_wake_battery.percent < 0 || g_wake_battery.percent >= OTA_MIN_BATTERY_PCT)) {
+    ota_update_pump(client, ota_ms);
+  }
+  #endif
+
+  {
+    char payload[16];
+    snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_retained_fetch_ms);
+    mqtt_publish_raw(topic_get(TOPIC_DEBUG_RETAINED_FETCH_MS), payload, false);
+  }
+  (void)client;
+  (void)client_id;
+
+  phase_overran();
+  Serial.printf("Deferred publish took %lu ms\n", millis() - phase_start);
+}
+
 #if USE_DISPLAY
 // Display update phase
-// Forward declaration for display update function from display_renderer
+// Forward declarations for display update functions from display_renderer
 extern void full_refresh();
+extern bool display_frame_unchanged();
+extern bool display_wait_idle(uint32_t timeout_ms);
 
 void run_display_phase() {
   PROFILE_SCOPE("run_display_phase");
+  CRASH_BREADCRUMB("run_display_phase");
+  MEM_PHASE(DISPLAY);
+  CPU_PHASE(RENDER);
   Serial.println("=== Display Phase ===");
   uint32_t phase_start = millis();
+  enter_phase(WakePhase::DISPLAY, DISPLAY_PHASE_TIMEOUT_MS);
+
+  // One snapshot of this wake's data for every renderer; the sensors and
+  // fuel gauge are not read again while drawing
+  render_model_capture(g_wake_readings, g_wake_battery);
 
-  // Call the full refresh to update the display with current sensor data
+  #if DISPLAY_SKIP_UNCHANGED_FRAMES
+  if (display_frame_unchanged()) {
+    Serial.println("Display unchanged - skipping refresh");
+    WAKE_MARK(DISPLAY_DONE);
+    return;
+  }
+  #endif
+
+  if (!g_display_initialized) {
+    display_manager_init();
+    g_display_initialized = true;
+  }
+
+  // Call the full refresh to update the display with current sensor data.
+  // With DISPLAY_ASYNC_REFRESH this returns once the frame is in panel RAM;
+  // the sleep phase waits for the waveform and marks DISPLAY_DONE.
   full_refresh();
 
+  #if !DISPLAY_ASYNC_REFRESH
+  WAKE_MARK(DISPLAY_DONE);
+  #endif
+  phase_overran();
   Serial.printf("Display phase took %lu ms\n", millis() - phase_start);
 }
 #endif
 
 // Deep sleep phase
 void run_sleep_phase() {
+  CRASH_BREADCRUMB("run_sleep_phase");
+  MEM_PHASE(SLEEP);
+  CPU_PHASE(SLEEP);
   Serial.println("=== Sleep Phase ===");
+
+  // Per-wake temporaries are done; drop them all at once
+  WakeArena::getInstance().reset();
   
   #if DEV_NO_SLEEP
+  #if USE_DISPLAY
+  display_wait_idle(DISPLAY_PHASE_TIMEOUT_MS);
+  #endif
   Serial.println("DEV_NO_SLEEP: Staying awake in loop()");
   Serial.println("Device will print [ALIVE] message every 5 seconds");
   Serial.flush();
   return;  // Return to setup(), then loop() will run continuously
   #endif
   
-  // Calculate adaptive wake interval based on battery level and sensor changes
+  // Calculate adaptive wake interval from battery level and the temperature trend
+  record_temperature_sample(g_wake_readings.temperatureC);
   SleepConfig config = get_default_sleep_config();
   uint32_t wake_interval_sec = calculate_optimal_sleep_interval(config);
+  note_sleep_interval(wake_interval_sec);
 
   Serial.printf("Adaptive sleep: %u sec (battery: %d%%, temp changing: %s)\n",
                 wake_interval_sec,
@@ -469,13 +1121,58 @@ void run_sleep_phase() {
   // Update cumulative uptime before sleep
   add_to_cumulative_uptime(millis() / 1000);
 
+  // Staleness for the skip-network heartbeat (as of the next wake)
+  add_sec_since_last_tx(wake_interval_sec + millis() / 1000);
+  increment_wakes_since_last_tx();
+
   // Prepare for sleep
-  power_prepare_sleep();
+  prepare_power_for_sleep();
   net_prepare_for_sleep();
 
+  // Sleep only once the panel has finished its waveform
+  #if USE_DISPLAY && DISPLAY_ASYNC_REFRESH
+  CPU_PHASE(WAIT);
+  display_wait_idle(DISPLAY_PHASE_TIMEOUT_MS);
+  WAKE_MARK(DISPLAY_DONE);
+  CPU_PHASE(SLEEP);
+  #endif
+
+  // Commit this wake's NVS log batch (one blob write) and time it
+  #ifdef LOG_ENABLED
+  Logger::getInstance().flush();
+  WAKE_MARK(LOGS_COMMITTED);
+  #endif
+
+  // Fold this wake's profiling stats into the RTC history
+  #if PROFILING_ENABLED
+  PerformanceMonitor::getInstance().persistWake(wake_interval_sec + millis() / 1000);
+  #endif
+
+  // Keep this wake's per-phase heap activity for the next wake
+  #if FEATURE_MEMORY_TRACKING
+  MemoryTracker::getInstance().endWake();
+  #endif
+
   // Store state to NVS
   nvs_end_cache();
 
+  // Close out this wake's timeline record (stays in RTC for next wake)
+  #if FEATURE_WAKE_TIMELINE
+  WakeTimeline::getInstance().commit();
+  #endif
+
+  // Charge this wake per phase and fold it into the RTC average
+  #if FEATURE_ENERGY_METER
+  EnergyMeter::getInstance().commit(wake_interval_sec, g_wake_battery.percent);
+  #endif
+
+  // Hand the sensor to the ULP; it wakes us early if a reading moves
+  #if FEATURE_ULP_SAMPLING
+  if (remote_config_feature(g_rtc_state.config, RCFG_FEATURE_ULP, true)) {
+    ulp_sampler_arm();
+  }
+  #endif
+
   Serial.printf("Entering deep sleep for %u seconds\n", wake_interval_sec);
   go_deep_sleep_with_tracking(wake_interval_sec);
 }
\ No newline at end of file
@@ -14,6 +14,7 @@ void app_loop();
 void run_sensor_phase();
 void run_network_phase();
 void run_display_phase();
+void run_deferred_publish_phase();
 void run_sleep_phase();
 
 // Application state
@@ -0,0 +1,43 @@
+#pragma once
+
+// Base64 encoding (RFC 4648 alphabet) for screenshot payloads
+// Blocks are encoded with padding only when the input length is not a
+// multiple of 3, so a stream encoded in 3-byte-aligned blocks concatenates
+// into one valid string. That lets display_capture.cpp stream a frame into
+// MQTT chunks with a small stack buffer.
+//
+// Usage:
+//   char block[BASE64_ENCODED_LEN(48)];
+//   size_t n = base64_encode_block(frame + pos, 48, block);   // No terminator
+
+#include <cstddef>
+#include <cstdint>
+
+#define BASE64_ENCODED_LEN(n) ((((n) + 2) / 3) * 4)
+
+static constexpr char BASE64_CHARS[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Encode len bytes into out (BASE64_ENCODED_LEN(len) chars, no terminator
+// written); returns the number of chars written
+inline size_t base64_encode_block(const uint8_t* in, size_t len, char* out) {
+  size_t j = 0;
+  size_t i = 0;
+  for (; i + 3 <= len; i += 3) {
+    uint32_t v = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+    out[j++] = BASE64_CHARS[(v >> 18) & 0x3F];
+    out[j++] = BASE64_CHARS[(v >> 12) & 0x3F];
+    out[j++] = BASE64_CHARS[(v >> 6) & 0x3F];
+    out[j++] = BASE64_CHARS[v & 0x3F];
+  }
+  size_t rem = len - i;
+  if (rem) {
+    uint32_t v = (uint32_t)in[i] << 16;
+    if (rem == 2) v |= (uint32_t)in[i + 1] << 8;
+    out[j++] = BASE64_CHARS[(v >> 18) & 0x3F];
+    out[j++] = BASE64_CHARS[(v >> 12) & 0x3F];
+    out[j++] = rem == 2 ? BASE64_CHARS[(v >> 6) & 0x3F] : '=';
+    out[j++] = '=';
+  }
+  return j;
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+// BME280 register-level helpers
+// Everything the direct sensor driver needs that does not touch the bus:
+// register values for the oversampling / IIR filter settings, the worst-case
+// forced-mode conversion time for those settings (datasheet appendix B),
+// calibration parsing and the Bosch integer compensation formulas applied to
+// one 8-byte burst read of 0xF7..0xFE (pressure, temperature, humidity).
+//
+// Usage:
+//   Bme280Calib cal;
+//   bme280_parse_calib(tp_regs, h_regs, cal);           // 0x88..0xA1, 0xE1..0xE7
+//   uint8_t ctrl_meas = bme280_ctrl_meas(2, 4, BME280_MODE_FORCED);
+//   wait_us(bme280_measure_time_us(2, 4, 1));
+//   Bme280Reading r = bme280_compensate(cal, data_regs); // NaN where skipped
+//
+// Oversampling is given as the ratio (0 = skipped, 1, 2, 4, 8, 16) and the IIR
+// filter as its coefficient (0 = off, 2, 4, 8, 16).
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "code_placement.h"
+
+static constexpr uint8_t BME280_CHIP_ID = 0x60;
+
+static constexpr uint8_t BME280_REG_CALIB_TP = 0x88;    // 26 bytes
+static constexpr uint8_t BME280_REG_CHIP_ID = 0xD0;
+static constexpr uint8_t BME280_REG_RESET = 0xE0;
+static constexpr uint8_t BME280_REG_CALIB_H = 0xE1;     // 7 bytes
+static constexpr uint8_t BME280_REG_CTRL_HUM = 0xF2;
+static constexpr uint8_t BME280_REG_STATUS = 0xF3;
+static constexpr uint8_t BME280_REG_CTRL_MEAS = 0xF4;
+static constexpr uint8_t BME280_REG_CONFIG = 0xF5;
+static constexpr uint8_t BME280_REG_DATA = 0xF7;        // 8 bytes
+
+static constexpr size_t BME280_CALIB_TP_LEN = 26;
+static constexpr size_t BME280_CALIB_H_LEN = 7;
+static constexpr size_t BME280_DATA_LEN = 8;
+
+static constexpr uint8_t BME280_RESET_CMD = 0xB6;
+static constexpr uint8_t BME280_STATUS_IM_UPDATE = 0x01; // NVM copy in progress
+
+static constexpr uint8_t BME280_MODE_SLEEP = 0x00;
+static constexpr uint8_t BME280_MODE_FORCED = 0x01;
+
+struct Bme280Calib {
+    uint16_t t1;
+    int16_t t2;
+    int16_t t3;
+    uint16_t p1;
+    int16_t p2, p3, p4, p5, p6, p7, p8, p9;
+    int16_t h2;
+    int16_t h4;
+    int16_t h5;
+    uint8_t h1;
+    uint8_t h3;
+    int8_t h6;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(Bme280Calib) == 34, "Bme280Calib must not contain padding");
+
+// What the driver keeps in RTC memory: calibration plus the register values
+// last written, so a wake with unchanged settings skips probing, the
+// calibration read and reconfiguration. addr 0 = not configured.
+struct Bme280Cache {
+    Bme280Calib calib;
+    uint8_t addr;
+    uint8_t ctrl_hum;
+    uint8_t ctrl_meas;      // Oversampling bits, mode field sleep
+    uint8_t config;
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(Bme280Cache) == 40, "Bme280Cache must not contain padding");
+
+struct Bme280Reading {
+    float temperatureC;
+    float humidityPct;
+    float pressureHPa;
+};
+
+// Oversampling ratio -> osrs_x field (unsupported ratios round down)
+inline uint8_t bme280_osrs_code(uint8_t ratio) {
+    if (ratio >= 16) return 5;
+    if (ratio >= 8) return 4;
+    if (ratio >= 4) return 3;
+    if (ratio >= 2) return 2;
+    return ratio ? 1 : 0;
+}
+
+// IIR coefficient -> filter field
+inline uint8_t bme280_filter_code(uint8_t coeff) {
+    if (coeff >= 16) return 4;
+    if (coeff >= 8) return 3;
+    if (coeff >= 4) return 2;
+    return coeff >= 2 ? 1 : 0;
+}
+
+inline uint8_t bme280_ctrl_hum(uint8_t osrs_h) {
+    return bme280_osrs_code(osrs_h);
+}
+
+inline uint8_t bme280_ctrl_meas(uint8_t osrs_t, uint8_t osrs_p, uint8_t mode) {
+    return (uint8_t)((bme280_osrs_code(osrs_t) << 5) | (bme280_osrs_code(osrs_p) << 2) | (mode & 0x03));
+}
+
+// Standby bits are irrelevant in forced mode and left at 0
+inline uint8_t bme280_config_reg(uint8_t filter) {
+    return (uint8_t)(bme280_filter_code(filter) << 2);
+}
+
+// Worst-case forced conversion time: 1.25 ms + 2.3 ms per temperature
+// sample, plus 2.3 ms per sample + 0.575 ms for pressure and humidity
+inline uint32_t bme280_measure_time_us(uint8_t osrs_t, uint8_t osrs_p, uint8_t osrs_h) {
+    uint32_t t = bme280_osrs_code(osrs_t) ? (1u << (bme280_osrs_code(osrs_t) - 1)) : 0;
+    uint32_t p = bme280_osrs_code(osrs_p) ? (1u << (bme280_osrs_code(osrs_p) - 1)) : 0;
+    uint32_t h = bme280_osrs_code(osrs_h) ? (1u << (bme280_osrs_code(osrs_h) - 1)) : 0;
+    uint32_t us = 1250 + 2300 * t;
+    if (p) us += 2300 * p + 575;
+    if (h) us += 2300 * h + 575;
+    return us;
+}
+
+inline uint16_t bme280_u16le(const uint8_t* b) { return (uint16_t)(b[0] | (b[1] << 8)); }
+inline int16_t bme280_s16le(const uint8_t* b) { return (int16_t)bme280_u16le(b); }
+
+// tp: registers 0x88..0xA1, h: registers 0xE1..0xE7
+inline void bme280_parse_calib(const uint8_t* tp, const uint8_t* h, Bme280Calib& c) {
+    c.t1 = bme280_u16le(tp + 0);
+    c.t2 = bme280_s16le(tp + 2);
+    c.t3 = bme280_s16le(tp + 4);
+    c.p1 = bme280_u16le(tp + 6);
+    c.p2 = bme280_s16le(tp + 8);
+    c.p3 = bme280_s16le(tp + 10);
+    c.p4 = bme280_s16le(tp + 12);
+    c.p5 = bme280_s16le(tp + 14);
+    c.p6 = bme280_s16le(tp + 16);
+    c.p7 = bme280_s16le(tp + 18);
+    c.p8 = bme280_s16le(tp + 20);
+    c.p9 = bme280_s16le(tp + 22);
+    c.h1 = tp[25];
+    c.h2 = bme280_s16le(h + 0);
+    c.h3 = h[2];
+    // H4 and H5 are 12-bit values sharing register 0xE5
+    c.h4 = (int16_t)(((int16_t)(int8_t)h[3] * 16) | (h[4] & 0x0F));
+    c.h5 = (int16_t)(((int16_t)(int8_t)h[5] * 16) | (h[4] >> 4));
+    c.h6 = (int8_t)h[6];
+    c.reserved = 0;
+}
+
+// t_fine (shared by the pressure and humidity formulas) and 0.01 degC
+inline int32_t bme280_t_fine(const Bme280Calib& c, int32_t adc_t) {
+    int32_t var1 = ((((adc_t >> 3) - ((int32_t)c.t1 << 1))) * ((int32_t)c.t2)) >> 11;
+    int32_t d = (adc_t >> 4) - (int32_t)c.t1;
+    int32_t var2 = (((d * d) >> 12) * ((int32_t)c.t3)) >> 14;
+    return var1 + var2;
+}
+
+// Q24.8 Pascals, 0 when the calibration would divide by zero
+inline uint32_t bme280_pressure_q24_8(const Bme280Calib& c, int32_t adc_p, int32_t t_fine) {
+    int64_t var1 = (int64_t)t_fine - 128000;
+    int64_t var2 = var1 * var1 * (int64_t)c.p6;
+    var2 = var2 + ((var1 * (int64_t)c.p5) * 131072);
+    var2 = var2 + ((int64_t)c.p4 * 34359738368LL);
+    var1 = ((var1 * var1 * (int64_t)c.p3) >> 8) + ((var1 * (int64_t)c.p2) * 4096);
+    var1 = ((((int64_t)1) << 47) + var1) * ((int64_t)c.p1) >> 33;
+    if (var1 == 0) return 0;
+    int64_t p = 1048576 - adc_p;
+    p = ((p * 2147483648LL - var2) * 3125) / var1;
+    var1 = ((int64_t)c.p9 * (p >> 13) * (p >> 13)) >> 25;
+    var2 = ((int64_t)c.p8 * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + ((int64_t)c.p7 * 16);
+    return (uint32_t)p;
+}
+
+// Q22.10 %RH, clamped to 0..100
+inline uint32_t bme280_humidity_q22_10(const Bme280Calib& c, int32_t adc_h, int32_t t_fine) {
+    int32_t v = t_fine - 76800;
+    v = (((((adc_h << 14) - ((int32_t)c.h4 * 1048576) - ((int32_t)c.h5 * v)) + 16384) >> 15) *
+         (((((((v * (int32_t)c.h6) >> 10) * (((v * (int32_t)c.h3) >> 11) + 32768)) >> 10) +
+            2097152) * (int32_t)c.h2 + 8192) >> 14));
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)c.h1) >> 4);
+    if (v < 0) v = 0;
+    if (v > 419430400) v = 419430400;
+    return (uint32_t)(v >> 12);
+}
+
+// data: registers 0xF7..0xFE; a channel whose oversampling is "skipped"
+// (or that reads back its reset value) comes out NaN
+HOT_PATH inline Bme280Reading bme280_compensate(const Bme280Calib& c, const uint8_t* data) {
+    Bme280Reading r = {NAN, NAN, NAN};
+    int32_t adc_p = ((int32_t)data[0] << 12) | ((int32_t)data[1] << 4) | (data[2] >> 4);
+    int32_t adc_t = ((int32_t)data[3] << 12) | ((int32_t)data[4] << 4) | (data[5] >> 4);
+    int32_t adc_h = ((int32_t)data[6] << 8) | data[7];
+    if (adc_t == 0x80000) return r;     // No temperature, no t_fine
+    int32_t t_fine = bme280_t_fine(c, adc_t);
+    r.temperatureC = (float)((t_fine * 5 + 128) >> 8) / 100.0f;
+    if (adc_p != 0x80000) {
+        uint32_t p = bme280_pressure_q24_8(c, adc_p, t_fine);
+        if (p) r.pressureHPa = (float)p / 25600.0f;
+    }
+    if (adc_h != 0x8000) {
+        r.humidityPct = (float)bme280_humidity_q22_10(c, adc_h, t_fine) / 1024.0f;
+    }
+    return r;
+}
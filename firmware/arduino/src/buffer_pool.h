@@ -1,10 +1,15 @@
 #pragma once
 
-#include <Arduino.h>
+#include <cstddef>
 #include <cstdint>
+#include "feature_flags.h"
+#include "buffer_pool_core.h"
 
 // Static buffer pool for reducing heap fragmentation
-// Provides pre-allocated buffers for temporary string operations
+// Provides pre-allocated buffers for temporary string operations. Size
+// classes come from feature_flags.h (BUFFER_POOL_*_SIZE/COUNT); acquire and
+// release are lock-free (see buffer_pool_core.h), so tasks and ISRs can share
+// the pool. A full class falls back to the next larger one.
 //
 // Usage:
 //   char* buf = BufferPool::getInstance().acquireSmall();
@@ -12,63 +17,63 @@
 //   // ... use buffer
 //   BufferPool::getInstance().release(buf);
 //
-// Or use RAII helper:
+// Or use RAII helper (the tag shows up in per-caller stats):
 //   {
-//       ScopedBuffer buf(BufferPool::SMALL_BUF);
+//       ScopedBuffer buf(BufferPool::SMALL_BUF, "mdns_host");
 //       snprintf(buf.get(), buf.size(), "format %d", value);
 //       // ... automatic release on scope exit
 //   }
 
 class BufferPool {
 public:
-    static constexpr size_t SMALL_BUF = 64;    // For small strings (topics, short messages)
-    static constexpr size_t MEDIUM_BUF = 128;  // For medium strings (JSON snippets)
-    static constexpr size_t LARGE_BUF = 256;   // For large strings (full JSON messages)
+    static constexpr size_t SMALL_BUF = BUFFER_POOL_SMALL_SIZE;    // For small strings (topics, short messages)
+    static constexpr size_t MEDIUM_BUF = BUFFER_POOL_MEDIUM_SIZE;  // For medium strings (JSON snippets)
+    static constexpr size_t LARGE_BUF = BUFFER_POOL_LARGE_SIZE;    // For large strings (full JSON messages)
 
-    static constexpr size_t SMALL_POOL_SIZE = 4;   // 4 x 64 = 256 bytes
-    static constexpr size_t MEDIUM_POOL_SIZE = 2;  // 2 x 128 = 256 bytes
-    static constexpr size_t LARGE_POOL_SIZE = 1;   // 1 x 256 = 256 bytes
-    // Total static allocation: 768 bytes
+    static constexpr size_t SMALL_POOL_SIZE = BUFFER_POOL_SMALL_COUNT;
+    static constexpr size_t MEDIUM_POOL_SIZE = BUFFER_POOL_MEDIUM_COUNT;
+    static constexpr size_t LARGE_POOL_SIZE = BUFFER_POOL_LARGE_COUNT;
+
+    static_assert(SMALL_BUF < MEDIUM_BUF && MEDIUM_BUF < LARGE_BUF, "Buffer pool classes must ascend in size");
+    static_assert(LARGE_BUF <= 0xFFFF, "Buffer pool slots are limited to 64 KB");
+    static_assert(SMALL_POOL_SIZE <= POOL_MAX_SLOTS && MEDIUM_POOL_SIZE <= POOL_MAX_SLOTS &&
+                  LARGE_POOL_SIZE <= POOL_MAX_SLOTS, "Buffer pool classes hold at most 32 slots");
 
     static BufferPool& getInstance() {
         static BufferPool instance;
         return instance;
     }
 
-    // Acquire buffers (returns nullptr if pool exhausted)
-    char* acquireSmall();
-    char* acquireMedium();
-    char* acquireLarge();
+    // Acquire buffers (returns nullptr if this class and every larger one is exhausted)
+    char* acquireSmall(const char* tag = nullptr) { return acquire(SMALL_BUF, tag); }
+    char* acquireMedium(const char* tag = nullptr) { return acquire(MEDIUM_BUF, tag); }
+    char* acquireLarge(const char* tag = nullptr) { return acquire(LARGE_BUF, tag); }
 
-    // Generic acquire by size
-    char* acquire(size_t size);
+    // Generic acquire by size; got_size receives the slot size actually handed
+    // out, which can be larger after a fallback. tag must have static lifetime.
+    char* acquire(size_t size, const char* tag = nullptr, size_t* got_size = nullptr) {
+        return pool_acquire(core_, size, got_size, tag);
+    }
 
-    // Release buffer back to pool
-    void release(char* buf);
+    // Release buffer back to pool (foreign pointers and double releases are counted)
+    void release(char* buf) { pool_release(core_, buf); }
 
     // Check if buffer belongs to pool
-    bool isPoolBuffer(const char* buf) const;
-
-    // Statistics
-    struct Stats {
-        uint32_t small_acquired;
-        uint32_t medium_acquired;
-        uint32_t large_acquired;
-        uint32_t small_released;
-        uint32_t medium_released;
-        uint32_t large_released;
-        uint32_t acquire_failures;  // Pool exhausted
-        uint32_t invalid_releases;  // Tried to release non-pool buffer
-        uint8_t small_in_use;
-        uint8_t medium_in_use;
-        uint8_t large_in_use;
-    };
-
-    const Stats& getStats() const { return stats_; }
-    void resetStats();
-
-    // Format stats to JSON
-    void formatStatsJson(char* out, size_t out_size) const;
+    bool isPoolBuffer(const char* buf) const { return pool_find(core_, buf) >= 0; }
+
+    // Slot size of a pool buffer, 0 for foreign pointers
+    size_t bufferSize(const char* buf) const;
+
+    enum SizeClass : uint8_t { CLASS_SMALL = 0, CLASS_MEDIUM, CLASS_LARGE, CLASS_COUNT };
+
+    const PoolClass& getClass(SizeClass c) const { return classes_[c]; }
+    uint32_t failures() const { return core_.failures; }
+    uint32_t invalidReleases() const { return core_.invalid_releases; }
+    void resetStats() { pool_reset_stats(core_); }
+
+    // Format stats to JSON (per class, then per caller tag)
+    void formatStatsJson(char* out, size_t out_size) const { pool_format_json(core_, out, out_size); }
+    void formatCallersJson(char* out, size_t out_size) const { pool_format_callers_json(core_, out, out_size); }
 
 private:
     BufferPool();
@@ -81,27 +86,15 @@ private:
     char medium_pool_[MEDIUM_POOL_SIZE][MEDIUM_BUF];
     char large_pool_[LARGE_POOL_SIZE][LARGE_BUF];
 
-    // In-use bitmasks (1 bit per buffer)
-    uint8_t small_in_use_;   // 4 bits used
-    uint8_t medium_in_use_;  // 2 bits used
-    uint8_t large_in_use_;   // 1 bit used
-
-    Stats stats_;
-
-    // Helper to find free slot
-    int8_t findFreeSlot(uint8_t mask, uint8_t max_count) const;
+    PoolClass classes_[CLASS_COUNT];
+    PoolCore core_;
 };
 
 // RAII wrapper for automatic buffer release
 class ScopedBuffer {
 public:
-    explicit ScopedBuffer(size_t size) : buf_(nullptr), size_(0) {
-        buf_ = BufferPool::getInstance().acquire(size);
-        if (buf_) {
-            size_ = (size <= BufferPool::SMALL_BUF) ? BufferPool::SMALL_BUF :
-                    (size <= BufferPool::MEDIUM_BUF) ? BufferPool::MEDIUM_BUF :
-                    BufferPool::LARGE_BUF;
-        }
+    explicit ScopedBuffer(size_t size, const char* tag = nullptr) : buf_(nullptr), size_(0) {
+        buf_ = BufferPool::getInstance().acquire(size, tag, &size_);
     }
 
     ~ScopedBuffer() {
@@ -122,7 +115,7 @@ public:
 
     char* get() { return buf_; }
     const char* get() const { return buf_; }
-    size_t size() const { return size_; }
+    size_t size() const { return size_; }  // Slot size, may exceed the request
     bool valid() const { return buf_ != nullptr; }
     operator bool() const { return valid(); }
 
@@ -0,0 +1,245 @@
+#pragma once
+
+// Lock-free size-class pool core
+// Each class is a run of equal-sized slots tracked by one 32-bit in-use mask.
+// Acquire claims the lowest free bit with compare-and-swap and release clears
+// it with an atomic AND, so tasks and ISRs can share a pool without a mutex.
+// A request goes to the smallest class that fits; if that class is fully in
+// use it falls back to the next larger one. Per-class high-water marks show
+// how to size the classes, and optional caller tags show who holds what.
+//
+// Usage:
+//   static char storage[4 * 64 + 2 * 128];
+//   PoolClass classes[2];
+//   pool_class_init(classes[0], storage, 64, 4);
+//   pool_class_init(classes[1], storage + 4 * 64, 128, 2);
+//   PoolCore pool = {classes, 2};
+//   size_t got = 0;
+//   char* buf = pool_acquire(pool, 100, &got, "ha_discovery");
+//   ...
+//   pool_release(pool, buf);
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+static constexpr size_t POOL_MAX_SLOTS = 32;    // Bits in the in-use mask
+static constexpr size_t POOL_MAX_CALLERS = 8;
+
+struct PoolClass {
+    char* base;
+    uint16_t size;
+    uint8_t count;          // <= POOL_MAX_SLOTS
+    uint32_t in_use;        // Bit per slot
+    uint32_t acquired;
+    uint32_t released;
+    uint32_t fallbacks;     // Served here because a smaller class was full
+    uint8_t high_water;     // Most slots ever in use at once
+};
+
+struct PoolCaller {
+    const char* tag;        // Static lifetime; nullptr = slot unused
+    uint32_t acquired;
+    uint32_t fallbacks;
+    uint32_t failures;
+};
+
+struct PoolCore {
+    PoolClass* classes;     // Ascending size
+    size_t class_count;
+    uint32_t failures;      // Nothing large enough was free
+    uint32_t invalid_releases;
+    PoolCaller callers[POOL_MAX_CALLERS];
+};
+
+inline void pool_class_init(PoolClass& c, char* base, uint16_t size, uint8_t count) {
+    c.base = base;
+    c.size = size;
+    c.count = count > POOL_MAX_SLOTS ? (uint8_t)POOL_MAX_SLOTS : count;
+    c.in_use = 0;
+    c.acquired = 0;
+    c.released = 0;
+    c.fallbacks = 0;
+    c.high_water = 0;
+}
+
+inline uint32_t pool_full_mask(const PoolClass& c) {
+    return c.count >= 32 ? 0xFFFFFFFFu : ((1u << c.count) - 1u);
+}
+
+inline uint8_t pool_in_use(const PoolClass& c) {
+    return (uint8_t)__builtin_popcount(__atomic_load_n(&c.in_use, __ATOMIC_RELAXED));
+}
+
+inline void pool_note_high_water(PoolClass& c, uint32_t mask) {
+    uint8_t n = (uint8_t)__builtin_popcount(mask);
+    uint8_t hw = __atomic_load_n(&c.high_water, __ATOMIC_RELAXED);
+    while (n > hw && !__atomic_compare_exchange_n(&c.high_water, &hw, n, true,
+                                                  __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Claim a free slot from one class; nullptr when every slot is in use
+inline char* pool_class_claim(PoolClass& c) {
+    uint32_t full = pool_full_mask(c);
+    uint32_t mask = __atomic_load_n(&c.in_use, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t free_bits = ~mask & full;
+        if (free_bits == 0) return nullptr;
+        uint32_t bit = free_bits & (~free_bits + 1u);
+        if (__atomic_compare_exchange_n(&c.in_use, &mask, mask | bit, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            __atomic_fetch_add(&c.acquired, 1u, __ATOMIC_RELAXED);
+            pool_note_high_water(c, mask | bit);
+            return c.base + (size_t)__builtin_ctz(bit) * c.size;
+        }
+        // mask was reloaded by the failed exchange
+    }
+}
+
+// Per-caller counters for a tag, registering it on first use; nullptr tag or
+// a full table skips caller accounting
+inline PoolCaller* pool_caller(PoolCore& p, const char* tag) {
+    if (!tag) return nullptr;
+    for (size_t i = 0; i < POOL_MAX_CALLERS; i++) {
+        PoolCaller& c = p.callers[i];
+        const char* cur = __atomic_load_n(&c.tag, __ATOMIC_ACQUIRE);
+        if (cur == tag) return &c;
+        if (cur == nullptr) {
+            if (__atomic_compare_exchange_n(&c.tag, &cur, tag, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                return &c;
+            }
+            if (cur == tag) return &c;  // Another context registered it first
+        }
+    }
+    return nullptr;
+}
+
+// Smallest free slot of at least size bytes; *got_size receives the slot size
+inline char* pool_acquire(PoolCore& p, size_t size, size_t* got_size = nullptr,
+                          const char* tag = nullptr) {
+    PoolCaller* caller = pool_caller(p, tag);
+    bool fell_back = false;
+    for (size_t i = 0; i < p.class_count; i++) {
+        PoolClass& c = p.classes[i];
+        if (size > c.size) continue;
+        char* buf = pool_class_claim(c);
+        if (!buf) {
+            fell_back = true;
+            continue;
+        }
+        if (fell_back) __atomic_fetch_add(&c.fallbacks, 1u, __ATOMIC_RELAXED);
+        if (caller) {
+            __atomic_fetch_add(&caller->acquired, 1u, __ATOMIC_RELAXED);
+            if (fell_back) __atomic_fetch_add(&caller->fallbacks, 1u, __ATOMIC_RELAXED);
+        }
+        if (got_size) *got_size = c.size;
+        return buf;
+    }
+    __atomic_fetch_add(&p.failures, 1u, __ATOMIC_RELAXED);
+    if (caller) __atomic_fetch_add(&caller->failures, 1u, __ATOMIC_RELAXED);
+    if (got_size) *got_size = 0;
+    return nullptr;
+}
+
+// Class owning buf, or -1; *slot receives the slot index
+inline int pool_find(const PoolCore& p, const char* buf, size_t* slot = nullptr) {
+    if (!buf) return -1;
+    for (size_t i = 0; i < p.class_count; i++) {
+        const PoolClass& c = p.classes[i];
+        if (buf < c.base || buf >= c.base + (size_t)c.size * c.count) continue;
+        size_t offset = (size_t)(buf - c.base);
+        if (offset % c.size != 0) return -1;    // Points inside a slot
+        if (slot) *slot = offset / c.size;
+        return (int)i;
+    }
+    return -1;
+}
+
+// False for foreign pointers and double releases (both counted)
+inline bool pool_release(PoolCore& p, char* buf) {
+    if (!buf) return false;
+    size_t slot = 0;
+    int cls = pool_find(p, buf, &slot);
+    if (cls < 0) {
+        __atomic_fetch_add(&p.invalid_releases, 1u, __ATOMIC_RELAXED);
+        return false;
+    }
+    PoolClass& c = p.classes[cls];
+    uint32_t bit = 1u << slot;
+    uint32_t prev = __atomic_fetch_and(&c.in_use, ~bit, __ATOMIC_RELEASE);
+    if ((prev & bit) == 0) {
+        __atomic_fetch_add(&p.invalid_releases, 1u, __ATOMIC_RELAXED);
+        return false;
+    }
+    __atomic_fetch_add(&c.released, 1u, __ATOMIC_RELAXED);
+    return true;
+}
+
+// Counters back to zero; in-use masks are live state and stay, and high-water
+// restarts from the current occupancy
+inline void pool_reset_stats(PoolCore& p) {
+    for (size_t i = 0; i < p.class_count; i++) {
+        PoolClass& c = p.classes[i];
+        __atomic_store_n(&c.acquired, 0u, __ATOMIC_RELAXED);
+        __atomic_store_n(&c.released, 0u, __ATOMIC_RELAXED);
+        __atomic_store_n(&c.fallbacks, 0u, __ATOMIC_RELAXED);
+        __atomic_store_n(&c.high_water, pool_in_use(c), __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&p.failures, 0u, __ATOMIC_RELAXED);
+    __atomic_store_n(&p.invalid_releases, 0u, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < POOL_MAX_CALLERS; i++) {
+        PoolCaller& c = p.callers[i];
+        __atomic_store_n(&c.acquired, 0u, __ATOMIC_RELAXED);
+        __atomic_store_n(&c.fallbacks, 0u, __ATOMIC_RELAXED);
+        __atomic_store_n(&c.failures, 0u, __ATOMIC_RELAXED);
+    }
+}
+
+// Appends to out at pos, clamping at the end so truncation stays terminated
+inline void pool_append(char* out, size_t out_size, size_t& pos, int n) {
+    if (n < 0) return;
+    pos += (size_t)n;
+    if (pos >= out_size) pos = out_size - 1;
+}
+
+// {"classes":[{"size":64,"count":4,"in_use":1,"hw":3,"acq":..,"rel":..,"fb":..},...],
+//  "failures":0,"invalid_releases":0}
+inline void pool_format_json(const PoolCore& p, char* out, size_t out_size) {
+    if (!out || out_size < 3) return;
+    size_t pos = 0;
+    pool_append(out, out_size, pos, snprintf(out, out_size, "{\"classes\":["));
+    for (size_t i = 0; i < p.class_count; i++) {
+        const PoolClass& c = p.classes[i];
+        pool_append(out, out_size, pos, snprintf(out + pos, out_size - pos,
+                    "%s{\"size\":%u,\"count\":%u,\"in_use\":%u,\"hw\":%u,"
+                    "\"acq\":%lu,\"rel\":%lu,\"fb\":%lu}",
+                    i ? "," : "", (unsigned)c.size, (unsigned)c.count,
+                    (unsigned)pool_in_use(c), (unsigned)c.high_water,
+                    (unsigned long)c.acquired, (unsigned long)c.released,
+                    (unsigned long)c.fallbacks));
+    }
+    pool_append(out, out_size, pos, snprintf(out + pos, out_size - pos,
+                "],\"failures\":%lu,\"invalid_releases\":%lu}",
+                (unsigned long)p.failures, (unsigned long)p.invalid_releases));
+}
+
+// {"callers":[{"tag":"x","acq":..,"fb":..,"fail":..},...]}
+inline void pool_format_callers_json(const PoolCore& p, char* out, size_t out_size) {
+    if (!out || out_size < 3) return;
+    size_t pos = 0;
+    pool_append(out, out_size, pos, snprintf(out, out_size, "{\"callers\":["));
+    bool first = true;
+    for (size_t i = 0; i < POOL_MAX_CALLERS; i++) {
+        const PoolCaller& c = p.callers[i];
+        const char* tag = __atomic_load_n(&c.tag, __ATOMIC_ACQUIRE);
+        if (!tag) continue;
+        pool_append(out, out_size, pos, snprintf(out + pos, out_size - pos,
+                    "%s{\"tag\":\"%s\",\"acq\":%lu,\"fb\":%lu,\"fail\":%lu}",
+                    first ? "" : ",", tag, (unsigned long)c.acquired,
+                    (unsigned long)c.fallbacks, (unsigned long)c.failures));
+        first = false;
+    }
+    pool_append(out, out_size, pos, snprintf(out + pos, out_size - pos, "]}"));
+}
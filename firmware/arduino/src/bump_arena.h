@@ -0,0 +1,128 @@
+#pragma once
+
+// Monotonic (bump) arena
+// Allocation rounds the top up to the alignment and moves it forward; nothing
+// is freed individually, the whole arena is reset in one step. Freeing or
+// growing the most recent block is the one exception (it moves the top back
+// or extends in place), which covers how JSON documents build strings and
+// shrink their pools. Peak use is tracked across resets so the arena can be
+// sized from a single number.
+//
+// Usage:
+//   static uint8_t storage[4096];
+//   BumpArena arena(storage, sizeof(storage));
+//   char* topic = (char*)arena.allocate(64);
+//   ...
+//   size_t mark = arena.mark();            // Scratch for one handler...
+//   ...
+//   arena.rewind(mark);                    // ...given back on the way out
+//   arena.reset();                         // Once per wake
+//
+// Not thread-safe: intended for one task (the wake's main loop).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class BumpArena {
+public:
+    static constexpr size_t ALIGN = 8;
+
+    BumpArena(uint8_t* storage, size_t capacity)
+        : base_(storage), capacity_(capacity) {}
+
+    // nullptr when the arena cannot fit size bytes (counted in failures())
+    void* allocate(size_t size) {
+        size_t start = alignUp(top_);
+        if (size == 0) size = 1;
+        if (start > capacity_ || size > capacity_ - start) {
+            failures_++;
+            return nullptr;
+        }
+        last_ = start;
+        top_ = start + size;
+        allocations_++;
+        if (top_ > peak_) peak_ = top_;
+        return base_ + start;
+    }
+
+    // Only the most recent block gives its space back
+    void deallocate(void* ptr) {
+        if (!ptr || !owns(ptr)) return;
+        if (offsetOf(ptr) == last_ && last_ < top_) top_ = last_;
+    }
+
+    // The most recent block grows or shrinks in place; any other block is
+    // copied to a new one (its old size is unknown, but it ends at or below
+    // the top, so copying up to the top is always in bounds)
+    void* reallocate(void* ptr, size_t new_size) {
+        if (!ptr) return allocate(new_size);
+        if (!owns(ptr)) return nullptr;
+        size_t offset = offsetOf(ptr);
+        if (new_size == 0) new_size = 1;
+        if (offset == last_ && last_ < top_) {
+            if (new_size > capacity_ - offset) {
+                failures_++;
+                return nullptr;
+            }
+            top_ = offset + new_size;
+            if (top_ > peak_) peak_ = top_;
+            return ptr;
+        }
+        size_t old_max = extent(ptr);
+        void* fresh = allocate(new_size);
+        if (fresh) memcpy(fresh, ptr, old_max < new_size ? old_max : new_size);
+        return fresh;
+    }
+
+    // Everything handed out since the last reset becomes invalid
+    void reset() {
+        top_ = 0;
+        last_ = 0;
+        resets_++;
+    }
+
+    // Give back everything allocated after mark() in one step
+    size_t mark() const { return top_; }
+    void rewind(size_t mark) {
+        if (mark >= top_) return;
+        top_ = mark;
+        last_ = mark;
+    }
+
+    // Bytes from ptr to the top: an upper bound on the size of an arena block
+    size_t extent(const void* ptr) const {
+        if (!owns(ptr) || offsetOf(ptr) >= top_) return 0;
+        return top_ - offsetOf(ptr);
+    }
+
+    bool owns(const void* ptr) const {
+        const uint8_t* p = (const uint8_t*)ptr;
+        return p >= base_ && p < base_ + capacity_;
+    }
+
+    size_t used() const { return top_; }
+    size_t peak() const { return peak_; }
+    size_t capacity() const { return capacity_; }
+    uint32_t allocations() const { return allocations_; }
+    uint32_t failures() const { return failures_; }
+    uint32_t resets() const { return resets_; }
+
+    void resetPeak() {
+        peak_ = top_;
+        failures_ = 0;
+    }
+
+private:
+    static size_t alignUp(size_t n) { return (n + ALIGN - 1) & ~(ALIGN - 1); }
+    size_t offsetOf(const void* ptr) const { return (size_t)((const uint8_t*)ptr - base_); }
+
+    uint8_t* base_;
+    size_t capacity_;
+    size_t top_ = 0;
+    size_t last_ = 0;           // Offset of the most recent block
+    size_t peak_ = 0;
+    uint32_t allocations_ = 0;
+    uint32_t failures_ = 0;
+    uint32_t resets_ = 0;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+// Span and rect rasterization on a 1-bit row-major buffer
+// Same layout as GFXcanvas1 at rotation 0: MSB-first, rows padded to whole
+// bytes, bit set = foreground. Spans are written with edge masks for the
+// partial bytes and memset for the whole bytes between them, instead of one
+// virtual drawPixel per pixel. Every call clips to the buffer.
+//
+// Usage:
+//   RasterTarget t = {canvas->getBuffer(), canvas->width(), canvas->height(),
+//                     (uint16_t)((canvas->width() + 7) / 8)};
+//   raster_hspan(t, x, y, len, true);
+//   raster_xbm(t, x, y, icon_bits, 24, 24, true);
+//   raster_bitmap(t, x, y, icon_atlas_bits(id), ICON_W, ICON_H, true);
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "code_placement.h"
+
+struct RasterTarget {
+  uint8_t* buf;
+  int16_t width;
+  int16_t height;
+  uint16_t stride;   // Bytes per row
+};
+
+inline void raster_pixel(const RasterTarget& t, int16_t x, int16_t y, bool set) {
+  if (x < 0 || y < 0 || x >= t.width || y >= t.height) return;
+  uint8_t* p = t.buf + (size_t)y * t.stride + (x >> 3);
+  uint8_t bit = (uint8_t)(0x80 >> (x & 7));
+  if (set) *p |= bit; else *p &= (uint8_t)~bit;
+}
+
+// Horizontal run of len pixels starting at (x, y)
+HOT_PATH inline void raster_hspan(const RasterTarget& t, int16_t x, int16_t y, int16_t len, bool set) {
+  if (y < 0 || y >= t.height || len <= 0) return;
+  int32_t x0 = x, x1 = (int32_t)x + len;   // Half-open [x0, x1)
+  if (x0 < 0) x0 = 0;
+  if (x1 > t.width) x1 = t.width;
+  if (x0 >= x1) return;
+
+  uint8_t* row = t.buf + (size_t)y * t.stride;
+  int32_t b0 = x0 >> 3, b1 = (x1 - 1) >> 3;
+  uint8_t head = (uint8_t)(0xFF >> (x0 & 7));
+  uint8_t tail = (uint8_t)(0xFF << (7 - ((x1 - 1) & 7)));
+  if (b0 == b1) {
+    uint8_t mask = head & tail;
+    if (set) row[b0] |= mask; else row[b0] &= (uint8_t)~mask;
+    return;
+  }
+  if (set) {
+    row[b0] |= head;
+    row[b1] |= tail;
+  } else {
+    row[b0] &= (uint8_t)~head;
+    row[b1] &= (uint8_t)~tail;
+  }
+  if (b1 - b0 > 1) memset(row + b0 + 1, set ? 0xFF : 0x00, (size_t)(b1 - b0 - 1));
+}
+
+// Vertical run of len pixels starting at (x, y); one mask, stride steps
+inline void raster_vspan(const RasterTarget& t, int16_t x, int16_t y, int16_t len, bool set) {
+  if (x < 0 || x >= t.width || len <= 0) return;
+  int32_t y0 = y, y1 = (int32_t)y + len;
+  if (y0 < 0) y0 = 0;
+  if (y1 > t.height) y1 = t.height;
+  uint8_t bit = (uint8_t)(0x80 >> (x & 7));
+  uint8_t* p = t.buf + (size_t)y0 * t.stride + (x >> 3);
+  for (int32_t yy = y0; yy < y1; ++yy, p += t.stride) {
+    if (set) *p |= bit; else *p &= (uint8_t)~bit;
+  }
+}
+
+inline void raster_fill_rect(const RasterTarget& t, int16_t x, int16_t y, int16_t w, int16_t h,
+                             bool set) {
+  if (w <= 0 || h <= 0) return;
+  int32_t y0 = y < 0 ? 0 : y;
+  int32_t y1 = (int32_t)y + h > t.height ? t.height : (int32_t)y + h;
+  for (int32_t yy = y0; yy < y1; ++yy) raster_hspan(t, x, (int16_t)yy, w, set);
+}
+
+inline void raster_fill(const RasterTarget& t, bool set) {
+  memset(t.buf, set ? 0xFF : 0x00, (size_t)t.stride * t.height);
+}
+
+// Draw the set bits of a 1-bit bitmap, (w + 7) / 8 bytes per row; clear
+// bits are left untouched, as Adafruit_GFX's transparent bitmap draws do.
+// lsb_first selects XBM bit order. Each source byte is shifted into at most
+// two target bytes.
+HOT_PATH inline void raster_blit_bits(const RasterTarget& t, int16_t x, int16_t y, const uint8_t* bits,
+                             int16_t w, int16_t h, bool set, bool lsb_first) {
+  if (!bits || w <= 0 || h <= 0) return;
+  int16_t src_stride = (int16_t)((w + 7) / 8);
+  for (int16_t r = 0; r < h; ++r) {
+    int32_t ty = (int32_t)y + r;
+    if (ty < 0 || ty >= t.height) continue;
+    uint8_t* row = t.buf + (size_t)ty * t.stride;
+    const uint8_t* src = bits + (size_t)r * src_stride;
+    for (int16_t sb = 0; sb < src_stride; ++sb) {
+      uint8_t v = src[sb];
+      if (!v) continue;
+      if (lsb_first) {
+        v = (uint8_t)(((v & 0xF0) >> 4) | ((v & 0x0F) << 4));
+        v = (uint8_t)(((v & 0xCC) >> 2) | ((v & 0x33) << 2));
+        v = (uint8_t)(((v & 0xAA) >> 1) | ((v & 0x55) << 1));
+      }
+      int16_t valid = (int16_t)(w - sb * 8);
+      if (valid < 8) v &= (uint8_t)(0xFF << (8 - valid));
+
+      int32_t px = (int32_t)x + sb * 8;
+      // Pixels that fall off the left or right edge are masked out
+      if (px < 0) {
+        if (px <= -8) continue;
+        v &= (uint8_t)(0xFF >> (-px));
+      }
+      int32_t over = px + 8 - t.width;
+      if (over > 0) {
+        if (over >= 8) continue;
+        v &= (uint8_t)(0xFF << over);
+      }
+      if (!v) continue;
+
+      int32_t byte = px >> 3;                          // Floor, also for px < 0
+      uint8_t shift = (uint8_t)(px & 7);
+      uint8_t lo = (uint8_t)(v >> shift);
+      uint8_t hi = shift ? (uint8_t)(v << (8 - shift)) : 0;
+      if (byte >= 0) {
+        if (set) row[byte] |= lo; else row[byte] &= (uint8_t)~lo;
+      }
+      if (hi && byte + 1 < t.stride) {
+        if (set) row[byte + 1] |= hi; else row[byte + 1] &= (uint8_t)~hi;
+      }
+    }
+  }
+}
+
+// XBM bitmap (LSB-first rows), as Adafruit_GFX::drawXBitmap
+inline void raster_xbm(const RasterTarget& t, int16_t x, int16_t y, const uint8_t* bits,
+                       int16_t w, int16_t h, bool set) {
+  raster_blit_bits(t, x, y, bits, w, h, set, true);
+}
+
+// MSB-first bitmap at most 24 px wide (icon atlas rows): each source row
+// is gathered into one word, clipped with a single mask, shifted once to the
+// destination bit offset and ORed into at most four bytes
+inline void raster_bitmap_narrow(const RasterTarget& t, int16_t x, int16_t y,
+                                 const uint8_t* bits, int16_t w, int16_t h, bool set) {
+  if (!bits || w <= 0 || w > 24 || h <= 0) return;
+  int32_t c0 = x < 0 ? -(int32_t)x : 0;                          // Visible columns [c0, c1)
+  int32_t c1 = (int32_t)x + w > t.width ? (int32_t)t.width - x : w;
+  if (c0 >= c1) return;
+  uint32_t keep = (0xFFFFFFFFu >> c0) & ~(0xFFFFFFFFu >> c1);   // Column c is bit 31 - c
+
+  int16_t src_stride = (int16_t)((w + 7) / 8);
+  int32_t px = (int32_t)x + c0;                                  // First visible pixel, >= 0
+  size_t byte = (size_t)(px >> 3);
+  uint8_t shift = (uint8_t)(px & 7);
+  for (int16_t r = 0; r < h; ++r) {
+    int32_t ty = (int32_t)y + r;
+    if (ty < 0 || ty >= t.height) continue;
+    const uint8_t* src = bits + (size_t)r * src_stride;
+    uint32_t word = 0;
+    for (int16_t b = 0; b < src_stride; ++b) word |= (uint32_t)src[b] << (24 - 8 * b);
+    word = ((word & keep) << c0) >> shift;
+    if (!word) continue;
+
+    uint8_t* row = t.buf + (size_t)ty * t.stride + byte;
+    for (int i = 0; i < 4 && byte + i < t.stride; ++i) {
+      uint8_t v = (uint8_t)(word >> (24 - 8 * i));
+      if (set) row[i] |= v; else row[i] &= (uint8_t)~v;
+    }
+  }
+}
+
+// MSB-first bitmap, as the transparent Adafruit_GFX::drawBitmap
+inline void raster_bitmap(const RasterTarget& t, int16_t x, int16_t y, const uint8_t* bits,
+                          int16_t w, int16_t h, bool set) {
+  if (w <= 24) raster_bitmap_narrow(t, x, y, bits, w, h, set);
+  else raster_blit_bits(t, x, y, bits, w, h, set, false);
+}
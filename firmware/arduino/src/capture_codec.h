@@ -0,0 +1,81 @@
+#pragma once
+
+// Screenshot compression: PackBits over an optional XOR delta
+// The 1-bit canvas is mostly white (zero bytes) and mostly unchanged between
+// screenshots, so byte runs compress it to a few hundred bytes. Input bytes
+// are read through an accessor and output bytes go to a sink one at a time,
+// so frames stream from the canvas into fixed-size MQTT chunks without a
+// full-size intermediate buffer.
+//
+// Usage:
+//   auto src = [&](size_t i) { return (uint8_t)(frame[i] ^ (base ? base[i] : 0)); };
+//   size_t n = packbits_encode(src, len, [&](uint8_t b) { chunk_put(b); });
+//
+// Stream format (decoded by scripts/device_manager/screenshot_handler.py):
+//   header h in 0..127    : h + 1 literal bytes follow
+//   header h in 129..255  : the next byte repeats 257 - h times (2..128)
+//   header 128            : no-op (never emitted)
+// A delta frame's encoded bytes are frame XOR base; the receiver XORs them
+// back onto its copy of the base frame.
+
+#include <cstddef>
+#include <cstdint>
+
+static constexpr size_t PACKBITS_MAX_RUN = 128;
+
+// Encode len bytes from src(i) into sink(b); returns the encoded size.
+// Runs of three or more equal bytes become repeat packets; shorter runs
+// stay inside literal packets, where they cost no extra header.
+template <typename Src, typename Sink>
+size_t packbits_encode(Src src, size_t len, Sink sink) {
+  size_t out = 0;
+  size_t i = 0;
+  while (i < len) {
+    uint8_t v = src(i);
+    size_t run = 1;
+    while (i + run < len && run < PACKBITS_MAX_RUN && src(i + run) == v) run++;
+
+    if (run >= 3) {
+      sink((uint8_t)(257 - run));
+      sink(v);
+      out += 2;
+      i += run;
+      continue;
+    }
+
+    // Literal packet: extend until a run of three starts or the packet is full
+    size_t start = i;
+    size_t lit = 0;
+    while (i + lit < len && lit < PACKBITS_MAX_RUN) {
+      size_t j = i + lit;
+      if (j + 2 < len && src(j) == src(j + 1) && src(j) == src(j + 2)) break;
+      lit++;
+    }
+    sink((uint8_t)(lit - 1));
+    for (size_t k = 0; k < lit; ++k) sink(src(start + k));
+    out += 1 + lit;
+    i += lit;
+  }
+  return out;
+}
+
+// Decode into out (exactly out_len bytes expected); returns false on a
+// truncated or overlong stream. Used by native tests; the receiver decodes
+// in Python.
+inline bool packbits_decode(const uint8_t* in, size_t in_len, uint8_t* out, size_t out_len) {
+  size_t i = 0, o = 0;
+  while (i < in_len) {
+    uint8_t h = in[i++];
+    if (h < 128) {
+      size_t n = (size_t)h + 1;
+      if (i + n > in_len || o + n > out_len) return false;
+      for (size_t k = 0; k < n; ++k) out[o++] = in[i++];
+    } else if (h > 128) {
+      size_t n = 257 - (size_t)h;
+      if (i >= in_len || o + n > out_len) return false;
+      uint8_t v = in[i++];
+      for (size_t k = 0; k < n; ++k) out[o++] = v;
+    }
+  }
+  return o == out_len;
+}
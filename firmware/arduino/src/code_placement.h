@@ -0,0 +1,38 @@
+#pragma once
+
+// Code placement for the wake path
+// Every wake starts with a cold flash cache, so code run on each wake pays a
+// cache-miss stall per line it touches, and code run once a week shares the
+// same cache lines. Two markers place functions deliberately:
+//
+//   HOT_PATH   measured-hot leaf code (CRC, sensor compensation, raster
+//              inner loops, the publish loop): linked into IRAM, which has
+//              no cache to miss. IRAM is scarce (footprint_budget.json), so
+//              keep this to small functions that show up in the "bench"
+//              debug command.
+//   COLD_PATH  rarely run code (debug commands, HA discovery publishing,
+//              diagnostics): never inlined into a hot caller, and emitted as
+//              .text.unlikely.*, which scripts/place_cold_text.py groups at
+//              the start of .flash.text, away from the code every wake runs.
+//
+// Usage:
+//   HOT_PATH uint32_t fast_crc32_update(uint32_t crc, const uint8_t* data, size_t len) { ... }
+//   COLD_PATH void DebugCommands::cmdHeap(PubSubClient* client) { ... }
+//
+// A HOT_PATH inline function runs from IRAM only where it is not inlined;
+// inlined copies live with their caller. Build with -DCODE_PLACEMENT=0 to
+// link everything the default way and compare "bench" reports (the "first"
+// field is the cold-cache run).
+
+#ifndef CODE_PLACEMENT
+#define CODE_PLACEMENT 1
+#endif
+
+#if CODE_PLACEMENT && defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#define HOT_PATH IRAM_ATTR
+#define COLD_PATH __attribute__((cold, noinline))
+#else
+#define HOT_PATH
+#define COLD_PATH
+#endif
@@ -13,6 +13,7 @@ struct OutsideReadings {
   float temperatureC = NAN;
   float humidityPct = NAN;
   char weather[64];
+  uint8_t weatherKind = 0;  // WeatherKind of weather, set when it arrives
   float windMps = NAN;
   float highTempC = NAN;
   float lowTempC = NAN;
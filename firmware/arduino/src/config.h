@@ -23,6 +23,26 @@
 #ifndef USE_BME280
 #define USE_BME280 1
 #endif
+// BME280 driver: 1 = direct register access (settings and calibration kept in
+// RTC, one burst read per sample), 0 = Adafruit_BME280 library
+#ifndef BME280_DIRECT
+#define BME280_DIRECT 1
+#endif
+// Oversampling ratios (0 = skip, 1, 2, 4, 8, 16) and IIR filter coefficient
+// (0 = off, 2, 4, 8, 16). The filter state lives in the sensor, so with forced
+// mode it smooths across wakes. x1/off converts in 9.3 ms worst case.
+#ifndef BME280_OSRS_T
+#define BME280_OSRS_T 1
+#endif
+#ifndef BME280_OSRS_P
+#define BME280_OSRS_P 1
+#endif
+#ifndef BME280_OSRS_H
+#define BME280_OSRS_H 1
+#endif
+#ifndef BME280_IIR_FILTER
+#define BME280_IIR_FILTER 0
+#endif
 #define USE_MQTT 1
 #define USE_ESPHOME_API 0
 // Support either fuel gauge; runtime probe decides which one is present
@@ -32,6 +52,11 @@
 #ifndef USE_LC709203F
 #define USE_LC709203F 1
 #endif
+// Fuel gauge reads are cached for the wake; only long awake sessions
+// (dev / no-sleep) outlive this and re-sample
+#ifndef BATTERY_CACHE_MAX_AGE_MS
+#define BATTERY_CACHE_MAX_AGE_MS 60000
+#endif
 
 // Wi-Fi provisioning (ESP-IDF wifi_prov_mgr) compile-time switch
 #ifndef USE_WIFI_PROVISIONING
@@ -79,11 +104,343 @@
 #ifndef PUBLISH_PHASE_TIMEOUT_MS
 #define PUBLISH_PHASE_TIMEOUT_MS 800
 #endif
+// Deadline supervisor (phase_deadline.h): WiFi association + MQTT session,
+// the batched publish + retained fetch, and the whole wake. A phase that
+// overruns is counted in the error stats and the wake degrades straight to
+// sleep; the 30 s task watchdog stays as the backstop behind it.
+#ifndef CONNECT_PHASE_TIMEOUT_MS
+#define CONNECT_PHASE_TIMEOUT_MS 10000
+#endif
+#ifndef NETWORK_PHASE_TIMEOUT_MS
+#define NETWORK_PHASE_TIMEOUT_MS (PUBLISH_PHASE_TIMEOUT_MS + FETCH_RETAINED_TIMEOUT_MS + 1000)
+#endif
+#ifndef WAKE_BUDGET_MS
+#if DEV_NO_SLEEP
+#define WAKE_BUDGET_MS 0      // Always-on builds have no wake to bound
+#else
+#define WAKE_BUDGET_MS 20000
+#endif
+#endif
+// Pipelined boot: how long the sensor phase waits for the background sensor
+// task started before WiFi association (covers BME280 init + measurement)
+#ifndef SENSOR_PIPELINE_JOIN_TIMEOUT_MS
+#define SENSOR_PIPELINE_JOIN_TIMEOUT_MS 1500
+#endif
+// After a join timeout the task is asked to stop; it finishes the I2C
+// transaction in flight (bounded by I2C_TIMEOUT_MS) and exits
+#ifndef SENSOR_PIPELINE_STOP_TIMEOUT_MS
+#define SENSOR_PIPELINE_STOP_TIMEOUT_MS (2 * I2C_TIMEOUT_MS)
+#endif
+// Skip-network wakes: a timer wake only brings up WiFi/MQTT when a reading
+// leaves its deadband relative to the last transmitted value, or when the
+// heartbeat interval has elapsed since the last successful publish
+#ifndef SKIP_NET_TEMP_DEADBAND_C
+#define SKIP_NET_TEMP_DEADBAND_C 0.2f
+#endif
+#ifndef SKIP_NET_RH_DEADBAND_PCT
+#define SKIP_NET_RH_DEADBAND_PCT 1.0f
+#endif
+#ifndef SKIP_NET_PRESS_DEADBAND_HPA
+#define SKIP_NET_PRESS_DEADBAND_HPA 0.5f
+#endif
+#ifndef SKIP_NET_HEARTBEAT_SEC
+#define SKIP_NET_HEARTBEAT_SEC 1800
+#endif
+// Adaptive sleep: longest trend-planned interval (flat readings); the
+// shortest is the rapid-update interval, or the low-battery one on low
+// battery. Keep <= SKIP_NET_HEARTBEAT_SEC so the heartbeat is not stretched.
+#ifndef SLEEP_MAX_INTERVAL_SEC
+#define SLEEP_MAX_INTERVAL_SEC 1800
+#endif
+// NTP scheduling: the clock is kept through deep sleep with its measured drift
+// taken out, and NTP is queried again only once the estimated error passes
+// NTP_MAX_ERROR_MS or NTP_MAX_INTERVAL_SEC has elapsed since the last sync
+#ifndef NTP_MAX_ERROR_MS
+#define NTP_MAX_ERROR_MS 10000
+#endif
+#ifndef NTP_MAX_INTERVAL_SEC
+#define NTP_MAX_INTERVAL_SEC 86400
+#endif
+#ifndef NTP_TIMEZONE
+#define NTP_TIMEZONE "EST5EDT,M3.2.0,M11.1.0"
+#endif
+// Idle light sleep (FEATURE_IDLE_LIGHT_SLEEP): longest single wait in the
+// always-on loops (well inside the MQTT keepalive and the 30 s watchdog), and
+// how often serial input is checked while a console is attached
+#ifndef IDLE_WAIT_MAX_MS
+#define IDLE_WAIT_MAX_MS 5000
+#endif
+#ifndef IDLE_SERIAL_POLL_MS
+#define IDLE_SERIAL_POLL_MS 100
+#endif
+// CPU frequency scaling (FEATURE_CPU_FREQ_SCALING): clock for phases that
+// mostly wait on I/O (WiFi, MQTT, I2C, panel BUSY) and for render/CRC bursts.
+// Rounded up to 10/20/40/80/160/240; never below 80 while WiFi is on.
+#ifndef CPU_FREQ_IO_MHZ
+#define CPU_FREQ_IO_MHZ 80
+#endif
+#ifndef CPU_FREQ_COMPUTE_MHZ
+#define CPU_FREQ_COMPUTE_MHZ 240
+#endif
+// ULP sampling (FEATURE_ULP_SAMPLING): sensor period while the main cores
+// sleep; the wake interval stays the heartbeat
+#ifndef ULP_SAMPLE_PERIOD_SEC
+#define ULP_SAMPLE_PERIOD_SEC 60
+#endif
+// Delta OTA (FEATURE_OTA_DELTA): patch bytes per data message (fits
+// MQTT_MAX_PACKET_SIZE with the topic and 8-byte header), bytes asked for per
+// request, time one wake may spend receiving, how long to wait for a chunk
+// before asking again, and the battery floor below which no update runs
+#ifndef OTA_CHUNK_BYTES
+#define OTA_CHUNK_BYTES 768
+#endif
+#ifndef OTA_REQUEST_BYTES
+#define OTA_REQUEST_BYTES 6144
+#endif
+#ifndef OTA_WAKE_BUDGET_MS
+#define OTA_WAKE_BUDGET_MS 1500
+#endif
+#ifndef OTA_CHUNK_TIMEOUT_MS
+#define OTA_CHUNK_TIMEOUT_MS 1000
+#endif
+#ifndef OTA_MIN_BATTERY_PCT
+#define OTA_MIN_BATTERY_PCT 30
+#endif
+// Store-and-forward: sample on every wake but only bring up the radio every
+// Nth timer wake (or when a reading leaves its deadband); held samples are
+// sent as one /history batch. 1 = off. The heartbeat does not apply in this
+// mode - N bounds staleness. Keep N <= 16 so a batch fits one publish.
+#ifndef STORE_FORWARD_WAKES
+#define STORE_FORWARD_WAKES 1
+#endif
+// Packed state: send the per-wake readings as one JSON document on
+// espsensor/<id>/state instead of one PUBLISH per topic (HA discovery
+// switches to value_json templates). 0 = classic per-topic publishing.
+#ifndef MQTT_PACKED_STATE
+#define MQTT_PACKED_STATE 0
+#endif
+// Skip republishing Home Assistant discovery when the CRC of the config set
+// matches the one stored in NVS. Set to 0 for brokers without retained-message
+// persistence, where configs are lost on a broker restart.
+#ifndef HA_DISCOVERY_SKIP_UNCHANGED
+#define HA_DISCOVERY_SKIP_UNCHANGED 1
+#endif
+// Retained diagnostics document (diag_document.h): republished unchanged every
+// N network wakes so a broker that lost it gets it back. 0 = only on change.
+#ifndef DIAG_DOC_HEARTBEAT_WAKES
+#define DIAG_DOC_HEARTBEAT_WAKES 24
+#endif
+
+// Persistent MQTT session: connect with clean_session=false and subscribe to
+// commands at QoS1 so the broker keeps the subscriptions and queues commands
+// sent while the device sleeps. Subscriptions are refreshed every N resumed
+// connects in case the broker expired the session.
+#ifndef MQTT_PERSISTENT_SESSION
+#define MQTT_PERSISTENT_SESSION 0
+#endif
+#ifndef MQTT_SESSION_RESUBSCRIBE_CONNECTS
+#define MQTT_SESSION_RESUBSCRIBE_CONNECTS 24
+#endif
+
+// MQTT over TLS (tls_client.h): connect to MQTT_PORT (normally 8883) through
+// mbedTLS and keep the negotiated session in RTC memory, so later wakes get an
+// abbreviated handshake. MQTT_TLS_CA_CERT is the broker's CA as a PEM string
+// (build_flags); without it the broker certificate is not verified. A cached
+// session is offered for the server's ticket lifetime, at most
+// TLS_SESSION_MAX_AGE_SEC; TLS_SESSION_CACHE_BYTES must hold the serialized
+// session, which includes the peer certificate when mbedTLS keeps it.
+#ifndef MQTT_TLS
+#define MQTT_TLS 0
+#endif
+#ifndef TLS_SESSION_CACHE_BYTES
+#define TLS_SESSION_CACHE_BYTES 1536
+#endif
+#ifndef TLS_SESSION_MAX_AGE_SEC
+#define TLS_SESSION_MAX_AGE_SEC 86400
+#endif
+#ifndef TLS_HANDSHAKE_TIMEOUT_MS
+#define TLS_HANDSHAKE_TIMEOUT_MS 5000
+#endif
+
+// Compact telemetry: also publish a 21-byte binary frame (telemetry_frame.h)
+// on espsensor/<id>/telemetry each wake. Text topics are unchanged.
+#ifndef MQTT_COMPACT_TELEMETRY
+#define MQTT_COMPACT_TELEMETRY 0
+#endif
+
+// ESP-NOW transport (espnow_link.h): report wakes send the telemetry frame
+// to a gateway node over ESP-NOW on the AP's channel (cached from the last
+// association) instead of joining WiFi and the broker. Every
+// ESPNOW_MQTT_EVERY_N_WAKES wakes, and whenever no gateway acks, the wake
+// takes the normal WiFi/MQTT path so commands, config, OTA and the clock
+// still get through. ESPNOW_GATEWAY_MAC ("aa:bb:cc:dd:ee:ff", build_flags) is
+// required: reports go by acked unicast, since a broadcast is never acked.
+// The gateway build (ESPNOW_GATEWAY) stays awake and republishes each
+// report on the sender's espsensor/<mac>/ topics. Frames are not encrypted.
+#ifndef ESPNOW_TRANSPORT
+#define ESPNOW_TRANSPORT 0
+#endif
+#ifndef ESPNOW_GATEWAY
+#define ESPNOW_GATEWAY 0
+#endif
+#ifndef ESPNOW_MQTT_EVERY_N_WAKES
+#define ESPNOW_MQTT_EVERY_N_WAKES 12
+#endif
+#ifndef ESPNOW_SEND_ATTEMPTS
+#define ESPNOW_SEND_ATTEMPTS 3
+#endif
+#ifndef ESPNOW_ACK_TIMEOUT_MS
+#define ESPNOW_ACK_TIMEOUT_MS 30
+#endif
+#ifndef ESPNOW_GATEWAY_MAX_SENDERS
+#define ESPNOW_GATEWAY_MAX_SENDERS 16
+#endif
+
+// Inside rolling aggregates (FEATURE_INSIDE_STATS): the two window lengths.
+// Each window has a fixed number of RTC buckets (rolling_stats.h), so a
+// longer window gets wider buckets; changing a length restarts its window.
+#ifndef INSIDE_STATS_SHORT_WINDOW_SEC
+#define INSIDE_STATS_SHORT_WINDOW_SEC 3600
+#endif
+#ifndef INSIDE_STATS_LONG_WINDOW_SEC
+#define INSIDE_STATS_LONG_WINDOW_SEC 86400
+#endif
+
+// UI-spec renderer: partial-refresh only the rects whose content changed,
+// with a full refresh every FULL_REFRESH_EVERY partials to clear ghosting.
+// 0 restores a full-window redraw every wake.
+#ifndef SPEC_PARTIAL_REFRESH
+#define SPEC_PARTIAL_REFRESH 1
+#endif
+
+// Most partial windows per wake; dirty rects are merged down to this many
+#ifndef SPEC_PARTIAL_MAX_WINDOWS
+#define SPEC_PARTIAL_MAX_WINDOWS 2
+#endif
+
+// UI-spec layout by battery level (ui_variant_select.h): UI_VARIANT_BASE
+// while healthy (ui::UIVAR_LARGE_DIGIT for a panel read from across the
+// room), compact below UI_COMPACT_BELOW_PCT, the minimal low-battery layout
+// below UI_LOW_BATTERY_BELOW_PCT (0 disables a tier). A layout change
+// forces a full refresh.
+#ifndef UI_VARIANT_BASE
+#define UI_VARIANT_BASE ui::UIVAR_V2
+#endif
+#ifndef UI_COMPACT_BELOW_PCT
+#define UI_COMPACT_BELOW_PCT 30
+#endif
+#ifndef UI_LOW_BATTERY_BELOW_PCT
+#define UI_LOW_BATTERY_BELOW_PCT 15
+#endif
+#ifndef UI_VARIANT_HYSTERESIS_PCT
+#define UI_VARIANT_HYSTERESIS_PCT 5
+#endif
+
+// Render spec frames once into the screenshot canvas and blit it to the panel
+// (one RAM write per wake) instead of paging through GxEPD2 per window
+#ifndef SPEC_CANVAS_BLIT
+#define SPEC_CANVAS_BLIT 1
+#endif
+
+// Send full-row panel RAM writes (the blitted frame, GxEPD2 pages) as one
+// SPI DMA burst instead of a SPI.transfer() per byte (panel_dma.h). The
+// SSD1680 accepts writes up to 20 MHz; GxEPD2 clocks its own at 4 MHz.
+#ifndef DISPLAY_SPI_DMA
+#define DISPLAY_SPI_DMA 1
+#endif
+#ifndef DISPLAY_SPI_DMA_HZ
+#define DISPLAY_SPI_DMA_HZ 10000000
+#endif
+
+// Leave the panel asleep (no SPI init, no controller wake) on wakes whose
+// render model matches the frame already shown and no full refresh is due
+// Run the blitted frame's waveform (the panel BUSY wait) on a background
+// task so network work overlaps it; the sleep phase waits for it to finish
+#ifndef DISPLAY_ASYNC_REFRESH
+#define DISPLAY_ASYNC_REFRESH 1
+#endif
+
+// On warm wakes with cached outside data, draw the frame before WiFi comes up
+// and redraw (partially, only the rects that differ) once retained data lands
+#ifndef DISPLAY_RENDER_BEFORE_NETWORK
+#define DISPLAY_RENDER_BEFORE_NETWORK 1
+#endif
+
+#ifndef DISPLAY_SKIP_UNCHANGED_FRAMES
+#define DISPLAY_SKIP_UNCHANGED_FRAMES 1
+#endif
+
+// Keep the previously displayed frame next to the canvas (PSRAM if present,
+// else 3.9 KB of DRAM) and take partial windows from a pixel diff of the two;
+// covers the second draw of a wake (DISPLAY_RENDER_BEFORE_NETWORK) and
+// DEV_NO_SLEEP sessions, since the copy does not survive deep sleep
+#ifndef DISPLAY_DOUBLE_BUFFER
+#define DISPLAY_DOUBLE_BUFFER 0
+#endif
+
 // Debounce window to coalesce multiple MQTT outside updates before a draw
 #ifndef MQTT_OUTSIDE_DEBOUNCE_MS
 #define MQTT_OUTSIDE_DEBOUNCE_MS 1200
 #endif
 
+// Energy model: average current per phase in mA. CPU covers the whole awake
+// time; radio and panel figures are adders on top of it while they are on.
+// Calibrate against a bench meter for the board in use. TX share is the
+// fraction of radio-on time spent transmitting.
+#ifndef ENERGY_MA_CPU
+#define ENERGY_MA_CPU 30.0f
+#endif
+#ifndef ENERGY_MA_RADIO_RX
+#define ENERGY_MA_RADIO_RX 40.0f
+#endif
+#ifndef ENERGY_MA_RADIO_TX
+#define ENERGY_MA_RADIO_TX 150.0f
+#endif
+#ifndef ENERGY_MA_PANEL
+#define ENERGY_MA_PANEL 4.0f
+#endif
+#ifndef ENERGY_MA_SLEEP
+#define ENERGY_MA_SLEEP 0.1f
+#endif
+#ifndef ENERGY_RADIO_TX_SHARE
+#define ENERGY_RADIO_TX_SHARE 0.1f
+#endif
+#ifndef BATTERY_CAPACITY_MAH
+#define BATTERY_CAPACITY_MAH 3000
+#endif
+
+// Count every heap allocation per wake phase (memory_tracking.cpp). Needs the
+// allocator wrapped at link time:
+//   -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc -Wl,--wrap=free
+#ifndef MEMORY_ALLOC_HOOKS
+#define MEMORY_ALLOC_HOOKS 0
+#endif
+// Records kept by IDF standalone heap tracing, when the SDK config enables it
+#ifndef MEMORY_HEAP_TRACE_RECORDS
+#define MEMORY_HEAP_TRACE_RECORDS 64
+#endif
+
+// fast_crc32 implementation: ROM crc32_le routine, slicing-by-4 tables
+// (4 KB RAM) or the bitwise loop; all produce the same CRC-32
+#define CRC32_IMPL_BITWISE 0
+#define CRC32_IMPL_TABLE 1
+#define CRC32_IMPL_ROM 2
+#ifndef CRC32_IMPL
+#define CRC32_IMPL CRC32_IMPL_ROM
+#endif
+
+// Keys the NVS write-back cache tracks per wake (system_manager.cpp); stores
+// past this write through immediately
+#ifndef NVS_CACHE_KEYS
+#define NVS_CACHE_KEYS 16
+#endif
+
+// Per-wake bump arena for transient JSON and formatting (wake_arena.h); reset
+// at run_sleep_phase(). Size from "peak_max" in the arena debug command.
+#ifndef WAKE_ARENA_BYTES
+#define WAKE_ARENA_BYTES 4096
+#endif
+
 // Logging system configuration
 #ifndef LOG_ENABLED
 #define LOG_ENABLED 1
@@ -113,6 +470,22 @@
 #define LOG_MQTT_RATE_LIMIT_MS 1000
 #endif
 
+// Record format pointer + raw args per entry and format only when an entry
+// is printed or published (takes effect while the Serial sink is off)
+#ifndef LOG_DEFERRED_FORMAT
+#define LOG_DEFERRED_FORMAT 1
+#endif
+
+// Persist logs to an append-only ring on a dedicated flash partition instead
+// of NVS blobs; needs board_build.partitions = partitions_flashlog.csv
+#ifndef LOG_FLASH_ENABLED
+#define LOG_FLASH_ENABLED 0
+#endif
+
+#ifndef LOG_FLASH_PARTITION_LABEL
+#define LOG_FLASH_PARTITION_LABEL "flashlog"
+#endif
+
 // Status pixel configuration 
 #ifndef USE_STATUS_PIXEL
 #define USE_STATUS_PIXEL 0
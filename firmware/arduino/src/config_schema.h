@@ -0,0 +1,94 @@
+#pragma once
+
+// Configuration schema rows
+// scripts/gen_device_header.py emits two constexpr tables into
+// generated_config.h: CONFIG_RANGES (numeric settings with their limits and
+// fallback) and CONFIG_STRINGS (string settings with their length limits).
+// Every row carries the FNV-1a hash of its device.yaml key. Strict rows are
+// checked with static_assert, so an out-of-range value or an over-long string
+// stops the build; config_validator.h walks both tables once at boot for what
+// can only be judged at runtime (empty strings, advisory ranges).
+//
+// Usage:
+//   static constexpr ConfigRange ranges[] = {
+//       {"wake_interval", 0x1234abcdu, WAKE_INTERVAL_SEC, 60, 86400, 3600, CONFIG_STRICT},
+//   };
+//   static_assert(config_range_ok(ranges[0]), "wake_interval out of range");
+//   const ConfigRange* r = config_find(ranges, 1, config_key_hash("wake_interval"));
+//
+// Everything here is C++11 constexpr (single-return, recursive) so it works
+// in the device build.
+
+#include <cstddef>
+#include <cstdint>
+
+enum ConfigSeverity : uint8_t {
+    CONFIG_STRICT = 0,      // Build fails when out of range
+    CONFIG_ADVISORY         // Logged at boot, firmware carries on
+};
+
+struct ConfigRange {
+    const char* key;        // device.yaml path, e.g. "mqtt.port"
+    uint32_t key_hash;      // config_key_hash(key), emitted by the generator
+    float value;
+    float min;
+    float max;
+    float fallback;         // Safe value when out of range
+    uint8_t severity;       // ConfigSeverity
+};
+
+struct ConfigString {
+    const char* key;
+    uint32_t key_hash;
+    const char* value;
+    uint16_t length;        // sizeof(literal) - 1
+    uint16_t min_len;       // Checked at runtime (unconfigured builds still compile)
+    uint16_t max_len;       // Checked at compile time
+};
+
+static constexpr uint32_t CONFIG_FNV_OFFSET = 0x811C9DC5u;
+static constexpr uint32_t CONFIG_FNV_PRIME = 0x01000193u;
+
+// FNV-1a over the key; matches key_hash() in gen_device_header.py
+constexpr uint32_t config_key_hash(const char* s, uint32_t h = CONFIG_FNV_OFFSET) {
+    return *s ? config_key_hash(s + 1, (h ^ (uint8_t)*s) * CONFIG_FNV_PRIME) : h;
+}
+
+constexpr bool config_range_ok(const ConfigRange& r) {
+    return r.value >= r.min && r.value <= r.max;
+}
+
+constexpr bool config_string_fits(const ConfigString& s) {
+    return s.length <= s.max_len;
+}
+
+constexpr bool config_string_ok(const ConfigString& s) {
+    return s.length >= s.min_len && s.length <= s.max_len;
+}
+
+// Every row's emitted hash agrees with config_key_hash(key)
+template <typename Row>
+constexpr bool config_hashes_match(const Row* rows, size_t n) {
+    return n == 0 || (rows[0].key_hash == config_key_hash(rows[0].key) &&
+                      config_hashes_match(rows + 1, n - 1));
+}
+
+template <typename Row>
+constexpr bool config_hash_absent(const Row* rows, size_t n, uint32_t hash) {
+    return n == 0 || (rows[0].key_hash != hash && config_hash_absent(rows + 1, n - 1, hash));
+}
+
+template <typename Row>
+constexpr bool config_hashes_unique(const Row* rows, size_t n) {
+    return n < 2 || (config_hash_absent(rows + 1, n - 1, rows[0].key_hash) &&
+                     config_hashes_unique(rows + 1, n - 1));
+}
+
+// Row with the given key hash, or nullptr
+template <typename Row>
+inline const Row* config_find(const Row* rows, size_t n, uint32_t hash) {
+    for (size_t i = 0; i < n; i++) {
+        if (rows[i].key_hash == hash) return &rows[i];
+    }
+    return nullptr;
+}
@@ -2,23 +2,34 @@
 #pragma once
 
 #include "generated_config.h"
+#include "config_schema.h"
 #include "error_codes.h"
 #include "logging.h"
 #include <Arduino.h>
 #include <IPAddress.h>
 
-// Configuration limits
-#define MIN_WAKE_INTERVAL_SEC 60        // 1 minute
-#define MAX_WAKE_INTERVAL_SEC 86400     // 24 hours
-#define MIN_FULL_REFRESH 1
-#define MAX_FULL_REFRESH 100
-#define MIN_MQTT_PORT 1
-#define MAX_MQTT_PORT 65535
-#define MAX_SSID_LENGTH 32
-#define MAX_PASSWORD_LENGTH 64
-#define MAX_HOSTNAME_LENGTH 63
-#define MIN_ACTIVE_SECONDS 5
-#define MAX_ACTIVE_SECONDS 300          // 5 minutes
+// Limits and fallbacks live in the CONFIG_RANGES / CONFIG_STRINGS tables that
+// gen_device_header.py emits into generated_config.h. Strict ranges and
+// string lengths are already enforced there with static_assert; what is left
+// for boot is one pass over both tables (config_schema.h).
+
+// Error reported for a string setting that fails its runtime check
+struct ConfigStringError {
+  uint32_t key_hash;
+  ErrorCode error;
+};
+
+static constexpr ConfigStringError CONFIG_STRING_ERRORS[] = {
+  {config_key_hash("wifi.ssid"), ERR_WIFI_INVALID_SSID},
+  {config_key_hash("wifi.password"), ERR_WIFI_INVALID_PASSWORD},
+  {config_key_hash("mqtt.host"), ERR_MQTT_INVALID_TOPIC},  // Reusing for host validation
+};
+
+inline ErrorCode config_string_error(uint32_t key_hash) {
+  const ConfigStringError* e = config_find(CONFIG_STRING_ERRORS,
+      sizeof(CONFIG_STRING_ERRORS) / sizeof(CONFIG_STRING_ERRORS[0]), key_hash);
+  return e ? e->error : ERR_CONFIG_INVALID;
+}
 
 // Safe mode configuration (minimal operation)
 struct SafeModeConfig {
@@ -38,19 +49,6 @@ struct ValidationResult {
   const char* error_message;
 };
 
-// Validate string is not empty and within length limits
-inline bool validate_string(const char* str, size_t max_len, const char* field_name) {
-  if (!str || strlen(str) == 0) {
-    LOG_ERROR("Config: %s is empty", field_name);
-    return false;
-  }
-  if (strlen(str) > max_len) {
-    LOG_ERROR("Config: %s too long (%d > %d)", field_name, strlen(str), max_len);
-    return false;
-  }
-  return true;
-}
-
 // Validate IP address string format
 inline bool validate_ip_address(const char* ip_str) {
   if (!ip_str || strlen(ip_str) == 0) return true;  // Empty is OK (not required)
@@ -63,87 +61,53 @@ inline bool validate_ip_address(const char* ip_str) {
   return true;
 }
 
-// Main configuration validation function
+// Main configuration validation function: one pass over the generated tables,
+// reporting every failing row and returning the first error
 inline ErrorCode validate_config() {
   LOG_INFO("Validating configuration...");
-  
-  // Wake interval validation
-  if (WAKE_INTERVAL_SEC < MIN_WAKE_INTERVAL_SEC || WAKE_INTERVAL_SEC > MAX_WAKE_INTERVAL_SEC) {
-    LOG_ERROR("Config: wake_interval out of range: %d (must be %d-%d)", 
-              WAKE_INTERVAL_SEC, MIN_WAKE_INTERVAL_SEC, MAX_WAKE_INTERVAL_SEC);
-    return ERR_CONFIG_OUT_OF_RANGE;
-  }
-  LOG_DEBUG("Config: wake_interval = %d seconds", WAKE_INTERVAL_SEC);
-  
-  // Full refresh validation
-  if (FULL_REFRESH_EVERY < MIN_FULL_REFRESH || FULL_REFRESH_EVERY > MAX_FULL_REFRESH) {
-    LOG_ERROR("Config: full_refresh_every out of range: %d (must be %d-%d)",
-              FULL_REFRESH_EVERY, MIN_FULL_REFRESH, MAX_FULL_REFRESH);
-    return ERR_CONFIG_OUT_OF_RANGE;
-  }
-  LOG_DEBUG("Config: full_refresh_every = %d", FULL_REFRESH_EVERY);
-  
-  // WiFi configuration validation
-  if (!validate_string(WIFI_SSID, MAX_SSID_LENGTH, "WiFi SSID")) {
-    return ERR_WIFI_INVALID_SSID;
-  }
-  if (!validate_string(WIFI_PASS, MAX_PASSWORD_LENGTH, "WiFi password")) {
-    return ERR_WIFI_INVALID_PASSWORD;
-  }
-  LOG_DEBUG("Config: WiFi SSID = %s", WIFI_SSID);
-  
-  // MQTT configuration validation
-  if (!validate_string(MQTT_HOST, MAX_HOSTNAME_LENGTH, "MQTT host")) {
-    return ERR_MQTT_INVALID_TOPIC;  // Reusing for host validation
-  }
-  if (MQTT_PORT < MIN_MQTT_PORT || MQTT_PORT > MAX_MQTT_PORT) {
-    LOG_ERROR("Config: MQTT port out of range: %d (must be %d-%d)",
-              MQTT_PORT, MIN_MQTT_PORT, MAX_MQTT_PORT);
-    return ERR_CONFIG_OUT_OF_RANGE;
+  ErrorCode first = ERR_NONE;
+  
+  for (size_t i = 0; i < CONFIG_RANGE_COUNT; i++) {
+    const ConfigRange& r = CONFIG_RANGES[i];
+    if (config_range_ok(r)) {
+      LOG_DEBUG("Config: %s = %g", r.key, r.value);
+    } else if (r.severity == CONFIG_STRICT) {
+      LOG_ERROR("Config: %s out of range: %g (must be %g-%g)", r.key, r.value, r.min, r.max);
+      if (first == ERR_NONE) first = ERR_CONFIG_OUT_OF_RANGE;
+    } else {
+      LOG_WARN("Config: %s unusual: %g (expected %g-%g)", r.key, r.value, r.min, r.max);
+    }
   }
-  LOG_DEBUG("Config: MQTT host = %s:%d", MQTT_HOST, MQTT_PORT);
   
-  // Room name validation
-  if (!validate_string(ROOM_NAME, MAX_HOSTNAME_LENGTH, "Room name")) {
-    return ERR_CONFIG_INVALID;
+  for (size_t i = 0; i < CONFIG_STRING_COUNT; i++) {
+    const ConfigString& s = CONFIG_STRINGS[i];
+    if (config_string_ok(s)) continue;
+    if (s.length < s.min_len) {
+      LOG_ERROR("Config: %s is empty", s.key);
+    } else {
+      LOG_ERROR("Config: %s too long (%u > %u)", s.key, s.length, s.max_len);
+    }
+    if (first == ERR_NONE) first = config_string_error(s.key_hash);
   }
-  LOG_DEBUG("Config: Room name = %s", ROOM_NAME);
+  LOG_DEBUG("Config: WiFi SSID = %s, MQTT = %s:%d", WIFI_SSID, MQTT_HOST, MQTT_PORT);
   
   // Optional IP configuration validation
   #ifdef WIFI_STATIC_IP
-  if (!validate_ip_address(WIFI_STATIC_IP)) {
-    return ERR_CONFIG_INVALID;
+  if (!validate_ip_address(WIFI_STATIC_IP) && first == ERR_NONE) {
+    first = ERR_CONFIG_INVALID;
   }
   #endif
   
-  #ifdef WIFI_STATIC_GW
-  if (!validate_ip_address(WIFI_STATIC_GW)) {
-    return ERR_CONFIG_INVALID;
+  #ifdef WIFI_STATIC_GATEWAY
+  if (!validate_ip_address(WIFI_STATIC_GATEWAY) && first == ERR_NONE) {
+    first = ERR_CONFIG_INVALID;
   }
   #endif
   
-  // Active seconds validation (if defined)
-  #ifdef ACTIVE_SECONDS
-  if (ACTIVE_SECONDS < MIN_ACTIVE_SECONDS || ACTIVE_SECONDS > MAX_ACTIVE_SECONDS) {
-    LOG_WARN("Config: active_seconds out of range: %d (using default)", ACTIVE_SECONDS);
+  if (first == ERR_NONE) {
+    LOG_INFO("Configuration validation successful");
   }
-  #endif
-  
-  // Threshold validations
-  #ifdef THRESH_TEMP_DEGC
-  if (THRESH_TEMP_DEGC <= 0 || THRESH_TEMP_DEGC > 10) {
-    LOG_WARN("Config: temp threshold unusual: %.2f°C", THRESH_TEMP_DEGC);
-  }
-  #endif
-  
-  #ifdef THRESH_RH_PCT
-  if (THRESH_RH_PCT <= 0 || THRESH_RH_PCT > 20) {
-    LOG_WARN("Config: humidity threshold unusual: %.1f%%", THRESH_RH_PCT);
-  }
-  #endif
-  
-  LOG_INFO("Configuration validation successful");
-  return ERR_NONE;
+  return first;
 }
 
 // Enter safe mode with minimal configuration
@@ -216,25 +180,12 @@ inline void apply_safe_defaults() {
   
   // This would need to modify the config at runtime
   // Since we're using #defines, we can't change them
-  // Instead, we track what needs to be overridden
-  
-  static struct {
-    uint32_t wake_interval_sec;
-    uint32_t full_refresh_every;
-    bool use_defaults;
-  } safe_config = {0, 0, false};
-  
-  // Check and note needed overrides
-  if (WAKE_INTERVAL_SEC < MIN_WAKE_INTERVAL_SEC || WAKE_INTERVAL_SEC > MAX_WAKE_INTERVAL_SEC) {
-    safe_config.wake_interval_sec = 3600;  // 1 hour default
-    safe_config.use_defaults = true;
-    LOG_WARN("Will use safe wake interval: %d", safe_config.wake_interval_sec);
-  }
-  
-  if (FULL_REFRESH_EVERY < MIN_FULL_REFRESH || FULL_REFRESH_EVERY > MAX_FULL_REFRESH) {
-    safe_config.full_refresh_every = 10;
-    safe_config.use_defaults = true;
-    LOG_WARN("Will use safe full refresh: %d", safe_config.full_refresh_every);
+  // Instead, we report the fallback each out-of-range row would take
+  for (size_t i = 0; i < CONFIG_RANGE_COUNT; i++) {
+    const ConfigRange& r = CONFIG_RANGES[i];
+    if (!config_range_ok(r)) {
+      LOG_WARN("Will use safe %s: %g", r.key, r.fallback);
+    }
   }
 }
 
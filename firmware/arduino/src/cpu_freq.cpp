@@ -0,0 +1,72 @@
+// CPU frequency scaling implementation
+
+#include "cpu_freq.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_timer.h>
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+static const CpuFreqPolicy g_policy = default_cpu_freq_policy();
+static uint16_t g_mhz = 0;
+static uint32_t g_low_since_us = 0;   // Start of the current low-clock stretch
+static uint32_t g_low_total_us = 0;   // Closed low-clock stretches
+static bool g_light_sleep = false;
+
+static uint32_t now_us() {
+  return (uint32_t)esp_timer_get_time();
+}
+
+static bool apply(uint16_t mhz) {
+#if CONFIG_PM_ENABLE
+  esp_pm_config_esp32s2_t pm = {};
+  pm.max_freq_mhz = mhz;
+  pm.min_freq_mhz = mhz < CPU_FREQ_IO_MHZ ? mhz : CPU_FREQ_IO_MHZ;
+  pm.light_sleep_enable = g_light_sleep;
+  return esp_pm_configure(&pm) == ESP_OK;
+#else
+  return setCpuFrequencyMhz(mhz);
+#endif
+}
+
+void cpu_freq_enter(CpuPhase phase) {
+  bool radio_on = WiFi.getMode() != WIFI_MODE_NULL;
+  uint16_t mhz = cpu_freq_for_phase(g_policy, phase, radio_on);
+  uint16_t cur = g_mhz ? g_mhz : (uint16_t)getCpuFrequencyMhz();
+  if (mhz == cur) {
+    g_mhz = cur;
+    return;
+  }
+  if (!apply(mhz)) {
+    Serial.printf("[CPU] %u MHz rejected for %s\n", mhz, cpu_phase_name(phase));
+    return;
+  }
+
+  uint32_t now = now_us();
+  if (g_mhz && g_mhz < CPU_FREQ_COMPUTE_MHZ) g_low_total_us += now - g_low_since_us;
+  if (mhz < CPU_FREQ_COMPUTE_MHZ) g_low_since_us = now;
+  g_mhz = mhz;
+}
+
+uint16_t cpu_freq_mhz() {
+  return g_mhz;
+}
+
+uint32_t cpu_freq_low_clock_us() {
+  uint32_t total = g_low_total_us;
+  if (g_mhz && g_mhz < CPU_FREQ_COMPUTE_MHZ) total += now_us() - g_low_since_us;
+  return total;
+}
+
+bool cpu_freq_light_sleep(bool enable) {
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  g_light_sleep = enable;
+  if (apply(g_mhz ? g_mhz : (uint16_t)getCpuFrequencyMhz())) return enable;
+  g_light_sleep = false;
+  return false;
+#else
+  (void)enable;
+  return false;
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+// CPU frequency scaling per wake phase (FEATURE_CPU_FREQ_SCALING)
+// Each phase of the wake asks for the clock cpu_freq_policy.h gives it; the
+// switch is skipped when the clock is already right. Without esp_pm the
+// clock is set directly (setCpuFrequencyMhz). With CONFIG_PM_ENABLE the
+// phase clock becomes the DFS ceiling and the I/O clock its floor, and the
+// WiFi driver decides in between: with wifi_configure_power_save(true) it
+// releases its APB lock between beacons and lets DFS drop, with power save
+// off it holds the ceiling for as long as the radio is up.
+//
+// Usage:
+//   CPU_PHASE(RENDER);
+//   full_refresh();
+//   CPU_PHASE(WAIT);
+//   display_wait_idle(timeout);
+
+#include <stdint.h>
+#include "feature_flags.h"
+#include "cpu_freq_policy.h"
+
+void cpu_freq_enter(CpuPhase phase);
+
+// Clock the last cpu_freq_enter() asked for (0 before the first call)
+uint16_t cpu_freq_mhz();
+
+// Microseconds of this wake spent below CPU_FREQ_COMPUTE_MHZ
+uint32_t cpu_freq_low_clock_us();
+
+// Let esp_pm light-sleep the chip whenever every task is blocked; true only
+// when it is now on (needs CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+bool cpu_freq_light_sleep(bool enable);
+
+#if FEATURE_CPU_FREQ_SCALING
+  #define CPU_PHASE(p) cpu_freq_enter(CpuPhase::p)
+#else
+  #define CPU_PHASE(p) ((void)0)
+#endif
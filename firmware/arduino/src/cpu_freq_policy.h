@@ -0,0 +1,75 @@
+#pragma once
+
+// Per-phase CPU frequency policy
+// Most of a wake is spent blocked: WiFi association, MQTT round trips, the
+// e-paper BUSY line. Those phases run at CPU_FREQ_IO_MHZ; rendering and the
+// frame CRC run at CPU_FREQ_COMPUTE_MHZ. While the radio is up the clock never
+// drops below 80 MHz, the minimum the WiFi driver supports (APB stays at
+// 80 MHz, so UART and I2C timing are unaffected by any switch here).
+//
+// Usage:
+//   CpuFreqPolicy policy = default_cpu_freq_policy();
+//   uint16_t mhz = cpu_freq_for_phase(policy, CpuPhase::RENDER, wifi_on);
+
+#include <cstdint>
+#include "config.h"
+
+enum class CpuPhase : uint8_t {
+  BOOT = 0,       // Serial, NVS cache, power init
+  SENSOR,         // I2C conversions
+  CONNECT,        // WiFi association, MQTT connect
+  PUBLISH,        // MQTT publishes and round trips
+  RENDER,         // Frame build, CRC, panel transfer
+  WAIT,           // Blocked on the panel BUSY line
+  SLEEP,          // NVS/log commit, RTC seal
+  COUNT
+};
+
+static constexpr uint16_t CPU_FREQ_RADIO_MIN_MHZ = 80;
+
+struct CpuFreqPolicy {
+  uint16_t mhz[(uint8_t)CpuPhase::COUNT];
+};
+
+inline CpuFreqPolicy default_cpu_freq_policy() {
+  CpuFreqPolicy p;
+  p.mhz[(uint8_t)CpuPhase::BOOT] = CPU_FREQ_IO_MHZ;
+  p.mhz[(uint8_t)CpuPhase::SENSOR] = CPU_FREQ_IO_MHZ;
+  p.mhz[(uint8_t)CpuPhase::CONNECT] = CPU_FREQ_IO_MHZ;
+  p.mhz[(uint8_t)CpuPhase::PUBLISH] = CPU_FREQ_IO_MHZ;
+  p.mhz[(uint8_t)CpuPhase::RENDER] = CPU_FREQ_COMPUTE_MHZ;
+  p.mhz[(uint8_t)CpuPhase::WAIT] = CPU_FREQ_IO_MHZ;
+  p.mhz[(uint8_t)CpuPhase::SLEEP] = CPU_FREQ_IO_MHZ;
+  return p;
+}
+
+// Nearest frequency at or above mhz the S2 can run from its 40 MHz crystal
+// (PLL: 240, 160, 80; XTAL dividers: 40, 20, 10)
+inline uint16_t cpu_freq_supported(uint16_t mhz) {
+  if (mhz > 160) return 240;
+  if (mhz > 80) return 160;
+  if (mhz > 40) return 80;
+  if (mhz > 20) return 40;
+  if (mhz > 10) return 20;
+  return 10;
+}
+
+inline uint16_t cpu_freq_for_phase(const CpuFreqPolicy& policy, CpuPhase phase, bool radio_on) {
+  uint8_t i = (uint8_t)phase;
+  uint16_t mhz = i < (uint8_t)CpuPhase::COUNT ? policy.mhz[i] : CPU_FREQ_COMPUTE_MHZ;
+  if (radio_on && mhz < CPU_FREQ_RADIO_MIN_MHZ) mhz = CPU_FREQ_RADIO_MIN_MHZ;
+  return cpu_freq_supported(mhz);
+}
+
+inline const char* cpu_phase_name(CpuPhase phase) {
+  switch (phase) {
+    case CpuPhase::BOOT:    return "boot";
+    case CpuPhase::SENSOR:  return "sensor";
+    case CpuPhase::CONNECT: return "connect";
+    case CpuPhase::PUBLISH: return "publish";
+    case CpuPhase::RENDER:  return "render";
+    case CpuPhase::WAIT:    return "wait";
+    case CpuPhase::SLEEP:   return "sleep";
+    default:                return "?";
+  }
+}
@@ -4,6 +4,30 @@
 
 // RTC memory - persists across resets
 RTC_DATA_ATTR CrashHandler::CrashInfo CrashHandler::crash_info_ = {};
+RTC_DATA_ATTR CrashBreadcrumbs CrashHandler::breadcrumbs_ = {};
+RTC_DATA_ATTR bool CrashHandler::panic_captured_ = false;
+
+// Arduino core panic hook: runs in the panic handler before the reset, so it
+// only copies into RTC memory
+#if defined(ESP_ARDUINO_VERSION_VAL)
+#if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(2, 0, 7)
+#define CRASH_PANIC_HOOK 1
+#endif
+#endif
+
+#if CRASH_PANIC_HOOK
+static void panic_hook(arduino_panic_info_t* info, void* arg) {
+    (void)arg;
+    uint32_t pcs[CRASH_BACKTRACE_DEPTH];
+    size_t n = info->backtrace_len < CRASH_BACKTRACE_DEPTH ? info->backtrace_len
+                                                            : CRASH_BACKTRACE_DEPTH;
+    for (size_t i = 0; i < n; i++) pcs[i] = (uint32_t)info->backtrace[i];
+    CrashHandler::getInstance().recordPanic((uint32_t)(uintptr_t)info->pc, pcs, n,
+                                            info->backtrace_corrupt,
+                                            info->backtrace_continues ||
+                                                info->backtrace_len > n);
+}
+#endif
 
 CrashHandler& CrashHandler::getInstance() {
     static CrashHandler instance;
@@ -13,8 +37,8 @@ CrashHandler& CrashHandler::getInstance() {
 void CrashHandler::begin() {
     if (initialized_) return;
 
-    // Increment boot count
-    if (crash_info_.magic == CRASH_MAGIC) {
+    // Increment boot count (a layout change fails the checksum)
+    if (crash_info_.magic == CRASH_MAGIC && validateChecksum(crash_info_)) {
         crash_info_.boot_count++;
     } else {
         // First boot or invalid data - initialize
@@ -36,17 +60,60 @@ void CrashHandler::begin() {
         reason == ESP_RST_BROWNOUT) {
 
         crash_info_.crash_count++;
+        crash_info_.crash_reason = reason;
         crash_info_.last_crash_timestamp = millis();
         crash_info_.free_heap_at_crash = esp_get_free_heap_size();
         crash_info_.min_free_heap = esp_get_minimum_free_heap_size();
+
+        // No hook ran (brownout, RTC watchdog, older core): a backtrace still
+        // held belongs to an earlier crash; the ring is as the crash left it
+        if (!panic_captured_) {
+            crash_info_.last_crash_pc = 0;
+            crash_info_.backtrace_len = 0;
+            crash_info_.backtrace_flags = 0;
+            captureBreadcrumbs();
+        }
+        crash_info_.report_pending = 1;
     }
+    panic_captured_ = false;
+    breadcrumbs_.count = 0;     // Trail of this boot only
 
     // Update checksum
     crash_info_.checksum = calculateChecksum(crash_info_);
 
+    #if CRASH_PANIC_HOOK
+    set_arduino_panic_handler(panic_hook, nullptr);
+    #endif
+
     initialized_ = true;
 }
 
+bool CrashHandler::hasPendingReport() const {
+    return crash_info_.magic == CRASH_MAGIC && validateChecksum(crash_info_) &&
+           crash_info_.report_pending;
+}
+
+void CrashHandler::recordPanic(uint32_t pc, const uint32_t* backtrace, size_t len,
+                               bool corrupt, bool truncated) {
+    if (crash_info_.magic != CRASH_MAGIC) {
+        memset(&crash_info_, 0, sizeof(crash_info_));
+        crash_info_.magic = CRASH_MAGIC;
+    }
+    size_t n = len < CRASH_BACKTRACE_DEPTH ? len : CRASH_BACKTRACE_DEPTH;
+    crash_info_.last_crash_pc = pc;
+    for (size_t i = 0; i < n; i++) crash_info_.backtrace[i] = backtrace[i];
+    crash_info_.backtrace_len = (uint8_t)n;
+    crash_info_.backtrace_flags = (corrupt ? BT_CORRUPT : 0) |
+                                  (truncated || len > n ? BT_TRUNCATED : 0);
+    captureBreadcrumbs();
+    crash_info_.checksum = calculateChecksum(crash_info_);
+    panic_captured_ = true;
+}
+
+void CrashHandler::captureBreadcrumbs() {
+    crash_info_.breadcrumb_len = (uint8_t)crash_breadcrumb_copy(breadcrumbs_, crash_info_.breadcrumbs);
+}
+
 bool CrashHandler::hasCrashInfo() const {
     if (crash_info_.magic != CRASH_MAGIC) return false;
     if (!validateChecksum(crash_info_)) return false;
@@ -66,6 +133,10 @@ void CrashHandler::clearCrashInfo() {
     crash_info_.last_crash_sp = 0;
     crash_info_.last_function[0] = '\0';
     crash_info_.free_heap_at_crash = 0;
+    crash_info_.backtrace_len = 0;
+    crash_info_.backtrace_flags = 0;
+    crash_info_.breadcrumb_len = 0;
+    crash_info_.report_pending = 0;
 
     // Update checksum
     crash_info_.checksum = calculateChecksum(crash_info_);
@@ -106,6 +177,29 @@ void CrashHandler::formatCrashReport(char* out, size_t out_size) const {
             crash_info_.min_free_heap);
 }
 
+void CrashHandler::formatCompactReport(char* out, size_t out_size) const {
+    char bt[CRASH_BACKTRACE_DEPTH * 9 + 1];
+    char bc[CRASH_BREADCRUMB_SLOTS * 5 + 1];
+    crash_format_hex_list(bt, sizeof(bt), crash_info_.backtrace, crash_info_.backtrace_len, 8);
+    crash_format_hex_list(bc, sizeof(bc), crash_info_.breadcrumbs, crash_info_.breadcrumb_len, 4);
+    snprintf(out, out_size,
+            "{\"v\":1,"
+            "\"reason\":\"%s\","
+            "\"n\":%u,"
+            "\"heap\":%u,"
+            "\"pc\":\"%08x\","
+            "\"bt\":\"%s\","
+            "\"bt_flags\":%u,"
+            "\"bc\":\"%s\"}",
+            getResetReasonString(crash_info_.crash_reason),
+            crash_info_.crash_count,
+            crash_info_.free_heap_at_crash,
+            crash_info_.last_crash_pc,
+            bt,
+            (unsigned)crash_info_.backtrace_flags,
+            bc);
+}
+
 const char* CrashHandler::getResetReasonString(esp_reset_reason_t reason) const {
     switch (reason) {
         case ESP_RST_UNKNOWN:   return "UNKNOWN";
@@ -3,11 +3,18 @@
 #include <Arduino.h>
 #include <esp_system.h>
 #include <rom/rtc.h>
+#include "crash_record.h"
+#include "feature_flags.h"
 
 // Crash diagnostics and recovery system
 // Stores crash information in RTC memory to survive reboots
 // Provides post-mortem analysis via MQTT
 //
+// A panic hook (Arduino core 2.0.6+) writes the faulting PC, the first
+// CRASH_BACKTRACE_DEPTH backtrace PCs and the breadcrumb ring into the record;
+// the next wake that reaches the broker publishes them as one compact
+// report (formatCompactReport) for scripts/symbolize_crash.py.
+//
 // Usage:
 //   void setup() {
 //       CrashHandler::getInstance().begin();
@@ -20,6 +27,11 @@
 //           CrashHandler::getInstance().clearCrashInfo();
 //       }
 //   }
+//
+//   void run_network_phase() {
+//       CRASH_BREADCRUMB("run_network_phase");
+//       ...
+//   }
 
 class CrashHandler {
 public:
@@ -31,16 +43,26 @@ public:
         uint32_t crash_count;               // Total crash count
         uint32_t boot_count;                // Total boot count
         uint32_t last_crash_timestamp;      // millis() at crash
-        uint32_t last_crash_pc;             // Program counter (not always available)
+        uint32_t last_crash_pc;             // Program counter (panic hook only)
         uint32_t last_crash_sp;             // Stack pointer (not always available)
         esp_reset_reason_t reset_reason;    // ESP32 reset reason
         RESET_REASON rtc_reset_reason;      // RTC reset reason (more detailed)
-        char last_function[MAX_FUNCTION_NAME];  // Last logged function before crash
+        esp_reset_reason_t crash_reason;    // Reset reason of the last crash
+        char last_function[MAX_FUNCTION_NAME];  // Last recordFunction() name (debug)
         uint32_t free_heap_at_crash;        // Heap at time of crash
         uint32_t min_free_heap;             // Minimum free heap seen
+        uint32_t backtrace[CRASH_BACKTRACE_DEPTH];   // Outermost frames dropped
+        uint16_t breadcrumbs[CRASH_BREADCRUMB_SLOTS];    // Oldest first
+        uint8_t backtrace_len;
+        uint8_t backtrace_flags;            // BT_CORRUPT | BT_TRUNCATED
+        uint8_t breadcrumb_len;
+        uint8_t report_pending;             // Crash not published yet
         uint16_t checksum;                  // Checksum for data validation
     };
 
+    static constexpr uint8_t BT_CORRUPT = 1u << 0;
+    static constexpr uint8_t BT_TRUNCATED = 1u << 1;
+
     static CrashHandler& getInstance();
 
     void begin();
@@ -57,12 +79,28 @@ public:
     // Record current function (for debugging)
     void recordFunction(const char* function_name);
 
+    // Record a call-site breadcrumb (CRASH_BREADCRUMB); not checksummed, so
+    // it is only two stores
+    static void breadcrumb(uint16_t site_id) { crash_breadcrumb_push(breadcrumbs_, site_id); }
+
+    // A crash whose compact report has not been published yet
+    bool hasPendingReport() const;
+
+    // Called from the panic hook: faulting PC and backtrace, innermost first
+    void recordPanic(uint32_t pc, const uint32_t* backtrace, size_t len,
+                     bool corrupt, bool truncated);
+
     // Update heap statistics
     void updateHeapStats();
 
     // Format crash report as JSON
     void formatCrashReport(char* out, size_t out_size) const;
 
+    // Compact report for mqtt_publish_last_crash():
+    // {"v":1,"reason":"PANIC","n":3,"heap":..,"pc":"4008a1b2","bt":"..","bc":".."}
+    static constexpr size_t COMPACT_REPORT_MAX = 320;
+    void formatCompactReport(char* out, size_t out_size) const;
+
     // Get human-readable reset reason
     const char* getResetReasonString(esp_reset_reason_t reason) const;
     const char* getRtcResetReasonString(RESET_REASON reason) const;
@@ -75,6 +113,10 @@ private:
 
     // RTC memory storage (survives deep sleep and resets)
     RTC_DATA_ATTR static CrashInfo crash_info_;
+    RTC_DATA_ATTR static CrashBreadcrumbs breadcrumbs_;
+    RTC_DATA_ATTR static bool panic_captured_;     // Hook ran since the last begin()
+
+    void captureBreadcrumbs();
 
     bool initialized_ = false;
 
@@ -83,9 +125,10 @@ private:
     bool validateChecksum(const CrashInfo& info) const;
 };
 
-// Macro to record function entry (lightweight breadcrumb)
-#ifdef DEBUG
-  #define CRASH_BREADCRUMB(func) CrashHandler::getInstance().recordFunction(func)
+// Macro to record function entry (lightweight breadcrumb); func must be a
+// string literal, hashed at compile time to the site id
+#if FEATURE_CRASH_HANDLER
+  #define CRASH_BREADCRUMB(func) CrashHandler::breadcrumb(CRASH_SITE_ID(func))
 #else
   #define CRASH_BREADCRUMB(func) ((void)0)
 #endif
@@ -0,0 +1,75 @@
+#pragma once
+
+// Crash record building blocks: call-site breadcrumbs and compact hex lists
+// A breadcrumb is a 16-bit id hashed from a string literal at compile time,
+// so recording one is two stores into an RTC ring, cheap enough to leave in
+// release builds. The panic hook copies the ring and the first backtrace PCs
+// into the crash record; the next wake publishes both as hex lists, which
+// scripts/symbolize_crash.py turns back into functions (addr2line) and
+// breadcrumb names (the same hash over the CRASH_BREADCRUMB literals).
+//
+// Usage:
+//   static CrashBreadcrumbs ring;
+//   crash_breadcrumb_push(ring, CRASH_SITE_ID("run_network_phase"));
+//   crash_format_hex_list(out, sizeof(out), pcs, n, 8);   // "400d1234,4008a1b2"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+static constexpr size_t CRASH_BACKTRACE_DEPTH = 8;
+static constexpr size_t CRASH_BREADCRUMB_SLOTS = 16;
+
+// 32-bit FNV-1a over a NUL-terminated string
+constexpr uint32_t crash_fnv1a(const char* s, uint32_t h = 2166136261u) {
+    return *s ? crash_fnv1a(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+// Folded to 16 bits; 0 is kept free to mark an empty slot
+constexpr uint16_t crash_fold16(uint32_t h) {
+    return (uint16_t)((h >> 16) ^ (h & 0xFFFFu)) ? (uint16_t)((h >> 16) ^ (h & 0xFFFFu)) : 1;
+}
+
+constexpr uint16_t crash_site_id(const char* name) {
+    return crash_fold16(crash_fnv1a(name));
+}
+
+// Forces the hash to a compile-time constant at each call site
+#define CRASH_SITE_ID(name) (std::integral_constant<uint16_t, crash_site_id(name)>::value)
+
+struct CrashBreadcrumbs {
+    uint16_t id[CRASH_BREADCRUMB_SLOTS];
+    uint32_t count;                 // Total pushed; newest at (count - 1) % SLOTS
+};
+
+inline void crash_breadcrumb_push(CrashBreadcrumbs& r, uint16_t id) {
+    r.id[r.count % CRASH_BREADCRUMB_SLOTS] = id;
+    r.count++;
+}
+
+// Held entries oldest first into out[CRASH_BREADCRUMB_SLOTS]; returns how many
+inline size_t crash_breadcrumb_copy(const CrashBreadcrumbs& r, uint16_t* out) {
+    size_t n = r.count < CRASH_BREADCRUMB_SLOTS ? r.count : CRASH_BREADCRUMB_SLOTS;
+    uint32_t first = r.count - (uint32_t)n;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = r.id[(first + i) % CRASH_BREADCRUMB_SLOTS];
+    }
+    return n;
+}
+
+// Comma-separated lowercase hex, width digits each; stops before an entry
+// that would not fit. Returns the length written.
+template <typename T>
+inline size_t crash_format_hex_list(char* out, size_t out_size, const T* v, size_t n, int width) {
+    if (!out || out_size == 0) return 0;
+    size_t len = 0;
+    out[0] = '\0';
+    for (size_t i = 0; i < n; i++) {
+        size_t need = (size_t)width + (i ? 1 : 0);
+        if (len + need >= out_size) break;
+        len += (size_t)snprintf(out + len, out_size - len, "%s%0*lx", i ? "," : "", width,
+                                (unsigned long)v[i]);
+    }
+    return len;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+// Software CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320)
+// Two interchangeable implementations of the zlib-style streaming update:
+// crc32_bitwise_update() is the old 8-steps-per-byte loop, and
+// crc32_table_update() is slicing-by-4 (four 256-entry tables built on first
+// use, one table lookup per byte, four bytes per step). fast_crc32() in
+// system_manager.cpp picks one of these or the ESP32 ROM routine with
+// CRC32_IMPL (config.h); all three give identical results.
+//
+// Usage:
+//   uint32_t crc = crc32_table_update(0, header, sizeof(header));
+//   crc = crc32_table_update(crc, body, body_len);    // Same as one call over both
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "crc32_table_update assumes a little-endian target"
+#endif
+
+static constexpr uint32_t CRC32_POLY = 0xEDB88320u;
+
+inline uint32_t crc32_bitwise_update(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k) {
+            uint32_t mask = -(crc & 1u);
+            crc = (crc >> 1) ^ (CRC32_POLY & mask);
+        }
+    }
+    return ~crc;
+}
+
+// Slicing tables, built once (4 KB); concurrent first calls write the same values
+inline const uint32_t (*crc32_tables())[256] {
+    static uint32_t tables[4][256];
+    static volatile bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c >> 1) ^ (CRC32_POLY & -(c & 1u));
+            tables[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int t = 1; t < 4; t++) {
+                uint32_t prev = tables[t - 1][i];
+                tables[t][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+            }
+        }
+        ready = true;
+    }
+    return tables;
+}
+
+inline uint32_t crc32_table_update(uint32_t crc, const uint8_t* data, size_t len) {
+    const uint32_t (*t)[256] = crc32_tables();
+    crc = ~crc;
+    // Byte steps up to a word boundary, then four bytes per step
+    while (len > 0 && ((uintptr_t)data & 3u) != 0) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        len--;
+    }
+    while (len >= 4) {
+        uint32_t word;
+        memcpy(&word, data, sizeof(word));
+        crc ^= word;
+        crc = t[3][crc & 0xFF] ^ t[2][(crc >> 8) & 0xFF] ^
+              t[1][(crc >> 16) & 0xFF] ^ t[0][crc >> 24];
+        data += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        len--;
+    }
+    return ~crc;
+}
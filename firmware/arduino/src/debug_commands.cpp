@@ -1,5 +1,7 @@
 #include "debug_commands.h"
 #include "mqtt_client.h"
+#include "mqtt_dispatch.h"
+#include "mqtt_stream.h"
 #include "safe_strings.h"
 #include "logging/logger.h"
 #include "profiling.h"
@@ -10,8 +12,14 @@
 #include "feature_flags.h"
 #include "mqtt_batcher.h"
 #include "display_smart_refresh.h"
+#include "wake_timeline.h"
+#include "trace.h"
+#include "wake_arena.h"
+#include "rtc_state.h"
 #include "sensors.h"
 #include "config.h"
+#include "device_bench.h"
+#include "code_placement.h"
 #if USE_DISPLAY
 #include "display_capture.h"
 #endif
@@ -24,15 +32,24 @@ DebugCommands& DebugCommands::getInstance() {
     return instance;
 }
 
+static void on_debug_command(const MqttInbound& msg) {
+    DebugCommands::getInstance().handleCommand(msg.topic, msg.payload, msg.length);
+}
+
 void DebugCommands::begin() {
     if (initialized_) return;
 
+    // Route suffix is relative to the device prefix (drop the leading '/')
+    mqtt_dispatch_register(MQTT_NS_DEVICE, TOPIC_CMD_DEBUG + 1, on_debug_command, nullptr,
+                           MQTT_ROUTE_RATE_LIMITED);
+
     // Subscribe to debug command topic using static buffer instead of String
     PubSubClient* client = mqtt_get_client();
-    if (client && client->connected() && client_id_[0] != '\0') {
+    // A resumed persistent session still holds the subscription
+    if (client && client->connected() && client_id_[0] != '\0' && !mqtt_session_resumed()) {
         char debug_topic[96];
         snprintf(debug_topic, sizeof(debug_topic), "espsensor/%s%s", client_id_, TOPIC_CMD_DEBUG);
-        client->subscribe(debug_topic);
+        client->subscribe(debug_topic, MQTT_PERSISTENT_SESSION ? 1 : 0);
     }
 
     initialized_ = true;
@@ -44,14 +61,15 @@ void DebugCommands::setClientId(const char* client_id) {
     }
 }
 
-void DebugCommands::handleCommand(const char* topic, const uint8_t* payload, size_t length) {
+COLD_PATH void DebugCommands::handleCommand(const char* topic, const uint8_t* payload, size_t length) {
     if (!initialized_) return;
 
     PubSubClient* client = mqtt_get_client();
     if (!client || !client->connected()) return;
 
-    // Parse JSON command
-    JsonDocument doc;
+    // Parse JSON command; the document lives in this handler's arena scratch
+    WakeArena::Scope scratch;
+    JsonDocument doc(WakeArena::jsonAllocator());
     DeserializationError error = deserializeJson(doc, payload, length);
 
     if (error) {
@@ -89,10 +107,14 @@ void DebugCommands::handleCommand(const char* topic, const uint8_t* payload, siz
         cmdSensors(client);
     } else if (strcmp(cmd, "perf") == 0) {
         cmdPerf(client);
+    } else if (strcmp(cmd, "perf_history") == 0) {
+        cmdPerfHistory(client);
     } else if (strcmp(cmd, "perf_reset") == 0) {
         cmdPerfReset(client);
     } else if (strcmp(cmd, "bufpool") == 0) {
         cmdBufPool(client);
+    } else if (strcmp(cmd, "bufpool_callers") == 0) {
+        cmdBufPoolCallers(client);
     } else if (strcmp(cmd, "crash") == 0) {
         cmdCrash(client);
     } else if (strcmp(cmd, "crash_clear") == 0) {
@@ -101,6 +123,12 @@ void DebugCommands::handleCommand(const char* topic, const uint8_t* payload, siz
         cmdMemory(client);
     } else if (strcmp(cmd, "memory_reset") == 0) {
         cmdMemoryReset(client);
+    } else if (strcmp(cmd, "memory_phases") == 0) {
+        cmdMemoryPhases(client);
+    } else if (strcmp(cmd, "memory_stacks") == 0) {
+        cmdMemoryStacks(client);
+    } else if (strcmp(cmd, "memory_trace") == 0) {
+        cmdMemoryTrace(client);
     } else if (strcmp(cmd, "sleep") == 0) {
         cmdSleep(client);
     } else if (strcmp(cmd, "features") == 0) {
@@ -111,6 +139,18 @@ void DebugCommands::handleCommand(const char* topic, const uint8_t* payload, siz
         cmdSmartRefresh(client);
     } else if (strcmp(cmd, "screenshot") == 0) {
         cmdScreenshot(client);
+    } else if (strcmp(cmd, "timeline") == 0) {
+        cmdTimeline(client);
+    } else if (strcmp(cmd, "trace") == 0) {
+        cmdTrace(client);
+    } else if (strcmp(cmd, "trace_clear") == 0) {
+        cmdTraceClear(client);
+    } else if (strcmp(cmd, "arena") == 0) {
+        cmdArena(client);
+    } else if (strcmp(cmd, "rtc") == 0) {
+        cmdRtc(client);
+    } else if (strcmp(cmd, "bench") == 0) {
+        cmdBench(client);
     } else {
         char response[128];
         snprintf(response, sizeof(response),
@@ -119,7 +159,7 @@ void DebugCommands::handleCommand(const char* topic, const uint8_t* payload, siz
     }
 }
 
-void DebugCommands::cmdHeap(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdHeap(PubSubClient* client) {
     uint32_t free_heap = esp_get_free_heap_size();
     uint32_t min_heap = esp_get_minimum_free_heap_size();
     uint32_t largest_block = heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT);
@@ -138,7 +178,7 @@ void DebugCommands::cmdHeap(PubSubClient* client) {
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdState(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdState(PubSubClient* client) {
     // Get outside readings from MQTT
     OutsideReadings outside = mqtt_get_outside_readings();
 
@@ -153,7 +193,7 @@ void DebugCommands::cmdState(PubSubClient* client) {
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdConfig(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdConfig(PubSubClient* client) {
     // Get logging configuration
     char log_config[256];
     Logger::getInstance().getConfigJson(log_config, sizeof(log_config));
@@ -166,7 +206,7 @@ void DebugCommands::cmdConfig(PubSubClient* client) {
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdRestart(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdRestart(PubSubClient* client) {
     publishResponse(client, "{\"cmd\":\"restart\",\"status\":\"restarting\"}");
 
     // Allow time for message to be sent
@@ -176,44 +216,26 @@ void DebugCommands::cmdRestart(PubSubClient* client) {
     esp_restart();
 }
 
-void DebugCommands::cmdModules(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdModules(PubSubClient* client) {
     Logger& logger = Logger::getInstance();
     uint8_t count = logger.getModuleCount();
 
-    char response[512];
-    int pos = snprintf(response, sizeof(response), "{\"cmd\":\"modules\",\"count\":%u,\"modules\":[", count);
-
-    for (uint8_t i = 0; i < count && pos < (int)(sizeof(response) - 64); i++) {
-        if (i > 0) {
-            pos += snprintf(response + pos, sizeof(response) - pos, ",");
-        }
-
-        const char* name = logger.getModuleName(i);
-        bool enabled = logger.isModuleEnabled(i);
-
-        // Bounds check before writing - reserve space for closing brackets
-        if (pos >= (int)(sizeof(response) - 64)) {
-            break;  // Stop if we're running out of space
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+        j.beginObject().field("cmd", "modules").field("count", (unsigned)count).beginArray("modules");
+        for (uint8_t i = 0; i < count; i++) {
+            j.beginObject()
+             .field("id", (unsigned)i)
+             .field("name", logger.getModuleName(i))
+             .field("enabled", logger.isModuleEnabled(i))
+             .endObject();
         }
-
-        pos += snprintf(response + pos, sizeof(response) - pos,
-                       "{\"id\":%u,\"name\":\"%s\",\"enabled\":%s}",
-                       i, name ? name : "null", enabled ? "true" : "false");
-    }
-
-    // Ensure we have space for closing brackets
-    if (pos < (int)(sizeof(response) - 3)) {
-        snprintf(response + pos, sizeof(response) - pos, "]}");
-    } else {
-        // Truncate and close - find safe spot
-        response[sizeof(response) - 3] = ']';
-        response[sizeof(response) - 2] = '}';
-        response[sizeof(response) - 1] = '\0';
-    }
-    publishResponse(client, response);
+        j.endArray().endObject();
+    });
 }
 
-void DebugCommands::cmdUptime(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdUptime(PubSubClient* client) {
     uint32_t uptime_ms = millis();
     uint32_t uptime_sec = uptime_ms / 1000;
 
@@ -225,7 +247,7 @@ void DebugCommands::cmdUptime(PubSubClient* client) {
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdNetwork(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdNetwork(PubSubClient* client) {
     bool wifi_connected = (WiFi.status() == WL_CONNECTED);
     int rssi = wifi_connected ? WiFi.RSSI() : 0;
     bool mqtt_connected = mqtt_is_connected();
@@ -240,7 +262,7 @@ void DebugCommands::cmdNetwork(PubSubClient* client) {
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdSensors(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdSensors(PubSubClient* client) {
     // Read current sensor values
     InsideReadings readings = read_inside_sensors();
 
@@ -261,84 +283,168 @@ void DebugCommands::cmdSensors(PubSubClient* client) {
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdPerf(PubSubClient* client) {
-    char response[1024];
-    PerformanceMonitor::getInstance().formatJson(response, sizeof(response));
-    publishResponse(client, response);
+COLD_PATH void DebugCommands::cmdPerf(PubSubClient* client) {
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    const PerformanceMonitor& perf = PerformanceMonitor::getInstance();
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) { perf.writeJson(j); });
+}
+
+COLD_PATH void DebugCommands::cmdPerfHistory(PubSubClient* client) {
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    const PerformanceMonitor& perf = PerformanceMonitor::getInstance();
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) { perf.writeHistoryJson(j); });
 }
 
-void DebugCommands::cmdPerfReset(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdPerfReset(PubSubClient* client) {
     PerformanceMonitor::getInstance().reset();
+    PerformanceMonitor::getInstance().resetHistory();
     publishResponse(client, "{\"cmd\":\"perf_reset\",\"status\":\"ok\"}");
 }
 
-void DebugCommands::cmdBufPool(PubSubClient* client) {
-    char stats[256];
+COLD_PATH void DebugCommands::cmdBufPool(PubSubClient* client) {
+    char stats[384];
     BufferPool::getInstance().formatStatsJson(stats, sizeof(stats));
 
-    char response[384];
+    char response[416];
     // Safely merge JSON: skip opening brace only if stats starts with '{'
     const char* stats_content = (stats[0] == '{') ? stats + 1 : stats;
     snprintf(response, sizeof(response), "{\"cmd\":\"bufpool\",%s}", stats_content);
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdCrash(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdBufPoolCallers(PubSubClient* client) {
+    char callers[416];
+    BufferPool::getInstance().formatCallersJson(callers, sizeof(callers));
+
+    char response[448];
+    const char* callers_content = (callers[0] == '{') ? callers + 1 : callers;
+    snprintf(response, sizeof(response), "{\"cmd\":\"bufpool_callers\",%s}", callers_content);
+    publishResponse(client, response);
+}
+
+COLD_PATH void DebugCommands::cmdArena(PubSubClient* client) {
+    char stats[192];
+    WakeArena::getInstance().formatJson(stats, sizeof(stats));
+
+    char response[224];
+    const char* stats_content = (stats[0] == '{') ? stats + 1 : stats;
+    snprintf(response, sizeof(response), "{\"cmd\":\"arena\",%s}", stats_content);
+    publishResponse(client, response);
+}
+
+COLD_PATH void DebugCommands::cmdRtc(PubSubClient* client) {
+    char stats[192];
+    rtc_state_format_json(stats, sizeof(stats));
+
+    char response[224];
+    const char* stats_content = (stats[0] == '{') ? stats + 1 : stats;
+    snprintf(response, sizeof(response), "{\"cmd\":\"rtc\",%s}", stats_content);
+    publishResponse(client, response);
+}
+
+COLD_PATH void DebugCommands::cmdCrash(PubSubClient* client) {
     char report[512];
     CrashHandler::getInstance().formatCrashReport(report, sizeof(report));
     publishResponse(client, report);
 }
 
-void DebugCommands::cmdCrashClear(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdCrashClear(PubSubClient* client) {
     CrashHandler::getInstance().clearCrashInfo();
     publishResponse(client, "{\"cmd\":\"crash_clear\",\"status\":\"ok\"}");
 }
 
-void DebugCommands::cmdMemory(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdMemory(PubSubClient* client) {
     // Update tracking before reading
     MemoryTracker::getInstance().update();
 
+    // Formatted once so both stream passes see the same snapshot
     char stats[384];
     MemoryTracker::getInstance().formatStatsJson(stats, sizeof(stats));
 
-    char response[512];
-    // Safely merge JSON: skip opening brace only if stats starts with '{'
-    const char* stats_content = (stats[0] == '{') ? stats + 1 : stats;
-    snprintf(response, sizeof(response), "{\"cmd\":\"memory\",%s}", stats_content);
-    publishResponse(client, response);
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+        j.beginObject().field("cmd", "memory").members(stats).endObject();
+    });
 }
 
-void DebugCommands::cmdMemoryReset(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdMemoryReset(PubSubClient* client) {
     MemoryTracker::getInstance().resetAll();
     publishResponse(client, "{\"cmd\":\"memory_reset\",\"status\":\"ok\"}");
 }
 
-void DebugCommands::cmdSleep(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdMemoryPhases(PubSubClient* client) {
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    const MemoryTracker& mem = MemoryTracker::getInstance();
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+        j.beginObject().field("cmd", "memory_phases");
+        mem.writePhasesJson(j);
+        j.endObject();
+    });
+}
+
+COLD_PATH void DebugCommands::cmdMemoryStacks(PubSubClient* client) {
+    MemoryTracker::getInstance().sampleStacks();
+
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    const MemoryTracker& mem = MemoryTracker::getInstance();
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+        j.beginObject().field("cmd", "memory_stacks");
+        mem.writeStacksJson(j);
+        j.endObject();
+    });
+}
+
+COLD_PATH void DebugCommands::cmdMemoryTrace(PubSubClient* client) {
+    MemoryTracker::getInstance().dumpHeapTrace();
+    publishResponse(client, "{\"cmd\":\"memory_trace\",\"status\":\"dumped to serial\"}");
+}
+
+COLD_PATH void DebugCommands::cmdSleep(PubSubClient* client) {
     SleepConfig config = get_default_sleep_config();
     uint32_t optimal = calculate_optimal_sleep_interval(config);
     BatteryStatus bs = read_battery_status();
 
+    // degC per hour from the trend model, null before two samples
+    char trend[16];
+    float rate = get_temperature_trend_rate();
+    if (isfinite(rate)) {
+        snprintf(trend, sizeof(trend), "%.3f", rate * 3600.0f);
+    } else {
+        snprintf(trend, sizeof(trend), "null");
+    }
+
     char response[384];
     snprintf(response, sizeof(response),
             "{\"cmd\":\"sleep\","
             "\"optimal_sec\":%u,"
             "\"battery_pct\":%d,"
+            "\"battery_age_ms\":%lu,"
+            "\"trend_c_per_h\":%s,"
             "\"normal\":%u,"
             "\"low_battery\":%u,"
             "\"critical\":%u,"
             "\"rapid_update\":%u,"
-            "\"thresholds\":{\"low\":%u,\"critical\":%u}}",
-            optimal, bs.percent,
+            "\"max\":%u,"
+            "\"thresholds\":{\"low\":%u,\"critical\":%u},"
+            "\"config_v\":%lu}",
+            optimal, bs.percent, (unsigned long)battery_status_age_ms(), trend,
             config.normal_interval_sec,
             config.low_battery_interval_sec,
             config.critical_interval_sec,
             config.rapid_update_interval_sec,
+            config.max_interval_sec,
             config.low_battery_threshold,
-            config.critical_battery_threshold);
+            config.critical_battery_threshold,
+            (unsigned long)g_rtc_state.config.version);
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdFeatures(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdFeatures(PubSubClient* client) {
     char response[512];
     snprintf(response, sizeof(response),
             "{\"cmd\":\"features\","
@@ -350,9 +456,13 @@ void DebugCommands::cmdFeatures(PubSubClient* client) {
             "\"battery_monitor\":%d,"
             "\"debug_commands\":%d,"
             "\"profiling\":%d,"
+            "\"trace\":%d,"
             "\"memory_tracking\":%d,"
             "\"crash_handler\":%d,"
-            "\"buffer_pool\":%d}",
+            "\"buffer_pool\":%d,"
+            "\"wake_timeline\":%d,"
+            "\"offline_queue\":%d,"
+            "\"device_bench\":%d}",
             FEATURE_HA_DISCOVERY,
             FEATURE_DIAGNOSTIC_MODE,
             FEATURE_STATUS_PIXEL,
@@ -361,24 +471,28 @@ void DebugCommands::cmdFeatures(PubSubClient* client) {
             FEATURE_BATTERY_MONITOR,
             FEATURE_DEBUG_COMMANDS,
             FEATURE_PROFILING,
+            FEATURE_TRACE,
             FEATURE_MEMORY_TRACKING,
             FEATURE_CRASH_HANDLER,
-            FEATURE_BUFFER_POOL);
+            FEATURE_BUFFER_POOL,
+            FEATURE_WAKE_TIMELINE,
+            FEATURE_OFFLINE_QUEUE,
+            FEATURE_DEVICE_BENCH);
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdMqttBatch(PubSubClient* client) {
-    char stats[192];
+COLD_PATH void DebugCommands::cmdMqttBatch(PubSubClient* client) {
+    char stats[320];
     MQTTBatcher::getInstance().formatStatsJson(stats, sizeof(stats));
 
-    char response[256];
+    char response[384];
     // Safely merge JSON: skip opening brace only if stats starts with '{'
     const char* stats_content = (stats[0] == '{') ? stats + 1 : stats;
     snprintf(response, sizeof(response), "{\"cmd\":\"mqtt_batch\",%s}", stats_content);
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdSmartRefresh(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdSmartRefresh(PubSubClient* client) {
     char stats[128];
     SmartRefresh::getInstance().formatStatsJson(stats, sizeof(stats));
 
@@ -386,12 +500,12 @@ void DebugCommands::cmdSmartRefresh(PubSubClient* client) {
     // Safely merge JSON: skip opening brace only if stats starts with '{'
     const char* stats_content = (stats[0] == '{') ? stats + 1 : stats;
     snprintf(response, sizeof(response),
-            "{\"cmd\":\"smart_refresh\",\"dirty_mask\":\"0x%04X\",%s}",
-            SmartRefresh::getInstance().getDirtyMask(), stats_content);
+            "{\"cmd\":\"smart_refresh\",\"dirty_mask\":\"0x%08lX\",%s}",
+            (unsigned long)SmartRefresh::getInstance().getDirtyMask(), stats_content);
     publishResponse(client, response);
 }
 
-void DebugCommands::cmdScreenshot(PubSubClient* client) {
+COLD_PATH void DebugCommands::cmdScreenshot(PubSubClient* client) {
 #if USE_DISPLAY
     // Acknowledge the command first
     publishResponse(client, "{\"cmd\":\"screenshot\",\"status\":\"capturing\"}");
@@ -403,15 +517,70 @@ void DebugCommands::cmdScreenshot(PubSubClient* client) {
 #endif
 }
 
+COLD_PATH void DebugCommands::cmdTimeline(PubSubClient* client) {
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    const WakeTimeline& timeline = WakeTimeline::getInstance();
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+        j.beginObject().field("cmd", "timeline");
+        timeline.writeJson(j, false);
+        j.endObject();
+    });
+}
+
+COLD_PATH void DebugCommands::cmdTrace(PubSubClient* client) {
+#if FEATURE_TRACE
+    int chunks = Tracer::getInstance().publish(client, client_id_);
+    if (chunks < 0) {
+        publishResponse(client, "{\"cmd\":\"trace\",\"error\":\"Publish failed\"}");
+        return;
+    }
+    char response[64];
+    snprintf(response, sizeof(response), "{\"cmd\":\"trace\",\"status\":\"ok\",\"chunks\":%d}", chunks);
+    publishResponse(client, response);
+#else
+    publishResponse(client, "{\"cmd\":\"trace\",\"error\":\"Tracing not enabled\"}");
+#endif
+}
+
+COLD_PATH void DebugCommands::cmdTraceClear(PubSubClient* client) {
+#if FEATURE_TRACE
+    Tracer::getInstance().clear();
+    publishResponse(client, "{\"cmd\":\"trace_clear\",\"status\":\"ok\"}");
+#else
+    publishResponse(client, "{\"cmd\":\"trace_clear\",\"error\":\"Tracing not enabled\"}");
+#endif
+}
+
+COLD_PATH void DebugCommands::cmdBench(PubSubClient* client) {
+#if FEATURE_DEVICE_BENCH
+    // Run everything first: the streamed publish emits the report twice
+    DeviceBenchResult results[DEVICE_BENCH_MAX_CASES];
+    size_t count = device_bench_run(results, DEVICE_BENCH_MAX_CASES);
+
+    char topic[96];
+    responseTopic(topic, sizeof(topic));
+    mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+        device_bench_write_json(j, results, count);
+    });
+#else
+    publishResponse(client, "{\"cmd\":\"bench\",\"error\":\"Benchmarks not enabled\"}");
+#endif
+}
+
 void DebugCommands::publishResponse(PubSubClient* client, const char* json) {
     if (!client || !client->connected()) return;
 
     // Use static buffer instead of String to reduce heap fragmentation
     char topic[96];
-    snprintf(topic, sizeof(topic), "espsensor/%s%s", client_id_, TOPIC_DEBUG_RESPONSE);
+    responseTopic(topic, sizeof(topic));
     client->publish(topic, json, false);
 }
 
+void DebugCommands::responseTopic(char* out, size_t out_size) const {
+    snprintf(out, out_size, "espsensor/%s%s", client_id_, TOPIC_DEBUG_RESPONSE);
+}
+
 // C linkage for MQTT callback
 extern "C" void debug_commands_handle(const char* topic, const uint8_t* payload, size_t length) {
     DebugCommands::getInstance().handleCommand(topic, payload, length);
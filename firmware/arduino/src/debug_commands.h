@@ -18,17 +18,28 @@
 // - {"cmd": "network"}                 -> Returns WiFi/MQTT status
 // - {"cmd": "sensors"}                 -> Returns sensor readings
 // - {"cmd": "perf"}                    -> Returns performance profiling stats
-// - {"cmd": "perf_reset"}              -> Resets performance counters
+// - {"cmd": "perf_history"}            -> Returns profiling stats accumulated across wakes
+// - {"cmd": "perf_reset"}              -> Resets performance counters and cross-wake history
 // - {"cmd": "bufpool"}                 -> Returns buffer pool statistics
+// - {"cmd": "bufpool_callers"}         -> Returns buffer pool use per caller tag
 // - {"cmd": "crash"}                   -> Returns crash diagnostics
 // - {"cmd": "crash_clear"}             -> Clears crash information
 // - {"cmd": "memory"}                  -> Returns memory tracking stats
 // - {"cmd": "memory_reset"}            -> Resets memory tracking stats
+// - {"cmd": "memory_phases"}           -> Returns heap activity per wake phase (this and last wake)
+// - {"cmd": "memory_stacks"}           -> Returns the lowest stack headroom seen per task
+// - {"cmd": "memory_trace"}            -> Dumps IDF heap trace records to serial (if built in)
 // - {"cmd": "sleep"}                   -> Returns adaptive sleep configuration
 // - {"cmd": "features"}                -> Returns enabled/disabled features
 // - {"cmd": "mqtt_batch"}              -> Returns MQTT batching statistics
 // - {"cmd": "smart_refresh"}           -> Returns smart refresh statistics
 // - {"cmd": "screenshot"}              -> Captures and publishes display screenshot
+// - {"cmd": "timeline"}                -> Returns wake-cycle timeline records from RTC
+// - {"cmd": "trace"}                   -> Publishes the trace ring on debug/trace/meta + data/<n>
+// - {"cmd": "trace_clear"}             -> Empties the trace ring
+// - {"cmd": "arena"}                   -> Returns per-wake arena use and peaks
+// - {"cmd": "rtc"}                     -> Returns RTC state block status and RTC memory use
+// - {"cmd": "bench"}                   -> Runs on-device micro-benchmarks, reports CPU cycles (device_bench.h)
 
 class DebugCommands {
 public:
@@ -62,20 +73,34 @@ private:
     void cmdNetwork(PubSubClient* client);
     void cmdSensors(PubSubClient* client);
     void cmdPerf(PubSubClient* client);
+    void cmdPerfHistory(PubSubClient* client);
     void cmdPerfReset(PubSubClient* client);
     void cmdBufPool(PubSubClient* client);
+    void cmdBufPoolCallers(PubSubClient* client);
     void cmdCrash(PubSubClient* client);
     void cmdCrashClear(PubSubClient* client);
     void cmdMemory(PubSubClient* client);
     void cmdMemoryReset(PubSubClient* client);
+    void cmdMemoryPhases(PubSubClient* client);
+    void cmdMemoryStacks(PubSubClient* client);
+    void cmdMemoryTrace(PubSubClient* client);
     void cmdSleep(PubSubClient* client);
     void cmdFeatures(PubSubClient* client);
     void cmdMqttBatch(PubSubClient* client);
     void cmdSmartRefresh(PubSubClient* client);
     void cmdScreenshot(PubSubClient* client);
+    void cmdTimeline(PubSubClient* client);
+    void cmdTrace(PubSubClient* client);
+    void cmdTraceClear(PubSubClient* client);
+    void cmdArena(PubSubClient* client);
+    void cmdRtc(PubSubClient* client);
+    void cmdBench(PubSubClient* client);
 
     // Helper to publish response
     void publishResponse(PubSubClient* client, const char* json);
+
+    // espsensor/<id>/debug/response, for streamed responses (mqtt_stream.h)
+    void responseTopic(char* out, size_t out_size) const;
 };
 
 // C linkage for MQTT callback
@@ -0,0 +1,240 @@
+// On-device micro-benchmark implementation
+#include "device_bench.h"
+
+#if FEATURE_DEVICE_BENCH
+
+#include <Arduino.h>
+#include <cmath>
+#include <cstring>
+#include <esp_cpu.h>
+#include <nvs.h>
+#include "base64_codec.h"
+#include "capture_codec.h"
+#include "config.h"
+#include "generated_config.h"
+#include "mqtt_batcher.h"
+#include "sensors.h"
+#include "system_manager.h"
+#include "topic_table.h"
+#if USE_DISPLAY
+#include "display_capture.h"
+#include "render_model.h"
+#endif
+
+#if USE_DISPLAY && USE_UI_SPEC
+extern void draw_from_spec_canvas_impl(uint8_t variantId, const RenderModel& m,
+                                       GFXcanvas1* canvas);
+#endif
+
+// Runs per case: enough for a stable min without holding the wake long
+static constexpr uint16_t RUNS_FAST = 32;     // < 1 ms each
+static constexpr uint16_t RUNS_FRAME = 8;
+static constexpr uint16_t RUNS_IO = 4;        // Flash writes, I2C conversions
+
+static volatile uint32_t g_sink;   // Keeps results from being optimized away
+static uint16_t g_run_mhz = 0;
+
+static void skip(DeviceBenchResult& r, const char* name, const char* reason) {
+    memset(&r, 0, sizeof(r));
+    r.name = name;
+    r.skipped = reason;
+}
+
+// Time runs calls of fn(i), each on its own, in CPU cycles
+template <typename Fn>
+static void time_case(DeviceBenchResult& r, const char* name, uint16_t runs, Fn fn) {
+    memset(&r, 0, sizeof(r));
+    r.name = name;
+    r.min_cycles = UINT32_MAX;
+    uint64_t total = 0;
+    for (uint16_t i = 0; i < runs; i++) {
+        uint32_t start = esp_cpu_get_ccount();
+        fn(i);
+        uint32_t cycles = esp_cpu_get_ccount() - start;
+        total += cycles;
+        if (i == 0) r.first_cycles = cycles;
+        if (cycles < r.min_cycles) r.min_cycles = cycles;
+        if (cycles > r.max_cycles) r.max_cycles = cycles;
+    }
+    r.runs = runs;
+    r.mean_cycles = runs ? (uint32_t)(total / runs) : 0;
+    if (runs == 0) r.min_cycles = 0;
+    yield();
+}
+
+#if USE_DISPLAY
+// The canvas holds the frame the panel shows; only redraw that same frame
+static const uint8_t* bench_frame(const char** reason) {
+    DisplayCapture& cap = DisplayCapture::getInstance();
+    GFXcanvas1* canvas = cap.getCanvas();
+    if (!canvas) {
+        *reason = "no capture canvas";
+        return nullptr;
+    }
+    if (!cap.hasContent()) {
+        *reason = "no frame drawn yet";
+        return nullptr;
+    }
+    return canvas->getBuffer();
+}
+#endif
+
+static void bench_display(DeviceBenchResult* out, size_t& n, size_t max) {
+#if USE_DISPLAY
+    const char* reason = nullptr;
+    const uint8_t* frame = bench_frame(&reason);
+    const size_t size = DisplayCapture::BUFFER_SIZE;
+
+    if (n < max) {
+#if USE_UI_SPEC
+        if (frame) {
+            GFXcanvas1* canvas = DisplayCapture::getInstance().getCanvas();
+            const RenderModel& m = render_model_current();
+            time_case(out[n], "render_frame", RUNS_FRAME, [&](uint16_t) {
+                canvas->fillScreen(0);
+                draw_from_spec_canvas_impl(0, m, canvas);
+            });
+        } else {
+            skip(out[n], "render_frame", reason);
+        }
+#else
+        skip(out[n], "render_frame", "built without USE_UI_SPEC");
+#endif
+        n++;
+    }
+
+    if (n < max) {
+        if (frame) {
+            time_case(out[n], "crc_frame", RUNS_FAST, [&](uint16_t) {
+                g_sink = fast_crc32(frame, size);
+            });
+        } else {
+            skip(out[n], "crc_frame", reason);
+        }
+        n++;
+    }
+
+    // Same 48-byte blocks the raw screenshot streams into the MQTT client
+    if (n < max) {
+        if (frame) {
+            time_case(out[n], "screenshot_b64", RUNS_FAST, [&](uint16_t) {
+                char block[BASE64_ENCODED_LEN(48)];
+                uint32_t acc = 0;
+                for (size_t pos = 0; pos < size; pos += 48) {
+                    size_t len = size - pos < 48 ? size - pos : 48;
+                    acc += base64_encode_block(frame + pos, len, block);
+                    acc += (uint8_t)block[0];
+                }
+                g_sink = acc;
+            });
+        } else {
+            skip(out[n], "screenshot_b64", reason);
+        }
+        n++;
+    }
+
+    if (n < max) {
+        if (frame) {
+            time_case(out[n], "screenshot_rle", RUNS_FAST, [&](uint16_t) {
+                auto src = [&](size_t i) { return frame[i]; };
+                g_sink = (uint32_t)packbits_encode(src, size, [](uint8_t) {});
+            });
+        } else {
+            skip(out[n], "screenshot_rle", reason);
+        }
+        n++;
+    }
+#else
+    static const char* const kNames[] = {"render_frame", "crc_frame", "screenshot_b64",
+                                         "screenshot_rle"};
+    for (const char* name : kNames) {
+        if (n < max) skip(out[n++], name, "display not enabled");
+    }
+#endif
+}
+
+// One report wake's readings, through the batcher's real record arena
+static void bench_batch(DeviceBenchResult& r) {
+    MQTTBatcher& batcher = MQTTBatcher::getInstance();
+    if (!batcher.isEmpty()) {
+        skip(r, "batch_format", "publishes queued");
+        return;
+    }
+    batcher.queue(topic_get(TOPIC_INSIDE_TEMPERATURE), "21.8", true);
+    batcher.queue(topic_get(TOPIC_INSIDE_HUMIDITY), "41", true);
+    batcher.queue(topic_get(TOPIC_INSIDE_PRESSURE), "1013.2", true);
+    batcher.queue(topic_get(TOPIC_BATTERY_VOLTAGE), "4.12", true);
+    batcher.queue(topic_get(TOPIC_BATTERY_PERCENT), "87", true);
+    batcher.queueJson(topic_get(TOPIC_INSIDE_STATS),
+                      "{\"1h\":{\"t\":[21.4,21.9,21.66],\"n\":6}}", true);
+    batcher.queue(topic_get(TOPIC_DEBUG_WAKE_COUNT), "1234", false);
+    batcher.queue(topic_get(TOPIC_DEBUG_UPTIME), "3", false);
+
+    char doc[MQTTBatcher::PACKED_PAYLOAD_LEN];
+    time_case(r, "batch_format", RUNS_FAST, [&](uint16_t) {
+        g_sink = (uint32_t)batcher.formatPacked(doc, sizeof(doc));
+    });
+    batcher.clear();   // The sample records still count in total_queued
+}
+
+// set + commit of one u32 in a namespace of its own; each run writes a new
+// value so the commit really reaches flash
+static void bench_nvs(DeviceBenchResult& r) {
+    nvs_handle_t h;
+    if (nvs_open("bench", NVS_READWRITE, &h) != ESP_OK) {
+        skip(r, "nvs_commit", "nvs_open failed");
+        return;
+    }
+    uint32_t seed = esp_cpu_get_ccount();
+    bool ok = true;
+    time_case(r, "nvs_commit", RUNS_IO, [&](uint16_t i) {
+        ok = nvs_set_u32(h, "n", seed + i) == ESP_OK && nvs_commit(h) == ESP_OK && ok;
+    });
+    nvs_close(h);
+    if (!ok) skip(r, "nvs_commit", "nvs write failed");
+}
+
+static void bench_sensor(DeviceBenchResult& r) {
+    bool valid = true;
+    time_case(r, "bme280_read", RUNS_IO, [&](uint16_t) {
+        InsideReadings ir = read_inside_sensors();
+        valid = valid && std::isfinite(ir.temperatureC);
+    });
+    if (!valid) skip(r, "bme280_read", "no valid reading");
+}
+
+size_t device_bench_run(DeviceBenchResult* out, size_t max) {
+    if (!out || max == 0) return 0;
+    g_run_mhz = (uint16_t)getCpuFrequencyMhz();
+
+    size_t n = 0;
+    bench_display(out, n, max);
+    if (n < max) bench_batch(out[n++]);
+    if (n < max) bench_nvs(out[n++]);
+    if (n < max) bench_sensor(out[n++]);
+    return n;
+}
+
+void device_bench_write_json(JsonStream& j, const DeviceBenchResult* results, size_t count) {
+    j.beginObject().field("cmd", "bench").field("fw", FW_VERSION)
+     .field("cpu_mhz", (unsigned)g_run_mhz).beginArray("results");
+    for (size_t i = 0; i < count; i++) {
+        const DeviceBenchResult& r = results[i];
+        j.beginObject().field("name", r.name);
+        if (r.skipped) {
+            j.field("skipped", r.skipped);
+        } else {
+            double us = g_run_mhz ? (double)r.mean_cycles / g_run_mhz : 0.0;
+            j.field("n", (unsigned)r.runs)
+             .field("first", (unsigned long)r.first_cycles)
+             .field("min", (unsigned long)r.min_cycles)
+             .field("mean", (unsigned long)r.mean_cycles)
+             .field("max", (unsigned long)r.max_cycles)
+             .field("us", us, 1);
+        }
+        j.endObject();
+    }
+    j.endArray().endObject();
+}
+
+#endif  // FEATURE_DEVICE_BENCH
@@ -0,0 +1,50 @@
+#pragma once
+
+// On-device micro-benchmarks (FEATURE_DEVICE_BENCH)
+// Times the wake's hot paths on the real core, flash cache and buses, which
+// the host benchmarks (test/bench_core) cannot show: a full spec frame into
+// the capture canvas, CRC of that frame, the packed batch document, an NVS
+// commit, a BME280 read and both screenshot encodings. Each case runs a few
+// times and every run is timed in CPU cycles (esp_cpu_get_ccount), so min
+// is the cost without interrupts and mean/max show what they add. first is
+// run 0 alone, which takes the flash cache misses for the case's code the
+// way a wake does; first - min is what HOT_PATH placement (code_placement.h)
+// should bring down.
+//
+// Usage (the "bench" debug command):
+//   DeviceBenchResult results[DEVICE_BENCH_MAX_CASES];
+//   size_t n = device_bench_run(results, DEVICE_BENCH_MAX_CASES);
+//   mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+//       device_bench_write_json(j, results, n);
+//   });
+//
+// Report:
+//   {"cmd":"bench","fw":"1.2.3","cpu_mhz":80,"results":[
+//    {"name":"crc_frame","n":32,"first":46020,"min":41230,"mean":41410,"max":44120,"us":517.6},
+//    {"name":"nvs_commit","skipped":"nvs_open failed"}, ...]}
+// us is mean cycles at cpu_mhz. Cases that need the display, or that would
+// disturb queued publishes, report "skipped" with the reason instead.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "feature_flags.h"
+#include "json_stream.h"
+
+static constexpr size_t DEVICE_BENCH_MAX_CASES = 8;
+
+struct DeviceBenchResult {
+    const char* name;
+    const char* skipped;     // Reason, nullptr when it ran
+    uint16_t runs;
+    uint32_t first_cycles;   // Run 0, from a cold cache
+    uint32_t min_cycles;
+    uint32_t mean_cycles;
+    uint32_t max_cycles;
+};
+
+// Run every case; returns the number of results written (at most max)
+size_t device_bench_run(DeviceBenchResult* out, size_t max);
+
+// Write the report above; reads nothing that changes between the two
+// passes of mqtt_publish_json_stream
+void device_bench_write_json(JsonStream& j, const DeviceBenchResult* results, size_t count);
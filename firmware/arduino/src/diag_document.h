@@ -0,0 +1,82 @@
+#pragma once
+
+// Retained diagnostics document (espsensor/<id>/debug/diagnostics)
+// The fields that rarely change between wakes (reset reason, crash count,
+// layout identity, firmware version) go out as one retained JSON document,
+// and only when its CRC differs from the last one the broker accepted, or
+// every heartbeat_wakes network wakes so a lost retained message comes back.
+// Counters that move on every wake (boot count, uptime, batcher stats) are
+// not part of it; they ride in the batched burst with the readings.
+//
+// Usage:
+//   DiagDocument doc = {reason, crashes, LAYOUT_VERSION, crc_str, FW_VERSION};
+//   size_t n = diag_document_format(doc, buf, sizeof(buf));
+//   DiagDocDecision d = diag_document_decide(g_rtc_state.diag, fast_crc32(buf, n),
+//                                            DIAG_DOC_HEARTBEAT_WAKES);
+//   bool ok = d != DiagDocDecision::SKIP && mqtt_publish_raw(topic, buf, true);
+//   diag_document_note_wake(g_rtc_state.diag, d, crc, ok);
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+struct DiagDocument {
+  const char* reset_reason;
+  uint32_t crash_count;
+  uint32_t layout_version;
+  const char* layout_crc;     // "0x%08X", or "N/A" without a display
+  const char* fw_version;
+};
+
+// Kept in RTC memory between wakes
+struct DiagDocState {
+  uint32_t last_crc;          // CRC of the last delivered document, 0 = none
+  uint32_t wakes_since;       // Network wakes since that delivery
+};
+
+enum class DiagDocDecision : uint8_t {
+  SKIP = 0,       // Same document as the broker holds, heartbeat not due
+  FIRST,          // Nothing delivered since the RTC state was reset
+  CHANGED,        // A field changed
+  HEARTBEAT       // Unchanged, but republished to refresh the retained copy
+};
+
+// {"reset_reason":"..","crash_count":N,"layout_version":N,"layout_crc":"..","fw":".."}
+// Returns the length, or 0 if it does not fit.
+inline size_t diag_document_format(const DiagDocument& d, char* out, size_t cap) {
+  if (!out || cap == 0) return 0;
+  int n = snprintf(out, cap,
+                   "{\"reset_reason\":\"%s\",\"crash_count\":%lu,\"layout_version\":%lu,"
+                   "\"layout_crc\":\"%s\",\"fw\":\"%s\"}",
+                   d.reset_reason ? d.reset_reason : "unknown",
+                   (unsigned long)d.crash_count, (unsigned long)d.layout_version,
+                   d.layout_crc ? d.layout_crc : "N/A",
+                   d.fw_version ? d.fw_version : "");
+  if (n < 0 || (size_t)n >= cap) {
+    out[0] = '\0';
+    return 0;
+  }
+  return (size_t)n;
+}
+
+inline DiagDocDecision diag_document_decide(const DiagDocState& s, uint32_t crc,
+                                            uint32_t heartbeat_wakes) {
+  if (crc == 0) crc = 1;          // As stored by diag_document_note_wake()
+  if (s.last_crc == 0) return DiagDocDecision::FIRST;
+  if (crc != s.last_crc) return DiagDocDecision::CHANGED;
+  if (heartbeat_wakes > 0 && s.wakes_since + 1 >= heartbeat_wakes) return DiagDocDecision::HEARTBEAT;
+  return DiagDocDecision::SKIP;
+}
+
+// Record one network wake. The CRC is only taken once the document reached
+// the broker; a failed publish leaves the state as it was so the next wake
+// tries again.
+inline void diag_document_note_wake(DiagDocState& s, DiagDocDecision d, uint32_t crc,
+                                    bool delivered) {
+  if (d != DiagDocDecision::SKIP && delivered) {
+    s.last_crc = crc ? crc : 1;   // 0 is reserved for "none"
+    s.wakes_since = 0;
+    return;
+  }
+  if (s.wakes_since < UINT32_MAX) s.wakes_since++;
+}
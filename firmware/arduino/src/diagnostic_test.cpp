@@ -3,6 +3,7 @@
 #include <Wire.h>
 #include "config.h"
 #include "display_layout.h"
+#include "code_placement.h"
 
 #ifdef NEOPIXEL_PIN
 #include <Adafruit_NeoPixel.h>
@@ -50,7 +51,7 @@ void show_boot_stage(int stage) {
 #endif
 
 // Enhanced system state dump for debugging
-void dump_system_state() {
+COLD_PATH void dump_system_state() {
   Serial.println("\n=== SYSTEM STATE DUMP ===");
   
   // Memory status
@@ -75,7 +76,7 @@ void dump_system_state() {
   Serial.flush();
 }
 
-void diagnostic_test_init() {
+COLD_PATH void diagnostic_test_init() {
   Serial.println("\n=== HARDWARE DIAGNOSTIC TEST ===");
   Serial.flush();
   
@@ -213,7 +214,7 @@ void diagnostic_test_init() {
   Serial.flush();
 }
 
-void diagnostic_test_loop() {
+COLD_PATH void diagnostic_test_loop() {
   static uint32_t last_test = 0;
   static int cycle = 0;
   
@@ -0,0 +1,85 @@
+#pragma once
+
+// Landscape capture canvas -> native panel buffer
+// The UI is drawn once into the 250x122 DisplayCapture canvas (1 = black,
+// MSB first, 32-byte rows). The SSD1680 RAM is portrait: 128x250, 16-byte
+// rows, 1 = white. With the display at rotation 3 a landscape pixel (x, y)
+// lands at native (y, 249 - x), so each 8x8 pixel block of the canvas is a
+// bit-matrix transpose of a native block. Blocks are transposed eight bytes
+// at a time in one 64-bit word instead of pixel by pixel.
+//
+// Usage:
+//   static uint8_t native[PANEL_NATIVE_BUFFER_SIZE];
+//   blit_canvas_rot3_to_native(canvas->getBuffer(), native);
+//   display.epd2.writeImage(native, 0, 0, PANEL_NATIVE_WIDTH, PANEL_NATIVE_HEIGHT);
+//   PanelWindow nw = blit_window_rot3_to_native(win);
+//   display.epd2.refresh(nw.x, nw.y, nw.w, nw.h);
+
+#include <cstddef>
+#include <cstdint>
+#include "partial_windows.h"
+
+static constexpr uint16_t BLIT_CANVAS_WIDTH = 250;
+static constexpr uint16_t BLIT_CANVAS_HEIGHT = 122;
+static constexpr uint16_t BLIT_CANVAS_STRIDE = (BLIT_CANVAS_WIDTH + 7) / 8;  // 32
+
+static constexpr uint16_t PANEL_NATIVE_WIDTH = 128;   // Controller columns (122 visible)
+static constexpr uint16_t PANEL_NATIVE_HEIGHT = 250;
+static constexpr uint16_t PANEL_NATIVE_STRIDE = PANEL_NATIVE_WIDTH / 8;  // 16
+static constexpr size_t PANEL_NATIVE_BUFFER_SIZE =
+    (size_t)PANEL_NATIVE_STRIDE * PANEL_NATIVE_HEIGHT;  // 4000
+
+// Transpose an 8x8 bit matrix: in[r] bit (7 - c) -> out[c] bit (7 - r)
+// (Hacker's Delight 7-3, on one 64-bit word)
+inline void blit_transpose8(const uint8_t in[8], uint8_t out[8]) {
+  uint64_t x = 0;
+  for (int r = 0; r < 8; r++) x = (x << 8) | in[r];
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x = x ^ t ^ (t << 28);
+  for (int c = 7; c >= 0; c--) {
+    out[c] = (uint8_t)x;
+    x >>= 8;
+  }
+}
+
+// Convert the whole canvas; rows of the native buffer past the canvas
+// height (native columns 122..127, not on glass) are filled white
+inline void blit_canvas_rot3_to_native(const uint8_t* canvas, uint8_t* native) {
+  for (uint16_t nb = 0; nb < PANEL_NATIVE_STRIDE; nb++) {
+    // Native byte column nb holds canvas rows 8*nb .. 8*nb+7
+    for (uint16_t cb = 0; cb < BLIT_CANVAS_STRIDE; cb++) {
+      uint8_t in[8];
+      for (uint16_t r = 0; r < 8; r++) {
+        uint16_t y = nb * 8 + r;
+        in[r] = y < BLIT_CANVAS_HEIGHT ? canvas[(size_t)y * BLIT_CANVAS_STRIDE + cb] : 0;
+      }
+      uint8_t cols[8];
+      blit_transpose8(in, cols);
+      // cols[c] = canvas column x = 8*cb + c, which is native row 249 - x
+      for (uint16_t c = 0; c < 8; c++) {
+        uint16_t x = cb * 8 + c;
+        if (x >= BLIT_CANVAS_WIDTH) break;
+        uint16_t ny = PANEL_NATIVE_HEIGHT - 1 - x;
+        native[(size_t)ny * PANEL_NATIVE_STRIDE + nb] = (uint8_t)~cols[c];
+      }
+    }
+  }
+}
+
+// Landscape window -> native controller window, clipped to the canvas
+inline PanelWindow blit_window_rot3_to_native(const PanelWindow& win) {
+  int16_t x0 = win.x < 0 ? 0 : win.x;
+  int16_t y0 = win.y < 0 ? 0 : win.y;
+  int16_t x1 = win.x + win.w > (int16_t)BLIT_CANVAS_WIDTH ? (int16_t)BLIT_CANVAS_WIDTH
+                                                           : (int16_t)(win.x + win.w);
+  int16_t y1 = win.y + win.h > (int16_t)BLIT_CANVAS_HEIGHT ? (int16_t)BLIT_CANVAS_HEIGHT
+                                                            : (int16_t)(win.y + win.h);
+  if (x1 <= x0 || y1 <= y0) return PanelWindow{0, 0, 0, 0};
+  return PanelWindow{y0, (int16_t)(PANEL_NATIVE_HEIGHT - x1), (int16_t)(y1 - y0),
+                     (int16_t)(x1 - x0)};
+}
@@ -2,16 +2,27 @@
 
 #if USE_DISPLAY
 
+#include <esp_heap_caps.h>
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
 #include "logging/logger.h"
 #include "mqtt_client.h"
+#include "base64_codec.h"
+#include "capture_codec.h"
+#include "system_manager.h"
+#include "wake_arena.h"
+#include "frame_diff.h"
 
+LOG_MODULE_COMPILE("DispCap");
 static uint8_t log_module_id = 0;  // Will be registered in getInstance
 
-// Base64 encoding table
-static const char base64_chars[] =
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+// Frame-sized copies go to PSRAM when the board has it, to DRAM otherwise
+static uint8_t* frame_alloc(bool* in_psram) {
+    void* p = heap_caps_malloc(DisplayCapture::BUFFER_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (in_psram) *in_psram = p != nullptr;
+    if (!p) p = heap_caps_malloc(DisplayCapture::BUFFER_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    return static_cast<uint8_t*>(p);
+}
 
 DisplayCapture::DisplayCapture() {
     // Allocate GFXcanvas1 for shadow buffer
@@ -23,6 +34,15 @@ DisplayCapture::DisplayCapture() {
     } else {
         LOG_ERROR("Failed to allocate screenshot canvas");
     }
+#if DISPLAY_DOUBLE_BUFFER
+    prev_ = frame_alloc(&frames_in_psram_);
+    if (prev_) {
+        LOG_INFO("Previous-frame buffer allocated in %s (%d bytes)",
+                 frames_in_psram_ ? "PSRAM" : "DRAM", BUFFER_SIZE);
+    } else {
+        LOG_WARN("No memory for the previous-frame buffer");
+    }
+#endif
 }
 
 DisplayCapture::~DisplayCapture() {
@@ -30,6 +50,36 @@ DisplayCapture::~DisplayCapture() {
         delete canvas_;
         canvas_ = nullptr;
     }
+    heap_caps_free(delta_base_);
+    delta_base_ = nullptr;
+    heap_caps_free(prev_);
+    prev_ = nullptr;
+}
+
+bool DisplayCapture::setDeltaBase(const uint8_t* frame, uint32_t crc) {
+    if (!frame) return false;
+    if (!delta_base_) {
+        delta_base_ = frame_alloc(nullptr);
+        if (!delta_base_) {
+            LOG_WARN("No memory for screenshot delta base");
+            return false;
+        }
+    }
+    memcpy(delta_base_, frame, BUFFER_SIZE);
+    delta_base_crc_ = crc;
+    return true;
+}
+
+void DisplayCapture::commitFrame() {
+    if (!prev_ || !canvas_ || !canvas_->getBuffer()) return;
+    memcpy(prev_, canvas_->getBuffer(), BUFFER_SIZE);
+    prev_valid_ = true;
+}
+
+size_t DisplayCapture::diffWindows(PanelWindow* out, size_t max_out) const {
+    if (!prev_valid_ || !canvas_ || !canvas_->getBuffer()) return 0;
+    return frame_diff_windows(prev_, canvas_->getBuffer(), WIDTH_BYTES, WIDTH, HEIGHT,
+                              out, max_out);
 }
 
 DisplayCapture& DisplayCapture::getInstance() {
@@ -89,50 +139,14 @@ size_t DisplayCapture::captureBase64(char* out_buffer, size_t buffer_size) {
 
 size_t DisplayCapture::base64Encode(const uint8_t* input, size_t input_len,
                                      char* output, size_t output_size) {
-    size_t output_len = ((input_len + 2) / 3) * 4;
+    size_t output_len = BASE64_ENCODED_LEN(input_len);
 
     if (output_size < output_len + 1) {
         LOG_ERROR("Output buffer too small");
         return 0;
     }
 
-    size_t i = 0, j = 0;
-    uint8_t char_array_3[3];
-    uint8_t char_array_4[4];
-
-    while (input_len--) {
-        char_array_3[i++] = *(input++);
-        if (i == 3) {
-            char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-            char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-            char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-            char_array_4[3] = char_array_3[2] & 0x3f;
-
-            for (i = 0; i < 4; i++) {
-                output[j++] = base64_chars[char_array_4[i]];
-            }
-            i = 0;
-        }
-    }
-
-    if (i) {
-        for (size_t k = i; k < 3; k++) {
-            char_array_3[k] = '\0';
-        }
-
-        char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-        char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-        char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-
-        for (size_t k = 0; k < i + 1; k++) {
-            output[j++] = base64_chars[char_array_4[k]];
-        }
-
-        while (i++ < 3) {
-            output[j++] = '=';
-        }
-    }
-
+    size_t j = base64_encode_block(input, input_len, output);
     output[j] = '\0';
     return j;
 }
@@ -152,93 +166,221 @@ void display_capture_fill_screen(uint16_t color) {
     }
 }
 
-// C linkage for MQTT command handler
-extern "C" void display_capture_handle(const char* payload, size_t length) {
-    LOG_INFO("Screenshot command received");
+enum CaptureFormat { CAPTURE_RAW, CAPTURE_RLE, CAPTURE_DELTA };
 
-    DisplayCapture& cap = DisplayCapture::getInstance();
-    
-    if (!cap.hasContent()) {
-        LOG_WARN("No display content captured yet");
+static CaptureFormat parse_capture_format(const char* payload, size_t length) {
+    char buf[64];
+    size_t n = 0;
+    if (payload) {
+        n = length < sizeof(buf) ? length : sizeof(buf) - 1;
+        memcpy(buf, payload, n);
+    }
+    buf[n] = '\0';
+    if (strstr(buf, "delta")) return CAPTURE_DELTA;
+    if (strstr(buf, "rle")) return CAPTURE_RLE;
+    return CAPTURE_RAW;
+}
+
+// Collects encoded bytes and publishes every CHUNK_BYTES as data/<n>
+class ChunkPublisher {
+public:
+    ChunkPublisher(PubSubClient* client, const char* client_id)
+        : client_(client), client_id_(client_id) {}
+
+    void put(uint8_t b) {
+        buf_[len_++] = b;
+        if (len_ == DisplayCapture::CHUNK_BYTES) flush();
+    }
+
+    void flush() {
+        if (len_ == 0 || !ok_) return;
+        char topic[128];
+        snprintf(topic, sizeof(topic), "espsensor/%s/debug/screenshot/data/%d",
+                 client_id_, chunks_);
+        ok_ = client_->publish(topic, buf_, len_, false);
+        if (!ok_) LOG_ERROR("Failed to publish chunk %d", chunks_);
+        chunks_++;
+        len_ = 0;
+    }
+
+    bool ok() const { return ok_; }
+    int chunks() const { return chunks_; }
+
+private:
+    PubSubClient* client_;
+    const char* client_id_;
+    uint8_t buf_[DisplayCapture::CHUNK_BYTES];
+    size_t len_ = 0;
+    int chunks_ = 0;
+    bool ok_ = true;
+};
+
+static bool publish_meta(PubSubClient* client, const char* client_id,
+                         const JsonDocument& meta_doc) {
+    char meta_buffer[256];
+    size_t meta_len = serializeJson(meta_doc, meta_buffer, sizeof(meta_buffer));
+    char topic[128];
+    snprintf(topic, sizeof(topic), "espsensor/%s/debug/screenshot/meta", client_id);
+    return client->publish(topic, (const uint8_t*)meta_buffer, meta_len, false);
+}
+
+// PackBits screenshot, optionally as an XOR delta against the last one sent;
+// encoded straight from the canvas into fixed-size chunks. The first pass
+// only counts bytes so the metadata can announce the size up front.
+static void capture_compressed(DisplayCapture& cap, PubSubClient* client, const char* client_id,
+                               bool want_delta) {
+    size_t size = 0;
+    const uint8_t* frame = cap.capture(&size);
+    if (!frame || size != DisplayCapture::BUFFER_SIZE) {
+        LOG_ERROR("Failed to capture display");
+        return;
     }
 
-    // Allocate buffer for base64 data on heap (it's large ~5KB)
-    char* base64_buffer = new char[DisplayCapture::BASE64_SIZE];
-    if (!base64_buffer) {
-        LOG_ERROR("Failed to allocate base64 buffer");
+    uint32_t base_crc = 0;
+    const uint8_t* base = want_delta ? cap.deltaBase(&base_crc) : nullptr;
+    auto src = [&](size_t i) { return (uint8_t)(frame[i] ^ (base ? base[i] : 0)); };
+
+    size_t encoded = packbits_encode(src, size, [](uint8_t) {});
+    size_t chunks = (encoded + DisplayCapture::CHUNK_BYTES - 1) / DisplayCapture::CHUNK_BYTES;
+    uint32_t crc = fast_crc32(frame, size);
+
+    WakeArena::Scope scratch;
+    JsonDocument meta_doc(WakeArena::jsonAllocator());
+    meta_doc["width"] = DisplayCapture::WIDTH;
+    meta_doc["height"] = DisplayCapture::HEIGHT;
+    meta_doc["format"] = "packbits";
+    meta_doc["delta"] = base != nullptr;
+    if (base) meta_doc["base_crc"] = base_crc;
+    meta_doc["crc"] = crc;
+    meta_doc["data_size"] = encoded;
+    meta_doc["chunks"] = chunks;
+    meta_doc["buffer_size"] = DisplayCapture::BUFFER_SIZE;
+    if (!publish_meta(client, client_id, meta_doc)) {
+        LOG_ERROR("Failed to publish screenshot metadata");
         return;
     }
 
-    size_t base64_len = cap.captureBase64(base64_buffer, DisplayCapture::BASE64_SIZE);
-    if (base64_len == 0) {
+    ChunkPublisher out(client, client_id);
+    packbits_encode(src, size, [&](uint8_t b) { out.put(b); });
+    out.flush();
+    if (!out.ok()) return;
+
+    cap.setDeltaBase(frame, crc);
+    LOG_INFO("Screenshot %s complete: %d bytes in %d chunks",
+             base ? "delta" : "keyframe", encoded, out.chunks());
+}
+
+// Legacy uncompressed screenshot: the whole frame as base64. Encoded
+// straight from the canvas into each publish in small stack blocks, so it
+// needs no heap and still works when the heap is fragmented.
+static void capture_raw(DisplayCapture& cap, PubSubClient* client, const char* client_id) {
+    size_t size = 0;
+    const uint8_t* frame = cap.capture(&size);
+    if (!frame || size == 0) {
         LOG_ERROR("Failed to capture and encode display");
-        delete[] base64_buffer;
         return;
     }
+    const size_t base64_len = BASE64_ENCODED_LEN(size);
 
     // Build JSON response
-    StaticJsonDocument<256> meta_doc;
+    WakeArena::Scope scratch;
+    JsonDocument meta_doc(WakeArena::jsonAllocator());
     meta_doc["width"] = DisplayCapture::WIDTH;
     meta_doc["height"] = DisplayCapture::HEIGHT;
     meta_doc["format"] = "1bit";
     meta_doc["data_size"] = base64_len;
     meta_doc["buffer_size"] = DisplayCapture::BUFFER_SIZE;
 
-    char meta_buffer[256];
-    size_t meta_len = serializeJson(meta_doc, meta_buffer, sizeof(meta_buffer));
-
     // Publish metadata to /debug/screenshot/meta
-    char topic[128];
-    const char* client_id = mqtt_get_client_id();
-    snprintf(topic, sizeof(topic), "espsensor/%s/debug/screenshot/meta", client_id);
+    if (!publish_meta(client, client_id, meta_doc)) {
+        LOG_ERROR("Failed to publish screenshot metadata");
+        return;
+    }
+    LOG_INFO("Published screenshot metadata");
 
-    PubSubClient* client = mqtt_get_client();
-    if (client && client->connected()) {
-        client->publish(topic, (const uint8_t*)meta_buffer, meta_len, false);
-        LOG_INFO("Published screenshot metadata");
+    // Publish base64 data to /debug/screenshot/data
+    char topic[128];
+    snprintf(topic, sizeof(topic), "espsensor/%s/debug/screenshot/data", client_id);
+
+    // Chunk and block sizes are multiples of 4 output chars (3 input bytes)
+    // so padding only ever appears at the very end
+    const size_t CHUNK_SIZE = 4096;
+    const size_t BLOCK_IN = 48;
+    static_assert(CHUNK_SIZE % 4 == 0 && (CHUNK_SIZE / 4 * 3) % BLOCK_IN == 0,
+                  "Base64 chunks must split on block boundaries");
+    size_t offset = 0;     // Output chars sent
+    size_t in_pos = 0;     // Input bytes consumed
+    int chunk_num = 0;
+
+    while (offset < base64_len) {
+        size_t chunk_len = min(CHUNK_SIZE, base64_len - offset);
+
+        if (base64_len > CHUNK_SIZE) {
+            snprintf(topic, sizeof(topic), "espsensor/%s/debug/screenshot/data/%d",
+                     client_id, chunk_num);
+        }
 
-        // Publish base64 data to /debug/screenshot/data
-        snprintf(topic, sizeof(topic), "espsensor/%s/debug/screenshot/data", client_id);
+        // Chunks exceed the client's packet buffer, so stream them
+        bool success = client->beginPublish(topic, chunk_len, false);
+        if (success) {
+            size_t chunk_in_end = min(size, in_pos + chunk_len / 4 * 3);
+            while (success && in_pos < chunk_in_end) {
+                char block[BLOCK_IN / 3 * 4];
+                size_t n = min(BLOCK_IN, chunk_in_end - in_pos);
+                size_t out_len = base64_encode_block(frame + in_pos, n, block);
+                success = client->write((const uint8_t*)block, out_len) == out_len;
+                in_pos += n;
+            }
+            success = client->endPublish() && success;
+        }
 
-        const size_t CHUNK_SIZE = 4096;
-        size_t offset = 0;
-        int chunk_num = 0;
+        if (success) {
+            LOG_DEBUG("Published chunk %d (%d bytes, offset=%d)",
+                     chunk_num, chunk_len, offset);
+        } else {
+            LOG_ERROR("Failed to publish chunk %d", chunk_num);
+            break;
+        }
 
-        while (offset < base64_len) {
-            size_t chunk_len = min(CHUNK_SIZE, base64_len - offset);
+        offset += chunk_len;
+        chunk_num++;
 
-            if (base64_len > CHUNK_SIZE) {
-                snprintf(topic, sizeof(topic), "espsensor/%s/debug/screenshot/data/%d",
-                         client_id, chunk_num);
-            }
+        if (offset < base64_len) {
+            delay(10);
+        }
+    }
 
-            bool success = client->publish(topic,
-                                          (const uint8_t*)(base64_buffer + offset),
-                                          chunk_len,
-                                          false);
-
-            if (success) {
-                LOG_DEBUG("Published chunk %d (%d bytes, offset=%d)",
-                         chunk_num, chunk_len, offset);
-            } else {
-                LOG_ERROR("Failed to publish chunk %d", chunk_num);
-                break;
-            }
+    LOG_INFO("Screenshot capture complete: %d bytes in %d chunks", base64_len, chunk_num);
+}
 
-            offset += chunk_len;
-            chunk_num++;
+// C linkage for MQTT command handler
+extern "C" void display_capture_handle(const char* payload, size_t length) {
+    LOG_INFO("Screenshot command received");
 
-            if (offset < base64_len) {
-                delay(10);
-            }
-        }
+    DisplayCapture& cap = DisplayCapture::getInstance();
+    
+    if (!cap.hasContent()) {
+        LOG_WARN("No display content captured yet");
+    }
 
-        LOG_INFO("Screenshot capture complete: %d bytes in %d chunks", base64_len, chunk_num);
-    } else {
+    PubSubClient* client = mqtt_get_client();
+    if (!client || !client->connected()) {
         LOG_ERROR("MQTT client not connected");
+        return;
     }
+    const char* client_id = mqtt_get_client_id();
 
-    delete[] base64_buffer;
+    switch (parse_capture_format(payload, length)) {
+        case CAPTURE_DELTA:
+            capture_compressed(cap, client, client_id, true);
+            break;
+        case CAPTURE_RLE:
+            capture_compressed(cap, client, client_id, false);
+            break;
+        default:
+            capture_raw(cap, client, client_id);
+            break;
+    }
 }
 
 #endif // USE_DISPLAY
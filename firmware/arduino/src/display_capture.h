@@ -6,6 +6,7 @@
 #include <Arduino.h>
 #include <cstdint>
 #include <Adafruit_GFX.h>
+#include "partial_windows.h"
 
 // Display framebuffer capture for remote debugging and monitoring
 // Uses GFXcanvas1 as a shadow buffer that mirrors all display drawing operations.
@@ -26,6 +27,13 @@
 //   DisplayCapture& cap = DisplayCapture::getInstance();
 //   size_t size;
 //   const uint8_t* buffer = cap.capture(&size);
+//
+// Double buffer (DISPLAY_DOUBLE_BUFFER): the canvas holds the next frame and
+// a second buffer keeps the previously displayed one, in PSRAM when the
+// board has it and in DRAM otherwise. The renderer diffs the two for its
+// partial windows and skips the panel write when they match. Both live in
+// RAM, so the previous frame lasts one boot: deep sleep clears it and the
+// first frame after a wake falls back to the RTC rect hashes.
 
 class DisplayCapture {
 public:
@@ -38,9 +46,10 @@ public:
     // Returns pointer to canvas buffer and sets size
     const uint8_t* capture(size_t* out_size);
 
-    // Get as base64 string (for MQTT transmission)
+    // Get as base64 string
     // Returns length of base64 string, 0 on error
-    // out_buffer must be at least BASE64_SIZE bytes
+    // out_buffer must be at least BASE64_SIZE bytes. The screenshot command
+    // does not use this; it streams base64 into the MQTT client instead.
     size_t captureBase64(char* out_buffer, size_t buffer_size);
     
     // Check if canvas has been initialized and drawn to
@@ -49,6 +58,30 @@ public:
     // Mark that content has been drawn
     void setHasContent() { has_content_ = true; }
 
+    // Last frame sent as a compressed screenshot (base for the next delta),
+    // nullptr until one has been sent
+    const uint8_t* deltaBase(uint32_t* crc) const {
+        if (crc) *crc = delta_base_crc_;
+        return delta_base_;
+    }
+
+    // Remember frame as the delta base; false if the copy cannot be allocated
+    bool setDeltaBase(const uint8_t* frame, uint32_t crc);
+
+    // Frame the panel shows (last commitFrame()), nullptr if none this boot
+    // or DISPLAY_DOUBLE_BUFFER is off
+    const uint8_t* previousFrame() const { return prev_valid_ ? prev_ : nullptr; }
+
+    // The canvas is now on the panel: keep it as the previous frame
+    void commitFrame();
+
+    // Windows (canvas pixels) over the rows and columns where the canvas
+    // differs from previousFrame(); 0 when identical or there is no previous
+    size_t diffWindows(PanelWindow* out, size_t max_out) const;
+
+    // Where the frame copies were allocated
+    bool framesInPsram() const { return frames_in_psram_; }
+
     // Display dimensions (250x122 for 2.13" eInk)
     static constexpr uint16_t WIDTH = 250;
     static constexpr uint16_t HEIGHT = 122;
@@ -58,6 +91,10 @@ public:
     static constexpr size_t BUFFER_SIZE = WIDTH_BYTES * HEIGHT;  // 3904 bytes
     static constexpr size_t BASE64_SIZE = ((BUFFER_SIZE + 2) / 3) * 4 + 1;  // ~5206 bytes
 
+    // Compressed screenshots are published in chunks of at most this many
+    // bytes, each well inside MQTT_MAX_PACKET_SIZE
+    static constexpr size_t CHUNK_BYTES = 512;
+
 private:
     DisplayCapture();
     ~DisplayCapture();
@@ -66,12 +103,20 @@ private:
 
     GFXcanvas1* canvas_ = nullptr;
     bool has_content_ = false;
+    uint8_t* delta_base_ = nullptr;   // Allocated on the first compressed capture
+    uint32_t delta_base_crc_ = 0;
+    uint8_t* prev_ = nullptr;         // Previous frame (double buffer)
+    bool prev_valid_ = false;
+    bool frames_in_psram_ = false;
 
     // Base64 encoding helper
     size_t base64Encode(const uint8_t* input, size_t input_len, char* output, size_t output_size);
 };
 
 // C linkage for MQTT command handler
+// Payload selects the format: empty/"capture" = raw base64 1bit (default),
+// "rle" = PackBits keyframe, "delta" = PackBits XOR delta against the last
+// compressed screenshot (a keyframe if there is none yet)
 extern "C" void display_capture_handle(const char* payload, size_t length);
 
 // Get the shadow canvas for drawing operations
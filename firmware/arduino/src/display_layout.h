@@ -4,9 +4,9 @@
 #pragma once
 
 // Layout identity for simulator ↔ firmware parity checks
-#define LAYOUT_VERSION 1
-#define LAYOUT_CRC 0xD601B413u
-#define LAYOUT_MD5 "3a67bd81077867cf3fea668af6cc7e6f"
+#define LAYOUT_VERSION 3
+#define LAYOUT_CRC 0x469141D8u
+#define LAYOUT_MD5 "976a1d971be49e995abe30b77d4cc935"
 
 // Display dimensions
 #define DISPLAY_WIDTH 250
@@ -17,6 +17,7 @@ static constexpr int RECT_HEADER_NAME[4] = {   6,   2,  90, 14};
 static constexpr int RECT_HEADER_VERSION[4] = { 172,   2,  72, 14};
 static constexpr int RECT_HEADER_TIME_CENTER[4] = { 100,   2,  50, 14};
 static constexpr int RECT_INSIDE_LABEL[4] = {   6,  18,  60, 14};
+static constexpr int RECT_INSIDE_HILO[4] = {  66,  20,  58, 12};
 static constexpr int RECT_INSIDE_TEMP[4] = {   6,  34, 118, 26};
 static constexpr int RECT_INSIDE_HUMIDITY[4] = {   6,  60, 118, 10};
 static constexpr int RECT_INSIDE_PRESSURE[4] = {   6,  70, 118, 10};
@@ -53,6 +54,9 @@ static_assert(2 + 14 <= DISPLAY_HEIGHT, "HEADER_TIME_CENTER height");
 static_assert(RECT_INSIDE_LABEL[0] >= 0 && RECT_INSIDE_LABEL[1] >= 0, "INSIDE_LABEL origin");
 static_assert(6 + 60 <= DISPLAY_WIDTH,  "INSIDE_LABEL width");
 static_assert(18 + 14 <= DISPLAY_HEIGHT, "INSIDE_LABEL height");
+static_assert(RECT_INSIDE_HILO[0] >= 0 && RECT_INSIDE_HILO[1] >= 0, "INSIDE_HILO origin");
+static_assert(66 + 58 <= DISPLAY_WIDTH,  "INSIDE_HILO width");
+static_assert(20 + 12 <= DISPLAY_HEIGHT, "INSIDE_HILO height");
 static_assert(RECT_INSIDE_TEMP[0] >= 0 && RECT_INSIDE_TEMP[1] >= 0, "INSIDE_TEMP origin");
 static_assert(6 + 118 <= DISPLAY_WIDTH,  "INSIDE_TEMP width");
 static_assert(34 + 26 <= DISPLAY_HEIGHT, "INSIDE_TEMP height");
@@ -13,6 +13,7 @@
 #define HEADER_VERSION (::RECT_HEADER_VERSION)
 #define HEADER_TIME_CENTER (::RECT_HEADER_TIME_CENTER)
 #define INSIDE_LABEL (::RECT_INSIDE_LABEL)
+#define INSIDE_HILO (::RECT_INSIDE_HILO)
 #define INSIDE_TEMP (::RECT_INSIDE_TEMP)
 #define INSIDE_HUMIDITY (::RECT_INSIDE_HUMIDITY)
 #define INSIDE_PRESSURE (::RECT_INSIDE_PRESSURE)
@@ -5,25 +5,18 @@
 
 #include <Arduino.h>
 #include <GxEPD2_BW.h>
+#include "panel_dma.h"
 #include "display_layout.h"
 #include "display_layout_aliases.h"
 #include "icons.h"
 #include "power.h"
 #include "net.h"
+#include "state_manager.h"
 #include "generated_config.h"
 
-// Check panel configuration
-#ifndef EINK_PANEL_DEPG0213BN
-#define EINK_PANEL_DEPG0213BN 0
-#endif
-
 // Display object - will be moved here from main.cpp later
 // For now, we'll access it via extern from main.cpp
-#if EINK_PANEL_DEPG0213BN
-extern GxEPD2_BW<GxEPD2_213_DEPG0213BN, GxEPD2_213_DEPG0213BN::HEIGHT> display;
-#else
-extern GxEPD2_BW<GxEPD2_213_GDEY0213B74, GxEPD2_213_GDEY0213B74::HEIGHT> display;
-#endif
+extern PanelDisplay display;
 
 // Constants needed for display operations
 #define HEADER_NAME_Y_ADJ -8
@@ -44,17 +37,24 @@ void draw_in_region_lambda(const int rect[4], void(*fn)(int16_t, int16_t, int16_
 void display_manager_init() {
     Serial.println("[DISPLAY] Initializing display...");
     
+    // Only a cold boot starts from unknown panel content; after deep sleep the
+    // controller RAM still holds the last frame, which partial refresh diffs
+    // against. initial=true would turn the first partial into a full refresh.
+    bool cold = needs_full_refresh_on_boot();
+    
     // Initialize display hardware
-    display.init(115200, true, 2, false);  // Serial speed, initial, pulldown_dis_time, use RST
+    display.init(115200, cold, 2, false);  // Serial speed, initial, pulldown_dis_time, use RST
     display.setRotation(3);  // Landscape orientation
     display.setTextColor(GxEPD_BLACK);
     display.setFullWindow();
     
     // Clear display with white background
-    display.firstPage();
-    do {
-        display.fillScreen(GxEPD_WHITE);
-    } while (display.nextPage());
+    if (cold) {
+        display.firstPage();
+        do {
+            display.fillScreen(GxEPD_WHITE);
+        } while (display.nextPage());
+    }
     
     #ifdef BOOT_DEBUG
     // Show test pattern during boot
@@ -86,19 +86,12 @@ void display_manager_init() {
     } while (display.nextPage());
     
     delay(2000);  // Show test pattern for 2 seconds
+    set_needs_full_refresh_on_boot(true);  // Test pattern is not a UI frame
     #endif
     
     Serial.println("[DISPLAY] Display initialized");
 }
 
-// Text width calculation
-int16_t text_width_default_font(const char* s, uint8_t size) {
-    // Default 5x7 font is 6 px advance per char at size 1
-    int16_t count = 0;
-    for (const char* p = s; *p; ++p) count++;
-    return count * 6 * size;
-}
-
 // Make a shortened condition string from weather text
 void make_short_condition_cstr(const char* weather, char* out, size_t out_size) {
     if (!out || out_size == 0)
@@ -148,9 +141,10 @@ void draw_static_chrome() {
     display.setCursor(131, 22);
     display.print(F("OUTSIDE"));
     // Version string in HEADER_VERSION region (not HEADER_TIME_CENTER)
-    String version_str = String("v") + FW_VERSION;
+    char version_str[24];
+    snprintf(version_str, sizeof(version_str), "v%s", FW_VERSION);
     display.setCursor(
-        HEADER_VERSION[0] + HEADER_VERSION[2] - 2 - text_width_default_font(version_str.c_str(), 1),
+        HEADER_VERSION[0] + HEADER_VERSION[2] - 2 - text_width_default_font(version_str, 1),
         HEADER_VERSION[1] + HEADER_VERSION[3] - 6);
     display.print(F("v"));
     display.print(FW_VERSION);
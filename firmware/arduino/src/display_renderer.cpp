@@ -4,6 +4,7 @@
 #if USE_DISPLAY
 
 #include <GxEPD2_BW.h>
+#include "panel_dma.h"
 #include "display_layout.h"
 #include "display_layout_aliases.h"
 #include "display_manager.h"
@@ -25,36 +26,36 @@ using namespace ui;
 #include "profiling.h"
 #include "display_capture.h"
 #include "dual_gfx.h"
-
-// Helper macro: draw to both display and screenshot canvas if context is set
+#include "partial_windows.h"
+#include "render_model.h"
+#include "rtc_state.h"
+#include "display_blit.h"
+#include "energy_meter.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "glyph_cache.h"
+#include "spec_draw.h"
+#include "ui_variant_select.h"
+
+// Helper macro: draw through the DualGFX context if set (display and/or
+// screenshot canvas, colors mapped per target), otherwise to the display
 #define DUAL_DRAW(method, ...) do { \
-    display.method(__VA_ARGS__); \
     DualGFX* _ctx = get_dual_gfx_context(); \
-    if (_ctx && _ctx->getSecondary()) { \
-        _ctx->getSecondary()->method(__VA_ARGS__); \
+    if (_ctx) { \
+        _ctx->method(__VA_ARGS__); \
+    } else { \
+        display.method(__VA_ARGS__); \
     } \
 } while(0)
 
-// For setTextColor which takes a GxEPD color that needs mapping to canvas color
-#define DUAL_SET_TEXT_COLOR(color) do { \
-    display.setTextColor(color); \
-    DualGFX* _ctx = get_dual_gfx_context(); \
-    if (_ctx && _ctx->getSecondary()) { \
-        uint16_t _mapped = (color == 0xFFFF) ? 1 : 0; \
-        _ctx->getSecondary()->setTextColor(_mapped); \
-    } \
-} while(0)
+// setTextColor takes a GxEPD color; DualGFX maps it for canvas targets
+#define DUAL_SET_TEXT_COLOR(color) DUAL_DRAW(setTextColor, color)
 
 // External display object from main.cpp
-#if EINK_PANEL_DEPG0213BN
-extern GxEPD2_BW<GxEPD2_213_DEPG0213BN, GxEPD2_213_DEPG0213BN::HEIGHT> display;
-#else
-extern GxEPD2_BW<GxEPD2_213_GDEY0213B74, GxEPD2_213_GDEY0213B74::HEIGHT> display;
-#endif
+extern PanelDisplay display;
 
 // External variables from main.cpp
 extern float get_last_outside_f();
-extern uint16_t partial_counter;
 extern bool g_full_only_mode;
 
 // Constants for display layout
@@ -144,54 +145,20 @@ void draw_right_aligned_text_in_rect(const int rect[4], const char* text,
 // Draw temperature with units
 void draw_temp_number_and_units(const int r[4], const char* t) {
   draw_in_region(r, [&](int16_t x, int16_t y, int16_t w, int16_t h) {
-    DUAL_SET_TEXT_COLOR(GxEPD_BLACK);
-    DUAL_DRAW(setTextSize, 2);
-    
-    int16_t x1, y1;
-    uint16_t bw, bh;
-    display.getTextBounds(t, 0, 0, &x1, &y1, &bw, &bh);
-    
-    int16_t targetX = x + (w - static_cast<int16_t>(bw)) / 2;
-    int16_t targetY = y + (h - static_cast<int16_t>(bh)) / 2;
-    int16_t baseX = targetX - x1;
-    int16_t baseY = targetY - y1;
-    
-    DUAL_DRAW(setCursor, baseX, baseY);
-    DUAL_DRAW(print, t);
-    
-    // Draw units
-    DUAL_DRAW(setTextSize, 1);
-    DUAL_DRAW(setCursor, baseX + static_cast<int16_t>(bw) + 2, baseY - 8);
-    DUAL_DRAW(print, "\xF8");
-    DUAL_DRAW(setCursor, baseX + static_cast<int16_t>(bw) + 8, baseY - 8);
-    DUAL_DRAW(print, "F");
+    draw_temp_number_and_units_direct(x, y, w, h, t);
   });
 }
 
 // Direct temperature drawing (without region clearing)
 void draw_temp_number_and_units_direct(int16_t x, int16_t y, int16_t w, int16_t h,
                                        const char* t) {
-  DUAL_SET_TEXT_COLOR(GxEPD_BLACK);
-  DUAL_DRAW(setTextSize, 2);
-  
-  int16_t x1, y1;
-  uint16_t bw, bh;
-  display.getTextBounds(t, 0, 0, &x1, &y1, &bw, &bh);
-  
-  int16_t targetX = x + (w - static_cast<int16_t>(bw)) / 2;
-  int16_t targetY = y + (h - static_cast<int16_t>(bh)) / 2;
-  int16_t baseX = targetX - x1;
-  int16_t baseY = targetY - y1;
-  
-  DUAL_DRAW(setCursor, baseX, baseY);
-  DUAL_DRAW(print, t);
-  
-  // Draw units (degree symbol and F)
-  DUAL_DRAW(setTextSize, 1);
-  DUAL_DRAW(setCursor, baseX + static_cast<int16_t>(bw) + 2, baseY - 8);
-  DUAL_DRAW(print, "\xF8");  // degree symbol
-  DUAL_DRAW(setCursor, baseX + static_cast<int16_t>(bw) + 8, baseY - 8);
-  DUAL_DRAW(print, "F");
+  // Draw through the context (display and/or screenshot canvas) if set
+  DualGFX* ctx = get_dual_gfx_context();
+  if (ctx) {
+    spec_draw_temp(*ctx, x, y, w, h, t);
+  } else {
+    spec_draw_temp(display, x, y, w, h, t);
+  }
 }
 
 // Draw header time
@@ -214,22 +181,17 @@ void draw_weather_icon_region_at(int16_t x, int16_t y, int16_t w, int16_t h,
   if (!condition) return;
   
   // Map condition to icon ID
-  IconId iconId = map_weather_to_icon(condition);
-  
-  // Center the baked icon within the region using generated dimensions
-  // Clamp positions to prevent drawing outside intended region when icon > region
-  int16_t icon_x = x + (w - ICON_W) / 2;
-  int16_t icon_y = y + (h - ICON_H) / 2;
-  if (icon_x < x) icon_x = x;  // Don't go left of region
-  if (icon_y < y) icon_y = y;  // Don't go above region
-  
-  // Draw the icon to display
-  draw_icon(display, icon_x, icon_y, iconId, GxEPD_BLACK);
-  
-  // Also draw to screenshot canvas if context is set
+  draw_weather_icon_id_at(x, y, w, h, map_weather_to_icon(condition));
+}
+
+// Draw an already-mapped weather icon centered in a region
+void draw_weather_icon_id_at(int16_t x, int16_t y, int16_t w, int16_t h, IconId iconId) {
+  // Draw through the context (display and/or screenshot canvas) if set
   DualGFX* ctx = get_dual_gfx_context();
-  if (ctx && ctx->getSecondary()) {
-    draw_icon(*ctx->getSecondary(), icon_x, icon_y, iconId, 0);  // 0 = black for canvas
+  if (ctx) {
+    spec_draw_icon(*ctx, x, y, w, h, iconId);
+  } else {
+    spec_draw_icon(display, x, y, w, h, iconId);
   }
 }
 
@@ -241,9 +203,277 @@ void draw_weather_icon_region_at_from_outside(int16_t x, int16_t y, int16_t w, i
   }
 }
 
+#ifndef FULL_REFRESH_EVERY
+#define FULL_REFRESH_EVERY 12
+#endif
+
 // Forward declaration for spec-based rendering (implemented in main.cpp)
 #if USE_UI_SPEC
-extern void draw_from_spec_full_impl(uint8_t variantId);
+extern void draw_from_spec_full_impl(uint8_t variantId, const RenderModel& m);
+extern void draw_from_spec_rects_impl(uint8_t variantId, const RenderModel& m,
+                                      uint32_t rectMask, bool capture);
+
+// Per-RectId content hashes of what the panel currently shows live in
+// g_rtc_state.rect_hashes. Usable only when every rect is valid, i.e. a
+// full refresh has drawn them all since the RTC state was last reset.
+static constexpr uint32_t ALL_RECTS_MASK =
+    ui::RECT__COUNT >= 32 ? 0xFFFFFFFFu : ((1u << ui::RECT__COUNT) - 1u);
+
+static_assert(ui::RECT__COUNT <= SmartRefresh::MAX_REGIONS,
+              "SmartRefresh cannot track every spec rect");
+
+// Bitmask of rects intersecting a window; their ops are redrawn (clipped)
+// so the byte-aligned window does not wipe neighbouring content
+static uint32_t spec_rects_in_window(int16_t x, int16_t y, int16_t w, int16_t h) {
+  uint32_t mask = 0;
+  for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) {
+    const int* r = rect_ptr_by_id(rid);
+    if (!r) continue;
+    if (r[0] < x + w && x < r[0] + r[2] && r[1] < y + h && y < r[1] + r[3])
+      mask |= 1u << rid;
+  }
+  return mask;
+}
+
+// Partial-window update of one byte-aligned window
+static void spec_partial_refresh_window(uint8_t variantId, const RenderModel& m,
+                                        const PanelWindow& win) {
+  uint32_t mask = spec_rects_in_window(win.x, win.y, win.w, win.h);
+
+  display.setPartialWindow(win.x, win.y, win.w, win.h);
+  display.firstPage();
+  do {
+    display.fillScreen(GxEPD_WHITE);
+    draw_from_spec_rects_impl(variantId, m, mask, false);
+#if USE_STATUS_PIXEL
+    status_pixel_tick();
+#endif
+    yield();
+  } while (display.nextPage());
+}
+
+extern void draw_from_spec_canvas_impl(uint8_t variantId, const RenderModel& m,
+                                       GFXcanvas1* canvas);
+
+#if SPEC_CANVAS_BLIT
+static_assert(decltype(display.epd2)::WIDTH == PANEL_NATIVE_WIDTH &&
+              decltype(display.epd2)::HEIGHT == PANEL_NATIVE_HEIGHT,
+              "Panel geometry does not match the canvas blit");
+static_assert(DisplayCapture::WIDTH == BLIT_CANVAS_WIDTH &&
+              DisplayCapture::HEIGHT == BLIT_CANVAS_HEIGHT,
+              "Screenshot canvas does not match the canvas blit");
+
+// Internal RAM and word-aligned, so the DMA transport sends it in place
+alignas(4) static uint8_t g_panel_native[PANEL_NATIVE_BUFFER_SIZE];
+
+// Waveform and previous-frame RAM write for a frame already in panel RAM
+static void spec_blit_finish(bool full, const PanelWindow* wins, size_t win_count) {
+  ENERGY_RAIL_ON(ENERGY_PANEL);
+  if (full) {
+    display.epd2.refresh(false);
+  } else {
+    for (size_t i = 0; i < win_count; ++i) {
+      PanelWindow nw = blit_window_rot3_to_native(wins[i]);
+      if (nw.w > 0 && nw.h > 0) display.epd2.refresh(nw.x, nw.y, nw.w, nw.h);
+#if USE_STATUS_PIXEL
+      status_pixel_tick();
+#endif
+      yield();
+    }
+  }
+  // Previous-frame RAM now matches, so the next partial diffs correctly
+  display.epd2.writeImageAgain(g_panel_native, 0, 0, PANEL_NATIVE_WIDTH, PANEL_NATIVE_HEIGHT);
+  if (full) display.epd2.powerOff();
+  ENERGY_RAIL_OFF(ENERGY_PANEL);
+}
+
+#if DISPLAY_ASYNC_REFRESH
+// Background waveform: GxEPD2 waits on BUSY with delay(), which yields, so
+// the main task keeps the radio busy while the panel updates
+struct BlitJob {
+  bool full;
+  PanelWindow wins[ui::RECT__COUNT];
+  size_t win_count;
+};
+
+static BlitJob g_blit_job;
+static SemaphoreHandle_t g_blit_done = nullptr;
+static bool g_blit_pending = false;
+
+static void spec_blit_task(void* arg) {
+  (void)arg;
+  spec_blit_finish(g_blit_job.full, g_blit_job.wins, g_blit_job.win_count);
+  xSemaphoreGive(g_blit_done);
+  vTaskDelete(nullptr);
+}
+
+// Start the waveform task; returns false if it could not be created
+static bool spec_blit_start_async(bool full, const PanelWindow* wins, size_t win_count) {
+  if (!g_blit_done) g_blit_done = xSemaphoreCreateBinary();
+  if (!g_blit_done) return false;
+
+  g_blit_job.full = full;
+  g_blit_job.win_count = win_count;
+  memcpy(g_blit_job.wins, wins, win_count * sizeof(PanelWindow));
+
+  // Above the main task so BUSY is serviced as soon as it drops
+  BaseType_t ok = xTaskCreate(spec_blit_task, "panel_refresh", 4096, nullptr,
+                              tskIDLE_PRIORITY + 2, nullptr);
+  if (ok != pdPASS) return false;
+  g_blit_pending = true;
+  return true;
+}
+#endif
+
+// Single-pass render: draw the frame once into the screenshot canvas,
+// convert it to controller layout and write it to panel RAM in one go. The
+// screenshot is then, by construction, exactly what the panel shows.
+// Returns false if the canvas is unavailable so the caller can page instead.
+// With the double buffer, a partial's windows come from the pixel diff
+// against the frame on the panel (wins and win_count are updated).
+static bool spec_blit_refresh(uint8_t variantId, const RenderModel& m, bool full,
+                              PanelWindow* wins, size_t& win_count) {
+  GFXcanvas1* canvas = display_capture_canvas();
+  if (!canvas || display.getRotation() != 3) return false;
+  display_wait_idle(DISPLAY_PHASE_TIMEOUT_MS);  // g_panel_native is in use until then
+
+  canvas->fillScreen(0);
+  draw_from_spec_canvas_impl(variantId, m, canvas);
+#if DISPLAY_DOUBLE_BUFFER
+  DisplayCapture& cap = DisplayCapture::getInstance();
+  if (!full && cap.previousFrame()) {
+    win_count = cap.diffWindows(wins, ui::RECT__COUNT);
+    for (size_t i = 0; i < win_count; ++i) {
+      wins[i] = panel_window_aligned(wins[i].x, wins[i].y, wins[i].w, wins[i].h);
+    }
+    win_count = panel_windows_coalesce(wins, win_count, SPEC_PARTIAL_MAX_WINDOWS);
+  }
+#endif
+  if (!full && win_count == 0) return true;  // Panel already shows this frame
+
+  blit_canvas_rot3_to_native(canvas->getBuffer(), g_panel_native);
+
+  display.epd2.writeImage(g_panel_native, 0, 0, PANEL_NATIVE_WIDTH, PANEL_NATIVE_HEIGHT);
+#if DISPLAY_SPI_DMA
+  const PanelDmaStats& dma = panel_dma_stats();
+  Serial.printf("[Display] Frame write: %lu us by DMA (%lu bursts, %lu fallbacks)\n",
+                (unsigned long)dma.last_us, (unsigned long)dma.bursts,
+                (unsigned long)dma.fallbacks);
+#endif
+#if DISPLAY_ASYNC_REFRESH
+  if (spec_blit_start_async(full, wins, win_count)) return true;
+#endif
+  spec_blit_finish(full, wins, win_count);
+  return true;
+}
+#endif
+
+// Layout for this wake's battery level; the panel's current one breaks ties
+// inside the hysteresis bands
+static uint8_t spec_variant(const RenderModel& m) {
+  static const UiVariantPolicy kPolicy = {
+    UI_VARIANT_BASE, ui::UIVAR_COMPACT, ui::UIVAR_LOW_BATTERY,
+    UI_COMPACT_BELOW_PCT, UI_LOW_BATTERY_BELOW_PCT, UI_VARIANT_HYSTERESIS_PCT,
+  };
+  float pct = m.value[ui::FIELD_BATTERY_PERCENT];
+  return ui_variant_select(g_rtc_state.ui_variant, isfinite(pct) ? (int)pct : -1, kPolicy);
+}
+
+// Spec render with per-rect dirty tracking: hash every rect's content,
+// then either do a periodic/forced full refresh or partial-refresh only the
+// rects whose hash changed since the panel was last drawn. All readings are
+// taken once per wake into the shared RenderModel used by both passes.
+static void spec_refresh(uint8_t variantId) {
+  const RenderModel& model = render_model_current();
+
+  SmartRefresh& sr = SmartRefresh::getInstance();
+  SmartRefresh::Snapshot& snap = g_rtc_state.rect_hashes;
+  for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) sr.registerRegion(rid);
+  bool restored = (snap.valid_mask & ALL_RECTS_MASK) == ALL_RECTS_MASK;
+  sr.restore(snap);
+
+  bool partial_ok = remote_config_feature(g_rtc_state.config, RCFG_FEATURE_PARTIAL_REFRESH,
+                                          SPEC_PARTIAL_REFRESH);
+  // Another layout leaves nothing of the old frame to keep
+  bool full = !partial_ok || !restored || needs_full_refresh_on_boot() ||
+              get_full_only_mode() || get_partial_counter() >= FULL_REFRESH_EVERY ||
+              variantId != g_rtc_state.ui_variant;
+
+  // Same model as the frame on the panel: no rect can differ, so skip
+  // walking the ops to hash them
+  uint32_t model_hash = render_model_hash(model);
+  uint32_t hashes[ui::RECT__COUNT];
+  if (restored && !full && g_rtc_state.model_hash_valid &&
+      model_hash == g_rtc_state.last_model_hash) {
+    memcpy(hashes, snap.hash, sizeof(hashes));
+  } else {
+    render_model_rect_hashes(variantId, model, hashes, ui::RECT__COUNT);
+  }
+  for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) {
+    sr.hasHashChanged(rid, hashes[rid]);
+  }
+  uint32_t dirty = sr.getDirtyMask();
+
+  // Each window costs a full waveform regardless of size, so merge the
+  // dirty rects into as few windows as possible first
+  PanelWindow wins[ui::RECT__COUNT];
+  size_t win_count = 0;
+  if (!full) {
+    for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) {
+      if (!(dirty & (1u << rid))) continue;
+      const int* r = rect_ptr_by_id(rid);
+      if (r) wins[win_count++] = panel_window_aligned(r[0], r[1], r[2], r[3]);
+    }
+    win_count = panel_windows_coalesce(wins, win_count, SPEC_PARTIAL_MAX_WINDOWS);
+  }
+
+#if SPEC_CANVAS_BLIT
+  bool blitted = spec_blit_refresh(variantId, model, full, wins, win_count);
+#else
+  bool blitted = false;
+#endif
+
+  if (full) {
+    if (!blitted) {
+      display.setFullWindow();
+      display.firstPage();
+      do {
+        display.fillScreen(GxEPD_WHITE);
+        // draw_from_spec_full_impl sets up DualGFX context and draws to both
+        // display and screenshot canvas
+        draw_from_spec_full_impl(variantId, model);
+      } while (display.nextPage());
+    }
+    reset_partial_counter();
+    set_needs_full_refresh_on_boot(false);
+  } else {
+    if (!blitted) {
+      for (size_t i = 0; i < win_count; ++i) {
+        spec_partial_refresh_window(variantId, model, wins[i]);
+      }
+    }
+    Serial.printf("[Display] Partial refresh: dirty rects 0x%04X in %u window(s)\n",
+                  dirty, (unsigned)win_count);
+    if (dirty && win_count) increment_partial_counter();
+
+    // Partial passes skip the canvas; render the whole frame into it once so
+    // screenshots still match the panel (the page buffer is not flushed again)
+    GFXcanvas1* canvas = display_capture_canvas();
+    if (canvas && !blitted) {
+      canvas->fillScreen(0);
+      draw_from_spec_full_impl(variantId, model);
+    }
+  }
+
+  for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) sr.markClean(rid);
+  sr.snapshot(snap);
+#if DISPLAY_DOUBLE_BUFFER
+  DisplayCapture::getInstance().commitFrame();   // The canvas matches the panel on every path
+#endif
+  g_rtc_state.last_model_hash = model_hash;
+  g_rtc_state.model_hash_valid = 1;
+  g_rtc_state.ui_variant = variantId;
+}
 #endif
 
 // Full display refresh
@@ -252,16 +482,7 @@ void full_refresh() {
   
 #if USE_UI_SPEC
   // Use spec-based rendering for simulator/device parity
-  display.setFullWindow();
-  display.firstPage();
-  
-  do {
-    display.fillScreen(GxEPD_WHITE);
-    // draw_from_spec_full_impl sets up DualGFX context and draws to both
-    // display and screenshot canvas
-    draw_from_spec_full_impl(0); // variantId 0 = "v2"
-  } while (display.nextPage());
-  reset_partial_counter();
+  spec_refresh(spec_variant(render_model_current()));
   return;
 #endif
 
@@ -280,6 +501,8 @@ void full_refresh() {
     regions_registered = true;
   }
 
+  const RenderModel& model = render_model_current();
+
   display.setFullWindow();
   display.firstPage();
   do {
@@ -287,49 +510,15 @@ void full_refresh() {
     draw_static_chrome();
 
     // Draw current time
-    char time_str[6];
-    net_time_hhmm(time_str, sizeof(time_str));
     // Track time changes (though we always redraw in full refresh)
-    SmartRefresh::getInstance().hasContentChanged(6, time_str);
-    draw_header_time_direct(time_str);
+    SmartRefresh::getInstance().hasContentChanged(6, model.time_hhmm);
+    draw_header_time_direct(model.time_hhmm);
 
-    // Get current sensor readings
-    InsideReadings inside = read_inside_sensors();
-    OutsideReadings outside = net_get_outside();
-    
-    // Format inside temperature
-    char in_temp[8];
-    if (isfinite(inside.temperatureC)) {
-      float tempF = inside.temperatureC * 9.0f / 5.0f + 32.0f;
-      snprintf(in_temp, sizeof(in_temp), "%.0f", tempF);
-    } else {
-      safe_strcpy(in_temp, "--");
-    }
-
-    // Format inside humidity
-    char in_rh[8];
-    if (isfinite(inside.humidityPct)) {
-      snprintf(in_rh, sizeof(in_rh), "%.0f", inside.humidityPct);
-    } else {
-      safe_strcpy(in_rh, "--");
-    }
-
-    // Format outside temperature
-    char out_temp[8];
-    if (outside.validTemp && isfinite(outside.temperatureC)) {
-      float tempF = outside.temperatureC * 9.0f / 5.0f + 32.0f;
-      snprintf(out_temp, sizeof(out_temp), "%.0f", tempF);
-    } else {
-      safe_strcpy(out_temp, "--");
-    }
-
-    // Format outside humidity
-    char out_rh[8];
-    if (outside.validHum && isfinite(outside.humidityPct)) {
-      snprintf(out_rh, sizeof(out_rh), "%.0f", outside.humidityPct);
-    } else {
-      safe_strcpy(out_rh, "--");
-    }
+    // Readings were taken and formatted once into the render model
+    const char* in_temp = model.formatted[ui::FIELD_INSIDE_TEMP_F];
+    const char* in_rh = model.formatted[ui::FIELD_INSIDE_HUM_PCT];
+    const char* out_temp = model.formatted[ui::FIELD_OUTSIDE_TEMP_F];
+    const char* out_rh = model.formatted[ui::FIELD_OUTSIDE_HUM_PCT];
 
     // Track content changes for smart refresh statistics
     SmartRefresh& sr = SmartRefresh::getInstance();
@@ -350,9 +539,10 @@ void full_refresh() {
     display.print("% RH");
 
     // Draw inside pressure if available
-    if (isfinite(inside.pressureHPa)) {
+    if (isfinite(model.value[ui::FIELD_PRESSURE_HPA])) {
       char pressure_str[12];
-      snprintf(pressure_str, sizeof(pressure_str), "%.0f", inside.pressureHPa);
+      render_model_format(model, ui::FIELD_PRESSURE_HPA, ui::CONV_NONE, 0,
+                          pressure_str, sizeof(pressure_str));
       sr.hasContentChanged(2, pressure_str); // Track pressure changes
       display.setCursor(INSIDE_PRESSURE[0], INSIDE_PRESSURE[1] + INSIDE_PRESSURE[3] - 4);
       display.print(pressure_str);
@@ -371,24 +561,24 @@ void full_refresh() {
     // This would need to be added to the OutsideReadings struct if needed
 
     // Draw wind speed if available (convert from m/s to mph)
-    if (outside.validWind && isfinite(outside.windMps)) {
+    if (isfinite(model.value[ui::FIELD_WIND_MPS])) {
       char wind_str[12];
-      float windMph = outside.windMps * 2.237f; // m/s to mph conversion
-      snprintf(wind_str, sizeof(wind_str), "%.0f mph", windMph);
+      size_t n = render_model_format(model, ui::FIELD_WIND_MPS, ui::CONV_MPS_TO_MPH, 0,
+                                     wind_str, sizeof(wind_str));
+      snprintf(wind_str + n, sizeof(wind_str) - n, " mph");
       display.setCursor(OUT_WIND[0], OUT_WIND[1] + OUT_WIND[3] - 4);
       display.print(wind_str);
     }
     
     // Draw weather icon and text
-    if (outside.validWeather && outside.weather[0]) {
+    if (model.weather[0]) {
       // Draw icon in WEATHER_ICON region
       draw_weather_icon_region_at(WEATHER_ICON[0], WEATHER_ICON[1],
-                                  WEATHER_ICON[2], WEATHER_ICON[3], outside.weather);
+                                  WEATHER_ICON[2], WEATHER_ICON[3], model.weather);
       
       // Draw weather text centered in FOOTER_WEATHER region (y=109)
       // This matches the simulator's ui_spec.json layout
-      char short_condition[24];
-      make_short_condition_cstr(outside.weather, short_condition, sizeof(short_condition));
+      const char* short_condition = model.short_condition;
       sr.hasContentChanged(5, short_condition); // Track weather changes
       display.setTextColor(GxEPD_BLACK);
       display.setTextSize(1);
@@ -402,15 +592,41 @@ void full_refresh() {
     }
     
     // Draw battery status and IP
-    BatteryStatus bs = read_battery_status();
-    char ip_str[32];
-    net_ip_cstr(ip_str, sizeof(ip_str));
-    draw_status_line_direct(bs, ip_str);
+    draw_status_line_direct(model.battery, model.ip);
     
   } while (display.nextPage());
   
   // Reset partial counter after full refresh
   reset_partial_counter();
+  set_needs_full_refresh_on_boot(false);
+  g_rtc_state.last_model_hash = render_model_hash(model);
+  g_rtc_state.model_hash_valid = 1;
+}
+
+bool display_frame_unchanged() {
+  if (!g_rtc_state.model_hash_valid) return false;
+  if (needs_full_refresh_on_boot() || get_full_only_mode() ||
+      get_partial_counter() >= FULL_REFRESH_EVERY) {
+    return false;
+  }
+#if USE_UI_SPEC
+  if (spec_variant(render_model_current()) != g_rtc_state.ui_variant) return false;
+#endif
+  return render_model_hash(render_model_current()) == g_rtc_state.last_model_hash;
+}
+
+bool display_wait_idle(uint32_t timeout_ms) {
+#if USE_UI_SPEC && SPEC_CANVAS_BLIT && DISPLAY_ASYNC_REFRESH
+  if (!g_blit_pending) return true;
+  if (xSemaphoreTake(g_blit_done, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+    Serial.println("[Display] Background refresh still busy - giving up the wait");
+    return false;
+  }
+  g_blit_pending = false;
+#else
+  (void)timeout_ms;
+#endif
+  return true;
 }
 
 // Smoke test for display
@@ -446,128 +662,39 @@ void dev_display_tick() {
 void draw_from_spec_full(uint8_t variantId) {
   #if USE_UI_SPEC
   // Delegate to the full implementation in main.cpp
-  extern void draw_from_spec_full_impl(uint8_t variantId);
-  draw_from_spec_full_impl(variantId);
+  draw_from_spec_full_impl(variantId, render_model_current());
   #endif
 }
 
 // Weather icon mapping functions
-IconId map_weather_to_icon(const char* w) {
-  String s(w);
-  s.toLowerCase();
-  // First handle Home Assistant recommended values exactly
-  
-  // https://developers.home-assistant.io/docs/core/entity/weather/#recommended-values-for-state-and-condition
-  if (s == "clear-night")
-    return ICON_WEATHER_NIGHT;
-  if (s == "cloudy")
-    return ICON_WEATHER_CLOUDY;
-  if (s == "exceptional")
-    return ICON_WEATHER_CLOUDY;  // generic fallback
-  if (s == "fog")
-    return ICON_WEATHER_FOG;
-  if (s == "hail")
-    return ICON_WEATHER_SNOWY;  // approximate
-  if (s == "lightning")
-    return ICON_WEATHER_LIGHTNING;
-  if (s == "lightning-rainy")
-    return ICON_WEATHER_LIGHTNING;  // prefer lightning cue
-  if (s == "partlycloudy")
-    return ICON_WEATHER_PARTLY_CLOUDY;
-  if (s == "pouring")
-    return ICON_WEATHER_POURING;
-  if (s == "rainy")
-    return ICON_WEATHER_POURING;
-  if (s == "snowy")
-    return ICON_WEATHER_SNOWY;
-  if (s == "snowy-rainy")
-    return ICON_WEATHER_SNOWY;  // approximate
-  if (s == "sunny")
-    return ICON_WEATHER_SUNNY;
-  if (s == "windy" || s == "windy-variant")
-    return ICON_WEATHER_CLOUDY;  // approximate
-  // Also accept explicit MDI icon names if passed through
-  if (s == "weather-sunny")
-    return ICON_WEATHER_SUNNY;
-  if (s == "weather-partly-cloudy")
-    return ICON_WEATHER_PARTLY_CLOUDY;
-  if (s == "weather-cloudy")
-    return ICON_WEATHER_CLOUDY;
-  if (s == "weather-fog")
-    return ICON_WEATHER_FOG;
-  if (s == "weather-pouring" || s == "weather-rainy")
-    return ICON_WEATHER_POURING;
-  if (s == "weather-snowy")
-    return ICON_WEATHER_SNOWY;
-  if (s == "weather-lightning")
-    return ICON_WEATHER_LIGHTNING;
-  if (s == "weather-night")
-    return ICON_WEATHER_NIGHT;
-  if (s == "weather-night-partly-cloudy")
-    return ICON_WEATHER_NIGHT_PARTLY_CLOUDY;
-  if (s.indexOf("tornado") >= 0)
-    return ICON_WEATHER_TORNADO;
-  if (s.indexOf("hurricane") >= 0)
-    return ICON_WEATHER_HURRICANE;
-  if (s.indexOf("drizzle") >= 0)
-    return ICON_WEATHER_DRIZZLE;
-  if (s.indexOf("storm") >= 0 || s.indexOf("thunder") >= 0 || s.indexOf("lightning") >= 0) {
-    return ICON_WEATHER_LIGHTNING;
-  }
-  if (s.indexOf("pour") >= 0 || s.indexOf("rain") >= 0 || s.indexOf("shower") >= 0) {
-    return ICON_WEATHER_POURING;
+IconId weather_kind_icon(WeatherKind kind) {
+  switch (kind) {
+    case WEATHER_KIND_PARTLY_CLOUDY: return ICON_WEATHER_PARTLY_CLOUDY;
+    case WEATHER_KIND_CLOUDY: return ICON_WEATHER_CLOUDY;
+    case WEATHER_KIND_FOG: return ICON_WEATHER_FOG;
+    case WEATHER_KIND_POURING: return ICON_WEATHER_POURING;
+    case WEATHER_KIND_DRIZZLE: return ICON_WEATHER_DRIZZLE;
+    case WEATHER_KIND_SNOWY: return ICON_WEATHER_SNOWY;
+    case WEATHER_KIND_LIGHTNING: return ICON_WEATHER_LIGHTNING;
+    case WEATHER_KIND_HURRICANE: return ICON_WEATHER_HURRICANE;
+    case WEATHER_KIND_TORNADO: return ICON_WEATHER_TORNADO;
+    case WEATHER_KIND_NIGHT: return ICON_WEATHER_NIGHT;
+    case WEATHER_KIND_NIGHT_PARTLY_CLOUDY: return ICON_WEATHER_NIGHT_PARTLY_CLOUDY;
+    default: return ICON_WEATHER_SUNNY;
   }
-  if (s.indexOf("snow") >= 0)
-    return ICON_WEATHER_SNOWY;
-  if (s.indexOf("fog") >= 0 || s.indexOf("mist") >= 0 || s.indexOf("haze") >= 0)
-    return ICON_WEATHER_FOG;
-  if (s.indexOf("part") >= 0)
-    return ICON_WEATHER_PARTLY_CLOUDY;
-  if (s.indexOf("cloud") >= 0 || s.indexOf("overcast") >= 0)
-    return ICON_WEATHER_CLOUDY;
-  if (s.indexOf("night") >= 0)
-    return ICON_WEATHER_NIGHT;
-  return ICON_WEATHER_SUNNY;
 }
 
-// Map OpenWeather primary item (id/icon) to our icon set; fallback to string mapping
+IconId map_weather_to_icon(const char* w) {
+  return weather_kind_icon(weather_classify(w));
+}
+
+// Map the outside condition to our icon set; the kind is classified when the
+// value arrives, so only readings built elsewhere need classifying here
 IconId map_openweather_to_icon(const OutsideReadings& o) {
-  // Prefer explicit icon code when provided (e.g., "10n") for day/night
-  if (o.validWeather && o.weather[0]) {
-    const char* ic = o.weather;
-    // Normalize length
-    if (strlen(ic) >= 2) {
-      if (strncmp(ic, "01", 2) == 0)
-        return (strchr(ic, 'n') ? ICON_WEATHER_NIGHT : ICON_WEATHER_SUNNY);
-      if (strncmp(ic, "02", 2) == 0)
-        return (strchr(ic, 'n') ? ICON_WEATHER_NIGHT_PARTLY_CLOUDY : ICON_WEATHER_PARTLY_CLOUDY);
-      if (strncmp(ic, "03", 2) == 0)
-        return ICON_WEATHER_CLOUDY;
-      if (strncmp(ic, "04", 2) == 0)
-        return ICON_WEATHER_CLOUDY;
-      if (strncmp(ic, "09", 2) == 0)
-        return ICON_WEATHER_DRIZZLE; // showers/drizzle
-      if (strncmp(ic, "10", 2) == 0)
-        return ICON_WEATHER_POURING; // rain
-      if (strncmp(ic, "11", 2) == 0)
-        return ICON_WEATHER_LIGHTNING;
-      if (strncmp(ic, "13", 2) == 0)
-        return ICON_WEATHER_SNOWY;
-      if (strncmp(ic, "50", 2) == 0)
-        return ICON_WEATHER_FOG; // atmosphere group
-      // Edge codes often seen
-      if (strncmp(ic, "51", 2) == 0 || strncmp(ic, "53", 2) == 0)
-        return ICON_WEATHER_DRIZZLE; // drizzle variants
-      if (strncmp(ic, "61", 2) == 0)
-        return ICON_WEATHER_DRIZZLE; // light rain
-      if (strncmp(ic, "80", 2) == 0)
-        return ICON_WEATHER_POURING; // shower rain
-    }
-  }
-  // Fallback: heuristics from free-form string
-  if (o.validWeather && o.weather[0])
-    return map_weather_to_icon(o.weather);
-  return ICON_WEATHER_SUNNY;
+  if (!o.validWeather || !o.weather[0]) return ICON_WEATHER_SUNNY;
+  WeatherKind kind = (WeatherKind)o.weatherKind;
+  if (kind == WEATHER_KIND_UNKNOWN) kind = weather_classify(o.weather);
+  return weather_kind_icon(kind);
 }
 
 // Draw sensor values on display
@@ -600,46 +727,4 @@ void draw_values(const char* in_temp_f, const char* in_rh, const char* out_temp_
   // Status line drawn separately by partial
 }
 
-#if USE_UI_SPEC
-// Utility to map RectId->rect pointer
-const int* rect_ptr_by_id(uint8_t rid) {
-  switch (rid) {
-    case ui::RECT_HEADER_NAME:
-      return HEADER_NAME;
-    case ui::RECT_HEADER_TIME_CENTER:
-      return HEADER_TIME_CENTER;
-    case ui::RECT_HEADER_VERSION:
-      return HEADER_VERSION;
-    case ui::RECT_INSIDE_LABEL:
-      return INSIDE_LABEL;
-    case ui::RECT_INSIDE_TEMP:
-      return INSIDE_TEMP;
-    case ui::RECT_INSIDE_HUMIDITY:
-      return INSIDE_HUMIDITY;
-    case ui::RECT_INSIDE_PRESSURE:
-      return INSIDE_PRESSURE;
-    case ui::RECT_OUTSIDE_LABEL:
-      return OUTSIDE_LABEL;
-    case ui::RECT_OUT_TEMP:
-      return OUT_TEMP;
-    case ui::RECT_WEATHER_ICON:
-      return WEATHER_ICON;
-    case ui::RECT_FOOTER_WEATHER:
-      return FOOTER_WEATHER;
-    case ui::RECT_FOOTER_BATTERY:
-      return FOOTER_BATTERY;
-    case ui::RECT_OUT_PRESSURE:
-      return OUT_PRESSURE;
-    case ui::RECT_OUT_HUMIDITY:
-      return OUT_HUMIDITY;
-    case ui::RECT_OUT_WIND:
-      return OUT_WIND;
-    case ui::RECT_FOOTER_IP:
-      return FOOTER_STATUS;  // FOOTER_STATUS is alias for RECT_FOOTER_IP
-    default:
-      return nullptr;
-  }
-}
-#endif
-
 #endif // USE_DISPLAY
\ No newline at end of file
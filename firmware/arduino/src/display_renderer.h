@@ -9,6 +9,7 @@
 #include "display_layout.h"
 #include "display_layout_aliases.h"
 #include "icons.h"
+#include "weather_classify.h"
 
 #if USE_DISPLAY
 
@@ -34,6 +35,14 @@ typedef void (*DrawFnFwd)();
 
 // Core rendering functions
 void full_refresh();
+
+// True when this wake's render model matches the frame on the panel and no
+// full refresh is due, so the display phase can leave the panel asleep
+bool display_frame_unchanged();
+
+// Block until a refresh started in the background has finished on the
+// panel; returns false if it was still running after timeout_ms
+bool display_wait_idle(uint32_t timeout_ms);
 void smoke_full_window_test();
 
 #if USE_UI_SPEC
@@ -47,10 +56,12 @@ void draw_header_time(const char* time_str);
 void draw_status_line(const BatteryStatus& bs, const char* ip_cstr);
 void draw_weather_icon_region_at(int16_t x, int16_t y, int16_t w, int16_t h,
                                  const char* condition);
+void draw_weather_icon_id_at(int16_t x, int16_t y, int16_t w, int16_t h, IconId iconId);
 void draw_weather_icon_region_at_from_outside(int16_t x, int16_t y, int16_t w, int16_t h,
                                               const OutsideReadings& outh);
 
 // Weather icon determination
+IconId weather_kind_icon(WeatherKind kind);
 IconId map_weather_to_icon(const char* w);
 IconId map_openweather_to_icon(const OutsideReadings& o);
 
@@ -1,4 +1,5 @@
 #include "display_smart_refresh.h"
+#include <Arduino.h>
 #include <cstring>
 
 SmartRefresh& SmartRefresh::getInstance() {
@@ -7,52 +8,43 @@ SmartRefresh& SmartRefresh::getInstance() {
 }
 
 void SmartRefresh::registerRegion(uint8_t region_id) {
-    if (findRegion(region_id)) return;  // Already registered
-    if (region_count_ >= MAX_REGIONS) return;
+    if (region_id >= MAX_REGIONS || isRegistered(region_id)) return;
 
-    regions_[region_count_].region_id = region_id;
-    regions_[region_count_].content_hash = 0;
-    regions_[region_count_].last_update_ms = 0;
-    regions_[region_count_].dirty = true;  // Initial state is dirty
-    region_count_++;
+    regions_[region_id] = {};
+    registered_mask_ |= bit(region_id);
+    dirty_mask_ |= bit(region_id);  // Initial state is dirty
 }
 
-SmartRefresh::RegionState* SmartRefresh::findRegion(uint8_t region_id) {
-    for (size_t i = 0; i < region_count_; i++) {
-        if (regions_[i].region_id == region_id) {
-            return &regions_[i];
-        }
-    }
-    return nullptr;
+uint32_t SmartRefresh::hashString(const char* s, uint32_t seed) {
+    return hashBytes(s, s ? strlen(s) : 0, seed);
 }
 
-uint32_t SmartRefresh::computeHash(const char* data, size_t len) {
-    // FNV-1a hash
-    uint32_t hash = 2166136261u;
-    for (size_t i = 0; i < len; i++) {
-        hash ^= (uint8_t)data[i];
-        hash *= 16777619u;
-    }
-    return hash;
+bool SmartRefresh::hasContentChanged(uint8_t region_id, const char* content) {
+    return hasHashChanged(region_id, hashString(content));
 }
 
-bool SmartRefresh::hasContentChanged(uint8_t region_id, const char* content) {
+bool SmartRefresh::hasContentChanged(uint8_t region_id, int32_t value) {
+    return hasHashChanged(region_id, hashInt(value));
+}
+
+bool SmartRefresh::hasContentChanged(uint8_t region_id, float value, int decimals) {
+    return hasHashChanged(region_id, hashFixed(value, decimals));
+}
+
+bool SmartRefresh::hasHashChanged(uint8_t region_id, uint32_t new_hash) {
     stats_.total_checks++;
 
-    RegionState* region = findRegion(region_id);
-    if (!region) {
+    if (!isRegistered(region_id)) {
         // Unknown region, assume changed
         stats_.actual_updates++;
         return true;
     }
 
-    size_t len = content ? strlen(content) : 0;
-    uint32_t new_hash = computeHash(content, len);
-
-    if (new_hash != region->content_hash || region->dirty) {
-        region->content_hash = new_hash;
-        region->last_update_ms = millis();
-        region->dirty = true;
+    RegionState& region = regions_[region_id];
+    if (new_hash != region.content_hash || (dirty_mask_ & bit(region_id))) {
+        region.content_hash = new_hash;
+        region.last_update_ms = millis();
+        dirty_mask_ |= bit(region_id);
         stats_.actual_updates++;
         return true;
     }
@@ -61,53 +53,42 @@ bool SmartRefresh::hasContentChanged(uint8_t region_id, const char* content) {
     return false;
 }
 
-bool SmartRefresh::hasContentChanged(uint8_t region_id, int32_t value) {
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%ld", (long)value);
-    return hasContentChanged(region_id, buf);
+uint32_t SmartRefresh::getHash(uint8_t region_id) {
+    return isRegistered(region_id) ? regions_[region_id].content_hash : 0;
 }
 
-bool SmartRefresh::hasContentChanged(uint8_t region_id, float value, int decimals) {
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
-    return hasContentChanged(region_id, buf);
+void SmartRefresh::restoreHash(uint8_t region_id, uint32_t hash) {
+    if (!isRegistered(region_id)) return;
+    regions_[region_id].content_hash = hash;
+    dirty_mask_ &= ~bit(region_id);
 }
 
-void SmartRefresh::markDirty(uint8_t region_id) {
-    RegionState* region = findRegion(region_id);
-    if (region) {
-        region->dirty = true;
+void SmartRefresh::snapshot(Snapshot& out) const {
+    out.valid_mask = registered_mask_ & ~dirty_mask_;
+    for (size_t i = 0; i < MAX_REGIONS; i++) {
+        out.hash[i] = (out.valid_mask & (1u << i)) ? regions_[i].content_hash : 0;
     }
 }
 
-void SmartRefresh::markAllDirty() {
-    for (size_t i = 0; i < region_count_; i++) {
-        regions_[i].dirty = true;
+void SmartRefresh::restore(const Snapshot& in) {
+    uint32_t load = in.valid_mask & registered_mask_;
+    for (size_t i = 0; i < MAX_REGIONS; i++) {
+        if (load & (1u << i)) regions_[i].content_hash = in.hash[i];
     }
+    // Regions the snapshot does not vouch for must be drawn once
+    dirty_mask_ = registered_mask_ & ~load;
 }
 
-void SmartRefresh::markClean(uint8_t region_id) {
-    RegionState* region = findRegion(region_id);
-    if (region) {
-        region->dirty = false;
-    }
+void SmartRefresh::markDirty(uint8_t region_id) {
+    if (isRegistered(region_id)) dirty_mask_ |= bit(region_id);
 }
 
-bool SmartRefresh::hasAnyDirty() const {
-    for (size_t i = 0; i < region_count_; i++) {
-        if (regions_[i].dirty) return true;
-    }
-    return false;
+void SmartRefresh::markAllDirty() {
+    dirty_mask_ = registered_mask_;
 }
 
-uint16_t SmartRefresh::getDirtyMask() const {
-    uint16_t mask = 0;
-    for (size_t i = 0; i < region_count_; i++) {
-        if (regions_[i].dirty) {
-            mask |= (1 << regions_[i].region_id);
-        }
-    }
-    return mask;
+void SmartRefresh::markClean(uint8_t region_id) {
+    if (isRegistered(region_id)) dirty_mask_ &= ~bit(region_id);
 }
 
 void SmartRefresh::resetStats() {
@@ -1,10 +1,19 @@
 #pragma once
 
-#include <Arduino.h>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 
 // Region content change tracking for smart partial refresh
-// Only refreshes regions that have actually changed
+// Only refreshes regions that have actually changed. Regions are indexed
+// directly by id (ui::RectId for the spec renderer), so every check is one
+// table lookup and the dirty set is a bitmask. Numbers are hashed from
+// their quantized integer form, with the same rounding the display's
+// "%.*f" text uses, so no formatting is needed to compare them.
+//
+// The table survives deep sleep as a Snapshot in the RTC state block:
+// restore() at wake, snapshot() after the frame is on the panel. The dirty
+// mask then names exactly the regions that changed since the last frame.
 //
 // Usage:
 //   SmartRefresh::getInstance().registerRegion(REGION_INSIDE_TEMP);
@@ -17,18 +26,24 @@
 
 class SmartRefresh {
 public:
-    static constexpr size_t MAX_REGIONS = 16;
+    static constexpr size_t MAX_REGIONS = 32;           // Region ids 0..31 (one mask bit each)
+    static constexpr uint32_t HASH_SEED = 2166136261u;  // FNV-1a offset basis
+    static constexpr int MAX_DECIMALS = 6;
 
     struct RegionState {
-        uint8_t region_id;
         uint32_t content_hash;
         uint32_t last_update_ms;
-        bool dirty;
+    };
+
+    // What the panel shows, carried across deep sleep (rtc_state.h)
+    struct Snapshot {
+        uint32_t valid_mask;              // Regions whose hash matches the panel
+        uint32_t hash[MAX_REGIONS];
     };
 
     static SmartRefresh& getInstance();
 
-    // Initialize tracking for a region
+    // Initialize tracking for a region (ids >= MAX_REGIONS are ignored)
     void registerRegion(uint8_t region_id);
 
     // Check if content has changed (computes hash)
@@ -36,6 +51,60 @@ public:
     bool hasContentChanged(uint8_t region_id, const char* content);
     bool hasContentChanged(uint8_t region_id, int32_t value);
     bool hasContentChanged(uint8_t region_id, float value, int decimals = 1);
+    // Same, with a hash the caller accumulated (e.g. over several draw ops)
+    bool hasHashChanged(uint8_t region_id, uint32_t hash);
+
+    // Last known hash, and restoring it clean (state carried across deep sleep)
+    uint32_t getHash(uint8_t region_id);
+    void restoreHash(uint8_t region_id, uint32_t hash);
+
+    // Whole-table save and load: snapshot() records the clean registered
+    // regions; restore() loads those back clean and leaves the rest dirty
+    void snapshot(Snapshot& out) const;
+    void restore(const Snapshot& in);
+
+    // FNV-1a, chainable by passing the previous result as seed
+    static uint32_t hashBytes(const void* data, size_t len, uint32_t seed = HASH_SEED) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        uint32_t hash = seed;
+        for (size_t i = 0; i < len; i++) {
+            hash ^= p[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+    static uint32_t hashString(const char* s, uint32_t seed = HASH_SEED);
+
+    static uint32_t hashInt(int32_t value, uint32_t seed = HASH_SEED) {
+        return hashBytes(&value, sizeof(value), seed);
+    }
+
+    // value as "%.*f" would print it: equal exactly when the text is equal
+    // (round half to even, "-0.0" apart from "0.0", any NaN alike)
+    static uint32_t hashFixed(float value, int decimals, uint32_t seed = HASH_SEED) {
+        static const double kScale[MAX_DECIMALS + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+        if (decimals < 0) decimals = 0;
+        if (decimals > MAX_DECIMALS) decimals = MAX_DECIMALS;
+        struct {
+            int64_t q;
+            int8_t decimals;
+            uint8_t kind;           // 0 finite, 1 -0, 2 +inf, 3 -inf, 4 NaN
+            uint8_t pad[6];
+        } key = {};
+        key.decimals = (int8_t)decimals;
+        if (std::isnan(value)) {
+            key.kind = 4;
+        } else if (std::isinf(value)) {
+            key.kind = value > 0 ? 2 : 3;
+        } else {
+            double scaled = (double)value * kScale[decimals];
+            if (scaled > 9.2e18) scaled = 9.2e18;
+            if (scaled < -9.2e18) scaled = -9.2e18;
+            key.q = std::llrint(scaled);   // Default rounding mode, as printf
+            if (key.q == 0 && std::signbit(value)) key.kind = 1;
+        }
+        return hashBytes(&key, sizeof(key), seed);
+    }
 
     // Mark region as dirty (force redraw)
     void markDirty(uint8_t region_id);
@@ -45,10 +114,10 @@ public:
     void markClean(uint8_t region_id);
 
     // Check if any region needs update
-    bool hasAnyDirty() const;
+    bool hasAnyDirty() const { return dirty_mask_ != 0; }
 
     // Get dirty regions as bitmask
-    uint16_t getDirtyMask() const;
+    uint32_t getDirtyMask() const { return dirty_mask_; }
 
     // Stats
     struct Stats {
@@ -69,11 +138,13 @@ private:
     SmartRefresh(const SmartRefresh&) = delete;
     SmartRefresh& operator=(const SmartRefresh&) = delete;
 
-    RegionState regions_[MAX_REGIONS];
-    size_t region_count_ = 0;
-    Stats stats_ = {};
+    static uint32_t bit(uint8_t region_id) { return 1u << region_id; }
+    bool isRegistered(uint8_t region_id) const {
+        return region_id < MAX_REGIONS && (registered_mask_ & bit(region_id));
+    }
 
-    // Simple hash function
-    uint32_t computeHash(const char* data, size_t len);
-    RegionState* findRegion(uint8_t region_id);
+    RegionState regions_[MAX_REGIONS] = {};
+    uint32_t registered_mask_ = 0;
+    uint32_t dirty_mask_ = 0;         // Always a subset of registered_mask_
+    Stats stats_ = {};
 };
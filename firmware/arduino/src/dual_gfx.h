@@ -4,6 +4,16 @@
 #if USE_DISPLAY
 
 #include <Adafruit_GFX.h>
+#include "canvas_raster.h"
+#include "glyph_cache.h"
+
+// Same values as GxEPD2.h, for code (and host builds) without the panel driver
+#ifndef GxEPD_BLACK
+#define GxEPD_BLACK 0x0000
+#endif
+#ifndef GxEPD_WHITE
+#define GxEPD_WHITE 0xFFFF
+#endif
 
 // DualGFX: Wrapper that forwards drawing operations to two GFX targets
 // Used for screenshot capture - draws to both display and shadow canvas
@@ -18,52 +28,109 @@
 //   get_dual_gfx_context()->drawRect(...);  // In helper functions
 //   set_dual_gfx_context(nullptr);  // After drawing
 //
+// Canvas-only rendering (one pass, blitted to the panel afterwards):
+//   DualGFX solo(canvas, nullptr, true);  // Map GxEPD colors on the primary too
+//
+// Canvas targets (the secondary, and a mapped primary) take a fast path for
+// pixels, axis-aligned lines, rects, fills and XBM icons: the 1-bit buffer
+// is written directly with byte masks and memset (canvas_raster.h) rather
+// than through one virtual drawPixel per pixel. Text goes through
+// Adafruit_GFX, except that cached glyphs (glyph_cache.h) are blitted when
+// the built-in font is drawn with a transparent background.
+//
 // Note: This wraps common operations used by the UI spec drawing code.
 // Not all Adafruit_GFX methods are wrapped - add more as needed.
 
 class DualGFX {
 public:
-    DualGFX(Adafruit_GFX* primary, Adafruit_GFX* secondary = nullptr)
-        : primary_(primary), secondary_(secondary) {}
+    // map_primary: primary is a GFXcanvas1 (canvas-only rendering)
+    DualGFX(Adafruit_GFX* primary, GFXcanvas1* secondary = nullptr,
+            bool map_primary = false)
+        : primary_(primary), secondary_(nullptr), map_primary_(map_primary) {
+        primary_fast_ = map_primary &&
+                        rasterTarget(static_cast<GFXcanvas1*>(primary), &primary_rt_);
+        setSecondary(secondary);
+    }
 
-    void setSecondary(Adafruit_GFX* secondary) { secondary_ = secondary; }
+    void setSecondary(GFXcanvas1* secondary) {
+        secondary_ = secondary;
+        secondary_fast_ = rasterTarget(secondary, &secondary_rt_);
+    }
     Adafruit_GFX* getPrimary() { return primary_; }
-    Adafruit_GFX* getSecondary() { return secondary_; }
+    GFXcanvas1* getSecondary() { return secondary_; }
 
     // --- Drawing primitives ---
     
     void drawPixel(int16_t x, int16_t y, uint16_t color) {
-        primary_->drawPixel(x, y, color);
-        if (secondary_) secondary_->drawPixel(x, y, mapColor(color));
+        if (primary_fast_) raster_pixel(primary_rt_, x, y, mapColor(color));
+        else primary_->drawPixel(x, y, primaryColor(color));
+        if (secondary_fast_) raster_pixel(secondary_rt_, x, y, mapColor(color));
+        else if (secondary_) secondary_->drawPixel(x, y, mapColor(color));
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+        if (primary_fast_) raster_hspan(primary_rt_, x, y, w, mapColor(color));
+        else primary_->drawFastHLine(x, y, w, primaryColor(color));
+        if (secondary_fast_) raster_hspan(secondary_rt_, x, y, w, mapColor(color));
+        else if (secondary_) secondary_->drawFastHLine(x, y, w, mapColor(color));
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+        if (primary_fast_) raster_vspan(primary_rt_, x, y, h, mapColor(color));
+        else primary_->drawFastVLine(x, y, h, primaryColor(color));
+        if (secondary_fast_) raster_vspan(secondary_rt_, x, y, h, mapColor(color));
+        else if (secondary_) secondary_->drawFastVLine(x, y, h, mapColor(color));
     }
 
     void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
-        primary_->drawLine(x0, y0, x1, y1, color);
+        if (y0 == y1) {
+            if (x0 > x1) { int16_t t = x0; x0 = x1; x1 = t; }
+            drawFastHLine(x0, y0, static_cast<int16_t>(x1 - x0 + 1), color);
+            return;
+        }
+        if (x0 == x1) {
+            if (y0 > y1) { int16_t t = y0; y0 = y1; y1 = t; }
+            drawFastVLine(x0, y0, static_cast<int16_t>(y1 - y0 + 1), color);
+            return;
+        }
+        primary_->drawLine(x0, y0, x1, y1, primaryColor(color));
         if (secondary_) secondary_->drawLine(x0, y0, x1, y1, mapColor(color));
     }
 
     void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-        primary_->drawRect(x, y, w, h, color);
-        if (secondary_) secondary_->drawRect(x, y, w, h, mapColor(color));
+        if (!primary_fast_ && !secondary_fast_) {
+            primary_->drawRect(x, y, w, h, primaryColor(color));
+            if (secondary_) secondary_->drawRect(x, y, w, h, mapColor(color));
+            return;
+        }
+        // Same four edges as Adafruit_GFX::drawRect
+        drawFastHLine(x, y, w, color);
+        drawFastHLine(x, static_cast<int16_t>(y + h - 1), w, color);
+        drawFastVLine(x, y, h, color);
+        drawFastVLine(static_cast<int16_t>(x + w - 1), y, h, color);
     }
 
     void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-        primary_->fillRect(x, y, w, h, color);
-        if (secondary_) secondary_->fillRect(x, y, w, h, mapColor(color));
+        if (primary_fast_) raster_fill_rect(primary_rt_, x, y, w, h, mapColor(color));
+        else primary_->fillRect(x, y, w, h, primaryColor(color));
+        if (secondary_fast_) raster_fill_rect(secondary_rt_, x, y, w, h, mapColor(color));
+        else if (secondary_) secondary_->fillRect(x, y, w, h, mapColor(color));
     }
 
     void fillScreen(uint16_t color) {
-        primary_->fillScreen(color);
-        if (secondary_) secondary_->fillScreen(mapColor(color));
+        if (primary_fast_) raster_fill(primary_rt_, mapColor(color));
+        else primary_->fillScreen(primaryColor(color));
+        if (secondary_fast_) raster_fill(secondary_rt_, mapColor(color));
+        else if (secondary_) secondary_->fillScreen(mapColor(color));
     }
 
     void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {
-        primary_->drawCircle(x, y, r, color);
+        primary_->drawCircle(x, y, r, primaryColor(color));
         if (secondary_) secondary_->drawCircle(x, y, r, mapColor(color));
     }
 
     void fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {
-        primary_->fillCircle(x, y, r, color);
+        primary_->fillCircle(x, y, r, primaryColor(color));
         if (secondary_) secondary_->fillCircle(x, y, r, mapColor(color));
     }
 
@@ -71,16 +138,27 @@ public:
     
     void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, 
                     int16_t w, int16_t h, uint16_t color) {
-        primary_->drawBitmap(x, y, bitmap, w, h, color);
-        if (secondary_) secondary_->drawBitmap(x, y, bitmap, w, h, mapColor(color));
+        if (primary_fast_) raster_bitmap(primary_rt_, x, y, bitmap, w, h, mapColor(color));
+        else primary_->drawBitmap(x, y, bitmap, w, h, primaryColor(color));
+        if (secondary_fast_) raster_bitmap(secondary_rt_, x, y, bitmap, w, h, mapColor(color));
+        else if (secondary_) secondary_->drawBitmap(x, y, bitmap, w, h, mapColor(color));
     }
 
     void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap,
                     int16_t w, int16_t h, uint16_t color, uint16_t bg) {
-        primary_->drawBitmap(x, y, bitmap, w, h, color, bg);
+        primary_->drawBitmap(x, y, bitmap, w, h, primaryColor(color), primaryColor(bg));
         if (secondary_) secondary_->drawBitmap(x, y, bitmap, w, h, mapColor(color), mapColor(bg));
     }
 
+    // bitmap is in PROGMEM, which is plain addressable flash on ESP32
+    void drawXBitmap(int16_t x, int16_t y, const uint8_t* bitmap,
+                     int16_t w, int16_t h, uint16_t color) {
+        if (primary_fast_) raster_xbm(primary_rt_, x, y, bitmap, w, h, mapColor(color));
+        else primary_->drawXBitmap(x, y, bitmap, w, h, primaryColor(color));
+        if (secondary_fast_) raster_xbm(secondary_rt_, x, y, bitmap, w, h, mapColor(color));
+        else if (secondary_) secondary_->drawXBitmap(x, y, bitmap, w, h, mapColor(color));
+    }
+
     // --- Text operations ---
     
     void setCursor(int16_t x, int16_t y) {
@@ -89,33 +167,44 @@ public:
     }
 
     void setTextColor(uint16_t color) {
-        primary_->setTextColor(color);
+        primary_->setTextColor(primaryColor(color));
         if (secondary_) secondary_->setTextColor(mapColor(color));
+        text_color_ = color;
+        text_color_set_ = true;
+        text_transparent_ = true;
     }
 
     void setTextColor(uint16_t color, uint16_t bg) {
-        primary_->setTextColor(color, bg);
+        primary_->setTextColor(primaryColor(color), primaryColor(bg));
         if (secondary_) secondary_->setTextColor(mapColor(color), mapColor(bg));
+        text_color_ = color;
+        text_color_set_ = true;
+        text_transparent_ = color == bg;
     }
 
     void setTextSize(uint8_t size) {
         primary_->setTextSize(size);
         if (secondary_) secondary_->setTextSize(size);
+        text_size_ = size;
     }
 
     void setTextWrap(bool wrap) {
         primary_->setTextWrap(wrap);
         if (secondary_) secondary_->setTextWrap(wrap);
+        text_wrap_ = wrap;
     }
 
     void setFont(const GFXfont* font = nullptr) {
         primary_->setFont(font);
         if (secondary_) secondary_->setFont(font);
+        custom_font_ = font != nullptr;
     }
 
     size_t print(const char* str) {
-        size_t n = primary_->print(str);
-        if (secondary_) secondary_->print(str);
+        size_t n = primary_fast_ ? printCached(static_cast<GFXcanvas1*>(primary_), primary_rt_, str)
+                                 : primary_->print(str);
+        if (secondary_fast_) printCached(secondary_, secondary_rt_, str);
+        else if (secondary_) secondary_->print(str);
         return n;
     }
 
@@ -124,9 +213,8 @@ public:
     }
 
     size_t print(char c) {
-        size_t n = primary_->print(c);
-        if (secondary_) secondary_->print(c);
-        return n;
+        char str[2] = {c, '\0'};
+        return print(str);
     }
 
     size_t print(int val, int base = DEC) {
@@ -155,7 +243,54 @@ public:
 
 private:
     Adafruit_GFX* primary_;
-    Adafruit_GFX* secondary_;
+    GFXcanvas1* secondary_;
+    bool map_primary_;  // Primary is a GFXcanvas1 rather than the panel
+    bool primary_fast_ = false;
+    bool secondary_fast_ = false;
+    RasterTarget primary_rt_ = {};
+    RasterTarget secondary_rt_ = {};
+
+    // Text state as set through this wrapper; glyphs are only blitted once
+    // size and color are known to match what the canvas would draw
+    uint8_t text_size_ = 0;
+    uint16_t text_color_ = 0;
+    bool text_color_set_ = false;
+    bool text_transparent_ = true;
+    bool text_wrap_ = true;
+    bool custom_font_ = false;
+
+    // Print to a canvas target, blitting cached glyphs and handing every
+    // other character (and any that would wrap) to Adafruit_GFX
+    size_t printCached(GFXcanvas1* canvas, const RasterTarget& rt, const char* str) {
+        if (!str) return 0;
+        if (custom_font_ || !text_transparent_ || !text_color_set_ ||
+            text_size_ < 1 || text_size_ > GLYPH_CACHE_MAX_SIZE) {
+            return canvas->print(str);
+        }
+        bool set = mapColor(text_color_) != 0;
+        int16_t advance = static_cast<int16_t>(GLYPH_ADVANCE * text_size_);
+        size_t n = 0;
+        for (const char* p = str; *p; ++p, ++n) {
+            int16_t cx = canvas->getCursorX();
+            int16_t cy = canvas->getCursorY();
+            const GlyphBitmap* g = glyph_cache_get(*p, text_size_);
+            if (!g || (text_wrap_ && cx + advance > rt.width)) {
+                canvas->write(static_cast<uint8_t>(*p));
+                continue;
+            }
+            raster_bitmap(rt, cx, cy, g->bits, g->w, g->h, set);
+            canvas->setCursor(static_cast<int16_t>(cx + advance), cy);
+        }
+        return n;
+    }
+
+    // Direct buffer access is only valid for an unrotated canvas
+    static bool rasterTarget(GFXcanvas1* canvas, RasterTarget* out) {
+        if (!canvas || !canvas->getBuffer() || canvas->getRotation() != 0) return false;
+        *out = RasterTarget{canvas->getBuffer(), canvas->width(), canvas->height(),
+                            static_cast<uint16_t>((canvas->width() + 7) / 8)};
+        return true;
+    }
 
     // Map GxEPD2 colors to GFXcanvas1 colors
     // For GFXcanvas1: 0 = background (white), 1 = foreground (black)
@@ -163,6 +298,10 @@ private:
     static uint16_t mapColor(uint16_t color) {
         return (color == 0x0000) ? 1 : 0;
     }
+
+    uint16_t primaryColor(uint16_t color) const {
+        return map_primary_ ? mapColor(color) : color;
+    }
 };
 
 // Global drawing context for screenshot capture
@@ -0,0 +1,111 @@
+#include "energy_meter.h"
+#include "config.h"
+#include <PubSubClient.h>
+
+// RTC memory - persists across deep sleep
+RTC_DATA_ATTR EnergyMeter::State EnergyMeter::state_ = {};
+
+static const char* const kPhaseKeys[ENERGY_PHASE_COUNT] = {"cpu", "rx", "tx", "panel", "sleep"};
+
+EnergyMeter& EnergyMeter::getInstance() {
+    static EnergyMeter instance;
+    return instance;
+}
+
+EnergyCurrents EnergyMeter::currents() {
+    EnergyCurrents c;
+    c.ma[ENERGY_CPU] = ENERGY_MA_CPU;
+    c.ma[ENERGY_RADIO_RX] = ENERGY_MA_RADIO_RX;
+    c.ma[ENERGY_RADIO_TX] = ENERGY_MA_RADIO_TX;
+    c.ma[ENERGY_PANEL] = ENERGY_MA_PANEL;
+    c.ma[ENERGY_SLEEP] = ENERGY_MA_SLEEP;
+    c.tx_share = ENERGY_RADIO_TX_SHARE;
+    return c;
+}
+
+void EnergyMeter::railOn(EnergyPhase rail) {
+    if (rail >= ENERGY_PHASE_COUNT || committed_ || on_since_us_[rail] != 0) return;
+    uint64_t now = (uint64_t)esp_timer_get_time();
+    on_since_us_[rail] = now ? now : 1;
+}
+
+void EnergyMeter::railOff(EnergyPhase rail) {
+    if (rail >= ENERGY_PHASE_COUNT || on_since_us_[rail] == 0) return;
+    on_total_us_[rail] += (uint64_t)esp_timer_get_time() - on_since_us_[rail];
+    on_since_us_[rail] = 0;
+}
+
+void EnergyMeter::commit(uint32_t sleep_sec, int battery_percent) {
+    if (committed_) return;
+
+    // Deep sleep powers everything down, so close any rail still on
+    for (size_t p = 0; p < ENERGY_PHASE_COUNT; p++) railOff((EnergyPhase)p);
+
+    uint64_t awake_us = (uint64_t)esp_timer_get_time();
+    EnergyCurrents c = currents();
+    EnergyPhaseUs t = {};
+    t.us[ENERGY_CPU] = awake_us;
+    energy_split_radio(t, on_total_us_[ENERGY_RADIO_RX] + on_total_us_[ENERGY_RADIO_TX], c.tx_share);
+    t.us[ENERGY_PANEL] = on_total_us_[ENERGY_PANEL];
+    t.us[ENERGY_SLEEP] = (uint64_t)sleep_sec * 1000000ULL;
+    EnergyWakeCharge w = energy_wake_charge(t, c);
+
+    if (state_.history.magic != ENERGY_HISTORY_MAGIC) {
+        memset(&state_, 0, sizeof(state_));
+    }
+    energy_history_validate(state_.history);
+    uint32_t period_sec = sleep_sec + (uint32_t)(awake_us / 1000000ULL);
+    energy_history_add(state_.history, w.total_uah, period_sec);
+    energy_gauge_update(state_.history, battery_percent, period_sec, BATTERY_CAPACITY_MAH);
+
+    Record& r = state_.last;
+    r.wake_index = state_.next_wake_index++;
+    r.awake_ms = (uint32_t)(awake_us / 1000ULL);
+    r.sleep_sec = sleep_sec;
+    memcpy(r.uah, w.uah, sizeof(r.uah));
+    r.total_uah = w.total_uah;
+    state_.pending = true;
+
+    committed_ = true;
+}
+
+float EnergyMeter::averageMa() const {
+    return energy_history_avg_ma(state_.history);
+}
+
+bool EnergyMeter::publishPending(PubSubClient* client, const char* client_id) {
+    if (!state_.pending || state_.history.magic != ENERGY_HISTORY_MAGIC) return true;
+    if (!client || !client->connected() || !client_id || !client_id[0]) return false;
+
+    char topic[96];
+    snprintf(topic, sizeof(topic), "espsensor/%s%s", client_id, TOPIC_SUFFIX);
+
+    char payload[320];
+    formatJson(payload, sizeof(payload));
+    if (!client->publish(topic, payload, false)) return false;
+
+    state_.pending = false;
+    return true;
+}
+
+void EnergyMeter::formatJson(char* out, size_t out_size) const {
+    if (!out || out_size == 0) return;
+    if (state_.history.magic != ENERGY_HISTORY_MAGIC) {
+        snprintf(out, out_size, "{\"wake\":null}");
+        return;
+    }
+
+    const Record& r = state_.last;
+    int n = snprintf(out, out_size, "{\"wake\":%lu,\"awake_ms\":%lu,\"sleep_s\":%lu,\"uah\":{",
+                     (unsigned long)r.wake_index, (unsigned long)r.awake_ms, (unsigned long)r.sleep_sec);
+    size_t pos = (n > 0) ? (size_t)n : 0;
+    for (size_t p = 0; p < ENERGY_PHASE_COUNT && pos < out_size; p++) {
+        n = snprintf(out + pos, out_size - pos, "%s\"%s\":%.1f", p ? "," : "", kPhaseKeys[p], r.uah[p]);
+        if (n > 0) pos += (size_t)n;
+    }
+    if (pos < out_size) {
+        snprintf(out + pos, out_size - pos,
+                 "},\"total_uah\":%.1f,\"avg_ma\":%.3f,\"model_ma\":%.3f,\"gauge_ma\":%.3f}",
+                 r.total_uah, averageMa(), energy_model_avg_ma(state_.history), state_.history.gauge_ma);
+    }
+}
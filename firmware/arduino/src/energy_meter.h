@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "feature_flags.h"
+#include "energy_model.h"
+
+// Energy-per-phase instrumentation
+// Times when the radio and the panel are on (esp_timer), turns those
+// durations plus the awake and scheduled sleep time into uAh with the
+// calibrated ENERGY_MA_* table (config.h), and keeps a decaying average in
+// RTC memory. estimate_battery_days() uses that average; the fuel gauge
+// replaces it once its percent readings have resolved a long discharge.
+//
+// Usage:
+//   EnergyMeter::getInstance().railOn(ENERGY_RADIO_RX);   // WiFi started
+//   EnergyMeter::getInstance().railOff(ENERGY_RADIO_RX);
+//   ...
+//   EnergyMeter::getInstance().publishPending(client, client_id);
+//   EnergyMeter::getInstance().commit(sleep_sec, battery_percent);  // Before deep sleep
+//
+// Payload (espsensor/<id>/debug/energy), for the previous wake:
+//   {"wake":123,"awake_ms":2950,"sleep_s":300,"uah":{"cpu":24.6,"rx":20.1,
+//    "tx":12.6,"panel":1.5,"sleep":8.3},"total_uah":67.1,"avg_ma":0.78,
+//    "model_ma":0.80,"gauge_ma":0}
+
+class PubSubClient;
+
+class EnergyMeter {
+public:
+    static constexpr const char* TOPIC_SUFFIX = "/debug/energy";
+
+    struct Record {
+        uint32_t wake_index;
+        uint32_t awake_ms;
+        uint32_t sleep_sec;
+        float uah[ENERGY_PHASE_COUNT];
+        float total_uah;
+    };
+
+    static EnergyMeter& getInstance();
+
+    // Mark a consumer on/off; radio time is split into RX and TX at commit,
+    // so pass ENERGY_RADIO_RX for the radio
+    void railOn(EnergyPhase rail);
+    void railOff(EnergyPhase rail);
+
+    // Close out this wake: charge it, fold it into the RTC average and keep
+    // the record for the next wake's publish. Call once before deep sleep.
+    void commit(uint32_t sleep_sec, int battery_percent);
+
+    // Publish the previous wake's record if it has not been sent yet
+    bool publishPending(PubSubClient* client, const char* client_id);
+
+    // Best measured average current in mA (0 until a wake has been committed)
+    float averageMa() const;
+
+    void formatJson(char* out, size_t out_size) const;
+
+    static EnergyCurrents currents();
+
+private:
+    EnergyMeter() = default;
+    ~EnergyMeter() = default;
+    EnergyMeter(const EnergyMeter&) = delete;
+    EnergyMeter& operator=(const EnergyMeter&) = delete;
+
+    struct State {
+        EnergyHistory history;
+        Record last;
+        uint32_t next_wake_index;
+        bool pending;            // last not yet published
+    };
+
+    // RTC memory storage (persists across deep sleep)
+    RTC_DATA_ATTR static State state_;
+
+    uint64_t on_since_us_[ENERGY_PHASE_COUNT] = {};   // 0 = off
+    uint64_t on_total_us_[ENERGY_PHASE_COUNT] = {};
+    bool committed_ = false;
+};
+
+#if FEATURE_ENERGY_METER
+  #define ENERGY_RAIL_ON(r) EnergyMeter::getInstance().railOn(r)
+  #define ENERGY_RAIL_OFF(r) EnergyMeter::getInstance().railOff(r)
+#else
+  #define ENERGY_RAIL_ON(r) ((void)0)
+  #define ENERGY_RAIL_OFF(r) ((void)0)
+#endif
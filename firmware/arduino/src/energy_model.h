@@ -0,0 +1,140 @@
+#pragma once
+
+// Per-wake charge model
+// Converts how long each power consumer was active into microamp-hours using
+// a calibrated current table, and keeps a decaying cross-wake average that
+// battery-life estimates can use instead of an assumed figure. Currents are
+// additive: CPU covers the whole awake time, and radio/panel draw on top of it
+// while they are on.
+//
+// Usage:
+//   EnergyCurrents c = {{30, 40, 150, 4, 0.1f}, 0.1f};   // mA per phase, TX share
+//   EnergyPhaseUs t = {};                         // Fill from esp_timer deltas
+//   EnergyWakeCharge w = energy_wake_charge(t, c);
+//   energy_history_add(history, w.total_uah, period_sec);
+//   float ma = energy_history_avg_ma(history);
+//
+// A long-window fuel-gauge reading (percent drop over hours of deep-sleep
+// cycles) overrides the model once it has resolved a few percent; the gauge
+// is far too coarse to see a single wake.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+enum EnergyPhase : uint8_t {
+    ENERGY_CPU = 0,         // Awake, CPU running
+    ENERGY_RADIO_RX,        // WiFi on, listening (adder over CPU)
+    ENERGY_RADIO_TX,        // WiFi transmitting (adder over CPU)
+    ENERGY_PANEL,           // E-paper waveform, BUSY asserted (adder over CPU)
+    ENERGY_SLEEP,           // Deep sleep until the next wake
+    ENERGY_PHASE_COUNT
+};
+
+struct EnergyCurrents {
+    float ma[ENERGY_PHASE_COUNT];
+    float tx_share;         // Fraction of radio-on time spent transmitting
+};
+
+struct EnergyPhaseUs {
+    uint64_t us[ENERGY_PHASE_COUNT];
+};
+
+struct EnergyWakeCharge {
+    float uah[ENERGY_PHASE_COUNT];
+    float total_uah;
+};
+
+// uAh = mA * us / 3.6e6
+inline float energy_uah(uint64_t us, float ma) {
+    return (float)((double)us * (double)ma / 3600000.0);
+}
+
+// Split radio-on time into RX and TX using the calibrated TX share
+inline void energy_split_radio(EnergyPhaseUs& t, uint64_t radio_on_us, float tx_share) {
+    if (tx_share < 0.0f) tx_share = 0.0f;
+    if (tx_share > 1.0f) tx_share = 1.0f;
+    uint64_t tx = (uint64_t)((double)radio_on_us * tx_share);
+    t.us[ENERGY_RADIO_TX] = tx;
+    t.us[ENERGY_RADIO_RX] = radio_on_us - tx;
+}
+
+inline EnergyWakeCharge energy_wake_charge(const EnergyPhaseUs& t, const EnergyCurrents& c) {
+    EnergyWakeCharge w;
+    w.total_uah = 0.0f;
+    for (size_t p = 0; p < ENERGY_PHASE_COUNT; p++) {
+        w.uah[p] = energy_uah(t.us[p], c.ma[p]);
+        w.total_uah += w.uah[p];
+    }
+    return w;
+}
+
+// Cross-wake accumulator (RTC memory). Sums are halved once they span more
+// than ENERGY_HISTORY_WINDOW_SEC, so the average follows seasonal changes
+// without forgetting everything on one odd wake.
+static constexpr uint32_t ENERGY_HISTORY_MAGIC = 0x45474831;  // "EGH1"
+static constexpr uint32_t ENERGY_HISTORY_WINDOW_SEC = 24u * 3600u;
+static constexpr uint8_t ENERGY_GAUGE_MIN_DROP_PCT = 3;     // Gauge steps needed before trusting it
+static constexpr uint32_t ENERGY_GAUGE_MIN_SEC = 6u * 3600u;
+
+struct EnergyHistory {
+    uint32_t magic;
+    float sum_uah;
+    uint32_t sum_sec;
+    float gauge_ma;             // Fuel-gauge average, 0 = not resolved yet
+    int8_t anchor_pct;          // Battery percent at the start of the gauge window, -1 = none
+    uint32_t anchor_sec;        // Seconds elapsed since the anchor
+};
+
+inline void energy_history_reset(EnergyHistory& h) {
+    memset(&h, 0, sizeof(h));
+    h.magic = ENERGY_HISTORY_MAGIC;
+    h.anchor_pct = -1;
+}
+
+inline void energy_history_validate(EnergyHistory& h) {
+    if (h.magic != ENERGY_HISTORY_MAGIC) energy_history_reset(h);
+}
+
+inline void energy_history_add(EnergyHistory& h, float wake_uah, uint32_t period_sec) {
+    h.sum_uah += wake_uah;
+    h.sum_sec += period_sec;
+    while (h.sum_sec > ENERGY_HISTORY_WINDOW_SEC) {
+        h.sum_uah *= 0.5f;
+        h.sum_sec /= 2;
+    }
+}
+
+// Fold a battery reading in: a long enough discharge since the anchor gives a
+// measured average; charging or a missing gauge restarts the window
+inline void energy_gauge_update(EnergyHistory& h, int percent, uint32_t period_sec, float capacity_mah) {
+    if (percent < 0 || percent > 100 || capacity_mah <= 0.0f) {
+        h.anchor_pct = -1;
+        return;
+    }
+    if (h.anchor_pct < 0 || percent > h.anchor_pct) {
+        h.anchor_pct = (int8_t)percent;
+        h.anchor_sec = 0;
+        return;
+    }
+    h.anchor_sec += period_sec;
+    int drop = h.anchor_pct - percent;
+    if (drop >= ENERGY_GAUGE_MIN_DROP_PCT && h.anchor_sec >= ENERGY_GAUGE_MIN_SEC) {
+        float hours = h.anchor_sec / 3600.0f;
+        h.gauge_ma = (capacity_mah * drop / 100.0f) / hours;
+        h.anchor_pct = (int8_t)percent;
+        h.anchor_sec = 0;
+    }
+}
+
+// Model average over the window in mA; 0 with no data
+inline float energy_model_avg_ma(const EnergyHistory& h) {
+    if (h.magic != ENERGY_HISTORY_MAGIC || h.sum_sec == 0) return 0.0f;
+    return h.sum_uah / 1000.0f / (h.sum_sec / 3600.0f);
+}
+
+// Best available average: the fuel-gauge figure once resolved, else the model
+inline float energy_history_avg_ma(const EnergyHistory& h) {
+    if (h.magic == ENERGY_HISTORY_MAGIC && h.gauge_ma > 0.0f) return h.gauge_ma;
+    return energy_model_avg_ma(h);
+}
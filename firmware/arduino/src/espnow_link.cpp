@@ -0,0 +1,259 @@
+// ESP-NOW transport implementation
+// The sensor side never associates: it starts the STA interface, pins the
+// radio to the cached AP channel (the gateway is on it, being associated)
+// and sends. The gateway side queues frames from the WiFi task's receive
+// callback and publishes them from the main loop.
+
+#include "espnow_link.h"
+#include "config.h"
+
+#if ESPNOW_TRANSPORT && ESPNOW_GATEWAY
+#error "ESPNOW_TRANSPORT and ESPNOW_GATEWAY are separate builds"
+#endif
+// A broadcast is reported sent whether or not anything heard it, so without a
+// gateway address every report would count as delivered and never fall back
+#if ESPNOW_TRANSPORT && !defined(ESPNOW_GATEWAY_MAC)
+#error "ESPNOW_TRANSPORT needs ESPNOW_GATEWAY_MAC (the gateway's STA MAC)"
+#endif
+
+#if ESPNOW_TRANSPORT || ESPNOW_GATEWAY
+#include "espnow_packet.h"
+#include "telemetry_frame.h"
+#include "topic_table.h"
+#include "wifi_manager.h"
+#include <esp_now.h>
+#include <esp_system.h>
+#include <esp_wifi.h>
+#include <WiFi.h>
+
+#if ESPNOW_TRANSPORT
+#include "feature_flags.h"
+#include "ota_update.h"
+
+static constexpr uint32_t ESPNOW_STATE_MAGIC = 0x45534E31;  // "ESN1"
+
+// RTC memory: sequence number and reports since the last MQTT wake
+RTC_DATA_ATTR static uint32_t rtc_espnow_magic = 0;
+RTC_DATA_ATTR static uint16_t rtc_espnow_seq = 0;
+RTC_DATA_ATTR static uint16_t rtc_espnow_reports = 0;
+
+static volatile bool g_send_done = false;
+static volatile bool g_send_ok = false;
+
+static void on_sent(const uint8_t* mac, esp_now_send_status_t status) {
+  (void)mac;
+  g_send_ok = status == ESP_NOW_SEND_SUCCESS;
+  g_send_done = true;
+}
+
+bool espnow_link_wake_applies() {
+  if (ESPNOW_MQTT_EVERY_N_WAKES <= 1) return false;
+  // Unset after a power-up, so the first wake associates and learns the channel
+  if (rtc_espnow_magic != ESPNOW_STATE_MAGIC) return false;
+  if (rtc_espnow_reports + 1 >= ESPNOW_MQTT_EVERY_N_WAKES) return false;
+  if (wifi_cached_channel() == 0) return false;
+  #if FEATURE_OTA_DELTA
+  if (ota_update_in_progress()) return false;
+  #endif
+  return true;
+}
+
+void espnow_link_note_mqtt_wake() {
+  if (rtc_espnow_magic != ESPNOW_STATE_MAGIC) {
+    // Random start: a rebooted sensor is not mistaken for a retry
+    rtc_espnow_seq = (uint16_t)esp_random();
+    rtc_espnow_magic = ESPNOW_STATE_MAGIC;
+  }
+  rtc_espnow_reports = 0;
+}
+
+bool espnow_link_send(const uint8_t* frame, size_t len) {
+  uint8_t channel = wifi_cached_channel();
+  if (channel == 0 || rtc_espnow_magic != ESPNOW_STATE_MAGIC) return false;
+
+  uint8_t pkt[ESPNOW_PACKET_MAX];
+  uint16_t seq = (uint16_t)(rtc_espnow_seq + 1);
+  size_t n = espnow_packet_encode(ESPNOW_KIND_TELEMETRY, seq, frame, len, pkt, sizeof(pkt));
+  if (n == 0) return false;
+
+  // Unicast only: the MAC layer acks it, which is what "delivered" means
+  uint8_t gateway[6];
+  if (!parse_bssid(ESPNOW_GATEWAY_MAC, gateway) || (gateway[0] & 0x01)) {
+    Serial.println("[ESPNOW] Bad ESPNOW_GATEWAY_MAC, taking the WiFi path");
+    return false;
+  }
+
+  uint32_t start = millis();
+  WiFi.mode(WIFI_STA);
+  esp_wifi_set_promiscuous(true);
+  esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+  esp_wifi_set_promiscuous(false);
+
+  bool acked = false;
+  int attempts = 0;
+  if (esp_now_init() == ESP_OK) {
+    esp_now_register_send_cb(on_sent);
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, gateway, 6);
+    peer.channel = channel;
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = false;
+
+    if (esp_now_add_peer(&peer) == ESP_OK) {
+      while (!acked && attempts < ESPNOW_SEND_ATTEMPTS) {
+        attempts++;
+        g_send_done = false;
+        if (esp_now_send(gateway, pkt, n) != ESP_OK) break;
+        uint32_t t = millis();
+        while (!g_send_done && millis() - t < ESPNOW_ACK_TIMEOUT_MS) delay(1);
+        acked = g_send_done && g_send_ok;
+      }
+    }
+    esp_now_deinit();
+  }
+  WiFi.mode(WIFI_OFF);
+
+  Serial.printf("[ESPNOW] Report seq %u on ch %u: %s after %d attempt(s), %lu ms\n",
+                seq, channel, acked ? "delivered" : "no ack", attempts,
+                (unsigned long)(millis() - start));
+  if (acked) {
+    rtc_espnow_seq = seq;
+    rtc_espnow_reports++;
+  }
+  return acked;
+}
+#endif // ESPNOW_TRANSPORT
+
+#if ESPNOW_GATEWAY
+#include <PubSubClient.h>
+
+static constexpr uint8_t ESPNOW_RX_QUEUE = 8;
+
+struct EspNowRx {
+  uint8_t mac[6];
+  uint8_t len;
+  uint8_t data[ESPNOW_PACKET_MAX];
+};
+
+// Filled by the WiFi task, drained by the main loop
+static EspNowRx g_rx[ESPNOW_RX_QUEUE];
+static uint8_t g_rx_head = 0;
+static uint8_t g_rx_tail = 0;
+static uint32_t g_rx_dropped = 0;
+static portMUX_TYPE g_rx_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static EspNowSeqTable<ESPNOW_GATEWAY_MAX_SENDERS> g_seen;
+static bool g_gateway_started = false;
+
+static void on_recv(const uint8_t* mac, const uint8_t* data, int len) {
+  if (!mac || !data || len <= 0 || len > (int)ESPNOW_PACKET_MAX) return;
+  portENTER_CRITICAL(&g_rx_mux);
+  uint8_t next = (uint8_t)((g_rx_head + 1) % ESPNOW_RX_QUEUE);
+  if (next == g_rx_tail) {
+    g_rx_dropped++;
+  } else {
+    EspNowRx& rx = g_rx[g_rx_head];
+    memcpy(rx.mac, mac, 6);
+    rx.len = (uint8_t)len;
+    memcpy(rx.data, data, len);
+    g_rx_head = next;
+  }
+  portEXIT_CRITICAL(&g_rx_mux);
+}
+
+static bool rx_pop(EspNowRx* out) {
+  bool have = false;
+  portENTER_CRITICAL(&g_rx_mux);
+  if (g_rx_tail != g_rx_head) {
+    *out = g_rx[g_rx_tail];
+    g_rx_tail = (uint8_t)((g_rx_tail + 1) % ESPNOW_RX_QUEUE);
+    have = true;
+  }
+  portEXIT_CRITICAL(&g_rx_mux);
+  return have;
+}
+
+bool espnow_gateway_begin() {
+  if (g_gateway_started) return true;
+  if (!wifi_is_connected()) return false;
+  // Modem sleep turns the receiver off between beacons and misses reports
+  wifi_configure_power_save(false);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("[ESPNOW] Gateway init failed");
+    return false;
+  }
+  esp_now_register_recv_cb(on_recv);
+  g_seen.clear();
+  g_gateway_started = true;
+  Serial.printf("[ESPNOW] Gateway listening on channel %d\n", WiFi.channel());
+  return true;
+}
+
+// Publish under espsensor/<sender>/ with the sensor's own topic suffixes
+static void publish_as(PubSubClient* client, const char* prefix, TopicId id,
+                       const uint8_t* payload, size_t len, bool retain) {
+  char topic[96];
+  snprintf(topic, sizeof(topic), "%s%s", prefix, topic_suffix(id));
+  if (!client->publish(topic, payload, len, retain)) {
+    Serial.printf("[ESPNOW] Publish failed: %s\n", topic);
+  }
+}
+
+static void publish_as(PubSubClient* client, const char* prefix, TopicId id, const char* payload) {
+  publish_as(client, prefix, id, (const uint8_t*)payload, strlen(payload), true);
+}
+
+static void publish_report(PubSubClient* client, const uint8_t mac[6], const EspNowPacket& p) {
+  TelemetryValues v;
+  if (p.kind != ESPNOW_KIND_TELEMETRY || !telemetry_decode(p.payload, p.payload_len, &v)) {
+    Serial.printf("[ESPNOW] Unknown report (kind %u, %u bytes)\n", p.kind, (unsigned)p.payload_len);
+    return;
+  }
+
+  // Client ids are the STA MAC in hex, which is the ESP-NOW source address
+  char prefix[32];
+  snprintf(prefix, sizeof(prefix), "espsensor/%02x%02x%02x%02x%02x%02x/",
+           mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+  char payload[32];
+  if (isfinite(v.tempC)) {
+    snprintf(payload, sizeof(payload), "%.1f", v.tempC);
+    publish_as(client, prefix, TOPIC_INSIDE_TEMPERATURE, payload);
+    if (isfinite(v.rhPct)) {
+      snprintf(payload, sizeof(payload), "%.0f", v.rhPct);
+      publish_as(client, prefix, TOPIC_INSIDE_HUMIDITY, payload);
+    }
+    if (isfinite(v.pressHPa)) {
+      snprintf(payload, sizeof(payload), "%.1f", v.pressHPa);
+      publish_as(client, prefix, TOPIC_INSIDE_PRESSURE, payload);
+    }
+  }
+  if (v.batteryPct >= 0 && isfinite(v.batteryV)) {
+    snprintf(payload, sizeof(payload), "%.2f", v.batteryV);
+    publish_as(client, prefix, TOPIC_BATTERY_VOLTAGE, payload);
+    snprintf(payload, sizeof(payload), "%d", v.batteryPct);
+    publish_as(client, prefix, TOPIC_BATTERY_PERCENT, payload);
+  }
+  publish_as(client, prefix, TOPIC_TELEMETRY, p.payload, p.payload_len, false);
+}
+
+void espnow_gateway_service(PubSubClient* client) {
+  if (!espnow_gateway_begin() || !client || !client->connected()) return;
+
+  EspNowRx rx;
+  EspNowPacket p;
+  while (rx_pop(&rx)) {
+    if (!espnow_packet_decode(rx.data, rx.len, &p)) continue;
+    if (!g_seen.accept(rx.mac, p.seq)) continue;   // Retry of a report already published
+    publish_report(client, rx.mac, p);
+  }
+
+  static uint32_t reported_drops = 0;
+  if (g_rx_dropped != reported_drops) {
+    reported_drops = g_rx_dropped;
+    Serial.printf("[ESPNOW] Queue full, %lu reports dropped\n", (unsigned long)reported_drops);
+  }
+}
+#endif // ESPNOW_GATEWAY
+
+#endif // ESPNOW_TRANSPORT || ESPNOW_GATEWAY
@@ -0,0 +1,45 @@
+#pragma once
+// ESP-NOW transport to a gateway node (ESPNOW_TRANSPORT / ESPNOW_GATEWAY)
+// Association, DHCP, TCP and MQTT account for nearly all of a report wake's
+// radio time. On a report wake the sensor instead brings the radio up
+// without associating, tunes it to the AP channel remembered from the last
+// association, and sends its compact telemetry frame (telemetry_frame.h) in
+// one ESP-NOW packet (espnow_packet.h): a few milliseconds of radio. The MAC
+// layer acks a unicast send; a send that is never acked falls back to the
+// normal WiFi/MQTT path on the same wake.
+//
+// The gateway is a mains-powered node running this firmware built with
+// ESPNOW_GATEWAY (env:feather_esp32s2_gateway). It stays associated with the
+// radio always listening (no modem sleep, since that misses ESP-NOW frames)
+// and republishes each report under the sender's namespace,
+// espsensor/<sender mac>/..., exactly as the sensor would have.
+//
+// Usage (sensor, from app_setup()):
+//   if (espnow_link_wake_applies() && espnow_link_send(frame, n)) ...  // Sleep without WiFi
+//   espnow_link_note_mqtt_wake();                  // After a publish over MQTT
+//
+// Usage (gateway):
+//   espnow_gateway_begin();                        // Once WiFi is associated
+//   espnow_gateway_service(mqtt_get_client());     // From net_loop()
+
+#include <stddef.h>
+#include <stdint.h>
+
+class PubSubClient;
+
+// This wake may report over ESP-NOW: the AP channel is known and a full
+// MQTT wake is not due
+bool espnow_link_wake_applies();
+
+// Send one telemetry frame; true once a gateway acked it (or, without
+// ESPNOW_GATEWAY_MAC, once broadcast). Leaves the radio off.
+bool espnow_link_send(const uint8_t* frame, size_t len);
+
+// Restart the count towards the next full MQTT wake
+void espnow_link_note_mqtt_wake();
+
+// Start listening on the associated channel
+bool espnow_gateway_begin();
+
+// Publish the reports received since the last call
+void espnow_gateway_service(PubSubClient* client);
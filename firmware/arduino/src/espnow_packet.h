@@ -0,0 +1,94 @@
+#pragma once
+
+// ESP-NOW packet framing (espnow_link.h)
+// A sensor in ESP-NOW mode sends its compact telemetry frame
+// (telemetry_frame.h) straight to a gateway node instead of associating,
+// wrapped in a four-byte header. The sender is identified by its MAC, which
+// is also its client id, so the gateway can publish under espsensor/<mac>/.
+//
+// Layout (v1):
+//   off size field
+//    0   1   magic (0xE5)
+//    1   1   kind (ESPNOW_KIND_TELEMETRY)
+//    2   2   seq     uint16 LE, same value on every retry of one report
+//    4   n   payload
+//
+// Usage:
+//   uint8_t pkt[ESPNOW_PACKET_MAX];
+//   size_t n = espnow_packet_encode(ESPNOW_KIND_TELEMETRY, seq, frame, len, pkt, sizeof(pkt));
+//   EspNowPacket p;
+//   if (espnow_packet_decode(data, len, &p) && seen.accept(mac, p.seq)) publish(p);
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static constexpr uint8_t ESPNOW_PACKET_MAGIC = 0xE5;
+static constexpr size_t ESPNOW_PACKET_HEADER = 4;
+static constexpr size_t ESPNOW_PACKET_MAX = 250;     // ESP_NOW_MAX_DATA_LEN
+
+enum EspNowKind : uint8_t {
+  ESPNOW_KIND_TELEMETRY = 1,
+};
+
+struct EspNowPacket {
+  uint8_t kind;
+  uint16_t seq;
+  const uint8_t* payload;    // Points into the decoded buffer
+  size_t payload_len;
+};
+
+// Returns the packet length, or 0 if the payload does not fit
+inline size_t espnow_packet_encode(uint8_t kind, uint16_t seq, const uint8_t* payload,
+                                   size_t payload_len, uint8_t* out, size_t out_size) {
+  size_t n = ESPNOW_PACKET_HEADER + payload_len;
+  if (!out || n > out_size || n > ESPNOW_PACKET_MAX) return 0;
+  if (payload_len && !payload) return 0;
+  out[0] = ESPNOW_PACKET_MAGIC;
+  out[1] = kind;
+  out[2] = (uint8_t)(seq & 0xFF);
+  out[3] = (uint8_t)(seq >> 8);
+  if (payload_len) memcpy(out + ESPNOW_PACKET_HEADER, payload, payload_len);
+  return n;
+}
+
+// False for a short buffer or foreign traffic
+inline bool espnow_packet_decode(const uint8_t* in, size_t len, EspNowPacket* p) {
+  if (!in || !p || len < ESPNOW_PACKET_HEADER || len > ESPNOW_PACKET_MAX) return false;
+  if (in[0] != ESPNOW_PACKET_MAGIC) return false;
+  p->kind = in[1];
+  p->seq = (uint16_t)(in[2] | (in[3] << 8));
+  p->payload = in + ESPNOW_PACKET_HEADER;
+  p->payload_len = len - ESPNOW_PACKET_HEADER;
+  return true;
+}
+
+// Last sequence number per sender. A report whose MAC-layer ack was lost is
+// sent again with the same seq; the gateway drops the copy. Senders past N
+// evict the oldest entry.
+template <size_t N>
+struct EspNowSeqTable {
+  uint8_t mac[N][6];
+  uint16_t seq[N];
+  size_t used;
+  size_t next;               // Eviction cursor once full
+
+  void clear() {
+    used = 0;
+    next = 0;
+  }
+
+  // True if (sender, seq) is new; records it
+  bool accept(const uint8_t sender[6], uint16_t s) {
+    for (size_t i = 0; i < used; i++) {
+      if (memcmp(mac[i], sender, 6) != 0) continue;
+      if (seq[i] == s) return false;
+      seq[i] = s;
+      return true;
+    }
+    size_t slot = used < N ? used++ : next++ % N;
+    memcpy(mac[slot], sender, 6);
+    seq[slot] = s;
+    return true;
+  }
+};
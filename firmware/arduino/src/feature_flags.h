@@ -55,6 +55,15 @@
   #endif
 #endif
 
+// Hot-path trace ring dumped by the "trace" debug command (debug builds)
+#ifndef FEATURE_TRACE
+  #ifdef DEBUG
+    #define FEATURE_TRACE 1
+  #else
+    #define FEATURE_TRACE 0
+  #endif
+#endif
+
 // Memory tracking
 #ifndef FEATURE_MEMORY_TRACKING
   #define FEATURE_MEMORY_TRACKING 1
@@ -70,6 +79,123 @@
   #define FEATURE_BUFFER_POOL 1
 #endif
 
+// Buffer pool size classes (bytes per slot, slots per class; at most 32 slots).
+// Classes must ascend in size; a full class falls back to the next larger one.
+// Size them from the "hw" high-water marks reported by the bufpool command.
+#ifndef BUFFER_POOL_SMALL_SIZE
+  #define BUFFER_POOL_SMALL_SIZE 64
+#endif
+#ifndef BUFFER_POOL_SMALL_COUNT
+  #define BUFFER_POOL_SMALL_COUNT 4
+#endif
+#ifndef BUFFER_POOL_MEDIUM_SIZE
+  #define BUFFER_POOL_MEDIUM_SIZE 128
+#endif
+#ifndef BUFFER_POOL_MEDIUM_COUNT
+  #define BUFFER_POOL_MEDIUM_COUNT 2
+#endif
+#ifndef BUFFER_POOL_LARGE_SIZE
+  #define BUFFER_POOL_LARGE_SIZE 256
+#endif
+#ifndef BUFFER_POOL_LARGE_COUNT
+  #define BUFFER_POOL_LARGE_COUNT 1
+#endif
+
+// WiFi fast reconnect using BSSID/channel/lease cached in RTC memory
+#ifndef FEATURE_WIFI_FAST_RECONNECT
+  #define FEATURE_WIFI_FAST_RECONNECT 1
+#endif
+
+// WiFi TX power, protocol, listen interval and backoff from per-wake RSSI history
+#ifndef FEATURE_WIFI_LINK_ADAPT
+  #define FEATURE_WIFI_LINK_ADAPT 1
+#endif
+
+// Pipelined boot: sensor init/measurement on a second task during WiFi association
+#ifndef FEATURE_PIPELINED_BOOT
+  #define FEATURE_PIPELINED_BOOT 1
+#endif
+
+// Wake-cycle timeline recorder (RTC ring of per-wake phase timestamps)
+#ifndef FEATURE_WAKE_TIMELINE
+  #define FEATURE_WAKE_TIMELINE 1
+#endif
+
+// Skip WiFi/MQTT on timer wakes whose readings are within deadband
+#ifndef FEATURE_SKIP_UNCHANGED_WAKES
+  #define FEATURE_SKIP_UNCHANGED_WAKES 1
+#endif
+
+// Per-phase CPU clock: I/O-bound phases at CPU_FREQ_IO_MHZ, render/CRC at
+// CPU_FREQ_COMPUTE_MHZ (cpu_freq.h)
+#ifndef FEATURE_CPU_FREQ_SCALING
+  #define FEATURE_CPU_FREQ_SCALING 1
+#endif
+
+// ULP RISC-V samples the BME280 during deep sleep and wakes the main cores
+// only when a reading leaves its deadband (needs an ESP-IDF build with the
+// ULP program, ulp/main.c; see ulp_sampler.cpp)
+#ifndef FEATURE_ULP_SAMPLING
+  #define FEATURE_ULP_SAMPLING 0
+#endif
+
+// Always-on loops (DEV_NO_SLEEP, diagnostic mode) block on the broker socket
+// between events with DTIM WiFi power save, and let esp_pm light-sleep the
+// chip where the build supports it (idle_sleep.h)
+#ifndef FEATURE_IDLE_LIGHT_SLEEP
+  #define FEATURE_IDLE_LIGHT_SLEEP 1
+#endif
+
+// Queue readings in RTC while offline and replay them on reconnect
+#ifndef FEATURE_OFFLINE_QUEUE
+  #define FEATURE_OFFLINE_QUEUE 1
+#endif
+
+// Per-phase charge accounting and measured battery-life estimate
+#ifndef FEATURE_ENERGY_METER
+  #define FEATURE_ENERGY_METER 1
+#endif
+
+// Firmware updates as delta patches over MQTT, received across wakes into
+// the inactive OTA partition and hash-checked before switching (ota_update.h)
+#ifndef FEATURE_OTA_DELTA
+  #define FEATURE_OTA_DELTA 1
+#endif
+
+// Rolling low/high/mean of the inside readings over 1 h and 24 h, kept in
+// RTC buckets, published and drawn on the display (inside_stats.h)
+#ifndef FEATURE_INSIDE_STATS
+  #define FEATURE_INSIDE_STATS 1
+#endif
+
+// On-device micro-benchmarks behind the "bench" debug command (device_bench.h)
+#ifndef FEATURE_DEVICE_BENCH
+  #define FEATURE_DEVICE_BENCH 1
+#endif
+
+// Compile-time log filtering for the Logger macros (logging/logger.h)
+// LOG_TRACE..LOG_FATAL calls below LOG_COMPILE_LEVEL (0=TRACE, 1=DEBUG,
+// 2=INFO, 3=WARN, 4=ERROR, 5=FATAL) compile to nothing, format string and
+// arguments included; the runtime level still filters everything above it.
+#ifndef LOG_COMPILE_LEVEL
+  #ifdef RELEASE_BUILD
+    #define LOG_COMPILE_LEVEL 2
+  #else
+    #define LOG_COMPILE_LEVEL 0
+  #endif
+#endif
+
+// Per-module compile mask: clear a module's bit to drop all of its calls.
+// Modules without a bit (names not listed in log_compile_module_bit) are
+// always compiled in.
+#define LOG_COMPILE_MODULE_MAIN     (1u << 0)
+#define LOG_COMPILE_MODULE_SYSTEM   (1u << 1)
+#define LOG_COMPILE_MODULE_PERF     (1u << 2)
+#define LOG_COMPILE_MODULE_DISPCAP  (1u << 3)
+#ifndef LOG_COMPILE_MODULE_MASK
+  #define LOG_COMPILE_MODULE_MASK 0xFFFFFFFFu
+#endif
+
 // Helper macros
 #define FEATURE_ENABLED(x) (FEATURE_##x == 1)
 #define FEATURE_DISABLED(x) (FEATURE_##x == 0)
@@ -0,0 +1,92 @@
+#pragma once
+
+// Changed areas between two 1-bit frames (DISPLAY_DOUBLE_BUFFER)
+// Compares the previously displayed frame with the next one 32 bits at a
+// time and reports each run of changed rows as one window spanning the
+// changed columns, in frame pixel coordinates. No window covers a row that
+// did not change; the caller byte-aligns and coalesces them like dirty rects.
+//
+// Usage:
+//   PanelWindow wins[8];
+//   size_t n = frame_diff_windows(prev, next, 32, 250, 122, wins, 8);
+//   if (n == 0) { /* the panel already shows next */ }
+//   for (size_t i = 0; i < n; i++) wins[i] = panel_window_aligned(wins[i].x, ...);
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "partial_windows.h"
+
+// Changed pixel columns [x0, x1] of one row (MSB-first bytes), false if none
+inline bool frame_diff_row(const uint8_t* a, const uint8_t* b, uint16_t stride,
+                           uint16_t width, uint16_t& x0, uint16_t& x1) {
+  size_t first = stride, last = 0;
+  size_t i = 0;
+  for (; i + 4 <= stride; i += 4) {
+    uint32_t wa, wb;
+    memcpy(&wa, a + i, 4);
+    memcpy(&wb, b + i, 4);
+    if (wa == wb) continue;
+    for (size_t k = i; k < i + 4; k++) {
+      if (a[k] == b[k]) continue;
+      if (first == stride) first = k;
+      last = k;
+    }
+  }
+  for (; i < stride; i++) {
+    if (a[i] == b[i]) continue;
+    if (first == stride) first = i;
+    last = i;
+  }
+  if (first == stride) return false;
+
+  uint8_t lead = a[first] ^ b[first];
+  uint8_t tail = a[last] ^ b[last];
+  uint16_t lx = (uint16_t)(first * 8);
+  while (!(lead & 0x80)) { lead <<= 1; lx++; }
+  uint16_t rx = (uint16_t)(last * 8 + 7);
+  while (!(tail & 0x01)) { tail >>= 1; rx--; }
+  if (lx >= width) return false;            // Only padding bits differ
+  if (rx >= width) rx = (uint16_t)(width - 1);
+  x0 = lx;
+  x1 = rx;
+  return true;
+}
+
+// Windows over the changed row runs; returns how many were written. When
+// there are more runs than max_out, the last window absorbs the rest.
+inline size_t frame_diff_windows(const uint8_t* prev, const uint8_t* next, uint16_t stride,
+                                 uint16_t width, uint16_t height,
+                                 PanelWindow* out, size_t max_out) {
+  if (!prev || !next || !out || max_out == 0) return 0;
+  size_t n = 0;
+  bool open = false;
+  uint16_t bx0 = 0, bx1 = 0, by0 = 0;
+  for (uint16_t y = 0; y <= height; y++) {
+    uint16_t x0 = 0, x1 = 0;
+    bool changed = y < height &&
+                   frame_diff_row(prev + (size_t)y * stride, next + (size_t)y * stride,
+                                  stride, width, x0, x1);
+    if (changed) {
+      if (!open) {
+        open = true;
+        by0 = y;
+        bx0 = x0;
+        bx1 = x1;
+      } else {
+        if (x0 < bx0) bx0 = x0;
+        if (x1 > bx1) bx1 = x1;
+      }
+      continue;
+    }
+    if (!open) continue;
+    open = false;
+    PanelWindow w = {(int16_t)bx0, (int16_t)by0, (int16_t)(bx1 - bx0 + 1), (int16_t)(y - by0)};
+    if (n < max_out) {
+      out[n++] = w;
+    } else {
+      out[n - 1] = panel_window_union(out[n - 1], w);
+    }
+  }
+  return n;
+}
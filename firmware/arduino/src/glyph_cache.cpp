@@ -0,0 +1,67 @@
+// Glyph cache implementation
+#include "glyph_cache.h"
+
+#if USE_DISPLAY
+
+#include <Adafruit_GFX.h>
+#include <cstring>
+
+// Characters whose glyphs are cached; '\xF8' is the degree sign as printed
+static const char kCachedChars[] = "0123456789.-:% \xF8" "FC";
+static constexpr size_t CACHED_COUNT = sizeof(kCachedChars) - 1;
+
+static GlyphBitmap g_glyphs[GLYPH_CACHE_MAX_SIZE][CACHED_COUNT];
+static bool g_ready[GLYPH_CACHE_MAX_SIZE][CACHED_COUNT];
+
+static int cached_index(char c) {
+  for (size_t i = 0; i < CACHED_COUNT; ++i) {
+    if (kCachedChars[i] == c) return (int)i;
+  }
+  return -1;
+}
+
+// Rasterize through write() on a scratch canvas so the result includes the
+// font's own quirks (CP437 offset for chars >= 176, transparent background)
+static void rasterize(char c, uint8_t size, GlyphBitmap& g) {
+  static GFXcanvas1 scratch(GLYPH_ADVANCE * GLYPH_CACHE_MAX_SIZE,
+                            GLYPH_HEIGHT * GLYPH_CACHE_MAX_SIZE);
+  scratch.fillScreen(0);
+  scratch.setTextWrap(false);
+  scratch.setTextSize(size);
+  scratch.setTextColor(1);
+  scratch.setCursor(0, 0);
+  scratch.write((uint8_t)c);
+
+  g.w = (uint8_t)((GLYPH_ADVANCE - 1) * size);   // Sixth column is spacing
+  g.h = (uint8_t)(GLYPH_HEIGHT * size);
+  const size_t src_stride = (scratch.width() + 7) / 8;
+  const size_t dst_stride = (g.w + 7) / 8;
+  const uint8_t* src = scratch.getBuffer();
+  memset(g.bits, 0, sizeof(g.bits));
+  for (uint8_t r = 0; r < g.h; ++r) {
+    memcpy(g.bits + r * dst_stride, src + r * src_stride, dst_stride);
+  }
+  // Drop scratch pixels past the glyph width in the last byte
+  uint8_t tail = (uint8_t)(0xFF << ((8 - (g.w & 7)) & 7));
+  for (uint8_t r = 0; r < g.h; ++r) g.bits[r * dst_stride + dst_stride - 1] &= tail;
+}
+
+int16_t text_width_default_font(const char* s, uint8_t size) {
+  int16_t count = 0;
+  for (const char* p = s; *p; ++p) count++;
+  return static_cast<int16_t>(count * GLYPH_ADVANCE * size);
+}
+
+const GlyphBitmap* glyph_cache_get(char c, uint8_t size) {
+  if (size < 1 || size > GLYPH_CACHE_MAX_SIZE) return nullptr;
+  int idx = cached_index(c);
+  if (idx < 0) return nullptr;
+  GlyphBitmap& g = g_glyphs[size - 1][idx];
+  if (!g_ready[size - 1][idx]) {
+    rasterize(c, size, g);
+    g_ready[size - 1][idx] = true;
+  }
+  return &g;
+}
+
+#endif // USE_DISPLAY
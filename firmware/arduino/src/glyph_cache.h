@@ -0,0 +1,39 @@
+#pragma once
+
+// Pre-rasterized glyphs for repeated text
+// Every spec text uses Adafruit GFX's built-in 5x7 font, at text size 1
+// (labels, clock, footer) or 2 (large temperatures). The glyphs that change
+// on every refresh (digits, sign, decimal point, colon, percent, degree
+// sign and unit letters) are rasterized once per wake with the font's own
+// write(), kept in static RAM, and drawn afterwards as bitmap blits. Other
+// characters return nullptr and are drawn by Adafruit GFX as before.
+//
+// Usage:
+//   const GlyphBitmap* g = glyph_cache_get('7', 2);
+//   if (g) raster_bitmap(target, x, y, g->bits, g->w, g->h, true);
+//   x += GLYPH_ADVANCE * 2;
+
+#include "config.h"
+
+#if USE_DISPLAY
+
+#include <cstdint>
+
+static constexpr uint8_t GLYPH_CACHE_MAX_SIZE = 2;  // Largest text size cached
+static constexpr int16_t GLYPH_ADVANCE = 6;          // Built-in font advance at size 1
+static constexpr int16_t GLYPH_HEIGHT = 8;           // Built-in font cell height at size 1
+
+struct GlyphBitmap {
+  uint8_t w;
+  uint8_t h;
+  uint8_t bits[GLYPH_HEIGHT * GLYPH_CACHE_MAX_SIZE * 2];  // MSB-first rows, (w + 7) / 8 bytes
+};
+
+// Width of s in the built-in font at text size (GLYPH_ADVANCE per char)
+int16_t text_width_default_font(const char* s, uint8_t size);
+
+// Glyph for c at text size (1..GLYPH_CACHE_MAX_SIZE), rasterized on first
+// use; nullptr if c is not in the cached set or size is out of range
+const GlyphBitmap* glyph_cache_get(char c, uint8_t size);
+
+#endif // USE_DISPLAY
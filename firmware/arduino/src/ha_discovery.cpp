@@ -7,184 +7,292 @@
 #include "mqtt_client.h"
 #include "generated_config.h"
 #include "config.h"
+#include "mqtt_batcher.h"
+#include "mqtt_dispatch.h"
+#include "system_manager.h"
+#include "code_placement.h"
 
 // Forward declaration for MQTT publish function
 extern bool mqtt_publish_raw(const char* topic, const char* payload, bool retain);
 
+// JSON-escaped templates from gen_device_header.py; fall back to the raw
+// macros for a generated_config.h that predates them
+#ifndef HA_ROOM_NAME_JSON
+#define HA_ROOM_NAME_JSON ROOM_NAME
+#endif
+#ifndef HA_DEVICE_JSON_TAIL
+#define HA_DEVICE_JSON_TAIL "\"name\":\"" ROOM_NAME " Sensor\",\"model\":\"ESP32 Environmental Sensor\"," \
+                            "\"manufacturer\":\"DIY\",\"sw_version\":\"" FW_VERSION "\"}"
+#endif
+
+// Largest config is ~560 bytes (packed mode, 39-char client id); PubSubClient
+// is built with a 1024-byte packet
+static constexpr size_t DISCOVERY_PAYLOAD_LEN = 640;
+static constexpr size_t DISCOVERY_TOPIC_LEN = 128;
+
+// NVS key (cache namespace) holding the CRC of the last published set
+static constexpr const char* HA_DISCOVERY_NVS_KEY = "ha_crc";
+
 static char g_device_id[40];
 static bool g_diagnostic_entities = false;
+static bool g_republish_requested = false;
 
-// Helper to publish discovery config
-static void publish_discovery_config(const char* component, const char* sensor_name, 
-                                    const char* json_config) {
-  char topic[256];
-  snprintf(topic, sizeof(topic), "homeassistant/%s/%s_%s/config", 
-          component, g_device_id, sensor_name);
-  
-  mqtt_publish_raw(topic, json_config, true);
+// Rendered once per client id: {"identifiers":["<id>"],<HA_DEVICE_JSON_TAIL>
+static char g_device_block[256];
+
+// One payload buffer reused for every entity (no String/heap traffic)
+static char g_payload[DISCOVERY_PAYLOAD_LEN];
+static char g_config_topic[DISCOVERY_TOPIC_LEN];
+
+// Static entity description; everything but the device id is a literal
+struct HaEntity {
+  const char* object_id;      // unique_id / config topic suffix
+  const char* name;           // Friendly name (JSON-escaped)
+  const char* state_suffix;   // Under espsensor/<id>/
+  const char* device_class;   // nullptr = omit
+  const char* unit;           // nullptr = omit
+  const char* icon;           // nullptr = omit
+  bool batched;               // Published through MQTTBatcher (packed-mode aware)
+  bool round1;                // value_template rounds to one decimal
+  bool diagnostic;            // entity_category: diagnostic
+};
+
+enum HaEntityId : uint8_t {
+  HA_TEMPERATURE = 0,
+  HA_HUMIDITY,
+  HA_PRESSURE,
+  HA_BATTERY,
+  HA_BATTERY_VOLTAGE,
+  HA_RSSI,
+  HA_UPTIME,
+  HA_WAKE_COUNT,
+  HA_ENTITY_COUNT
+};
+
+static const HaEntity kEntities[] = {
+  {"temperature",     HA_ROOM_NAME_JSON " Temperature",     "inside/temperature", "temperature",          "°C",  nullptr,              true,  true,  false},
+  {"humidity",        HA_ROOM_NAME_JSON " Humidity",        "inside/humidity",    "humidity",             "%",   nullptr,              true,  true,  false},
+  {"pressure",        HA_ROOM_NAME_JSON " Pressure",        "inside/pressure",    "atmospheric_pressure", "hPa", nullptr,              true,  true,  false},
+  {"battery",         HA_ROOM_NAME_JSON " Battery",         "battery/percent",    "battery",              "%",   nullptr,              true,  false, false},
+  {"battery_voltage", HA_ROOM_NAME_JSON " Battery Voltage", "battery/voltage",    "voltage",              "V",   nullptr,              true,  false, true},
+  {"rssi",            HA_ROOM_NAME_JSON " WiFi RSSI",       "wifi/rssi",          "signal_strength",      "dBm", nullptr,              false, false, true},
+  {"uptime",          HA_ROOM_NAME_JSON " Uptime",          "debug/uptime",       nullptr,                "s",   "mdi:timer-outline",  true,  false, true},
+  {"wake_count",      HA_ROOM_NAME_JSON " Wake Count",      "debug/wake_count",   nullptr,                nullptr, "mdi:counter",      false, false, true},
+};
+
+// Append-only writer over a fixed buffer; overflow sticks and is checked once
+struct DiscoveryWriter {
+  char* buf;
+  size_t cap;
+  size_t len;
+  bool overflow;
+
+  void raw(const char* s) {
+    size_t n = strlen(s);
+    if (overflow || len + n >= cap) {
+      overflow = true;
+      return;
+    }
+    memcpy(buf + len, s, n + 1);
+    len += n;
+  }
+
+  // "key":"a b c",  (parts concatenated; nullptr parts are skipped)
+  void field(const char* key, const char* a, const char* b = nullptr,
+             const char* c = nullptr, const char* d = nullptr) {
+    raw("\"");
+    raw(key);
+    raw("\":\"");
+    raw(a);
+    if (b) raw(b);
+    if (c) raw(c);
+    if (d) raw(d);
+    raw("\",");
+  }
+};
+
+static void render_device_block() {
+  int n = snprintf(g_device_block, sizeof(g_device_block), "{\"identifiers\":[\"%s\"],%s",
+                   g_device_id, HA_DEVICE_JSON_TAIL);
+  if (n < 0 || (size_t)n >= sizeof(g_device_block)) {
+    // A truncated block would be invalid JSON; publish_entity skips on empty
+    Serial.println("[HA] Device block too large - discovery disabled");
+    g_device_block[0] = '\0';
+  }
+}
+
+// state_topic (+ value_template); in packed mode the reading lives in
+// espsensor/<id>/state under the key MQTTBatcher derives from the suffix
+static void write_state_fields(DiscoveryWriter& w, const HaEntity& e) {
+#if MQTT_PACKED_STATE
+  if (e.batched) {
+    char key[MQTTBatcher::MAX_TOPIC_LEN];
+    MQTTBatcher::packedKey(e.state_suffix, key, sizeof(key));
+    w.field("state_topic", "espsensor/", g_device_id, "/", MQTTBatcher::PACKED_TOPIC_SUFFIX);
+    w.field("value_template", "{{ value_json.", key, e.round1 ? " | round(1)" : "", " }}");
+    return;
+  }
+#endif
+  w.field("state_topic", "espsensor/", g_device_id, "/", e.state_suffix);
+  if (e.round1) w.field("value_template", "{{ value | round(1) }}");
+}
+
+// Render one entity's config topic and payload into the shared buffers
+static bool render_entity(HaEntityId id) {
+  const HaEntity& e = kEntities[id];
+  if (g_device_block[0] == '\0') render_device_block();
+  if (g_device_block[0] == '\0') return false;
+
+  DiscoveryWriter w = {g_payload, sizeof(g_payload), 0, false};
+  w.raw("{");
+  w.field("name", e.name);
+  w.field("unique_id", g_device_id, "_", e.object_id);
+  write_state_fields(w, e);
+  w.field("availability_topic", "espsensor/", g_device_id, "/availability");
+  if (e.device_class) w.field("device_class", e.device_class);
+  if (e.unit) w.field("unit_of_measurement", e.unit);
+  if (e.icon) w.field("icon", e.icon);
+  if (e.diagnostic) w.field("entity_category", "diagnostic");
+  w.raw("\"device\":");
+  w.raw(g_device_block);
+  w.raw("}");
+
+  if (w.overflow) {
+    Serial.printf("[HA] Discovery config too large, skipping: %s\n", e.object_id);
+    return false;
+  }
+
+  snprintf(g_config_topic, sizeof(g_config_topic), "homeassistant/sensor/%s_%s/config",
+           g_device_id, e.object_id);
+  return true;
+}
+
+// False if the config could not be rendered or the broker did not take it
+COLD_PATH static bool publish_entity(HaEntityId id) {
+  return render_entity(id) && mqtt_publish_raw(g_config_topic, g_payload, true);
+}
+
+// Entities ha_discovery_publish_all() emits with the current settings
+static bool entity_in_set(HaEntityId id) {
+  return g_diagnostic_entities || !kEntities[id].diagnostic || id == HA_RSSI;
+}
+
+// CRC over every config (topic + payload) in the current set, plus the
+// firmware version so an upgrade always republishes
+static uint32_t discovery_set_hash() {
+  uint32_t crcs[HA_ENTITY_COUNT + 1];
+  size_t n = 0;
+  for (uint8_t i = 0; i < HA_ENTITY_COUNT; i++) {
+    HaEntityId id = (HaEntityId)i;
+    if (!entity_in_set(id) || !render_entity(id)) continue;
+    uint32_t topic_crc = fast_crc32((const uint8_t*)g_config_topic, strlen(g_config_topic));
+    crcs[n++] = topic_crc ^ fast_crc32((const uint8_t*)g_payload, strlen(g_payload));
+  }
+  crcs[n++] = fast_crc32((const uint8_t*)FW_VERSION, strlen(FW_VERSION));
+  return fast_crc32((const uint8_t*)crcs, n * sizeof(crcs[0]));
 }
 
-// Helper to build device JSON
-static String build_device_json() {
-  return String("{") +
-    "\"identifiers\":[\"" + g_device_id + "\"]," +
-    "\"name\":\"" + ROOM_NAME + " Sensor\"," +
-    "\"model\":\"ESP32 Environmental Sensor\"," +
-    "\"manufacturer\":\"DIY\"," +
-    "\"sw_version\":\"" + FW_VERSION + "\"" +
-    "}";
+// HA birth message: Home Assistant restarted and needs the configs again
+COLD_PATH static void on_ha_status(const MqttInbound& msg) {
+  if (msg.length == 6 && memcmp(msg.payload, "online", 6) == 0) {
+    Serial.println("[HA] Home Assistant online - republishing discovery");
+    g_republish_requested = true;
+  }
 }
 
 void ha_discovery_begin(const char* client_id) {
   if (client_id) {
     snprintf(g_device_id, sizeof(g_device_id), "%s", client_id);
+    render_device_block();
   }
+  mqtt_dispatch_set_prefix(MQTT_NS_HOMEASSISTANT, "homeassistant/");
+  mqtt_dispatch_register(MQTT_NS_HOMEASSISTANT, "status", on_ha_status);
 }
 
-void ha_discovery_publish_all() {
-  if (!mqtt_is_connected()) return;
+COLD_PATH bool ha_discovery_publish_all() {
+  if (!mqtt_is_connected()) return false;
   
-  ha_discovery_publish_temperature_sensor();
-  ha_discovery_publish_humidity_sensor();
-  ha_discovery_publish_pressure_sensor();
-  ha_discovery_publish_battery_sensor();
-  ha_discovery_publish_rssi_sensor();
-  
-  if (g_diagnostic_entities) {
-    ha_discovery_publish_diagnostic_sensors();
+  bool ok = true;
+  for (uint8_t i = 0; i < HA_ENTITY_COUNT; i++) {
+    if (entity_in_set((HaEntityId)i) && !publish_entity((HaEntityId)i)) ok = false;
   }
+  return ok;
 }
 
-void ha_discovery_publish_temperature_sensor() {
+bool ha_discovery_publish_if_changed() {
+  if (!mqtt_is_connected()) return false;
+
+  // Watch for HA restarts (birth message) from here on
+  PubSubClient* client = mqtt_get_client();
+  if (client && !mqtt_session_resumed()) {
+    client->subscribe("homeassistant/status", MQTT_PERSISTENT_SESSION ? 1 : 0);
+  }
+
+  uint32_t hash = discovery_set_hash();
+#if HA_DISCOVERY_SKIP_UNCHANGED
+  uint32_t stored = nvs_load_uint(HA_DISCOVERY_NVS_KEY, 0);
+  if (stored == hash && !g_republish_requested) {
+    Serial.printf("[HA] Discovery unchanged (crc=%08lx) - not republishing\n", (unsigned long)hash);
+    return false;
+  }
+#endif
+
+  bool ok = ha_discovery_publish_all();
+  g_republish_requested = false;
+  if (!ok) {
+    // Keep the old hash so the next wake publishes the set again
+    Serial.println("[HA] Discovery publish incomplete - will retry next wake");
+    return false;
+  }
+  nvs_store_uint(HA_DISCOVERY_NVS_KEY, hash);
+  Serial.printf("[HA] Discovery published (crc=%08lx)\n", (unsigned long)hash);
+  return true;
+}
+
+void ha_discovery_service() {
+  if (g_republish_requested && mqtt_is_connected()) {
+    bool ok = ha_discovery_publish_all();
+    g_republish_requested = false;
+    if (ok) nvs_store_uint(HA_DISCOVERY_NVS_KEY, discovery_set_hash());
+  }
+}
+
+COLD_PATH void ha_discovery_publish_temperature_sensor() {
   if (!mqtt_is_connected()) return;
-  
-  String config = String("{") +
-    "\"name\":\"" + ROOM_NAME + " Temperature\"," +
-    "\"unique_id\":\"" + g_device_id + "_temperature\"," +
-    "\"state_topic\":\"espsensor/" + g_device_id + "/inside/temperature\"," +
-    "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-    "\"device_class\":\"temperature\"," +
-    "\"unit_of_measurement\":\"°C\"," +
-    "\"value_template\":\"{{ value | round(1) }}\"," +
-    "\"device\":" + build_device_json() +
-    "}";
-  
-  publish_discovery_config("sensor", "temperature", config.c_str());
+  publish_entity(HA_TEMPERATURE);
 }
 
-void ha_discovery_publish_humidity_sensor() {
+COLD_PATH void ha_discovery_publish_humidity_sensor() {
   if (!mqtt_is_connected()) return;
-  
-  String config = String("{") +
-    "\"name\":\"" + ROOM_NAME + " Humidity\"," +
-    "\"unique_id\":\"" + g_device_id + "_humidity\"," +
-    "\"state_topic\":\"espsensor/" + g_device_id + "/inside/humidity\"," +
-    "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-    "\"device_class\":\"humidity\"," +
-    "\"unit_of_measurement\":\"%\"," +
-    "\"value_template\":\"{{ value | round(1) }}\"," +
-    "\"device\":" + build_device_json() +
-    "}";
-  
-  publish_discovery_config("sensor", "humidity", config.c_str());
+  publish_entity(HA_HUMIDITY);
 }
 
-void ha_discovery_publish_pressure_sensor() {
+COLD_PATH void ha_discovery_publish_pressure_sensor() {
   if (!mqtt_is_connected()) return;
-  
-  String config = String("{") +
-    "\"name\":\"" + ROOM_NAME + " Pressure\"," +
-    "\"unique_id\":\"" + g_device_id + "_pressure\"," +
-    "\"state_topic\":\"espsensor/" + g_device_id + "/inside/pressure\"," +
-    "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-    "\"device_class\":\"atmospheric_pressure\"," +
-    "\"unit_of_measurement\":\"hPa\"," +
-    "\"value_template\":\"{{ value | round(1) }}\"," +
-    "\"device\":" + build_device_json() +
-    "}";
-  
-  publish_discovery_config("sensor", "pressure", config.c_str());
+  publish_entity(HA_PRESSURE);
 }
 
-void ha_discovery_publish_battery_sensor() {
+COLD_PATH void ha_discovery_publish_battery_sensor() {
   if (!mqtt_is_connected()) return;
   
-  // Battery percentage
-  String config = String("{") +
-    "\"name\":\"" + ROOM_NAME + " Battery\"," +
-    "\"unique_id\":\"" + g_device_id + "_battery\"," +
-    "\"state_topic\":\"espsensor/" + g_device_id + "/battery/percent\"," +
-    "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-    "\"device_class\":\"battery\"," +
-    "\"unit_of_measurement\":\"%\"," +
-    "\"device\":" + build_device_json() +
-    "}";
-  
-  publish_discovery_config("sensor", "battery", config.c_str());
+  publish_entity(HA_BATTERY);
   
   // Battery voltage (diagnostic)
   if (g_diagnostic_entities) {
-    config = String("{") +
-      "\"name\":\"" + ROOM_NAME + " Battery Voltage\"," +
-      "\"unique_id\":\"" + g_device_id + "_battery_voltage\"," +
-      "\"state_topic\":\"espsensor/" + g_device_id + "/battery/voltage\"," +
-      "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-      "\"device_class\":\"voltage\"," +
-      "\"unit_of_measurement\":\"V\"," +
-      "\"entity_category\":\"diagnostic\"," +
-      "\"device\":" + build_device_json() +
-      "}";
-    
-    publish_discovery_config("sensor", "battery_voltage", config.c_str());
+    publish_entity(HA_BATTERY_VOLTAGE);
   }
 }
 
-void ha_discovery_publish_rssi_sensor() {
+COLD_PATH void ha_discovery_publish_rssi_sensor() {
   if (!mqtt_is_connected()) return;
-  
-  String config = String("{") +
-    "\"name\":\"" + ROOM_NAME + " WiFi RSSI\"," +
-    "\"unique_id\":\"" + g_device_id + "_rssi\"," +
-    "\"state_topic\":\"espsensor/" + g_device_id + "/wifi/rssi\"," +
-    "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-    "\"device_class\":\"signal_strength\"," +
-    "\"unit_of_measurement\":\"dBm\"," +
-    "\"entity_category\":\"diagnostic\"," +
-    "\"device\":" + build_device_json() +
-    "}";
-  
-  publish_discovery_config("sensor", "rssi", config.c_str());
+  publish_entity(HA_RSSI);
 }
 
-void ha_discovery_publish_diagnostic_sensors() {
+COLD_PATH void ha_discovery_publish_diagnostic_sensors() {
   if (!mqtt_is_connected()) return;
   
-  // Uptime sensor
-  String config = String("{") +
-    "\"name\":\"" + ROOM_NAME + " Uptime\"," +
-    "\"unique_id\":\"" + g_device_id + "_uptime\"," +
-    "\"state_topic\":\"espsensor/" + g_device_id + "/debug/uptime\"," +
-    "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-    "\"unit_of_measurement\":\"s\"," +
-    "\"icon\":\"mdi:timer-outline\"," +
-    "\"entity_category\":\"diagnostic\"," +
-    "\"device\":" + build_device_json() +
-    "}";
-  
-  publish_discovery_config("sensor", "uptime", config.c_str());
-  
-  // Wake count sensor
-  config = String("{") +
-    "\"name\":\"" + ROOM_NAME + " Wake Count\"," +
-    "\"unique_id\":\"" + g_device_id + "_wake_count\"," +
-    "\"state_topic\":\"espsensor/" + g_device_id + "/debug/wake_count\"," +
-    "\"availability_topic\":\"espsensor/" + g_device_id + "/availability\"," +
-    "\"icon\":\"mdi:counter\"," +
-    "\"entity_category\":\"diagnostic\"," +
-    "\"device\":" + build_device_json() +
-    "}";
-  
-  publish_discovery_config("sensor", "wake_count", config.c_str());
+  publish_entity(HA_UPTIME);
+  publish_entity(HA_WAKE_COUNT);
 }
 
 void ha_discovery_set_diagnostic_mode(bool enable) {
@@ -195,7 +303,9 @@ void ha_discovery_set_diagnostic_mode(bool enable) {
 
 // No-op stubs when HA Discovery is disabled
 void ha_discovery_begin(const char*) {}
-void ha_discovery_publish_all() {}
+bool ha_discovery_publish_all() { return false; }
+bool ha_discovery_publish_if_changed() { return false; }
+void ha_discovery_service() {}
 void ha_discovery_publish_temperature_sensor() {}
 void ha_discovery_publish_humidity_sensor() {}
 void ha_discovery_publish_pressure_sensor() {}
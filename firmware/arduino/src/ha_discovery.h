@@ -7,7 +7,18 @@
 
 // Home Assistant discovery functions
 void ha_discovery_begin(const char* client_id);
-void ha_discovery_publish_all();
+// Publish every config in the set; true only if the broker accepted all of them
+bool ha_discovery_publish_all();
+
+// Publish the full set only if its CRC differs from the one stored in NVS
+// (config, firmware version or diagnostic setting changed) or Home Assistant
+// sent its birth message. Returns true if configs were published; on a failed
+// publish the stored CRC is left alone so the next wake tries again.
+bool ha_discovery_publish_if_changed();
+
+// Republish after an HA birth message received while connected (call from the loop)
+void ha_discovery_service();
+
 void ha_discovery_publish_temperature_sensor();
 void ha_discovery_publish_humidity_sensor();
 void ha_discovery_publish_pressure_sensor();
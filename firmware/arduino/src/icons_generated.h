@@ -1,5 +1,6 @@
 #pragma once
 // Copyright 2024 Justin
+#include <stddef.h>
 #include <stdint.h>
 #include <pgmspace.h>
 
@@ -567,6 +568,652 @@ static const uint8_t moon_waning_crescent_24x24_bits[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00,
 };
 
+#define ICON_COUNT 25
+#define ICON_ROW_BYTES 3
+#define ICON_ATLAS_STRIDE (ICON_ROW_BYTES * ICON_H)
+
+// Every icon in IconId order, ICON_ATLAS_STRIDE bytes apart; rows are
+// MSB first with 1 = ink, the canvas framebuffer's bit order
+static const uint8_t icon_atlas[ICON_COUNT * ICON_ATLAS_STRIDE] PROGMEM = {
+    // weather-sunny
+    0x00, 0x00, 0x00,
+    0x00, 0x18, 0x00,
+    0x00, 0x18, 0x00,
+    0x00, 0x18, 0x00,
+    0x0C, 0x00, 0x30,
+    0x0E, 0x00, 0x70,
+    0x04, 0x3C, 0x20,
+    0x00, 0xFF, 0x00,
+    0x01, 0xFF, 0x80,
+    0x01, 0xFF, 0x80,
+    0x03, 0xFF, 0xC0,
+    0x73, 0xFF, 0xCE,
+    0x73, 0xFF, 0xCE,
+    0x03, 0xFF, 0xC0,
+    0x01, 0xFF, 0x80,
+    0x01, 0xFF, 0x80,
+    0x00, 0xFF, 0x00,
+    0x04, 0x3C, 0x20,
+    0x0E, 0x00, 0x70,
+    0x0C, 0x00, 0x30,
+    0x00, 0x18, 0x00,
+    0x00, 0x18, 0x00,
+    0x00, 0x18, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-partly-cloudy
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x01, 0x80, 0x00,
+    0x01, 0x8C, 0x00,
+    0x13, 0xF8, 0x00,
+    0x1E, 0x18, 0x00,
+    0x0C, 0x0F, 0xC0,
+    0x08, 0x1F, 0xF0,
+    0x08, 0x3F, 0xF8,
+    0x38, 0x7F, 0xFC,
+    0x2D, 0xFF, 0xFC,
+    0x0F, 0xFF, 0xFC,
+    0x0F, 0xFF, 0xFC,
+    0x1F, 0xFF, 0xFC,
+    0x1F, 0xFF, 0xFC,
+    0x1F, 0xFF, 0xFC,
+    0x1F, 0xFF, 0xF8,
+    0x0F, 0xFF, 0xF8,
+    0x0F, 0xFF, 0xF0,
+    0x03, 0xFF, 0xC0,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-cloudy
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x0F, 0xC0,
+    0x00, 0x3F, 0xF0,
+    0x00, 0x7F, 0xF8,
+    0x00, 0xFF, 0xFC,
+    0x00, 0xFF, 0xFC,
+    0x1D, 0xFF, 0xFE,
+    0x39, 0xFF, 0xFE,
+    0x39, 0xFF, 0xFE,
+    0x79, 0xFF, 0xFE,
+    0x7F, 0xFF, 0xFE,
+    0x7F, 0xFF, 0xFE,
+    0x7F, 0xFF, 0xFC,
+    0x7F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF0,
+    0x0F, 0xFF, 0xC0,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-fog
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x07, 0x00,
+    0x00, 0x1F, 0xE0,
+    0x00, 0x7F, 0xF0,
+    0x00, 0x7F, 0xF8,
+    0x00, 0xFF, 0xF8,
+    0x04, 0xFF, 0xF8,
+    0x1C, 0xFF, 0xFC,
+    0x1D, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xF8,
+    0x3F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF0,
+    0x1F, 0xFF, 0xF0,
+    0x0F, 0xFF, 0xC0,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x03, 0xF3, 0xC0,
+    0x01, 0x81, 0x80,
+    0x00, 0x00, 0x00,
+    0x00, 0x7F, 0x00,
+    0x00, 0x2A, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-pouring
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x1F, 0xC0,
+    0x00, 0x3F, 0xF0,
+    0x00, 0x7F, 0xF0,
+    0x00, 0xFF, 0xF8,
+    0x04, 0xFF, 0xF8,
+    0x0C, 0xFF, 0xFC,
+    0x1D, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xF8,
+    0x3F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF0,
+    0x0F, 0xFF, 0xE0,
+    0x03, 0xFF, 0x00,
+    0x00, 0x30, 0x00,
+    0x00, 0x62, 0x00,
+    0x00, 0x66, 0x00,
+    0x00, 0xCC, 0x00,
+    0x00, 0x08, 0x00,
+    0x00, 0x18, 0x00,
+    0x00, 0x10, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-drizzle
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x0C, 0x00,
+    0x00, 0x60, 0x00,
+    0x00, 0x60, 0x00,
+    0x00, 0x64, 0x00,
+    0x00, 0x0E, 0x00,
+    0x00, 0x1E, 0x00,
+    0x00, 0x1E, 0x00,
+    0x00, 0x0E, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-snowy
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x1F, 0xC0,
+    0x00, 0x3F, 0xF0,
+    0x00, 0x7F, 0xF0,
+    0x00, 0xFF, 0xF8,
+    0x04, 0xFF, 0xF8,
+    0x0C, 0xFF, 0xFC,
+    0x1D, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xF8,
+    0x3F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF0,
+    0x0F, 0xFF, 0xE0,
+    0x03, 0xFF, 0x00,
+    0x00, 0x00, 0x00,
+    0x01, 0x01, 0x00,
+    0x03, 0x03, 0x00,
+    0x00, 0x30, 0x00,
+    0x00, 0x30, 0x00,
+    0x02, 0x02, 0x00,
+    0x06, 0x03, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-sleet
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x7E, 0x00,
+    0x00, 0xFF, 0x00,
+    0x01, 0xC3, 0x80,
+    0x03, 0x00, 0xC0,
+    0x0F, 0x00, 0xC0,
+    0x3E, 0x00, 0x40,
+    0x30, 0x00, 0x78,
+    0x60, 0x00, 0x7C,
+    0x60, 0x00, 0x0E,
+    0x60, 0x60, 0x06,
+    0x66, 0x60, 0x06,
+    0x37, 0xE0, 0x0E,
+    0x33, 0xFC, 0x3C,
+    0x03, 0xFD, 0xB8,
+    0x0F, 0xF1, 0xC0,
+    0x0F, 0xF3, 0xC0,
+    0x01, 0xFB, 0xE0,
+    0x01, 0x9B, 0xC0,
+    0x01, 0x81, 0xC0,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-lightning
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x1F, 0xC0,
+    0x00, 0x3F, 0xF0,
+    0x00, 0x7F, 0xF0,
+    0x00, 0xFF, 0xF8,
+    0x04, 0xFF, 0xF8,
+    0x0C, 0xFF, 0xFC,
+    0x1D, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xF8,
+    0x3F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF0,
+    0x0F, 0xFF, 0xE0,
+    0x03, 0xFF, 0x00,
+    0x00, 0x30, 0x00,
+    0x00, 0x20, 0x00,
+    0x00, 0x7C, 0x00,
+    0x00, 0x1C, 0x00,
+    0x00, 0x08, 0x00,
+    0x00, 0x18, 0x00,
+    0x00, 0x10, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-haze
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x18, 0x00,
+    0x00, 0x3C, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x0E, 0x3C, 0x70,
+    0x0C, 0x7E, 0x30,
+    0x00, 0xC3, 0x00,
+    0x01, 0x81, 0x80,
+    0x01, 0x81, 0x80,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x3F, 0xFC, 0xFC,
+    0x3F, 0xFC, 0xFC,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x1F, 0x3F, 0xF8,
+    0x1F, 0x3F, 0xF8,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-dust
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x03, 0xFF, 0x40,
+    0x00, 0x00, 0x00,
+    0x00, 0xBD, 0x80,
+    0x00, 0x3D, 0x80,
+    0x00, 0x00, 0x00,
+    0x03, 0xFF, 0xC0,
+    0x00, 0x00, 0x00,
+    0x01, 0x7B, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-smoke
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x7C, 0x00,
+    0x00, 0xC6, 0x00,
+    0x01, 0x82, 0x00,
+    0x03, 0x03, 0xC0,
+    0x06, 0x00, 0x40,
+    0x04, 0x00, 0x60,
+    0x04, 0x00, 0x20,
+    0x06, 0x00, 0x40,
+    0x03, 0xC0, 0xC0,
+    0x00, 0x64, 0x80,
+    0x00, 0x3F, 0x00,
+    0x00, 0x3E, 0x00,
+    0x00, 0x1C, 0x00,
+    0x00, 0x0C, 0x00,
+    0x00, 0x0C, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-hurricane
+    0x00, 0x07, 0x00,
+    0x00, 0x1E, 0x00,
+    0x00, 0x7E, 0x00,
+    0x00, 0xFE, 0x00,
+    0x01, 0xFE, 0x00,
+    0x03, 0xFF, 0x80,
+    0x07, 0xFF, 0xC0,
+    0x07, 0xFF, 0xE0,
+    0x0F, 0xFF, 0xE0,
+    0x0F, 0xFF, 0xF0,
+    0x0F, 0xC3, 0xF0,
+    0x0F, 0xC3, 0xF0,
+    0x0F, 0xC3, 0xF0,
+    0x0F, 0xC3, 0xF0,
+    0x0F, 0xFF, 0xF0,
+    0x07, 0xFF, 0xF0,
+    0x07, 0xFF, 0xE0,
+    0x03, 0xFF, 0xE0,
+    0x01, 0xFF, 0xC0,
+    0x00, 0x7F, 0x80,
+    0x00, 0x7F, 0x00,
+    0x00, 0x7E, 0x00,
+    0x00, 0x78, 0x00,
+    0x00, 0xC0, 0x00,
+    // weather-tornado
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x07, 0xFF, 0xF8,
+    0x07, 0xFF, 0xFC,
+    0x03, 0xFE, 0x00,
+    0x01, 0xFC, 0x00,
+    0x03, 0xFE, 0x00,
+    0x1F, 0xFF, 0x00,
+    0x0F, 0xFF, 0x00,
+    0x00, 0xFC, 0x00,
+    0x00, 0xFE, 0x00,
+    0x03, 0xFF, 0xC0,
+    0x03, 0xFF, 0xE0,
+    0x00, 0x0F, 0x00,
+    0x00, 0x06, 0x00,
+    0x00, 0x0F, 0x00,
+    0x00, 0x1F, 0x80,
+    0x00, 0x1F, 0x80,
+    0x00, 0x00, 0x00,
+    0x00, 0x38, 0x00,
+    0x00, 0x38, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-night
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x60, 0x00,
+    0x01, 0xE0, 0x00,
+    0x03, 0xE0, 0x00,
+    0x07, 0xC0, 0x00,
+    0x0F, 0xE0, 0x00,
+    0x0F, 0xE0, 0x00,
+    0x1F, 0xE0, 0x00,
+    0x1F, 0xF0, 0x00,
+    0x1F, 0xF0, 0x00,
+    0x1F, 0xF8, 0x00,
+    0x1F, 0xFE, 0x00,
+    0x1F, 0xFF, 0xCC,
+    0x0F, 0xFF, 0xFC,
+    0x0F, 0xFF, 0xF8,
+    0x07, 0xFF, 0xF8,
+    0x07, 0xFF, 0xF0,
+    0x03, 0xFF, 0xE0,
+    0x00, 0xFF, 0xC0,
+    0x00, 0x3F, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-night-partly-cloudy
+    0x00, 0x00, 0x00,
+    0x00, 0x60, 0x00,
+    0x00, 0x78, 0x00,
+    0x00, 0x4C, 0x00,
+    0x00, 0x44, 0x00,
+    0x00, 0xC6, 0x00,
+    0x00, 0x86, 0x00,
+    0x03, 0x87, 0xE0,
+    0x3F, 0x1F, 0xF8,
+    0x3C, 0x1F, 0xFC,
+    0x30, 0x3F, 0xFC,
+    0x19, 0xFF, 0xFE,
+    0x0F, 0xFF, 0xFE,
+    0x0F, 0xFF, 0xFE,
+    0x0F, 0xFF, 0xFE,
+    0x0F, 0xFF, 0xFE,
+    0x0F, 0xFF, 0xFE,
+    0x0F, 0xFF, 0xFC,
+    0x0F, 0xFF, 0xFC,
+    0x07, 0xFF, 0xF0,
+    0x01, 0xFF, 0xE0,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // weather-windy-variant
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x78, 0x00,
+    0x00, 0xFC, 0x00,
+    0x00, 0xFC, 0x00,
+    0x00, 0x1C, 0x38,
+    0x3F, 0xFC, 0x7C,
+    0x3F, 0xF0, 0x7E,
+    0x00, 0x00, 0x1C,
+    0x1F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xF8,
+    0x00, 0x00, 0x00,
+    0x1F, 0xFE, 0x00,
+    0x1F, 0xFF, 0x80,
+    0x00, 0x03, 0x80,
+    0x00, 0x1F, 0x80,
+    0x00, 0x1F, 0x80,
+    0x00, 0x0F, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-new
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x7E, 0x00,
+    0x01, 0xFF, 0x80,
+    0x03, 0x81, 0xC0,
+    0x06, 0x00, 0x60,
+    0x0C, 0x00, 0x30,
+    0x18, 0x00, 0x18,
+    0x18, 0x00, 0x18,
+    0x30, 0x00, 0x0C,
+    0x30, 0x00, 0x0C,
+    0x30, 0x00, 0x0C,
+    0x30, 0x00, 0x0C,
+    0x30, 0x00, 0x0C,
+    0x30, 0x00, 0x0C,
+    0x18, 0x00, 0x18,
+    0x18, 0x00, 0x18,
+    0x0C, 0x00, 0x30,
+    0x06, 0x00, 0x60,
+    0x03, 0x81, 0xC0,
+    0x01, 0xFF, 0x80,
+    0x00, 0x7E, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-waxing-crescent
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x3E, 0x00,
+    0x00, 0x1F, 0x80,
+    0x00, 0x07, 0xC0,
+    0x00, 0x03, 0xE0,
+    0x00, 0x03, 0xF0,
+    0x00, 0x01, 0xF8,
+    0x00, 0x01, 0xF8,
+    0x00, 0x00, 0xFC,
+    0x00, 0x00, 0xFC,
+    0x00, 0x00, 0xFC,
+    0x00, 0x00, 0xFC,
+    0x00, 0x00, 0xFC,
+    0x00, 0x00, 0xFC,
+    0x00, 0x01, 0xF8,
+    0x00, 0x01, 0xF8,
+    0x00, 0x03, 0xF0,
+    0x00, 0x03, 0xE0,
+    0x00, 0x07, 0xC0,
+    0x00, 0x1F, 0x80,
+    0x00, 0x3E, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-first-quarter
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x0E, 0x00,
+    0x00, 0x0F, 0x80,
+    0x00, 0x0F, 0xC0,
+    0x00, 0x0F, 0xE0,
+    0x00, 0x0F, 0xF0,
+    0x00, 0x0F, 0xF8,
+    0x00, 0x0F, 0xF8,
+    0x00, 0x0F, 0xFC,
+    0x00, 0x0F, 0xFC,
+    0x00, 0x0F, 0xFC,
+    0x00, 0x0F, 0xFC,
+    0x00, 0x0F, 0xFC,
+    0x00, 0x0F, 0xFC,
+    0x00, 0x0F, 0xF8,
+    0x00, 0x0F, 0xF8,
+    0x00, 0x0F, 0xF0,
+    0x00, 0x0F, 0xE0,
+    0x00, 0x0F, 0xC0,
+    0x00, 0x0F, 0x80,
+    0x00, 0x0E, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-waxing-gibbous
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x1E, 0x00,
+    0x00, 0x7F, 0x80,
+    0x00, 0xFF, 0xC0,
+    0x00, 0xFF, 0xE0,
+    0x01, 0xFF, 0xF0,
+    0x01, 0xFF, 0xF8,
+    0x01, 0xFF, 0xF8,
+    0x03, 0xFF, 0xFC,
+    0x03, 0xFF, 0xFC,
+    0x03, 0xFF, 0xFC,
+    0x03, 0xFF, 0xFC,
+    0x03, 0xFF, 0xFC,
+    0x03, 0xFF, 0xFC,
+    0x01, 0xFF, 0xF8,
+    0x01, 0xFF, 0xF8,
+    0x01, 0xFF, 0xF0,
+    0x00, 0xFF, 0xE0,
+    0x00, 0xFF, 0xC0,
+    0x00, 0x7F, 0x80,
+    0x00, 0x1E, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-full
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x7E, 0x00,
+    0x01, 0xFF, 0x80,
+    0x03, 0xFF, 0xC0,
+    0x07, 0xFF, 0xE0,
+    0x0F, 0xFF, 0xF0,
+    0x1F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF8,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x3F, 0xFF, 0xFC,
+    0x1F, 0xFF, 0xF8,
+    0x1F, 0xFF, 0xF8,
+    0x0F, 0xFF, 0xF0,
+    0x07, 0xFF, 0xE0,
+    0x03, 0xFF, 0xC0,
+    0x01, 0xFF, 0x80,
+    0x00, 0x7E, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-waning-gibbous
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x78, 0x00,
+    0x01, 0xFE, 0x00,
+    0x03, 0xFF, 0x00,
+    0x07, 0xFF, 0x00,
+    0x0F, 0xFF, 0x80,
+    0x1F, 0xFF, 0x80,
+    0x1F, 0xFF, 0x80,
+    0x3F, 0xFF, 0xC0,
+    0x3F, 0xFF, 0xC0,
+    0x3F, 0xFF, 0xC0,
+    0x3F, 0xFF, 0xC0,
+    0x3F, 0xFF, 0xC0,
+    0x3F, 0xFF, 0xC0,
+    0x1F, 0xFF, 0x80,
+    0x1F, 0xFF, 0x80,
+    0x0F, 0xFF, 0x80,
+    0x07, 0xFF, 0x00,
+    0x03, 0xFF, 0x00,
+    0x01, 0xFE, 0x00,
+    0x00, 0x78, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-last-quarter
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x70, 0x00,
+    0x01, 0xF0, 0x00,
+    0x03, 0xF0, 0x00,
+    0x07, 0xF0, 0x00,
+    0x0F, 0xF0, 0x00,
+    0x1F, 0xF0, 0x00,
+    0x1F, 0xF0, 0x00,
+    0x3F, 0xF0, 0x00,
+    0x3F, 0xF0, 0x00,
+    0x3F, 0xF0, 0x00,
+    0x3F, 0xF0, 0x00,
+    0x3F, 0xF0, 0x00,
+    0x3F, 0xF0, 0x00,
+    0x1F, 0xF0, 0x00,
+    0x1F, 0xF0, 0x00,
+    0x0F, 0xF0, 0x00,
+    0x07, 0xF0, 0x00,
+    0x03, 0xF0, 0x00,
+    0x01, 0xF0, 0x00,
+    0x00, 0x70, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    // moon-waning-crescent
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x7C, 0x00,
+    0x01, 0xF8, 0x00,
+    0x03, 0xE0, 0x00,
+    0x07, 0xC0, 0x00,
+    0x0F, 0xC0, 0x00,
+    0x1F, 0x80, 0x00,
+    0x1F, 0x80, 0x00,
+    0x3F, 0x00, 0x00,
+    0x3F, 0x00, 0x00,
+    0x3F, 0x00, 0x00,
+    0x3F, 0x00, 0x00,
+    0x3F, 0x00, 0x00,
+    0x3F, 0x00, 0x00,
+    0x1F, 0x80, 0x00,
+    0x1F, 0x80, 0x00,
+    0x0F, 0xC0, 0x00,
+    0x07, 0xC0, 0x00,
+    0x03, 0xE0, 0x00,
+    0x01, 0xF8, 0x00,
+    0x00, 0x7C, 0x00,
+    0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
+};
+
+inline const uint8_t* icon_atlas_bits(IconId id) {
+    return (unsigned)id < ICON_COUNT
+        ? icon_atlas + (size_t)id * ICON_ATLAS_STRIDE : nullptr;
+}
+
+template<typename GFX>
+inline void draw_icon_atlas(GFX& d, int16_t x, int16_t y,
+    IconId id, uint16_t color) {
+    const uint8_t* bits = icon_atlas_bits(id);
+    if (bits) d.drawBitmap(x, y, bits, ICON_W, ICON_H, color);
+}
+
 template<typename GFX>
 inline void draw_icon_xbm(GFX& d, int16_t x, int16_t y,
     IconId id, uint16_t color) {
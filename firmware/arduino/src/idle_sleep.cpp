@@ -0,0 +1,51 @@
+// Idle light sleep implementation
+
+#include "idle_sleep.h"
+#include "feature_flags.h"
+#include "config.h"
+#include "cpu_freq.h"
+#include "mqtt_client.h"
+#include "wifi_manager.h"
+#include <Arduino.h>
+#include <WiFi.h>
+
+static bool g_begun = false;
+
+void idle_sleep_begin() {
+  if (g_begun) return;
+  g_begun = true;
+
+  #if FEATURE_IDLE_LIGHT_SLEEP
+  if (WiFi.getMode() != WIFI_MODE_NULL) wifi_configure_power_save(true);
+  CPU_PHASE(WAIT);
+
+  bool light_sleep = false;
+  #if ARDUINO_USB_CDC_ON_BOOT
+  if (!Serial) light_sleep = cpu_freq_light_sleep(true);
+  #else
+  light_sleep = cpu_freq_light_sleep(true);
+  #endif
+  Serial.printf("[Idle] Blocking between events%s\n",
+                light_sleep ? " with automatic light sleep" : "");
+  #endif
+}
+
+uint32_t idle_sleep_wait(uint32_t timeout_ms) {
+  uint32_t start = millis();
+
+  #if FEATURE_IDLE_LIGHT_SLEEP
+  if (timeout_ms > IDLE_WAIT_MAX_MS) timeout_ms = IDLE_WAIT_MAX_MS;
+  // With no USB host nobody can type, so one wait covers the whole timeout
+  uint32_t slice = (bool)Serial ? IDLE_SERIAL_POLL_MS : timeout_ms;
+
+  while (millis() - start < timeout_ms) {
+    if (Serial.available()) break;
+    uint32_t remaining = timeout_ms - (millis() - start);
+    if (mqtt_wait_for_data(remaining < slice ? remaining : slice)) break;
+  }
+  #else
+  delay(100);  // Small delay to prevent watchdog issues
+  #endif
+
+  return millis() - start;
+}
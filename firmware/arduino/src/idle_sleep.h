@@ -0,0 +1,24 @@
+#pragma once
+// Idle light sleep for the always-on loops (FEATURE_IDLE_LIGHT_SLEEP)
+// DEV_NO_SLEEP builds and diagnostic mode stay awake in app_loop(). Instead of
+// spinning on delay(100) they block on the broker socket until MQTT data
+// arrives or the next periodic job is due. Meanwhile WiFi sleeps between DTIM
+// beacons (the AP buffers broker traffic) and, in builds with tickless idle,
+// esp_pm light-sleeps the chip for as long as every task is blocked. The
+// broker session stays up: the loop still runs well inside the keepalive.
+//
+// Serial input can't wake a socket wait, so while a console is attached the
+// wait is sliced at IDLE_SERIAL_POLL_MS; light sleep is left off when a USB
+// host holds the port, since it would drop the CDC link.
+//
+// Usage:
+//   idle_sleep_begin();                        // Once, entering the always-on loop
+//   net_loop();
+//   idle_sleep_wait(ms_until_next_job);        // Returns early on MQTT or serial input
+
+#include <stdint.h>
+
+void idle_sleep_begin();
+
+// Block up to timeout_ms (capped at IDLE_WAIT_MAX_MS); returns the ms waited
+uint32_t idle_sleep_wait(uint32_t timeout_ms);
@@ -0,0 +1,103 @@
+// Inside rolling aggregates implementation
+#include "inside_stats.h"
+#include "config.h"
+#include "feature_flags.h"
+
+#if FEATURE_INSIDE_STATS
+#include "rtc_state.h"
+#include <time.h>
+
+static_assert(INSIDE_STATS_SHORT_WINDOW_SEC >= ROLLING_SHORT_BUCKETS, "short stats window too small");
+static_assert(INSIDE_STATS_LONG_WINDOW_SEC >= ROLLING_LONG_BUCKETS, "long stats window too small");
+
+static constexpr uint32_t SHORT_SPAN_SEC = INSIDE_STATS_SHORT_WINDOW_SEC / ROLLING_SHORT_BUCKETS;
+static constexpr uint32_t LONG_SPAN_SEC = INSIDE_STATS_LONG_WINDOW_SEC / ROLLING_LONG_BUCKETS;
+
+static bool g_recorded = false;
+
+static bool clock_now(uint32_t& now) {
+  time_t t = time(nullptr);
+  if (t < (time_t)NTP_MIN_VALID_EPOCH) return false;
+  now = (uint32_t)t;
+  return true;
+}
+
+void inside_stats_record(const InsideReadings& r) {
+  if (g_recorded) return;
+  uint32_t now;
+  if (!clock_now(now)) return;
+  rolling_push(g_rtc_state.stats_short, now, SHORT_SPAN_SEC,
+               r.temperatureC, r.humidityPct, r.pressureHPa);
+  rolling_push(g_rtc_state.stats_long, now, LONG_SPAN_SEC,
+               r.temperatureC, r.humidityPct, r.pressureHPa);
+  g_recorded = true;
+}
+
+bool inside_stats_get(InsideStatsWindow window, uint8_t qty, RollingSummary& out) {
+  uint32_t now;
+  if (!clock_now(now)) return false;
+  return window == INSIDE_STATS_SHORT ? rolling_summary(g_rtc_state.stats_short, now, qty, out)
+                                      : rolling_summary(g_rtc_state.stats_long, now, qty, out);
+}
+
+// "1h", "24h", "90m" or "45s"
+static void window_label(uint32_t sec, char* out, size_t out_size) {
+  if (sec % 3600 == 0) snprintf(out, out_size, "%luh", (unsigned long)(sec / 3600));
+  else if (sec % 60 == 0) snprintf(out, out_size, "%lum", (unsigned long)(sec / 60));
+  else snprintf(out, out_size, "%lus", (unsigned long)sec);
+}
+
+// "label":{"t":[lo,hi,mean],...,"n":k}; returns chars appended, 0 if empty
+static size_t format_window(InsideStatsWindow window, uint32_t window_sec, bool first,
+                            char* out, size_t out_size) {
+  static const char* const kKeys[ROLL__COUNT] = {"t", "rh", "p"};
+  static const char* const kFormats[ROLL__COUNT] = {
+    "%s\"%s\":[%.1f,%.1f,%.2f]",
+    "%s\"%s\":[%.0f,%.0f,%.1f]",
+    "%s\"%s\":[%.1f,%.1f,%.2f]",
+  };
+
+  char label[12];
+  window_label(window_sec, label, sizeof(label));
+  size_t pos = 0;
+  int n = snprintf(out, out_size, "%s\"%s\":{", first ? "" : ",", label);
+  if (n < 0 || (size_t)n >= out_size) return 0;
+  pos = (size_t)n;
+
+  uint16_t samples = 0;
+  bool any = false;
+  for (uint8_t q = 0; q < ROLL__COUNT; q++) {
+    RollingSummary s;
+    if (!inside_stats_get(window, q, s)) continue;
+    n = snprintf(out + pos, out_size - pos, kFormats[q], any ? "," : "", kKeys[q], s.lo, s.hi, s.mean);
+    if (n < 0 || pos + (size_t)n >= out_size) return 0;
+    pos += (size_t)n;
+    if (s.n > samples) samples = s.n;
+    any = true;
+  }
+  if (!any) return 0;
+
+  n = snprintf(out + pos, out_size - pos, ",\"n\":%u}", samples);
+  if (n < 0 || pos + (size_t)n >= out_size) return 0;
+  return pos + (size_t)n;
+}
+
+size_t inside_stats_format_json(char* out, size_t out_size) {
+  if (!out || out_size < 3) return 0;
+  size_t pos = 1;
+  out[0] = '{';
+  size_t n = format_window(INSIDE_STATS_SHORT, INSIDE_STATS_SHORT_WINDOW_SEC, true,
+                           out + pos, out_size - pos - 1);
+  pos += n;
+  pos += format_window(INSIDE_STATS_LONG, INSIDE_STATS_LONG_WINDOW_SEC, n == 0,
+                       out + pos, out_size - pos - 1);
+  if (pos == 1) {
+    out[0] = '\0';
+    return 0;
+  }
+  out[pos++] = '}';
+  out[pos] = '\0';
+  return pos;
+}
+
+#endif // FEATURE_INSIDE_STATS
@@ -0,0 +1,39 @@
+#pragma once
+// On-device rolling aggregates of the inside readings (FEATURE_INSIDE_STATS)
+// Each wake's temperature, RH and pressure go into two RTC-resident bucket
+// rings (rolling_stats.h): a short window (INSIDE_STATS_SHORT_WINDOW_SEC,
+// 1 h) and a long one (INSIDE_STATS_LONG_WINDOW_SEC, 24 h). Low, high and
+// mean per window are published retained on espsensor/<id>/inside/stats
+// (folded into the packed state document in packed mode) and the long
+// window's high/low is drawn next to the inside label, so neither Home
+// Assistant nor the display needs the sample history.
+//
+// Samples need wall-clock time (NTP or the clock kept through deep sleep);
+// wakes without a valid clock are left out.
+//
+// Payload: {"1h":{"t":[20.4,21.2,20.8],"rh":[41,44,42.5],"p":[1012.3,1013.1,1012.7],"n":6},"24h":{...}}
+// ([low, high, mean]; a quantity with no samples in the window is omitted)
+//
+// Usage:
+//   inside_stats_record(readings);                 // Once per wake, sensor phase
+//   RollingSummary s;
+//   if (inside_stats_get(INSIDE_STATS_LONG, ROLL_TEMP, s)) ...
+//   inside_stats_format_json(buf, sizeof(buf));
+
+#include <stddef.h>
+#include "rolling_stats.h"
+#include "sensors.h"
+
+enum InsideStatsWindow : uint8_t {
+  INSIDE_STATS_SHORT = 0,
+  INSIDE_STATS_LONG
+};
+
+// Fold this wake's readings in (at most once per wake)
+void inside_stats_record(const InsideReadings& r);
+
+// Summary of one quantity over a window, as of now; false if it is empty
+bool inside_stats_get(InsideStatsWindow window, uint8_t qty, RollingSummary& out);
+
+// Both windows as JSON; returns the length, 0 if there is nothing to report
+size_t inside_stats_format_json(char* out, size_t out_size);
@@ -0,0 +1,201 @@
+#pragma once
+
+// Streaming JSON writer
+// Emits a document piecewise into a sink through a small chunk buffer, so a
+// response of any size needs constant memory. Commas and nesting are tracked
+// by the writer; strings are escaped. With no sink it only counts, which is
+// how a publish learns the length MQTT needs up front (mqtt_stream.h runs
+// the same emitter twice: count, then write).
+//
+// A writer given a limit never hands the sink more than limit bytes, and
+// finish() pads a shorter document with spaces up to it (trailing
+// whitespace is valid JSON), so the announced length is always met.
+//
+// Usage:
+//   JsonStream j(sink, ctx);
+//   j.beginObject().field("cmd", "perf").beginArray("stats");
+//   j.beginObject().field("name", s.name).field("count", s.count).endObject();
+//   j.endArray().endObject().finish();
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+class JsonStream {
+public:
+    // Returns how many bytes it took
+    typedef size_t (*Sink)(void* ctx, const char* data, size_t len);
+
+    static constexpr size_t CHUNK = 64;
+    static constexpr size_t NO_LIMIT = (size_t)-1;
+
+    // Counting pass: nothing is written, length() is what would be
+    JsonStream() : JsonStream(nullptr, nullptr, NO_LIMIT) {}
+
+    JsonStream(Sink sink, void* ctx, size_t limit = NO_LIMIT)
+        : sink_(sink), ctx_(ctx), limit_(limit) {}
+
+    JsonStream& beginObject(const char* key = nullptr) { return open(key, '{'); }
+    JsonStream& endObject() { return close('}'); }
+    JsonStream& beginArray(const char* key = nullptr) { return open(key, '['); }
+    JsonStream& endArray() { return close(']'); }
+
+    // key is nullptr for array elements
+    JsonStream& field(const char* key, const char* value) {
+        prefix(key);
+        if (!value) return put("null");
+        put('"');
+        escaped(value);
+        return put('"');
+    }
+
+    JsonStream& field(const char* key, bool value) {
+        prefix(key);
+        return put(value ? "true" : "false");
+    }
+
+    JsonStream& field(const char* key, int value) { return number(key, "%d", value); }
+    JsonStream& field(const char* key, unsigned value) { return number(key, "%u", value); }
+    JsonStream& field(const char* key, long value) { return number(key, "%ld", value); }
+    JsonStream& field(const char* key, unsigned long value) { return number(key, "%lu", value); }
+
+    // Non-finite values are written as null
+    JsonStream& field(const char* key, double value, int decimals = 1) {
+        if (!std::isfinite(value)) return fieldNull(key);
+        return number(key, "%.*f", decimals, value);
+    }
+
+    JsonStream& fieldNull(const char* key) {
+        prefix(key);
+        return put("null");
+    }
+
+    // Value that is already JSON
+    JsonStream& fieldRaw(const char* key, const char* json) {
+        prefix(key);
+        return put(json ? json : "null");
+    }
+
+    // Splice the members of a formatted object ("{...}") into the open object
+    JsonStream& members(const char* object_json) {
+        if (!object_json) return *this;
+        const char* b = object_json;
+        while (*b == ' ') b++;
+        if (*b == '{') b++;
+        const char* e = b + strlen(b);
+        while (e > b && (e[-1] == ' ' || e[-1] == '\n')) e--;
+        if (e > b && e[-1] == '}') e--;
+        if (e == b) return *this;
+        prefix(nullptr);
+        return write(b, (size_t)(e - b));
+    }
+
+    // Flush, padding up to the limit; returns the document length
+    size_t finish() {
+        if (limit_ != NO_LIMIT) {
+            while (len_ < limit_) put(' ');
+        }
+        flush();
+        return len_;
+    }
+
+    // Bytes emitted (or counted) so far
+    size_t length() const { return len_; }
+    // Bytes the sink accepted
+    size_t written() const { return written_; }
+    // The document ran past the limit and was cut
+    bool overflowed() const { return overflow_; }
+
+private:
+    Sink sink_;
+    void* ctx_;
+    size_t limit_;
+    size_t len_ = 0;
+    size_t written_ = 0;
+    size_t fill_ = 0;
+    uint32_t has_member_ = 0;     // Bit per nesting level
+    uint8_t depth_ = 0;
+    bool overflow_ = false;
+    char buf_[CHUNK];
+
+    static constexpr uint8_t MAX_DEPTH = 31;
+
+    JsonStream& open(const char* key, char c) {
+        prefix(key);
+        put(c);
+        if (depth_ < MAX_DEPTH) depth_++;
+        has_member_ &= ~(1u << depth_);
+        return *this;
+    }
+
+    JsonStream& close(char c) {
+        if (depth_ > 0) depth_--;
+        return put(c);
+    }
+
+    // Comma before every member after the first, then "key":
+    void prefix(const char* key) {
+        uint32_t bit = 1u << depth_;
+        if (has_member_ & bit) put(',');
+        has_member_ |= bit;
+        if (key) {
+            put('"');
+            escaped(key);
+            put("\":");
+        }
+    }
+
+    template <typename... Args>
+    JsonStream& number(const char* key, const char* fmt, Args... args) {
+        char tmp[32];
+        int n = snprintf(tmp, sizeof(tmp), fmt, args...);
+        prefix(key);
+        if (n < 0) return put("null");
+        return write(tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+    }
+
+    void escaped(const char* s) {
+        for (; *s; s++) {
+            unsigned char c = (unsigned char)*s;
+            if (c == '"' || c == '\\') {
+                put('\\');
+                put((char)c);
+            } else if (c < 0x20) {
+                char tmp[8];
+                snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+                put(tmp);
+            } else {
+                put((char)c);
+            }
+        }
+    }
+
+    JsonStream& put(const char* s) { return write(s, strlen(s)); }
+
+    JsonStream& put(char c) { return write(&c, 1); }
+
+    JsonStream& write(const char* data, size_t n) {
+        if (limit_ != NO_LIMIT && len_ + n > limit_) {
+            overflow_ = true;
+            n = limit_ - len_;
+        }
+        len_ += n;
+        if (!sink_) return *this;
+        while (n > 0) {
+            size_t take = CHUNK - fill_ < n ? CHUNK - fill_ : n;
+            memcpy(buf_ + fill_, data, take);
+            fill_ += take;
+            data += take;
+            n -= take;
+            if (fill_ == CHUNK) flush();
+        }
+        return *this;
+    }
+
+    void flush() {
+        if (sink_ && fill_ > 0) written_ += sink_(ctx_, buf_, fill_);
+        fill_ = 0;
+    }
+};
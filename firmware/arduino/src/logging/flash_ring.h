@@ -0,0 +1,241 @@
+#pragma once
+
+// Append-only circular log on raw flash
+// A dedicated partition is split into 4 KB sectors used strictly round-robin,
+// so every sector sees the same number of erases. Each sector starts with a
+// CRC'd header carrying a monotonic sequence number; records are appended
+// behind it with their own CRC, so a record torn by a reset is skipped on
+// readback instead of corrupting the rest. When the active sector is full,
+// the next (oldest) one is erased and takes the next sequence number. Reads go
+// through a memory-mapped view of the partition and hand out pointers into
+// it, so iterating the log copies nothing.
+//
+// Usage:
+//   FlashRingIo io = {ctx, write_fn, erase_fn, mapped_base, partition_size};
+//   FlashRing ring;
+//   ring.begin(io);                        // Scan, or format if empty
+//   ring.append(&entry, sizeof(entry));
+//   ring.forEach([](const uint8_t* p, uint16_t len) { ...; return true; });
+//
+// The I/O hooks exist so the ring can be tested against a RAM-backed NOR
+// emulation; on the device they are esp_partition_write/erase_range and the
+// view comes from esp_partition_mmap.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static constexpr uint32_t FLASH_RING_SECTOR = 4096;
+static constexpr uint32_t FLASH_RING_SECTOR_MAGIC = 0x31474C46;  // "FLG1"
+static constexpr uint16_t FLASH_RING_RECORD_DATA = 0x4C44;       // "DL"
+static constexpr uint16_t FLASH_RING_RECORD_CLEAR = 0x4C43;      // "CL": hides older records
+static constexpr uint16_t FLASH_RING_ERASED16 = 0xFFFF;
+static constexpr uint16_t FLASH_RING_MAX_PAYLOAD = 256;
+
+struct FlashRingIo {
+    void* ctx;
+    bool (*write)(void* ctx, uint32_t offset, const void* data, size_t len);
+    bool (*erase)(void* ctx, uint32_t offset, size_t len);   // Sector-aligned
+    const uint8_t* base;                                      // Mapped view for reads
+    uint32_t size;                                            // Multiple of FLASH_RING_SECTOR
+};
+
+struct FlashRingSectorHeader {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t reserved;      // Left erased
+    uint32_t crc;           // Over magic + seq
+};
+
+struct FlashRingRecordHeader {
+    uint16_t kind;          // FLASH_RING_RECORD_*, 0xFFFF = end of sector data
+    uint16_t len;           // Payload bytes
+    uint32_t crc;           // Over the payload
+};
+
+inline uint32_t flash_ring_crc32(const uint8_t* data, size_t len, uint32_t crc = 0xFFFFFFFFu) {
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return crc;
+}
+
+inline uint32_t flash_ring_record_size(uint16_t len) {
+    return (uint32_t)((sizeof(FlashRingRecordHeader) + len + 3u) & ~3u);
+}
+
+class FlashRing {
+public:
+    // Scan the region; formats the first sector if none is valid
+    bool begin(const FlashRingIo& io) {
+        ready_ = false;
+        if (!io.base || !io.write || !io.erase || io.size < 2 * FLASH_RING_SECTOR) return false;
+        io_ = io;
+        sectors_ = io.size / FLASH_RING_SECTOR;
+
+        bool found = false;
+        for (uint32_t s = 0; s < sectors_; s++) {
+            uint32_t seq;
+            if (!sectorValid(s, seq)) continue;
+            if (!found || (int32_t)(seq - active_seq_) > 0) {
+                active_ = s;
+                active_seq_ = seq;
+                found = true;
+            }
+        }
+        if (!found) {
+            if (!startSector(0, 1)) return false;
+        } else {
+            write_off_ = endOfData(active_);
+        }
+        ready_ = true;
+        return true;
+    }
+
+    bool ready() const { return ready_; }
+
+    // Append one record; false on I/O failure or an oversized payload
+    bool append(const void* data, uint16_t len) {
+        return appendRecord(FLASH_RING_RECORD_DATA, data, len);
+    }
+
+    // Hide everything written so far (one small record, no erases)
+    bool clear() {
+        return appendRecord(FLASH_RING_RECORD_CLEAR, nullptr, 0);
+    }
+
+    // Visit data records oldest first with pointers into the mapped view;
+    // records failing their CRC are skipped. fn returns false to stop.
+    template <typename Fn>
+    size_t forEach(Fn fn) const {
+        if (!ready_) return 0;
+        // Start after the newest clear marker
+        uint32_t start_sector = 0, start_off = 0;
+        bool have_clear = false;
+        walk([&](uint32_t order, uint32_t off, const FlashRingRecordHeader& h, const uint8_t*) {
+            if (h.kind == FLASH_RING_RECORD_CLEAR) {
+                start_sector = order;
+                start_off = off;
+                have_clear = true;
+            }
+            return true;
+        });
+        size_t visited = 0;
+        walk([&](uint32_t order, uint32_t off, const FlashRingRecordHeader& h, const uint8_t* payload) {
+            if (have_clear && (order < start_sector || (order == start_sector && off <= start_off)))
+                return true;
+            if (h.kind != FLASH_RING_RECORD_DATA) return true;
+            if (flash_ring_crc32(payload, h.len) != h.crc) return true;
+            visited++;
+            return fn(payload, h.len);
+        });
+        return visited;
+    }
+
+    size_t count() const {
+        return forEach([](const uint8_t*, uint16_t) { return true; });
+    }
+
+    uint32_t sectorCount() const { return sectors_; }
+    uint32_t activeSector() const { return active_; }
+    uint32_t activeSequence() const { return active_seq_; }
+
+private:
+    FlashRingIo io_ = {};
+    uint32_t sectors_ = 0;
+    uint32_t active_ = 0;
+    uint32_t active_seq_ = 0;
+    uint32_t write_off_ = 0;        // Within the active sector
+    bool ready_ = false;
+
+    const uint8_t* sectorBase(uint32_t s) const { return io_.base + s * FLASH_RING_SECTOR; }
+
+    static uint32_t headerCrc(const FlashRingSectorHeader& h) {
+        return flash_ring_crc32((const uint8_t*)&h, sizeof(h.magic) + sizeof(h.seq));
+    }
+
+    bool sectorValid(uint32_t s, uint32_t& seq) const {
+        FlashRingSectorHeader h;
+        memcpy(&h, sectorBase(s), sizeof(h));
+        if (h.magic != FLASH_RING_SECTOR_MAGIC || h.crc != headerCrc(h)) return false;
+        seq = h.seq;
+        return true;
+    }
+
+    bool startSector(uint32_t s, uint32_t seq) {
+        if (!io_.erase(io_.ctx, s * FLASH_RING_SECTOR, FLASH_RING_SECTOR)) return false;
+        FlashRingSectorHeader h;
+        memset(&h, 0xFF, sizeof(h));
+        h.magic = FLASH_RING_SECTOR_MAGIC;
+        h.seq = seq;
+        h.crc = headerCrc(h);
+        if (!io_.write(io_.ctx, s * FLASH_RING_SECTOR, &h, sizeof(h))) return false;
+        active_ = s;
+        active_seq_ = seq;
+        write_off_ = sizeof(FlashRingSectorHeader);
+        return true;
+    }
+
+    // Offset of the first unwritten byte; a garbled header ends the sector
+    uint32_t endOfData(uint32_t s) const {
+        uint32_t off = sizeof(FlashRingSectorHeader);
+        while (off + sizeof(FlashRingRecordHeader) <= FLASH_RING_SECTOR) {
+            FlashRingRecordHeader h;
+            memcpy(&h, sectorBase(s) + off, sizeof(h));
+            if (h.kind == FLASH_RING_ERASED16) return off;
+            if (!knownRecord(h, off)) return FLASH_RING_SECTOR;
+            off += flash_ring_record_size(h.len);
+        }
+        return FLASH_RING_SECTOR;
+    }
+
+    static bool knownRecord(const FlashRingRecordHeader& h, uint32_t off) {
+        if (h.kind != FLASH_RING_RECORD_DATA && h.kind != FLASH_RING_RECORD_CLEAR) return false;
+        return h.len <= FLASH_RING_MAX_PAYLOAD && off + flash_ring_record_size(h.len) <= FLASH_RING_SECTOR;
+    }
+
+    // Visit every well-formed record, oldest sector first. fn receives the
+    // sector's position in age order (0 = oldest) and the record offset.
+    template <typename Fn>
+    void walk(Fn fn) const {
+        for (uint32_t order = 0; order < sectors_; order++) {
+            uint32_t s = (active_ + 1 + order) % sectors_;
+            uint32_t seq;
+            if (!sectorValid(s, seq)) continue;
+            // Round-robin allocation: anything newer than the active sector is stale
+            if ((int32_t)(seq - active_seq_) > 0) continue;
+            uint32_t off = sizeof(FlashRingSectorHeader);
+            uint32_t end = (s == active_) ? write_off_ : FLASH_RING_SECTOR;
+            while (off + sizeof(FlashRingRecordHeader) <= end) {
+                FlashRingRecordHeader h;
+                memcpy(&h, sectorBase(s) + off, sizeof(h));
+                if (h.kind == FLASH_RING_ERASED16 || !knownRecord(h, off)) break;
+                const uint8_t* payload = sectorBase(s) + off + sizeof(h);
+                if (!fn(order, off, h, payload)) return;
+                off += flash_ring_record_size(h.len);
+            }
+        }
+    }
+
+    bool appendRecord(uint16_t kind, const void* data, uint16_t len) {
+        if (!ready_ || len > FLASH_RING_MAX_PAYLOAD) return false;
+        uint32_t size = flash_ring_record_size(len);
+        if (write_off_ + size > FLASH_RING_SECTOR) {
+            if (!startSector((active_ + 1) % sectors_, active_seq_ + 1)) {
+                ready_ = false;
+                return false;
+            }
+        }
+
+        // Header and payload in one program operation; padding stays erased
+        uint8_t rec[sizeof(FlashRingRecordHeader) + FLASH_RING_MAX_PAYLOAD + 3];
+        memset(rec, 0xFF, size);
+        FlashRingRecordHeader h = {kind, len, flash_ring_crc32((const uint8_t*)data, data ? len : 0)};
+        memcpy(rec, &h, sizeof(h));
+        if (len) memcpy(rec + sizeof(h), data, len);
+        bool ok = io_.write(io_.ctx, active_ * FLASH_RING_SECTOR + write_off_, rec, size);
+        write_off_ += size;  // Never reprogram a possibly half-written slot
+        return ok;
+    }
+};
@@ -1,12 +1,19 @@
 #include "log_buffer.h"
 #include "metrics_diagnostics.h"
+#include <esp_ota_ops.h>
 
-RTC_DATA_ATTR LogEntry LogBuffer::buffer_[LogBuffer::BUFFER_SIZE];
-RTC_DATA_ATTR size_t LogBuffer::head_ = 0;
-RTC_DATA_ATTR size_t LogBuffer::tail_ = 0;
-RTC_DATA_ATTR size_t LogBuffer::count_ = 0;
-RTC_DATA_ATTR uint32_t LogBuffer::overflow_count_ = 0;
+RTC_DATA_ATTR LogRing<LogBuffer::BUFFER_SIZE> LogBuffer::ring_;
 RTC_DATA_ATTR bool LogBuffer::wrapped_ = false;
+RTC_DATA_ATTR uint32_t LogBuffer::image_tag_ = 0;
+
+// Identifies the running firmware image; deferred entries hold pointers into
+// its flash, so entries written by another image cannot be formatted
+static uint32_t current_image_tag() {
+    const esp_app_desc_t* desc = esp_ota_get_app_description();
+    uint32_t tag;
+    memcpy(&tag, desc->app_elf_sha256, sizeof(tag));
+    return tag;
+}
 
 // Guard against race condition in begin() - static ensures single initialization
 static volatile bool s_begin_in_progress = false;
@@ -30,167 +37,96 @@ void LogBuffer::begin() {
         return;
     }
     
-    mutex_ = xSemaphoreCreateMutex();
-    if (mutex_ == nullptr) {
-        // Mutex creation failed - cannot proceed safely
-        Serial.println("[LogBuffer] FATAL: Failed to create mutex");
-        s_begin_in_progress = false;
-        return;
-    }
-    
     if (!wrapped_) {
         // First boot - initialize to clean state
-        head_ = 0;
-        tail_ = 0;
-        count_ = 0;
-        overflow_count_ = 0;
+        log_ring_reset(ring_);
     } else {
         // Waking from deep sleep - validate RTC memory integrity
-        // Check that indices are within bounds (could be corrupted)
-        if (head_ >= BUFFER_SIZE || tail_ >= BUFFER_SIZE || count_ > BUFFER_SIZE) {
+        // The tail can never be ahead of the head (could be corrupted)
+        if ((int32_t)(ring_.head - ring_.tail) < 0) {
             Serial.println("[LogBuffer] WARN: RTC memory corruption detected, resetting");
             increment_error_stat("rtc_corruption");
-            head_ = 0;
-            tail_ = 0;
-            count_ = 0;
-            overflow_count_ = 0;
+            log_ring_reset(ring_);
             wrapped_ = false;
             // Note: We still proceed - the buffer is now in a safe state
         }
     }
     
-    // Success - mark as initialized
-    // Note: If we fail after mutex creation, we clean up the mutex
+    uint32_t tag = current_image_tag();
+    if (image_tag_ != tag) {
+        log_ring_reset(ring_);
+        wrapped_ = false;
+        image_tag_ = tag;
+    }
+    
     initialized_ = true;
     s_begin_in_progress = false;
 }
 
 void LogBuffer::end() {
-    if (!initialized_) return;
-    
-    if (mutex_) {
-        vSemaphoreDelete(mutex_);
-        mutex_ = nullptr;
-    }
-    
     initialized_ = false;
 }
 
+// Lock-free: safe from any task or ISR, never blocks
 bool LogBuffer::push(const LogEntry& entry) {
-    if (!initialized_ || mutex_ == nullptr) return false;
+    if (!initialized_) return false;
 
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return false;
-
-    return pushUnsafe(entry);
-}
-
-bool LogBuffer::pushUnsafe(const LogEntry& entry) {
-    buffer_[head_] = entry;
-    
-    head_ = (head_ + 1) % BUFFER_SIZE;
-    
-    if (count_ < BUFFER_SIZE) {
-        count_++;
-    } else {
-        tail_ = (tail_ + 1) % BUFFER_SIZE;
-        overflow_count_++;
+    if (log_ring_push(ring_, entry)) {
         wrapped_ = true;
     }
-    
     return true;
 }
 
 bool LogBuffer::pop(LogEntry& entry) {
-    if (!initialized_ || mutex_ == nullptr) return false;
-
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return false;
-
-    // Check isEmpty inside mutex to avoid race condition
-    if (count_ == 0) {
-        return false;
-    }
-
-    return popUnsafe(entry);
-}
-
-bool LogBuffer::popUnsafe(LogEntry& entry) {
-    if (count_ == 0) return false;
-    
-    entry = buffer_[tail_];
-    tail_ = (tail_ + 1) % BUFFER_SIZE;
-    count_--;
-    
-    return true;
+    if (!initialized_) return false;
+    return log_ring_pop(ring_, entry);
 }
 
 bool LogBuffer::getEntry(size_t index, LogEntry& entry) const {
-    if (!initialized_ || mutex_ == nullptr) return false;
-
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return false;
+    if (!initialized_) return false;
 
-    // Check index inside mutex to avoid race condition
-    if (index >= count_) {
+    // Snapshot the window once; a slot being rewritten reads as missing
+    uint32_t oldest = log_ring_oldest(ring_);
+    if (index >= (size_t)(log_ring_head(ring_) - oldest)) {
         return false;
     }
 
-    size_t actual_index = (tail_ + index) % BUFFER_SIZE;
-    entry = buffer_[actual_index];
-
-    return true;
+    return log_ring_read(ring_, oldest + (uint32_t)index, entry);
 }
 
 size_t LogBuffer::getCount() const {
-    if (!initialized_ || mutex_ == nullptr) return 0;
-
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return 0;
-
-    return count_;
+    if (!initialized_) return 0;
+    return log_ring_count(ring_);
 }
 
 bool LogBuffer::isFull() const {
-    if (!initialized_ || mutex_ == nullptr) return false;
-
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return false;
-
-    return count_ >= BUFFER_SIZE;
+    if (!initialized_) return false;
+    return log_ring_count(ring_) >= BUFFER_SIZE;
 }
 
 bool LogBuffer::isEmpty() const {
-    if (!initialized_ || mutex_ == nullptr) return true;
-
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return true;  // Fail-safe: assume empty if we can't get mutex
-
-    return count_ == 0;
+    if (!initialized_) return true;
+    return log_ring_count(ring_) == 0;
 }
 
 void LogBuffer::clear() {
-    if (!initialized_ || mutex_ == nullptr) return;
-
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return;
+    if (!initialized_) return;
 
-    head_ = 0;
-    tail_ = 0;
-    count_ = 0;
-    overflow_count_ = 0;
+    // Producers may still be running, so drop entries by moving the tail
+    // rather than wiping the slots
+    log_ring_discard(ring_);
+    ring_.overflow = 0;
     wrapped_ = false;
-    memset(buffer_, 0, sizeof(buffer_));
 }
 
 void LogBuffer::dump(void (*output_fn)(const LogEntry&)) {
-    if (!initialized_ || mutex_ == nullptr || !output_fn) return;
-
-    MutexGuard guard(mutex_);
-    if (!guard.acquired()) return;
+    if (!initialized_ || !output_fn) return;
 
-    for (size_t i = 0; i < count_; i++) {
-        size_t index = (tail_ + i) % BUFFER_SIZE;
-        output_fn(buffer_[index]);
+    LogEntry entry;
+    uint32_t head = log_ring_head(ring_);
+    for (uint32_t t = log_ring_oldest(ring_); t != head; t++) {
+        if (log_ring_read(ring_, t, entry)) {
+            output_fn(entry);
+        }
     }
-}
\ No newline at end of file
+}
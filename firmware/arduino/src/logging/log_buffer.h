@@ -1,35 +1,10 @@
 #pragma once
 
 #include "logger.h"
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-
-// RAII wrapper for FreeRTOS mutex
-class MutexGuard {
-public:
-    explicit MutexGuard(SemaphoreHandle_t mutex) : mutex_(mutex), acquired_(false) {
-        if (mutex_ && xSemaphoreTake(mutex_, portMAX_DELAY) == pdTRUE) {
-            acquired_ = true;
-        }
-    }
-
-    ~MutexGuard() {
-        if (acquired_ && mutex_) {
-            xSemaphoreGive(mutex_);
-        }
-    }
-
-    bool acquired() const { return acquired_; }
-
-    // Prevent copying
-    MutexGuard(const MutexGuard&) = delete;
-    MutexGuard& operator=(const MutexGuard&) = delete;
-
-private:
-    SemaphoreHandle_t mutex_;
-    bool acquired_;
-};
+#include "log_ring.h"
 
+// RTC-resident crash-log ring. push() is lock-free and never blocks, so it
+// may be called from any task or an ISR; readers are the logger task only.
 class LogBuffer {
 public:
     static constexpr size_t BUFFER_SIZE = 64;  // Reduced from 256 to fit in RTC memory
@@ -54,8 +29,8 @@ public:
     
     size_t getCapacity() const { return BUFFER_SIZE; }
     
-    uint32_t getOverflowCount() const { return overflow_count_; }
-    void resetOverflowCount() { overflow_count_ = 0; }
+    uint32_t getOverflowCount() const { return ring_.overflow; }
+    void resetOverflowCount() { ring_.overflow = 0; }
     
     void dump(void (*output_fn)(const LogEntry&));
     
@@ -65,16 +40,9 @@ private:
     LogBuffer(const LogBuffer&) = delete;
     LogBuffer& operator=(const LogBuffer&) = delete;
     
-    RTC_DATA_ATTR static LogEntry buffer_[BUFFER_SIZE];
-    RTC_DATA_ATTR static size_t head_;
-    RTC_DATA_ATTR static size_t tail_;
-    RTC_DATA_ATTR static size_t count_;
-    RTC_DATA_ATTR static uint32_t overflow_count_;
+    RTC_DATA_ATTR static LogRing<BUFFER_SIZE> ring_;
     RTC_DATA_ATTR static bool wrapped_;
+    RTC_DATA_ATTR static uint32_t image_tag_;  // Firmware image that wrote ring_
     
-    mutable SemaphoreHandle_t mutex_ = nullptr;
     bool initialized_ = false;
-    
-    bool pushUnsafe(const LogEntry& entry);
-    bool popUnsafe(LogEntry& entry);
 };
\ No newline at end of file
@@ -0,0 +1,268 @@
+#pragma once
+
+// Deferred log formatting
+// Instead of running vsnprintf on every log call, an entry can record the
+// format string pointer plus the raw argument bytes; the text is built only
+// when the entry is printed to Serial or shipped over MQTT. Capturing is a
+// scan of the format and a few stores per argument.
+//
+// Usage:
+//   va_list copy;
+//   va_copy(copy, args);
+//   if (!log_defer_capture(entry, format, copy)) {
+//       vsnprintf(entry.message, sizeof(entry.message), format, args);  // eager
+//   }
+//   va_end(copy);
+//   ...
+//   char text[128];
+//   log_entry_format(entry, text, sizeof(text));
+//
+// The format must have static storage (string literals, as the LOG_* macros
+// pass). %s arguments are copied into the entry, since the caller's buffer
+// is gone by the time the entry is printed. Conversions the capture does not
+// handle (%n, %L, wide strings) or arguments that do not fit return false so
+// the caller formats eagerly instead.
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "log_entry.h"
+
+enum LogArgKind : uint8_t {
+    LOG_ARG_NONE,       // %% (no argument)
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_STR,
+    LOG_ARG_INVALID     // Not supported by deferred capture
+};
+
+struct LogSpec {
+    const char* start;  // At the '%'
+    size_t len;         // Through the conversion character
+    bool star_width;
+    bool star_prec;
+    LogArgKind kind;
+};
+
+// Parse one conversion starting at '%'; returns the character after it
+inline const char* log_parse_spec(const char* p, LogSpec& spec) {
+    spec.start = p;
+    spec.star_width = spec.star_prec = false;
+    spec.kind = LOG_ARG_INVALID;
+    const char* q = p + 1;
+    while (*q && strchr("-+ #0", *q)) q++;
+    if (*q == '*') { spec.star_width = true; q++; }
+    else while (*q >= '0' && *q <= '9') q++;
+    if (*q == '.') {
+        q++;
+        if (*q == '*') { spec.star_prec = true; q++; }
+        else while (*q >= '0' && *q <= '9') q++;
+    }
+    char len = 0;  // 'H' = hh, 'Q' = ll
+    if (*q == 'h') { len = (q[1] == 'h') ? 'H' : 'h'; q += (len == 'H') ? 2 : 1; }
+    else if (*q == 'l') { len = (q[1] == 'l') ? 'Q' : 'l'; q += (len == 'Q') ? 2 : 1; }
+    else if (*q && strchr("jztL", *q)) { len = *q; q++; }
+    char conv = *q;
+    if (!conv) { spec.len = (size_t)(q - p); return q; }
+    q++;
+    spec.len = (size_t)(q - p);
+
+    switch (conv) {
+        case '%':
+            spec.kind = LOG_ARG_NONE;
+            break;
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            switch (len) {
+                case 0: case 'h': case 'H': spec.kind = LOG_ARG_INT; break;
+                case 'l': spec.kind = LOG_ARG_LONG; break;
+                case 'Q': case 'j': spec.kind = LOG_ARG_LLONG; break;
+                case 'z': spec.kind = LOG_ARG_SIZE; break;
+                case 't': spec.kind = LOG_ARG_PTRDIFF; break;
+                default: break;
+            }
+            break;
+        case 'c':
+            if (len == 0) spec.kind = LOG_ARG_INT;
+            break;
+        case 'f': case 'F': case 'e': case 'E':
+        case 'g': case 'G': case 'a': case 'A':
+            if (len == 0 || len == 'l') spec.kind = LOG_ARG_DOUBLE;
+            break;
+        case 'p':
+            if (len == 0) spec.kind = LOG_ARG_PTR;
+            break;
+        case 's':
+            if (len == 0) spec.kind = LOG_ARG_STR;
+            break;
+        default:
+            break;  // %n and unknown conversions
+    }
+    return q;
+}
+
+inline size_t log_arg_size(LogArgKind kind) {
+    switch (kind) {
+        case LOG_ARG_INT: return sizeof(int);
+        case LOG_ARG_LONG: return sizeof(long);
+        case LOG_ARG_LLONG: return sizeof(long long);
+        case LOG_ARG_SIZE: return sizeof(size_t);
+        case LOG_ARG_PTRDIFF: return sizeof(ptrdiff_t);
+        case LOG_ARG_DOUBLE: return sizeof(double);
+        case LOG_ARG_PTR: return sizeof(void*);
+        default: return 0;
+    }
+}
+
+// Record format + raw arguments into entry; false if the caller must format
+// eagerly (args is then in an indeterminate state, so pass a va_copy)
+inline bool log_defer_capture(LogEntry& entry, const char* format, va_list args) {
+    if (!format) return false;
+    uint8_t* out = entry.deferred.args;
+    size_t pos = 0;
+
+    for (const char* p = format; *p;) {
+        if (*p != '%') { p++; continue; }
+        LogSpec spec;
+        p = log_parse_spec(p, spec);
+        if (spec.kind == LOG_ARG_INVALID) return false;
+        if (spec.kind == LOG_ARG_NONE) continue;
+
+        for (int stars = spec.star_width + spec.star_prec; stars > 0; stars--) {
+            if (pos + sizeof(int) > LOG_ENTRY_ARG_BYTES) return false;
+            int v = va_arg(args, int);
+            memcpy(out + pos, &v, sizeof(v));
+            pos += sizeof(v);
+        }
+
+        if (spec.kind == LOG_ARG_STR) {
+            const char* s = va_arg(args, const char*);
+            if (!s) s = "(null)";
+            if (pos >= LOG_ENTRY_ARG_BYTES) return false;
+            size_t room = LOG_ENTRY_ARG_BYTES - pos - 1;
+            size_t n = strnlen(s, room);
+            memcpy(out + pos, s, n);
+            out[pos + n] = '\0';
+            pos += n + 1;
+            continue;
+        }
+
+        size_t size = log_arg_size(spec.kind);
+        if (pos + size > LOG_ENTRY_ARG_BYTES) return false;
+        switch (spec.kind) {
+            case LOG_ARG_INT: { int v = va_arg(args, int); memcpy(out + pos, &v, size); break; }
+            case LOG_ARG_LONG: { long v = va_arg(args, long); memcpy(out + pos, &v, size); break; }
+            case LOG_ARG_LLONG: { long long v = va_arg(args, long long); memcpy(out + pos, &v, size); break; }
+            case LOG_ARG_SIZE: { size_t v = va_arg(args, size_t); memcpy(out + pos, &v, size); break; }
+            case LOG_ARG_PTRDIFF: { ptrdiff_t v = va_arg(args, ptrdiff_t); memcpy(out + pos, &v, size); break; }
+            case LOG_ARG_DOUBLE: { double v = va_arg(args, double); memcpy(out + pos, &v, size); break; }
+            case LOG_ARG_PTR: { void* v = va_arg(args, void*); memcpy(out + pos, &v, size); break; }
+            default: return false;
+        }
+        pos += size;
+    }
+
+    entry.deferred.format = format;
+    entry.arg_len = (uint8_t)pos;
+    entry.flags |= LOG_ENTRY_DEFERRED;
+    return true;
+}
+
+// Write the entry's message text to out (always NUL-terminated); returns the
+// length written
+inline size_t log_entry_format(const LogEntry& entry, char* out, size_t out_size) {
+    if (!out || out_size == 0) return 0;
+    if (!(entry.flags & LOG_ENTRY_DEFERRED)) {
+        size_t n = strnlen(entry.message, sizeof(entry.message));
+        if (n >= out_size) n = out_size - 1;
+        memcpy(out, entry.message, n);
+        out[n] = '\0';
+        return n;
+    }
+
+    const uint8_t* args = entry.deferred.args;
+    const size_t arg_len = entry.arg_len < LOG_ENTRY_ARG_BYTES ? entry.arg_len : LOG_ENTRY_ARG_BYTES;
+    size_t ai = 0;
+    size_t pos = 0;
+    out[0] = '\0';
+    const char* p = entry.deferred.format ? entry.deferred.format : "";
+
+    while (*p && pos + 1 < out_size) {
+        if (*p != '%') { out[pos++] = *p++; continue; }
+        LogSpec spec;
+        p = log_parse_spec(p, spec);
+        if (spec.kind == LOG_ARG_NONE) { out[pos++] = '%'; continue; }
+        if (spec.kind == LOG_ARG_INVALID) break;  // Capture never records these
+
+        int stars[2] = {0, 0};
+        int nstars = spec.star_width + spec.star_prec;
+        if (ai + nstars * sizeof(int) > arg_len) break;
+        for (int i = 0; i < nstars; i++) {
+            memcpy(&stars[i], args + ai, sizeof(int));
+            ai += sizeof(int);
+        }
+
+        // Rebuild the spec with '*' replaced by the recorded width/precision
+        char fmt[48];
+        if (spec.len > 24) break;  // Room for two expanded '*' values
+        size_t fl = 0;
+        int si = 0;
+        for (size_t i = 0; i < spec.len; i++) {
+            char c = spec.start[i];
+            if (c != '*') { fmt[fl++] = c; continue; }
+            int v = stars[si++];
+            bool is_prec = (i > 0 && spec.start[i - 1] == '.');
+            if (is_prec && v < 0) { fl--; continue; }  // Negative precision = none
+            fl += (size_t)snprintf(fmt + fl, sizeof(fmt) - fl, "%d", v);
+        }
+        fmt[fl] = '\0';
+
+        char* dst = out + pos;
+        size_t room = out_size - pos;
+        int n = 0;
+        if (spec.kind == LOG_ARG_STR) {
+            if (ai >= arg_len) break;
+            const char* s = (const char*)(args + ai);
+            size_t sl = strnlen(s, arg_len - ai);
+            if (ai + sl >= arg_len) break;  // Unterminated: corrupt entry
+            n = snprintf(dst, room, fmt, s);
+            ai += sl + 1;
+        } else {
+            size_t size = log_arg_size(spec.kind);
+            if (ai + size > arg_len) break;
+            const uint8_t* a = args + ai;
+            switch (spec.kind) {
+                case LOG_ARG_INT: { int v; memcpy(&v, a, size); n = snprintf(dst, room, fmt, v); break; }
+                case LOG_ARG_LONG: { long v; memcpy(&v, a, size); n = snprintf(dst, room, fmt, v); break; }
+                case LOG_ARG_LLONG: { long long v; memcpy(&v, a, size); n = snprintf(dst, room, fmt, v); break; }
+                case LOG_ARG_SIZE: { size_t v; memcpy(&v, a, size); n = snprintf(dst, room, fmt, v); break; }
+                case LOG_ARG_PTRDIFF: { ptrdiff_t v; memcpy(&v, a, size); n = snprintf(dst, room, fmt, v); break; }
+                case LOG_ARG_DOUBLE: { double v; memcpy(&v, a, size); n = snprintf(dst, room, fmt, v); break; }
+                case LOG_ARG_PTR: { void* v; memcpy(&v, a, size); n = snprintf(dst, room, fmt, v); break; }
+                default: break;
+            }
+            ai += size;
+        }
+        if (n < 0) break;
+        pos += ((size_t)n < room) ? (size_t)n : room - 1;
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+// Replace a deferred entry's payload with its formatted (truncated) text, for
+// sinks that outlive the firmware image such as NVS
+inline void log_entry_materialize(LogEntry& entry) {
+    if (!(entry.flags & LOG_ENTRY_DEFERRED)) return;
+    char text[LOG_ENTRY_PAYLOAD];
+    log_entry_format(entry, text, sizeof(text));
+    memcpy(entry.message, text, sizeof(entry.message));
+    entry.flags &= (uint8_t)~LOG_ENTRY_DEFERRED;
+    entry.arg_len = 0;
+}
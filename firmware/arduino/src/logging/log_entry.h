@@ -0,0 +1,38 @@
+#pragma once
+
+// Log entry record shared by the logger, the RTC ring buffer and the sinks.
+
+#include <cstddef>
+#include <cstdint>
+
+enum class LogLevel : uint8_t {
+    TRACE = 0,
+    DEBUG = 1,
+    INFO = 2,
+    WARN = 3,
+    ERROR = 4,
+    FATAL = 5,
+    NONE = 6
+};
+
+// LogEntry::flags
+static constexpr uint8_t LOG_ENTRY_DEFERRED = 0x01;  // deferred.{format,args} hold the message
+
+static constexpr size_t LOG_ENTRY_PAYLOAD = 48;
+static constexpr size_t LOG_ENTRY_ARG_BYTES = LOG_ENTRY_PAYLOAD - sizeof(const char*);
+
+struct LogEntry {
+    uint32_t timestamp;
+    LogLevel level;
+    uint8_t module_id;
+    uint16_t sequence;
+    uint8_t flags;
+    uint8_t arg_len;        // Bytes used in deferred.args
+    union {
+        char message[LOG_ENTRY_PAYLOAD];   // Formatted text (flags == 0)
+        struct {
+            const char* format;            // Static format string in flash
+            uint8_t args[LOG_ENTRY_ARG_BYTES];  // Raw argument bytes in format order
+        } deferred;
+    };
+} __attribute__((packed));
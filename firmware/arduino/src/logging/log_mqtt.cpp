@@ -1,9 +1,42 @@
 #include "log_mqtt.h"
 #include "../mqtt_client.h"
 #include "../safe_strings.h"
+#include "../mqtt_dispatch.h"
 
 extern PubSubClient* mqtt_get_client();
 
+static void on_log_command(const MqttInbound& msg) {
+    LogMQTT::getInstance()->handleCommand(msg.topic, msg.payload, msg.length);
+}
+
+static bool ends_with(const char* s, const char* suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+// Append s as a JSON string body (no quotes); false if out_size is too small
+static bool append_json_escaped(char* out, size_t out_size, size_t& pos, const char* s) {
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        char esc[7];
+        size_t n = 0;
+        if (c == '"' || c == '\\') {
+            esc[0] = '\\';
+            esc[1] = (char)c;
+            n = 2;
+        } else if (c < 0x20) {
+            n = (size_t)snprintf(esc, sizeof(esc), "\\u%04x", c);
+        } else {
+            esc[0] = (char)c;
+            n = 1;
+        }
+        if (pos + n >= out_size) return false;
+        memcpy(out + pos, esc, n);
+        pos += n;
+    }
+    return true;
+}
+
 LogMQTT* LogMQTT::getInstance() {
     static LogMQTT instance;
     return &instance;
@@ -12,13 +45,14 @@ LogMQTT* LogMQTT::getInstance() {
 void LogMQTT::begin() {
     if (initialized_) return;
     
-    while (!queue_.empty()) {
-        queue_.pop();
-    }
-    
-    published_count_ = 0;
-    dropped_count_ = 0;
+    clearQueue();
+    resetCounters();
     
+    // Route suffixes are relative to the device prefix (drop the leading '/')
+    mqtt_dispatch_register(MQTT_NS_DEVICE, TOPIC_CMD_CLEAR + 1, on_log_command, nullptr, MQTT_ROUTE_RATE_LIMITED);
+    mqtt_dispatch_register(MQTT_NS_DEVICE, TOPIC_CMD_LEVEL + 1, on_log_command, nullptr, MQTT_ROUTE_RATE_LIMITED);
+    mqtt_dispatch_register(MQTT_NS_DEVICE, TOPIC_CMD_FILTER + 1, on_log_command, nullptr, MQTT_ROUTE_RATE_LIMITED);
+
     subscribeToCommands();
     
     initialized_ = true;
@@ -41,19 +75,19 @@ void LogMQTT::setClientId(const char* id) {
 bool LogMQTT::publish(const LogEntry& entry, const char* module_name) {
     if (!initialized_ || !enabled_) return false;
     
-    if (queue_.size() >= MAX_QUEUE_SIZE) {
-        queue_.pop();
+    if (queue_count_ >= MAX_QUEUE_SIZE) {
+        queue_head_ = (queue_head_ + 1) % MAX_QUEUE_SIZE;
+        queue_count_--;
         dropped_count_++;
     }
     
-    QueuedEntry queued;
+    QueuedEntry& queued = queue_[(queue_head_ + queue_count_) % MAX_QUEUE_SIZE];
     queued.entry = entry;
-    safe_strcpy(queued.module_name, module_name);
-    
-    queue_.push(queued);
+    safe_strcpy(queued.module_name, module_name ? module_name : "");
+    queue_count_++;
     
-    if (isConnected()) {
-        return publishQueued();
+    if (queue_count_ >= FLUSH_THRESHOLD || entry.level >= LogLevel::ERROR) {
+        flush();
     }
     
     return true;
@@ -62,11 +96,16 @@ bool LogMQTT::publish(const LogEntry& entry, const char* module_name) {
 void LogMQTT::flush() {
     if (!initialized_) return;
     
-    while (!queue_.empty() && isConnected()) {
-        publishQueued();
+    while (queue_count_ > 0 && isConnected()) {
+        if (!publishBatch()) break;
     }
 }
 
+void LogMQTT::clearQueue() {
+    queue_head_ = 0;
+    queue_count_ = 0;
+}
+
 bool LogMQTT::isConnected() const {
     PubSubClient* client = mqtt_get_client();
     return client && client->connected();
@@ -76,92 +115,123 @@ PubSubClient* LogMQTT::getMQTTClient() {
     return mqtt_get_client();
 }
 
-bool LogMQTT::publishQueued() {
-    if (queue_.empty()) return true;
+bool LogMQTT::publishBatch() {
+    if (queue_count_ == 0) return false;
     
     PubSubClient* client = getMQTTClient();
     if (!client || !client->connected()) return false;
     
-    QueuedEntry& queued = queue_.front();
+    // PubSubClient needs the fixed header, topic length and topic in the
+    // same buffer; size for the longest level suffix
+    char topic[MAX_TOPIC_LEN];
+    buildTopic("/logs/debug", topic, sizeof(topic));
+    size_t overhead = 5 + 2 + strlen(topic);
+    size_t budget = (overhead < sizeof(payload_)) ? sizeof(payload_) - overhead : 0;
     
-    String topic = buildTopic(queued.entry.level);
-    String payload = formatEntry(queued.entry, queued.module_name);
+    size_t pos = 0;
+    size_t taken = 0;
+    LogLevel top = LogLevel::TRACE;
+    if (budget > 2) payload_[pos++] = '[';
+    while (taken < queue_count_ && budget > 2) {
+        const QueuedEntry& queued = queue_[(queue_head_ + taken) % MAX_QUEUE_SIZE];
+        size_t sep = taken ? 1 : 0;
+        if (sep && pos < budget) payload_[pos] = ',';
+        // Keep room for the closing ']'
+        size_t n = formatEntry(queued, payload_ + pos + sep, budget - 1 - pos - sep);
+        if (n == 0) {
+            if (taken > 0) break;
+            // Cannot fit even alone: drop it rather than stall the queue
+            queue_head_ = (queue_head_ + 1) % MAX_QUEUE_SIZE;
+            queue_count_--;
+            dropped_count_++;
+            return queue_count_ > 0;
+        }
+        pos += sep + n;
+        if (queued.entry.level > top) top = queued.entry.level;
+        taken++;
+    }
+    if (taken == 0) return false;
+    payload_[pos++] = ']';
     
-    bool success = client->publish(topic.c_str(), payload.c_str(), false);
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "%s%s", TOPIC_LOGS, levelSuffix(top));
+    buildTopic(suffix, topic, sizeof(topic));
     
-    if (success) {
-        queue_.pop();
-        published_count_++;
+    if (!client->publish(topic, (const uint8_t*)payload_, (unsigned int)pos, false)) {
+        return false;
     }
     
-    return success;
+    queue_head_ = (queue_head_ + taken) % MAX_QUEUE_SIZE;
+    queue_count_ -= taken;
+    published_count_ += taken;
+    batch_count_++;
+    return true;
 }
 
-String LogMQTT::buildTopic(LogLevel level) {
-    String topic = String(TOPIC_PREFIX) + client_id_ + TOPIC_LOGS;
-    
+void LogMQTT::buildTopic(const char* suffix, char* out, size_t out_size) const {
+    snprintf(out, out_size, "%s%s%s", TOPIC_PREFIX, client_id_, suffix);
+}
+
+const char* LogMQTT::levelSuffix(LogLevel level) {
     switch (level) {
         case LogLevel::ERROR:
         case LogLevel::FATAL:
-            topic += "/error";
-            break;
+            return "/error";
         case LogLevel::WARN:
-            topic += "/warn";
-            break;
+            return "/warn";
         case LogLevel::INFO:
-            topic += "/info";
-            break;
+            return "/info";
         default:
-            topic += "/debug";
-            break;
+            return "/debug";
     }
-    
-    return topic;
 }
 
-String LogMQTT::formatEntry(const LogEntry& entry, const char* module_name) {
-    JsonDocument doc;
-    
-    doc["ts"] = entry.timestamp;
-    doc["lvl"] = Logger::getInstance().levelToString(entry.level);
-    doc["mod"] = module_name;
-    doc["seq"] = entry.sequence;
-    doc["msg"] = entry.message;
+size_t LogMQTT::formatEntry(const QueuedEntry& queued, char* out, size_t out_size) {
+    const LogEntry& entry = queued.entry;
+    int head = snprintf(out, out_size, "{\"ts\":%lu,\"lvl\":\"%s\",\"mod\":\"",
+                        (unsigned long)entry.timestamp,
+                        Logger::getInstance().levelToString(entry.level));
+    if (head < 0 || (size_t)head >= out_size) return 0;
+    size_t pos = (size_t)head;
+    if (!append_json_escaped(out, out_size, pos, queued.module_name)) return 0;
     
-    String output;
-    serializeJson(doc, output);
+    int mid = snprintf(out + pos, out_size - pos, "\",\"seq\":%u,\"msg\":\"", (unsigned)entry.sequence);
+    if (mid < 0 || (size_t)mid >= out_size - pos) return 0;
+    pos += (size_t)mid;
     
-    return output;
+    char message[Logger::MAX_MESSAGE_LENGTH];
+    Logger::getInstance().formatMessage(entry, message, sizeof(message));
+    if (!append_json_escaped(out, out_size, pos, message)) return 0;
+    if (pos + 2 >= out_size) return 0;
+    out[pos++] = '"';
+    out[pos++] = '}';
+    return pos;
 }
 
 void LogMQTT::subscribeToCommands() {
     PubSubClient* client = getMQTTClient();
     if (!client || !client->connected()) return;
 
-    String clear_topic = String(TOPIC_PREFIX) + client_id_ + TOPIC_CMD_CLEAR;
-    String level_topic = String(TOPIC_PREFIX) + client_id_ + TOPIC_CMD_LEVEL;
-    String filter_topic = String(TOPIC_PREFIX) + client_id_ + TOPIC_CMD_FILTER;
-
-    client->subscribe(clear_topic.c_str());
-    client->subscribe(level_topic.c_str());
-    client->subscribe(filter_topic.c_str());
+    char topic[MAX_TOPIC_LEN];
+    buildTopic(TOPIC_CMD_CLEAR, topic, sizeof(topic));
+    client->subscribe(topic);
+    buildTopic(TOPIC_CMD_LEVEL, topic, sizeof(topic));
+    client->subscribe(topic);
+    buildTopic(TOPIC_CMD_FILTER, topic, sizeof(topic));
+    client->subscribe(topic);
 }
 
 void LogMQTT::handleCommand(const char* topic, const uint8_t* payload, size_t length) {
     if (!initialized_) return;
 
-    String topic_str(topic);
+    if (!topic) return;
 
-    if (topic_str.endsWith(TOPIC_CMD_CLEAR)) {
+    if (ends_with(topic, TOPIC_CMD_CLEAR)) {
         Logger::getInstance().clearCrashLog();
-
-        while (!queue_.empty()) {
-            queue_.pop();
-        }
-
+        clearQueue();
         resetCounters();
 
-    } else if (topic_str.endsWith(TOPIC_CMD_LEVEL)) {
+    } else if (ends_with(topic, TOPIC_CMD_LEVEL)) {
         if (length > 0 && length < 10) {
             char level_str[10];
             memcpy(level_str, payload, length);
@@ -173,7 +243,7 @@ void LogMQTT::handleCommand(const char* topic, const uint8_t* payload, size_t le
             }
         }
 
-    } else if (topic_str.endsWith(TOPIC_CMD_FILTER)) {
+    } else if (ends_with(topic, TOPIC_CMD_FILTER)) {
         // Handle log filter configuration
         // Payload format: {"level":"DEBUG","modules":["MQTT","DISPLAY"],"serial":true}
         if (length > 0 && length < 512) {
@@ -188,8 +258,9 @@ void LogMQTT::handleCommand(const char* topic, const uint8_t* payload, size_t le
 
                 PubSubClient* client = getMQTTClient();
                 if (client && client->connected()) {
-                    String status_topic = String(TOPIC_PREFIX) + client_id_ + TOPIC_STATUS_CONFIG;
-                    client->publish(status_topic.c_str(), response, false);
+                    char status_topic[MAX_TOPIC_LEN];
+                    buildTopic(TOPIC_STATUS_CONFIG, status_topic, sizeof(status_topic));
+                    client->publish(status_topic, response, false);
                 }
             }
         }
@@ -3,16 +3,24 @@
 #include "logger.h"
 #include <PubSubClient.h>
 #include <WiFiClient.h>
-#include <ArduinoJson.h>
-#include <queue>
+#include "../mqtt_client.h"
 
 // External C interface for MQTT callback
 extern "C" void log_mqtt_handle_command(const char* topic, const uint8_t* payload, size_t length);
 
+// MQTT log sink
+// Entries wait in a fixed ring (oldest dropped when full) and flush() packs as
+// many as fit in one MQTT_MAX_PACKET_SIZE packet into a JSON array:
+//   [{"ts":..,"lvl":"INFO","mod":"MQTT","seq":..,"msg":".."},...]
+// A batch goes to <prefix><id>/logs/<level> for its most severe entry, so
+// error subscribers still see every batch containing an error. The queue is
+// flushed when it reaches FLUSH_THRESHOLD, on an ERROR/FATAL entry, and from
+// Logger::flush(); nothing here allocates.
 class LogMQTT {
 public:
     static constexpr size_t MAX_QUEUE_SIZE = 32;
-    static constexpr size_t JSON_BUFFER_SIZE = 256;
+    static constexpr size_t FLUSH_THRESHOLD = 16;
+    static constexpr size_t MAX_TOPIC_LEN = 96;
     static constexpr const char* TOPIC_PREFIX = "espsensor/";
     static constexpr const char* TOPIC_LOGS = "/logs";
     static constexpr const char* TOPIC_CMD_CLEAR = "/cmd/clear_logs";
@@ -27,8 +35,10 @@ public:
     
     void setClientId(const char* id);
     
+    // Queue an entry; publishes the queue early per the rules above
     bool publish(const LogEntry& entry, const char* module_name);
     
+    // Publish everything queued, one packet per batch
     void flush();
     
     bool isConnected() const;
@@ -36,13 +46,15 @@ public:
     void setEnabled(bool enabled) { enabled_ = enabled; }
     bool isEnabled() const { return enabled_; }
     
-    size_t getQueuedCount() const { return queue_.size(); }
+    size_t getQueuedCount() const { return queue_count_; }
     size_t getPublishedCount() const { return published_count_; }
     size_t getDroppedCount() const { return dropped_count_; }
+    size_t getBatchCount() const { return batch_count_; }
     
     void resetCounters() {
         published_count_ = 0;
         dropped_count_ = 0;
+        batch_count_ = 0;
     }
     
     void handleCommand(const char* topic, const uint8_t* payload, size_t length);
@@ -58,20 +70,29 @@ private:
         char module_name[16];
     };
     
-    std::queue<QueuedEntry> queue_;
+    QueuedEntry queue_[MAX_QUEUE_SIZE];
+    size_t queue_head_ = 0;                 // Oldest entry
+    size_t queue_count_ = 0;
     char client_id_[40] = {0};
     bool initialized_ = false;
     bool enabled_ = true;
     
     size_t published_count_ = 0;
     size_t dropped_count_ = 0;
+    size_t batch_count_ = 0;
+
+    char payload_[MQTT_MAX_PACKET_SIZE];    // Batch being built
     
     PubSubClient* getMQTTClient();
     
-    bool publishQueued();
+    // Publish one batch from the front of the queue; false if nothing was sent
+    bool publishBatch();
     
-    String buildTopic(LogLevel level);
-    String formatEntry(const LogEntry& entry, const char* module_name);
+    void clearQueue();
+    void buildTopic(const char* suffix, char* out, size_t out_size) const;
+    static const char* levelSuffix(LogLevel level);
+    // Append one entry object; returns its length, or 0 if it does not fit
+    static size_t formatEntry(const QueuedEntry& queued, char* out, size_t out_size);
     
     void subscribeToCommands();
 };
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+// Lock-free log ring
+// Bounded multi-producer / single-consumer ring over plain storage that can
+// live in RTC memory. Producers claim a ticket with one atomic add and never
+// wait, so push is safe from tasks, the MQTT callback and ISRs alike; when
+// the ring is full the oldest entry is overwritten (a crash log wants the
+// latest lines). Each slot carries a commit stamp (odd once committed, 0
+// while being written) and readers validate it before and after copying, seqlock-style,
+// so a slot overwritten mid-read is reported as missing rather than torn.
+//
+// Usage:
+//   RTC_DATA_ATTR static LogRing<64> ring;   // Zero-initialized = empty
+//   log_ring_push(ring, entry);              // Any context
+//   for (uint32_t t = log_ring_oldest(ring); t != log_ring_head(ring); t++)
+//       if (log_ring_read(ring, t, entry)) print(entry);
+//
+// Tickets are free-running uint32 counters; differences stay correct across
+// wrap-around.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "log_entry.h"
+
+template <size_t N>
+struct LogRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Ring size must be a power of two");
+    LogEntry slots[N];
+    uint32_t stamp[N];      // log_ring_stamp(ticket) once committed, 0 while being written
+    uint32_t head;          // Next ticket to hand out (producers)
+    uint32_t tail;          // Oldest ticket not yet consumed (consumer)
+    uint32_t overflow;      // Unconsumed entries overwritten
+};
+
+// Commit stamp for a ticket: always odd, so it never equals the 0 "being
+// written" marker, even when the ticket counter wraps
+inline uint32_t log_ring_stamp(uint32_t ticket) {
+    return (ticket << 1) | 1u;
+}
+
+template <size_t N>
+inline uint32_t log_ring_head(const LogRing<N>& r) {
+    return __atomic_load_n(&r.head, __ATOMIC_ACQUIRE);
+}
+
+// Oldest ticket still held: the tail, unless producers lapped it
+template <size_t N>
+inline uint32_t log_ring_oldest(const LogRing<N>& r) {
+    uint32_t head = log_ring_head(r);
+    uint32_t tail = __atomic_load_n(&r.tail, __ATOMIC_RELAXED);
+    return (head - tail > N) ? head - (uint32_t)N : tail;
+}
+
+// Entries currently held (including any still being written)
+template <size_t N>
+inline size_t log_ring_count(const LogRing<N>& r) {
+    uint32_t head = log_ring_head(r);
+    return head - log_ring_oldest(r);
+}
+
+// Append an entry; never blocks. Returns true if an unconsumed entry was
+// overwritten to make room.
+template <size_t N>
+inline bool log_ring_push(LogRing<N>& r, const LogEntry& entry) {
+    uint32_t ticket = __atomic_fetch_add(&r.head, 1, __ATOMIC_RELAXED);
+    size_t s = ticket & (N - 1);
+    bool overwrote = ticket - __atomic_load_n(&r.tail, __ATOMIC_RELAXED) >= N;
+    if (overwrote) __atomic_fetch_add(&r.overflow, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&r.stamp[s], 0u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&r.slots[s], &entry, sizeof(LogEntry));
+    __atomic_store_n(&r.stamp[s], log_ring_stamp(ticket), __ATOMIC_RELEASE);
+    return overwrote;
+}
+
+// Copy out the entry for ticket; false if it is not committed yet or was
+// overwritten while copying
+template <size_t N>
+inline bool log_ring_read(const LogRing<N>& r, uint32_t ticket, LogEntry& out) {
+    size_t s = ticket & (N - 1);
+    uint32_t want = log_ring_stamp(ticket);
+    if (__atomic_load_n(&r.stamp[s], __ATOMIC_ACQUIRE) != want) return false;
+    memcpy(&out, &r.slots[s], sizeof(LogEntry));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&r.stamp[s], __ATOMIC_RELAXED) == want;
+}
+
+// Single consumer: take the oldest entry. Slots lost to overwriting are
+// skipped; false when empty or the oldest entry is still being written.
+template <size_t N>
+inline bool log_ring_pop(LogRing<N>& r, LogEntry& out) {
+    for (;;) {
+        uint32_t ticket = log_ring_oldest(r);
+        if (ticket == log_ring_head(r)) return false;
+        bool ok = log_ring_read(r, ticket, out);
+        if (!ok && log_ring_head(r) - ticket <= N) {
+            // Still within the window, so a later lap has not claimed the
+            // slot: a 0 or previous-lap stamp is this ticket's write in flight
+            uint32_t st = __atomic_load_n(&r.stamp[ticket & (N - 1)], __ATOMIC_RELAXED);
+            if (st == 0 || (int32_t)(st - log_ring_stamp(ticket)) <= 0) return false;
+        }
+        __atomic_store_n(&r.tail, ticket + 1, __ATOMIC_RELEASE);
+        if (ok) return true;
+    }
+}
+
+// Single consumer: drop everything pushed so far
+template <size_t N>
+inline void log_ring_discard(LogRing<N>& r) {
+    __atomic_store_n(&r.tail, log_ring_head(r), __ATOMIC_RELEASE);
+}
+
+// Reset to empty; only when no producer can run (boot, corruption recovery)
+template <size_t N>
+inline void log_ring_reset(LogRing<N>& r) {
+    memset(&r, 0, sizeof(r));
+}
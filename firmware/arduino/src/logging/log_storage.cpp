@@ -7,128 +7,333 @@ LogStorage* LogStorage::getInstance() {
 
 void LogStorage::begin() {
     if (initialized_) return;
-    
+
     prefs_.begin(NVS_NAMESPACE, false);
-    loadMetadata();
+    removeLegacyKeys();
+    cache_slot_ = -1;
+    pending_count_ = 0;
+#if LOG_FLASH_ENABLED
+    if (beginFlash()) {
+        initialized_ = true;
+        return;
+    }
+#endif
+    scanSegments();
     initialized_ = true;
 }
 
 void LogStorage::end() {
     if (!initialized_) return;
-    
-    if (dirty_) {
-        flush();
+
+    flush();
+
+#if LOG_FLASH_ENABLED
+    if (flash_map_) {
+        spi_flash_munmap(flash_map_);
+        flash_map_ = 0;
     }
-    
+    flash_active_ = false;
+#endif
+
     prefs_.end();
     initialized_ = false;
 }
 
-void LogStorage::loadMetadata() {
-    head_ = prefs_.getUInt(KEY_HEAD, 0);
-    count_ = prefs_.getUInt(KEY_COUNT, 0);
-    
-    if (count_ > MAX_STORED_ENTRIES) {
-        count_ = 0;
-        head_ = 0;
-    }
+bool LogStorage::usingFlash() const {
+#if LOG_FLASH_ENABLED
+    return flash_active_;
+#else
+    return false;
+#endif
 }
 
-void LogStorage::saveMetadata() {
-    prefs_.putUInt(KEY_HEAD, head_);
-    prefs_.putUInt(KEY_COUNT, count_);
-    dirty_ = false;
+#if LOG_FLASH_ENABLED
+bool LogStorage::flashWrite(void* ctx, uint32_t offset, const void* data, size_t len) {
+    return esp_partition_write((const esp_partition_t*)ctx, offset, data, len) == ESP_OK;
 }
 
-bool LogStorage::storeEntry(const LogEntry& entry) {
-    if (!initialized_) return false;
-    
-    rotateIfNeeded();
-    
-    size_t index = (head_ + count_) % MAX_STORED_ENTRIES;
-    
-    if (!storeEntryAtIndex(index, entry)) {
+bool LogStorage::flashErase(void* ctx, uint32_t offset, size_t len) {
+    return esp_partition_erase_range((const esp_partition_t*)ctx, offset, len) == ESP_OK;
+}
+
+// Map the log partition and attach the ring; false falls back to NVS
+bool LogStorage::beginFlash() {
+    const esp_partition_t* part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, LOG_FLASH_PARTITION_LABEL);
+    if (!part) return false;
+
+    const void* view = nullptr;
+    if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &view, &flash_map_) != ESP_OK) {
+        flash_map_ = 0;
         return false;
     }
-    
-    if (count_ < MAX_STORED_ENTRIES) {
-        count_++;
+
+    FlashRingIo io = {(void*)part, flashWrite, flashErase, (const uint8_t*)view, part->size};
+    if (!flash_.begin(io)) {
+        spi_flash_munmap(flash_map_);
+        flash_map_ = 0;
+        return false;
+    }
+    flash_active_ = true;
+    committed_count_ = flash_.count();
+    return true;
+}
+#endif
+
+template <typename Fn>
+void LogStorage::forEachCommitted(Fn fn) {
+#if LOG_FLASH_ENABLED
+    if (flash_active_) {
+        flash_.forEach([&](const uint8_t* data, uint16_t len) {
+            if (len != sizeof(LogEntry)) return true;
+            return fn(*(const LogEntry*)data);
+        });
+        return;
+    }
+#endif
+    for (size_t i = 0; i < used_; i++) {
+        size_t slot = order_[i];
+        if (!loadSegment(slot)) continue;
+        for (size_t e = 0; e < len_[slot]; e++) {
+            if (!fn(cache_.entries[e])) return;
+        }
+    }
+}
+
+void LogStorage::segmentKey(size_t slot, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s%u", KEY_SEGMENT_PREFIX, (unsigned)slot);
+}
+
+// Per-entry keys ("e_<n>") plus "head"/"count" metadata from the old layout
+void LogStorage::removeLegacyKeys() {
+    if (!prefs_.isKey("count")) return;
+
+    char key[8];
+    for (size_t i = 0; i < 50; i++) {
+        snprintf(key, sizeof(key), "e_%u", (unsigned)i);
+        prefs_.remove(key);
+    }
+    prefs_.remove("head");
+    prefs_.remove("count");
+}
+
+void LogStorage::scanSegments() {
+    char key[8];
+    for (size_t slot = 0; slot < SEGMENT_COUNT; slot++) {
+        seq_[slot] = 0;
+        len_[slot] = 0;
+        segmentKey(slot, key, sizeof(key));
+        size_t bytes = prefs_.getBytesLength(key);
+        if (bytes <= SEGMENT_HEADER || bytes > sizeof(Segment) ||
+            (bytes - SEGMENT_HEADER) % sizeof(LogEntry) != 0) {
+            continue;
+        }
+        if (!loadSegment(slot) || cache_.magic != SEGMENT_MAGIC) continue;
+        seq_[slot] = cache_.seq;
+        len_[slot] = (uint8_t)((bytes - SEGMENT_HEADER) / sizeof(LogEntry));
+    }
+    rebuildOrder();
+}
+
+void LogStorage::rebuildOrder() {
+    used_ = 0;
+    committed_count_ = 0;
+    for (size_t slot = 0; slot < SEGMENT_COUNT; slot++) {
+        if (len_[slot] == 0) continue;
+        // Insertion sort by sequence (at most SEGMENT_COUNT slots)
+        size_t i = used_++;
+        while (i > 0 && seq_[order_[i - 1]] > seq_[slot]) {
+            order_[i] = order_[i - 1];
+            i--;
+        }
+        order_[i] = (uint8_t)slot;
+        committed_count_ += len_[slot];
+    }
+}
+
+bool LogStorage::loadSegment(size_t slot) {
+    if (cache_slot_ == (int8_t)slot) return true;
+
+    char key[8];
+    segmentKey(slot, key, sizeof(key));
+    cache_slot_ = -1;
+    if (prefs_.getBytes(key, &cache_, sizeof(cache_)) <= SEGMENT_HEADER) return false;
+    cache_slot_ = (int8_t)slot;
+    return true;
+}
+
+void LogStorage::commitPending() {
+    if (pending_count_ == 0) return;
+
+    uint32_t start = (uint32_t)esp_timer_get_time();
+
+#if LOG_FLASH_ENABLED
+    if (flash_active_) {
+        for (size_t i = 0; i < pending_count_; i++) {
+            flash_.append(&pending_[i], sizeof(LogEntry));
+        }
+        pending_count_ = 0;
+        committed_count_ = flash_.count();  // Rotation may have dropped a sector
+        last_commit_us_ = (uint32_t)esp_timer_get_time() - start;
+        return;
+    }
+#endif
+
+    // Reuse an empty slot, else overwrite the oldest segment
+    size_t slot = 0;
+    uint32_t newest = 0;
+    bool found_empty = false;
+    for (size_t s = 0; s < SEGMENT_COUNT; s++) {
+        if (len_[s] == 0 && !found_empty) {
+            slot = s;
+            found_empty = true;
+        }
+        if (len_[s] != 0 && seq_[s] > newest) newest = seq_[s];
+    }
+    if (!found_empty) slot = order_[0];
+
+    char key[8];
+    segmentKey(slot, key, sizeof(key));
+    cache_.magic = SEGMENT_MAGIC;
+    cache_.seq = newest + 1;
+    memcpy(cache_.entries, pending_, pending_count_ * sizeof(LogEntry));
+    size_t bytes = SEGMENT_HEADER + pending_count_ * sizeof(LogEntry);
+
+    if (prefs_.putBytes(key, &cache_, bytes) == bytes) {
+        seq_[slot] = cache_.seq;
+        len_[slot] = (uint8_t)pending_count_;
+        cache_slot_ = (int8_t)slot;
+        rebuildOrder();
     } else {
-        head_ = (head_ + 1) % MAX_STORED_ENTRIES;
+        cache_slot_ = -1;
     }
-    
-    dirty_ = true;
-    
-    if ((count_ % 5) == 0) {
-        flush();
+    pending_count_ = 0;
+
+    last_commit_us_ = (uint32_t)esp_timer_get_time() - start;
+}
+
+bool LogStorage::storeEntry(const LogEntry& entry) {
+    if (!initialized_) return false;
+
+    if (pending_count_ >= SEGMENT_ENTRIES) {
+        commitPending();
     }
-    
+    pending_[pending_count_++] = entry;
+
     return true;
 }
 
 bool LogStorage::getEntry(size_t index, LogEntry& entry) {
-    if (!initialized_ || index >= count_) return false;
-    
-    size_t actual_index = (head_ + index) % MAX_STORED_ENTRIES;
-    return loadEntryAtIndex(actual_index, entry);
+    if (!initialized_) return false;
+
+#if LOG_FLASH_ENABLED
+    if (flash_active_) {
+        if (index >= committed_count_) {
+            index -= committed_count_;
+            if (index >= pending_count_) return false;
+            entry = pending_[index];
+            return true;
+        }
+        bool found = false;
+        forEachCommitted([&](const LogEntry& e) {
+            if (index-- != 0) return true;
+            entry = e;
+            found = true;
+            return false;
+        });
+        return found;
+    }
+#endif
+
+    for (size_t i = 0; i < used_; i++) {
+        size_t slot = order_[i];
+        if (index < len_[slot]) {
+            if (!loadSegment(slot)) return false;
+            entry = cache_.entries[index];
+            return true;
+        }
+        index -= len_[slot];
+    }
+
+    if (index >= pending_count_) return false;
+    entry = pending_[index];
+    return true;
 }
 
 size_t LogStorage::getStoredCount() {
-    return count_;
+    return committed_count_ + pending_count_;
 }
 
 void LogStorage::clearLogs() {
     if (!initialized_) return;
-    
-    for (size_t i = 0; i < MAX_STORED_ENTRIES; i++) {
-        prefs_.remove(getEntryKey(i).c_str());
+
+#if LOG_FLASH_ENABLED
+    if (flash_active_) {
+        flash_.clear();
+        committed_count_ = 0;
+        pending_count_ = 0;
+        return;
     }
-    
-    head_ = 0;
-    count_ = 0;
-    saveMetadata();
+#endif
+
+    char key[8];
+    for (size_t slot = 0; slot < SEGMENT_COUNT; slot++) {
+        if (len_[slot] == 0) continue;
+        segmentKey(slot, key, sizeof(key));
+        prefs_.remove(key);
+        len_[slot] = 0;
+        seq_[slot] = 0;
+    }
+
+    pending_count_ = 0;
+    cache_slot_ = -1;
+    rebuildOrder();
 }
 
 void LogStorage::markCrash() {
     if (!initialized_) return;
-    
+
     prefs_.putBool(KEY_CRASH, true);
 }
 
 bool LogStorage::wasCrashed() {
     if (!initialized_) return false;
-    
+
     return prefs_.getBool(KEY_CRASH, false);
 }
 
 void LogStorage::clearCrashFlag() {
     if (!initialized_) return;
-    
+
     prefs_.remove(KEY_CRASH);
 }
 
 void LogStorage::flush() {
-    if (!initialized_ || !dirty_) return;
-    
-    saveMetadata();
+    if (!initialized_) return;
+
+    commitPending();
 }
 
 void LogStorage::dumpToSerial() {
     if (!initialized_) return;
-    
-    Serial.printf("=== NVS LOG STORAGE (%zu entries) ===\n", count_);
-    
-    LogEntry entry;
-    for (size_t i = 0; i < count_; i++) {
-        if (getEntry(i, entry)) {
-            Serial.printf("[%lu] %d: %s\n", 
-                         entry.timestamp, 
-                         (int)entry.level, 
-                         entry.message);
-        }
+
+    const char* where = usingFlash() ? "FLASH" : "NVS";
+    Serial.printf("=== %s LOG STORAGE (%zu entries) ===\n", where, getStoredCount());
+
+    char message[Logger::MAX_MESSAGE_LENGTH];
+    auto print = [&](const LogEntry& entry) {
+        Serial.printf("[%lu] %d: %s\n",
+                     entry.timestamp,
+                     (int)entry.level,
+                     Logger::getInstance().formatMessage(entry, message, sizeof(message)));
+        return true;
+    };
+    forEachCommitted(print);
+    for (size_t i = 0; i < pending_count_; i++) {
+        print(pending_[i]);
     }
-    
-    Serial.println("=== END NVS LOGS ===");
+
+    Serial.printf("=== END %s LOGS ===\n", where);
 }
 
 bool LogStorage::exportToBuffer(uint8_t* buffer, size_t& size, size_t max_size) {
@@ -136,89 +341,66 @@ bool LogStorage::exportToBuffer(uint8_t* buffer, size_t& size, size_t max_size)
         size = 0;
         return false;
     }
-    
+
     size_t written = 0;
     size_t entry_count = 0;
-    
-    LogEntry entry;
-    for (size_t i = 0; i < count_ && written + sizeof(LogEntry) <= max_size; i++) {
-        if (getEntry(i, entry)) {
-            memcpy(buffer + written, &entry, sizeof(LogEntry));
-            written += sizeof(LogEntry);
-            entry_count++;
-        }
+
+    auto copy = [&](const LogEntry& entry) {
+        if (written + sizeof(LogEntry) > max_size) return false;
+        memcpy(buffer + written, &entry, sizeof(LogEntry));
+        written += sizeof(LogEntry);
+        entry_count++;
+        return true;
+    };
+    forEachCommitted(copy);
+    for (size_t i = 0; i < pending_count_; i++) {
+        if (!copy(pending_[i])) break;
     }
-    
+
     size = written;
     return entry_count > 0;
 }
 
 size_t LogStorage::getOldestTimestamp() {
-    if (!initialized_ || count_ == 0) return 0;
-    
+    if (!initialized_ || getStoredCount() == 0) return 0;
+
     LogEntry entry;
     if (getEntry(0, entry)) {
         return entry.timestamp;
     }
-    
+
     return 0;
 }
 
 size_t LogStorage::getNewestTimestamp() {
-    if (!initialized_ || count_ == 0) return 0;
-    
+    if (!initialized_ || getStoredCount() == 0) return 0;
+
     LogEntry entry;
-    if (getEntry(count_ - 1, entry)) {
+    if (getEntry(getStoredCount() - 1, entry)) {
         return entry.timestamp;
     }
-    
+
     return 0;
 }
 
+// No-op in flash mode: the ring's size bounds retention
 void LogStorage::pruneOldEntries(uint32_t max_age_ms) {
-    if (!initialized_ || count_ == 0) return;
-    
+    if (!initialized_ || used_ == 0) return;
+
     uint32_t current_time = esp_timer_get_time() / 1000;
     uint32_t cutoff_time = current_time - max_age_ms;
-    
-    size_t removed = 0;
-    LogEntry entry;
-    
-    while (count_ > 0 && getEntry(0, entry)) {
-        if (entry.timestamp < cutoff_time) {
-            head_ = (head_ + 1) % MAX_STORED_ENTRIES;
-            count_--;
-            removed++;
-        } else {
+
+    char key[8];
+    while (used_ > 0) {
+        size_t slot = order_[0];
+        if (!loadSegment(slot) || cache_.entries[len_[slot] - 1].timestamp >= cutoff_time) {
             break;
         }
+        segmentKey(slot, key, sizeof(key));
+        prefs_.remove(key);
+        len_[slot] = 0;
+        seq_[slot] = 0;
+        cache_slot_ = -1;
+        rebuildOrder();
     }
-    
-    if (removed > 0) {
-        dirty_ = true;
-        flush();
-    }
-}
-
-String LogStorage::getEntryKey(size_t index) {
-    return String(KEY_PREFIX) + String(index);
 }
-
-bool LogStorage::storeEntryAtIndex(size_t index, const LogEntry& entry) {
-    String key = getEntryKey(index);
-    size_t written = prefs_.putBytes(key.c_str(), &entry, sizeof(LogEntry));
-    return written == sizeof(LogEntry);
-}
-
-bool LogStorage::loadEntryAtIndex(size_t index, LogEntry& entry) {
-    String key = getEntryKey(index);
-    size_t read = prefs_.getBytes(key.c_str(), &entry, sizeof(LogEntry));
-    return read == sizeof(LogEntry);
-}
-
-void LogStorage::rotateIfNeeded() {
-    if (count_ >= MAX_STORED_ENTRIES) {
-        head_ = (head_ + 1) % MAX_STORED_ENTRIES;
-        count_ = MAX_STORED_ENTRIES - 1;
-    }
-}
\ No newline at end of file
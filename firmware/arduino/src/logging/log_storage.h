@@ -2,63 +2,118 @@
 
 #include "logger.h"
 #include <Preferences.h>
+#if LOG_FLASH_ENABLED
+#include <esp_partition.h>
+#include "flash_ring.h"
+#endif
 
+// NVS log persistence
+// Entries are collected in RAM during the wake and committed once (normally
+// from Logger::flush() before deep sleep) as a single packed blob, so a wake
+// costs one NVS write instead of one per entry plus metadata. The newest
+// SEGMENT_COUNT segments are kept; each blob carries a sequence number, so no
+// separate metadata key is needed and the order is rebuilt at begin().
+//
+// With LOG_FLASH_ENABLED and a matching partition, commits append to a
+// FlashRing on that partition instead and reads walk its memory-mapped view;
+// NVS then only holds the crash flag. Without the partition, the NVS segments
+// are used as before.
 class LogStorage {
 public:
-    static constexpr size_t MAX_STORED_ENTRIES = 50;
+    static constexpr size_t SEGMENT_COUNT = 8;
+    static constexpr size_t SEGMENT_ENTRIES = 8;    // Pending entries per blob
+    static constexpr size_t MAX_STORED_ENTRIES = SEGMENT_COUNT * SEGMENT_ENTRIES;
     static constexpr const char* NVS_NAMESPACE = "logs";
-    static constexpr const char* KEY_COUNT = "count";
-    static constexpr const char* KEY_HEAD = "head";
     static constexpr const char* KEY_CRASH = "crash";
-    static constexpr const char* KEY_PREFIX = "e_";
-    
+    static constexpr const char* KEY_SEGMENT_PREFIX = "s";
+    static constexpr uint32_t SEGMENT_MAGIC = 0x4C475331;  // "LGS1"
+
     static LogStorage* getInstance();
-    
+
     void begin();
     void end();
-    
+
+    // Queue an entry for the next commit (commits early if the batch is full)
     bool storeEntry(const LogEntry& entry);
-    
+
+    // Committed entries oldest first, then any still pending
     bool getEntry(size_t index, LogEntry& entry);
-    
+
     size_t getStoredCount();
-    
+
     void clearLogs();
-    
+
     void markCrash();
     bool wasCrashed();
     void clearCrashFlag();
-    
+
+    // Commit pending entries as one blob
     void flush();
-    
+
     void dumpToSerial();
-    
+
     bool exportToBuffer(uint8_t* buffer, size_t& size, size_t max_size);
-    
+
     size_t getOldestTimestamp();
     size_t getNewestTimestamp();
-    
+
+    // Drops whole segments whose newest entry is older than max_age_ms
     void pruneOldEntries(uint32_t max_age_ms);
-    
+
+    // Duration of the last blob commit (0 = none this boot)
+    uint32_t getLastCommitUs() const { return last_commit_us_; }
+
+    // True when entries go to the flash log partition rather than NVS
+    bool usingFlash() const;
+
 private:
     LogStorage() = default;
     ~LogStorage() = default;
     LogStorage(const LogStorage&) = delete;
     LogStorage& operator=(const LogStorage&) = delete;
-    
+
+    struct Segment {
+        uint32_t magic;
+        uint32_t seq;           // Monotonic; higher = newer
+        LogEntry entries[SEGMENT_ENTRIES];
+    } __attribute__((packed));
+    static constexpr size_t SEGMENT_HEADER = sizeof(uint32_t) * 2;
+
     Preferences prefs_;
     bool initialized_ = false;
-    size_t head_ = 0;
-    size_t count_ = 0;
-    bool dirty_ = false;
-    
-    void loadMetadata();
-    void saveMetadata();
-    
-    String getEntryKey(size_t index);
-    
-    bool storeEntryAtIndex(size_t index, const LogEntry& entry);
-    bool loadEntryAtIndex(size_t index, LogEntry& entry);
-    
-    void rotateIfNeeded();
-};
\ No newline at end of file
+
+    // Committed segments, by slot: sequence and entry count (0 = empty)
+    uint32_t seq_[SEGMENT_COUNT] = {};
+    uint8_t len_[SEGMENT_COUNT] = {};
+    uint8_t order_[SEGMENT_COUNT] = {};   // Non-empty slots, oldest first
+    uint8_t used_ = 0;
+    size_t committed_count_ = 0;
+
+    LogEntry pending_[SEGMENT_ENTRIES];
+    size_t pending_count_ = 0;
+
+    Segment cache_;                         // Last segment read back
+    int8_t cache_slot_ = -1;
+    uint32_t last_commit_us_ = 0;
+
+    static void segmentKey(size_t slot, char* out, size_t out_size);
+    void scanSegments();
+    void rebuildOrder();
+    bool loadSegment(size_t slot);
+    void commitPending();
+    void removeLegacyKeys();
+
+    // Visit committed entries oldest first; entries may point into flash
+    template <typename Fn>
+    void forEachCommitted(Fn fn);
+
+#if LOG_FLASH_ENABLED
+    FlashRing flash_;
+    spi_flash_mmap_handle_t flash_map_ = 0;
+    bool flash_active_ = false;
+
+    bool beginFlash();
+    static bool flashWrite(void* ctx, uint32_t offset, const void* data, size_t len);
+    static bool flashErase(void* ctx, uint32_t offset, size_t len);
+#endif
+};
@@ -2,6 +2,7 @@
 #include "log_buffer.h"
 #include "log_storage.h"
 #include "log_mqtt.h"
+#include "log_deferred.h"
 #include "../config.h"
 #include "../safe_strings.h"
 #include <esp_system.h>
@@ -106,9 +107,21 @@ void Logger::logv(LogLevel level, uint8_t module, const char* format, va_list ar
     entry.level = level;
     entry.module_id = module;
     entry.sequence = sequence_++;
+    entry.flags = 0;
+    entry.arg_len = 0;
+
+    // Serial formats every entry anyway, so deferral only pays off without it
+    bool deferred = false;
+    if (config_.deferred_format && !config_.serial_enabled) {
+        va_list copy;
+        va_copy(copy, args);
+        deferred = log_defer_capture(entry, format, copy);
+        va_end(copy);
+    }
+    if (!deferred) {
+        vsnprintf(entry.message, sizeof(entry.message), format, args);
+    }
 
-    vsnprintf(entry.message, sizeof(entry.message), format, args);
-    
     if (config_.serial_enabled) {
         outputSerial(entry);
     }
@@ -251,6 +264,11 @@ bool Logger::getBufferedEntry(size_t index, LogEntry& entry) const {
     return g_log_buffer ? g_log_buffer->getEntry(index, entry) : false;
 }
 
+const char* Logger::formatMessage(const LogEntry& entry, char* out, size_t out_size) const {
+    log_entry_format(entry, out, out_size);
+    return out;
+}
+
 void Logger::outputSerial(const LogEntry& entry) {
     char timestamp_str[16];
     snprintf(timestamp_str, sizeof(timestamp_str), "%lu", entry.timestamp);
@@ -259,11 +277,12 @@ void Logger::outputSerial(const LogEntry& entry) {
                               ? module_names_[entry.module_id] 
                               : "UNKNOWN";
     
+    char message[MAX_MESSAGE_LENGTH];
     Serial.printf("[%s] %s [%s] %s\n",
                   timestamp_str,
                   levelToString(entry.level),
                   module_name,
-                  entry.message);
+                  formatMessage(entry, message, sizeof(message)));
 }
 
 void Logger::outputBuffer(const LogEntry& entry) {
@@ -273,7 +292,10 @@ void Logger::outputBuffer(const LogEntry& entry) {
 }
 
 void Logger::outputNVS(const LogEntry& entry) {
-    g_log_storage->storeEntry(entry);
+    // NVS outlives the firmware image, so format pointers must not reach it
+    LogEntry stored = entry;
+    log_entry_materialize(stored);
+    g_log_storage->storeEntry(stored);
 }
 
 void Logger::outputMQTT(const LogEntry& entry) {
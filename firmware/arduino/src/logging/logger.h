@@ -3,24 +3,9 @@
 #include <Arduino.h>
 #include <esp_timer.h>
 #include <cstdarg>
-
-enum class LogLevel : uint8_t {
-    TRACE = 0,
-    DEBUG = 1,
-    INFO = 2,
-    WARN = 3,
-    ERROR = 4,
-    FATAL = 5,
-    NONE = 6
-};
-
-struct LogEntry {
-    uint32_t timestamp;     
-    LogLevel level;         
-    uint8_t module_id;      
-    uint16_t sequence;      
-    char message[48];       
-} __attribute__((packed));
+#include "log_entry.h"
+#include "../config.h"
+#include "../feature_flags.h"
 
 class Logger {
 public:
@@ -35,6 +20,7 @@ public:
         bool mqtt_enabled;
         uint16_t mqtt_rate_limit_ms;
         uint16_t enabled_modules_mask;  // Bitmask of enabled modules (0xFFFF = all enabled)
+        bool deferred_format;           // Record format + raw args; format only when printed
 
         Config() :
             min_level(LogLevel::INFO),
@@ -43,7 +29,8 @@ public:
             nvs_enabled(false),
             mqtt_enabled(false),
             mqtt_rate_limit_ms(1000),
-            enabled_modules_mask(0xFFFF) {}  // All modules enabled by default
+            enabled_modules_mask(0xFFFF),  // All modules enabled by default
+            deferred_format(LOG_DEFERRED_FORMAT) {}
     };
     
     static Logger& getInstance();
@@ -86,6 +73,9 @@ public:
     void getConfigJson(char* out, size_t out_size) const;
 
     const char* levelToString(LogLevel level) const;
+
+    // Message text of an entry (formats deferred entries); returns out
+    const char* formatMessage(const LogEntry& entry, char* out, size_t out_size) const;
     LogLevel stringToLevel(const char* str) const;
     
     void flush();
@@ -121,14 +111,71 @@ private:
     bool initialized_ = false;
 };
 
-#define LOG_MODULE(name) static uint8_t log_module_id = Logger::getInstance().registerModule(name)
+// Compile-time module filter (LOG_COMPILE_MODULE_MASK in feature_flags.h)
+constexpr bool log_name_equal(const char* a, const char* b) {
+    return *a == *b && (*a == '\0' || log_name_equal(a + 1, b + 1));
+}
+
+constexpr uint32_t log_compile_module_bit(const char* name) {
+    return log_name_equal(name, "MAIN") ? LOG_COMPILE_MODULE_MAIN :
+           log_name_equal(name, "SYSTEM") ? LOG_COMPILE_MODULE_SYSTEM :
+           log_name_equal(name, "PERF") ? LOG_COMPILE_MODULE_PERF :
+           log_name_equal(name, "DispCap") ? LOG_COMPILE_MODULE_DISPCAP : 0;
+}
+
+constexpr bool log_compile_module_enabled(const char* name) {
+    return log_compile_module_bit(name) == 0 ||
+           (LOG_COMPILE_MODULE_MASK & log_compile_module_bit(name)) != 0;
+}
+
+// Declares log_module_compiled for the LOG_* macros; LOG_MODULE does this,
+// files that register their module id by hand use it directly
+#define LOG_MODULE_COMPILE(name) static constexpr bool log_module_compiled = log_compile_module_enabled(name)
+
+#define LOG_MODULE(name) \
+    LOG_MODULE_COMPILE(name); \
+    static uint8_t log_module_id = Logger::getInstance().registerModule(name)
+
+// Levels below LOG_COMPILE_LEVEL expand to nothing; a disabled module's calls
+// are dead code on a constant and are dropped by the compiler
+#define LOG_AT_(method, fmt, ...) \
+    do { if (log_module_compiled) Logger::getInstance().method(log_module_id, fmt, ##__VA_ARGS__); } while (0)
+
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_TRACE(fmt, ...) LOG_AT_(trace, fmt, ##__VA_ARGS__)
+#else
+#define LOG_TRACE(fmt, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_DEBUG(fmt, ...) LOG_AT_(debug, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_INFO(fmt, ...) LOG_AT_(info, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 3
+#define LOG_WARN(fmt, ...) LOG_AT_(warn, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 4
+#define LOG_ERROR(fmt, ...) LOG_AT_(error, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) ((void)0)
+#endif
 
-#define LOG_TRACE(fmt, ...) Logger::getInstance().trace(log_module_id, fmt, ##__VA_ARGS__)
-#define LOG_DEBUG(fmt, ...) Logger::getInstance().debug(log_module_id, fmt, ##__VA_ARGS__)
-#define LOG_INFO(fmt, ...) Logger::getInstance().info(log_module_id, fmt, ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...) Logger::getInstance().warn(log_module_id, fmt, ##__VA_ARGS__)
-#define LOG_ERROR(fmt, ...) Logger::getInstance().error(log_module_id, fmt, ##__VA_ARGS__)
-#define LOG_FATAL(fmt, ...) Logger::getInstance().fatal(log_module_id, fmt, ##__VA_ARGS__)
+#if LOG_COMPILE_LEVEL <= 5
+#define LOG_FATAL(fmt, ...) LOG_AT_(fatal, fmt, ##__VA_ARGS__)
+#else
+#define LOG_FATAL(fmt, ...) ((void)0)
+#endif
 
 #define LOG_LEVEL_SET(level) Logger::getInstance().setLevel(level)
 #define LOG_FLUSH() Logger::getInstance().flush()
@@ -19,6 +19,7 @@
 #endif
 #if USE_DISPLAY
 #include <GxEPD2_BW.h>
+#include "panel_dma.h"
 #endif
 
 #if USE_DISPLAY
@@ -29,6 +30,9 @@
 #include "ui_generated.h"
 #include "display_capture.h"
 #include "dual_gfx.h"
+#include "display_smart_refresh.h"
+#include "render_model.h"
+#include "spec_draw.h"
 using namespace ui;
 #endif
 #include "generated_config.h"
@@ -88,267 +92,34 @@ static inline void draw_in_region(const int rect[4], DrawFnFwd drawFn);
       // waits
 #endif
 
-// 2.13" b/w class; choose the one matching your panel
-// B74 works for SSD1680/UC8151 variants used by many 2.13" panels
-// Alternative: DEPG0213BN (also SSD1680 family). Select via
-// -DEINK_PANEL_DEPG0213BN=1
+// Panel class selection (EINK_PANEL_DEPG0213BN) lives in panel_dma.h
 #if USE_DISPLAY
-#ifndef EINK_PANEL_DEPG0213BN
-#define EINK_PANEL_DEPG0213BN 0
-#endif
-#if EINK_PANEL_DEPG0213BN
-GxEPD2_BW<GxEPD2_213_DEPG0213BN, GxEPD2_213_DEPG0213BN::HEIGHT> display(
-    GxEPD2_213_DEPG0213BN(EINK_CS, EINK_DC, EINK_RST, EINK_BUSY));
-#else
-// Prefer the explicit GDEY0213B74 class name for clarity on SSD1680 FeatherWing
-GxEPD2_BW<GxEPD2_213_GDEY0213B74, GxEPD2_213_GDEY0213B74::HEIGHT> display(
-    GxEPD2_213_GDEY0213B74(EINK_CS, EINK_DC, EINK_RST, EINK_BUSY));
-#endif
+PanelDisplay display(PanelDriver(EINK_CS, EINK_DC, EINK_RST, EINK_BUSY));
 
 // Now that display exists, provide the implementation using it
 #if USE_UI_SPEC
-// Non-static so display_renderer.cpp can call it
-void draw_from_spec_full_impl(uint8_t variantId) {
-  // TOP_Y_OFFSET removed for spec alignment
-  using ui::ALIGN_CENTER;
-  using ui::ALIGN_LEFT;
-  using ui::ALIGN_RIGHT;
-  using ui::ComponentOps;
-  using ui::OP_LINE;
-  using ui::OP_TEMPGROUPCENTERED;
-  using ui::OP_TEXT;
-  using ui::OP_TIMERIGHT;
-  using ui::OP_TEXTCENTEREDIN;
-  using ui::OP_BATTERYGLYPH;
-  using ui::OP_ICONIN;
-  using ui::UiOpHeader;
-  
-  // Set up dual drawing to both display and screenshot canvas
-  GFXcanvas1* canvas = display_capture_canvas();
+// Non-static so display_renderer.cpp can call it.
+// Draws into the panel page buffer and, with capture, the screenshot canvas;
+// with capture false the screenshot canvas is left untouched.
+void draw_from_spec_rects_impl(uint8_t variantId, const RenderModel& m, uint32_t rectMask,
+                               bool capture) {
+  GFXcanvas1* canvas = capture ? display_capture_canvas() : nullptr;
   DualGFX gfx(&display, canvas);
-  DualGFXScope gfx_scope(&gfx);  // Set global context for helper functions
   if (canvas) {
     DisplayCapture::getInstance().setHasContent();
   }
-  
-  int comp_count = 0;
-  const ComponentOps* comps = get_variant_ops(variantId, &comp_count);
-  gfx.drawRect(0, 0, EINK_WIDTH, EINK_HEIGHT, GxEPD_BLACK);
-  gfx.drawLine(1, 18, EINK_WIDTH - 2, 18, GxEPD_BLACK);
-  gfx.drawLine(125, 18, 125, EINK_HEIGHT - 2, GxEPD_BLACK);
-  for (int ci = 0; ci < comp_count; ++ci) {
-    const ComponentOps& co = comps[ci];
-    for (int i = 0; i < co.count; ++i) {
-      const UiOpHeader& op = co.ops[i];
-      switch (op.kind) {
-        case ui::OP_LINE: {
-          int16_t x0 = op.p0, y0 = op.p1, x1 = op.p2, y1 = op.p3;
-          // Ensure correct endpoint order for iteration
-          if (x0 > x1) { int16_t t = x0; x0 = x1; x1 = t; }
-          if (y0 > y1) { int16_t t = y0; y0 = y1; y1 = t; }
-          if (y0 == y1) {
-            for (int16_t x = x0; x <= x1; ++x) gfx.drawPixel(x, y0, GxEPD_BLACK);
-          } else if (x0 == x1) {
-            for (int16_t y = y0; y <= y1; ++y) gfx.drawPixel(x0, y, GxEPD_BLACK);
-          }
-          break;
-        }
-        case ui::OP_TEXT: {
-          const int* r = rect_ptr_by_id(op.rect);
-          int16_t tx = op.p0;
-          int16_t ty = op.p1;
-          auto fmt_field = [&](const String& key) -> String {
-            static char buf[32];
-            if (key == "room_name")
-              return String(ROOM_NAME);
-            if (key == "ip") {
-              char ip_c[32];
-              net_ip_cstr(ip_c, sizeof(ip_c));
-              return String(ip_c);
-            }
-            if (key == "fw_version")
-              return String(FW_VERSION);
-            // Battery fields
-            if (key == "battery_percent" || key.startsWith("battery_voltage")) {
-              BatteryStatus bs = read_battery_status();
-              if (key == "battery_percent") {
-                snprintf(buf, sizeof(buf), "%d", bs.percent);
-                return String(buf);
-              }
-              // Handle battery_voltage:.2f format
-              snprintf(buf, sizeof(buf), "%.2f", bs.voltage);
-              return String(buf);
-            }
-            if (key == "days") {
-              BatteryStatus bs = read_battery_status();
-              snprintf(buf, sizeof(buf), "%d", bs.estimatedDays);
-              return String(buf);
-            }
-            // Inside sensor fields
-            if (key == "inside_hum_pct") {
-              InsideReadings ir = read_inside_sensors();
-              snprintf(buf, sizeof(buf), "%.0f", ir.humidityPct);
-              return String(buf);
-            }
-            if (key.startsWith("pressure_hpa")) {
-              InsideReadings ir = read_inside_sensors();
-              snprintf(buf, sizeof(buf), "%.1f", ir.pressureHPa);
-              return String(buf);
-            }
-            // Outside sensor fields
-            if (key == "outside_hum_pct") {
-              OutsideReadings o = net_get_outside();
-              snprintf(buf, sizeof(buf), "%.0f", o.humidityPct);
-              return String(buf);
-            }
-            if (key.startsWith("wind_mps")) {
-              OutsideReadings o = net_get_outside();
-              float mph = o.windMps * 2.237f;
-              snprintf(buf, sizeof(buf), "%.1f", mph);
-              return String(buf);
-            }
-            if (key == "weather") {
-              OutsideReadings o = net_get_outside();
-              return String(o.weather);
-            }
-            if (key == "time_hhmm") {
-              net_time_hhmm(buf, sizeof(buf));
-              return String(buf);
-            }
-            return String("--");
-          };
-          String templ = op.s0 ? op.s0 : "";
-          String out;
-          out.reserve(templ.length() + 8);
-          int start = 0;
-          while (true) {
-            int lb = templ.indexOf('{', start);
-            if (lb < 0) {
-              out += templ.substring(start);
-              break;
-            }
-            int rb = templ.indexOf('}', lb + 1);
-            if (rb < 0) {
-              out += templ.substring(start);
-              break;
-            }
-            out += templ.substring(start, lb);
-            String key = templ.substring(lb + 1, rb);
-            out += fmt_field(key);
-            start = rb + 1;
-          }
-          gfx.setTextColor(GxEPD_BLACK);
-          gfx.setTextSize(1);
-          // Handle rect-based positioning for all alignments (LEFT, RIGHT, CENTER)
-          if (r && tx == 0) {
-            int16_t tw = text_width_default_font(out.c_str(), 1);
-            if (op.align == ALIGN_LEFT)
-              tx = r[0] + 1;  // Left-align: start at rect's left edge
-            else if (op.align == ALIGN_RIGHT)
-              tx = r[0] + r[2] - 2 - tw;
-            else if (op.align == ALIGN_CENTER)
-              tx = r[0] + (r[2] - tw) / 2;
-            // Use y-offset (p1) if provided, otherwise default to +1
-            ty = r[1] + (op.p1 != 0 ? op.p1 : 1);
-          }
-          gfx.setCursor(tx, ty);
-          gfx.print(out.c_str());
-          break;
-        }
-        case OP_TIMERIGHT: {
-          const int* r = rect_ptr_by_id(op.rect);
-          if (!r) break;
-          char hhmm[8];
-          net_time_hhmm(hhmm, sizeof(hhmm));
-          int16_t tw = text_width_default_font(hhmm, 1);
-          int16_t rx = static_cast<int16_t>(r[0] + r[2] - 2 - tw);
-          int16_t by = static_cast<int16_t>(r[1] + r[3] - 2);
-          gfx.setTextColor(GxEPD_BLACK);
-          gfx.setTextSize(1);
-          gfx.setCursor(rx, by);
-          gfx.print(hhmm);
-          break;
-        }
-        // OP_LABELCENTERED removed - no longer in ui_spec.json
-        case OP_TEMPGROUPCENTERED: {
-          const int* r = rect_ptr_by_id(op.rect);
-          if (!r)
-            break;
-          char temp_buf[16];
-          temp_buf[0] = 0;
-          // Check by rect ID, not pointer comparison
-          if (op.rect == ui::RECT_INSIDE_TEMP) {
-            InsideReadings ir = read_inside_sensors();
-            if (isfinite(ir.temperatureC)) {
-              float tempF = ir.temperatureC * 9.0f / 5.0f + 32.0f;
-              snprintf(temp_buf, sizeof(temp_buf), "%.0f", tempF);
-            } else {
-              snprintf(temp_buf, sizeof(temp_buf), "--");
-            }
-          } else if (op.rect == ui::RECT_OUT_TEMP) {
-            OutsideReadings orr = net_get_outside();
-            if (orr.validTemp && isfinite(orr.temperatureC)) {
-              float tempF = orr.temperatureC * 9.0f / 5.0f + 32.0f;
-              snprintf(temp_buf, sizeof(temp_buf), "%.0f", tempF);
-            } else if (isfinite(get_last_outside_f())) {
-              snprintf(temp_buf, sizeof(temp_buf), "%.0f", get_last_outside_f());
-            } else {
-              snprintf(temp_buf, sizeof(temp_buf), "--");
-            }
-          }
-          // Use direct draw (no displayWindow call) during full refresh
-          draw_temp_number_and_units_direct(r[0], r[1], r[2], r[3], temp_buf);
-          break;
-        }
-        case OP_ICONIN: {
-          const int* r = rect_ptr_by_id(op.rect);
-          if (!r)
-            break;
-          OutsideReadings o = net_get_outside();
-          if (o.validWeather && o.weather[0]) {
-            draw_weather_icon_region_at(r[0], r[1], r[2], r[3], o.weather);
-          }
-          break;
-        }
-        // OP_SHORTCONDITION removed - no longer in ui_spec.json
-        case OP_TEXTCENTEREDIN: {
-          const int* r = rect_ptr_by_id(op.rect);
-          if (!r)
-            break;
-          String templ = op.s0 ? op.s0 : "";
-          char ip_c[32];
-          net_ip_cstr(ip_c, sizeof(ip_c));
-          templ.replace("{ip}", ip_c);
-          gfx.setTextColor(GxEPD_BLACK);
-          gfx.setTextSize(1);
-          int16_t tw = text_width_default_font(templ.c_str(), 1);
-          int16_t tx = r[0] + (r[2] - tw) / 2;
-          int16_t ty = r[1] + op.p0;
-          gfx.setCursor(tx, ty);
-          gfx.print(templ.c_str());
-          break;
-        }
-        case OP_BATTERYGLYPH: {
-          BatteryStatus bs = read_battery_status();
-          int16_t bx = op.p0, by = op.p1, bw = op.p2, bh = op.p3;
-          gfx.drawRect(bx, by, bw, bh, GxEPD_BLACK);
-          gfx.fillRect(static_cast<int16_t>(bx + bw), static_cast<int16_t>(by + 2), 2, 3,
-                       GxEPD_BLACK);
-          // Clamp percent to 0-100 to prevent fill exceeding bounds
-          int pct_clamped = (bs.percent > 100) ? 100 : ((bs.percent < 0) ? 0 : bs.percent);
-          int16_t max_fillw = (bw > 2) ? static_cast<int16_t>(bw - 2) : 0;
-          int16_t fillw = static_cast<int16_t>((max_fillw * (pct_clamped / 100.0f) + 0.5f));
-          if (fillw > max_fillw) fillw = max_fillw;  // Safety clamp
-          if (fillw > 0 && max_fillw > 0)
-            gfx.fillRect(static_cast<int16_t>(bx + 1), static_cast<int16_t>(by + 1), fillw,
-                         static_cast<int16_t>(bh - 2), GxEPD_BLACK);
-          break;
-        }
-        default:
-          break;
-      }
-    }
-  }  // USE_UI_SPEC
+  spec_draw_ops(gfx, variantId, m, rectMask);
+}
+
+void draw_from_spec_full_impl(uint8_t variantId, const RenderModel& m) {
+  draw_from_spec_rects_impl(variantId, m, 0xFFFFFFFFu, true);
+}
+
+// Single pass into a cleared canvas only; the caller blits it to the panel
+void draw_from_spec_canvas_impl(uint8_t variantId, const RenderModel& m, GFXcanvas1* canvas) {
+  DualGFX gfx(canvas, nullptr, true);
+  DisplayCapture::getInstance().setHasContent();
+  spec_draw_ops(gfx, variantId, m, 0xFFFFFFFFu);
 }
 #endif  // USE_UI_SPEC
 #endif  // USE_DISPLAY
@@ -411,16 +182,6 @@ static const char* wakeup_cause_str(esp_sleep_wakeup_cause_t c);
 
 // Function moved to display_renderer module
 
-static inline void net_publish_layout_identity() {
-  if (!mqtt_is_connected())
-    return;
-  char topic[128];
-  snprintf(topic, sizeof(topic), "%s/layout", MQTT_PUB_BASE);
-  char payload[96];
-  snprintf(payload, sizeof(payload), "{\"layout_version\":%u,\"layout_crc\":\"0x%08X\"}",
-           static_cast<unsigned>(LAYOUT_VERSION), static_cast<unsigned>(LAYOUT_CRC));
-  mqtt_publish_raw(topic, payload, true);
-}
 // needs_full_on_boot now managed in state_manager module
 // g_full_only_mode now managed in state_manager module
 #ifdef FORCE_FULL_ONLY
@@ -1,8 +1,71 @@
 #include "memory_tracking.h"
+#include "rtc_state.h"
 #include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#if CONFIG_HEAP_TRACING_STANDALONE
+#include <esp_heap_trace.h>
+#endif
+
+MemoryTracker::MemoryStats& MemoryTracker::stats_ = g_rtc_state.memory;
 
 // RTC memory - persists across deep sleep
-RTC_DATA_ATTR MemoryTracker::MemoryStats MemoryTracker::stats_ = {};
+RTC_DATA_ATTR MemoryTracker::PhaseAllocs MemoryTracker::last_wake_[MemoryTracker::PHASE_COUNT] = {};
+
+// Set once begin() has run; the heap hooks must not construct the singleton
+// (its guard may itself allocate)
+static MemoryTracker* g_tracker = nullptr;
+
+static const char* const kPhaseNames[MemoryTracker::PHASE_COUNT] = {
+    "boot", "connect", "sensor", "publish", "display", "deferred", "sleep"
+};
+
+#if CONFIG_HEAP_TRACING_STANDALONE
+// Outstanding allocations for heap_trace_dump() (leak mode)
+static heap_trace_record_t g_trace_records[MEMORY_HEAP_TRACE_RECORDS];
+#endif
+
+static void on_alloc_failed(size_t size, uint32_t caps, const char* function_name) {
+    if (g_tracker) g_tracker->noteFailed(size, caps, function_name);
+}
+
+#if MEMORY_ALLOC_HOOKS
+// Linker wrappers (-Wl,--wrap=malloc etc.): every allocation in the image,
+// including Arduino core and library code, passes through here
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    void* p = __real_malloc(size);
+    if (g_tracker && p) g_tracker->noteAlloc(heap_caps_get_allocated_size(p));
+    return p;
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    void* p = __real_calloc(n, size);
+    if (g_tracker && p) g_tracker->noteAlloc(heap_caps_get_allocated_size(p));
+    return p;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    size_t old_bytes = (g_tracker && ptr) ? heap_caps_get_allocated_size(ptr) : 0;
+    void* p = __real_realloc(ptr, size);
+    if (g_tracker && (p || size == 0)) {
+        if (old_bytes) g_tracker->noteFree(old_bytes);
+        if (p) g_tracker->noteAlloc(heap_caps_get_allocated_size(p));
+    }
+    return p;
+}
+
+void __wrap_free(void* ptr) {
+    if (g_tracker && ptr) g_tracker->noteFree(heap_caps_get_allocated_size(ptr));
+    __real_free(ptr);
+}
+}
+#endif
 
 MemoryTracker::MemoryTracker() {
     // Constructor intentionally minimal - initialization in begin()
@@ -25,6 +88,17 @@ void MemoryTracker::begin() {
     stats_.total_allocations = 0;
     stats_.failed_allocations = 0;
 
+    memset(phases_, 0, sizeof(phases_));
+    phase_ = PHASE_BOOT;
+    g_tracker = this;
+    heap_caps_register_failed_alloc_callback(on_alloc_failed);
+
+#if CONFIG_HEAP_TRACING_STANDALONE
+    if (heap_trace_init_standalone(g_trace_records, MEMORY_HEAP_TRACE_RECORDS) == ESP_OK) {
+        heap_trace_start(HEAP_TRACE_LEAKS);
+    }
+#endif
+
     // Initial update
     update();
 
@@ -35,7 +109,7 @@ void MemoryTracker::update() {
     updateHeapWatermarks();
 
     // Update stack watermark
-    uint32_t stack_usage = estimateStackUsage();
+    uint32_t stack_usage = loopStackUsed();
     if (stack_usage > stats_.stack_high_watermark) {
         stats_.stack_high_watermark = stack_usage;
     }
@@ -58,23 +132,106 @@ void MemoryTracker::update() {
         }
     }
     #endif
+
+    sampleStacks();
 }
 
 void MemoryTracker::recordAllocation(size_t size, bool success) {
-    stats_.total_allocations++;
+    // Failures are counted by the failed-alloc callback; successes by the
+    // heap hooks when they are active
+    if (!success) return;
+    if (size > stats_.largest_allocation) {
+        stats_.largest_allocation = size;
+    }
+    if (!hooksActive()) stats_.total_allocations++;
+}
+
+bool MemoryTracker::hooksActive() const {
+    return MEMORY_ALLOC_HOOKS != 0;
+}
 
-    if (success) {
-        if (size > stats_.largest_allocation) {
-            stats_.largest_allocation = size;
+void MemoryTracker::setPhase(Phase p) {
+    if (p < PHASE_COUNT) phase_ = p;
+}
+
+void MemoryTracker::noteAlloc(size_t bytes) {
+    PhaseAllocs& a = phases_[phase_];
+    __atomic_fetch_add(&a.allocs, 1u, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&a.bytes, (uint32_t)bytes, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats_.total_allocations, 1u, __ATOMIC_RELAXED);
+    // Racy max; good enough for a watermark
+    if (bytes > stats_.largest_allocation) stats_.largest_allocation = bytes;
+}
+
+void MemoryTracker::noteFree(size_t bytes) {
+    __atomic_fetch_add(&phases_[phase_].freed_bytes, (uint32_t)bytes, __ATOMIC_RELAXED);
+}
+
+void MemoryTracker::noteFailed(size_t requested, uint32_t caps, const char* function_name) {
+    (void)function_name;
+    __atomic_fetch_add(&phases_[phase_].failed, 1u, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats_.failed_allocations, 1u, __ATOMIC_RELAXED);
+    last_failed_size_ = (uint32_t)requested;
+    last_failed_caps_ = caps;
+}
+
+void MemoryTracker::endWake() {
+    memcpy(last_wake_, phases_, sizeof(last_wake_));
+}
+
+void MemoryTracker::sampleStacks() {
+#if configUSE_TRACE_FACILITY
+    static TaskStatus_t status[MAX_TASKS + 4];
+    UBaseType_t n = uxTaskGetSystemState(status, sizeof(status) / sizeof(status[0]), nullptr);
+    for (UBaseType_t i = 0; i < n; i++) {
+        // ESP-IDF stacks are sized in bytes
+        uint32_t free_bytes = status[i].usStackHighWaterMark;
+        const char* name = status[i].pcTaskName;
+        size_t slot = 0;
+        while (slot < stack_count_ && strncmp(stacks_[slot].name, name, sizeof(stacks_[slot].name) - 1) != 0) {
+            slot++;
+        }
+        if (slot == stack_count_) {
+            if (stack_count_ == MAX_TASKS) continue;
+            strncpy(stacks_[slot].name, name, sizeof(stacks_[slot].name) - 1);
+            stacks_[slot].name[sizeof(stacks_[slot].name) - 1] = '\0';
+            stacks_[slot].min_free = free_bytes;
+            stack_count_++;
+        } else if (free_bytes < stacks_[slot].min_free) {
+            stacks_[slot].min_free = free_bytes;
         }
-    } else {
-        stats_.failed_allocations++;
     }
+#else
+    // Without the trace facility only the calling task can be sampled
+    const char* name = pcTaskGetTaskName(nullptr);
+    uint32_t free_bytes = uxTaskGetStackHighWaterMark(nullptr);
+    if (stack_count_ == 0) {
+        strncpy(stacks_[0].name, name, sizeof(stacks_[0].name) - 1);
+        stacks_[0].name[sizeof(stacks_[0].name) - 1] = '\0';
+        stacks_[0].min_free = free_bytes;
+        stack_count_ = 1;
+    } else if (free_bytes < stacks_[0].min_free) {
+        stacks_[0].min_free = free_bytes;
+    }
+#endif
+}
+
+void MemoryTracker::dumpHeapTrace() {
+#if CONFIG_HEAP_TRACING_STANDALONE
+    heap_trace_dump();
+#else
+    Serial.println("[MEM] Heap tracing not in this build (CONFIG_HEAP_TRACING_STANDALONE)");
+#endif
+}
+
+const char* MemoryTracker::phaseName(Phase p) {
+    return p < PHASE_COUNT ? kPhaseNames[p] : "?";
 }
 
 void MemoryTracker::resetCounters() {
     stats_.total_allocations = 0;
     stats_.failed_allocations = 0;
+    memset(phases_, 0, sizeof(phases_));
 }
 
 void MemoryTracker::resetAll() {
@@ -86,6 +243,9 @@ void MemoryTracker::resetAll() {
     stats_.failed_allocations = 0;
     stats_.fragmentation_peak = 0;
     stats_.psram_high_watermark = 0;
+    memset(phases_, 0, sizeof(phases_));
+    memset(last_wake_, 0, sizeof(last_wake_));
+    stack_count_ = 0;
 
     // Re-initialize
     update();
@@ -99,6 +259,9 @@ void MemoryTracker::formatStatsJson(char* out, size_t out_size) const {
             "\"largest_alloc\":%u,"
             "\"total_allocs\":%u,"
             "\"failed_allocs\":%u,"
+            "\"last_fail_size\":%u,"
+            "\"last_fail_caps\":%u,"
+            "\"alloc_hooks\":%d,"
             "\"frag_peak_pct\":%u,"
             "\"total_heap\":%u,"
             "\"psram_high_wm\":%u}",
@@ -108,11 +271,92 @@ void MemoryTracker::formatStatsJson(char* out, size_t out_size) const {
             stats_.largest_allocation,
             stats_.total_allocations,
             stats_.failed_allocations,
+            last_failed_size_,
+            last_failed_caps_,
+            hooksActive() ? 1 : 0,
             stats_.fragmentation_peak,
             stats_.total_heap_size,
             stats_.psram_high_watermark);
 }
 
+// Writes [[allocs,bytes,freed,failed],...] for one phase table
+static size_t format_phase_table(char* out, size_t out_size, const MemoryTracker::PhaseAllocs* t) {
+    size_t pos = 0;
+    for (size_t p = 0; p < MemoryTracker::PHASE_COUNT && pos < out_size; p++) {
+        int n = snprintf(out + pos, out_size - pos, "%s[%u,%u,%u,%u]", p ? "," : "[",
+                         t[p].allocs, t[p].bytes, t[p].freed_bytes, t[p].failed);
+        if (n < 0) break;
+        pos += (size_t)n;
+    }
+    if (pos < out_size) {
+        int n = snprintf(out + pos, out_size - pos, "]");
+        if (n > 0) pos += (size_t)n;
+    }
+    return pos;
+}
+
+void MemoryTracker::formatPhasesJson(char* out, size_t out_size) const {
+    if (!out || out_size == 0) return;
+    int n = snprintf(out, out_size, "{\"hooks\":%d,\"ph\":[", hooksActive() ? 1 : 0);
+    size_t pos = n > 0 ? (size_t)n : 0;
+    for (size_t p = 0; p < PHASE_COUNT && pos < out_size; p++) {
+        n = snprintf(out + pos, out_size - pos, "%s\"%s\"", p ? "," : "", kPhaseNames[p]);
+        if (n > 0) pos += (size_t)n;
+    }
+    if (pos < out_size) {
+        n = snprintf(out + pos, out_size - pos, "],\"cur\":");
+        if (n > 0) pos += (size_t)n;
+    }
+    if (pos < out_size) pos += format_phase_table(out + pos, out_size - pos, phases_);
+    if (pos < out_size) {
+        n = snprintf(out + pos, out_size - pos, ",\"last\":");
+        if (n > 0) pos += (size_t)n;
+    }
+    if (pos < out_size) pos += format_phase_table(out + pos, out_size - pos, last_wake_);
+    if (pos < out_size) snprintf(out + pos, out_size - pos, "}");
+}
+
+void MemoryTracker::formatStacksJson(char* out, size_t out_size) const {
+    if (!out || out_size == 0) return;
+    int n = snprintf(out, out_size, "{\"tasks\":[");
+    size_t pos = n > 0 ? (size_t)n : 0;
+    for (size_t i = 0; i < stack_count_ && pos < out_size; i++) {
+        n = snprintf(out + pos, out_size - pos, "%s[\"%s\",%u]", i ? "," : "",
+                     stacks_[i].name, stacks_[i].min_free);
+        if (n > 0) pos += (size_t)n;
+    }
+    if (pos < out_size) snprintf(out + pos, out_size - pos, "]}");
+}
+
+static void write_phase_table(JsonStream& j, const char* key, const MemoryTracker::PhaseAllocs* t) {
+    j.beginArray(key);
+    for (size_t p = 0; p < MemoryTracker::PHASE_COUNT; p++) {
+        j.beginArray()
+         .field(nullptr, t[p].allocs)
+         .field(nullptr, t[p].bytes)
+         .field(nullptr, t[p].freed_bytes)
+         .field(nullptr, t[p].failed)
+         .endArray();
+    }
+    j.endArray();
+}
+
+void MemoryTracker::writePhasesJson(JsonStream& j) const {
+    j.field("hooks", hooksActive() ? 1 : 0).beginArray("ph");
+    for (size_t p = 0; p < PHASE_COUNT; p++) j.field(nullptr, kPhaseNames[p]);
+    j.endArray();
+    write_phase_table(j, "cur", phases_);
+    write_phase_table(j, "last", last_wake_);
+}
+
+void MemoryTracker::writeStacksJson(JsonStream& j) const {
+    j.beginArray("tasks");
+    for (size_t i = 0; i < stack_count_; i++) {
+        j.beginArray().field(nullptr, stacks_[i].name).field(nullptr, stacks_[i].min_free).endArray();
+    }
+    j.endArray();
+}
+
 float MemoryTracker::getCurrentFragmentation() const {
     uint32_t free_heap = esp_get_free_heap_size();
     if (free_heap == 0) return 100.0f;
@@ -146,25 +390,10 @@ void MemoryTracker::updateHeapWatermarks() {
     }
 }
 
-uint32_t MemoryTracker::estimateStackUsage() const {
-    // ESP32-specific stack estimation
-    // This is approximate - gets the current stack pointer distance from base
-
-    // Get stack base (approximate - varies by core and task)
-    #if CONFIG_FREERTOS_UNICORE
-    const uint32_t STACK_BASE = 0x3FFB0000;  // Approximate for core 0
-    #else
-    const uint32_t STACK_BASE = 0x3FFB8000;  // Approximate for SMP
-    #endif
-
-    // Get current stack pointer (inline assembly)
-    uint32_t sp;
-    __asm__ __volatile__("mov %0, sp" : "=r"(sp));
-
-    // Calculate usage (stack grows downward)
-    if (sp < STACK_BASE) {
-        return STACK_BASE - sp;
-    }
-
-    return 0;
+uint32_t MemoryTracker::loopStackUsed() const {
+    // High-water mark of the calling task (the Arduino loop task for every
+    // caller of update()), in bytes on ESP-IDF
+    uint32_t size = getArduinoLoopTaskStackSize();
+    uint32_t free_bytes = uxTaskGetStackHighWaterMark(nullptr);
+    return free_bytes < size ? size - free_bytes : 0;
 }
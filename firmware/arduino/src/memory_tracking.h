@@ -3,13 +3,24 @@
 #include <Arduino.h>
 #include <esp_system.h>
 #include <esp_heap_caps.h>
+#include "feature_flags.h"
+#include "config.h"
+#include "json_stream.h"
 
 // Memory high watermark tracking system
 // Tracks peak memory usage and allocation patterns
 // Stores data in RTC memory to persist across deep sleep
 //
+// Allocations are observed at the heap, not reported by callers: failed
+// allocations through heap_caps_register_failed_alloc_callback, and with
+// MEMORY_ALLOC_HOOKS every malloc/calloc/realloc/free (linker --wrap, see
+// config.h). Counts and bytes are attributed to the wake phase set with
+// MEM_PHASE(), so a module that churns or leaks shows up in its phase.
+// Stack headroom is sampled per task from the FreeRTOS high-water marks.
+//
 // Usage:
 //   MemoryTracker::getInstance().begin();
+//   MEM_PHASE(CONNECT);                    // Attribute what follows to a phase
 //
 //   // Periodically update
 //   MemoryTracker::getInstance().update();
@@ -17,13 +28,15 @@
 //   // Query stats
 //   auto stats = MemoryTracker::getInstance().getStats();
 //   Serial.printf("Peak heap used: %u bytes\n", stats.heap_high_watermark);
+//
+//   MemoryTracker::getInstance().endWake();   // Before deep sleep
 
 class MemoryTracker {
 public:
     struct MemoryStats {
         uint32_t heap_high_watermark;      // Maximum heap usage seen
         uint32_t heap_low_watermark;       // Minimum free heap seen
-        uint32_t stack_high_watermark;     // Maximum stack usage (estimated)
+        uint32_t stack_high_watermark;     // Maximum loop task stack usage (high-water mark)
         uint32_t largest_allocation;       // Largest single allocation seen
         uint32_t total_allocations;        // Total allocation count (resets on reboot)
         uint32_t failed_allocations;       // Failed allocation count (resets on reboot)
@@ -32,6 +45,32 @@ public:
         uint32_t psram_high_watermark;     // PSRAM peak usage (if available)
     };
 
+    enum Phase : uint8_t {
+        PHASE_BOOT = 0,
+        PHASE_CONNECT,      // WiFi, mDNS, MQTT
+        PHASE_SENSOR,
+        PHASE_PUBLISH,
+        PHASE_DISPLAY,
+        PHASE_DEFERRED,     // Timeline, perf summary, HA discovery
+        PHASE_SLEEP,
+        PHASE_COUNT
+    };
+
+    // Heap activity within one phase (bytes are allocator block sizes)
+    struct PhaseAllocs {
+        uint32_t allocs;
+        uint32_t bytes;
+        uint32_t freed_bytes;
+        uint32_t failed;
+    };
+
+    struct TaskStack {
+        char name[16];
+        uint32_t min_free;                 // Lowest stack headroom seen this boot (bytes)
+    };
+
+    static constexpr size_t MAX_TASKS = 12;
+
     static MemoryTracker& getInstance();
 
     void begin();
@@ -42,6 +81,39 @@ public:
     // Record an allocation attempt
     void recordAllocation(size_t size, bool success);
 
+    // Attribute heap activity from here on to phase p
+    void setPhase(Phase p);
+
+    // Copy this wake's per-phase counters to RTC for the next wake
+    void endWake();
+
+    // Sample every task's stack high-water mark
+    void sampleStacks();
+
+    // True when every heap allocation is counted (MEMORY_ALLOC_HOOKS)
+    bool hooksActive() const;
+
+    // {"ph":[...],"cur":[[allocs,bytes,freed,failed],...],"last":[...]}
+    void formatPhasesJson(char* out, size_t out_size) const;
+
+    // {"tasks":[["name",min_free],...]}
+    void formatStacksJson(char* out, size_t out_size) const;
+
+    // Streamed forms of the two above, members only (into an open object)
+    void writePhasesJson(JsonStream& j) const;
+    void writeStacksJson(JsonStream& j) const;
+
+    // Print outstanding allocations with their callers when the IDF build
+    // has standalone heap tracing (leak mode, started by begin())
+    void dumpHeapTrace();
+
+    static const char* phaseName(Phase p);
+
+    // Heap hooks; public so the C allocation wrappers can reach them
+    void noteAlloc(size_t bytes);
+    void noteFree(size_t bytes);
+    void noteFailed(size_t requested, uint32_t caps, const char* function_name);
+
     // Get current statistics
     const MemoryStats& getStats() const { return stats_; }
 
@@ -63,14 +135,29 @@ private:
     MemoryTracker(const MemoryTracker&) = delete;
     MemoryTracker& operator=(const MemoryTracker&) = delete;
 
-    // RTC memory storage (persists across deep sleep)
-    RTC_DATA_ATTR static MemoryStats stats_;
+    // Lives in the consolidated RTC block (rtc_state.h)
+    static MemoryStats& stats_;
+
+    // Last complete wake, by phase
+    RTC_DATA_ATTR static PhaseAllocs last_wake_[PHASE_COUNT];
 
     bool initialized_ = false;
+    volatile uint8_t phase_ = PHASE_BOOT;
+    PhaseAllocs phases_[PHASE_COUNT] = {};
+    TaskStack stacks_[MAX_TASKS] = {};
+    size_t stack_count_ = 0;
+    uint32_t last_failed_size_ = 0;
+    uint32_t last_failed_caps_ = 0;
 
     // Update heap watermarks
     void updateHeapWatermarks();
 
-    // Estimate stack usage (ESP32-specific)
-    uint32_t estimateStackUsage() const;
+    // Loop task stack used so far, from its high-water mark
+    uint32_t loopStackUsed() const;
 };
+
+#if FEATURE_MEMORY_TRACKING
+  #define MEM_PHASE(p) MemoryTracker::getInstance().setPhase(MemoryTracker::PHASE_##p)
+#else
+  #define MEM_PHASE(p) ((void)0)
+#endif
@@ -1,11 +1,17 @@
 // Metrics and diagnostics implementation
 #include "metrics_diagnostics.h"
+#include "rtc_state.h"
 #include "generated_config.h"
 #if USE_DISPLAY
 #include "display_layout.h"
 #endif
 #include "net.h"
 #include "mqtt_client.h"
+#include "mqtt_batcher.h"
+#include "topic_table.h"
+#include "system_manager.h"
+#include "diag_document.h"
+#include "code_placement.h"
 #include "safe_strings.h"  // Add safe string operations
 #include "logging.h"       // Add logging infrastructure
 #include <time.h>
@@ -14,19 +20,12 @@
 #include <Adafruit_NeoPixel.h>
 #endif
 
-// Error statistics (persist across deep sleep)
-RTC_DATA_ATTR ErrorStats g_error_stats = {0};
+// Error statistics (consolidated RTC block, persist across deep sleep)
+ErrorStats& g_error_stats = g_rtc_state.errors;
 
 // Global diagnostic mode flag
 static bool g_diagnostic_mode = false;
 
-// RTC variables for boot tracking (persist across deep sleep)
-RTC_DATA_ATTR static uint32_t rtc_boot_count = 0;           // Total boots since power-on
-RTC_DATA_ATTR static uint32_t rtc_crash_count = 0;          // Count of abnormal resets
-RTC_DATA_ATTR static uint32_t rtc_cumulative_uptime_sec = 0; // Total awake time in seconds
-RTC_DATA_ATTR static uint32_t rtc_last_boot_timestamp = 0;   // Timestamp of last boot
-RTC_DATA_ATTR static esp_reset_reason_t rtc_last_reset_reason = ESP_RST_UNKNOWN;
-
 // Status pixel object if enabled
 #if USE_STATUS_PIXEL
 static Adafruit_NeoPixel* g_status_pixel = nullptr;
@@ -56,39 +55,38 @@ void increment_error_stat(const char* stat_name) {
     g_error_stats.wifi_disconnects++;
   } else if (strcmp(stat_name, "mqtt_publish_fail") == 0) {
     g_error_stats.mqtt_publish_failures++;
+  } else if (strcmp(stat_name, "phase_overrun") == 0) {
+    g_error_stats.phase_overruns++;
   }
 }
 
-void reset_error_stats() {
+COLD_PATH void reset_error_stats() {
   memset(&g_error_stats, 0, sizeof(g_error_stats));
 }
 
-void publish_error_stats() {
+COLD_PATH void publish_error_stats() {
   if (!mqtt_is_connected()) return;
 
-  char topic_buf[96];
   char payload[32];
 
   // Publish each stat
   snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_error_stats.mqtt_payload_truncations);
-  snprintf(topic_buf, sizeof(topic_buf), "espsensor/%s/debug/errors/truncations", mqtt_get_client_id());
-  mqtt_publish_raw(topic_buf, payload, false);
+  mqtt_publish_raw(topic_get(TOPIC_DEBUG_ERR_TRUNCATIONS), payload, false);
 
   snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_error_stats.rtc_memory_corruptions);
-  snprintf(topic_buf, sizeof(topic_buf), "espsensor/%s/debug/errors/rtc_corruptions", mqtt_get_client_id());
-  mqtt_publish_raw(topic_buf, payload, false);
+  mqtt_publish_raw(topic_get(TOPIC_DEBUG_ERR_RTC_CORRUPTIONS), payload, false);
 
   snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_error_stats.sensor_read_failures);
-  snprintf(topic_buf, sizeof(topic_buf), "espsensor/%s/debug/errors/sensor_failures", mqtt_get_client_id());
-  mqtt_publish_raw(topic_buf, payload, false);
+  mqtt_publish_raw(topic_get(TOPIC_DEBUG_ERR_SENSOR_FAILURES), payload, false);
 
   snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_error_stats.wifi_disconnects);
-  snprintf(topic_buf, sizeof(topic_buf), "espsensor/%s/debug/errors/wifi_disconnects", mqtt_get_client_id());
-  mqtt_publish_raw(topic_buf, payload, false);
+  mqtt_publish_raw(topic_get(TOPIC_DEBUG_ERR_WIFI_DISCONNECTS), payload, false);
 
   snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_error_stats.mqtt_publish_failures);
-  snprintf(topic_buf, sizeof(topic_buf), "espsensor/%s/debug/errors/mqtt_failures", mqtt_get_client_id());
-  mqtt_publish_raw(topic_buf, payload, false);
+  mqtt_publish_raw(topic_get(TOPIC_DEBUG_ERR_MQTT_FAILURES), payload, false);
+
+  snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_error_stats.phase_overruns);
+  mqtt_publish_raw(topic_get(TOPIC_DEBUG_ERR_PHASE_OVERRUNS), payload, false);
 }
 
 uint32_t get_error_stat(const char* stat_name) {
@@ -102,6 +100,8 @@ uint32_t get_error_stat(const char* stat_name) {
     return g_error_stats.wifi_disconnects;
   } else if (strcmp(stat_name, "mqtt_publish_fail") == 0) {
     return g_error_stats.mqtt_publish_failures;
+  } else if (strcmp(stat_name, "phase_overrun") == 0) {
+    return g_error_stats.phase_overruns;
   }
   return 0;
 }
@@ -119,16 +119,16 @@ bool check_rapid_reset_diagnostic_trigger() {
   
   // Check if last boot was recent (rapid reset indicator)
   // Guard against clock reset or wrap: only compare if current >= last boot
-  if (rtc_last_boot_timestamp > 0 && current_time >= rtc_last_boot_timestamp) {
-    uint32_t time_since_last_boot = current_time - rtc_last_boot_timestamp;
+  if (g_rtc_state.last_boot_timestamp > 0 && current_time >= g_rtc_state.last_boot_timestamp) {
+    uint32_t time_since_last_boot = current_time - g_rtc_state.last_boot_timestamp;
     
     // Check both time-based and count-based triggers
     bool is_rapid_boot = (time_since_last_boot < RAPID_RESET_THRESHOLD_SEC);
-    bool has_many_crashes = (rtc_crash_count >= RAPID_RESET_COUNT_TRIGGER);
+    bool has_many_crashes = (g_rtc_state.crash_count >= RAPID_RESET_COUNT_TRIGGER);
     
     if (is_rapid_boot && has_many_crashes) {
       LOG_WARN("Rapid reset trigger: %u crashes in %u seconds", 
-               rtc_crash_count, time_since_last_boot);
+               g_rtc_state.crash_count, time_since_last_boot);
       return true;
     }
   }
@@ -153,38 +153,22 @@ void emit_metrics_json(float tempC, float rhPct, float pressHPa) {
   mqtt_publish_debug_json(json, false);
 }
 
-// Publish layout identity for UI parity checking
-void publish_layout_identity() {
-  if (!mqtt_is_connected()) {
-    return;
-  }
-  
-  mqtt_topic_t topic;  // Use pre-sized buffer type
-  safe_snprintf(topic, "%s/layout", MQTT_PUB_BASE);
-  
-  char payload[96];
-  #if USE_DISPLAY
-  safe_snprintf(payload, 
-           "{\"layout_version\":%u,\"layout_crc\":\"0x%08X\"}",
-           static_cast<unsigned>(LAYOUT_VERSION), 
-           static_cast<unsigned>(LAYOUT_CRC));
-  #else
-  safe_snprintf(payload, 
-           "{\"layout_version\":%u,\"layout_crc\":\"%s\"}",
-           0u,
-           "N/A");
-  #endif
-  
-  mqtt_publish_raw(topic, payload, true);
-}
-
 // Pump network for a duration to receive MQTT messages
+// Sleeps on the broker socket between packets instead of a fixed poll delay,
+// so each message is handled as soon as it arrives
 void pump_network_ms(uint32_t duration_ms) {
   uint32_t start = millis();
   
   while (millis() - start < duration_ms) {
     net_loop();
-    delay(10);
+
+    uint32_t remaining = duration_ms - (millis() - start);
+    if (remaining > duration_ms) break;  // Elapsed during net_loop()
+    #if USE_STATUS_PIXEL
+    // Keep the status animation ticking (250 ms steps)
+    if (remaining > 50) remaining = 50;
+    #endif
+    mqtt_wait_for_data(remaining);
     
     #if USE_STATUS_PIXEL
     status_pixel_tick();
@@ -192,6 +176,29 @@ void pump_network_ms(uint32_t duration_ms) {
   }
 }
 
+// Pump network until the retained outside data manifest is complete
+uint32_t pump_network_until_retained(uint32_t timeout_ms) {
+  uint32_t start = millis();
+
+  while (millis() - start < timeout_ms) {
+    net_loop();
+    if (mqtt_retained_complete()) break;
+
+    uint32_t remaining = timeout_ms - (millis() - start);
+    if (remaining > timeout_ms) break;  // Elapsed during net_loop()
+    #if USE_STATUS_PIXEL
+    if (remaining > 50) remaining = 50;
+    #endif
+    mqtt_wait_for_data(remaining);
+
+    #if USE_STATUS_PIXEL
+    status_pixel_tick();
+    #endif
+  }
+
+  return millis() - start;
+}
+
 // Get current time as HH:MM string
 void net_time_hhmm(char* out, size_t out_size) {
   if (!out || out_size < 6) {
@@ -279,17 +286,17 @@ void status_pixel_tick() {
 // Boot and crash tracking functions
 void update_boot_counters() {
   esp_reset_reason_t current_reset_reason = esp_reset_reason();
-  rtc_last_reset_reason = current_reset_reason;
+  g_rtc_state.last_reset_reason = current_reset_reason;
   
   // Update boot and crash counters
   if (current_reset_reason == ESP_RST_POWERON) {
     // Power-on reset: clear all counters
-    rtc_boot_count = 1;
-    rtc_crash_count = 0;
-    rtc_cumulative_uptime_sec = 0;
+    g_rtc_state.boot_count = 1;
+    g_rtc_state.crash_count = 0;
+    g_rtc_state.cumulative_uptime_sec = 0;
   } else {
     // Any other reset: increment boot count
-    rtc_boot_count++;
+    g_rtc_state.boot_count++;
     
     // Increment crash count for abnormal resets
     // Need to check if it's a crash (would need system_manager function)
@@ -298,7 +305,7 @@ void update_boot_counters() {
         current_reset_reason == ESP_RST_TASK_WDT ||
         current_reset_reason == ESP_RST_WDT ||
         current_reset_reason == ESP_RST_BROWNOUT) {
-      rtc_crash_count++;
+      g_rtc_state.crash_count++;
     }
   }
   
@@ -306,56 +313,112 @@ void update_boot_counters() {
   // Check for time() failure (returns -1 on error)
   time_t now = time(nullptr);
   if (now != (time_t)-1) {
-    rtc_last_boot_timestamp = static_cast<uint32_t>(now);
+    g_rtc_state.last_boot_timestamp = static_cast<uint32_t>(now);
   }
 }
 
 uint32_t get_boot_count() {
-  return rtc_boot_count;
+  return g_rtc_state.boot_count;
 }
 
 uint32_t get_crash_count() {
-  return rtc_crash_count;
+  return g_rtc_state.crash_count;
 }
 
 uint32_t get_cumulative_uptime_sec() {
-  return rtc_cumulative_uptime_sec;
+  return g_rtc_state.cumulative_uptime_sec;
 }
 
 void add_to_cumulative_uptime(uint32_t seconds) {
-  rtc_cumulative_uptime_sec += seconds;
+  g_rtc_state.cumulative_uptime_sec += seconds;
 }
 
 uint32_t get_last_boot_timestamp() {
-  return rtc_last_boot_timestamp;
+  return g_rtc_state.last_boot_timestamp;
 }
 
 void set_last_boot_timestamp(uint32_t timestamp) {
-  rtc_last_boot_timestamp = timestamp;
+  g_rtc_state.last_boot_timestamp = timestamp;
 }
 
 esp_reset_reason_t get_last_reset_reason() {
-  return rtc_last_reset_reason;
+  return (esp_reset_reason_t)g_rtc_state.last_reset_reason;
 }
 
-void publish_boot_diagnostics() {
-  if (!mqtt_is_connected()) {
+// Document prepared this wake, taken into g_rtc_state.diag once published
+static DiagDocDecision g_diag_decision = DiagDocDecision::SKIP;
+static uint32_t g_diag_crc = 0;
+static bool g_diag_pending = false;
+static char g_diag_payload[192];
+
+// Reset reason, crash count and layout identity as one retained document,
+// only when it differs from the one the broker holds (or on the heartbeat)
+static void prepare_diag_document() {
+  char layout_crc[12];
+  DiagDocument doc;
+  doc.reset_reason = get_reset_reason_string(get_last_reset_reason());
+  doc.crash_count = g_rtc_state.crash_count;
+  #if USE_DISPLAY
+  snprintf(layout_crc, sizeof(layout_crc), "0x%08X", static_cast<unsigned>(LAYOUT_CRC));
+  doc.layout_version = LAYOUT_VERSION;
+  #else
+  snprintf(layout_crc, sizeof(layout_crc), "N/A");
+  doc.layout_version = 0;
+  #endif
+  doc.layout_crc = layout_crc;
+  doc.fw_version = FW_VERSION;
+
+  size_t len = diag_document_format(doc, g_diag_payload, sizeof(g_diag_payload));
+  if (len == 0) {
+    Serial.println("[Diag] Diagnostics document too long - not sent");
     return;
   }
-  
-  // Publish boot diagnostics via MQTT
+  g_diag_crc = fast_crc32(reinterpret_cast<const uint8_t*>(g_diag_payload), len);
+  g_diag_decision = diag_document_decide(g_rtc_state.diag, g_diag_crc, DIAG_DOC_HEARTBEAT_WAKES);
+  g_diag_pending = true;
+}
+
+void queue_boot_diagnostics() {
+  // Boot diagnostics ride along in the same batched burst as the readings.
+  // The counters change every wake and are packable, so in packed mode they
+  // land in the state document; the slow fields are one retained document,
+  // published on its own by publish_diag_document() after the flush
+  MQTTBatcher& batcher = MQTTBatcher::getInstance();
+  char payload[32];
+
+  prepare_diag_document();
+
+  snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_rtc_state.boot_count);
+  batcher.queue(topic_get(TOPIC_DEBUG_BOOT_COUNT), payload, false);
+
+  snprintf(payload, sizeof(payload), "%lu", (unsigned long)g_rtc_state.cumulative_uptime_sec);
+  batcher.queue(topic_get(TOPIC_DEBUG_UPTIME), payload, false);
+
+  // Batcher counters as one JSON document (too long for the old fixed slots)
+  char stats[320];
   char topic[128];
-  char payload[64];
-  
-  snprintf(topic, sizeof(topic), "%s/debug/boot_count", MQTT_PUB_BASE);
-  snprintf(payload, sizeof(payload), "%lu", (unsigned long)rtc_boot_count);
-  mqtt_publish_raw(topic, payload, false);
-  
-  snprintf(topic, sizeof(topic), "%s/debug/crash_count", MQTT_PUB_BASE);
-  snprintf(payload, sizeof(payload), "%lu", (unsigned long)rtc_crash_count);
-  mqtt_publish_raw(topic, payload, false);
+  batcher.formatStatsJson(stats, sizeof(stats));
+  snprintf(topic, sizeof(topic), "%s/debug/batcher", MQTT_PUB_BASE);
+  batcher.queueJson(topic, stats, false);
+}
+
+void publish_diag_document() {
+  if (!g_diag_pending) return;
+  bool delivered = false;
+  if (g_diag_decision != DiagDocDecision::SKIP) {
+    delivered = mqtt_publish_raw(topic_get(TOPIC_DEBUG_DIAGNOSTICS), g_diag_payload, true);
+    if (!delivered) Serial.println("[Diag] Diagnostics document not published - retry next wake");
+  }
+  diag_document_note_wake(g_rtc_state.diag, g_diag_decision, g_diag_crc, delivered);
+  g_diag_pending = false;
+}
+
+COLD_PATH void publish_boot_diagnostics() {
+  if (!mqtt_is_connected()) {
+    return;
+  }
   
-  snprintf(topic, sizeof(topic), "%s/debug/uptime", MQTT_PUB_BASE);
-  snprintf(payload, sizeof(payload), "%lu", (unsigned long)rtc_cumulative_uptime_sec);
-  mqtt_publish_raw(topic, payload, false);
-}
\ No newline at end of file
+  queue_boot_diagnostics();
+  MQTTBatcher::getInstance().flush(mqtt_get_client());
+  publish_diag_document();
+}
@@ -13,10 +13,11 @@ struct ErrorStats {
   uint32_t sensor_read_failures;
   uint32_t wifi_disconnects;
   uint32_t mqtt_publish_failures;
+  uint32_t phase_overruns;          // Wake phases past their deadline (phase_deadline.h)
 };
 
 // Error statistics management
-extern RTC_DATA_ATTR ErrorStats g_error_stats;
+extern ErrorStats& g_error_stats;   // Field of g_rtc_state (rtc_state.h)
 void increment_error_stat(const char* stat_name);
 void reset_error_stats();
 void publish_error_stats();
@@ -37,14 +38,23 @@ uint32_t get_last_boot_timestamp();
 void set_last_boot_timestamp(uint32_t timestamp);
 esp_reset_reason_t get_last_reset_reason();
 void publish_boot_diagnostics();
+// Queue the same diagnostics onto MQTTBatcher; the caller flushes, then
+// calls publish_diag_document()
+void queue_boot_diagnostics();
+// Publish the retained diagnostics document (when due) on its own and keep
+// its CRC only if that publish succeeded
+void publish_diag_document();
 
 // Metrics publishing
 void emit_metrics_json(float tempC, float rhPct, float pressHPa);
-void publish_layout_identity();
 
 // Network pumping for MQTT message reception
 void pump_network_ms(uint32_t duration_ms);
 
+// Pump until every expected retained topic has arrived or the timeout hits
+// Returns elapsed milliseconds
+uint32_t pump_network_until_retained(uint32_t timeout_ms);
+
 // Time utilities
 void net_time_hhmm(char* out, size_t out_size);
 
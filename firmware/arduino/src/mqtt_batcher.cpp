@@ -1,31 +1,80 @@
 #include "mqtt_batcher.h"
 #include "safe_strings.h"
+#include "code_placement.h"
+#include <stdlib.h>
+
+// True if the payload can be emitted as a bare JSON number
+static bool is_json_number(const char* s) {
+    if (!s || !*s) return false;
+    char* end = nullptr;
+    strtod(s, &end);
+    if (!end || *end != '\0') return false;
+    // strtod accepts forms JSON does not (inf, nan, hex, leading '+' or '.')
+    for (const char* c = s; *c; c++) {
+        if (!(isdigit((unsigned char)*c) || *c == '-' || *c == '.' || *c == 'e' || *c == 'E' || *c == '+')) {
+            return false;
+        }
+    }
+    size_t n = strlen(s);
+    bool starts_ok = isdigit((unsigned char)s[0]) || (s[0] == '-' && isdigit((unsigned char)s[1]));
+    return starts_ok && isdigit((unsigned char)s[n - 1]);
+}
+
+static constexpr size_t kHeaderSize = 4;
 
 MQTTBatcher& MQTTBatcher::getInstance() {
     static MQTTBatcher instance;
     return instance;
 }
 
-bool MQTTBatcher::queue(const char* topic, const char* payload, bool retain) {
+bool MQTTBatcher::queue(const char* topic, const char* payload, bool retain, bool packable) {
+    return queueRecord(topic, payload, (retain ? FLAG_RETAIN : 0) | (packable ? 0 : FLAG_NO_PACK));
+}
+
+bool MQTTBatcher::queueJson(const char* topic, const char* json, bool retain) {
+    return queueRecord(topic, json, FLAG_JSON | (retain ? FLAG_RETAIN : 0));
+}
+
+bool MQTTBatcher::queueRecord(const char* topic, const char* payload, uint8_t flags) {
     stats_.total_queued++;
+    if (!topic || !payload) return false;
 
-    if (queue_count_ >= MAX_BATCH) {
+    // Store prefix-relative when possible
+    bool relative = prefix_len_ > 0 && strncmp(topic, prefix_, prefix_len_) == 0;
+    const char* stored_topic = relative ? topic + prefix_len_ : topic;
+    size_t topic_len = strlen(stored_topic);
+    size_t payload_len = strlen(payload);
+
+    if (topic_len >= MAX_TOPIC_LEN || payload_len > MAX_PAYLOAD_LEN) {
+        stats_.oversize_drops++;
+        Serial.printf("[MQTTBatch] Too long to batch, dropping: %s\n", topic);
+        return false;
+    }
+
+    size_t record_len = kHeaderSize + topic_len + 1 + payload_len + 1;
+    if (queue_count_ >= MAX_BATCH || arena_used_ + record_len > ARENA_SIZE) {
         stats_.queue_full_drops++;
         Serial.printf("[MQTTBatch] Queue full, dropping: %s\n", topic);
         return false;
     }
 
-    QueuedPublish& entry = queue_[queue_count_];
-    safe_strcpy(entry.topic, topic);
-    safe_strcpy(entry.payload, payload);
-    entry.retain = retain;
-    entry.valid = true;
+    RecordHeader hdr;
+    hdr.flags = FLAG_VALID | (relative ? FLAG_RELATIVE : 0) | flags;
+    hdr.topic_len = (uint8_t)topic_len;
+    hdr.payload_len = (uint16_t)payload_len;
+
+    uint8_t* dst = arena_ + arena_used_;
+    memcpy(dst, &hdr, kHeaderSize);
+    memcpy(dst + kHeaderSize, stored_topic, topic_len + 1);
+    memcpy(dst + kHeaderSize + topic_len + 1, payload, payload_len + 1);
 
+    arena_used_ += record_len;
     queue_count_++;
+    if (arena_used_ > stats_.arena_high_water) stats_.arena_high_water = arena_used_;
     return true;
 }
 
-size_t MQTTBatcher::flush(PubSubClient* client) {
+HOT_PATH size_t MQTTBatcher::flush(PubSubClient* client) {
     if (!client || !client->connected() || queue_count_ == 0) {
         return 0;
     }
@@ -33,31 +82,140 @@ size_t MQTTBatcher::flush(PubSubClient* client) {
     stats_.flush_count++;
     size_t success_count = 0;
 
-    for (size_t i = 0; i < queue_count_; i++) {
-        QueuedPublish& entry = queue_[i];
-        if (entry.valid) {
-            if (client->publish(entry.topic, entry.payload, entry.retain)) {
-                success_count++;
-            } else {
-                Serial.printf("[MQTTBatch] Failed to publish: %s\n", entry.topic);
-            }
-            entry.valid = false;
+    if (packed_mode_ && prefix_len_ > 0) {
+        success_count += flushPacked(client);
+    }
+
+    char topic[MAX_PREFIX_LEN + MAX_TOPIC_LEN];
+    RecordView rec;
+    for (size_t off = 0; readRecord(off, rec); off += recordSize(rec)) {
+        if (!(rec.hdr.flags & FLAG_VALID)) continue;
+
+        const char* full = fullTopic(rec, topic, sizeof(topic));
+        if (client->publish(full, rec.payload, (rec.hdr.flags & FLAG_RETAIN) != 0)) {
+            success_count++;
+        } else {
+            Serial.printf("[MQTTBatch] Failed to publish: %s\n", full);
         }
     }
 
     stats_.total_flushed += success_count;
-    queue_count_ = 0;
+    clear();
 
     return success_count;
 }
 
 void MQTTBatcher::clear() {
-    for (size_t i = 0; i < queue_count_; i++) {
-        queue_[i].valid = false;
-    }
+    arena_used_ = 0;
     queue_count_ = 0;
 }
 
+bool MQTTBatcher::readRecord(size_t offset, RecordView& out) const {
+    if (offset + kHeaderSize > arena_used_) return false;
+
+    memcpy(&out.hdr, arena_ + offset, kHeaderSize);
+    out.topic = (const char*)(arena_ + offset + kHeaderSize);
+    out.payload = out.topic + out.hdr.topic_len + 1;
+    return true;
+}
+
+size_t MQTTBatcher::recordSize(const RecordView& rec) {
+    return kHeaderSize + rec.hdr.topic_len + 1 + rec.hdr.payload_len + 1;
+}
+
+const char* MQTTBatcher::fullTopic(const RecordView& rec, char* buf, size_t buf_size) const {
+    if (!(rec.hdr.flags & FLAG_RELATIVE)) return rec.topic;
+    snprintf(buf, buf_size, "%s%s", prefix_, rec.topic);
+    return buf;
+}
+
+void MQTTBatcher::setTopicPrefix(const char* prefix) {
+    safe_strcpy(prefix_, prefix ? prefix : "");
+    prefix_len_ = strlen(prefix_);
+}
+
+void MQTTBatcher::packedKey(const char* suffix, char* out, size_t out_size) {
+    if (!out || out_size == 0) return;
+    size_t i = 0;
+    for (; suffix && suffix[i] && i + 1 < out_size; i++) {
+        out[i] = suffix[i] == '/' ? '_' : suffix[i];
+    }
+    out[i] = '\0';
+}
+
+HOT_PATH size_t MQTTBatcher::buildPacked(char* out, size_t out_size, size_t* offsets,
+                                size_t& count, bool& retain) const {
+    count = 0;
+    retain = false;
+    if (!out || out_size < 3) return 0;
+
+    size_t pos = 0;
+    out[pos++] = '{';
+
+    RecordView rec;
+    for (size_t off = 0; readRecord(off, rec); off += recordSize(rec)) {
+        if (!(rec.hdr.flags & FLAG_VALID) || !(rec.hdr.flags & FLAG_RELATIVE)) continue;
+        if (rec.hdr.flags & FLAG_NO_PACK) continue;
+        bool raw = (rec.hdr.flags & FLAG_JSON) != 0;
+        if (!raw && strpbrk(rec.payload, "\"\\")) continue;  // Needs escaping - send per-topic
+
+        char key[MAX_TOPIC_LEN];
+        packedKey(rec.topic, key, sizeof(key));
+        bool numeric = raw || is_json_number(rec.payload);
+
+        // sep + "key": + value (+ quotes), leaving room for the closing '}'
+        size_t need = (count ? 1 : 0) + strlen(key) + 3 + rec.hdr.payload_len + (numeric ? 0 : 2);
+        if (pos + need + 2 > out_size) continue;  // Falls back to per-topic
+
+        pos += snprintf(out + pos, out_size - pos,
+                        numeric ? "%s\"%s\":%s" : "%s\"%s\":\"%s\"",
+                        count ? "," : "", key, rec.payload);
+        retain = retain || (rec.hdr.flags & FLAG_RETAIN);
+        if (offsets) offsets[count] = off;
+        count++;
+    }
+
+    if (count == 0) {
+        out[0] = '\0';
+        return 0;
+    }
+    out[pos++] = '}';
+    out[pos] = '\0';
+    return pos;
+}
+
+size_t MQTTBatcher::formatPacked(char* out, size_t out_size) const {
+    size_t count;
+    bool retain;
+    return buildPacked(out, out_size, nullptr, count, retain);
+}
+
+size_t MQTTBatcher::flushPacked(PubSubClient* client) {
+    char payload[PACKED_PAYLOAD_LEN];
+    size_t packed_offsets[MAX_BATCH];
+    size_t packed_count = 0;
+    bool retain = false;
+
+    if (buildPacked(payload, sizeof(payload), packed_offsets, packed_count, retain) == 0) return 0;
+
+    char topic[MAX_PREFIX_LEN + 8];
+    snprintf(topic, sizeof(topic), "%s%s", prefix_, PACKED_TOPIC_SUFFIX);
+
+    if (!client->publish(topic, payload, retain)) {
+        // Leave records valid so the per-topic loop still delivers them
+        Serial.printf("[MQTTBatch] Packed publish failed (%u entries), sending per-topic\n",
+                      (unsigned)packed_count);
+        return 0;
+    }
+
+    for (size_t i = 0; i < packed_count; i++) {
+        arena_[packed_offsets[i]] &= (uint8_t)~FLAG_VALID;   // flags is the first header byte
+    }
+
+    stats_.packed_flushes++;
+    return packed_count;
+}
+
 void MQTTBatcher::resetStats() {
     stats_ = {};
 }
@@ -68,7 +226,11 @@ void MQTTBatcher::formatStatsJson(char* out, size_t out_size) const {
         : 0.0f;
 
     safe_snprintf_rt(out, out_size,
-            "{\"queued\":%u,\"flushed\":%u,\"flushes\":%u,\"drops\":%u,\"avg_batch\":%.1f,\"current_queue\":%zu}",
+            "{\"queued\":%u,\"flushed\":%u,\"flushes\":%u,\"drops\":%u,\"avg_batch\":%.1f,\"current_queue\":%zu,"
+            "\"oversize\":%u,\"arena_used\":%zu,\"arena_peak\":%u,\"arena_size\":%u,"
+            "\"packed\":%d,\"packed_flushes\":%u}",
             stats_.total_queued, stats_.total_flushed, stats_.flush_count,
-            stats_.queue_full_drops, avg_batch, queue_count_);
+            stats_.queue_full_drops, avg_batch, queue_count_,
+            stats_.oversize_drops, arena_used_, stats_.arena_high_water, (unsigned)ARENA_SIZE,
+            packed_mode_ ? 1 : 0, stats_.packed_flushes);
 }
@@ -11,25 +11,41 @@
 //   batcher.queue("topic1", "payload1", true);
 //   batcher.queue("topic2", "payload2", true);
 //   batcher.flush(mqtt_client);
+//
+// Storage: one contiguous arena of variable-length records
+//   [flags:1][topic_len:1][payload_len:2][topic\0][payload\0]
+// Topics under the prefix set with setTopicPrefix() are stored as the suffix
+// only, so short readings cost a few bytes and long payloads (diagnostics
+// JSON) fit as long as the arena has room.
+//
+// Packed mode (optional): every queued topic under the device prefix is
+// folded into one JSON document on <prefix>state, keyed by the topic suffix
+// with '/' replaced by '_' (inside/temperature -> inside_temperature).
+// Numeric payloads are emitted as JSON numbers and queueJson() payloads as
+// nested values. Topics outside the prefix are still published individually.
+//   batcher.setTopicPrefix("espsensor/<id>/");
+//   batcher.setPackedMode(true);
 
 class MQTTBatcher {
 public:
-    static constexpr size_t MAX_BATCH = 12;
-    static constexpr size_t MAX_TOPIC_LEN = 64;
-    static constexpr size_t MAX_PAYLOAD_LEN = 48;
-
-    struct QueuedPublish {
-        char topic[MAX_TOPIC_LEN];
-        char payload[MAX_PAYLOAD_LEN];
-        bool retain;
-        bool valid;
-    };
+    static constexpr size_t MAX_BATCH = 24;              // Max records
+    static constexpr size_t ARENA_SIZE = 1024;           // Bytes for all records
+    static constexpr size_t MAX_TOPIC_LEN = 64;          // Stored (suffix) topic
+    static constexpr size_t MAX_PAYLOAD_LEN = 400;       // Fits PubSubClient's 512 B packet
+    static constexpr size_t MAX_PREFIX_LEN = 48;
+    static constexpr size_t PACKED_PAYLOAD_LEN = 384;
+    static constexpr const char* PACKED_TOPIC_SUFFIX = "state";
 
     static MQTTBatcher& getInstance();
 
     // Queue a message for batched publish
-    // Returns false if queue is full
-    bool queue(const char* topic, const char* payload, bool retain = false);
+    // packable=false keeps the message on its own topic in packed mode
+    // Returns false if the record limit or arena space is exhausted
+    bool queue(const char* topic, const char* payload, bool retain = false,
+               bool packable = true);
+
+    // Queue a JSON object or array payload; packed mode nests it as-is
+    bool queueJson(const char* topic, const char* json, bool retain = false);
 
     // Flush all queued messages
     // Returns number of messages successfully published
@@ -37,18 +53,34 @@ public:
 
     // Get queue status
     size_t getQueuedCount() const { return queue_count_; }
-    bool isFull() const { return queue_count_ >= MAX_BATCH; }
+    bool isFull() const { return queue_count_ >= MAX_BATCH || arena_used_ >= ARENA_SIZE; }
+    size_t getArenaUsed() const { return arena_used_; }
     bool isEmpty() const { return queue_count_ == 0; }
 
     // Clear queue without publishing
     void clear();
 
+    // Shared topic prefix ("espsensor/<id>/") for suffix storage and packed mode
+    void setTopicPrefix(const char* prefix);
+    void setPackedMode(bool enabled) { packed_mode_ = enabled; }
+    bool isPackedMode() const { return packed_mode_; }
+
+    // The packed document the next flush would publish on <prefix>state, into
+    // out; returns its length, 0 if no queued entry packs. Publishes nothing.
+    size_t formatPacked(char* out, size_t out_size) const;
+
+    // JSON key used in the packed document for a topic suffix
+    static void packedKey(const char* suffix, char* out, size_t out_size);
+
     // Stats
     struct Stats {
         uint32_t total_queued;
         uint32_t total_flushed;
         uint32_t flush_count;        // Number of flush operations
         uint32_t queue_full_drops;   // Messages dropped due to full queue
+        uint32_t oversize_drops;     // Topic or payload longer than the limits
+        uint32_t arena_high_water;   // Most arena bytes used by one batch
+        uint32_t packed_flushes;     // Flushes sent as a single packed document
     };
 
     const Stats& getStats() const { return stats_; }
@@ -62,7 +94,48 @@ private:
     MQTTBatcher(const MQTTBatcher&) = delete;
     MQTTBatcher& operator=(const MQTTBatcher&) = delete;
 
-    QueuedPublish queue_[MAX_BATCH];
+    // Record header (stored unaligned in the arena, accessed via memcpy)
+    struct RecordHeader {
+        uint8_t flags;
+        uint8_t topic_len;       // Excluding NUL
+        uint16_t payload_len;    // Excluding NUL
+    };
+    static_assert(sizeof(RecordHeader) == 4, "arena record header must stay 4 bytes");
+    static constexpr uint8_t FLAG_VALID = 0x01;
+    static constexpr uint8_t FLAG_RETAIN = 0x02;
+    static constexpr uint8_t FLAG_RELATIVE = 0x04;   // Topic is prefix-relative
+    static constexpr uint8_t FLAG_NO_PACK = 0x08;    // Never fold into the packed document
+    static constexpr uint8_t FLAG_JSON = 0x10;       // Payload is a JSON value (no quoting)
+
+    struct RecordView {
+        RecordHeader hdr;
+        const char* topic;       // As stored (suffix if FLAG_RELATIVE)
+        const char* payload;
+    };
+
+    uint8_t arena_[ARENA_SIZE];
+    size_t arena_used_ = 0;
     size_t queue_count_ = 0;
     Stats stats_ = {};
+    char prefix_[MAX_PREFIX_LEN] = {};
+    size_t prefix_len_ = 0;
+    bool packed_mode_ = false;
+
+    bool queueRecord(const char* topic, const char* payload, uint8_t flags);
+
+    // Fold packable entries into out; offsets (may be null) gets the record
+    // offset of each of the count entries packed. Returns the length or 0.
+    size_t buildPacked(char* out, size_t out_size, size_t* offsets, size_t& count,
+                       bool& retain) const;
+
+    // Publish prefixed entries as one document; returns entries delivered
+    // and leaves entries it could not pack marked valid
+    size_t flushPacked(PubSubClient* client);
+
+    // Walk records: pass offset 0 to start; returns false past the last one
+    bool readRecord(size_t offset, RecordView& out) const;
+    static size_t recordSize(const RecordView& rec);
+
+    // Expand a stored topic to the full topic string
+    const char* fullTopic(const RecordView& rec, char* buf, size_t buf_size) const;
 };
@@ -7,10 +7,20 @@
 #include "profiling.h"
 #include "safe_strings.h"
 #include "power.h"  // For BatteryStatus
-#include <Preferences.h>
-#if LOG_MQTT_ENABLED
-#include "logging/log_mqtt.h"
+#include "net_events.h"
+#include "topic_table.h"
+#include "mqtt_dispatch.h"
+#include "weather_classify.h"
+#include "system_manager.h"  // fast_crc32
+#include "rtc_state.h"
+#include "wake_arena.h"
+#include "ota_update.h"
+#if MQTT_TLS
+#include "tls_client.h"
 #endif
+#include <ArduinoJson.h>
+#include <lwip/sockets.h>
+#include <Preferences.h>
 
 // External C function declarations (must be at file scope for extern "C")
 #if USE_DISPLAY
@@ -19,8 +29,40 @@ extern "C" void display_capture_handle(const char* payload, size_t length);
 
 // Static storage
 static WiFiClient g_wifi_client;
+#if MQTT_TLS
+// TLS rides on the plain socket; select() still watches g_wifi_client's fd
+static TlsClient g_tls_client(g_wifi_client);
+static PubSubClient g_mqtt(g_tls_client);
+#if !defined(MQTT_TLS_CA_CERT)
+#warning "MQTT_TLS without MQTT_TLS_CA_CERT: broker certificate is not verified"
+#endif
+#else
 static PubSubClient g_mqtt(g_wifi_client);
+#endif
 static OutsideReadings g_outside;
+
+// Outside values kept across deep sleep so a wake can draw before the
+// retained fetch. Plain data: RTC memory is not re-initialized on wake.
+struct OutsideCache {
+  uint32_t magic;
+  float temperatureC;
+  bool validTemp;
+  bool validWeather;
+  uint8_t weatherKind;
+  char weather[64];
+};
+
+static constexpr uint32_t OUTSIDE_CACHE_MAGIC = 0x4F555443;  // "OUTC"
+RTC_DATA_ATTR static OutsideCache g_outside_cache = {};
+
+static void save_outside_cache() {
+  g_outside_cache.temperatureC = g_outside.temperatureC;
+  g_outside_cache.validTemp = g_outside.validTemp;
+  g_outside_cache.validWeather = g_outside.validWeather;
+  g_outside_cache.weatherKind = g_outside.weatherKind;
+  safe_strcpy(g_outside_cache.weather, g_outside.validWeather ? g_outside.weather : "");
+  g_outside_cache.magic = OUTSIDE_CACHE_MAGIC;
+}
 static char g_mqtt_client_id[40];  // Renamed to avoid conflict with net.h
 static Preferences g_mqtt_prefs;
 
@@ -28,206 +70,319 @@ static Preferences g_mqtt_prefs;
 static bool g_diagnostic_mode_requested = false;
 static bool g_diagnostic_mode_request_value = false;
 
-// Rate limiting for MQTT commands (prevents flooding/DoS)
-static uint32_t g_last_command_ms = 0;
-static const uint32_t COMMAND_COOLDOWN_MS = 1000;  // 1 second between commands
+#ifdef MQTT_SUB_BASE
+// Retained outdoor topics we subscribe to under MQTT_SUB_BASE
+// Topics sharing a field bit are aliases (new name + legacy name); the
+// retained fetch is complete once every required field has been seen.
+enum RetainedKind : uint8_t {
+  RETAINED_TEMP_F,
+  RETAINED_TEMP_C,
+  RETAINED_WEATHER_TEXT,
+  RETAINED_WEATHER_CODE,
+};
+
+struct RetainedTopic {
+  const char* suffix;
+  uint8_t field_bit;
+  bool required;
+  RetainedKind kind;
+};
+
+static const RetainedTopic kRetainedManifest[] = {
+  {"/temp_f",         RETAINED_FIELD_TEMP,    true,  RETAINED_TEMP_F},        // Temperature in Fahrenheit
+  {"/condition",      RETAINED_FIELD_WEATHER, true,  RETAINED_WEATHER_TEXT},  // Weather condition text
+  {"/condition_code", RETAINED_FIELD_CODE,    false, RETAINED_WEATHER_CODE},  // Weather condition code
+  // Legacy topics for backward compatibility
+  {"/temp",           RETAINED_FIELD_TEMP,    true,  RETAINED_TEMP_C},        // Temperature in Celsius
+  {"/weather",        RETAINED_FIELD_WEATHER, true,  RETAINED_WEATHER_TEXT},  // Weather description
+  {"/weather_id",     RETAINED_FIELD_CODE,    false, RETAINED_WEATHER_CODE},  // Weather ID
+};
+#endif
 
-// Helper to build MQTT topic (buffer-based to avoid heap fragmentation)
-static void build_topic_buf(char* out, size_t out_size, const char* suffix) {
-  if (out_size == 0) return;
-  if (g_mqtt_client_id[0] == '\0') {
-    // Client ID not set - use fallback
-    safe_snprintf_rt(out, out_size, "espsensor/unknown/%s", suffix ? suffix : "");
+// Fields seen since the last subscribe
+static uint8_t g_retained_seen_mask = 0;
+
+// Persistent session bookkeeping. Kept in RTC so it survives deep sleep;
+// a power-up loses it, which only costs one fresh subscribe.
+static constexpr uint32_t MQTT_SESSION_MAGIC = 0x4D534553;  // "MSES"
+RTC_DATA_ATTR static uint32_t rtc_session_magic = 0;
+RTC_DATA_ATTR static uint32_t rtc_session_key = 0;       // CRC of client id + broker
+RTC_DATA_ATTR static uint16_t rtc_session_resumes = 0;   // Connects since last subscribe
+static bool g_session_resumed = false;
+
+// Broker currently handed to PubSubClient, which keeps only the pointer
+static char g_mqtt_host[64] = "";
+static uint16_t g_mqtt_port = 0;
+
+static void apply_server(const char* host, uint16_t port) {
+  snprintf(g_mqtt_host, sizeof(g_mqtt_host), "%s", host ? host : "");
+  g_mqtt_port = port;
+  g_mqtt.setServer(g_mqtt_host, g_mqtt_port);
+}
+
+// Identifies the broker-side session: same client id on the same broker
+static uint32_t session_key() {
+  char key[112];
+  snprintf(key, sizeof(key), "%s@%s:%u", g_mqtt_client_id, g_mqtt_host,
+           (unsigned)g_mqtt_port);
+  return fast_crc32((const uint8_t*)key, strlen(key));
+}
+
+// True if the broker should still hold our QoS1 command subscriptions
+static bool session_can_resume() {
+  #if MQTT_PERSISTENT_SESSION
+  return rtc_session_magic == MQTT_SESSION_MAGIC &&
+         rtc_session_key == session_key() &&
+         rtc_session_resumes < MQTT_SESSION_RESUBSCRIBE_CONNECTS;
+  #else
+  return false;
+  #endif
+}
+
+static void session_record_subscribed() {
+  rtc_session_magic = MQTT_SESSION_MAGIC;
+  rtc_session_key = session_key();
+  rtc_session_resumes = 0;
+}
+
+// ---- Command handlers (device namespace, cmd/...) ----
+
+static void on_cmd_diagnostic_mode(const MqttInbound& msg) {
+  if (msg.length > 0) {
+    char value = (char)msg.payload[0];
+    g_diagnostic_mode_requested = true;
+    g_diagnostic_mode_request_value = (value == '1' || value == 't' || value == 'T');
+  }
+}
+
+// Minimum 180s / 3 min to prevent sensor heating
+static void on_cmd_sleep_interval(const MqttInbound& msg) {
+  if (msg.length > 0 && msg.length < 16) {
+    char buf[16];
+    memcpy(buf, msg.payload, msg.length);
+    buf[msg.length] = '\0';
+    char* endptr = nullptr;
+    long interval = strtol(buf, &endptr, 10);
+    if (endptr != buf && interval >= 180 && interval <= 3600) {
+      // Store new interval - will be used on next sleep cycle
+      extern void set_custom_sleep_interval(uint32_t sec);
+      set_custom_sleep_interval(static_cast<uint32_t>(interval));
+      Serial.printf("[MQTT] Sleep interval set to %ld seconds\n", interval);
+    } else {
+      Serial.println("[MQTT] Invalid sleep interval (must be 180-3600 seconds)");
+    }
+  }
+}
+
+// Device mode (dev or production)
+static void on_cmd_mode(const MqttInbound& msg) {
+  if (msg.length > 0 && msg.length < 16) {
+    char buf[16];
+    memcpy(buf, msg.payload, msg.length);
+    buf[msg.length] = '\0';
+    extern void set_device_mode(const char* mode);
+    set_device_mode(buf);
+  }
+}
+
+static void on_cmd_status(const MqttInbound&) {
+  extern void publish_device_status();
+  publish_device_status();
+}
+
+static void on_cmd_reboot(const MqttInbound&) {
+  Serial.println("[MQTT] Reboot command received");
+  Serial.flush();
+  delay(100);
+  esp_restart();
+}
+
+#if USE_DISPLAY
+static void on_cmd_screenshot(const MqttInbound& msg) {
+  display_capture_handle((const char*)msg.payload, msg.length);
+}
+#endif
+
+// ---- Retained fleet config (device namespace, config) ----
+
+static void read_feature(JsonVariantConst v, uint8_t bit, RemoteConfig& c) {
+  if (!v.is<bool>()) return;
+  c.features_set |= bit;
+  if (v.as<bool>()) c.features_on |= bit;
+}
+
+// Redelivered on every connect; parsed only when "v" changes. An empty
+// retained message (config deleted) returns every field to its default.
+static void on_device_config(const MqttInbound& msg) {
+  RemoteConfig& current = g_rtc_state.config;
+  if (msg.length == 0) {
+    if (current.version != 0) Serial.println("[Config] Cleared, using firmware defaults");
+    memset(&current, 0, sizeof(current));
     return;
   }
-  safe_snprintf_rt(out, out_size, "espsensor/%s/%s", g_mqtt_client_id, suffix ? suffix : "");
+
+  uint32_t version = 0;
+  if (!remote_config_peek_version((const char*)msg.payload, msg.length, version)) {
+    Serial.println("[Config] Ignored: no \"v\" version");
+    return;
+  }
+  if (version == current.version) return;
+
+  JsonDocument doc(WakeArena::jsonAllocator());
+  DeserializationError error = deserializeJson(doc, msg.payload, msg.length);
+  if (error) {
+    Serial.printf("[Config] Parse failed (v%lu): %s\n", (unsigned long)version, error.c_str());
+    return;
+  }
+
+  RemoteConfig c;
+  memset(&c, 0, sizeof(c));
+  c.version = version;
+  JsonVariantConst sleep = doc["sleep"];
+  c.normal_interval_sec = sleep["normal"] | 0u;
+  c.low_battery_interval_sec = sleep["low"] | 0u;
+  c.critical_interval_sec = sleep["critical"] | 0u;
+  c.rapid_update_interval_sec = sleep["rapid"] | 0u;
+  c.max_interval_sec = sleep["max"] | 0u;
+  JsonVariantConst battery = doc["battery"];
+  uint32_t low = battery["low"] | 0u;
+  uint32_t critical = battery["critical"] | 0u;
+  c.low_battery_threshold = low <= 100 ? (uint8_t)low : 0;
+  c.critical_battery_threshold = critical <= 100 ? (uint8_t)critical : 0;
+  JsonVariantConst deadband = doc["deadband"];
+  c.temp_deadband_c = deadband["temp_c"] | 0.0f;
+  c.rh_deadband_pct = deadband["rh_pct"] | 0.0f;
+  c.press_deadband_hpa = deadband["press_hpa"] | 0.0f;
+  c.heartbeat_sec = deadband["heartbeat_s"] | 0u;
+  JsonVariantConst features = doc["features"];
+  read_feature(features["partial_refresh"], RCFG_FEATURE_PARTIAL_REFRESH, c);
+  read_feature(features["compact_telemetry"], RCFG_FEATURE_COMPACT_TELEMETRY, c);
+  read_feature(features["ulp"], RCFG_FEATURE_ULP, c);
+  remote_config_sanitize(c);
+
+  current = c;
+  Serial.printf("[Config] Applied v%lu (features 0x%02x/0x%02x)\n", (unsigned long)version,
+                c.features_on, c.features_set);
+}
+
+// ---- Retained outdoor data (outside namespace) ----
+
+#ifdef MQTT_SUB_BASE
+// Parse a finite float; strtof (not atof) so "0" and a parse error differ
+static bool parse_float(const char* s, float& out) {
+  char* endptr = nullptr;
+  float v = strtof(s, &endptr);
+  if (endptr == s || !isfinite(v)) return false;
+  out = v;
+  return true;
+}
+
+static void on_outside_retained(const MqttInbound& msg) {
+  const RetainedTopic& rt = *static_cast<const RetainedTopic*>(msg.ctx);
+
+  // Record arrival against the manifest and wake the retained-data fetch
+  g_retained_seen_mask |= rt.field_bit;
+  net_events_set(NET_EVT_MQTT_DATA);
+
+  // Convert payload to string
+  char value_str[64];
+  if (msg.length < sizeof(value_str)) {
+    memcpy(value_str, msg.payload, msg.length);
+    value_str[msg.length] = '\0';
+  } else {
+    // Payload too large - truncate and log warning
+    memcpy(value_str, msg.payload, sizeof(value_str) - 1);
+    value_str[sizeof(value_str) - 1] = '\0';
+    Serial.printf("[MQTT] WARN: Payload truncated (%u bytes > %u max)\n",
+                  (unsigned)msg.length, (unsigned)(sizeof(value_str) - 1));
+    increment_error_stat("mqtt_truncation");
+  }
+
+  float v;
+  switch (rt.kind) {
+    case RETAINED_TEMP_F:
+      if (parse_float(value_str, v)) {
+        g_outside.temperatureC = (v - 32.0f) * 5.0f / 9.0f;
+        g_outside.validTemp = true;
+      }
+      break;
+    case RETAINED_TEMP_C:
+      if (parse_float(value_str, v)) {
+        g_outside.temperatureC = v;
+        g_outside.validTemp = true;
+      }
+      break;
+    case RETAINED_WEATHER_TEXT:
+      snprintf(g_outside.weather, sizeof(g_outside.weather), "%s", value_str);
+      g_outside.weatherKind = weather_classify(g_outside.weather);
+      g_outside.validWeather = true;
+      break;
+    case RETAINED_WEATHER_CODE:
+      // Code could be mapped to weather text if needed; the text topic is used for now
+      break;
+  }
+  save_outside_cache();
 }
+#endif
 
-// Deprecated - use build_topic_buf instead (kept for compatibility)
-static String build_topic(const char* suffix) {
-  char buf[96];
-  build_topic_buf(buf, sizeof(buf), suffix);
-  return String(buf);
+static void register_builtin_routes() {
+  mqtt_dispatch_set_prefix(MQTT_NS_DEVICE, topic_device_prefix());
+  mqtt_dispatch_register(MQTT_NS_DEVICE, "cmd/diagnostic_mode", on_cmd_diagnostic_mode, nullptr, MQTT_ROUTE_RATE_LIMITED);
+  mqtt_dispatch_register(MQTT_NS_DEVICE, "cmd/sleep_interval", on_cmd_sleep_interval, nullptr, MQTT_ROUTE_RATE_LIMITED);
+  mqtt_dispatch_register(MQTT_NS_DEVICE, "cmd/mode", on_cmd_mode, nullptr, MQTT_ROUTE_RATE_LIMITED);
+  mqtt_dispatch_register(MQTT_NS_DEVICE, "cmd/status", on_cmd_status, nullptr, MQTT_ROUTE_RATE_LIMITED);
+  mqtt_dispatch_register(MQTT_NS_DEVICE, "cmd/reboot", on_cmd_reboot, nullptr, MQTT_ROUTE_RATE_LIMITED);
+  #if USE_DISPLAY
+  mqtt_dispatch_register(MQTT_NS_DEVICE, "cmd/screenshot", on_cmd_screenshot, nullptr, MQTT_ROUTE_RATE_LIMITED);
+  #endif
+  mqtt_dispatch_register(MQTT_NS_DEVICE, topic_suffix(TOPIC_CONFIG), on_device_config);
+  #if FEATURE_OTA_DELTA
+  ota_update_register_routes();
+  #endif
+
+  // Debug and log commands register themselves (DebugCommands::begin, LogMQTT::begin)
+
+  #ifdef MQTT_SUB_BASE
+  mqtt_dispatch_set_prefix(MQTT_NS_OUTSIDE, MQTT_SUB_BASE);
+  for (const RetainedTopic& rt : kRetainedManifest) {
+    mqtt_dispatch_register(MQTT_NS_OUTSIDE, rt.suffix, on_outside_retained,
+                           const_cast<RetainedTopic*>(&rt));
+  }
+  #endif
 }
 
 void mqtt_begin() {
-  // Client ID will be set externally via mqtt_set_client_id
-  // to avoid WiFi dependency in this module
+  // Client ID is normally set via mqtt_set_client_id; fall back to the MAC
+  // (same format as net_begin) so topics never use the "unknown" id
+  if (g_mqtt_client_id[0] == '\0') {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    char id[13];
+    snprintf(id, sizeof(id), "%02x%02x%02x%02x%02x%02x",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    mqtt_set_client_id(id);
+  }
   
   // Configure MQTT client
   g_mqtt.setBufferSize(MQTT_MAX_PACKET_SIZE);
+  #if MQTT_TLS
+  #ifdef MQTT_TLS_CA_CERT
+  g_tls_client.setCACert(MQTT_TLS_CA_CERT);
+  #else
+  g_tls_client.setCACert(nullptr);
+  #endif
+  g_tls_client.setHandshakeTimeout(TLS_HANDSHAKE_TIMEOUT_MS);
+  #endif
   
   // Set MQTT server
   #ifdef MQTT_HOST
-  g_mqtt.setServer(MQTT_HOST, MQTT_PORT);
+  apply_server(MQTT_HOST, MQTT_PORT);
   #endif
   
-  // Set up MQTT callback for commands and outdoor data
-  // NOTE: Using C strings (not Arduino String) to avoid heap fragmentation
+  // Route commands and outdoor data through the dispatch table
+  register_builtin_routes();
   g_mqtt.setCallback([](char* topic, byte* payload, unsigned int length) {
-    // Null check for safety
-    if (!topic) return;
-    
-    // Helper to check if topic ends with suffix (C string version - no heap allocation)
-    auto topic_ends_with = [](const char* t, const char* suffix) -> bool {
-      size_t tlen = strlen(t);
-      size_t slen = strlen(suffix);
-      if (tlen < slen) return false;
-      return strcmp(t + tlen - slen, suffix) == 0;
-    };
-    
-    // Rate limit command topics (prevents flooding/DoS attacks)
-    // Data topics (temp, weather) are not rate limited
-    if (strstr(topic, "/cmd/") != nullptr) {
-      uint32_t now = millis();
-      if (now - g_last_command_ms < COMMAND_COOLDOWN_MS) {
-        Serial.println("[MQTT] Command rate limited - ignoring");
-        return;
-      }
-      g_last_command_ms = now;
-    }
-    
-    // Handle diagnostic mode commands
-    if (topic_ends_with(topic, "/cmd/diagnostic_mode")) {
-      if (length > 0) {
-        char value = (char)payload[0];
-        g_diagnostic_mode_requested = true;
-        g_diagnostic_mode_request_value = (value == '1' || value == 't' || value == 'T');
-      }
-      return;
-    }
-    
-    // Handle sleep interval command (minimum 180s / 3 min to prevent sensor heating)
-    if (topic_ends_with(topic, "/cmd/sleep_interval")) {
-      if (length > 0 && length < 16) {
-        char buf[16];
-        memcpy(buf, payload, length);
-        buf[length] = '\0';
-        char* endptr = nullptr;
-        long interval = strtol(buf, &endptr, 10);
-        if (endptr != buf && interval >= 180 && interval <= 3600) {
-          // Store new interval - will be used on next sleep cycle
-          extern void set_custom_sleep_interval(uint32_t sec);
-          set_custom_sleep_interval(static_cast<uint32_t>(interval));
-          Serial.printf("[MQTT] Sleep interval set to %ld seconds\n", interval);
-        } else {
-          Serial.println("[MQTT] Invalid sleep interval (must be 180-3600 seconds)");
-        }
-      }
-      return;
-    }
-    
-    // Handle device mode command (dev or production)
-    if (topic_ends_with(topic, "/cmd/mode")) {
-      if (length > 0 && length < 16) {
-        char buf[16];
-        memcpy(buf, payload, length);
-        buf[length] = '\0';
-        extern void set_device_mode(const char* mode);
-        set_device_mode(buf);
-      }
-      return;
-    }
-    
-    // Handle status request command
-    if (topic_ends_with(topic, "/cmd/status")) {
-      extern void publish_device_status();
-      publish_device_status();
-      return;
-    }
-    
-    // Handle reboot command
-    if (topic_ends_with(topic, "/cmd/reboot")) {
-      Serial.println("[MQTT] Reboot command received");
-      Serial.flush();
-      delay(100);
-      esp_restart();
-      return;
-    }
-    
-    // Handle screenshot command
-    if (topic_ends_with(topic, "/cmd/screenshot")) {
-      #if USE_DISPLAY
-      display_capture_handle((const char*)payload, length);
-      #endif
-      return;
-    }
-    
-    // Forward log commands to LogMQTT
-    #if LOG_MQTT_ENABLED
-    if (strstr(topic, "/cmd/clear_logs") != nullptr ||
-        strstr(topic, "/cmd/log_level") != nullptr ||
-        strstr(topic, "/cmd/log_filter") != nullptr) {
-      log_mqtt_handle_command(topic, (const uint8_t*)payload, length);
-      return;
-    }
-    #endif
-
-    // Handle debug commands
-    if (strstr(topic, "/cmd/debug") != nullptr) {
-      debug_commands_handle(topic, (const uint8_t*)payload, length);
-      return;
-    }
-    
-    // Handle outdoor weather data (alias topics)
-    #ifdef MQTT_SUB_BASE
-    // Convert payload to string
-    char value_str[64];
-    if (length < sizeof(value_str)) {
-      memcpy(value_str, payload, length);
-      value_str[length] = '\0';
-    } else {
-      // Payload too large - truncate and log warning
-      memcpy(value_str, payload, sizeof(value_str) - 1);
-      value_str[sizeof(value_str) - 1] = '\0';
-      Serial.printf("[MQTT] WARN: Payload truncated (%u bytes > %u max)\n",
-                    (unsigned)length, (unsigned)(sizeof(value_str) - 1));
-      increment_error_stat("mqtt_truncation");
-    }
-    
-    // Handle temperature in Fahrenheit
-    if (topic_ends_with(topic, "/temp_f")) {
-      // Use strtof to properly detect parse errors (atof returns 0.0 for both error and valid "0")
-      char* endptr = nullptr;
-      float temp_f = strtof(value_str, &endptr);
-      // Valid parse: endptr moved past start AND value is finite
-      if (endptr != value_str && isfinite(temp_f)) {
-        // Convert to Celsius and update outside readings
-        float temp_c = (temp_f - 32.0f) * 5.0f / 9.0f;
-        g_outside.temperatureC = temp_c;
-        g_outside.validTemp = true;
-      }
-    }
-    // Handle temperature in Celsius (legacy)
-    else if (topic_ends_with(topic, "/temp")) {
-      char* endptr = nullptr;
-      float temp_c = strtof(value_str, &endptr);
-      if (endptr != value_str && isfinite(temp_c)) {
-        g_outside.temperatureC = temp_c;
-        g_outside.validTemp = true;
-      }
-    }
-    // Handle weather condition text
-    else if (topic_ends_with(topic, "/condition")) {
-      snprintf(g_outside.weather, sizeof(g_outside.weather), "%s", value_str);
-      g_outside.validWeather = true;
-    }
-    // Handle weather description (legacy)
-    else if (topic_ends_with(topic, "/weather")) {
-      snprintf(g_outside.weather, sizeof(g_outside.weather), "%s", value_str);
-      g_outside.validWeather = true;
-    }
-    // Handle weather condition code (currently not stored separately)
-    else if (topic_ends_with(topic, "/condition_code")) {
-      // Weather code could be used to map to weather text if needed
-      // For now, we rely on the condition text itself
-    }
-    // Handle weather ID (legacy - currently not stored separately)
-    else if (topic_ends_with(topic, "/weather_id")) {
-      // Weather ID could be used to map to weather text if needed  
-      // For now, we rely on the weather text itself
-    }
-    #endif
+    mqtt_dispatch(topic, (const uint8_t*)payload, length);
   });
 }
 
@@ -247,34 +402,34 @@ bool mqtt_connect() {
   }
 
   // Build LWT topic and message
-  char lwt_topic[96];
-  build_topic_buf(lwt_topic, sizeof(lwt_topic), "availability");
+  const char* lwt_topic = topic_get(TOPIC_AVAILABILITY);
 
-  // Connect with authentication if configured
+  // Connect with authentication if configured; a persistent session keeps
+  // our subscriptions (and QoS1 commands sent while asleep) on the broker
+  bool clean_session = !MQTT_PERSISTENT_SESSION;
   bool connected = false;
   #if defined(MQTT_USER) && defined(MQTT_PASS)
   connected = g_mqtt.connect(g_mqtt_client_id, MQTT_USER, MQTT_PASS,
-                            lwt_topic, 0, true, "offline");
+                            lwt_topic, 0, true, "offline", clean_session);
   #else
-  connected = g_mqtt.connect(g_mqtt_client_id, lwt_topic, 0, true, "offline");
+  connected = g_mqtt.connect(g_mqtt_client_id, nullptr, nullptr,
+                            lwt_topic, 0, true, "offline", clean_session);
   #endif
 
   if (connected) {
+    net_events_set(NET_EVT_MQTT_CONNECTED);
+
     // Publish online status
     g_mqtt.publish(lwt_topic, "online", true);
 
     // Publish device discovery message
-    char discovery_topic[96];
-    snprintf(discovery_topic, sizeof(discovery_topic), "espsensor/discovery/%s", g_mqtt_client_id);
-
     // Build discovery payload with device info
     char discovery_payload[256];
     char ip_buf[16];
     #if FEATURE_WIFI
     // Get IP address from WiFi manager
-    extern String wifi_get_ip();
-    String ip_str = wifi_get_ip();
-    safe_strcpy(ip_buf, ip_str.c_str());
+    extern void wifi_get_ip_cstr(char* out, size_t out_size);
+    wifi_get_ip_cstr(ip_buf, sizeof(ip_buf));
     #else
     safe_strcpy(ip_buf, "0.0.0.0");
     #endif
@@ -284,12 +439,23 @@ bool mqtt_connect() {
              g_mqtt_client_id, ip_buf, FW_VERSION, ROOM_NAME, millis() / 1000);
 
     // Publish discovery (not retained - will clear on disconnect via LWT)
-    g_mqtt.publish(discovery_topic, discovery_payload, false);
+    g_mqtt.publish(topic_get(TOPIC_DISCOVERY), discovery_payload, false);
 
-    // Subscribe to command topics
-    char cmd_topic[96];
-    build_topic_buf(cmd_topic, sizeof(cmd_topic), "cmd/+");
-    g_mqtt.subscribe(cmd_topic);
+    // Subscribe to command topics, unless the resumed session still holds them
+    g_session_resumed = session_can_resume();
+    if (g_session_resumed) {
+      rtc_session_resumes++;
+      Serial.println("[MQTT] Session resumed - command subscriptions kept by broker");
+    } else {
+      g_mqtt.subscribe(topic_get(TOPIC_CMD_WILDCARD), MQTT_PERSISTENT_SESSION ? 1 : 0);
+      if (MQTT_PERSISTENT_SESSION) session_record_subscribed();
+    }
+
+    // Retained config is only delivered on subscribe, so ask every connect
+    g_mqtt.subscribe(topic_get(TOPIC_CONFIG));
+    #if FEATURE_OTA_DELTA
+    ota_update_subscribe(&g_mqtt);
+    #endif
 
     // Initialize debug commands
     DebugCommands::getInstance().setClientId(g_mqtt_client_id);
@@ -297,20 +463,13 @@ bool mqtt_connect() {
     
     // Subscribe to outdoor weather data (alias topics)
     #ifdef MQTT_SUB_BASE
-    String outdoor_base = String(MQTT_SUB_BASE);
-    // Subscribe to alias topics for outdoor data
-    String sub_topics[] = {
-      outdoor_base + "/temp_f",      // Temperature in Fahrenheit
-      outdoor_base + "/condition",   // Weather condition text
-      outdoor_base + "/condition_code", // Weather condition code
-      // Legacy topics for backward compatibility
-      outdoor_base + "/temp",        // Temperature in Celsius
-      outdoor_base + "/weather",     // Weather description
-      outdoor_base + "/weather_id"   // Weather ID
-    };
-    
-    for (const String& topic : sub_topics) {
-      g_mqtt.subscribe(topic.c_str());
+    // Retained values are (re)delivered after each subscribe, so these are
+    // sent every connect even when the session is resumed
+    g_retained_seen_mask = 0;
+    for (const RetainedTopic& rt : kRetainedManifest) {
+      char sub_topic[96];
+      snprintf(sub_topic, sizeof(sub_topic), "%s%s", MQTT_SUB_BASE, rt.suffix);
+      g_mqtt.subscribe(sub_topic);
     }
     #endif
   }
@@ -318,6 +477,62 @@ bool mqtt_connect() {
   return connected;
 }
 
+bool mqtt_session_resumed() {
+  return g_session_resumed;
+}
+
+uint8_t mqtt_retained_expected_mask() {
+  uint8_t mask = 0;
+  #ifdef MQTT_SUB_BASE
+  for (const RetainedTopic& rt : kRetainedManifest) {
+    if (rt.required) mask |= rt.field_bit;
+  }
+  #endif
+  return mask;
+}
+
+uint8_t mqtt_retained_seen_mask() {
+  return g_retained_seen_mask;
+}
+
+bool mqtt_retained_complete() {
+  uint8_t expected = mqtt_retained_expected_mask();
+  return (g_retained_seen_mask & expected) == expected;
+}
+
+bool mqtt_wait_for_data(uint32_t timeout_ms) {
+  if (!g_mqtt.connected()) {
+    delay(timeout_ms);
+    return false;
+  }
+
+  // Bytes already pulled into the WiFiClient buffer won't show up in select()
+  #if MQTT_TLS
+  if (g_tls_client.available() > 0) {
+    return true;
+  }
+  #else
+  if (g_wifi_client.available() > 0) {
+    return true;
+  }
+  #endif
+
+  int fd = g_wifi_client.fd();
+  if (fd < 0) {
+    delay(timeout_ms);
+    return false;
+  }
+
+  fd_set rfds;
+  FD_ZERO(&rfds);
+  FD_SET(fd, &rfds);
+  struct timeval tv;
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = (timeout_ms % 1000) * 1000;
+
+  return select(fd + 1, &rfds, nullptr, nullptr, &tv) > 0;
+}
+
 bool mqtt_is_connected() {
   return g_mqtt.connected();
 }
@@ -325,9 +540,7 @@ bool mqtt_is_connected() {
 void mqtt_disconnect() {
   if (g_mqtt.connected()) {
     // Publish offline status before disconnecting
-    char lwt_topic[96];
-    build_topic_buf(lwt_topic, sizeof(lwt_topic), "availability");
-    g_mqtt.publish(lwt_topic, "offline", true);
+    g_mqtt.publish(topic_get(TOPIC_AVAILABILITY), "offline", true);
     g_mqtt.disconnect();
   }
 }
@@ -349,9 +562,6 @@ void publish_device_status() {
   BatteryStatus bs = read_battery_status();
   
   // Build status JSON
-  char topic_buf[96];
-  build_topic_buf(topic_buf, sizeof(topic_buf), "status");
-  
   char payload[256];
   snprintf(payload, sizeof(payload),
     "{\"mode\":\"%s\",\"sleep_interval_sec\":%lu,\"dev_mode_timeout_sec\":%lu,"
@@ -366,13 +576,15 @@ void publish_device_status() {
     ROOM_NAME
   );
   
-  g_mqtt.publish(topic_buf, payload, false);
+  g_mqtt.publish(topic_get(TOPIC_STATUS), payload, false);
   Serial.printf("[MQTT] Published device status: mode=%s, interval=%lus\n", mode, (unsigned long)sleep_interval);
 }
 
 void mqtt_set_client_id(const char* client_id) {
   if (client_id) {
     snprintf(g_mqtt_client_id, sizeof(g_mqtt_client_id), "%s", client_id);
+    topic_table_build(g_mqtt_client_id);
+    mqtt_dispatch_set_prefix(MQTT_NS_DEVICE, topic_device_prefix());
   }
 }
 
@@ -381,7 +593,7 @@ const char* mqtt_get_client_id() {
 }
 
 void mqtt_set_server(const char* server, uint16_t port) {
-  g_mqtt.setServer(server, port);
+  apply_server(server, port);
 }
 
 bool mqtt_publish_raw(const char* topic, const char* payload, bool retain) {
@@ -393,183 +605,165 @@ bool mqtt_publish_raw(const char* topic, const char* payload, bool retain) {
 void mqtt_publish_inside(float tempC, float rhPct) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[64];
 
   // Publish temperature
   if (isfinite(tempC)) {
     snprintf(payload, sizeof(payload), "%.1f", tempC);
-    build_topic_buf(topic_buf, sizeof(topic_buf), "inside/temperature");
-    g_mqtt.publish(topic_buf, payload, true);
+    g_mqtt.publish(topic_get(TOPIC_INSIDE_TEMPERATURE), payload, true);
   }
 
   // Publish humidity
   if (isfinite(rhPct)) {
     snprintf(payload, sizeof(payload), "%.1f", rhPct);
-    build_topic_buf(topic_buf, sizeof(topic_buf), "inside/humidity");
-    g_mqtt.publish(topic_buf, payload, true);
+    g_mqtt.publish(topic_get(TOPIC_INSIDE_HUMIDITY), payload, true);
   }
 }
 
 void mqtt_publish_pressure(float pressureHPa) {
   if (!g_mqtt.connected() || !isfinite(pressureHPa)) return;
 
-  char topic_buf[96];
   char payload[32];
   snprintf(payload, sizeof(payload), "%.1f", pressureHPa);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "inside/pressure");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_INSIDE_PRESSURE), payload, true);
 }
 
 void mqtt_publish_battery(float voltage, int percent) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[32];
 
   // Publish voltage
   if (isfinite(voltage)) {
     snprintf(payload, sizeof(payload), "%.2f", voltage);
-    build_topic_buf(topic_buf, sizeof(topic_buf), "battery/voltage");
-    g_mqtt.publish(topic_buf, payload, true);
+    g_mqtt.publish(topic_get(TOPIC_BATTERY_VOLTAGE), payload, true);
   }
 
   // Publish percentage
   if (percent >= 0) {
     snprintf(payload, sizeof(payload), "%d", percent);
-    build_topic_buf(topic_buf, sizeof(topic_buf), "battery/percent");
-    g_mqtt.publish(topic_buf, payload, true);
+    g_mqtt.publish(topic_get(TOPIC_BATTERY_PERCENT), payload, true);
   }
 }
 
 void mqtt_publish_wifi_rssi(int rssiDbm) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[16];
   snprintf(payload, sizeof(payload), "%d", rssiDbm);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "wifi/rssi");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_WIFI_RSSI), payload, true);
 }
 
 void mqtt_publish_status(const char* payload, bool retain) {
   if (!g_mqtt.connected() || !payload) return;
 
-  char topic_buf[96];
-  build_topic_buf(topic_buf, sizeof(topic_buf), "status");
-  g_mqtt.publish(topic_buf, payload, retain);
+  g_mqtt.publish(topic_get(TOPIC_STATUS), payload, retain);
 }
 
 void mqtt_publish_debug_json(const char* payload, bool retain) {
   if (!g_mqtt.connected() || !payload) return;
 
-  char topic_buf[96];
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/json");
-  g_mqtt.publish(topic_buf, payload, retain);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_JSON), payload, retain);
 }
 
-void mqtt_publish_last_crash(const char* reason_or_null) {
-  if (!g_mqtt.connected()) return;
+bool mqtt_publish_last_crash(const char* reason_or_null) {
+  if (!g_mqtt.connected()) return false;
 
-  char topic_buf[96];
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/last_crash");
+  const char* topic = topic_get(TOPIC_DEBUG_LAST_CRASH);
   if (reason_or_null) {
-    g_mqtt.publish(topic_buf, reason_or_null, true);
+    return g_mqtt.publish(topic, reason_or_null, true);
   } else {
-    g_mqtt.publish(topic_buf, "none", true);
+    return g_mqtt.publish(topic, "none", true);
   }
 }
 
 void mqtt_publish_debug_probe(const char* payload, bool retain) {
   if (!g_mqtt.connected() || !payload) return;
 
-  char topic_buf[96];
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/probe");
-  g_mqtt.publish(topic_buf, payload, retain);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_PROBE), payload, retain);
 }
 
 void mqtt_publish_boot_reason(const char* reason) {
   if (!g_mqtt.connected() || !reason) return;
 
-  char topic_buf[96];
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/boot_reason");
-  g_mqtt.publish(topic_buf, reason, true);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_BOOT_REASON), reason, true);
 }
 
 void mqtt_publish_boot_count(uint32_t count) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[16];
   snprintf(payload, sizeof(payload), "%u", count);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/boot_count");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_BOOT_COUNT), payload, true);
 }
 
 void mqtt_publish_crash_count(uint32_t count) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[16];
   snprintf(payload, sizeof(payload), "%u", count);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/crash_count");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_CRASH_COUNT), payload, true);
 }
 
 void mqtt_publish_uptime(uint32_t uptime_sec) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[16];
   snprintf(payload, sizeof(payload), "%u", uptime_sec);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/uptime");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_UPTIME), payload, true);
 }
 
 void mqtt_publish_wake_count(uint32_t count) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[16];
   snprintf(payload, sizeof(payload), "%u", count);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/wake_count");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_WAKE_COUNT), payload, true);
 }
 
 void mqtt_publish_memory_diagnostics(uint32_t free_heap, uint32_t min_heap,
                                     uint32_t largest_block, float fragmentation_pct) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[128];
   snprintf(payload, sizeof(payload),
           "{\"free\":%u,\"min\":%u,\"largest\":%u,\"frag\":%.1f}",
           free_heap, min_heap, largest_block, fragmentation_pct);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/memory");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_MEMORY), payload, true);
 }
 
 void mqtt_publish_diagnostic_mode(bool active) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
-  build_topic_buf(topic_buf, sizeof(topic_buf), "diagnostic_mode");
-  g_mqtt.publish(topic_buf, active ? "true" : "false", true);
+  g_mqtt.publish(topic_get(TOPIC_DIAGNOSTIC_MODE), active ? "true" : "false", true);
 }
 
 void mqtt_publish_publish_latency_ms(uint32_t publishLatencyMs) {
   if (!g_mqtt.connected()) return;
 
-  char topic_buf[96];
   char payload[16];
   snprintf(payload, sizeof(payload), "%u", publishLatencyMs);
-  build_topic_buf(topic_buf, sizeof(topic_buf), "debug/publish_latency_ms");
-  g_mqtt.publish(topic_buf, payload, true);
+  g_mqtt.publish(topic_get(TOPIC_DEBUG_PUBLISH_LATENCY_MS), payload, true);
 }
 
 // Outside readings management
 void mqtt_update_outside_readings(const OutsideReadings& readings) {
   g_outside = readings;
+  g_outside.weatherKind = g_outside.validWeather ? weather_classify(g_outside.weather)
+                                                 : (uint8_t)WEATHER_KIND_UNKNOWN;
+  save_outside_cache();
+}
+
+bool mqtt_restore_outside_cache() {
+  if (g_outside_cache.magic != OUTSIDE_CACHE_MAGIC) return false;
+  if (!g_outside_cache.validTemp && !g_outside_cache.validWeather) return false;
+
+  g_outside.temperatureC = g_outside_cache.temperatureC;
+  g_outside.validTemp = g_outside_cache.validTemp;
+  g_outside.validWeather = g_outside_cache.validWeather;
+  g_outside.weatherKind = g_outside_cache.weatherKind;
+  safe_strcpy(g_outside.weather, g_outside_cache.weather);
+  return true;
 }
 
 OutsideReadings mqtt_get_outside_readings() {
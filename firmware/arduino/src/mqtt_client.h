@@ -28,6 +28,25 @@ void mqtt_disconnect();
 void mqtt_set_server(const char* server, uint16_t port);
 bool mqtt_publish_raw(const char* topic, const char* payload, bool retain);
 
+// True if this connection resumed a persistent session whose broker-side
+// subscriptions are still current (MQTT_PERSISTENT_SESSION); modules skip
+// re-subscribing their non-retained topics when set
+bool mqtt_session_resumed();
+
+// Retained outdoor data manifest
+// Field bits for the topics subscribed under MQTT_SUB_BASE; aliases share a bit
+#define RETAINED_FIELD_TEMP    (1u << 0)
+#define RETAINED_FIELD_WEATHER (1u << 1)
+#define RETAINED_FIELD_CODE    (1u << 2)
+
+uint8_t mqtt_retained_expected_mask();  // Required fields (0 if nothing subscribed)
+uint8_t mqtt_retained_seen_mask();      // Fields received since the last subscribe
+bool mqtt_retained_complete();          // All required fields received
+
+// Block until the broker socket is readable or the timeout expires
+// Returns true if there is data for mqtt_loop() to process
+bool mqtt_wait_for_data(uint32_t timeout_ms);
+
 // Publishing functions
 void mqtt_publish_inside(float tempC, float rhPct);
 void mqtt_publish_pressure(float pressureHPa);
@@ -35,7 +54,7 @@ void mqtt_publish_battery(float voltage, int percent);
 void mqtt_publish_wifi_rssi(int rssiDbm);
 void mqtt_publish_status(const char* payload, bool retain = true);
 void mqtt_publish_debug_json(const char* payload, bool retain = false);
-void mqtt_publish_last_crash(const char* reason_or_null);
+bool mqtt_publish_last_crash(const char* reason_or_null);
 void mqtt_publish_debug_probe(const char* payload, bool retain = false);
 void mqtt_publish_boot_reason(const char* reason);
 void mqtt_publish_boot_count(uint32_t count);
@@ -50,6 +69,10 @@ void mqtt_publish_publish_latency_ms(uint32_t publishLatencyMs);
 // Outside readings management
 void mqtt_update_outside_readings(const OutsideReadings& readings);
 
+// Seed the outside readings from the values kept in RTC memory over deep
+// sleep (last retained data seen); returns false if none are cached
+bool mqtt_restore_outside_cache();
+
 // Access to MQTT client for logging
 PubSubClient* mqtt_get_client();
 OutsideReadings mqtt_get_outside_readings();
@@ -0,0 +1,116 @@
+// Inbound MQTT dispatch table implementation
+#include "mqtt_dispatch.h"
+#include "safe_strings.h"
+
+// Power of two; keep well above the route count so probes stay short
+static constexpr size_t DISPATCH_SLOTS = 32;
+static constexpr size_t DISPATCH_MAX_PREFIX = 64;
+
+struct DispatchRoute {
+  const char* suffix;       // nullptr = empty slot
+  MqttTopicHandler handler;
+  void* ctx;
+  uint32_t hash;
+  uint8_t ns;
+  uint8_t flags;
+};
+
+struct DispatchPrefix {
+  char str[DISPATCH_MAX_PREFIX];
+  size_t len;
+};
+
+static DispatchRoute g_routes[DISPATCH_SLOTS];
+static DispatchPrefix g_prefixes[MQTT_NS_COUNT];
+static size_t g_route_count = 0;
+static uint32_t g_unmatched = 0;
+static uint32_t g_last_command_ms = 0;
+static bool g_command_seen = false;
+
+// FNV-1a over the suffix, seeded with the namespace
+static uint32_t route_hash(uint8_t ns, const char* s) {
+  uint32_t h = 2166136261u ^ ns;
+  h *= 16777619u;
+  for (; *s; s++) {
+    h ^= (uint8_t)*s;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// Slot holding (ns, suffix), or the empty slot where it would go;
+// returns nullptr only when the table is full and the route is absent
+static DispatchRoute* find_slot(uint8_t ns, const char* suffix, uint32_t hash) {
+  size_t idx = hash & (DISPATCH_SLOTS - 1);
+  for (size_t probe = 0; probe < DISPATCH_SLOTS; probe++) {
+    DispatchRoute& r = g_routes[(idx + probe) & (DISPATCH_SLOTS - 1)];
+    if (!r.suffix) return &r;
+    if (r.hash == hash && r.ns == ns && strcmp(r.suffix, suffix) == 0) return &r;
+  }
+  return nullptr;
+}
+
+void mqtt_dispatch_set_prefix(MqttDispatchNs ns, const char* prefix) {
+  if (ns >= MQTT_NS_COUNT) return;
+  safe_strcpy(g_prefixes[ns].str, prefix ? prefix : "");
+  g_prefixes[ns].len = strlen(g_prefixes[ns].str);
+}
+
+bool mqtt_dispatch_register(MqttDispatchNs ns, const char* suffix,
+                            MqttTopicHandler handler, void* ctx, uint8_t flags) {
+  if (ns >= MQTT_NS_COUNT || !suffix || !handler) return false;
+
+  uint32_t hash = route_hash(ns, suffix);
+  DispatchRoute* slot = find_slot(ns, suffix, hash);
+  if (!slot) {
+    Serial.printf("[MQTT] Dispatch table full - cannot route %s\n", suffix);
+    return false;
+  }
+
+  if (!slot->suffix) g_route_count++;
+  slot->suffix = suffix;
+  slot->handler = handler;
+  slot->ctx = ctx;
+  slot->hash = hash;
+  slot->ns = ns;
+  slot->flags = flags;
+  return true;
+}
+
+bool mqtt_dispatch(const char* topic, const uint8_t* payload, unsigned int length) {
+  if (!topic) return false;
+
+  for (uint8_t ns = 0; ns < MQTT_NS_COUNT; ns++) {
+    const DispatchPrefix& p = g_prefixes[ns];
+    if (p.len == 0 || strncmp(topic, p.str, p.len) != 0) continue;
+
+    const char* suffix = topic + p.len;
+    DispatchRoute* r = find_slot(ns, suffix, route_hash(ns, suffix));
+    if (!r || !r->suffix) continue;   // A longer prefix in another namespace may match
+
+    if (r->flags & MQTT_ROUTE_RATE_LIMITED) {
+      uint32_t now = millis();
+      if (g_command_seen && now - g_last_command_ms < MQTT_COMMAND_COOLDOWN_MS) {
+        Serial.println("[MQTT] Command rate limited - ignoring");
+        return false;
+      }
+      g_last_command_ms = now;
+      g_command_seen = true;
+    }
+
+    MqttInbound msg = {topic, suffix, payload, length, r->ctx};
+    r->handler(msg);
+    return true;
+  }
+
+  g_unmatched++;
+  return false;
+}
+
+size_t mqtt_dispatch_route_count() {
+  return g_route_count;
+}
+
+uint32_t mqtt_dispatch_unmatched_count() {
+  return g_unmatched;
+}
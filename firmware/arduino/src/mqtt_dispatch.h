@@ -0,0 +1,59 @@
+#pragma once
+
+// Inbound MQTT dispatch table
+// Routes an incoming topic to its handler with one prefix compare and one
+// hash probe instead of testing every known suffix in turn. Each namespace
+// owns a topic prefix (the device prefix, the outdoor MQTT_SUB_BASE); the
+// prefix is stripped once and the remaining suffix is looked up in a small
+// open-addressed table.
+//
+// Usage:
+//   mqtt_dispatch_set_prefix(MQTT_NS_DEVICE, topic_device_prefix());
+//   mqtt_dispatch_register(MQTT_NS_DEVICE, "cmd/reboot", on_reboot, nullptr,
+//                          MQTT_ROUTE_RATE_LIMITED);
+//   // From the PubSubClient callback:
+//   mqtt_dispatch(topic, payload, length);
+//
+// Suffix strings are stored by pointer and must outlive the table (string
+// literals or static storage).
+
+#include <Arduino.h>
+
+enum MqttDispatchNs : uint8_t {
+  MQTT_NS_DEVICE = 0,     // espsensor/<id>/...
+  MQTT_NS_OUTSIDE,        // MQTT_SUB_BASE...
+  MQTT_NS_HOMEASSISTANT,  // homeassistant/...
+  MQTT_NS_COUNT
+};
+
+// Route flags
+static constexpr uint8_t MQTT_ROUTE_RATE_LIMITED = 0x01;  // Subject to the command cooldown
+
+// Minimum spacing between rate-limited commands (prevents flooding/DoS)
+static constexpr uint32_t MQTT_COMMAND_COOLDOWN_MS = 1000;
+
+struct MqttInbound {
+  const char* topic;        // Full topic as received
+  const char* suffix;       // Topic with the namespace prefix stripped
+  const uint8_t* payload;
+  unsigned int length;
+  void* ctx;                // Value given at registration
+};
+
+typedef void (*MqttTopicHandler)(const MqttInbound& msg);
+
+// Set (or replace) a namespace prefix; the string is copied
+void mqtt_dispatch_set_prefix(MqttDispatchNs ns, const char* prefix);
+
+// Register a handler for an exact suffix; re-registering a suffix replaces
+// its handler. Returns false if the table is full.
+bool mqtt_dispatch_register(MqttDispatchNs ns, const char* suffix,
+                            MqttTopicHandler handler, void* ctx = nullptr,
+                            uint8_t flags = 0);
+
+// Dispatch one message; returns true if a handler ran
+bool mqtt_dispatch(const char* topic, const uint8_t* payload, unsigned int length);
+
+// Registered route count and lookups that found no handler (diagnostics)
+size_t mqtt_dispatch_route_count();
+uint32_t mqtt_dispatch_unmatched_count();
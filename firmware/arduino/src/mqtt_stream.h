@@ -0,0 +1,40 @@
+#pragma once
+
+// Streamed JSON publish (json_stream.h over PubSubClient)
+// MQTT needs the payload length before the first byte, so the emitter runs
+// twice: a counting pass, then beginPublish() with that length and a second
+// pass that writes straight into the client's stream. No document buffer and
+// no MQTT_MAX_PACKET_SIZE limit; only the 64-byte chunk sits in RAM.
+//
+// Both passes must emit the same document: read anything that changes while
+// it runs (millis, heap) into locals first. A shorter second pass is padded
+// with spaces, a longer one cut at the announced length and reported false.
+//
+// Usage:
+//   uint32_t heap = esp_get_free_heap_size();
+//   mqtt_publish_json_stream(client, topic, false, [&](JsonStream& j) {
+//       j.beginObject().field("free", heap).endObject();
+//   });
+
+#include <PubSubClient.h>
+#include "json_stream.h"
+
+inline size_t mqtt_stream_sink(void* ctx, const char* data, size_t len) {
+    return static_cast<PubSubClient*>(ctx)->write(reinterpret_cast<const uint8_t*>(data), len);
+}
+
+template <typename Emit>
+bool mqtt_publish_json_stream(PubSubClient* client, const char* topic, bool retain, Emit emit) {
+    if (!client || !client->connected() || !topic) return false;
+
+    JsonStream counter;
+    emit(counter);
+    size_t len = counter.length();
+
+    if (!client->beginPublish(topic, len, retain)) return false;
+    JsonStream out(mqtt_stream_sink, client, len);
+    emit(out);
+    out.finish();
+    bool sent = client->endPublish() == 1;
+    return sent && !out.overflowed() && out.written() == len;
+}
@@ -8,6 +8,9 @@
 #include "ha_discovery.h"
 #include "common_types.h"
 #include "generated_config.h"
+#include "net_events.h"
+#include "offline_queue.h"
+#include "espnow_link.h"
 
 // Static storage for backward compatibility
 static char g_client_id[40];
@@ -15,17 +18,6 @@ static OutsideReadings g_outside;
 static bool g_diagnostic_mode_requested = false;
 static bool g_diagnostic_mode_request_value = false;
 
-// Offline sample structure for data persistence
-struct OfflineSample {
-  uint32_t timestamp;
-  float tempC;
-  float rhPct;
-  float pressureHPa;
-  bool hasTemp;
-  bool hasRh;
-  bool hasPressure;
-};
-
 // Initialize networking components
 inline void net_begin() {
   // Generate client ID
@@ -43,6 +35,12 @@ inline void net_begin() {
 // Main network loop
 inline void net_loop() {
   mqtt_loop();
+  ha_discovery_service();
+
+  // Gateway build: bridge sensors' ESP-NOW reports to their MQTT topics
+  #if ESPNOW_GATEWAY
+  espnow_gateway_service(mqtt_get_client());
+  #endif
   
   // Check for diagnostic mode commands
   if (mqtt_is_diagnostic_mode_requested()) {
@@ -159,7 +157,14 @@ inline bool net_mqtt_connect_with_retry(uint32_t timeout_ms, uint32_t max_attemp
     if (mqtt_connect()) {
       return true;
     }
-    delay(1000);
+    // Back off before retrying. If WiFi is down, retry as soon as it gets an
+    // IP again; if it is up, cut the backoff short when the link drops
+    if (!wifi_is_connected()) {
+      net_events_wait(NET_EVT_WIFI_GOT_IP, 1000);
+    } else {
+      net_events_clear(NET_EVT_WIFI_DISCONNECTED);
+      net_events_wait(NET_EVT_WIFI_DISCONNECTED, 1000);
+    }
   }
   return false;
 }
@@ -183,8 +188,8 @@ inline bool net_init_and_connect() {
   
   Serial.println(F("MQTT connected"));
   
-  // Publish discovery
-  net_publish_ha_discovery();
+  // Publish discovery (skipped when the retained set on the broker is current)
+  ha_discovery_publish_if_changed();
   
   return true;
 }
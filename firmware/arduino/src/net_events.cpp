@@ -0,0 +1,65 @@
+// Network event signalling implementation
+#include "net_events.h"
+#include <WiFi.h>
+#include <esp_sntp.h>
+
+static EventGroupHandle_t g_net_events = nullptr;
+
+static void on_wifi_event(arduino_event_id_t event) {
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      net_events_clear(NET_EVT_WIFI_DISCONNECTED);
+      net_events_set(NET_EVT_WIFI_GOT_IP);
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      net_events_clear(NET_EVT_WIFI_GOT_IP | NET_EVT_MQTT_CONNECTED);
+      net_events_set(NET_EVT_WIFI_DISCONNECTED);
+      break;
+    default:
+      break;
+  }
+}
+
+static void on_time_sync(struct timeval* tv) {
+  (void)tv;
+  net_events_set(NET_EVT_TIME_SYNCED);
+}
+
+void net_events_begin() {
+  if (g_net_events) return;
+
+  g_net_events = xEventGroupCreate();
+  if (!g_net_events) {
+    Serial.println("[NetEvt] Failed to create event group");
+    return;
+  }
+
+  WiFi.onEvent(on_wifi_event);
+  sntp_set_time_sync_notification_cb(on_time_sync);
+}
+
+void net_events_set(uint32_t bits) {
+  if (g_net_events) xEventGroupSetBits(g_net_events, (EventBits_t)bits);
+}
+
+void net_events_clear(uint32_t bits) {
+  if (g_net_events) xEventGroupClearBits(g_net_events, (EventBits_t)bits);
+}
+
+uint32_t net_events_get() {
+  return g_net_events ? (uint32_t)xEventGroupGetBits(g_net_events) : 0;
+}
+
+uint32_t net_events_wait(uint32_t bits, uint32_t timeout_ms) {
+  if (!g_net_events) {
+    // No event group - degrade to a single short sleep so callers still progress
+    delay(timeout_ms < 10 ? timeout_ms : 10);
+    return 0;
+  }
+
+  return (uint32_t)xEventGroupWaitBits(g_net_events, (EventBits_t)bits,
+                                       pdFALSE,   // Don't clear on exit
+                                       pdFALSE,   // Any bit
+                                       pdMS_TO_TICKS(timeout_ms));
+}
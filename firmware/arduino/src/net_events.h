@@ -0,0 +1,34 @@
+#pragma once
+
+// Network event signalling
+// Bridges WiFi/SNTP/MQTT callbacks to a FreeRTOS event group so the main task
+// can block until a link condition is met instead of polling with delay().
+//
+// Usage:
+//   net_events_begin();                                  // Once, before WiFi.begin()
+//   net_events_clear(NET_EVT_WIFI_GOT_IP);
+//   WiFi.begin(...);
+//   if (net_events_wait(NET_EVT_WIFI_GOT_IP, timeout_ms) & NET_EVT_WIFI_GOT_IP) { ... }
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+// Event bits
+#define NET_EVT_WIFI_GOT_IP        (1u << 0)  // Station has an IP (DHCP or static)
+#define NET_EVT_WIFI_DISCONNECTED  (1u << 1)  // Station lost/failed association
+#define NET_EVT_TIME_SYNCED        (1u << 2)  // SNTP delivered a time update
+#define NET_EVT_MQTT_CONNECTED     (1u << 3)  // Broker accepted CONNECT (CONNACK)
+#define NET_EVT_MQTT_DATA          (1u << 4)  // A subscribed data message arrived
+
+// Create the event group and register WiFi/SNTP handlers (idempotent)
+void net_events_begin();
+
+// Set/clear bits (safe from WiFi event task and MQTT callback)
+void net_events_set(uint32_t bits);
+void net_events_clear(uint32_t bits);
+uint32_t net_events_get();
+
+// Block until any of `bits` is set or the timeout expires
+// Returns the event bits at the time of return (bits are not cleared)
+uint32_t net_events_wait(uint32_t bits, uint32_t timeout_ms);
@@ -0,0 +1,88 @@
+#pragma once
+
+// NTP sync scheduling with RTC clock drift compensation
+// The system clock keeps running through deep sleep on the RTC slow clock,
+// which runs fast or slow by a few hundred ppm. Each NTP sync measures how far
+// the clock wandered since the previous one; that rate is learnt (as a
+// correction on top of the one already applied) and taken back out of the
+// clock on every wake. The residual of the last measurement bounds how wrong
+// the clock can be now, so NTP is only queried again once that estimate
+// passes the caller's error bound, or at the interval ceiling regardless.
+//
+// Usage:
+//   NtpSchedule& s = g_rtc_state.ntp;
+//   int64_t us = ntp_take_correction_us(s, now_sec);   // Once per wake
+//   if (ntp_sync_due(s, now_sec, 10000, 86400)) { ... query NTP ... }
+//   ntp_on_sync(s, local_sec, ntp_sec);                 // With the reply
+
+#include <cmath>
+#include <cstdint>
+
+static constexpr uint32_t NTP_MIN_VALID_EPOCH = 1700000000u;   // Nov 2023
+// Shorter spans are dominated by the reply's own latency, not drift
+static constexpr uint32_t NTP_MIN_DRIFT_SPAN_SEC = 3600;
+static constexpr float NTP_DRIFT_UNKNOWN_PPM = 500.0f;   // Before any measurement
+static constexpr float NTP_DRIFT_FLOOR_PPM = 20.0f;      // Crystal/RC temperature wander
+static constexpr float NTP_DRIFT_MAX_PPM = 20000.0f;     // Larger: a step, not drift
+
+struct NtpSchedule {
+  uint32_t last_sync_epoch;     // NTP time of the last sync, 0 = never
+  uint32_t last_adjust_epoch;   // Clock time the correction was last applied
+  float drift_ppm;              // Learnt clock rate error, + = runs fast
+  float uncertainty_ppm;        // Residual of the last measurement
+  uint16_t sync_count;
+  uint8_t reserved[2];
+};
+
+static_assert(sizeof(NtpSchedule) % 4 == 0, "NtpSchedule must not leave tail padding");
+
+inline bool ntp_time_valid(uint32_t epoch) {
+  return epoch >= NTP_MIN_VALID_EPOCH;
+}
+
+// Microseconds to add to the clock for the drift since the last call;
+// 0 until a rate has been measured or while the clock is not set
+inline int64_t ntp_take_correction_us(NtpSchedule& s, uint32_t now_sec) {
+  if (!ntp_time_valid(now_sec) || s.last_adjust_epoch == 0) return 0;
+  if (now_sec <= s.last_adjust_epoch) return 0;
+  uint32_t dt = now_sec - s.last_adjust_epoch;
+  s.last_adjust_epoch = now_sec;
+  // ppm of the elapsed seconds is microseconds
+  return -(int64_t)llround((double)dt * s.drift_ppm);
+}
+
+// Estimated error of the clock now, milliseconds
+inline uint32_t ntp_error_ms(const NtpSchedule& s, uint32_t now_sec) {
+  if (s.last_sync_epoch == 0 || now_sec < s.last_sync_epoch) return UINT32_MAX;
+  float ppm = s.sync_count >= 2 ? std::fmax(s.uncertainty_ppm, NTP_DRIFT_FLOOR_PPM)
+                                : NTP_DRIFT_UNKNOWN_PPM;
+  double ms = (double)(now_sec - s.last_sync_epoch) * ppm / 1000.0;
+  return ms >= (double)UINT32_MAX ? UINT32_MAX : (uint32_t)ms;
+}
+
+inline bool ntp_sync_due(const NtpSchedule& s, uint32_t now_sec, uint32_t max_error_ms,
+                         uint32_t max_interval_sec) {
+  if (!ntp_time_valid(now_sec) || s.last_sync_epoch == 0) return true;
+  if (now_sec < s.last_sync_epoch) return true;   // Clock went backwards
+  if (now_sec - s.last_sync_epoch >= max_interval_sec) return true;
+  return ntp_error_ms(s, now_sec) > max_error_ms;
+}
+
+// Record a sync: local_sec is what the clock read at the moment the reply
+// set it to ntp_sec (both with fractions)
+inline void ntp_on_sync(NtpSchedule& s, double local_sec, double ntp_sec) {
+  if (s.last_sync_epoch != 0 && ntp_time_valid((uint32_t)local_sec) &&
+      ntp_sec > (double)s.last_sync_epoch + NTP_MIN_DRIFT_SPAN_SEC) {
+    double span = ntp_sec - (double)s.last_sync_epoch;
+    float residual = (float)((local_sec - ntp_sec) / span * 1e6);
+    if (std::fabs(residual) <= NTP_DRIFT_MAX_PPM) {
+      s.drift_ppm += residual;
+      s.uncertainty_ppm = std::fabs(residual);
+      if (s.sync_count < UINT16_MAX) s.sync_count++;
+    }
+  } else if (s.last_sync_epoch == 0) {
+    s.sync_count = 1;
+  }
+  s.last_sync_epoch = (uint32_t)ntp_sec;
+  s.last_adjust_epoch = (uint32_t)ntp_sec;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+// NVS write-back cache
+// Keeps a small typed key table in RAM with the value last seen in flash and
+// the value the firmware wants there now. Stores only touch the table; the
+// flush at the end of the wake writes the keys whose value actually changed,
+// so a wake that re-stores the same values costs no flash writes at all.
+// Values are compared as raw 32-bit patterns, so a float NaN that was loaded
+// and stored back counts as unchanged.
+//
+// Usage:
+//   NvsWriteCache<16> cache;
+//   uint32_t bits;
+//   if (!cache.lookup("icon", NVS_CACHE_U32, bits)) {
+//       bits = read_from_flash("icon");
+//       cache.noteLoaded("icon", NVS_CACHE_U32, bits, found);
+//   }
+//   cache.store("icon", NVS_CACHE_U32, 42);
+//   cache.flush([](const char* key, NvsCacheType type, uint32_t bits) { return write(key, type, bits); });
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static constexpr size_t NVS_CACHE_KEY_LEN = 16;     // NVS keys are at most 15 chars
+
+enum NvsCacheType : uint8_t {
+    NVS_CACHE_FLOAT = 0,    // Stored as a 4-byte blob (Preferences::putFloat layout)
+    NVS_CACHE_U32,
+    NVS_CACHE_U16,
+    NVS_CACHE_U8
+};
+
+inline uint32_t nvs_float_bits(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+inline float nvs_bits_float(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+template <size_t N>
+class NvsWriteCache {
+public:
+    struct Entry {
+        char key[NVS_CACHE_KEY_LEN];
+        uint8_t type;           // NvsCacheType
+        bool in_flash;          // flash_bits is what flash holds
+        bool stored;            // current_bits set this wake
+        uint32_t flash_bits;
+        uint32_t current_bits;
+    };
+
+    // Value for key if the table knows it (stored this wake, or loaded)
+    bool lookup(const char* key, NvsCacheType type, uint32_t& bits) const {
+        const Entry* e = find(key, type);
+        if (!e) return false;
+        if (e->stored) {
+            bits = e->current_bits;
+            return true;
+        }
+        if (!e->in_flash) return false;     // Known absent: caller applies its default
+        bits = e->flash_bits;
+        return true;
+    }
+
+    // Whether flash was read for key (so no read is needed before store)
+    bool known(const char* key, NvsCacheType type) const { return find(key, type) != nullptr; }
+
+    // Record what flash holds for key (found = false: key absent)
+    void noteLoaded(const char* key, NvsCacheType type, uint32_t bits, bool found) {
+        Entry* e = findOrAdd(key, type);
+        if (!e) return;
+        e->in_flash = found;
+        e->flash_bits = found ? bits : 0;
+    }
+
+    // Queue a value; false when the table is full (caller writes through)
+    bool store(const char* key, NvsCacheType type, uint32_t bits) {
+        Entry* e = findOrAdd(key, type);
+        if (!e) return false;
+        e->stored = true;
+        e->current_bits = bits;
+        return true;
+    }
+
+    bool dirty(const Entry& e) const {
+        return e.stored && (!e.in_flash || e.flash_bits != e.current_bits);
+    }
+
+    size_t dirtyCount() const {
+        size_t n = 0;
+        for (size_t i = 0; i < count_; i++) {
+            if (dirty(entries_[i])) n++;
+        }
+        return n;
+    }
+
+    // write(key, type, bits) -> bool for each changed key; written keys
+    // become clean. Returns the number written; unchanged stores are
+    // counted in skipped().
+    template <typename Fn>
+    size_t flush(Fn write) {
+        size_t written = 0;
+        for (size_t i = 0; i < count_; i++) {
+            Entry& e = entries_[i];
+            if (!e.stored) continue;
+            if (!dirty(e)) {
+                skipped_++;
+            } else if (write(e.key, (NvsCacheType)e.type, e.current_bits)) {
+                e.in_flash = true;
+                e.flash_bits = e.current_bits;
+                written++;
+            }
+            e.stored = false;
+        }
+        written_ += (uint32_t)written;
+        return written;
+    }
+
+    void clear() { count_ = 0; }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return N; }
+    uint32_t written() const { return written_; }
+    uint32_t skipped() const { return skipped_; }
+    uint32_t overflows() const { return overflows_; }
+
+private:
+    const Entry* find(const char* key, NvsCacheType type) const {
+        for (size_t i = 0; i < count_; i++) {
+            if (entries_[i].type == type && strncmp(entries_[i].key, key, NVS_CACHE_KEY_LEN) == 0) {
+                return &entries_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    Entry* findOrAdd(const char* key, NvsCacheType type) {
+        Entry* e = const_cast<Entry*>(find(key, type));
+        if (e) return e;
+        if (count_ >= N || strlen(key) >= NVS_CACHE_KEY_LEN) {
+            overflows_++;
+            return nullptr;
+        }
+        e = &entries_[count_++];
+        memset(e, 0, sizeof(*e));
+        strncpy(e->key, key, NVS_CACHE_KEY_LEN - 1);
+        e->type = type;
+        return e;
+    }
+
+    Entry entries_[N] = {};
+    size_t count_ = 0;
+    uint32_t written_ = 0;
+    uint32_t skipped_ = 0;
+    uint32_t overflows_ = 0;
+};
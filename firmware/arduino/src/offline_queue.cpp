@@ -0,0 +1,182 @@
+#include "offline_queue.h"
+#include <PubSubClient.h>
+#include <math.h>
+
+// RTC memory - persists across deep sleep
+RTC_DATA_ATTR OfflineQueue::Ring OfflineQueue::ring_ = {};
+
+// Chunk size keeps each publish inside PubSubClient's 512-byte packet buffer
+static constexpr size_t CHUNK_BYTES = 384;
+
+static int16_t quantize_temp(float c) {
+    float q = roundf(c * 100.0f);
+    if (q < -32767.0f) q = -32767.0f;
+    if (q > 32767.0f) q = 32767.0f;
+    return (int16_t)q;
+}
+
+static uint16_t quantize_u16(float v, float scale) {
+    float q = roundf(v * scale);
+    if (q < 0.0f) q = 0.0f;
+    if (q > 65534.0f) q = 65534.0f;
+    return (uint16_t)q;
+}
+
+OfflineQueue& OfflineQueue::getInstance() {
+    static OfflineQueue instance;
+    return instance;
+}
+
+void OfflineQueue::push(const OfflineSample& sample) {
+    validateRing();
+
+    if (ring_.count >= CAPACITY) {
+        popFront(1);
+        ring_.dropped++;
+    }
+
+    PackedSample p;
+    if (ring_.count == 0) {
+        ring_.base_ts = sample.timestamp;
+        p.dt_sec = 0;
+    } else {
+        // Clock stepped backwards (NTP correction) - keep order, zero delta
+        uint32_t dt = sample.timestamp > ring_.last_ts ? sample.timestamp - ring_.last_ts : 0;
+        p.dt_sec = dt > 0xFFFF ? 0xFFFF : (uint16_t)dt;
+    }
+    ring_.last_ts = sample.timestamp;
+
+    p.temp_cC = (sample.hasTemp && isfinite(sample.tempC))
+                    ? quantize_temp(sample.tempC) : TEMP_INVALID;
+    p.rh_cPct = (sample.hasRh && isfinite(sample.rhPct))
+                    ? quantize_u16(sample.rhPct, 100.0f) : U16_INVALID;
+    p.press_dHPa = (sample.hasPressure && isfinite(sample.pressureHPa))
+                    ? quantize_u16(sample.pressureHPa, 10.0f) : U16_INVALID;
+
+    ring_.samples[(ring_.tail + ring_.count) % CAPACITY] = p;
+    ring_.count++;
+}
+
+bool OfflineQueue::replay(PubSubClient* client, const char* client_id) {
+    if (size() == 0) return true;
+    if (!client || !client->connected() || !client_id || !client_id[0]) return false;
+
+    char topic[96];
+    snprintf(topic, sizeof(topic), "espsensor/%s%s", client_id, TOPIC_SUFFIX);
+
+    char payload[CHUNK_BYTES];
+    size_t sent = 0;
+    while (ring_.count > 0) {
+        size_t n = formatChunk(payload, sizeof(payload), ring_.count);
+        if (n == 0) break;
+
+        if (!client->publish(topic, payload, false)) {
+            Serial.printf("[Offline] Replay stopped after %u samples, %u kept\n",
+                          (unsigned)sent, (unsigned)ring_.count);
+            return false;
+        }
+        popFront(n);
+        sent += n;
+    }
+
+    Serial.printf("[Offline] Replayed %u samples (%u dropped while offline)\n",
+                  (unsigned)sent, (unsigned)ring_.dropped);
+    ring_.dropped = 0;
+    return ring_.count == 0;
+}
+
+size_t OfflineQueue::size() const {
+    return ring_.magic == QUEUE_MAGIC ? ring_.count : 0;
+}
+
+uint32_t OfflineQueue::getDroppedCount() const {
+    return ring_.magic == QUEUE_MAGIC ? ring_.dropped : 0;
+}
+
+void OfflineQueue::clear() {
+    memset(&ring_, 0, sizeof(ring_));
+    ring_.magic = QUEUE_MAGIC;
+}
+
+bool OfflineQueue::get(size_t index, OfflineSample& out) const {
+    if (index >= size()) return false;
+
+    uint32_t ts = ring_.base_ts;
+    for (size_t i = 1; i <= index; i++) {
+        ts += ring_.samples[(ring_.tail + i) % CAPACITY].dt_sec;
+    }
+    const PackedSample& p = ring_.samples[(ring_.tail + index) % CAPACITY];
+
+    out.timestamp = ts;
+    out.hasTemp = p.temp_cC != TEMP_INVALID;
+    out.hasRh = p.rh_cPct != U16_INVALID;
+    out.hasPressure = p.press_dHPa != U16_INVALID;
+    out.tempC = out.hasTemp ? p.temp_cC / 100.0f : NAN;
+    out.rhPct = out.hasRh ? p.rh_cPct / 100.0f : NAN;
+    out.pressureHPa = out.hasPressure ? p.press_dHPa / 10.0f : NAN;
+    return true;
+}
+
+size_t OfflineQueue::formatChunk(char* out, size_t out_size, size_t max_samples) const {
+    if (!out || out_size == 0) return 0;
+    out[0] = '\0';
+
+    size_t n_avail = size();
+    if (max_samples > n_avail) max_samples = n_avail;
+    if (max_samples == 0) return 0;
+
+    int written = snprintf(out, out_size, "{\"v\":1,\"t0\":%lu,\"s\":[",
+                           (unsigned long)ring_.base_ts);
+    if (written < 0 || (size_t)written >= out_size) { out[0] = '\0'; return 0; }
+    size_t pos = (size_t)written;
+
+    size_t n = 0;
+    for (; n < max_samples; n++) {
+        const PackedSample& p = ring_.samples[(ring_.tail + n) % CAPACITY];
+
+        char t[8], rh[8], pr[8];
+        if (p.temp_cC != TEMP_INVALID) snprintf(t, sizeof(t), "%d", p.temp_cC);
+        else strcpy(t, "null");
+        if (p.rh_cPct != U16_INVALID) snprintf(rh, sizeof(rh), "%u", p.rh_cPct);
+        else strcpy(rh, "null");
+        if (p.press_dHPa != U16_INVALID) snprintf(pr, sizeof(pr), "%u", p.press_dHPa);
+        else strcpy(pr, "null");
+
+        char rec[48];
+        int len = snprintf(rec, sizeof(rec), "%s[%u,%s,%s,%s]", n ? "," : "",
+                           n ? p.dt_sec : 0, t, rh, pr);
+        if (len < 0 || (size_t)len >= sizeof(rec)) break;
+
+        if (pos + (size_t)len + 3 > out_size) break;  // Keep room for "]}"
+        memcpy(out + pos, rec, (size_t)len + 1);
+        pos += (size_t)len;
+    }
+
+    if (n == 0) { out[0] = '\0'; return 0; }
+    memcpy(out + pos, "]}", 3);
+    return n;
+}
+
+void OfflineQueue::validateRing() {
+    if (ring_.magic == QUEUE_MAGIC &&
+        ring_.tail < CAPACITY &&
+        ring_.count <= CAPACITY) {
+        return;
+    }
+
+    // First boot or corrupted RTC memory - start clean
+    clear();
+}
+
+void OfflineQueue::popFront(size_t n) {
+    while (n-- > 0 && ring_.count > 0) {
+        ring_.tail = (ring_.tail + 1) % CAPACITY;
+        ring_.count--;
+        if (ring_.count > 0) {
+            // New oldest sample carries the absolute base
+            PackedSample& head = ring_.samples[ring_.tail];
+            ring_.base_ts += head.dt_sec;
+            head.dt_sec = 0;
+        }
+    }
+}
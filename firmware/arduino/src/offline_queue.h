@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+#include "feature_flags.h"
+
+// Offline sample queue
+// Keeps readings from wakes that could not reach the broker in an RTC ring of
+// compact records (delta-encoded timestamps, 16-bit quantized values) and
+// replays them in a few batched publishes once MQTT is back.
+//
+// Usage:
+//   OfflineSample s = {...};
+//   OfflineQueue::getInstance().push(s);                     // Network down
+//   ...
+//   OfflineQueue::getInstance().replay(client, client_id);   // After mqtt connect
+//
+// Payload (espsensor/<id>/history, not retained, one or more chunks):
+//   {"v":1,"t0":1700000000,"s":[[0,2150,4512,10132],[300,2148,null,10131],...]}
+//   t0 is the epoch of the chunk's first sample; each row is
+//   [dt_sec_since_previous, tempC*100, rh*100, hPa*10]; null = not measured.
+
+class PubSubClient;
+
+// Offline sample structure for data persistence
+struct OfflineSample {
+    uint32_t timestamp;
+    float tempC;
+    float rhPct;
+    float pressureHPa;
+    bool hasTemp;
+    bool hasRh;
+    bool hasPressure;
+};
+
+class OfflineQueue {
+public:
+    static constexpr size_t CAPACITY = 96;                 // 8 h at 5 min wakes
+    static constexpr uint32_t QUEUE_MAGIC = 0x4F465131;    // "OFQ1"
+    static constexpr const char* TOPIC_SUFFIX = "/history";
+
+    // Quantized sentinels for "not measured"
+    static constexpr int16_t TEMP_INVALID = INT16_MIN;
+    static constexpr uint16_t U16_INVALID = 0xFFFF;
+
+    struct PackedSample {
+        uint16_t dt_sec;        // Seconds since previous sample (0 for oldest)
+        int16_t temp_cC;        // Centi-degrees C
+        uint16_t rh_cPct;       // Centi-percent RH
+        uint16_t press_dHPa;    // Deci-hPa
+    };
+
+    static OfflineQueue& getInstance();
+
+    // Append a sample, dropping the oldest when full
+    void push(const OfflineSample& sample);
+
+    // Publish all queued samples; removes only what the broker accepted
+    // Returns true if the queue is empty afterwards
+    bool replay(PubSubClient* client, const char* client_id);
+
+    size_t size() const;
+    uint32_t getDroppedCount() const;
+    void clear();
+
+    // Decode entry i (0 = oldest) back to an OfflineSample
+    bool get(size_t index, OfflineSample& out) const;
+
+    // Format up to max_samples from the oldest as one payload chunk
+    // Returns the number of samples written (0 if none fit)
+    size_t formatChunk(char* out, size_t out_size, size_t max_samples) const;
+
+private:
+    OfflineQueue() = default;
+    ~OfflineQueue() = default;
+    OfflineQueue(const OfflineQueue&) = delete;
+    OfflineQueue& operator=(const OfflineQueue&) = delete;
+
+    struct Ring {
+        uint32_t magic;
+        uint32_t base_ts;       // Epoch of the oldest sample
+        uint32_t last_ts;       // Epoch of the newest sample
+        uint32_t dropped;       // Samples lost to overflow
+        uint16_t tail;          // Oldest slot
+        uint16_t count;
+        PackedSample samples[CAPACITY];
+    };
+
+    // RTC memory storage (persists across deep sleep)
+    RTC_DATA_ATTR static Ring ring_;
+
+    void validateRing();
+    void popFront(size_t n);
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+// Streaming delta patch decoder for OTA updates (ota_update.cpp)
+// A patch rebuilds the new image from the running one with three ops, so
+// code that only moved or had its addresses shifted costs a few bytes per
+// region instead of its full size. Patch bytes can arrive in pieces of any
+// size over any number of wakes: the decoder state is a small POD that is
+// kept in RTC memory and checkpointed to NVS between chunks.
+//
+// Usage:
+//   OtaDeltaState st;
+//   ota_delta_init(st);
+//   size_t used;
+//   OtaDeltaResult r = ota_delta_feed(st, limits, chunk, len, 8192, used,
+//       [&](uint32_t off, uint8_t* buf, size_t n) { return read_running(off, buf, n); },
+//       [&](uint32_t off, const uint8_t* buf, size_t n) { return write_target(off, buf, n); });
+//
+// Patch format (built by scripts/ota_delta.py); varints are unsigned LEB128:
+//   0x00                          END, the output must be exactly dst_size bytes
+//   0x01 src len                  COPY len source bytes from src
+//   0x02 len <len bytes>          DATA: literal bytes
+//   0x03 src len {skip n <n>}...  ADD: len bytes of source from src, unchanged for
+//                                 each skip run, then n bytes with a delta added
+//                                 (mod 256); segments until len is covered
+// Output is written strictly in order, so at most one sector is ever open.
+
+#include <cstddef>
+#include <cstdint>
+
+static constexpr uint8_t OTA_DELTA_OP_END = 0x00;
+static constexpr uint8_t OTA_DELTA_OP_COPY = 0x01;
+static constexpr uint8_t OTA_DELTA_OP_DATA = 0x02;
+static constexpr uint8_t OTA_DELTA_OP_ADD = 0x03;
+
+// Source bytes read per callback while copying or adding
+static constexpr size_t OTA_DELTA_BLOCK = 64;
+
+enum OtaDeltaPhase : uint8_t {
+  OTA_DELTA_READ_OP = 0,
+  OTA_DELTA_READ_SRC,       // Varint args
+  OTA_DELTA_READ_LEN,
+  OTA_DELTA_DATA_BYTES,
+  OTA_DELTA_ADD_SKIP,
+  OTA_DELTA_ADD_COUNT,
+  OTA_DELTA_ADD_BYTES,
+  OTA_DELTA_COPY_RUN,       // Copying source bytes (COPY, or an ADD skip run)
+  OTA_DELTA_SKIP_RUN,
+  OTA_DELTA_FINISHED,
+  OTA_DELTA_FAILED
+};
+
+enum OtaDeltaResult : uint8_t {
+  OTA_DELTA_MORE = 0,       // Needs more patch bytes (or more output budget)
+  OTA_DELTA_DONE,           // END seen with the full image written
+  OTA_DELTA_ERROR           // Malformed patch or a callback failed
+};
+
+struct OtaDeltaLimits {
+  uint32_t src_size;        // Running image bytes the patch may read
+  uint32_t dst_size;        // Exact size of the rebuilt image
+};
+
+struct OtaDeltaState {
+  uint32_t out_pos;         // Image bytes written
+  uint32_t src_pos;         // Next source byte of the current COPY/ADD
+  uint32_t remaining;       // Bytes left in the current op
+  uint32_t segment;         // Bytes left in the current run or segment
+  uint32_t varint;          // Varint being assembled
+  uint8_t varint_shift;
+  uint8_t op;
+  uint8_t phase;            // OtaDeltaPhase
+  uint8_t reserved;
+};
+
+static_assert(sizeof(OtaDeltaState) % 4 == 0, "OtaDeltaState must not leave tail padding");
+
+inline void ota_delta_init(OtaDeltaState& st) {
+  st = OtaDeltaState();
+}
+
+inline OtaDeltaResult ota_delta_fail(OtaDeltaState& st) {
+  st.phase = OTA_DELTA_FAILED;
+  return OTA_DELTA_ERROR;
+}
+
+// Feeds one varint byte; true once the value is complete
+inline bool ota_delta_varint(OtaDeltaState& st, uint8_t b, bool& overflow) {
+  if (st.varint_shift > 28 || (st.varint_shift == 28 && (b & 0x70))) {
+    overflow = true;
+    return false;
+  }
+  st.varint |= (uint32_t)(b & 0x7F) << st.varint_shift;
+  st.varint_shift += 7;
+  return (b & 0x80) == 0;
+}
+
+// Copies n source bytes from st.src_pos to the output
+template <typename ReadSrc, typename WriteOut>
+bool ota_delta_copy(OtaDeltaState& st, uint32_t n, ReadSrc& read_src, WriteOut& write_out) {
+  uint8_t buf[OTA_DELTA_BLOCK];
+  while (n > 0) {
+    size_t take = n < OTA_DELTA_BLOCK ? n : OTA_DELTA_BLOCK;
+    if (!read_src(st.src_pos, buf, take)) return false;
+    if (!write_out(st.out_pos, buf, take)) return false;
+    st.src_pos += (uint32_t)take;
+    st.out_pos += (uint32_t)take;
+    n -= (uint32_t)take;
+  }
+  return true;
+}
+
+// Decode up to len patch bytes, writing at most out_budget image bytes.
+// consumed is how many patch bytes were used; when the budget runs out it is
+// less than len and the rest must be fed again later (a COPY that stopped
+// part way continues on the next call, even one with no patch bytes).
+template <typename ReadSrc, typename WriteOut>
+OtaDeltaResult ota_delta_feed(OtaDeltaState& st, const OtaDeltaLimits& lim,
+                              const uint8_t* data, size_t len, uint32_t out_budget,
+                              size_t& consumed, ReadSrc read_src, WriteOut write_out) {
+  consumed = 0;
+  if (st.phase == OTA_DELTA_FAILED) return OTA_DELTA_ERROR;
+  uint32_t out_end = lim.dst_size - st.out_pos < out_budget ? lim.dst_size
+                                                             : st.out_pos + out_budget;
+  size_t i = 0;
+  for (;;) {
+    uint32_t budget = out_end - st.out_pos;
+
+    // Source runs need no patch bytes
+    if (st.phase == OTA_DELTA_COPY_RUN || st.phase == OTA_DELTA_SKIP_RUN) {
+      uint32_t n = st.segment < budget ? st.segment : budget;
+      if (n == 0 && st.segment > 0) break;
+      if (!ota_delta_copy(st, n, read_src, write_out)) return ota_delta_fail(st);
+      st.segment -= n;
+      st.remaining -= n;
+      if (st.segment > 0) continue;
+      st.phase = (st.phase == OTA_DELTA_SKIP_RUN && st.remaining > 0) ? OTA_DELTA_ADD_COUNT
+                                                                       : OTA_DELTA_READ_OP;
+      continue;
+    }
+
+    if (i >= len) break;
+    if (st.phase == OTA_DELTA_FINISHED) return ota_delta_fail(st);   // Bytes after END
+
+    if (st.phase == OTA_DELTA_READ_OP) {
+      st.op = data[i++];
+      st.varint = 0;
+      st.varint_shift = 0;
+      if (st.op == OTA_DELTA_OP_END) {
+        if (st.out_pos != lim.dst_size) return ota_delta_fail(st);
+        st.phase = OTA_DELTA_FINISHED;
+      } else if (st.op == OTA_DELTA_OP_COPY || st.op == OTA_DELTA_OP_ADD) {
+        st.phase = OTA_DELTA_READ_SRC;
+      } else if (st.op == OTA_DELTA_OP_DATA) {
+        st.phase = OTA_DELTA_READ_LEN;
+      } else {
+        return ota_delta_fail(st);
+      }
+      continue;
+    }
+
+    if (st.phase == OTA_DELTA_DATA_BYTES || st.phase == OTA_DELTA_ADD_BYTES) {
+      size_t take = len - i;
+      if (st.segment < take) take = st.segment;
+      if (budget < take) take = budget;
+      if (take == 0) break;
+      if (st.phase == OTA_DELTA_DATA_BYTES) {
+        if (!write_out(st.out_pos, data + i, take)) return ota_delta_fail(st);
+        st.out_pos += (uint32_t)take;
+      } else {
+        // New bytes = source + delta, a block at a time
+        uint8_t buf[OTA_DELTA_BLOCK];
+        size_t done = 0;
+        while (done < take) {
+          size_t n = take - done < OTA_DELTA_BLOCK ? take - done : OTA_DELTA_BLOCK;
+          if (!read_src(st.src_pos, buf, n)) return ota_delta_fail(st);
+          for (size_t k = 0; k < n; k++) buf[k] = (uint8_t)(buf[k] + data[i + done + k]);
+          if (!write_out(st.out_pos, buf, n)) return ota_delta_fail(st);
+          st.src_pos += (uint32_t)n;
+          st.out_pos += (uint32_t)n;
+          done += n;
+        }
+      }
+      i += take;
+      st.segment -= (uint32_t)take;
+      st.remaining -= (uint32_t)take;
+      if (st.segment == 0) {
+        bool add_more = st.phase == OTA_DELTA_ADD_BYTES && st.remaining > 0;
+        st.phase = add_more ? OTA_DELTA_ADD_SKIP : OTA_DELTA_READ_OP;
+      }
+      continue;
+    }
+
+    // Varint phases
+    bool overflow = false;
+    if (!ota_delta_varint(st, data[i++], overflow)) {
+      if (overflow) return ota_delta_fail(st);
+      continue;
+    }
+    uint32_t v = st.varint;
+    st.varint = 0;
+    st.varint_shift = 0;
+
+    switch (st.phase) {
+      case OTA_DELTA_READ_SRC:
+        st.src_pos = v;
+        st.phase = OTA_DELTA_READ_LEN;
+        break;
+
+      case OTA_DELTA_READ_LEN:
+        if (v == 0 || v > lim.dst_size - st.out_pos) return ota_delta_fail(st);
+        st.remaining = v;
+        st.segment = v;
+        if (st.op == OTA_DELTA_OP_DATA) {
+          st.phase = OTA_DELTA_DATA_BYTES;
+          break;
+        }
+        if (st.src_pos > lim.src_size || v > lim.src_size - st.src_pos) return ota_delta_fail(st);
+        st.phase = st.op == OTA_DELTA_OP_COPY ? OTA_DELTA_COPY_RUN : OTA_DELTA_ADD_SKIP;
+        break;
+
+      case OTA_DELTA_ADD_SKIP:
+        if (v > st.remaining) return ota_delta_fail(st);
+        st.segment = v;
+        st.phase = OTA_DELTA_SKIP_RUN;
+        break;
+
+      case OTA_DELTA_ADD_COUNT:
+        if (v == 0 || v > st.remaining) return ota_delta_fail(st);
+        st.segment = v;
+        st.phase = OTA_DELTA_ADD_BYTES;
+        break;
+
+      default:
+        return ota_delta_fail(st);
+    }
+  }
+  consumed = i;
+  return st.phase == OTA_DELTA_FINISHED ? OTA_DELTA_DONE : OTA_DELTA_MORE;
+}
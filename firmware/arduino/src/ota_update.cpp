@@ -0,0 +1,578 @@
+// Delta OTA implementation
+// The image is written with raw partition writes rather than esp_ota_begin():
+// that erases the whole target partition up front and keeps its progress in
+// RAM, so it can neither be spread over wakes nor resumed. Sectors are erased
+// lazily just ahead of the decoder instead, and esp_ota_set_boot_partition()
+// validates the finished image before the switch. Flash encryption is not
+// supported (patches are built against the plaintext image).
+
+#include "ota_update.h"
+#include "feature_flags.h"
+
+#if FEATURE_OTA_DELTA
+#include "config.h"
+#include "mqtt_client.h"     // mqtt_wait_for_data
+#include "mqtt_dispatch.h"
+#include "topic_table.h"
+#include "system_manager.h"  // fast_crc32
+#include "wake_arena.h"
+#include "ota_delta.h"
+#include <ArduinoJson.h>
+#include <PubSubClient.h>
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <esp_task_wdt.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/version.h>
+
+static constexpr uint32_t OTA_PROGRESS_MAGIC = 0x4F544144;  // "OTAD"
+static constexpr uint32_t OTA_SECTOR_BYTES = 4096;
+static constexpr size_t OTA_PAGE_BYTES = 256;
+static constexpr uint32_t OTA_FEED_OUT_BYTES = 16384;       // Image bytes per decoder call
+static constexpr size_t OTA_HASH_BLOCK = 1024;
+
+enum OtaJobState : uint8_t {
+  OTA_IDLE = 0,
+  OTA_RECEIVING,
+  OTA_APPLIED,          // Boot partition switched to the new image
+  OTA_CURRENT,          // Running the job's target image
+  OTA_NOT_APPLICABLE,   // Running image is not the patch's source
+  OTA_FAILED            // Waits for a manifest with a new id
+};
+
+enum OtaError : uint8_t {
+  OTA_ERR_NONE = 0,
+  OTA_ERR_SIZE,         // Image does not fit the partition
+  OTA_ERR_PATCH,        // Malformed patch
+  OTA_ERR_FLASH,
+  OTA_ERR_HASH,         // Rebuilt image does not match the manifest
+  OTA_ERR_BOOT,         // esp_ota_set_boot_partition refused the image
+  OTA_ERR_ROLLBACK      // New image did not stay booted
+};
+
+struct OtaManifest {
+  uint32_t id;
+  uint32_t size;        // Patch bytes
+  uint32_t src_size;
+  uint32_t dst_size;
+  uint8_t src_sha[32];
+  uint8_t dst_sha[32];
+};
+
+struct OtaProgress {
+  uint32_t magic;
+  uint32_t job_id;
+  uint32_t patch_size;
+  uint32_t patch_pos;     // Patch bytes decoded
+  uint32_t src_size;
+  uint32_t dst_size;
+  uint32_t target_addr;   // Partition being written
+  uint32_t erased_to;     // Target bytes erased (sector multiple)
+  uint8_t dst_sha[32];
+  OtaDeltaState delta;
+  uint8_t state;          // OtaJobState
+  uint8_t error;          // OtaError
+  uint16_t reserved;
+  uint32_t crc;           // fast_crc32 of everything before it
+};
+
+static_assert(sizeof(OtaProgress) % 4 == 0, "OtaProgress must not leave tail padding");
+
+RTC_DATA_ATTR static OtaProgress rtc_ota;
+
+static bool g_loaded = false;
+static bool g_dirty = false;
+static bool g_pumping = false;      // Chunks are only decoded inside the pump
+static bool g_switched = false;     // Boot partition changed during this boot
+static uint32_t g_deadline_ms = 0;
+static uint32_t g_last_chunk_ms = 0;
+static uint32_t g_stale_chunks = 0;
+
+static OtaManifest g_manifest;
+static bool g_manifest_pending = false;
+static bool g_manifest_cleared = false;
+
+static const esp_partition_t* g_running = nullptr;
+static const esp_partition_t* g_target = nullptr;
+
+// Output page buffer: the decoder writes in small pieces, flash prefers pages
+static uint8_t g_page[OTA_PAGE_BYTES];
+static uint32_t g_page_addr = 0;
+static size_t g_page_fill = 0;
+
+static const char* state_name(uint8_t s) {
+  switch (s) {
+    case OTA_RECEIVING: return "receiving";
+    case OTA_APPLIED: return "applied";
+    case OTA_CURRENT: return "current";
+    case OTA_NOT_APPLICABLE: return "not_applicable";
+    case OTA_FAILED: return "failed";
+    default: return "idle";
+  }
+}
+
+static const char* error_name(uint8_t e) {
+  switch (e) {
+    case OTA_ERR_SIZE: return "size";
+    case OTA_ERR_PATCH: return "patch";
+    case OTA_ERR_FLASH: return "flash";
+    case OTA_ERR_HASH: return "hash";
+    case OTA_ERR_BOOT: return "boot";
+    case OTA_ERR_ROLLBACK: return "rollback";
+    default: return "";
+  }
+}
+
+// ---- Progress persistence (RTC, checkpointed to NVS) ----
+
+static uint32_t progress_crc(const OtaProgress& p) {
+  return fast_crc32((const uint8_t*)&p, offsetof(OtaProgress, crc));
+}
+
+static bool progress_valid(const OtaProgress& p) {
+  return p.magic == OTA_PROGRESS_MAGIC && p.crc == progress_crc(p);
+}
+
+static void progress_load() {
+  if (g_loaded) return;
+  g_loaded = true;
+  g_running = esp_ota_get_running_partition();
+  if (progress_valid(rtc_ota)) return;
+
+  // Cold boot (or a new image with another RTC layout): last checkpoint
+  Preferences prefs;
+  OtaProgress p;
+  bool ok = false;
+  if (prefs.begin("ota", true)) {
+    ok = prefs.getBytes("job", &p, sizeof(p)) == sizeof(p) && progress_valid(p);
+    prefs.end();
+  }
+  if (ok) {
+    rtc_ota = p;
+    Serial.printf("[OTA] Resuming job %lu from NVS at %lu/%lu\n", (unsigned long)p.job_id,
+                  (unsigned long)p.patch_pos, (unsigned long)p.patch_size);
+  } else {
+    memset(&rtc_ota, 0, sizeof(rtc_ota));
+    rtc_ota.magic = OTA_PROGRESS_MAGIC;
+    rtc_ota.crc = progress_crc(rtc_ota);
+  }
+}
+
+static void progress_commit() {
+  rtc_ota.crc = progress_crc(rtc_ota);
+  g_dirty = true;
+}
+
+// One NVS write per wake at most; decoding is deterministic, so bytes
+// rewritten after resuming from an older checkpoint are identical
+static void progress_checkpoint() {
+  if (!g_dirty) return;
+  g_dirty = false;
+  Preferences prefs;
+  if (!prefs.begin("ota", false)) return;
+  if (prefs.putBytes("job", &rtc_ota, sizeof(rtc_ota)) != sizeof(rtc_ota)) {
+    Serial.println("[OTA] WARN: NVS checkpoint failed");
+  }
+  prefs.end();
+}
+
+static void job_fail(OtaError err) {
+  rtc_ota.state = OTA_FAILED;
+  rtc_ota.error = err;
+  progress_commit();
+  Serial.printf("[OTA] Job %lu failed: %s\n", (unsigned long)rtc_ota.job_id, error_name(err));
+}
+
+// ---- Flash access ----
+
+static bool hash_partition(const esp_partition_t* part, uint32_t len, uint8_t out[32]) {
+  if (!part || len > part->size) return false;
+  uint8_t buf[OTA_HASH_BLOCK];
+  mbedtls_sha256_context ctx;
+  mbedtls_sha256_init(&ctx);
+  #if MBEDTLS_VERSION_NUMBER >= 0x03000000
+  mbedtls_sha256_starts(&ctx, 0);
+  #else
+  mbedtls_sha256_starts_ret(&ctx, 0);
+  #endif
+  bool ok = true;
+  for (uint32_t off = 0; off < len && ok; off += OTA_HASH_BLOCK) {
+    size_t n = len - off < OTA_HASH_BLOCK ? len - off : OTA_HASH_BLOCK;
+    ok = esp_partition_read(part, off, buf, n) == ESP_OK;
+    #if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    if (ok) mbedtls_sha256_update(&ctx, buf, n);
+    #else
+    if (ok) mbedtls_sha256_update_ret(&ctx, buf, n);
+    #endif
+    if ((off & 0xFFFF) == 0) esp_task_wdt_reset();
+  }
+  #if MBEDTLS_VERSION_NUMBER >= 0x03000000
+  mbedtls_sha256_finish(&ctx, out);
+  #else
+  mbedtls_sha256_finish_ret(&ctx, out);
+  #endif
+  mbedtls_sha256_free(&ctx);
+  return ok;
+}
+
+static bool hash_matches(const esp_partition_t* part, uint32_t len, const uint8_t expect[32]) {
+  uint8_t got[32];
+  return hash_partition(part, len, got) && memcmp(got, expect, sizeof(got)) == 0;
+}
+
+static bool read_src(uint32_t off, uint8_t* buf, size_t n) {
+  return esp_partition_read(g_running, off, buf, n) == ESP_OK;
+}
+
+static bool ensure_erased(uint32_t end) {
+  while (rtc_ota.erased_to < end) {
+    if (esp_partition_erase_range(g_target, rtc_ota.erased_to, OTA_SECTOR_BYTES) != ESP_OK) {
+      return false;
+    }
+    rtc_ota.erased_to += OTA_SECTOR_BYTES;
+  }
+  return true;
+}
+
+static bool flush_page() {
+  if (g_page_fill == 0) return true;
+  bool ok = ensure_erased(g_page_addr + g_page_fill) &&
+            esp_partition_write(g_target, g_page_addr, g_page, g_page_fill) == ESP_OK;
+  g_page_fill = 0;
+  return ok;
+}
+
+// Output arrives strictly in order; write it a flash page at a time
+static bool write_out(uint32_t off, const uint8_t* buf, size_t n) {
+  while (n > 0) {
+    if (g_page_fill == 0) g_page_addr = off;
+    size_t room = OTA_PAGE_BYTES - (g_page_addr % OTA_PAGE_BYTES) - g_page_fill;
+    size_t take = n < room ? n : room;
+    memcpy(g_page + g_page_fill, buf, take);
+    g_page_fill += take;
+    off += (uint32_t)take;
+    buf += take;
+    n -= take;
+    if (take == room && !flush_page()) return false;
+  }
+  return true;
+}
+
+// Decode patch bytes until they are used up or the wake's budget runs out;
+// returns how many were consumed
+static size_t feed(const uint8_t* data, size_t len) {
+  OtaDeltaLimits lim = { rtc_ota.src_size, rtc_ota.dst_size };
+  size_t total = 0;
+  do {
+    size_t used = 0;
+    OtaDeltaResult r = ota_delta_feed(rtc_ota.delta, lim, data + total, len - total,
+                                      OTA_FEED_OUT_BYTES, used, read_src, write_out);
+    bool flushed = flush_page();
+    total += used;
+    rtc_ota.patch_pos += (uint32_t)used;
+    if (r == OTA_DELTA_ERROR || !flushed) {
+      job_fail(flushed ? OTA_ERR_PATCH : OTA_ERR_FLASH);
+      return total;
+    }
+    if (r == OTA_DELTA_DONE) break;
+    esp_task_wdt_reset();
+  } while ((total < len || rtc_ota.delta.phase == OTA_DELTA_COPY_RUN ||
+            rtc_ota.delta.phase == OTA_DELTA_SKIP_RUN) &&
+           (int32_t)(g_deadline_ms - millis()) > 0);
+  progress_commit();
+  return total;
+}
+
+// ---- Job control ----
+
+static bool hex_to_sha(const char* hex, uint8_t out[32]) {
+  if (!hex || strlen(hex) != 64) return false;
+  for (int i = 0; i < 32; i++) {
+    uint8_t v = 0;
+    for (int k = 0; k < 2; k++) {
+      char c = hex[i * 2 + k];
+      v <<= 4;
+      if (c >= '0' && c <= '9') v |= c - '0';
+      else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+      else return false;
+    }
+    out[i] = v;
+  }
+  return true;
+}
+
+static const esp_partition_t* find_target() {
+  const esp_partition_t* p = esp_ota_get_next_update_partition(nullptr);
+  return (p && p != g_running) ? p : nullptr;
+}
+
+static void job_cancel() {
+  if (rtc_ota.state == OTA_APPLIED && g_switched && g_running) {
+    esp_ota_set_boot_partition(g_running);   // Not booted yet: switch back
+    g_switched = false;
+  }
+  if (rtc_ota.state != OTA_IDLE) Serial.println("[OTA] Manifest removed, job cancelled");
+  uint32_t magic = rtc_ota.magic;
+  memset(&rtc_ota, 0, sizeof(rtc_ota));
+  rtc_ota.magic = magic;
+  progress_commit();
+}
+
+// A new manifest id: work out whether this device can take the patch
+static void job_start(const OtaManifest& m) {
+  memset(&rtc_ota, 0, sizeof(rtc_ota));
+  rtc_ota.magic = OTA_PROGRESS_MAGIC;
+  rtc_ota.job_id = m.id;
+  rtc_ota.patch_size = m.size;
+  rtc_ota.src_size = m.src_size;
+  rtc_ota.dst_size = m.dst_size;
+  memcpy(rtc_ota.dst_sha, m.dst_sha, sizeof(rtc_ota.dst_sha));
+  ota_delta_init(rtc_ota.delta);
+
+  g_target = find_target();
+  if (g_running && hash_matches(g_running, m.dst_size, m.dst_sha)) {
+    rtc_ota.state = OTA_CURRENT;
+  } else if (!g_running || !g_target || m.src_size > g_running->size ||
+             m.dst_size > g_target->size) {
+    rtc_ota.state = OTA_FAILED;
+    rtc_ota.error = OTA_ERR_SIZE;
+  } else if (!hash_matches(g_running, m.src_size, m.src_sha)) {
+    rtc_ota.state = OTA_NOT_APPLICABLE;
+  } else {
+    rtc_ota.state = OTA_RECEIVING;
+    rtc_ota.target_addr = g_target->address;
+  }
+  progress_commit();
+  Serial.printf("[OTA] Job %lu: %s (%lu byte patch)\n", (unsigned long)m.id,
+                state_name(rtc_ota.state), (unsigned long)m.size);
+}
+
+// Rebuilt image complete: check it and switch the boot partition
+static void job_finish() {
+  if (!hash_matches(g_target, rtc_ota.dst_size, rtc_ota.dst_sha)) {
+    job_fail(OTA_ERR_HASH);
+    return;
+  }
+  esp_err_t err = esp_ota_set_boot_partition(g_target);
+  if (err != ESP_OK) {
+    Serial.printf("[OTA] Boot switch refused: %s\n", esp_err_to_name(err));
+    job_fail(OTA_ERR_BOOT);
+    return;
+  }
+  g_switched = true;
+  rtc_ota.state = OTA_APPLIED;
+  progress_commit();
+  Serial.printf("[OTA] Job %lu verified; new image boots on the next wake\n",
+                (unsigned long)rtc_ota.job_id);
+}
+
+// After a switch: either this is the new image, or it did not stay booted
+static void job_check_applied() {
+  if (rtc_ota.state != OTA_APPLIED || g_switched || !g_running) return;
+  if (g_running->address == rtc_ota.target_addr) {
+    rtc_ota.state = OTA_CURRENT;
+  } else {
+    rtc_ota.state = OTA_FAILED;
+    rtc_ota.error = OTA_ERR_ROLLBACK;
+  }
+  progress_commit();
+  Serial.printf("[OTA] Job %lu: %s\n", (unsigned long)rtc_ota.job_id, state_name(rtc_ota.state));
+}
+
+static void apply_manifest() {
+  if (g_manifest_cleared) {
+    g_manifest_cleared = false;
+    job_cancel();
+  }
+  if (!g_manifest_pending) return;
+  g_manifest_pending = false;
+  if (g_manifest.id == rtc_ota.job_id && rtc_ota.state != OTA_IDLE) return;   // Redelivery
+  job_start(g_manifest);
+}
+
+// ---- MQTT ----
+
+static uint32_t read_le32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Only stashed: hashing the running image can take a few hundred ms, so it
+// runs from the pump rather than inside the client's loop()
+static void on_ota_manifest(const MqttInbound& msg) {
+  if (msg.length == 0) {
+    g_manifest_cleared = true;
+    g_manifest_pending = false;
+    return;
+  }
+  JsonDocument doc(WakeArena::jsonAllocator());
+  DeserializationError error = deserializeJson(doc, msg.payload, msg.length);
+  if (error) {
+    Serial.printf("[OTA] Manifest parse failed: %s\n", error.c_str());
+    return;
+  }
+  OtaManifest m;
+  memset(&m, 0, sizeof(m));
+  m.id = doc["id"] | 0u;
+  m.size = doc["size"] | 0u;
+  m.src_size = doc["src_size"] | 0u;
+  m.dst_size = doc["dst_size"] | 0u;
+  if (m.id == 0 || m.size == 0 || m.src_size == 0 || m.dst_size == 0 ||
+      !hex_to_sha(doc["src"] | "", m.src_sha) || !hex_to_sha(doc["dst"] | "", m.dst_sha)) {
+    Serial.println("[OTA] Manifest ignored: missing or bad fields");
+    return;
+  }
+  g_manifest = m;
+  g_manifest_pending = true;
+}
+
+static void on_ota_data(const MqttInbound& msg) {
+  if (!g_pumping || rtc_ota.state != OTA_RECEIVING || msg.length <= 8) return;
+  uint32_t id = read_le32(msg.payload);
+  uint32_t off = read_le32(msg.payload + 4);
+  if (id != rtc_ota.job_id || off != rtc_ota.patch_pos) {
+    g_stale_chunks++;    // Repeat of a request, or after a chunk that was lost
+    return;
+  }
+  size_t len = msg.length - 8;
+  if (len > rtc_ota.patch_size - rtc_ota.patch_pos) len = rtc_ota.patch_size - rtc_ota.patch_pos;
+  feed(msg.payload + 8, len);
+  g_last_chunk_ms = millis();
+}
+
+static bool send_request(PubSubClient* client) {
+  uint32_t left = rtc_ota.patch_size - rtc_ota.patch_pos;
+  char payload[96];
+  snprintf(payload, sizeof(payload), "{\"id\":%lu,\"off\":%lu,\"len\":%lu,\"chunk\":%u}",
+           (unsigned long)rtc_ota.job_id, (unsigned long)rtc_ota.patch_pos,
+           (unsigned long)(left < OTA_REQUEST_BYTES ? left : OTA_REQUEST_BYTES),
+           (unsigned)OTA_CHUNK_BYTES);
+  return client->publish(topic_get(TOPIC_OTA_REQUEST), payload, false);
+}
+
+static void publish_status(PubSubClient* client) {
+  char payload[192];
+  int n = snprintf(payload, sizeof(payload),
+                   "{\"id\":%lu,\"state\":\"%s\",\"pos\":%lu,\"size\":%lu,\"out\":%lu,\"dst_size\":%lu",
+                   (unsigned long)rtc_ota.job_id, state_name(rtc_ota.state),
+                   (unsigned long)rtc_ota.patch_pos, (unsigned long)rtc_ota.patch_size,
+                   (unsigned long)rtc_ota.delta.out_pos, (unsigned long)rtc_ota.dst_size);
+  if (n > 0 && (size_t)n < sizeof(payload) && rtc_ota.error != OTA_ERR_NONE) {
+    n += snprintf(payload + n, sizeof(payload) - n, ",\"err\":\"%s\"", error_name(rtc_ota.error));
+  }
+  if (n > 0 && (size_t)n < sizeof(payload)) {
+    snprintf(payload + n, sizeof(payload) - n, "}");
+    client->publish(topic_get(TOPIC_OTA_STATUS), payload, true);
+  }
+}
+
+// ---- Public API ----
+
+void ota_update_register_routes() {
+  mqtt_dispatch_register(MQTT_NS_DEVICE, topic_suffix(TOPIC_OTA), on_ota_manifest);
+  mqtt_dispatch_register(MQTT_NS_DEVICE, topic_suffix(TOPIC_OTA_DATA), on_ota_data);
+}
+
+void ota_update_subscribe(PubSubClient* client) {
+  if (!client) return;
+  client->subscribe(topic_get(TOPIC_OTA));
+  client->subscribe(topic_get(TOPIC_OTA_DATA));
+}
+
+bool ota_update_in_progress() {
+  progress_load();
+  if (rtc_ota.state == OTA_RECEIVING) return true;
+  #if defined(CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE) || defined(CONFIG_APP_ROLLBACK_ENABLE)
+  esp_ota_img_states_t img;
+  if (g_running && esp_ota_get_state_partition(g_running, &img) == ESP_OK &&
+      img == ESP_OTA_IMG_PENDING_VERIFY) {
+    return true;
+  }
+  #endif
+  return false;
+}
+
+void ota_update_confirm_boot() {
+  #if defined(CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE) || defined(CONFIG_APP_ROLLBACK_ENABLE)
+  progress_load();
+  esp_ota_img_states_t img;
+  if (g_running && esp_ota_get_state_partition(g_running, &img) == ESP_OK &&
+      img == ESP_OTA_IMG_PENDING_VERIFY) {
+    esp_ota_mark_app_valid_cancel_rollback();
+    Serial.println("[OTA] New image confirmed");
+  }
+  #endif
+}
+
+bool ota_update_pump(PubSubClient* client, uint32_t budget_ms) {
+  if (!client || !client->connected()) return false;
+  progress_load();
+  uint8_t state_before = rtc_ota.state;
+  uint32_t pos_before = rtc_ota.patch_pos;
+
+  apply_manifest();
+  job_check_applied();
+
+  if (rtc_ota.state == OTA_RECEIVING) {
+    if (!g_target) g_target = find_target();
+    if (!g_target || g_target->address != rtc_ota.target_addr) {
+      job_fail(OTA_ERR_SIZE);     // Partition table changed under the job
+    }
+  }
+
+  if (rtc_ota.state == OTA_RECEIVING) {
+    uint32_t start = millis();
+    g_deadline_ms = start + budget_ms;
+    g_pumping = true;
+    g_stale_chunks = 0;
+    uint32_t asked_to = rtc_ota.patch_pos;     // Patch offset requested up to
+    uint32_t asked_ms = 0;
+    while (rtc_ota.state == OTA_RECEIVING && rtc_ota.delta.phase != OTA_DELTA_FINISHED &&
+           (int32_t)(g_deadline_ms - millis()) > 0 && client->connected()) {
+      // Source runs left over from the last chunk need no patch bytes
+      if (rtc_ota.delta.phase == OTA_DELTA_COPY_RUN || rtc_ota.delta.phase == OTA_DELTA_SKIP_RUN) {
+        feed(nullptr, 0);
+        continue;
+      }
+      if (rtc_ota.patch_pos >= rtc_ota.patch_size) {
+        job_fail(OTA_ERR_PATCH);  // Patch ended without END
+        break;
+      }
+      uint32_t now = millis();
+      uint32_t idle_since = g_last_chunk_ms > asked_ms ? g_last_chunk_ms : asked_ms;
+      if (asked_to <= rtc_ota.patch_pos || now - idle_since > OTA_CHUNK_TIMEOUT_MS) {
+        if (!send_request(client)) break;
+        asked_to = rtc_ota.patch_pos + OTA_REQUEST_BYTES;
+        asked_ms = now;
+      }
+      uint32_t left = g_deadline_ms - millis();
+      if (mqtt_wait_for_data(left < 50 ? left : 50)) client->loop();
+    }
+    g_pumping = false;
+    if (rtc_ota.state == OTA_RECEIVING && rtc_ota.delta.phase == OTA_DELTA_FINISHED) {
+      job_finish();
+    }
+    Serial.printf("[OTA] Job %lu: %lu/%lu patch bytes, %lu/%lu image bytes (%lu ms, %lu stale)\n",
+                  (unsigned long)rtc_ota.job_id, (unsigned long)rtc_ota.patch_pos,
+                  (unsigned long)rtc_ota.patch_size, (unsigned long)rtc_ota.delta.out_pos,
+                  (unsigned long)rtc_ota.dst_size, (unsigned long)(millis() - start),
+                  (unsigned long)g_stale_chunks);
+  }
+
+  progress_checkpoint();
+  if (rtc_ota.state != state_before || rtc_ota.patch_pos != pos_before) {
+    publish_status(client);
+  }
+  return rtc_ota.state == OTA_RECEIVING;
+}
+
+// Arduino marks a new image valid at startup unless this says it will do so
+// itself; with rollback on, confirmation waits for the first publish
+#if defined(CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE) || defined(CONFIG_APP_ROLLBACK_ENABLE)
+extern "C" bool verifyRollbackLater() {
+  return true;
+}
+#endif
+
+#endif
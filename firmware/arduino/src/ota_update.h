@@ -0,0 +1,49 @@
+#pragma once
+// Delta firmware updates over MQTT (FEATURE_OTA_DELTA)
+// A retained manifest offers a patch (ota_delta.h) from one image to another.
+// A device running the patch's source image asks for the patch a few KB at a
+// time and decodes it straight into the inactive OTA partition, for as long
+// as OTA_WAKE_BUDGET_MS allows each wake. Where it got to (patch offset,
+// decoder state, erased sectors) is kept in RTC memory and checkpointed to
+// NVS, so an update continues across any number of wakes and survives a
+// power loss. Once the rebuilt image hashes to the manifest's SHA-256 the
+// boot partition is switched; the next wake boots it.
+//
+// Topics (espsensor/<id>/...):
+//   ota         retained {"id":1234,"size":41210,"src_size":1048576,"src":"<sha256>",
+//                         "dst_size":1049600,"dst":"<sha256>"}; empty cancels
+//   ota/req     {"id":1234,"off":8192,"len":6144,"chunk":768} from the device
+//   ota/data    u32 id, u32 offset (little-endian) then the patch bytes
+//   ota/status  retained {"id":1234,"state":"receiving","pos":8192,"size":41210,...}
+// scripts/ota_delta.py builds the patch and manifest and answers requests.
+//
+// With bootloader rollback enabled the new image stays on probation until
+// ota_update_confirm_boot() after its first successful publish; an image that
+// crashes or never reaches the broker is rolled back on the next reset.
+//
+// Usage:
+//   ota_update_register_routes();                  // From register_builtin_routes()
+//   ota_update_subscribe(client);                  // Every connect
+//   if (ota_update_in_progress()) ...              // Do not skip the network
+//   ota_update_confirm_boot();                     // After the first publish
+//   ota_update_pump(client, OTA_WAKE_BUDGET_MS);   // Deferred publish phase
+
+#include <stdint.h>
+
+class PubSubClient;
+
+// Manifest and data routes on the device namespace
+void ota_update_register_routes();
+
+// Retained manifest and data topics (retained messages need a subscribe)
+void ota_update_subscribe(PubSubClient* client);
+
+// A patch is being received, or a new image is waiting to be confirmed
+bool ota_update_in_progress();
+
+// Accept the running image if it is on rollback probation
+void ota_update_confirm_boot();
+
+// Act on the manifest and receive patch bytes until budget_ms has passed;
+// returns true while the update needs more wakes
+bool ota_update_pump(PubSubClient* client, uint32_t budget_ms);
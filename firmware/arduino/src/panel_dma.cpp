@@ -0,0 +1,103 @@
+// DMA transport for e-ink frame writes
+#include "panel_dma.h"
+
+#if USE_DISPLAY && DISPLAY_SPI_DMA
+
+#include <driver/spi_master.h>
+#include <esp_timer.h>
+
+#ifndef DISPLAY_SPI_DMA_HOST
+#define DISPLAY_SPI_DMA_HOST SPI2_HOST   // The controller Arduino's SPI uses
+#endif
+
+static PanelDmaStats g_stats = {};
+
+static constexpr size_t MAX_CHUNKS = 2;   // A full 128x250 frame is one chunk
+static constexpr uint32_t CHUNK_TIMEOUT_MS = 100;
+
+// Drop the DMA driver and give the pins back to Arduino's SPI
+static void release(SPIClass& spi, spi_device_handle_t dev) {
+    if (dev) spi_bus_remove_device(dev);
+    spi_bus_free(DISPLAY_SPI_DMA_HOST);
+    spi.begin();
+}
+
+bool panel_dma_write(SPIClass& spi, int16_t cs, int16_t dc, const uint8_t* data, size_t len) {
+    size_t chunks = panel_dma_chunk_count(len, PANEL_DMA_MAX_CHUNK);
+    if (chunks == 0 || chunks > MAX_CHUNKS) {
+        g_stats.fallbacks++;
+        return false;
+    }
+    uint32_t start = (uint32_t)esp_timer_get_time();
+
+    spi.end();
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = MOSI;
+    bus.miso_io_num = -1;
+    bus.sclk_io_num = SCK;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = (int)PANEL_DMA_MAX_CHUNK;
+    if (spi_bus_initialize(DISPLAY_SPI_DMA_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK) {
+        spi.begin();
+        g_stats.fallbacks++;
+        return false;
+    }
+
+    // CS stays a GPIO GxEPD2 drives, held low across the chunks
+    spi_device_interface_config_t cfg = {};
+    cfg.mode = 0;
+    cfg.clock_speed_hz = DISPLAY_SPI_DMA_HZ;
+    cfg.spics_io_num = -1;
+    cfg.queue_size = (int)MAX_CHUNKS;
+    spi_device_handle_t dev = nullptr;
+    if (spi_bus_add_device(DISPLAY_SPI_DMA_HOST, &cfg, &dev) != ESP_OK) {
+        release(spi, nullptr);
+        g_stats.fallbacks++;
+        return false;
+    }
+
+    spi_transaction_t trans[MAX_CHUNKS] = {};
+    digitalWrite(dc, HIGH);
+    digitalWrite(cs, LOW);
+    size_t queued = 0;
+    bool ok = true;
+    for (size_t off = 0; off < len && ok; off += PANEL_DMA_MAX_CHUNK) {
+        size_t n = len - off < PANEL_DMA_MAX_CHUNK ? len - off : PANEL_DMA_MAX_CHUNK;
+        trans[queued].length = n * 8;
+        trans[queued].tx_buffer = data + off;
+        ok = spi_device_queue_trans(dev, &trans[queued], pdMS_TO_TICKS(CHUNK_TIMEOUT_MS)) == ESP_OK;
+        if (ok) queued++;
+    }
+    // Blocks this task until the DMA engine is done with each chunk
+    for (size_t i = 0; i < queued; i++) {
+        spi_transaction_t* done = nullptr;
+        if (spi_device_get_trans_result(dev, &done, pdMS_TO_TICKS(CHUNK_TIMEOUT_MS)) != ESP_OK)
+            ok = false;
+    }
+    digitalWrite(cs, HIGH);
+    release(spi, dev);
+
+    if (!ok) {
+        g_stats.fallbacks++;
+        return false;
+    }
+    g_stats.bursts++;
+    g_stats.bytes += (uint32_t)len;
+    g_stats.last_us = (uint32_t)esp_timer_get_time() - start;
+    return true;
+}
+
+#else
+
+bool panel_dma_write(SPIClass&, int16_t, int16_t, const uint8_t*, size_t) {
+    return false;
+}
+
+static PanelDmaStats g_stats = {};
+
+#endif
+
+const PanelDmaStats& panel_dma_stats() {
+    return g_stats;
+}
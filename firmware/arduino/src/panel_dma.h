@@ -0,0 +1,120 @@
+#pragma once
+
+// DMA transport for e-ink frame writes (DISPLAY_SPI_DMA)
+// PanelDma<Panel> wraps a GxEPD2 SSD1680 driver class. Writes covering
+// whole controller rows (the canvas blit's full frame, GxEPD2_BW pages) go
+// out as one SPI DMA burst; everything else, and the commands, still go
+// through GxEPD2. During a burst the writing task blocks on the driver, so
+// the CPU runs other tasks or idles until the frame is out.
+//
+// The bus is Arduino's SPI for the rest of the time: panel_dma_write()
+// ends it, runs the transfer through spi_master on the same host and pins,
+// then begins it again, so GxEPD2 never sees a changed bus.
+//
+// Usage:
+//   PanelDisplay display(PanelDriver(EINK_CS, EINK_DC, EINK_RST, EINK_BUSY));  // main.cpp
+//   extern PanelDisplay display;                                               // users
+//   display.epd2.writeImage(g_panel_native, 0, 0, PANEL_NATIVE_WIDTH, PANEL_NATIVE_HEIGHT);
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "config.h"
+#include "panel_dma_core.h"
+
+struct PanelDmaStats {
+    uint32_t bursts;      // RAM writes sent by DMA
+    uint32_t fallbacks;   // Eligible writes that went byte by byte (driver error)
+    uint32_t bytes;
+    uint32_t last_us;     // Duration of the last burst, bus hand-over included
+};
+
+// Send len bytes as data (DC high, CS low for the whole burst) on the bus
+// spi normally drives. false if the DMA driver failed; part of the data
+// may have gone out, so the caller restarts the RAM write. spi is usable
+// again either way.
+bool panel_dma_write(SPIClass& spi, int16_t cs, int16_t dc, const uint8_t* data, size_t len);
+
+const PanelDmaStats& panel_dma_stats();
+
+template <typename Panel>
+class PanelDma : public Panel {
+public:
+    using Panel::Panel;
+    using Panel::writeImage;
+    using Panel::writeImageAgain;
+
+    void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h,
+                    bool invert = false, bool mirror_y = false, bool pgm = false) {
+        static const uint8_t kCurrent[] = {SSD1680_WRITE_RAM_BW};
+        if (!writeRows(kCurrent, 1, bitmap, x, y, w, h, invert, mirror_y, pgm))
+            Panel::writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+
+    // Previous frame then current, as GxEPD2 does after a refresh
+    void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h,
+                         bool invert = false, bool mirror_y = false, bool pgm = false) {
+        static const uint8_t kBoth[] = {SSD1680_WRITE_RAM_PREV, SSD1680_WRITE_RAM_BW};
+        if (!writeRows(kBoth, 2, bitmap, x, y, w, h, invert, mirror_y, pgm))
+            Panel::writeImageAgain(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+
+private:
+    void startRamWrite(const PanelCtrlByte* area, size_t n, uint8_t command) {
+        for (size_t i = 0; i < n; i++) {
+            if (area[i].command) this->_writeCommand(area[i].value);
+            else this->_writeData(area[i].value);
+        }
+        this->_writeCommand(command);
+    }
+
+    bool writeRows(const uint8_t* commands, size_t command_count, const uint8_t bitmap[],
+                   int16_t x, int16_t y, int16_t w, int16_t h,
+                   bool invert, bool mirror_y, bool pgm) {
+#if DISPLAY_SPI_DMA
+        if (!bitmap || !panel_dma_eligible(x, y, w, h, Panel::WIDTH, Panel::HEIGHT,
+                                           invert, mirror_y, pgm))
+            return false;
+        // One byte through GxEPD2 first: it does the driver's lazy setup
+        // (initial RAM clear, partial-mode init) that it keeps private
+        Panel::writeImage(bitmap, 0, y, 8, 1, false, false, false);
+
+        const size_t len = (size_t)h * (Panel::WIDTH / 8);
+        PanelCtrlByte area[PANEL_RAM_AREA_LEN];
+        size_t n = ssd1680_ram_area(0, (uint16_t)y, Panel::WIDTH, (uint16_t)h, area);
+        for (size_t c = 0; c < command_count; c++) {
+            startRamWrite(area, n, commands[c]);
+            if (!panel_dma_write(*this->_pSPIx, this->_cs, this->_dc, bitmap, len)) {
+                // Same RAM write again from the window start, byte by byte
+                startRamWrite(area, n, commands[c]);
+                this->_startTransfer();
+                for (size_t i = 0; i < len; i++) this->_transfer(bitmap[i]);
+                this->_endTransfer();
+            }
+        }
+        return true;
+#else
+        (void)commands; (void)command_count; (void)bitmap; (void)x; (void)y; (void)w; (void)h;
+        (void)invert; (void)mirror_y; (void)pgm;
+        return false;
+#endif
+    }
+};
+
+#if USE_DISPLAY
+#include <GxEPD2_BW.h>
+
+// 2.13" b/w class; choose the one matching your panel
+// B74 works for SSD1680/UC8151 variants used by many 2.13" panels
+// Alternative: DEPG0213BN (also SSD1680 family). Select via
+// -DEINK_PANEL_DEPG0213BN=1
+#ifndef EINK_PANEL_DEPG0213BN
+#define EINK_PANEL_DEPG0213BN 0
+#endif
+#if EINK_PANEL_DEPG0213BN
+using PanelDriver = PanelDma<GxEPD2_213_DEPG0213BN>;
+#else
+// Prefer the explicit GDEY0213B74 class name for clarity on SSD1680 FeatherWing
+using PanelDriver = PanelDma<GxEPD2_213_GDEY0213B74>;
+#endif
+using PanelDisplay = GxEPD2_BW<PanelDriver, PanelDriver::HEIGHT>;
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+// Planning for DMA writes of e-ink controller RAM (panel_dma.h)
+// GxEPD2 clocks image data into the SSD1680 one SPI.transfer() per byte. A
+// write qualifies for one DMA burst when it covers whole controller rows
+// (x = 0, full width) of a plain RAM buffer: its bytes are then contiguous
+// and in the controller's order. Narrower windows, PROGMEM sources and
+// inverted or mirrored writes keep GxEPD2's byte loop, as do writes too
+// small to repay handing the bus to the DMA driver and back.
+//
+// Usage:
+//   if (panel_dma_eligible(x, y, w, h, WIDTH, HEIGHT, invert, mirror_y, pgm)) {
+//     PanelCtrlByte seq[PANEL_RAM_AREA_LEN];
+//     size_t n = ssd1680_ram_area(0, y, WIDTH, h, seq);   // then the RAM command
+//     size_t chunks = panel_dma_chunk_count((size_t)h * WIDTH / 8, PANEL_DMA_MAX_CHUNK);
+//   }
+
+#include <cstddef>
+#include <cstdint>
+
+// spi_master transfer size limit: one DMA descriptor list per transaction,
+// kept a multiple of 4 so every chunk starts word-aligned
+static constexpr size_t PANEL_DMA_MAX_CHUNK = 4092;
+
+// Below this the bus hand-over (~100 us) costs more than the byte loop saves
+static constexpr size_t PANEL_DMA_MIN_BYTES = 256;
+
+// SSD1680 RAM commands
+static constexpr uint8_t SSD1680_DATA_ENTRY = 0x11;
+static constexpr uint8_t SSD1680_RAM_X_RANGE = 0x44;
+static constexpr uint8_t SSD1680_RAM_Y_RANGE = 0x45;
+static constexpr uint8_t SSD1680_RAM_X_COUNTER = 0x4E;
+static constexpr uint8_t SSD1680_RAM_Y_COUNTER = 0x4F;
+static constexpr uint8_t SSD1680_WRITE_RAM_BW = 0x24;     // Current frame
+static constexpr uint8_t SSD1680_WRITE_RAM_PREV = 0x26;   // Previous frame (partial diff)
+
+struct PanelCtrlByte {
+  bool command;   // false = data
+  uint8_t value;
+};
+
+static constexpr size_t PANEL_RAM_AREA_LEN = 15;
+
+inline bool panel_dma_eligible(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t panel_w, uint16_t panel_h,
+                               bool invert, bool mirror_y, bool pgm,
+                               size_t min_bytes = PANEL_DMA_MIN_BYTES) {
+  if (invert || mirror_y || pgm) return false;
+  if (x != 0 || w != (int16_t)panel_w || (panel_w % 8) != 0) return false;
+  if (y < 0 || h <= 0 || (int32_t)y + h > panel_h) return false;
+  return (size_t)h * (panel_w / 8) >= min_bytes;
+}
+
+inline size_t panel_dma_chunk_count(size_t len, size_t max_chunk) {
+  if (len == 0 || max_chunk == 0) return 0;
+  return (len + max_chunk - 1) / max_chunk;
+}
+
+// Address window and counters for a byte-aligned window, x and y
+// incrementing; the same sequence GxEPD2's SSD1680 drivers send before a
+// RAM write. Returns the number of entries written (PANEL_RAM_AREA_LEN).
+inline size_t ssd1680_ram_area(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                               PanelCtrlByte out[PANEL_RAM_AREA_LEN]) {
+  const uint16_t y_end = (uint16_t)(y + h - 1);
+  const PanelCtrlByte seq[PANEL_RAM_AREA_LEN] = {
+    {true, SSD1680_DATA_ENTRY}, {false, 0x03},
+    {true, SSD1680_RAM_X_RANGE}, {false, (uint8_t)(x / 8)}, {false, (uint8_t)((x + w - 1) / 8)},
+    {true, SSD1680_RAM_Y_RANGE}, {false, (uint8_t)(y % 256)}, {false, (uint8_t)(y / 256)},
+    {false, (uint8_t)(y_end % 256)}, {false, (uint8_t)(y_end / 256)},
+    {true, SSD1680_RAM_X_COUNTER}, {false, (uint8_t)(x / 8)},
+    {true, SSD1680_RAM_Y_COUNTER}, {false, (uint8_t)(y % 256)}, {false, (uint8_t)(y / 256)},
+  };
+  for (size_t i = 0; i < PANEL_RAM_AREA_LEN; i++) out[i] = seq[i];
+  return PANEL_RAM_AREA_LEN;
+}
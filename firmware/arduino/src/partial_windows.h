@@ -0,0 +1,99 @@
+#pragma once
+
+// Partial-window planning for e-ink updates
+// The panel's update time is dominated by the number of waveforms, not by
+// their area, so dirty rects are merged into as few byte-aligned windows as
+// possible before any partial refresh is issued.
+//
+// Usage:
+//   PanelWindow wins[16];
+//   size_t n = 0;
+//   for (each dirty rect r) wins[n++] = panel_window_aligned(r[0], r[1], r[2], r[3]);
+//   n = panel_windows_coalesce(wins, n, 2);
+//   for (size_t i = 0; i < n; i++) refresh(wins[i]);
+
+#include <cstddef>
+#include <cstdint>
+
+struct PanelWindow {
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+};
+
+// Widen a rect to 8-pixel byte boundaries on X (SSD1680-class controllers
+// reject or mis-draw unaligned windows)
+inline PanelWindow panel_window_aligned(int16_t x, int16_t y, int16_t w, int16_t h) {
+  int16_t ax = x & ~0x07;
+  int16_t aw = static_cast<int16_t>(((x + w - ax) + 7) & ~0x07);
+  return PanelWindow{ax, y, aw, h};
+}
+
+inline int32_t panel_window_area(const PanelWindow& a) {
+  return (int32_t)a.w * a.h;
+}
+
+// Overlapping or sharing an edge
+inline bool panel_windows_touch(const PanelWindow& a, const PanelWindow& b) {
+  return a.x <= b.x + b.w && b.x <= a.x + a.w &&
+         a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+inline PanelWindow panel_window_union(const PanelWindow& a, const PanelWindow& b) {
+  int16_t x0 = a.x < b.x ? a.x : b.x;
+  int16_t y0 = a.y < b.y ? a.y : b.y;
+  int16_t x1 = (a.x + a.w) > (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+  int16_t y1 = (a.y + a.h) > (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+  return PanelWindow{x0, y0, static_cast<int16_t>(x1 - x0), static_cast<int16_t>(y1 - y0)};
+}
+
+// Replace wins[i] with the union of wins[i] and wins[j], dropping wins[j]
+inline size_t panel_windows_merge_at(PanelWindow* wins, size_t n, size_t i, size_t j) {
+  wins[i] = panel_window_union(wins[i], wins[j]);
+  wins[j] = wins[n - 1];
+  return n - 1;
+}
+
+// Merge every pair that overlaps or is adjacent until none are left; the
+// union covers no pixels the pair did not border, and saves a waveform
+inline size_t panel_windows_merge_touching(PanelWindow* wins, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = i + 1; j < n; j++) {
+      if (panel_windows_touch(wins[i], wins[j])) {
+        n = panel_windows_merge_at(wins, n, i, j);
+        i = (size_t)-1;  // Restart: the union may now touch earlier windows
+        break;
+      }
+    }
+  }
+  return n;
+}
+
+// Merge windows in place and return the new count: first every touching
+// pair, then the pair whose union adds the least area until at most
+// max_windows remain. Unions of byte-aligned windows stay byte-aligned.
+inline size_t panel_windows_coalesce(PanelWindow* wins, size_t n, size_t max_windows) {
+  if (!wins) return 0;
+  if (max_windows == 0) max_windows = 1;
+
+  n = panel_windows_merge_touching(wins, n);
+  while (n > max_windows) {
+    size_t best_i = 0, best_j = 1;
+    int32_t best_cost = INT32_MAX;
+    for (size_t i = 0; i < n; i++) {
+      for (size_t j = i + 1; j < n; j++) {
+        int32_t cost = panel_window_area(panel_window_union(wins[i], wins[j])) -
+                       panel_window_area(wins[i]) - panel_window_area(wins[j]);
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+    n = panel_windows_merge_at(wins, n, best_i, best_j);
+    n = panel_windows_merge_touching(wins, n);
+  }
+  return n;
+}
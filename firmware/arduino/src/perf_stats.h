@@ -0,0 +1,296 @@
+#pragma once
+
+// Timing statistics for PROFILE_SCOPE
+// Each stat keeps count/total/min/max plus a log-linear histogram: every
+// power of two is split into PERF_HIST_SUB linear buckets, so percentiles are
+// within ~12% anywhere from 1 us to PERF_HIST_MAX_US. Averages hide the one
+// slow wake an hour; p95/p99 do not.
+//
+// Stats live in a fixed open-addressed table keyed by a hash of the scope
+// name. Slots are claimed with a compare-and-swap on the name pointer and
+// updates are atomic adds, so recording never takes a lock. Call sites look
+// their slot up once and cache the pointer (see PROFILE_SCOPE).
+//
+// Usage:
+//   static PerfRegistry<32> registry;
+//   PerfStats* s = registry.get("wifi_connect");   // Once per call site
+//   s->record(elapsed_us);
+//   uint32_t p95 = s->percentile(95);
+//
+// PerfRtcTable is the compacted form kept in RTC memory across deep sleep:
+// one bucket per power of two, 64-bit totals and a truncated name copy (the
+// registry's name pointers would not survive an OTA update). Each wake's
+// stats are merged into it before sleeping.
+//   RTC_DATA_ATTR static PerfRtcTable<12> history;   // Zero = empty
+//   perf_rtc_merge(history, *stats);
+//   perf_rtc_percentile(history.stats[i], 95);
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static constexpr uint32_t PERF_HIST_SUB_BITS = 2;
+static constexpr uint32_t PERF_HIST_SUB = 1u << PERF_HIST_SUB_BITS;
+static constexpr uint32_t PERF_HIST_MAX_BIT = 24;                    // 2^24 us = 16.7 s
+static constexpr uint32_t PERF_HIST_MAX_US = (1u << PERF_HIST_MAX_BIT) - 1;
+static constexpr size_t PERF_HIST_BUCKETS =
+    (PERF_HIST_MAX_BIT - PERF_HIST_SUB_BITS + 1) * PERF_HIST_SUB;  // Slower samples clamp into the last
+
+// Bucket for a duration: values below PERF_HIST_SUB map 1:1, larger ones by
+// exponent and the next PERF_HIST_SUB_BITS bits
+inline size_t perf_hist_bucket(uint32_t us) {
+    if (us > PERF_HIST_MAX_US) us = PERF_HIST_MAX_US;
+    if (us < PERF_HIST_SUB) return us;
+    uint32_t msb = 31u - (uint32_t)__builtin_clz(us);
+    uint32_t sub = (us >> (msb - PERF_HIST_SUB_BITS)) & (PERF_HIST_SUB - 1);
+    return (size_t)((msb - PERF_HIST_SUB_BITS + 1) * PERF_HIST_SUB + sub);
+}
+
+// Smallest duration that lands in bucket b
+inline uint32_t perf_hist_lower(size_t b) {
+    if (b < PERF_HIST_SUB) return (uint32_t)b;
+    uint32_t msb = (uint32_t)(b / PERF_HIST_SUB) + PERF_HIST_SUB_BITS - 1;
+    uint32_t sub = (uint32_t)(b % PERF_HIST_SUB);
+    return (1u << msb) | (sub << (msb - PERF_HIST_SUB_BITS));
+}
+
+// Width of bucket b in microseconds
+inline uint32_t perf_hist_width(size_t b) {
+    if (b < PERF_HIST_SUB) return 1;
+    uint32_t msb = (uint32_t)(b / PERF_HIST_SUB) + PERF_HIST_SUB_BITS - 1;
+    return 1u << (msb - PERF_HIST_SUB_BITS);
+}
+
+struct PerfStats {
+    const char* name;       // nullptr = free slot
+    uint32_t count;
+    uint32_t total_us;
+    uint32_t min_us;        // UINT32_MAX until the first sample
+    uint32_t max_us;
+    uint32_t last_us;
+    uint16_t hist[PERF_HIST_BUCKETS];   // Saturating
+
+    void record(uint32_t elapsed_us) {
+        __atomic_fetch_add(&count, 1u, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&total_us, elapsed_us, __ATOMIC_RELAXED);
+        __atomic_store_n(&last_us, elapsed_us, __ATOMIC_RELAXED);
+
+        uint32_t seen = __atomic_load_n(&min_us, __ATOMIC_RELAXED);
+        while (elapsed_us < seen &&
+               !__atomic_compare_exchange_n(&min_us, &seen, elapsed_us, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+        seen = __atomic_load_n(&max_us, __ATOMIC_RELAXED);
+        while (elapsed_us > seen &&
+               !__atomic_compare_exchange_n(&max_us, &seen, elapsed_us, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+
+        uint16_t& bucket = hist[perf_hist_bucket(elapsed_us)];
+        if (__atomic_load_n(&bucket, __ATOMIC_RELAXED) != UINT16_MAX) {
+            __atomic_fetch_add(&bucket, (uint16_t)1, __ATOMIC_RELAXED);
+        }
+    }
+
+    uint32_t getAverage() const {
+        return count > 0 ? total_us / count : 0;
+    }
+
+    // Duration at or below which p percent of samples fall (bucket midpoint,
+    // clamped to the observed min/max; p100 is the max); 0 with no samples
+    uint32_t percentile(uint8_t p) const {
+        uint32_t samples = 0;
+        for (size_t b = 0; b < PERF_HIST_BUCKETS; b++) samples += hist[b];
+        if (samples == 0) return 0;
+        if (p >= 100) return max_us;
+        uint32_t rank = (uint32_t)(((uint64_t)samples * p + 99) / 100);
+        if (rank == 0) rank = 1;
+
+        uint32_t seen = 0;
+        for (size_t b = 0; b < PERF_HIST_BUCKETS; b++) {
+            seen += hist[b];
+            if (seen < rank) continue;
+            uint32_t v = perf_hist_lower(b) + perf_hist_width(b) / 2;
+            if (v < min_us) v = min_us;
+            if (v > max_us) v = max_us;
+            return v;
+        }
+        return max_us;
+    }
+
+    // Clear counters, keeping the name (call sites hold on to the slot)
+    void reset() {
+        count = 0;
+        total_us = 0;
+        min_us = UINT32_MAX;
+        max_us = 0;
+        last_us = 0;
+        memset(hist, 0, sizeof(hist));
+    }
+};
+
+// FNV-1a over the scope name
+inline uint32_t perf_name_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const char* p = name; *p; p++) {
+        h ^= (uint8_t)*p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+template <size_t N>
+class PerfRegistry {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Registry size must be a power of two");
+
+public:
+    PerfRegistry() { clear(); }
+
+    // Stats for name, claiming a slot on first use; nullptr when full.
+    // The name pointer is stored, so it must have static lifetime.
+    PerfStats* get(const char* name) {
+        if (!name) return nullptr;
+        size_t start = perf_name_hash(name) & (N - 1);
+        for (size_t probe = 0; probe < N; probe++) {
+            PerfStats& s = stats_[(start + probe) & (N - 1)];
+            const char* owner = __atomic_load_n(&s.name, __ATOMIC_ACQUIRE);
+            if (!owner) {
+                if (__atomic_compare_exchange_n(&s.name, &owner, name, false,
+                                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                    __atomic_fetch_add(&count_, 1u, __ATOMIC_RELAXED);
+                    return &s;
+                }
+                // Lost the race: owner now holds the winner's name
+            }
+            if (owner == name || strcmp(owner, name) == 0) return &s;
+        }
+        return nullptr;
+    }
+
+    // Zero every stat; slots stay claimed
+    void reset() {
+        for (size_t i = 0; i < N; i++) {
+            if (stats_[i].name) stats_[i].reset();
+        }
+    }
+
+    // Drop all slots; only safe before any call site has cached a pointer
+    void clear() {
+        for (size_t i = 0; i < N; i++) {
+            stats_[i].name = nullptr;
+            stats_[i].reset();
+        }
+        count_ = 0;
+    }
+
+    size_t size() const { return __atomic_load_n(&count_, __ATOMIC_RELAXED); }
+    static constexpr size_t capacity() { return N; }
+
+    // Claimed slots in table order (i < capacity()); nullptr for free ones
+    const PerfStats* slot(size_t i) const {
+        return (i < N && stats_[i].name) ? &stats_[i] : nullptr;
+    }
+
+private:
+    PerfStats stats_[N];
+    uint32_t count_;
+};
+
+// Cross-wake aggregate (RTC memory)
+static constexpr uint32_t PERF_RTC_MAGIC = 0x50524631;  // "PRF1" (bump when PerfRtcStat changes)
+static constexpr size_t PERF_RTC_BUCKETS = PERF_HIST_BUCKETS / PERF_HIST_SUB;  // One per power of two
+static constexpr size_t PERF_RTC_NAME_LEN = 20;
+
+// Compact bucket c covers [perf_rtc_lower(c), perf_rtc_lower(c + 1))
+inline uint32_t perf_rtc_lower(size_t c) {
+    return c == 0 ? 0 : (1u << (c + PERF_HIST_SUB_BITS - 1));
+}
+
+struct PerfRtcStat {
+    uint32_t hash;                      // perf_name_hash of the full name, 0 = free
+    char name[PERF_RTC_NAME_LEN];       // Truncated copy for reporting
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint16_t hist[PERF_RTC_BUCKETS];    // Saturating
+};
+
+template <size_t N>
+struct PerfRtcTable {
+    uint32_t magic;
+    uint32_t wakes;                     // Wakes merged since the last reset
+    uint32_t window_sec;                // Wall time those wakes covered
+    uint32_t dropped;                   // Stats that found no free slot
+    PerfRtcStat stats[N];
+};
+
+template <size_t N>
+inline void perf_rtc_reset(PerfRtcTable<N>& t) {
+    memset(&t, 0, sizeof(t));
+    t.magic = PERF_RTC_MAGIC;
+}
+
+// Zeroed (first boot) or stale-layout tables start over
+template <size_t N>
+inline void perf_rtc_validate(PerfRtcTable<N>& t) {
+    if (t.magic != PERF_RTC_MAGIC) perf_rtc_reset(t);
+}
+
+// Fold one wake's stats in; false if the table is full
+template <size_t N>
+inline bool perf_rtc_merge(PerfRtcTable<N>& t, const PerfStats& s) {
+    if (!s.name || s.count == 0) return true;
+    uint32_t hash = perf_name_hash(s.name);
+    if (hash == 0) hash = 1;
+
+    PerfRtcStat* slot = nullptr;
+    for (size_t i = 0; i < N && !slot; i++) {
+        if (t.stats[i].hash == hash) slot = &t.stats[i];
+    }
+    for (size_t i = 0; i < N && !slot; i++) {
+        if (t.stats[i].hash != 0) continue;
+        slot = &t.stats[i];
+        memset(slot, 0, sizeof(*slot));
+        slot->hash = hash;
+        slot->min_us = UINT32_MAX;
+        strncpy(slot->name, s.name, PERF_RTC_NAME_LEN - 1);
+    }
+    if (!slot) {
+        t.dropped++;
+        return false;
+    }
+
+    slot->count = (slot->count > UINT32_MAX - s.count) ? UINT32_MAX : slot->count + s.count;
+    slot->total_us += s.total_us;
+    if (s.min_us < slot->min_us) slot->min_us = s.min_us;
+    if (s.max_us > slot->max_us) slot->max_us = s.max_us;
+    for (size_t b = 0; b < PERF_HIST_BUCKETS; b++) {
+        uint32_t sum = (uint32_t)slot->hist[b / PERF_HIST_SUB] + s.hist[b];
+        slot->hist[b / PERF_HIST_SUB] = (uint16_t)(sum > UINT16_MAX ? UINT16_MAX : sum);
+    }
+    return true;
+}
+
+// As PerfStats::percentile, over the compact buckets (bucket midpoint,
+// clamped to the observed min/max)
+inline uint32_t perf_rtc_percentile(const PerfRtcStat& s, uint8_t p) {
+    uint32_t samples = 0;
+    for (size_t c = 0; c < PERF_RTC_BUCKETS; c++) samples += s.hist[c];
+    if (samples == 0) return 0;
+    if (p >= 100) return s.max_us;
+    uint32_t rank = (uint32_t)(((uint64_t)samples * p + 99) / 100);
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (size_t c = 0; c < PERF_RTC_BUCKETS; c++) {
+        seen += s.hist[c];
+        if (seen < rank) continue;
+        uint32_t lo = perf_rtc_lower(c);
+        uint32_t v = lo + (perf_rtc_lower(c + 1) - lo) / 2;
+        if (v < s.min_us) v = s.min_us;
+        if (v > s.max_us) v = s.max_us;
+        return v;
+    }
+    return s.max_us;
+}
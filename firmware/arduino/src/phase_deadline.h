@@ -0,0 +1,104 @@
+#pragma once
+
+// Per-phase deadlines inside one overall wake budget
+// Each wake phase (sensors, WiFi/MQTT connect, publish, display, deferred
+// publish) gets its own budget, and the whole wake gets WAKE_BUDGET_MS. The
+// blocking waits inside a phase are clamped to what is left of both, and a
+// phase that finishes past either limit is an overrun: it is reported once,
+// and the wake is degraded from then on (no retained fetch, no display, the
+// sample goes to the offline queue) so it reaches deep sleep well before
+// the task watchdog would reboot it.
+//
+// Usage:
+//   PhaseDeadline d;
+//   phase_deadline_begin(d, millis(), WAKE_BUDGET_MS);
+//   phase_deadline_enter(d, WakePhase::CONNECT, CONNECT_PHASE_TIMEOUT_MS, millis());
+//   wifi_connect_with_exponential_backoff(3, 1000, phase_deadline_remaining(d, millis()));
+//   if (phase_deadline_check(d, millis())) increment_error_stat("phase_overrun");
+//   if (phase_deadline_degraded(d)) { /* queue offline, sleep */ }
+
+#include <cstdint>
+
+enum class WakePhase : uint8_t {
+  SENSOR = 0,
+  CONNECT,        // WiFi association, DHCP, MQTT session
+  NETWORK,        // Batched publish and retained fetch
+  DISPLAY,
+  DEFERRED,       // Publishes after the display phase
+  COUNT
+};
+
+struct PhaseDeadline {
+  uint32_t wake_start_ms;
+  uint32_t wake_budget_ms;    // 0 = unbounded
+  uint32_t phase_start_ms;
+  uint32_t phase_budget_ms;   // 0 = only the wake budget applies
+  WakePhase phase;
+  uint8_t overrun_mask;       // One bit per WakePhase that overran
+  bool degraded;
+};
+
+static constexpr uint32_t PHASE_DEADLINE_UNBOUNDED = UINT32_MAX;
+
+inline const char* wake_phase_name(WakePhase p) {
+  switch (p) {
+    case WakePhase::SENSOR: return "sensor";
+    case WakePhase::CONNECT: return "connect";
+    case WakePhase::NETWORK: return "network";
+    case WakePhase::DISPLAY: return "display";
+    case WakePhase::DEFERRED: return "deferred";
+    default: return "unknown";
+  }
+}
+
+inline void phase_deadline_begin(PhaseDeadline& d, uint32_t now_ms, uint32_t wake_budget_ms) {
+  d.wake_start_ms = now_ms;
+  d.wake_budget_ms = wake_budget_ms;
+  d.phase_start_ms = now_ms;
+  d.phase_budget_ms = 0;
+  d.phase = WakePhase::SENSOR;
+  d.overrun_mask = 0;
+  d.degraded = false;
+}
+
+inline void phase_deadline_enter(PhaseDeadline& d, WakePhase p, uint32_t budget_ms, uint32_t now_ms) {
+  d.phase = p;
+  d.phase_budget_ms = budget_ms;
+  d.phase_start_ms = now_ms;
+}
+
+// Time left before budget_ms from start, 0 once past it (wrap-safe)
+inline uint32_t phase_deadline_left(uint32_t start_ms, uint32_t budget_ms, uint32_t now_ms) {
+  if (budget_ms == 0) return PHASE_DEADLINE_UNBOUNDED;
+  uint32_t elapsed = now_ms - start_ms;
+  return elapsed >= budget_ms ? 0 : budget_ms - elapsed;
+}
+
+// Left in the current phase and in the wake, whichever ends first
+inline uint32_t phase_deadline_remaining(const PhaseDeadline& d, uint32_t now_ms) {
+  uint32_t phase_left = phase_deadline_left(d.phase_start_ms, d.phase_budget_ms, now_ms);
+  uint32_t wake_left = phase_deadline_left(d.wake_start_ms, d.wake_budget_ms, now_ms);
+  return phase_left < wake_left ? phase_left : wake_left;
+}
+
+// A wait of timeout_ms cut down to the deadline
+inline uint32_t phase_deadline_clamp(const PhaseDeadline& d, uint32_t timeout_ms, uint32_t now_ms) {
+  uint32_t left = phase_deadline_remaining(d, now_ms);
+  return timeout_ms < left ? timeout_ms : left;
+}
+
+// Called at the end of a phase (or between its blocking steps). True the
+// first time the current phase is found past its budget or the wake past
+// its own; the wake is degraded from then on.
+inline bool phase_deadline_check(PhaseDeadline& d, uint32_t now_ms) {
+  if (phase_deadline_remaining(d, now_ms) != 0) return false;
+  uint8_t bit = (uint8_t)(1u << (uint8_t)d.phase);
+  d.degraded = true;
+  if (d.overrun_mask & bit) return false;
+  d.overrun_mask |= bit;
+  return true;
+}
+
+inline bool phase_deadline_degraded(const PhaseDeadline& d) {
+  return d.degraded;
+}
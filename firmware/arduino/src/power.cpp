@@ -4,6 +4,8 @@
 #include "power.h"
 #include <Wire.h>
 #include <cmath>  // For fabsf()
+#include "feature_flags.h"
+#include "energy_meter.h"
 
 #if USE_MAX17048
 #include <Adafruit_MAX1704X.h>
@@ -85,7 +87,27 @@ void lc_sleep_between_wakes() {
 }
 #endif
 
-BatteryStatus read_battery_status() {
+// Days left at the measured average draw (energy meter history, or the fuel
+// gauge once it has resolved a long discharge); 50 mA until there is data
+#if USE_MAX17048 || USE_LC709203F
+static int battery_days_remaining(int percent) {
+  float ma = 50.0f;
+#if FEATURE_ENERGY_METER
+  float measured = EnergyMeter::getInstance().averageMa();
+  if (measured > 0.0f) ma = measured;
+#endif
+  return estimate_battery_days(percent, BATTERY_CAPACITY_MAH, ma);
+}
+#endif
+
+// One fuel gauge sample per wake: every reader (publish, display, sleep
+// scheduling) sees the same numbers and only the first one pays for I2C.
+// Reset by deep sleep like any other DRAM state.
+static BatteryStatus g_battery_cache;
+static uint32_t g_battery_sampled_ms = 0;
+static bool g_battery_cached = false;
+
+static BatteryStatus sample_battery_status() {
   BatteryStatus b;
   
 #if USE_MAX17048
@@ -111,10 +133,7 @@ BatteryStatus read_battery_status() {
     float pct = g_maxfg.cellPercent();
     b.percent = constrain(static_cast<int>(pct), 0, 100);
     
-    // Simple day estimate: 3000mAh / 50mA average = 60 hours = 2.5 days
-    if (b.percent >= 0) {
-      b.estimatedDays = (b.percent * 2.5) / 100;
-    }
+    b.estimatedDays = battery_days_remaining(b.percent);
   }
 #endif
 
@@ -141,15 +160,31 @@ BatteryStatus read_battery_status() {
     float pct = g_lcfg.cellPercent();
     b.percent = constrain(static_cast<int>(pct), 0, 100);
     
-    if (b.percent >= 0) {
-      b.estimatedDays = (b.percent * 2.5) / 100;
-    }
+    b.estimatedDays = battery_days_remaining(b.percent);
   }
 #endif
 
   return b;
 }
 
+BatteryStatus read_battery_status() {
+  // Awake-for-good modes (dev/no-sleep) still pick up a fresh sample now and then
+  if (!g_battery_cached || millis() - g_battery_sampled_ms > BATTERY_CACHE_MAX_AGE_MS)
+    return refresh_battery_status();
+  return g_battery_cache;
+}
+
+BatteryStatus refresh_battery_status() {
+  g_battery_cache = sample_battery_status();
+  g_battery_sampled_ms = millis();
+  g_battery_cached = true;
+  return g_battery_cache;
+}
+
+uint32_t battery_status_age_ms() {
+  return g_battery_cached ? millis() - g_battery_sampled_ms : UINT32_MAX;
+}
+
 // Battery percentage from voltage
 int estimate_battery_percent(float voltage) {
   if (!isfinite(voltage) || voltage < 3.0)
@@ -217,8 +252,11 @@ void power_wake_from_sleep() {
 
 // Adaptive sleep scheduling implementation
 #include "state_manager.h"
+#include "rtc_state.h"
+#include "trend_model.h"
 
-static float g_last_temperature = NAN;
+// One trend sample per wake, however often the planner is asked
+static bool g_trend_sampled = false;
 
 // Custom sleep interval (set via MQTT, 0 = use adaptive)
 static uint32_t g_custom_sleep_interval_sec = 0;
@@ -286,27 +324,57 @@ static SleepConfig g_sleep_config = {
     .critical_interval_sec = 1800,        // 30 minutes
     .rapid_update_interval_sec = 60,      // 1 minute
     .low_battery_threshold = 20,
-    .critical_battery_threshold = 5
+    .critical_battery_threshold = 5,
+    .max_interval_sec = SLEEP_MAX_INTERVAL_SEC
 };
 
 SleepConfig get_default_sleep_config() {
-    return g_sleep_config;
+    const RemoteConfig& rc = g_rtc_state.config;
+    SleepConfig c = g_sleep_config;
+    c.normal_interval_sec = remote_config_u32(rc.normal_interval_sec, c.normal_interval_sec);
+    c.low_battery_interval_sec = remote_config_u32(rc.low_battery_interval_sec, c.low_battery_interval_sec);
+    c.critical_interval_sec = remote_config_u32(rc.critical_interval_sec, c.critical_interval_sec);
+    c.rapid_update_interval_sec = remote_config_u32(rc.rapid_update_interval_sec, c.rapid_update_interval_sec);
+    c.max_interval_sec = remote_config_u32(rc.max_interval_sec, c.max_interval_sec);
+    uint8_t low = rc.low_battery_threshold ? rc.low_battery_threshold : c.low_battery_threshold;
+    uint8_t critical = rc.critical_battery_threshold ? rc.critical_battery_threshold
+                                                     : c.critical_battery_threshold;
+    // A pair that would hide the low tier keeps the firmware thresholds
+    if (critical < low) {
+        c.low_battery_threshold = low;
+        c.critical_battery_threshold = critical;
+    }
+    return c;
 }
 
-bool is_temperature_changing_rapidly() {
-    // Get current inside temperature from state
-    float current_temp = get_last_inside_f();
+PublishPolicy get_publish_policy() {
+    PublishPolicy p = default_publish_policy();
+    remote_config_apply_policy(g_rtc_state.config, p);
+    return p;
+}
 
-    if (isnan(g_last_temperature) || isnan(current_temp)) {
-        g_last_temperature = current_temp;
-        return false;
-    }
+void record_temperature_sample(float tempC) {
+    if (g_trend_sampled) return;
+    TrendHistory& h = g_rtc_state.trend;
+    trend_push(h, h.next_dt_sec, tempC);
+    g_trend_sampled = std::isfinite(tempC);
+}
 
-    // Use fabsf() for float absolute value (abs() returns int, truncating the delta)
-    float delta = fabsf(current_temp - g_last_temperature);
-    g_last_temperature = current_temp;
+void note_sleep_interval(uint32_t sec) {
+    // The gap the next wake's sample will report: this sleep plus time awake
+    g_rtc_state.trend.next_dt_sec = sec + millis() / 1000;
+}
 
-    return delta > 2.0f;  // More than 2°F change
+float get_temperature_trend_rate() {
+    return trend_rate(g_rtc_state.trend);
+}
+
+// The trend would leave the publish deadband before a normal interval is up
+bool is_temperature_changing_rapidly() {
+    float rate = get_temperature_trend_rate();
+    return std::isfinite(rate) &&
+           rate * (float)get_default_sleep_config().normal_interval_sec >=
+               get_publish_policy().temp_deadband_c;
 }
 
 uint32_t calculate_optimal_sleep_interval(const SleepConfig& config) {
@@ -317,27 +385,23 @@ uint32_t calculate_optimal_sleep_interval(const SleepConfig& config) {
     }
 
     BatteryStatus bs = read_battery_status();
+    SleepTier tier = sleep_tier(config, bs.percent);
 
     // Critical battery - maximum conservation
-    if (bs.percent >= 0 && bs.percent < config.critical_battery_threshold) {
+    if (tier == SleepTier::CRITICAL) {
         Serial.printf("[Power] Critical battery (%d%%), using %us interval\n",
                       bs.percent, config.critical_interval_sec);
         return config.critical_interval_sec;
     }
 
-    // Low battery - extended interval
-    if (bs.percent >= 0 && bs.percent < config.low_battery_threshold) {
-        Serial.printf("[Power] Low battery (%d%%), using %us interval\n",
-                      bs.percent, config.low_battery_interval_sec);
-        return config.low_battery_interval_sec;
+    // Trend-planned (sleep_policy.h); low battery never wakes sooner than
+    // its own interval. Sleep until the expected change reaches the deadband.
+    float rate = get_temperature_trend_rate();
+    uint32_t sec = sleep_plan_interval(config, bs.percent, rate,
+                                       get_publish_policy().temp_deadband_c);
+    if (std::isfinite(rate)) {
+        Serial.printf("[Power] Trend %.2f degC/h, planned %us (%u..%us)\n",
+                      rate * 3600.0f, sec, sleep_min_interval(config, tier), config.max_interval_sec);
     }
-
-    // Rapid temperature change - shorter interval for responsiveness
-    if (is_temperature_changing_rapidly()) {
-        Serial.println("[Power] Temperature changing rapidly, using short interval");
-        return config.rapid_update_interval_sec;
-    }
-
-    // Normal operation
-    return config.normal_interval_sec;
+    return sec;
 }
\ No newline at end of file
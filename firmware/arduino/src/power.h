@@ -6,6 +6,8 @@
 #include <esp_sleep.h>
 #include "config.h"
 #include "generated_config.h"
+#include "publish_policy.h"
+#include "sleep_policy.h"
 
 // Battery status structure
 struct BatteryStatus {
@@ -14,25 +16,34 @@ struct BatteryStatus {
   int estimatedDays = -1;
 };
 
-// Adaptive sleep configuration
-struct SleepConfig {
-    uint32_t normal_interval_sec;      // Default: 300 (5 min)
-    uint32_t low_battery_interval_sec; // Default: 600 (10 min) for <20% battery
-    uint32_t critical_interval_sec;    // Default: 1800 (30 min) for <5% battery
-    uint32_t rapid_update_interval_sec; // Default: 60 (1 min) when data changing
-    uint8_t low_battery_threshold;     // Default: 20%
-    uint8_t critical_battery_threshold; // Default: 5%
-};
-
 // Core power functions
+// Cached: the first call of a wake samples the fuel gauge, later calls return
+// that sample (re-sampled after BATTERY_CACHE_MAX_AGE_MS)
 BatteryStatus read_battery_status();
+// Sample the fuel gauge now and replace the cached value
+BatteryStatus refresh_battery_status();
+// Age of the cached sample, UINT32_MAX before the first one
+uint32_t battery_status_age_ms();
 int estimate_battery_percent(float voltage);
 int estimate_battery_days(int percent, float mah_capacity = 3000, float ma_average = 50);
 
 // Adaptive sleep scheduling
+// The interval is planned from the RTC temperature trend (trend_model.h):
+// long enough for the expected change to reach the publish deadband, within
+// the battery tier's bounds. Planning and the queries below have no side
+// effects; the trend only moves through record_temperature_sample().
+// Firmware defaults with the retained config document's overrides applied
 SleepConfig get_default_sleep_config();
 uint32_t calculate_optimal_sleep_interval(const SleepConfig& config);
+// Skip-network deadbands and heartbeat, same overrides
+PublishPolicy get_publish_policy();
 bool is_temperature_changing_rapidly();
+// Expected |degC/s| from the trend, NaN before two samples
+float get_temperature_trend_rate();
+// Add this wake's reading to the trend (first finite call per wake wins)
+void record_temperature_sample(float tempC);
+// Planned sleep, so the next wake's sample knows how far apart they are
+void note_sleep_interval(uint32_t sec);
 
 // Custom sleep interval (set via MQTT command)
 void set_custom_sleep_interval(uint32_t sec);
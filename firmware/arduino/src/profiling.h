@@ -4,9 +4,15 @@
 #include <esp_timer.h>
 #include "logging/logger.h"
 #include "feature_flags.h"
+#include "trace.h"
+#include "json_stream.h"
 
 // Performance profiling instrumentation
 // Provides automatic timing of code blocks and statistical tracking
+// (count/min/max/avg plus p50/p95/p99 from per-stat histograms, see
+// perf_stats.h), reported by the "perf" debug command. With FEATURE_TRACE,
+// every scope is also recorded as a begin/end pair in the trace ring
+// (trace.h), even when profiling itself is disabled.
 //
 // Usage:
 //   void my_function() {
@@ -17,6 +23,8 @@
 // Configuration:
 //   FEATURE_PROFILING (from feature_flags.h) - Enable profiling
 //   #define SLOW_THRESHOLD_US 1000 - Log warning if operation exceeds this (microseconds)
+//   PERF_RTC_HISTORY - Accumulate stats across deep sleep in RTC memory
+//   PERF_SUMMARY_INTERVAL_SEC - Publish and restart the cross-wake summary this often
 
 #ifndef PROFILING_ENABLED
   #define PROFILING_ENABLED FEATURE_PROFILING
@@ -26,39 +34,21 @@
   #define SLOW_THRESHOLD_US 1000  // 1ms default threshold
 #endif
 
-#if PROFILING_ENABLED
+#ifndef PERF_RTC_HISTORY
+  #define PERF_RTC_HISTORY 1
+#endif
 
-struct PerfStats {
-    const char* name;
-    uint32_t count;
-    uint32_t total_us;
-    uint32_t min_us;
-    uint32_t max_us;
-    uint32_t last_us;
+#ifndef PERF_RTC_SLOTS
+  #define PERF_RTC_SLOTS 12       // ~1.2 KB of RTC memory
+#endif
 
-    PerfStats() : name(nullptr), count(0), total_us(0),
-                  min_us(UINT32_MAX), max_us(0), last_us(0) {}
+#ifndef PERF_SUMMARY_INTERVAL_SEC
+  #define PERF_SUMMARY_INTERVAL_SEC 3600
+#endif
 
-    void record(uint32_t elapsed_us) {
-        count++;
-        total_us += elapsed_us;
-        last_us = elapsed_us;
-        if (elapsed_us < min_us) min_us = elapsed_us;
-        if (elapsed_us > max_us) max_us = elapsed_us;
-    }
+#if PROFILING_ENABLED
 
-    uint32_t getAverage() const {
-        return count > 0 ? total_us / count : 0;
-    }
-
-    void reset() {
-        count = 0;
-        total_us = 0;
-        min_us = UINT32_MAX;
-        max_us = 0;
-        last_us = 0;
-    }
-};
+#include "perf_stats.h"
 
 class PerformanceMonitor {
 public:
@@ -69,26 +59,12 @@ public:
         return instance;
     }
 
-    // Get or create stats entry for the given name.
+    // Get or create stats entry for the given name (hashed lookup).
     // NOTE: The name pointer is stored directly - caller must ensure it points to
     // a string with static lifetime (e.g., __func__, string literals).
     // Do NOT pass dynamically allocated or stack-based strings.
     PerfStats* getStats(const char* name) {
-        // Find existing stat - try pointer comparison first (fast path for __func__)
-        // then fall back to strcmp for different pointers with same content
-        for (size_t i = 0; i < stat_count_; i++) {
-            if (stats_[i].name == name || strcmp(stats_[i].name, name) == 0) {
-                return &stats_[i];
-            }
-        }
-
-        // Create new stat
-        if (stat_count_ < MAX_STATS) {
-            stats_[stat_count_].name = name;  // Store pointer directly (must be static!)
-            return &stats_[stat_count_++];
-        }
-
-        return nullptr;  // Out of slots
+        return registry_.get(name);
     }
 
     void record(const char* name, uint32_t elapsed_us) {
@@ -99,19 +75,15 @@ public:
     }
 
     void reset() {
-        for (size_t i = 0; i < stat_count_; i++) {
-            stats_[i].reset();
-        }
+        registry_.reset();
     }
 
+    // Call sites cache their slot, so names stay registered
     void resetAll() {
-        stat_count_ = 0;
+        registry_.reset();
     }
 
-    size_t getStatCount() const { return stat_count_; }
-    PerfStats* getStatByIndex(size_t index) {
-        return (index < stat_count_) ? &stats_[index] : nullptr;
-    }
+    size_t getStatCount() const { return registry_.size(); }
 
     // Format all stats to JSON
     void formatJson(char* out, size_t out_size) const {
@@ -122,22 +94,29 @@ public:
         if (written < 0) { out[0] = '\0'; return; }
         pos = (size_t)written;
 
-        for (size_t i = 0; i < stat_count_ && pos < out_size - 1; i++) {
-            if (i > 0 && pos < out_size - 1) {
+        bool first = true;
+        for (size_t i = 0; i < registry_.capacity() && pos < out_size - 1; i++) {
+            const PerfStats* stat = registry_.slot(i);
+            if (!stat) continue;
+
+            if (!first && pos < out_size - 1) {
                 written = snprintf(out + pos, out_size - pos, ",");
                 if (written > 0) pos += (size_t)written;
             }
 
             if (pos >= out_size - 1) break;
 
-            const PerfStats& s = stats_[i];
+            const PerfStats& s = *stat;
             size_t remaining = out_size - pos;
             written = snprintf(out + pos, remaining,
-                          "{\"name\":\"%s\",\"count\":%u,\"avg_us\":%u,\"min_us\":%u,\"max_us\":%u,\"last_us\":%u}",
-                          s.name, s.count, s.getAverage(), s.min_us, s.max_us, s.last_us);
+                          "{\"name\":\"%s\",\"count\":%u,\"avg_us\":%u,\"min_us\":%u,\"max_us\":%u,\"last_us\":%u,"
+                          "\"p50_us\":%u,\"p95_us\":%u,\"p99_us\":%u}",
+                          s.name, s.count, s.getAverage(), s.count ? s.min_us : 0, s.max_us, s.last_us,
+                          s.percentile(50), s.percentile(95), s.percentile(99));
             // Check: written >= 0 means success, written < remaining means not truncated
             if (written >= 0 && (size_t)written < remaining) {
                 pos += (size_t)written;
+                first = false;
             } else {
                 break;  // Buffer full or error, stop adding entries
             }
@@ -155,26 +134,166 @@ public:
         }
     }
 
+    // Stream all stats as JSON (no size limit; see mqtt_stream.h)
+    void writeJson(JsonStream& j) const {
+        j.beginObject().beginArray("stats");
+        for (size_t i = 0; i < registry_.capacity(); i++) {
+            const PerfStats* stat = registry_.slot(i);
+            if (!stat) continue;
+            const PerfStats& s = *stat;
+            j.beginObject()
+             .field("name", s.name)
+             .field("count", s.count)
+             .field("avg_us", s.getAverage())
+             .field("min_us", s.count ? s.min_us : 0u)
+             .field("max_us", s.max_us)
+             .field("last_us", s.last_us)
+             .field("p50_us", s.percentile(50))
+             .field("p95_us", s.percentile(95))
+             .field("p99_us", s.percentile(99))
+             .endObject();
+        }
+        j.endArray().endObject();
+    }
+
+    // Fold this wake's stats into the RTC history and clear them; call once
+    // just before deep sleep with the wall time until the next wake
+    void persistWake(uint32_t window_sec) {
+#if PERF_RTC_HISTORY
+        History& h = history();
+        perf_rtc_validate(h);
+        for (size_t i = 0; i < registry_.capacity(); i++) {
+            const PerfStats* stat = registry_.slot(i);
+            if (stat) perf_rtc_merge(h, *stat);
+        }
+        h.wakes++;
+        h.window_sec += window_sec;
+#else
+        (void)window_sec;
+#endif
+        registry_.reset();
+    }
+
+    // True once the history covers PERF_SUMMARY_INTERVAL_SEC
+    bool summaryDue() const {
+#if PERF_RTC_HISTORY
+        const History& h = history();
+        return h.magic == PERF_RTC_MAGIC && h.wakes > 0 && h.window_sec >= PERF_SUMMARY_INTERVAL_SEC;
+#else
+        return false;
+#endif
+    }
+
+    void resetHistory() {
+#if PERF_RTC_HISTORY
+        perf_rtc_reset(history());
+#endif
+    }
+
+    // Format the cross-wake history to JSON (truncated to whole entries)
+    void formatHistoryJson(char* out, size_t out_size) const {
+        if (out_size == 0) return;
+#if PERF_RTC_HISTORY
+        const History& h = history();
+        bool valid = h.magic == PERF_RTC_MAGIC;
+        int written = snprintf(out, out_size, "{\"wakes\":%u,\"window_s\":%u,\"dropped\":%u,\"stats\":[",
+                               valid ? h.wakes : 0, valid ? h.window_sec : 0, valid ? h.dropped : 0);
+        if (written < 0 || (size_t)written >= out_size) { out[0] = '\0'; return; }
+        size_t pos = (size_t)written;
+
+        bool first = true;
+        for (size_t i = 0; valid && i < PERF_RTC_SLOTS; i++) {
+            const PerfRtcStat& s = h.stats[i];
+            if (s.hash == 0) continue;
+            size_t remaining = out_size - pos;
+            written = snprintf(out + pos, remaining,
+                          "%s{\"name\":\"%s\",\"count\":%u,\"avg_us\":%u,\"min_us\":%u,\"max_us\":%u,"
+                          "\"p50_us\":%u,\"p95_us\":%u,\"p99_us\":%u}",
+                          first ? "" : ",", s.name, s.count,
+                          s.count ? (uint32_t)(s.total_us / s.count) : 0, s.count ? s.min_us : 0, s.max_us,
+                          perf_rtc_percentile(s, 50), perf_rtc_percentile(s, 95), perf_rtc_percentile(s, 99));
+            // Keep room for the closing "]}"
+            if (written < 0 || (size_t)written + 2 >= remaining) break;
+            pos += (size_t)written;
+            first = false;
+        }
+        snprintf(out + pos, out_size - pos, "]}");
+#else
+        int written = snprintf(out, out_size, "{\"stats\":[],\"enabled\":false}");
+        if (written < 0) out[0] = '\0';
+#endif
+    }
+
+    // Stream the cross-wake history as JSON (every entry)
+    void writeHistoryJson(JsonStream& j) const {
+        j.beginObject();
+#if PERF_RTC_HISTORY
+        const History& h = history();
+        bool valid = h.magic == PERF_RTC_MAGIC;
+        j.field("wakes", valid ? h.wakes : 0u)
+         .field("window_s", valid ? h.window_sec : 0u)
+         .field("dropped", valid ? h.dropped : 0u)
+         .beginArray("stats");
+        for (size_t i = 0; valid && i < PERF_RTC_SLOTS; i++) {
+            const PerfRtcStat& s = h.stats[i];
+            if (s.hash == 0) continue;
+            j.beginObject()
+             .field("name", s.name)
+             .field("count", s.count)
+             .field("avg_us", s.count ? (uint32_t)(s.total_us / s.count) : 0u)
+             .field("min_us", s.count ? s.min_us : 0u)
+             .field("max_us", s.max_us)
+             .field("p50_us", perf_rtc_percentile(s, 50))
+             .field("p95_us", perf_rtc_percentile(s, 95))
+             .field("p99_us", perf_rtc_percentile(s, 99))
+             .endObject();
+        }
+        j.endArray();
+#else
+        j.beginArray("stats").endArray().field("enabled", false);
+#endif
+        j.endObject();
+    }
+
 private:
     PerformanceMonitor() = default;
     ~PerformanceMonitor() = default;
     PerformanceMonitor(const PerformanceMonitor&) = delete;
     PerformanceMonitor& operator=(const PerformanceMonitor&) = delete;
 
-    PerfStats stats_[MAX_STATS];
-    size_t stat_count_ = 0;
+    PerfRegistry<MAX_STATS> registry_;
+
+#if PERF_RTC_HISTORY
+    typedef PerfRtcTable<PERF_RTC_SLOTS> History;
+
+    // Survives deep sleep; zeroed on power-up and by perf_rtc_validate
+    static History& history() {
+        RTC_DATA_ATTR static History table;
+        return table;
+    }
+#endif
 };
 
 class ScopedTimer {
 public:
-    ScopedTimer(const char* name) : name_(name), start_(esp_timer_get_time()) {}
+    ScopedTimer(PerfStats* stat, const char* name)
+        : stat_(stat), name_(name), start_(esp_timer_get_time()) {
+#if FEATURE_TRACE
+        Tracer::getInstance().begin(name_);
+#endif
+    }
 
     ~ScopedTimer() {
         uint64_t end = esp_timer_get_time();
+#if FEATURE_TRACE
+        Tracer::getInstance().end(name_);
+#endif
         uint32_t elapsed = (uint32_t)(end - start_);
 
-        // Record in performance monitor
-        PerformanceMonitor::getInstance().record(name_, elapsed);
+        // Record in the call site's slot (nullptr if the registry was full)
+        if (stat_) {
+            stat_->record(elapsed);
+        }
 
         // Log warning if slow
         if (elapsed > SLOW_THRESHOLD_US) {
@@ -184,29 +303,48 @@ public:
     }
 
 private:
+    PerfStats* stat_;
     const char* name_;
     uint64_t start_;
 };
 
-// Macro for easy profiling
-#define PROFILE_SCOPE(name) ScopedTimer _timer_##__LINE__(name)
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Macro for easy profiling; the stats slot is resolved once per call site
+#define PROFILE_SCOPE(name) \
+    static PerfStats* const PROFILE_CONCAT(_perf_slot_, __LINE__) = \
+        PerformanceMonitor::getInstance().getStats(name); \
+    ScopedTimer PROFILE_CONCAT(_timer_, __LINE__)(PROFILE_CONCAT(_perf_slot_, __LINE__), name)
 
 // Macro for conditional profiling (only if threshold exceeded)
 #define PROFILE_SCOPE_SLOW(name, threshold_us) \
-    ScopedTimerConditional _timer_##__LINE__(name, threshold_us)
+    static PerfStats* const PROFILE_CONCAT(_perf_slot_, __LINE__) = \
+        PerformanceMonitor::getInstance().getStats(name); \
+    ScopedTimerConditional PROFILE_CONCAT(_timer_, __LINE__)( \
+        PROFILE_CONCAT(_perf_slot_, __LINE__), name, threshold_us)
 
 // Conditional timer that only records if threshold exceeded
 class ScopedTimerConditional {
 public:
-    ScopedTimerConditional(const char* name, uint32_t threshold_us)
-        : name_(name), threshold_(threshold_us), start_(esp_timer_get_time()) {}
+    ScopedTimerConditional(PerfStats* stat, const char* name, uint32_t threshold_us)
+        : stat_(stat), name_(name), threshold_(threshold_us), start_(esp_timer_get_time()) {
+#if FEATURE_TRACE
+        Tracer::getInstance().begin(name_);
+#endif
+    }
 
     ~ScopedTimerConditional() {
         uint64_t end = esp_timer_get_time();
+#if FEATURE_TRACE
+        Tracer::getInstance().end(name_);
+#endif
         uint32_t elapsed = (uint32_t)(end - start_);
 
         if (elapsed > threshold_) {
-            PerformanceMonitor::getInstance().record(name_, elapsed);
+            if (stat_) {
+                stat_->record(elapsed);
+            }
 
             LOG_MODULE("PERF");
             LOG_WARN("SLOW: %s took %u us (%.2f ms), threshold %u us",
@@ -215,6 +353,7 @@ public:
     }
 
 private:
+    PerfStats* stat_;
     const char* name_;
     uint32_t threshold_;
     uint64_t start_;
@@ -222,9 +361,9 @@ private:
 
 #else  // PROFILING_ENABLED == 0
 
-// No-op implementations when profiling is disabled
-#define PROFILE_SCOPE(name)
-#define PROFILE_SCOPE_SLOW(name, threshold_us)
+// No-op implementations when profiling is disabled (scopes are still traced)
+#define PROFILE_SCOPE(name) TRACE_SCOPE(name)
+#define PROFILE_SCOPE_SLOW(name, threshold_us) TRACE_SCOPE(name)
 
 class PerformanceMonitor {
 public:
@@ -236,12 +375,24 @@ public:
     void reset() {}
     void resetAll() {}
     size_t getStatCount() const { return 0; }
+    void persistWake(uint32_t) {}
+    bool summaryDue() const { return false; }
+    void resetHistory() {}
     void formatJson(char* out, size_t out_size) const {
         if (out_size > 0) {
             int written = snprintf(out, out_size, "{\"stats\":[],\"enabled\":false}");
             if (written < 0) out[0] = '\0';
         }
     }
+    void formatHistoryJson(char* out, size_t out_size) const {
+        formatJson(out, out_size);
+    }
+    void writeJson(JsonStream& j) const {
+        j.beginObject().beginArray("stats").endArray().field("enabled", false).endObject();
+    }
+    void writeHistoryJson(JsonStream& j) const {
+        writeJson(j);
+    }
 };
 
 #endif  // PROFILING_ENABLED
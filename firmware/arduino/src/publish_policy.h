@@ -0,0 +1,89 @@
+#pragma once
+
+// Change-detection policy for skip-network wakes
+// Decides whether a timer wake needs to bring up WiFi/MQTT, or whether the
+// readings are close enough to what was last transmitted that the wake can
+// update the display (if any) and go straight back to sleep.
+//
+// Usage:
+//   PublishPolicy policy = default_publish_policy();
+//   PublishDecision d = evaluate_publish_policy(policy, last_tx, now, sec_since_tx);
+//   if (d == PublishDecision::SKIP) { /* no radio this wake */ }
+
+#include <cmath>
+#include <cstdint>
+#include "config.h"
+
+struct PublishSnapshot {
+  float tempC;
+  float rhPct;
+  float pressHPa;
+};
+
+struct PublishPolicy {
+  float temp_deadband_c;      // Publish when |delta T| >= this
+  float rh_deadband_pct;      // Publish when |delta RH| >= this
+  float press_deadband_hpa;   // Publish when |delta P| >= this
+  uint32_t heartbeat_sec;     // Publish at least this often regardless
+};
+
+enum class PublishDecision : uint8_t {
+  SKIP = 0,         // Within all deadbands and heartbeat not due
+  NO_BASELINE,      // Nothing transmitted yet (or baseline lost)
+  CHANGED,          // At least one metric left its deadband (or validity changed)
+  HEARTBEAT         // Maximum staleness reached
+};
+
+inline PublishPolicy default_publish_policy() {
+  PublishPolicy p;
+  p.temp_deadband_c = SKIP_NET_TEMP_DEADBAND_C;
+  p.rh_deadband_pct = SKIP_NET_RH_DEADBAND_PCT;
+  p.press_deadband_hpa = SKIP_NET_PRESS_DEADBAND_HPA;
+  p.heartbeat_sec = SKIP_NET_HEARTBEAT_SEC;
+  return p;
+}
+
+// True if a metric moved outside its deadband, or went valid <-> invalid
+inline bool metric_left_deadband(float last, float now, float deadband) {
+  bool last_ok = std::isfinite(last);
+  bool now_ok = std::isfinite(now);
+  if (last_ok != now_ok) return true;
+  if (!now_ok) return false;          // Both invalid - nothing new to say
+  return std::fabs(now - last) >= deadband;
+}
+
+inline PublishDecision evaluate_publish_policy(const PublishPolicy& policy,
+                                               const PublishSnapshot& last_tx,
+                                               const PublishSnapshot& now,
+                                               uint32_t sec_since_tx) {
+  if (!std::isfinite(last_tx.tempC)) {
+    return PublishDecision::NO_BASELINE;
+  }
+  if (sec_since_tx >= policy.heartbeat_sec) {
+    return PublishDecision::HEARTBEAT;
+  }
+  if (metric_left_deadband(last_tx.tempC, now.tempC, policy.temp_deadband_c) ||
+      metric_left_deadband(last_tx.rhPct, now.rhPct, policy.rh_deadband_pct) ||
+      metric_left_deadband(last_tx.pressHPa, now.pressHPa, policy.press_deadband_hpa)) {
+    return PublishDecision::CHANGED;
+  }
+  return PublishDecision::SKIP;
+}
+
+// Store-and-forward (STORE_FORWARD_WAKES > 1): true if the wake_n-th wake
+// since the last transmit can stay offline; the radio comes up every
+// `every` wakes, or sooner when a reading leaves its deadband
+inline bool store_forward_skip(PublishDecision d, uint32_t wake_n, uint32_t every) {
+  bool crossed = (d == PublishDecision::CHANGED || d == PublishDecision::NO_BASELINE);
+  return !crossed && wake_n < every;
+}
+
+inline const char* publish_decision_str(PublishDecision d) {
+  switch (d) {
+    case PublishDecision::SKIP:        return "skip";
+    case PublishDecision::NO_BASELINE: return "no_baseline";
+    case PublishDecision::CHANGED:     return "changed";
+    case PublishDecision::HEARTBEAT:   return "heartbeat";
+    default:                           return "unknown";
+  }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+// Fleet configuration from the retained espsensor/<id>/config document
+// Sleep tiers, battery thresholds, publish deadbands and feature toggles can
+// be tuned centrally. The broker redelivers the retained document on every
+// connect; only a new "v" is parsed, into RtcState, where the sleep planner
+// and the next wake's skip decision read it without touching the network.
+//
+// Every field is optional. An absent or out-of-range field, or a pair out of
+// order (max below normal, rapid above normal, critical battery above low),
+// reads as 0 and leaves the firmware default in place. Toggles can only
+// switch off (or back on) a feature compiled into this build.
+//
+//   {"v":7,
+//    "sleep":{"normal":300,"low":600,"critical":1800,"rapid":60,"max":3600},
+//    "battery":{"low":20,"critical":5},
+//    "deadband":{"temp_c":0.2,"rh_pct":1.0,"press_hpa":0.5,"heartbeat_s":3600},
+//    "features":{"partial_refresh":true,"compact_telemetry":false,"ulp":true}}
+//
+// Usage:
+//   uint32_t v;
+//   if (remote_config_peek_version(payload, len, v) && v != cfg.version) { ...parse... }
+//   remote_config_sanitize(parsed);
+//   PublishPolicy p = default_publish_policy();
+//   remote_config_apply_policy(cfg, p);
+//   bool ulp = remote_config_feature(cfg, RCFG_FEATURE_ULP, FEATURE_ULP_SAMPLING);
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "publish_policy.h"
+
+static constexpr uint32_t RCFG_MIN_INTERVAL_SEC = 60;
+static constexpr uint32_t RCFG_MAX_INTERVAL_SEC = 86400;
+static constexpr uint32_t RCFG_MIN_HEARTBEAT_SEC = 300;
+static constexpr float RCFG_MAX_DEADBAND = 50.0f;
+
+enum RemoteFeature : uint8_t {
+  RCFG_FEATURE_PARTIAL_REFRESH = 1 << 0,    // SPEC_PARTIAL_REFRESH
+  RCFG_FEATURE_COMPACT_TELEMETRY = 1 << 1,  // MQTT_COMPACT_TELEMETRY
+  RCFG_FEATURE_ULP = 1 << 2,                // FEATURE_ULP_SAMPLING
+};
+
+struct RemoteConfig {
+  uint32_t version;                   // "v" of the applied document, 0 = none
+  uint32_t normal_interval_sec;       // 0 = firmware default for every field
+  uint32_t low_battery_interval_sec;
+  uint32_t critical_interval_sec;
+  uint32_t rapid_update_interval_sec;
+  uint32_t max_interval_sec;
+  uint32_t heartbeat_sec;
+  float temp_deadband_c;
+  float rh_deadband_pct;
+  float press_deadband_hpa;
+  uint8_t low_battery_threshold;      // Percent
+  uint8_t critical_battery_threshold;
+  uint8_t features_set;               // RemoteFeature bits the document names
+  uint8_t features_on;                // Their values
+};
+
+static_assert(sizeof(RemoteConfig) % 4 == 0, "RemoteConfig must not leave tail padding");
+
+// Top-level "v" of a JSON object without a full parse; nested objects and
+// strings are skipped. False if there is none or it is not an integer >= 1.
+inline bool remote_config_peek_version(const char* s, size_t len, uint32_t& out) {
+  int depth = 0;
+  bool in_str = false;
+  bool key_v = false;      // The string just closed was "v" at depth 1
+  size_t str_start = 0;
+  for (size_t i = 0; i < len; i++) {
+    char c = s[i];
+    if (in_str) {
+      if (c == '\\') { i++; continue; }
+      if (c == '"') {
+        in_str = false;
+        key_v = depth == 1 && i == str_start + 1 && s[str_start] == 'v';
+      }
+      continue;
+    }
+    if (c == '"') { in_str = true; str_start = i + 1; continue; }
+    if (c == '{' || c == '[') { depth++; key_v = false; continue; }
+    if (c == '}' || c == ']') { depth--; key_v = false; continue; }
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+    if (c == ':' && key_v) {
+      size_t j = i + 1;
+      while (j < len && (s[j] == ' ' || s[j] == '\t')) j++;
+      uint64_t v = 0;
+      size_t digits = 0;
+      while (j < len && s[j] >= '0' && s[j] <= '9' && digits < 10) {
+        v = v * 10 + (uint64_t)(s[j] - '0');
+        j++;
+        digits++;
+      }
+      if (digits == 0 || v == 0 || v > UINT32_MAX) return false;
+      if (j < len && ((s[j] >= '0' && s[j] <= '9') || s[j] == '.' || s[j] == 'e' || s[j] == 'E')) {
+        return false;
+      }
+      out = (uint32_t)v;
+      return true;
+    }
+    key_v = false;
+  }
+  return false;
+}
+
+inline uint32_t rcfg_clamp_interval(uint32_t sec) {
+  return (sec >= RCFG_MIN_INTERVAL_SEC && sec <= RCFG_MAX_INTERVAL_SEC) ? sec : 0;
+}
+
+inline float rcfg_clamp_deadband(float v) {
+  return (std::isfinite(v) && v > 0.0f && v <= RCFG_MAX_DEADBAND) ? v : 0.0f;
+}
+
+// A pair whose lower bound exceeds its upper bound goes back to 0 together
+inline void rcfg_drop_unordered(uint32_t& lo, uint32_t& hi) {
+  if (lo && hi && lo > hi) {
+    lo = 0;
+    hi = 0;
+  }
+}
+
+// Out-of-range fields back to 0 (firmware default)
+inline void remote_config_sanitize(RemoteConfig& c) {
+  c.normal_interval_sec = rcfg_clamp_interval(c.normal_interval_sec);
+  c.low_battery_interval_sec = rcfg_clamp_interval(c.low_battery_interval_sec);
+  c.critical_interval_sec = rcfg_clamp_interval(c.critical_interval_sec);
+  c.rapid_update_interval_sec = rcfg_clamp_interval(c.rapid_update_interval_sec);
+  c.max_interval_sec = rcfg_clamp_interval(c.max_interval_sec);
+  // Every tier interval is a floor under max, and rapid must stay below
+  // normal, or the trend planner's [min, max] bounds cross
+  rcfg_drop_unordered(c.normal_interval_sec, c.max_interval_sec);
+  rcfg_drop_unordered(c.low_battery_interval_sec, c.max_interval_sec);
+  rcfg_drop_unordered(c.critical_interval_sec, c.max_interval_sec);
+  rcfg_drop_unordered(c.rapid_update_interval_sec, c.max_interval_sec);
+  rcfg_drop_unordered(c.rapid_update_interval_sec, c.normal_interval_sec);
+  if (c.heartbeat_sec < RCFG_MIN_HEARTBEAT_SEC || c.heartbeat_sec > RCFG_MAX_INTERVAL_SEC) {
+    c.heartbeat_sec = 0;
+  }
+  c.temp_deadband_c = rcfg_clamp_deadband(c.temp_deadband_c);
+  c.rh_deadband_pct = rcfg_clamp_deadband(c.rh_deadband_pct);
+  c.press_deadband_hpa = rcfg_clamp_deadband(c.press_deadband_hpa);
+  if (c.low_battery_threshold > 100) c.low_battery_threshold = 0;
+  if (c.critical_battery_threshold > 100) c.critical_battery_threshold = 0;
+  // Critical must stay below low, or the low tier is never reached
+  if (c.low_battery_threshold && c.critical_battery_threshold &&
+      c.critical_battery_threshold >= c.low_battery_threshold) {
+    c.low_battery_threshold = 0;
+    c.critical_battery_threshold = 0;
+  }
+  c.features_on &= c.features_set;
+}
+
+inline uint32_t remote_config_u32(uint32_t value, uint32_t fallback) {
+  return value ? value : fallback;
+}
+
+inline float remote_config_float(float value, float fallback) {
+  return value > 0.0f ? value : fallback;
+}
+
+inline void remote_config_apply_policy(const RemoteConfig& c, PublishPolicy& p) {
+  p.temp_deadband_c = remote_config_float(c.temp_deadband_c, p.temp_deadband_c);
+  p.rh_deadband_pct = remote_config_float(c.rh_deadband_pct, p.rh_deadband_pct);
+  p.press_deadband_hpa = remote_config_float(c.press_deadband_hpa, p.press_deadband_hpa);
+  p.heartbeat_sec = remote_config_u32(c.heartbeat_sec, p.heartbeat_sec);
+}
+
+// A feature runs when it is compiled in and the document does not turn it off
+inline bool remote_config_feature(const RemoteConfig& c, uint8_t bit, bool compiled) {
+  if (!compiled) return false;
+  if (!(c.features_set & bit)) return true;
+  return (c.features_on & bit) != 0;
+}
@@ -0,0 +1,112 @@
+// Render model snapshot and field formatting
+#include "render_model.h"
+
+#if USE_DISPLAY
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "display_manager.h"
+#include "display_renderer.h"
+#include "feature_flags.h"
+#include "generated_config.h"
+#include "inside_stats.h"
+#include "net.h"
+#include "power.h"
+#include "safe_strings.h"
+#include "sensors.h"
+#include "state_manager.h"
+
+using namespace ui;
+
+static float c_to_f(float c) {
+  return c * 9.0f / 5.0f + 32.0f;
+}
+
+static RenderModel g_current;
+static bool g_current_valid = false;
+
+void render_model_snapshot(RenderModel& m, const InsideReadings& ir, const BatteryStatus& bs) {
+  for (int f = 0; f < FIELD__COUNT; ++f) {
+    m.value[f] = NAN;
+    m.decimals[f] = 0;
+    m.text[f] = nullptr;
+  }
+
+  OutsideReadings o = net_get_outside();
+  m.battery = bs;
+  net_ip_cstr(m.ip, sizeof(m.ip));
+  net_time_hhmm(m.time_hhmm, sizeof(m.time_hhmm));
+  safe_strcpy(m.weather, o.validWeather ? o.weather : "");
+  m.short_condition[0] = '\0';
+  if (m.weather[0]) make_short_condition_cstr(m.weather, m.short_condition, sizeof(m.short_condition));
+
+  m.text[FIELD_ROOM_NAME] = ROOM_NAME;
+  m.text[FIELD_FW_VERSION] = FW_VERSION;
+  m.text[FIELD_IP] = m.ip;
+  m.text[FIELD_TIME_HHMM] = m.time_hhmm;
+  m.text[FIELD_WEATHER] = m.weather;
+
+  m.value[FIELD_INSIDE_TEMP_F] = std::isfinite(ir.temperatureC) ? c_to_f(ir.temperatureC) : NAN;
+  m.value[FIELD_INSIDE_HUM_PCT] = ir.humidityPct;
+  m.value[FIELD_PRESSURE_HPA] = ir.pressureHPa;
+  m.decimals[FIELD_PRESSURE_HPA] = 1;
+
+  // 24 h high/low (inside_stats.h); "--" until the window has a sample
+  #if FEATURE_INSIDE_STATS
+  RollingSummary day;
+  if (inside_stats_get(INSIDE_STATS_LONG, ROLL_TEMP, day)) {
+    m.value[FIELD_INSIDE_HI_F] = c_to_f(day.hi);
+    m.value[FIELD_INSIDE_LO_F] = c_to_f(day.lo);
+  }
+  #endif
+
+  // Outside temperature falls back to the last value seen on a previous wake
+  if (o.validTemp && std::isfinite(o.temperatureC)) {
+    m.value[FIELD_OUTSIDE_TEMP_F] = c_to_f(o.temperatureC);
+  } else {
+    m.value[FIELD_OUTSIDE_TEMP_F] = get_last_outside_f();
+  }
+  m.value[FIELD_OUTSIDE_HUM_PCT] = o.validHum ? o.humidityPct : NAN;
+  m.value[FIELD_WIND_MPS] = o.validWind ? o.windMps : NAN;
+  m.decimals[FIELD_WIND_MPS] = 1;
+  // FIELD_OUTSIDE_PRESSURE_HPA: not carried by OutsideReadings, renders "--"
+
+  m.value[FIELD_BATTERY_VOLTAGE] = bs.voltage;
+  m.decimals[FIELD_BATTERY_VOLTAGE] = 2;
+  m.value[FIELD_BATTERY_PERCENT] = bs.percent >= 0 ? (float)bs.percent : NAN;
+  m.value[FIELD_DAYS] = bs.estimatedDays >= 0 ? (float)bs.estimatedDays : NAN;
+  m.battery_pct = (bs.percent > 100) ? 100 : ((bs.percent < 0) ? 0 : bs.percent);
+
+  m.has_icon = m.weather[0] != '\0';
+  m.icon = m.has_icon ? map_openweather_to_icon(o) : IconId();
+
+  // Default formatting, done once; ops at the default precision copy it
+  for (int f = 0; f < FIELD__COUNT; ++f) {
+    float v = m.value[f];
+    if (m.text[f] || !std::isfinite(v)) {
+      memcpy(m.formatted[f], "--", 3);
+    } else {
+      snprintf(m.formatted[f], RENDER_MODEL_VALUE_LEN, "%.*f", m.decimals[f], v);
+    }
+  }
+}
+
+void render_model_snapshot(RenderModel& m) {
+  render_model_snapshot(m, read_inside_sensors(), read_battery_status());
+}
+
+void render_model_capture(const InsideReadings& inside, const BatteryStatus& battery) {
+  render_model_snapshot(g_current, inside, battery);
+  g_current_valid = true;
+}
+
+const RenderModel& render_model_current() {
+  if (!g_current_valid) {
+    render_model_snapshot(g_current);
+    g_current_valid = true;
+  }
+  return g_current;
+}
+
+#endif  // USE_DISPLAY
@@ -0,0 +1,87 @@
+#pragma once
+
+// Render model shared by the spec and legacy renderers
+// An immutable snapshot of every field the display binds (ui::FieldId),
+// filled once per wake after the sensor and network phases from the
+// readings those phases already took. Numbers are formatted once into fixed
+// arrays. Renderers resolve fields by array index, with no sensor, fuel
+// gauge or network reads and no key string compares while drawing.
+//
+// Usage:
+//   render_model_capture(wake_readings, wake_battery);   // app_controller
+//   const RenderModel& model = render_model_current();    // renderers
+//   char text[64];
+//   render_model_expand(model, op.segs, op.seg_count, text, sizeof(text));
+
+#include "config.h"
+
+#if USE_DISPLAY
+
+#include <cstddef>
+#include <cstdint>
+#include "icons.h"
+#include "power.h"
+#include "sensors.h"
+#include "ui_ops_generated.h"
+
+static constexpr size_t RENDER_MODEL_VALUE_LEN = 12;
+
+struct RenderModel {
+  float value[ui::FIELD__COUNT];       // Numeric fields (NAN = unavailable)
+  int8_t decimals[ui::FIELD__COUNT];   // Precision when the template gives none
+  const char* text[ui::FIELD__COUNT];  // Text fields (nullptr = numeric field)
+  char formatted[ui::FIELD__COUNT][RENDER_MODEL_VALUE_LEN];  // value at decimals, or "--"
+
+  int battery_pct;                     // Clamped to 0-100 for the glyph
+  bool has_icon;
+  IconId icon;
+
+  char ip[32];
+  char time_hhmm[8];
+  char weather[64];
+  char short_condition[24];            // Footer form of weather
+  BatteryStatus battery;
+
+  RenderModel() = default;
+  // text[] may point into this object
+  RenderModel(const RenderModel&) = delete;
+  RenderModel& operator=(const RenderModel&) = delete;
+};
+
+// Fill the model from this wake's inside readings and battery status plus
+// the outside data, IP and clock (all already in RAM)
+void render_model_snapshot(RenderModel& m, const InsideReadings& inside,
+                           const BatteryStatus& battery);
+
+// As above, but reads the sensors and fuel gauge itself
+void render_model_snapshot(RenderModel& m);
+
+// Fill this wake's shared model; call once the network phase is done
+void render_model_capture(const InsideReadings& inside, const BatteryStatus& battery);
+
+// This wake's shared model; read from the sources if nothing captured it
+const RenderModel& render_model_current();
+
+// Hash of everything the model renders ("did anything change?")
+uint32_t render_model_hash(const RenderModel& m);
+
+// Format one field ("--" when unavailable); decimals < 0 = field default.
+// Returns the length written.
+size_t render_model_format(const RenderModel& m, uint8_t field, uint8_t conv,
+                           int8_t decimals, char* out, size_t out_size);
+
+// Expand a pre-parsed text template; returns the length written
+size_t render_model_expand(const RenderModel& m, const ui::UiTextSeg* segs, uint8_t count,
+                           char* out, size_t out_size);
+
+// Text a spec op draws: its template expanded, or s0 verbatim if it has none
+size_t render_model_op_text(const ui::UiOpHeader& op, const RenderModel& m, char* out,
+                            size_t out_size);
+
+// Content hash per RectId of everything the variant's ops would draw into
+// each rect, so a rect whose hash is unchanged since the last refresh can
+// be left alone
+void render_model_rect_hashes(uint8_t variantId, const RenderModel& m, uint32_t* out,
+                              size_t count);
+
+#endif  // USE_DISPLAY
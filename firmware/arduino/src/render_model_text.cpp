@@ -0,0 +1,125 @@
+// Render model field formatting and per-rect content hashes
+// Split from render_model.cpp: nothing here reads sensors, the network or
+// the panel, so the spec op walk also builds on the host (test/bench_core).
+#include "render_model.h"
+
+#if USE_DISPLAY
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "display_smart_refresh.h"
+
+using namespace ui;
+
+// Copy with truncation; returns the length written
+static size_t copy_text(char* out, size_t out_size, const char* s) {
+  size_t n = strlen(s);
+  if (n >= out_size) n = out_size - 1;
+  memcpy(out, s, n);
+  out[n] = '\0';
+  return n;
+}
+
+uint32_t render_model_hash(const RenderModel& m) {
+  uint32_t h = SmartRefresh::HASH_SEED;
+  for (int f = 0; f < FIELD__COUNT; ++f) {
+    h = m.text[f] ? SmartRefresh::hashString(m.text[f], h)
+                  : SmartRefresh::hashString(m.formatted[f], h);
+  }
+  h = SmartRefresh::hashBytes(&m.battery_pct, sizeof(m.battery_pct), h);
+  h = SmartRefresh::hashBytes(&m.has_icon, sizeof(m.has_icon), h);
+  h = SmartRefresh::hashBytes(&m.icon, sizeof(m.icon), h);
+  return h;
+}
+
+size_t render_model_format(const RenderModel& m, uint8_t field, uint8_t conv,
+                           int8_t decimals, char* out, size_t out_size) {
+  if (!out || out_size == 0) return 0;
+  out[0] = '\0';
+  if (field >= FIELD__COUNT) return 0;
+
+  if (m.text[field]) {
+    return copy_text(out, out_size, m.text[field]);
+  }
+
+  if (conv == CONV_NONE && (decimals < 0 || decimals == m.decimals[field])) {
+    return copy_text(out, out_size, m.formatted[field]);
+  }
+
+  float v = m.value[field];
+  if (conv == CONV_MPS_TO_MPH) v *= 2.237f;
+  if (!std::isfinite(v)) {
+    return copy_text(out, out_size, "--");
+  }
+  int d = decimals >= 0 ? decimals : m.decimals[field];
+  int n = snprintf(out, out_size, "%.*f", d, v);
+  if (n < 0) return 0;
+  return (size_t)n < out_size ? (size_t)n : out_size - 1;
+}
+
+size_t render_model_expand(const RenderModel& m, const UiTextSeg* segs, uint8_t count,
+                           char* out, size_t out_size) {
+  if (!out || out_size == 0) return 0;
+  size_t len = 0;
+  out[0] = '\0';
+  for (uint8_t i = 0; i < count && len + 1 < out_size; ++i) {
+    const UiTextSeg& seg = segs[i];
+    if (seg.lit) len += copy_text(out + len, out_size - len, seg.lit);
+    if (seg.field != FIELD_NONE && len + 1 < out_size) {
+      len += render_model_format(m, seg.field, seg.conv, seg.decimals, out + len, out_size - len);
+    }
+  }
+  return len;
+}
+
+size_t render_model_op_text(const UiOpHeader& op, const RenderModel& m, char* out,
+                            size_t out_size) {
+  if (op.segs) return render_model_expand(m, op.segs, op.seg_count, out, out_size);
+  snprintf(out, out_size, "%s", op.s0 ? op.s0 : "");
+  return strlen(out);
+}
+
+void render_model_rect_hashes(uint8_t variantId, const RenderModel& m, uint32_t* out, size_t count) {
+  for (size_t i = 0; i < count; ++i) out[i] = SmartRefresh::HASH_SEED;
+
+  int comp_count = 0;
+  const ui::ComponentOps* comps = ui::get_variant_ops(variantId, &comp_count);
+  for (int ci = 0; ci < comp_count; ++ci) {
+    const ui::ComponentOps& co = comps[ci];
+    for (int i = 0; i < co.count; ++i) {
+      const ui::UiOpHeader& op = co.ops[i];
+      if (op.rect >= count) continue;  // Chrome (rect 255) never changes
+      uint32_t& h = out[op.rect];
+      char buf[64];
+      h = SmartRefresh::hashBytes(&op.kind, 1, h);
+      switch (op.kind) {
+        case ui::OP_TEXT:
+        case ui::OP_TEXTCENTEREDIN:
+          render_model_op_text(op, m, buf, sizeof(buf));
+          h = SmartRefresh::hashString(buf, h);
+          break;
+        case ui::OP_TIMERIGHT:
+          render_model_format(m, op.field, ui::CONV_NONE, -1, buf, sizeof(buf));
+          h = SmartRefresh::hashString(buf, h);
+          break;
+        case ui::OP_TEMPGROUPCENTERED:
+          render_model_format(m, op.field, ui::CONV_NONE, static_cast<int8_t>(op.p1), buf,
+                              sizeof(buf));
+          h = SmartRefresh::hashString(buf, h);
+          break;
+        case ui::OP_ICONIN:
+          h = SmartRefresh::hashBytes(&m.has_icon, sizeof(m.has_icon), h);
+          h = SmartRefresh::hashBytes(&m.icon, sizeof(m.icon), h);
+          break;
+        case ui::OP_BATTERYGLYPH:
+          h = SmartRefresh::hashBytes(&m.battery_pct, sizeof(m.battery_pct), h);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+#endif  // USE_DISPLAY
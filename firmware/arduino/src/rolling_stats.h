@@ -0,0 +1,156 @@
+#pragma once
+
+// Rolling min/max/mean of the inside readings over fixed windows
+// A window is a ring of B time buckets, each span_sec wide, holding the
+// low, high, sum and count of every quantity sampled in it (temperature,
+// RH, pressure). A sample lands in the bucket of its time slot; moving into
+// a later slot clears the buckets skipped over, so the ring always covers
+// the last B slots. Summaries fold the buckets still inside the window at
+// the time asked, so a sensor that stopped sampling for hours reports an
+// empty window rather than stale extremes. One push per wake costs a few
+// integer operations; the ring is plain data for RTC memory.
+//
+// Values are stored as int16 fixed point (temperature and RH in 1/100,
+// pressure in 1/10 hPa), the same scaling as the telemetry frame.
+//
+// Usage:
+//   rolling_push(w, now_sec, 3600 / ROLLING_SHORT_BUCKETS, tempC, rhPct, pressHPa);
+//   RollingSummary s;
+//   if (rolling_summary(w, now_sec, ROLL_TEMP, s)) draw(s.lo, s.hi);
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+static constexpr size_t ROLLING_SHORT_BUCKETS = 6;    // 1 h window: 10 min buckets
+static constexpr size_t ROLLING_LONG_BUCKETS = 24;    // 24 h window: 1 h buckets
+
+enum RollingQty : uint8_t {
+  ROLL_TEMP = 0,
+  ROLL_RH,
+  ROLL_PRESS,
+  ROLL__COUNT
+};
+
+inline float rolling_scale(uint8_t q) {
+  return q == ROLL_PRESS ? 10.0f : 100.0f;
+}
+
+struct RollingBucket {
+  int16_t lo[ROLL__COUNT];
+  int16_t hi[ROLL__COUNT];
+  int32_t sum[ROLL__COUNT];
+  uint8_t n[ROLL__COUNT];     // Saturates at 255 (sum stops with it)
+  uint8_t reserved;
+};
+
+static_assert(sizeof(RollingBucket) == 28, "RollingBucket layout");
+
+template <size_t B>
+struct RollingWindow {
+  uint32_t span_sec;          // Bucket width; 0 = never used
+  uint32_t head_slot;         // Time slot (now / span_sec) of the newest bucket
+  uint8_t head;               // Index of the newest bucket
+  uint8_t reserved[3];
+  RollingBucket bucket[B];
+};
+
+struct RollingSummary {
+  float lo;
+  float hi;
+  float mean;
+  uint16_t n;                 // Samples folded in
+};
+
+inline void rolling_clear_bucket(RollingBucket& b) {
+  b = RollingBucket();
+}
+
+template <size_t B>
+inline void rolling_reset(RollingWindow<B>& w, uint32_t span_sec) {
+  w = RollingWindow<B>();
+  w.span_sec = span_sec;
+}
+
+inline bool rolling_fixed(float v, float scale, int16_t& out) {
+  if (!std::isfinite(v)) return false;
+  float s = std::round(v * scale);
+  if (s < -32767.0f || s > 32767.0f) return false;
+  out = (int16_t)s;
+  return true;
+}
+
+// Add one wake's readings at now_sec (any monotonic-ish seconds clock, e.g.
+// epoch); NaN readings are skipped. A changed span_sec restarts the window.
+template <size_t B>
+inline void rolling_push(RollingWindow<B>& w, uint32_t now_sec, uint32_t span_sec,
+                         float tempC, float rhPct, float pressHPa) {
+  if (span_sec == 0) return;
+  if (w.span_sec != span_sec || w.head >= B) rolling_reset(w, span_sec);
+
+  uint32_t slot = now_sec / span_sec;
+  size_t idx;
+  if (w.head_slot == 0 || slot >= w.head_slot + B) {
+    // First sample, or the whole window has gone by
+    for (size_t i = 0; i < B; i++) rolling_clear_bucket(w.bucket[i]);
+    w.head = 0;
+    w.head_slot = slot;
+    idx = 0;
+  } else if (slot > w.head_slot) {
+    for (uint32_t s = w.head_slot; s < slot; s++) {
+      w.head = (uint8_t)((w.head + 1) % B);
+      rolling_clear_bucket(w.bucket[w.head]);
+    }
+    w.head_slot = slot;
+    idx = w.head;
+  } else {
+    // Same slot, or the clock stepped back within the window
+    uint32_t age = w.head_slot - slot;
+    if (age >= B) return;
+    idx = (w.head + B - age) % B;
+  }
+
+  const float v[ROLL__COUNT] = {tempC, rhPct, pressHPa};
+  RollingBucket& b = w.bucket[idx];
+  for (uint8_t q = 0; q < ROLL__COUNT; q++) {
+    int16_t x;
+    if (!rolling_fixed(v[q], rolling_scale(q), x) || b.n[q] == 0xFF) continue;
+    if (b.n[q] == 0 || x < b.lo[q]) b.lo[q] = x;
+    if (b.n[q] == 0 || x > b.hi[q]) b.hi[q] = x;
+    b.sum[q] += x;
+    b.n[q]++;
+  }
+}
+
+// Low, high and mean of quantity q over the buckets still inside the window
+// at now_sec; false when it holds no samples
+template <size_t B>
+inline bool rolling_summary(const RollingWindow<B>& w, uint32_t now_sec, uint8_t q,
+                            RollingSummary& out) {
+  out = RollingSummary();
+  if (w.span_sec == 0 || w.head_slot == 0 || q >= ROLL__COUNT || w.head >= B) return false;
+  uint32_t now_slot = now_sec / w.span_sec;
+
+  int16_t lo = 0, hi = 0;
+  int64_t sum = 0;
+  uint32_t n = 0;
+  for (size_t age = 0; age < B; age++) {
+    if (age > w.head_slot) break;
+    uint32_t slot = w.head_slot - (uint32_t)age;
+    if (slot + B <= now_slot) break;          // Older buckets have left the window too
+    const RollingBucket& b = w.bucket[(w.head + B - age) % B];
+    if (b.n[q] == 0) continue;
+    if (n == 0 || b.lo[q] < lo) lo = b.lo[q];
+    if (n == 0 || b.hi[q] > hi) hi = b.hi[q];
+    sum += b.sum[q];
+    n += b.n[q];
+  }
+  if (n == 0) return false;
+
+  float scale = rolling_scale(q);
+  out.lo = lo / scale;
+  out.hi = hi / scale;
+  out.mean = (float)((double)sum / n / scale);
+  out.n = n > 0xFFFF ? 0xFFFF : (uint16_t)n;
+  return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+// Versioned, CRC-sealed RTC memory block
+// A block starts with a header naming its layout version, size and the
+// firmware image that wrote it, plus a CRC over the body. The CRC is written
+// once right before deep sleep (rtc_block_seal) and checked once at wake, so
+// a deep-sleep wake either gets back exactly what was sealed or starts fresh.
+// Warm resets (panic, watchdog, esp_restart) happen between seals and cannot
+// carry a valid CRC; for those only the header is checked.
+//
+// Usage:
+//   struct MyState { RtcBlockHeader header; uint32_t counter; };
+//   RTC_DATA_ATTR MyState s;
+//   RtcBlockStatus st = rtc_block_check(s.header, &s, sizeof(s), 1, image_tag,
+//                                       woke_from_deep_sleep, crc_fn);
+//   if (!rtc_block_usable(st)) { reset_defaults(s); rtc_block_init(s.header, sizeof(s), 1, image_tag); }
+//   ...
+//   rtc_block_seal(s.header, &s, sizeof(s), crc_fn);     // Just before deep sleep
+//
+// crc_fn is any callable uint32_t(const uint8_t*, size_t), e.g. fast_crc32.
+
+#include <cstddef>
+#include <cstdint>
+
+static constexpr uint32_t RTC_BLOCK_MAGIC = 0x52544331;   // "RTC1"
+
+struct RtcBlockHeader {
+    uint32_t magic;
+    uint16_t version;       // Layout version; bump when fields move
+    uint16_t size;          // sizeof the whole block
+    uint32_t image_tag;     // Firmware image that wrote the block
+    uint32_t crc;           // Over the body (everything after the header)
+};
+
+enum RtcBlockStatus : uint8_t {
+    RTC_BLOCK_VALID = 0,    // Sealed and intact
+    RTC_BLOCK_UNSEALED,     // Warm reset: header matches, body taken as-is
+    RTC_BLOCK_EMPTY,        // Never written (cold boot)
+    RTC_BLOCK_LAYOUT,       // Written by a different layout version or size
+    RTC_BLOCK_IMAGE,        // Written by different firmware
+    RTC_BLOCK_CORRUPT       // Body does not match the sealed CRC
+};
+
+inline bool rtc_block_usable(RtcBlockStatus s) {
+    return s == RTC_BLOCK_VALID || s == RTC_BLOCK_UNSEALED;
+}
+
+inline const char* rtc_block_status_name(RtcBlockStatus s) {
+    switch (s) {
+        case RTC_BLOCK_VALID: return "valid";
+        case RTC_BLOCK_UNSEALED: return "unsealed";
+        case RTC_BLOCK_EMPTY: return "empty";
+        case RTC_BLOCK_LAYOUT: return "layout";
+        case RTC_BLOCK_IMAGE: return "image";
+        case RTC_BLOCK_CORRUPT: return "corrupt";
+    }
+    return "?";
+}
+
+template <typename Crc>
+inline uint32_t rtc_block_body_crc(const void* block, size_t size, Crc crc) {
+    if (size <= sizeof(RtcBlockHeader)) return 0;
+    return crc((const uint8_t*)block + sizeof(RtcBlockHeader), size - sizeof(RtcBlockHeader));
+}
+
+inline void rtc_block_init(RtcBlockHeader& h, size_t size, uint16_t version, uint32_t image_tag) {
+    h.magic = RTC_BLOCK_MAGIC;
+    h.version = version;
+    h.size = (uint16_t)size;
+    h.image_tag = image_tag;
+    h.crc = 0;
+}
+
+// require_seal: the previous wake ended in deep sleep, so the CRC must match
+template <typename Crc>
+inline RtcBlockStatus rtc_block_check(const RtcBlockHeader& h, const void* block, size_t size,
+                                      uint16_t version, uint32_t image_tag, bool require_seal,
+                                      Crc crc) {
+    if (h.magic != RTC_BLOCK_MAGIC) return RTC_BLOCK_EMPTY;
+    if (h.version != version || h.size != size) return RTC_BLOCK_LAYOUT;
+    if (h.image_tag != image_tag) return RTC_BLOCK_IMAGE;
+    if (!require_seal) return RTC_BLOCK_UNSEALED;
+    return rtc_block_body_crc(block, size, crc) == h.crc ? RTC_BLOCK_VALID : RTC_BLOCK_CORRUPT;
+}
+
+template <typename Crc>
+inline void rtc_block_seal(RtcBlockHeader& h, const void* block, size_t size, Crc crc) {
+    h.crc = rtc_block_body_crc(block, size, crc);
+}
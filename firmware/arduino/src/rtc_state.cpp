@@ -0,0 +1,74 @@
+#include "rtc_state.h"
+#include "system_manager.h"  // fast_crc32
+#include <esp_ota_ops.h>
+#include <esp_sleep.h>
+#include <cmath>
+#include <cstring>
+
+// RTC memory - persists across deep sleep
+RTC_DATA_ATTR RtcState g_rtc_state = {};
+
+static RtcBlockStatus s_status = RTC_BLOCK_EMPTY;
+
+// Section bounds from the IDF linker script
+extern "C" char _rtc_data_start, _rtc_data_end, _rtc_bss_start, _rtc_bss_end;
+
+static uint32_t crc_fn(const uint8_t* data, size_t len) {
+  return fast_crc32(data, len);
+}
+
+// Identifies the running firmware image (same tag LogBuffer keys on)
+static uint32_t current_image_tag() {
+  const esp_app_desc_t* desc = esp_ota_get_app_description();
+  uint32_t tag;
+  memcpy(&tag, desc->app_elf_sha256, sizeof(tag));
+  return tag;
+}
+
+void rtc_state_reset() {
+  memset(&g_rtc_state, 0, sizeof(g_rtc_state));
+  rtc_block_init(g_rtc_state.header, sizeof(g_rtc_state), RTC_STATE_VERSION, current_image_tag());
+  g_rtc_state.last_tx_inside_tempC = NAN;
+  g_rtc_state.last_tx_inside_rh = NAN;
+  g_rtc_state.last_tx_inside_pressureHPa = NAN;
+  g_rtc_state.last_inside_f = NAN;
+  g_rtc_state.last_inside_rh = NAN;
+  g_rtc_state.last_outside_f = NAN;
+  g_rtc_state.last_outside_rh = NAN;
+  g_rtc_state.last_icon_id = -1;
+  g_rtc_state.last_published_inside_tempC = NAN;
+  g_rtc_state.last_published_inside_rh = NAN;
+  g_rtc_state.last_published_inside_pressureHPa = NAN;
+  g_rtc_state.needs_full_on_boot = 1;
+  g_rtc_state.last_reset_reason = ESP_RST_UNKNOWN;
+}
+
+RtcBlockStatus rtc_state_begin() {
+  bool from_deep_sleep = esp_reset_reason() == ESP_RST_DEEPSLEEP;
+  s_status = rtc_block_check(g_rtc_state.header, &g_rtc_state, sizeof(g_rtc_state),
+                             RTC_STATE_VERSION, current_image_tag(), from_deep_sleep, crc_fn);
+  if (!rtc_block_usable(s_status)) {
+    rtc_state_reset();
+    if (s_status == RTC_BLOCK_CORRUPT) g_rtc_state.errors.rtc_memory_corruptions++;
+  }
+  return s_status;
+}
+
+RtcBlockStatus rtc_state_status() {
+  return s_status;
+}
+
+void rtc_state_seal() {
+  rtc_block_seal(g_rtc_state.header, &g_rtc_state, sizeof(g_rtc_state), crc_fn);
+}
+
+void rtc_state_format_json(char* out, size_t out_size) {
+  size_t data = (size_t)(&_rtc_data_end - &_rtc_data_start);
+  size_t bss = (size_t)(&_rtc_bss_end - &_rtc_bss_start);
+  snprintf(out, out_size,
+           "{\"status\":\"%s\",\"version\":%u,\"state_bytes\":%u,\"rtc_data\":%u,"
+           "\"rtc_bss\":%u,\"rtc_used\":%u,\"rtc_capacity\":%u}",
+           rtc_block_status_name(s_status), (unsigned)RTC_STATE_VERSION,
+           (unsigned)sizeof(g_rtc_state), (unsigned)data, (unsigned)bss,
+           (unsigned)(data + bss), (unsigned)RTC_SLOW_MEM_BYTES);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <Arduino.h>
+#include "rtc_block.h"
+#include "bme280_core.h"
+#include "trend_model.h"
+#include "rolling_stats.h"
+#include "ntp_schedule.h"
+#include "remote_config.h"
+#include "metrics_diagnostics.h"
+#include "memory_tracking.h"
+#include "diag_document.h"
+#include "display_smart_refresh.h"
+#include "wifi_link_adapt.h"
+
+// Consolidated RTC state
+// Every small piece of state that survives deep sleep (wake and boot
+// counters, the skip-network baseline, display change-detection CRCs, error
+// and memory stats) lives in one versioned block with a single CRC
+// (rtc_block.h). rtc_state_begin() checks it once at wake and falls back to
+// defaults in one step on corruption or a firmware change; the deep-sleep
+// path seals it last thing before esp_deep_sleep_start().
+//
+// Fields are ordered hot-first (read on every wake before the network comes
+// up), then diagnostics, and grouped by width so the struct has no padding.
+// Bump RTC_STATE_VERSION whenever a field is added, removed or moved.
+//
+// Large rings with their own headers (log buffer, wake timeline, offline
+// queue, energy and profiling history) and the crash record stay separate:
+// the crash record and logs must survive a panic between seals, and the rings
+// are too big to CRC on every wake.
+
+static constexpr uint16_t RTC_STATE_VERSION = 11;
+static constexpr size_t RTC_SLOW_MEM_BYTES = 8192;     // ESP32-S2 RTC slow memory
+
+struct RtcState {
+  RtcBlockHeader header;
+
+  // Hot: boot path and skip-network decision
+  uint32_t wake_count;
+  uint32_t boot_count;
+  uint32_t sec_since_last_tx;
+  float last_tx_inside_tempC;
+  float last_tx_inside_rh;
+  float last_tx_inside_pressureHPa;
+
+  // Sensor driver: BME280 calibration and applied register settings
+  Bme280Cache bme280;
+
+  // RSSI and attempts of the last connects, for link tuning (wifi_link_adapt.h)
+  WifiLinkHistory wifi_link;
+
+  // Display change detection
+  float last_inside_f;
+  float last_inside_rh;
+  float last_outside_f;
+  float last_outside_rh;
+  int32_t last_icon_id;
+  uint32_t last_footer_weather_crc;
+  uint32_t last_status_crc;
+  uint32_t last_model_hash;           // render_model_hash() of the frame on the panel
+  SmartRefresh::Snapshot rect_hashes; // Per-RectId hashes of that frame
+
+  // Publish change detection
+  float last_published_inside_tempC;
+  float last_published_inside_rh;
+  float last_published_inside_pressureHPa;
+
+  // Adaptive sleep: per-wake temperature history
+  TrendHistory trend;
+
+  // Inside min/max/mean over the short and long windows (inside_stats.h)
+  RollingWindow<ROLLING_SHORT_BUCKETS> stats_short;
+  RollingWindow<ROLLING_LONG_BUCKETS> stats_long;
+
+  // Clock drift and NTP schedule
+  NtpSchedule ntp;
+
+  // Overrides from the retained config document (remote_config.h)
+  RemoteConfig config;
+
+  uint16_t partial_counter;
+  uint16_t wakes_since_last_tx;
+  uint8_t needs_full_on_boot;
+  uint8_t model_hash_valid;           // last_model_hash describes the panel
+  uint8_t ui_variant;                 // VariantId of the frame on the panel
+  uint8_t reserved[1];
+
+  // Diagnostics
+  uint32_t crash_count;
+  uint32_t cumulative_uptime_sec;
+  uint32_t last_boot_timestamp;
+  int32_t last_reset_reason;          // esp_reset_reason_t
+  DiagDocState diag;                  // Last delivered diagnostics document
+  ErrorStats errors;
+  MemoryTracker::MemoryStats memory;
+};
+
+static_assert(sizeof(RtcState) % 4 == 0, "RtcState must not leave tail padding");
+static_assert(sizeof(RtcState) <= 0xFFFF, "RtcState size must fit the header");
+
+// RTC memory storage (persists across deep sleep)
+extern RTC_DATA_ATTR RtcState g_rtc_state;
+
+// Validate the block once at wake; resets it to defaults unless usable
+RtcBlockStatus rtc_state_begin();
+
+// Status from rtc_state_begin()
+RtcBlockStatus rtc_state_status();
+
+// Back to defaults (keeps the header valid)
+void rtc_state_reset();
+
+// Write the CRC; call immediately before esp_deep_sleep_start()
+void rtc_state_seal();
+
+// {"status":"valid","version":1,"state_bytes":152,"rtc_data":..,"rtc_bss":..,"rtc_used":..,"rtc_capacity":8192}
+void rtc_state_format_json(char* out, size_t out_size);
@@ -0,0 +1,48 @@
+#pragma once
+
+// Sensor driver interface
+// A driver splits one measurement into start and collect so the scheduler
+// (sensor_scheduler.h) can run every sensor's conversion at the same time:
+// begin() once per wake (cheap when the sensor kept its setup through deep
+// sleep), startConversion(), then readResult() once conversionTimeUs() has
+// passed. readResult() fills only the fields that sensor measures.
+//
+// Usage:
+//   class Sht40Driver : public SensorDriver {
+//   public:
+//       const char* name() const override { return "sensor_sht40"; }
+//       bool begin() override { ... }
+//       bool startConversion() override { return write_cmd(0xFD); }
+//       uint32_t conversionTimeUs() const override { return 8300; }
+//       bool readResult(InsideReadings& out) override { ... out.humidityPct = rh; ... }
+//   };
+
+#include <cmath>
+#include <cstdint>
+
+// Sensor reading structure
+struct InsideReadings {
+    float temperatureC = NAN;
+    float humidityPct = NAN;
+    float pressureHPa = NAN;
+};
+
+class SensorDriver {
+public:
+    virtual ~SensorDriver() {}
+
+    // Static lifetime; also the name the driver's timing is profiled under
+    virtual const char* name() const = 0;
+
+    // Probe and configure; false when the sensor is absent
+    virtual bool begin() = 0;
+
+    // Trigger one conversion; false on a bus error
+    virtual bool startConversion() = 0;
+
+    // Worst-case time from startConversion() until a result can be read
+    virtual uint32_t conversionTimeUs() const = 0;
+
+    // Collect the conversion; false means the sensor needs begin() again
+    virtual bool readResult(InsideReadings& out) = 0;
+};
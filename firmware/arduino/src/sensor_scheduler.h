@@ -0,0 +1,135 @@
+#pragma once
+
+// Parallel sensor read scheduler
+// Starts every ready driver's conversion at once and collects results in the
+// order they become due, so the sensor phase costs the slowest conversion
+// rather than the sum of all of them. A driver still converting when the
+// caller stops collecting (a 5 s CO2 measurement against a 300 ms sensor
+// budget) stays pending: it is not restarted, and a later collect() picks
+// its result up. A failed start or read sends the driver back through
+// begin() on the next beginAll().
+//
+// Usage:
+//   SensorScheduler sched;
+//   sched.add(&bme280);
+//   sched.beginAll();
+//   sched.startAll(now_us());
+//   uint32_t due;
+//   while (sched.nextDue(due) && before_deadline()) {
+//       wait_until(due);
+//       sched.collect(now_us(), readings, [](const char* name, uint32_t us, bool ok) { ... });
+//   }
+//
+// Times are a free-running 32-bit microsecond clock; comparisons are
+// wrap-safe. Not thread-safe: one task drives the scheduler.
+
+#include <cstddef>
+#include <cstdint>
+#include "sensor_driver.h"
+
+static constexpr size_t SENSOR_MAX_DRIVERS = 4;
+
+class SensorScheduler {
+public:
+    bool add(SensorDriver* driver) {
+        if (!driver || count_ >= SENSOR_MAX_DRIVERS) return false;
+        Slot& s = slots_[count_++];
+        s.driver = driver;
+        s.ready = false;
+        s.pending = false;
+        return true;
+    }
+
+    // begin() every driver that is not set up yet; returns how many are
+    size_t beginAll() {
+        size_t n = 0;
+        for (size_t i = 0; i < count_; i++) {
+            Slot& s = slots_[i];
+            if (!s.ready) s.ready = s.driver->begin();
+            if (s.ready) n++;
+        }
+        return n;
+    }
+
+    // Start a conversion on every ready driver that is not already
+    // converting; returns how many started
+    size_t startAll(uint32_t now_us) {
+        size_t n = 0;
+        for (size_t i = 0; i < count_; i++) {
+            Slot& s = slots_[i];
+            if (!s.ready || s.pending) continue;
+            if (!s.driver->startConversion()) {
+                s.ready = false;
+                continue;
+            }
+            s.pending = true;
+            s.started_us = now_us;
+            s.due_us = now_us + s.driver->conversionTimeUs();
+            n++;
+        }
+        return n;
+    }
+
+    // Earliest due time among pending conversions; false if none pending
+    bool nextDue(uint32_t& due_us) const {
+        bool any = false;
+        for (size_t i = 0; i < count_; i++) {
+            const Slot& s = slots_[i];
+            if (!s.pending) continue;
+            if (!any || (int32_t)(s.due_us - due_us) < 0) due_us = s.due_us;
+            any = true;
+        }
+        return any;
+    }
+
+    // Read every conversion due by now_us, earliest first, calling
+    // report(name, elapsed_us, ok) for each; returns how many were read
+    template <typename Report>
+    size_t collect(uint32_t now_us, InsideReadings& out, Report report) {
+        size_t n = 0;
+        for (;;) {
+            Slot* next = nullptr;
+            for (size_t i = 0; i < count_; i++) {
+                Slot& s = slots_[i];
+                if (!s.pending || (int32_t)(now_us - s.due_us) < 0) continue;
+                if (!next || (int32_t)(s.due_us - next->due_us) < 0) next = &s;
+            }
+            if (!next) return n;
+            next->pending = false;
+            bool ok = next->driver->readResult(out);
+            if (!ok) next->ready = false;
+            report(next->driver->name(), now_us - next->started_us, ok);
+            n++;
+        }
+    }
+
+    size_t pending() const {
+        size_t n = 0;
+        for (size_t i = 0; i < count_; i++) {
+            if (slots_[i].pending) n++;
+        }
+        return n;
+    }
+
+    size_t ready() const {
+        size_t n = 0;
+        for (size_t i = 0; i < count_; i++) {
+            if (slots_[i].ready) n++;
+        }
+        return n;
+    }
+
+    size_t size() const { return count_; }
+
+private:
+    struct Slot {
+        SensorDriver* driver;
+        bool ready;             // begin() succeeded and nothing failed since
+        bool pending;           // Conversion started, result not read yet
+        uint32_t started_us;
+        uint32_t due_us;
+    };
+
+    Slot slots_[SENSOR_MAX_DRIVERS] = {};
+    size_t count_ = 0;
+};
@@ -3,14 +3,22 @@
 
 #include "sensors.h"
 #include "profiling.h"
+#include "sensor_scheduler.h"
 #include <Wire.h>
 
 #if USE_BME280
+#if BME280_DIRECT
+#include "bme280_core.h"
+#include "rtc_state.h"
+#else
 #include <Adafruit_BME280.h>
+#endif
+#endif
 
 // Module-local variables
-static Adafruit_BME280 g_bme280;
-static bool g_bme280_initialized = false;
+static SensorScheduler g_sensors;
+static bool g_sensors_registered = false;
+static bool g_i2c_started = false;
 
 #if I2C_DEBUG_SCAN
 // Attempt to recover a stuck I2C bus by pulsing SCL when SDA is held low
@@ -37,10 +45,7 @@ static void i2c_bus_recover_if_stuck() {
 }
 #endif
 
-void sensors_begin() {
-  if (g_bme280_initialized)
-    return;
-    
+static void i2c_begin() {
   // Explicitly initialize I2C on known pins when available
 #if defined(SDA) && defined(SCL)
   Serial.printf("I2C: using pins SDA=%d SCL=%d\n", SDA, SCL);
@@ -56,7 +61,7 @@ void sensors_begin() {
   Wire.setTimeOut(I2C_TIMEOUT_MS > 0 ? I2C_TIMEOUT_MS : 50);
 #endif
   Wire.setClock(I2C_CLOCK_HZ);
-  
+
 #if I2C_DEBUG_SCAN
   Serial.println("I2C: scanning...");
   const uint8_t candidates[] = {0x76, 0x77};
@@ -71,44 +76,238 @@ void sensors_begin() {
     }
   }
 #endif
+}
 
-  // Try default I2C address 0x77 then 0x76
-  if (!g_bme280.begin(0x77) && !g_bme280.begin(0x76)) {
-    Serial.println("BME280 not found");
-    g_bme280_initialized = false;
-    return;
+#if USE_BME280
+#if BME280_DIRECT
+static bool bme280_write(uint8_t addr, uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  Wire.write(value);
+  return Wire.endTransmission() == 0;
+}
+
+// Register pointer write + repeated-start burst read
+static bool bme280_read(uint8_t addr, uint8_t reg, uint8_t* out, size_t len) {
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0)
+    return false;
+  if (Wire.requestFrom(addr, (uint8_t)len) != len)
+    return false;
+  for (size_t i = 0; i < len; i++) {
+    out[i] = (uint8_t)Wire.read();
+  }
+  return true;
+}
+
+// Register values for the configured oversampling / filter
+static void bme280_wanted(Bme280Cache& want) {
+  want.ctrl_hum = bme280_ctrl_hum(BME280_OSRS_H);
+  want.ctrl_meas = bme280_ctrl_meas(BME280_OSRS_T, BME280_OSRS_P, BME280_MODE_SLEEP);
+  want.config = bme280_config_reg(BME280_IIR_FILTER);
+}
+
+// Probe, reset, read calibration and write the settings; fills the RTC cache
+static bool bme280_configure(uint8_t addr, Bme280Cache& cache) {
+  uint8_t id = 0;
+  if (!bme280_read(addr, BME280_REG_CHIP_ID, &id, 1) || id != BME280_CHIP_ID)
+    return false;
+  if (!bme280_write(addr, BME280_REG_RESET, BME280_RESET_CMD))
+    return false;
+  // NVM calibration copy takes ~2 ms after reset; only paid on cold boot
+  uint8_t status = BME280_STATUS_IM_UPDATE;
+  for (int i = 0; i < 10 && (status & BME280_STATUS_IM_UPDATE); i++) {
+    delay(2);
+    if (!bme280_read(addr, BME280_REG_STATUS, &status, 1))
+      return false;
   }
-  
-  g_bme280.setSampling(Adafruit_BME280::MODE_FORCED,
-                       Adafruit_BME280::SAMPLING_X1, // temp
-                       Adafruit_BME280::SAMPLING_X1, // pressure
-                       Adafruit_BME280::SAMPLING_X1, // humidity
-                       Adafruit_BME280::FILTER_OFF);
-  g_bme280_initialized = true;
+  uint8_t tp[BME280_CALIB_TP_LEN];
+  uint8_t h[BME280_CALIB_H_LEN];
+  if (!bme280_read(addr, BME280_REG_CALIB_TP, tp, sizeof(tp)) ||
+      !bme280_read(addr, BME280_REG_CALIB_H, h, sizeof(h)))
+    return false;
+  Bme280Cache want = {};
+  bme280_wanted(want);
+  // ctrl_hum only takes effect on the following ctrl_meas write, and config
+  // is written while the sensor sleeps
+  if (!bme280_write(addr, BME280_REG_CTRL_HUM, want.ctrl_hum) ||
+      !bme280_write(addr, BME280_REG_CONFIG, want.config) ||
+      !bme280_write(addr, BME280_REG_CTRL_MEAS, want.ctrl_meas))
+    return false;
+  bme280_parse_calib(tp, h, want.calib);
+  want.addr = addr;
+  cache = want;
+  return true;
 }
 
+// Direct register driver: settings and calibration kept in RTC, forced mode
+// with one trigger write and one 8-byte burst read per sample
+class Bme280Driver : public SensorDriver {
+public:
+  const char* name() const override { return "sensor_bme280"; }
+
+  bool begin() override {
+    // Settings survive deep sleep in the sensor; RTC remembers what was written
+    Bme280Cache& cache = g_rtc_state.bme280;
+    Bme280Cache want = {};
+    bme280_wanted(want);
+    if (cache.addr != 0 && cache.ctrl_hum == want.ctrl_hum &&
+        cache.ctrl_meas == want.ctrl_meas && cache.config == want.config)
+      return true;
+    if (!bme280_configure(0x77, cache) && !bme280_configure(0x76, cache)) {
+      Serial.println("BME280 not found");
+      cache.addr = 0;
+      return false;
+    }
+    return true;
+  }
+
+  bool startConversion() override {
+    Bme280Cache& cache = g_rtc_state.bme280;
+    if (bme280_write(cache.addr, BME280_REG_CTRL_MEAS, cache.ctrl_meas | BME280_MODE_FORCED))
+      return true;
+    cache.addr = 0;
+    return false;
+  }
+
+  // Worst case for the configured oversampling (9.3 ms at x1)
+  uint32_t conversionTimeUs() const override {
+    return bme280_measure_time_us(BME280_OSRS_T, BME280_OSRS_P, BME280_OSRS_H);
+  }
+
+  // A configured channel reading back as skipped means the sensor lost its
+  // settings (power cycled while we slept); forget the cached setup so
+  // begin() reconfigures it
+  bool readResult(InsideReadings& r) override {
+    Bme280Cache& cache = g_rtc_state.bme280;
+    uint8_t data[BME280_DATA_LEN];
+    if (!bme280_read(cache.addr, BME280_REG_DATA, data, sizeof(data))) {
+      cache.addr = 0;
+      return false;
+    }
+    Bme280Reading b = bme280_compensate(cache.calib, data);
+    r.temperatureC = b.temperatureC;
+    r.humidityPct = b.humidityPct;
+    r.pressureHPa = b.pressureHPa;
+    if (!isfinite(b.temperatureC) || (BME280_OSRS_P && !isfinite(b.pressureHPa)) ||
+        (BME280_OSRS_H && !isfinite(b.humidityPct))) {
+      cache.addr = 0;
+      return false;
+    }
+    return true;
+  }
+};
 #else
-// No BME280, stub implementation
-void sensors_begin() { 
-  /* noop until SHT4x added */ 
+// Adafruit_BME280 library driver; takeForcedMeasurement() waits for the
+// conversion itself, so the result is due as soon as it returns
+class Bme280Driver : public SensorDriver {
+public:
+  const char* name() const override { return "sensor_bme280"; }
+
+  bool begin() override {
+    // Try default I2C address 0x77 then 0x76
+    if (!bme_.begin(0x77) && !bme_.begin(0x76)) {
+      Serial.println("BME280 not found");
+      return false;
+    }
+    bme_.setSampling(Adafruit_BME280::MODE_FORCED,
+                     Adafruit_BME280::SAMPLING_X1, // temp
+                     Adafruit_BME280::SAMPLING_X1, // pressure
+                     Adafruit_BME280::SAMPLING_X1, // humidity
+                     Adafruit_BME280::FILTER_OFF);
+    return true;
+  }
+
+  // Forced mode: trigger one measurement for low power
+  bool startConversion() override { return bme_.takeForcedMeasurement(); }
+
+  uint32_t conversionTimeUs() const override { return 0; }
+
+  bool readResult(InsideReadings& r) override {
+    r.temperatureC = bme_.readTemperature();
+    r.humidityPct = bme_.readHumidity();
+    // Adafruit_BME280::readPressure returns Pascals; convert to hPa for MQTT/HA
+    r.pressureHPa = bme_.readPressure() / 100.0f;
+    return isfinite(r.temperatureC);
+  }
+
+private:
+  Adafruit_BME280 bme_;
+};
+#endif
+
+static Bme280Driver g_bme280;
+#endif
+
+// Every compiled-in driver, registered once
+static void register_drivers() {
+  if (g_sensors_registered)
+    return;
+  g_sensors_registered = true;
+#if USE_BME280
+  g_sensors.add(&g_bme280);
+#endif
+  // Future: SHT40, SGP40, SCD41 drivers register here; a slow conversion
+  // (SCD41 single shot is 5 s) stays pending across phases instead of
+  // holding up the others
 }
+
+// Each driver's start-to-result time goes to the profiler under its name
+static void sensor_report(const char* name, uint32_t elapsed_us, bool ok) {
+#if PROFILING_ENABLED
+  PerformanceMonitor::getInstance().record(name, elapsed_us);
+#else
+  (void)elapsed_us;
 #endif
+  if (!ok)
+    Serial.printf("Sensor %s: read failed\n", name);
+}
+
+// Start every idle conversion at once and collect results as they come due.
+// Conversions due after budget_us are left running for a later call; the
+// waits are delay() so the radio task runs meanwhile.
+static void sensors_cycle(InsideReadings& r, uint32_t budget_us) {
+  uint32_t start = (uint32_t)micros();
+  g_sensors.startAll(start);
+  uint32_t due;
+  while (g_sensors.nextDue(due)) {
+    if (due - start > budget_us)
+      break;
+    int32_t wait_us = (int32_t)(due - (uint32_t)micros());
+    if (wait_us > 0)
+      delay(((uint32_t)wait_us + 999) / 1000);
+    g_sensors.collect((uint32_t)micros(), r, sensor_report);
+  }
+}
+
+void sensors_begin() {
+  register_drivers();
+  if (g_sensors.size() == 0 || g_sensors.ready() == g_sensors.size())
+    return;
+  if (!g_i2c_started) {
+    i2c_begin();
+    g_i2c_started = true;
+  }
+  g_sensors.beginAll();
+}
 
 InsideReadings read_inside_sensors() {
   PROFILE_SCOPE("read_inside_sensors");
   InsideReadings r;
-#if USE_BME280
   sensors_begin();
-  if (!g_bme280_initialized)
+  size_t ready = g_sensors.ready();
+  if (ready == 0)
     return r;
-    
-  // Forced mode: trigger one measurement for low power
-  g_bme280.takeForcedMeasurement();
-  r.temperatureC = g_bme280.readTemperature();
-  r.humidityPct = g_bme280.readHumidity();
-  // Adafruit_BME280::readPressure returns Pascals; convert to hPa for MQTT/HA
-  r.pressureHPa = g_bme280.readPressure() / 100.0f;
-#endif
+
+  const uint32_t budget_us = SENSOR_PHASE_TIMEOUT_MS * 1000UL;
+  sensors_cycle(r, budget_us);
+  // A driver that failed (e.g. a sensor that lost its settings) is set up
+  // again and sampled once more
+  if (g_sensors.ready() < ready) {
+    g_sensors.beginAll();
+    sensors_cycle(r, budget_us);
+  }
   return r;
 }
 
@@ -117,9 +316,9 @@ void sensors_init_all() {
   PROFILE_SCOPE("sensors_init_all");
   Serial.println("Initializing sensors...");
 
-  // Initialize I2C and BME280
+  // Initialize I2C and every registered driver
   sensors_begin();
-  
+
   // Read initial sensor values for diagnostics
   InsideReadings initial = read_inside_sensors();
   if (isfinite(initial.temperatureC)) {
@@ -128,31 +327,27 @@ void sensors_init_all() {
   } else {
     Serial.println("No sensor readings available");
   }
-  
-  // Future: Add other sensor initializations here
-  // - SHT40 support
-  // - SGP40 air quality sensor
-  // - SCD41 CO2 sensor
 }
 
 // Sensor phase with timeout protection
-InsideReadings read_sensors_with_timeout(uint32_t timeout_ms) {
+InsideReadings read_sensors_with_timeout(uint32_t timeout_ms, const volatile bool* cancel) {
   uint32_t start = millis();
   InsideReadings readings;
-  
+
   // Attempt to read sensors with timeout
-  while (millis() - start < timeout_ms) {
+  while (millis() - start < timeout_ms && !(cancel && *cancel)) {
     readings = read_inside_sensors();
     if (isfinite(readings.temperatureC)) {
       // Valid reading obtained
       break;
     }
+    // Only reached after a failed read: the conversion wait is in the read
     delay(10);
   }
-  
+
   if (!isfinite(readings.temperatureC)) {
     Serial.println("Sensor read timeout");
   }
-  
+
   return readings;
-}
\ No newline at end of file
+}
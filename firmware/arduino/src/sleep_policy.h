@@ -0,0 +1,52 @@
+#pragma once
+
+// Adaptive sleep interval policy
+// Battery tiers around the trend planner (trend_model.h): a critical battery
+// sleeps the fixed critical interval, a low one never wakes sooner than its
+// own interval, otherwise the expected change is allowed to reach the publish
+// deadband within [rapid_update, max]. Takes the readings as arguments so the
+// same planner runs on the device (power.cpp) and in the host soak replay
+// (test/soak_replay).
+//
+// Usage:
+//   uint32_t sec = sleep_plan_interval(config, battery_pct, trend_rate(h),
+//                                      policy.temp_deadband_c);
+
+#include <cstdint>
+#include "trend_model.h"
+
+// Adaptive sleep configuration
+struct SleepConfig {
+  uint32_t normal_interval_sec;      // Default: 300 (5 min)
+  uint32_t low_battery_interval_sec; // Default: 600 (10 min) for <20% battery
+  uint32_t critical_interval_sec;    // Default: 1800 (30 min) for <5% battery
+  uint32_t rapid_update_interval_sec; // Default: 60 (1 min) when data changing
+  uint8_t low_battery_threshold;     // Default: 20%
+  uint8_t critical_battery_threshold; // Default: 5%
+  uint32_t max_interval_sec;         // Default: SLEEP_MAX_INTERVAL_SEC, flat-trend ceiling
+};
+
+// Battery tier of a reading; percent < 0 (no gauge) counts as normal
+enum class SleepTier : uint8_t { NORMAL = 0, LOW_BATTERY, CRITICAL };
+
+inline SleepTier sleep_tier(const SleepConfig& c, int battery_pct) {
+  if (battery_pct < 0) return SleepTier::NORMAL;
+  if (battery_pct < c.critical_battery_threshold) return SleepTier::CRITICAL;
+  if (battery_pct < c.low_battery_threshold) return SleepTier::LOW_BATTERY;
+  return SleepTier::NORMAL;
+}
+
+// Shortest sleep the tier allows
+inline uint32_t sleep_min_interval(const SleepConfig& c, SleepTier tier) {
+  return tier == SleepTier::LOW_BATTERY ? c.low_battery_interval_sec
+                                        : c.rapid_update_interval_sec;
+}
+
+// rate is the trend's |degC/s| (NaN without history)
+inline uint32_t sleep_plan_interval(const SleepConfig& c, int battery_pct, float rate,
+                                    float deadband_c) {
+  SleepTier tier = sleep_tier(c, battery_pct);
+  if (tier == SleepTier::CRITICAL) return c.critical_interval_sec;
+  return trend_plan_interval(rate, deadband_c, sleep_min_interval(c, tier), c.max_interval_sec,
+                             c.normal_interval_sec);
+}
@@ -0,0 +1,102 @@
+// UI spec op interpreter
+// Split from main.cpp so it builds without the panel driver: the device
+// hands it a DualGFX over the panel and screenshot canvas, the host golden
+// frame test a bare canvas.
+#include "spec_draw.h"
+
+#if USE_DISPLAY && USE_UI_SPEC
+
+// Text cursor x for an op's resolved anchor and the text's width
+static int16_t anchored_x(const ui::UiOpHeader& op, int16_t tw) {
+  if (op.align == ui::ALIGN_RIGHT) return static_cast<int16_t>(op.x - tw);
+  if (op.align == ui::ALIGN_CENTER) return static_cast<int16_t>(op.x + (op.w - tw) / 2);
+  return op.x;
+}
+
+static void draw_text_at(DualGFX& gfx, const ui::UiOpHeader& op, const char* text) {
+  int16_t tw = op.align == ui::ALIGN_LEFT ? 0 : text_width_default_font(text, 1);
+  gfx.setTextColor(GxEPD_BLACK);
+  gfx.setTextSize(1);
+  gfx.setCursor(anchored_x(op, tw), op.y);
+  gfx.print(text);
+}
+
+// Geometry is resolved by the generator (ui_ops_generated.h), so every op
+// draws at its stored coordinates; only text widths are measured here
+void spec_draw_ops(DualGFX& gfx, uint8_t variantId, const RenderModel& m, uint32_t rectMask,
+                   const SpecOpProbe* probe) {
+  using ui::ComponentOps;
+  using ui::UiOpHeader;
+
+  DualGFXScope gfx_scope(&gfx);  // Set global context for helper functions
+
+  int comp_count = 0;
+  const ComponentOps* comps = ui::get_variant_ops(variantId, &comp_count);
+  for (int ci = 0; ci < comp_count; ++ci) {
+    const ComponentOps& co = comps[ci];
+    for (int i = 0; i < co.count; ++i) {
+      const UiOpHeader& op = co.ops[i];
+      if (op.rect < ui::RECT__COUNT && !(rectMask & (1u << op.rect)))
+        continue;
+      if (probe && probe->begin) probe->begin(probe->ctx, ci, i, op);
+      switch (op.kind) {
+        case ui::OP_LINE:
+          if (op.h == 1) {
+            gfx.drawFastHLine(op.x, op.y, op.w, GxEPD_BLACK);
+          } else {
+            gfx.drawFastVLine(op.x, op.y, op.h, GxEPD_BLACK);
+          }
+          break;
+        case ui::OP_TEXT:
+        case ui::OP_TEXTCENTEREDIN: {
+          char out[64];
+          render_model_op_text(op, m, out, sizeof(out));
+          draw_text_at(gfx, op, out);
+          break;
+        }
+        case ui::OP_TIMERIGHT: {
+          char hhmm[8];
+          render_model_format(m, op.field, ui::CONV_NONE, -1, hhmm, sizeof(hhmm));
+          draw_text_at(gfx, op, hhmm);
+          break;
+        }
+        case ui::OP_TEMPGROUPCENTERED: {
+          char temp_buf[16];
+          render_model_format(m, op.field, ui::CONV_NONE, static_cast<int8_t>(op.p1), temp_buf,
+                              sizeof(temp_buf));
+          spec_draw_temp_at(gfx, op.x, op.y, op.w, static_cast<uint8_t>(op.p0), temp_buf);
+          break;
+        }
+        case ui::OP_ICONIN:
+          if (m.has_icon) {
+            spec_draw_icon(gfx, op.x, op.y, op.w, op.h, m.icon);
+          }
+          break;
+        case ui::OP_BATTERYGLYPH: {
+          int16_t bx = op.x, by = op.y, bw = op.w, bh = op.h;
+          gfx.drawRect(bx, by, bw, bh, GxEPD_BLACK);
+          gfx.fillRect(static_cast<int16_t>(bx + bw), static_cast<int16_t>(by + 2), 2, 3,
+                       GxEPD_BLACK);
+          // Percent is clamped to 0-100 in the snapshot so the fill stays in bounds
+          int16_t max_fillw = (bw > 2) ? static_cast<int16_t>(bw - 2) : 0;
+          int16_t fillw = static_cast<int16_t>((max_fillw * (m.battery_pct / 100.0f) + 0.5f));
+          if (fillw > max_fillw) fillw = max_fillw;  // Safety clamp
+          if (fillw > 0 && max_fillw > 0)
+            gfx.fillRect(static_cast<int16_t>(bx + 1), static_cast<int16_t>(by + 1), fillw,
+                         static_cast<int16_t>(bh - 2), GxEPD_BLACK);
+          break;
+        }
+        default:
+          break;
+      }
+      if (probe && probe->end) probe->end(probe->ctx, ci, i, op);
+    }
+  }
+}
+
+// Utility to map RectId->rect pointer
+const int* rect_ptr_by_id(uint8_t rid) {
+  return rid < ui::RECT__COUNT ? ui::kRectGeometry[rid] : nullptr;
+}
+
+#endif  // USE_DISPLAY && USE_UI_SPEC
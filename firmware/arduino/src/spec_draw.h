@@ -0,0 +1,83 @@
+#pragma once
+
+// UI spec op interpreter
+// Walks the generated ops of a layout variant (ui_ops_generated.h) and draws
+// them through a DualGFX from one RenderModel snapshot. Nothing here touches
+// the panel driver, the sensors or the network, so the same code also runs
+// on the host against a bare GFXcanvas1 (test/render_golden).
+//
+// Usage:
+//   DualGFX gfx(&display, display_capture_canvas());   // Panel + screenshot
+//   spec_draw_ops(gfx, 0, render_model_current(), 0xFFFFFFFFu);
+//
+//   DualGFX solo(canvas, nullptr, true);                // Canvas only
+//   spec_draw_ops(solo, 0, model, mask, &probe);        // probe times each op
+
+#include "config.h"
+
+#if USE_DISPLAY
+
+#include <cstdint>
+#include "dual_gfx.h"
+#include "glyph_cache.h"
+#include "icons.h"
+#include "render_model.h"
+#include "ui_ops_generated.h"
+
+#if USE_UI_SPEC
+// Called around every op that is drawn (host timing); never set on device
+struct SpecOpProbe {
+  void (*begin)(void* ctx, int component, int index, const ui::UiOpHeader& op);
+  void (*end)(void* ctx, int component, int index, const ui::UiOpHeader& op);
+  void* ctx;
+};
+
+// Draw the variant's ops whose rect is in rectMask; chrome (rect 255)
+// always draws, since partial windows clear whatever chrome passes through
+void spec_draw_ops(DualGFX& gfx, uint8_t variantId, const RenderModel& m, uint32_t rectMask,
+                   const SpecOpProbe* probe = nullptr);
+
+// RectId -> {x, y, w, h} (ui::kRectGeometry), nullptr if unknown
+const int* rect_ptr_by_id(uint8_t rid);
+#endif  // USE_UI_SPEC
+
+// Large temperature centered across [x, x + w) with its glyph top at y,
+// degree sign and F to its upper right; the generator resolves y for the
+// ops, so only the centering on the text width is left to do here
+template <typename GFX>
+void spec_draw_temp_at(GFX& gfx, int16_t x, int16_t y, int16_t w, uint8_t size, const char* t) {
+  gfx.setTextColor(GxEPD_BLACK);
+  gfx.setTextSize(size);
+
+  // Built-in font metrics, as getTextBounds() would report them
+  int16_t bw = text_width_default_font(t, size);
+  int16_t baseX = static_cast<int16_t>(x + (w - bw) / 2);
+
+  gfx.setCursor(baseX, y);
+  gfx.print(t);
+
+  gfx.setTextSize(1);
+  gfx.setCursor(static_cast<int16_t>(baseX + bw + 2), static_cast<int16_t>(y - 8));
+  gfx.print("\xF8");  // Degree sign
+  gfx.setCursor(static_cast<int16_t>(baseX + bw + 8), static_cast<int16_t>(y - 8));
+  gfx.print("F");
+}
+
+// Large temperature centered in a rect; gfx is the panel (legacy renderer)
+// or a DualGFX
+template <typename GFX>
+void spec_draw_temp(GFX& gfx, int16_t x, int16_t y, int16_t w, int16_t h, const char* t) {
+  spec_draw_temp_at(gfx, x, static_cast<int16_t>(y + (h - GLYPH_HEIGHT * 2) / 2), w, 2, t);
+}
+
+// Baked weather icon centered in a rect, never left of or above it
+template <typename GFX>
+void spec_draw_icon(GFX& gfx, int16_t x, int16_t y, int16_t w, int16_t h, IconId id) {
+  int16_t icon_x = static_cast<int16_t>(x + (w - ICON_W) / 2);
+  int16_t icon_y = static_cast<int16_t>(y + (h - ICON_H) / 2);
+  if (icon_x < x) icon_x = x;
+  if (icon_y < y) icon_y = y;
+  draw_icon(gfx, icon_x, icon_y, id, GxEPD_BLACK);
+}
+
+#endif  // USE_DISPLAY
@@ -1,156 +1,176 @@
 // State management implementation
 #include "state_manager.h"
+#include "rtc_state.h"
 #include <cmath>
 
-// RTC_DATA_ATTR variables persist across deep sleep but not power cycles
-// Display state
-RTC_DATA_ATTR uint16_t partial_counter = 0;
-
-// Temperature and sensor state
-RTC_DATA_ATTR static float last_inside_f = NAN;
-RTC_DATA_ATTR static float last_outside_f = NAN;
-RTC_DATA_ATTR static float last_outside_rh = NAN;
-RTC_DATA_ATTR static float last_inside_rh = NAN;
-
-// Weather icon state
-RTC_DATA_ATTR static int32_t last_icon_id = -1;
-
-// CRC state for change detection
-RTC_DATA_ATTR static uint32_t last_footer_weather_crc = 0;
-RTC_DATA_ATTR static uint32_t last_status_crc = 0;
-
-// Published sensor values
-RTC_DATA_ATTR static float last_published_inside_tempC = NAN;
-RTC_DATA_ATTR static float last_published_inside_rh = NAN;
-RTC_DATA_ATTR static float last_published_inside_pressureHPa = NAN;
-
-// Display refresh state
-RTC_DATA_ATTR static bool needs_full_on_boot = true;
+// Persistent state lives in the consolidated RTC block (rtc_state.h)
 
 // Display state tracking
 uint16_t get_partial_counter() {
-  return partial_counter;
+  return g_rtc_state.partial_counter;
 }
 
 void set_partial_counter(uint16_t count) {
-  partial_counter = count;
+  g_rtc_state.partial_counter = count;
 }
 
 void increment_partial_counter() {
-  partial_counter++;
+  g_rtc_state.partial_counter++;
 }
 
 void reset_partial_counter() {
-  partial_counter = 0;
+  g_rtc_state.partial_counter = 0;
 }
 
 // Temperature state tracking
 float get_last_inside_f() {
-  return last_inside_f;
+  return g_rtc_state.last_inside_f;
 }
 
 void set_last_inside_f(float temp) {
-  last_inside_f = temp;
+  g_rtc_state.last_inside_f = temp;
 }
 
 float get_last_outside_f() {
-  return last_outside_f;
+  return g_rtc_state.last_outside_f;
 }
 
 void set_last_outside_f(float temp) {
-  last_outside_f = temp;
+  g_rtc_state.last_outside_f = temp;
 }
 
 float get_last_outside_rh() {
-  return last_outside_rh;
+  return g_rtc_state.last_outside_rh;
 }
 
 void set_last_outside_rh(float rh) {
-  last_outside_rh = rh;
+  g_rtc_state.last_outside_rh = rh;
 }
 
 float get_last_inside_rh() {
-  return last_inside_rh;
+  return g_rtc_state.last_inside_rh;
 }
 
 void set_last_inside_rh(float rh) {
-  last_inside_rh = rh;
+  g_rtc_state.last_inside_rh = rh;
 }
 
 // Published sensor state
 float get_last_published_inside_tempC() {
-  return last_published_inside_tempC;
+  return g_rtc_state.last_published_inside_tempC;
 }
 
 void set_last_published_inside_tempC(float temp) {
-  last_published_inside_tempC = temp;
+  g_rtc_state.last_published_inside_tempC = temp;
 }
 
 float get_last_published_inside_rh() {
-  return last_published_inside_rh;
+  return g_rtc_state.last_published_inside_rh;
 }
 
 void set_last_published_inside_rh(float rh) {
-  last_published_inside_rh = rh;
+  g_rtc_state.last_published_inside_rh = rh;
 }
 
 float get_last_published_inside_pressureHPa() {
-  return last_published_inside_pressureHPa;
+  return g_rtc_state.last_published_inside_pressureHPa;
 }
 
 void set_last_published_inside_pressureHPa(float pressure) {
-  last_published_inside_pressureHPa = pressure;
+  g_rtc_state.last_published_inside_pressureHPa = pressure;
+}
+
+// Last transmitted snapshot
+float get_last_tx_inside_tempC() {
+  return g_rtc_state.last_tx_inside_tempC;
+}
+
+float get_last_tx_inside_rh() {
+  return g_rtc_state.last_tx_inside_rh;
+}
+
+float get_last_tx_inside_pressureHPa() {
+  return g_rtc_state.last_tx_inside_pressureHPa;
+}
+
+void set_last_tx_inside(float tempC, float rh, float pressureHPa) {
+  g_rtc_state.last_tx_inside_tempC = tempC;
+  g_rtc_state.last_tx_inside_rh = rh;
+  g_rtc_state.last_tx_inside_pressureHPa = pressureHPa;
+  g_rtc_state.sec_since_last_tx = 0;
+  g_rtc_state.wakes_since_last_tx = 0;
+}
+
+uint32_t get_sec_since_last_tx() {
+  return g_rtc_state.sec_since_last_tx;
+}
+
+void add_sec_since_last_tx(uint32_t sec) {
+  g_rtc_state.sec_since_last_tx = (g_rtc_state.sec_since_last_tx > UINT32_MAX - sec) ? UINT32_MAX : g_rtc_state.sec_since_last_tx + sec;
+}
+
+uint16_t get_wakes_since_last_tx() {
+  return g_rtc_state.wakes_since_last_tx;
+}
+
+void increment_wakes_since_last_tx() {
+  if (g_rtc_state.wakes_since_last_tx < UINT16_MAX) g_rtc_state.wakes_since_last_tx++;
 }
 
 // Weather icon state
 int32_t get_last_icon_id() {
-  return last_icon_id;
+  return g_rtc_state.last_icon_id;
 }
 
 void set_last_icon_id(int32_t id) {
-  last_icon_id = id;
+  g_rtc_state.last_icon_id = id;
 }
 
 // CRC state for change detection
 uint32_t get_last_footer_weather_crc() {
-  return last_footer_weather_crc;
+  return g_rtc_state.last_footer_weather_crc;
 }
 
 void set_last_footer_weather_crc(uint32_t crc) {
-  last_footer_weather_crc = crc;
+  g_rtc_state.last_footer_weather_crc = crc;
 }
 
 uint32_t get_last_status_crc() {
-  return last_status_crc;
+  return g_rtc_state.last_status_crc;
 }
 
 void set_last_status_crc(uint32_t crc) {
-  last_status_crc = crc;
+  g_rtc_state.last_status_crc = crc;
 }
 
 // Display refresh state
 bool needs_full_refresh_on_boot() {
-  return needs_full_on_boot;
+  return g_rtc_state.needs_full_on_boot;
 }
 
 void set_needs_full_refresh_on_boot(bool needs) {
-  needs_full_on_boot = needs;
+  g_rtc_state.needs_full_on_boot = needs;
 }
 
 // Initialize all RTC state to defaults
 void init_rtc_state() {
-  partial_counter = 0;
-  last_inside_f = NAN;
-  last_outside_f = NAN;
-  last_outside_rh = NAN;
-  last_inside_rh = NAN;
-  last_icon_id = -1;
-  last_footer_weather_crc = 0;
-  last_status_crc = 0;
-  last_published_inside_tempC = NAN;
-  last_published_inside_rh = NAN;
-  last_published_inside_pressureHPa = NAN;
-  needs_full_on_boot = true;
+  g_rtc_state.partial_counter = 0;
+  g_rtc_state.last_inside_f = NAN;
+  g_rtc_state.last_outside_f = NAN;
+  g_rtc_state.last_outside_rh = NAN;
+  g_rtc_state.last_inside_rh = NAN;
+  g_rtc_state.last_icon_id = -1;
+  g_rtc_state.last_footer_weather_crc = 0;
+  g_rtc_state.last_status_crc = 0;
+  g_rtc_state.last_published_inside_tempC = NAN;
+  g_rtc_state.last_published_inside_rh = NAN;
+  g_rtc_state.last_published_inside_pressureHPa = NAN;
+  g_rtc_state.last_tx_inside_tempC = NAN;
+  g_rtc_state.last_tx_inside_rh = NAN;
+  g_rtc_state.last_tx_inside_pressureHPa = NAN;
+  g_rtc_state.sec_since_last_tx = 0;
+  g_rtc_state.wakes_since_last_tx = 0;
+  g_rtc_state.needs_full_on_boot = true;
 }
 
 // Global variable for full-only mode
@@ -176,30 +196,30 @@ void nvs_load_cache_if_unset() {
   
   nvs_begin_cache();
   
-  if (!isfinite(last_inside_f))
-    last_inside_f = nvs_load_float("li_f", NAN);
-  if (!isfinite(last_inside_rh))
-    last_inside_rh = nvs_load_float("li_rh", NAN);
-  if (!isfinite(last_outside_f))
-    last_outside_f = nvs_load_float("lo_f", NAN);
-  if (!isfinite(last_outside_rh))
-    last_outside_rh = nvs_load_float("lo_rh", NAN);
-  if (last_icon_id < 0) {
+  if (!isfinite(g_rtc_state.last_inside_f))
+    g_rtc_state.last_inside_f = nvs_load_float("li_f", NAN);
+  if (!isfinite(g_rtc_state.last_inside_rh))
+    g_rtc_state.last_inside_rh = nvs_load_float("li_rh", NAN);
+  if (!isfinite(g_rtc_state.last_outside_f))
+    g_rtc_state.last_outside_f = nvs_load_float("lo_f", NAN);
+  if (!isfinite(g_rtc_state.last_outside_rh))
+    g_rtc_state.last_outside_rh = nvs_load_float("lo_rh", NAN);
+  if (g_rtc_state.last_icon_id < 0) {
     // Use UINT32_MAX (0xFFFFFFFF) as sentinel which becomes -1 when cast to int32_t
     uint32_t loaded = nvs_load_uint("icon", UINT32_MAX);
-    last_icon_id = (loaded == UINT32_MAX) ? -1 : static_cast<int32_t>(loaded);
+    g_rtc_state.last_icon_id = (loaded == UINT32_MAX) ? -1 : static_cast<int32_t>(loaded);
   }
-  if (last_status_crc == 0)
-    last_status_crc = nvs_load_uint("st_crc", 0);
-  if (!isfinite(last_published_inside_tempC))
-    last_published_inside_tempC = nvs_load_float("pi_t", NAN);
-  if (!isfinite(last_published_inside_rh))
-    last_published_inside_rh = nvs_load_float("pi_rh", NAN);
-  if (!isfinite(last_published_inside_pressureHPa))
-    last_published_inside_pressureHPa = nvs_load_float("pi_p", NAN);
+  if (g_rtc_state.last_status_crc == 0)
+    g_rtc_state.last_status_crc = nvs_load_uint("st_crc", 0);
+  if (!isfinite(g_rtc_state.last_published_inside_tempC))
+    g_rtc_state.last_published_inside_tempC = nvs_load_float("pi_t", NAN);
+  if (!isfinite(g_rtc_state.last_published_inside_rh))
+    g_rtc_state.last_published_inside_rh = nvs_load_float("pi_rh", NAN);
+  if (!isfinite(g_rtc_state.last_published_inside_pressureHPa))
+    g_rtc_state.last_published_inside_pressureHPa = nvs_load_float("pi_p", NAN);
   uint16_t pc = nvs_load_ushort("pcount", 0);
   if (pc > 0)
-    partial_counter = pc;
+    g_rtc_state.partial_counter = pc;
   // Load render mode (0=partial, 1=full-only)
   g_full_only_mode = nvs_load_uchar("full_only", 0) != 0;
   
@@ -31,6 +31,16 @@ void set_last_published_inside_rh(float rh);
 float get_last_published_inside_pressureHPa();
 void set_last_published_inside_pressureHPa(float pressure);
 
+// Last transmitted snapshot (baseline for skip-network wakes)
+float get_last_tx_inside_tempC();
+float get_last_tx_inside_rh();
+float get_last_tx_inside_pressureHPa();
+void set_last_tx_inside(float tempC, float rh, float pressureHPa);
+uint32_t get_sec_since_last_tx();
+void add_sec_since_last_tx(uint32_t sec);
+uint16_t get_wakes_since_last_tx();
+void increment_wakes_since_last_tx();
+
 // Weather icon state
 int32_t get_last_icon_id();
 void set_last_icon_id(int32_t id);
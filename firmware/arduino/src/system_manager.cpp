@@ -2,8 +2,16 @@
 #include "system_manager.h"
 #include <esp_heap_caps.h>
 #include <esp_sleep.h>
+#include <nvs.h>
 #include "config.h"
 #include "generated_config.h"
+#include "rtc_state.h"
+#include "nvs_write_cache.h"
+#include "crc32.h"
+#include "code_placement.h"
+#if CRC32_IMPL == CRC32_IMPL_ROM
+#include <esp_rom_crc.h>
+#endif
 #ifdef LOG_ENABLED
 #include "logging/logger.h"
 #include "logging/log_buffer.h"
@@ -11,27 +19,27 @@
 LOG_MODULE("SYSTEM");
 #endif
 
-// RTC memory for persisting data across deep sleep
-RTC_DATA_ATTR static uint32_t rtc_wake_count = 0;
 
-// Global preferences object for NVS cache
-static Preferences g_prefs;
+// NVS "cache" namespace: handle, begin/end nesting depth, write-back table
+static nvs_handle_t g_nvs = 0;
+static uint8_t g_nvs_depth = 0;
+static NvsWriteCache<NVS_CACHE_KEYS> g_nvs_cache;
 
 // Display deadline for timing
 static uint32_t g_display_deadline_ms = 0;
 
 // Get current wake count
 uint32_t get_wake_count() {
-    return rtc_wake_count;
+    return g_rtc_state.wake_count;
 }
 
 // Increment wake count
 void increment_wake_count() {
-    rtc_wake_count++;
+    g_rtc_state.wake_count++;
 }
 
 void reset_wake_count() {
-    rtc_wake_count = 0;
+    g_rtc_state.wake_count = 0;
 }
 
 // Get memory diagnostics
@@ -89,7 +97,7 @@ void print_boot_diagnostics() {
     Serial.printf("Heap: free=%u min=%u\n", mem.free_heap, mem.min_free_heap);
     
     // Wake count
-    Serial.printf("Wake count: %u\n", rtc_wake_count);
+    Serial.printf("Wake count: %u\n", g_rtc_state.wake_count);
     
     Serial.println(F("========================"));
 }
@@ -124,7 +132,7 @@ bool reset_reason_is_crash(esp_reset_reason_t reason) {
 // Go to deep sleep with wake tracking
 void go_deep_sleep_with_tracking(uint32_t seconds) {
     #ifdef LOG_ENABLED
-    LOG_INFO("Entering deep sleep for %u seconds. Wake count: %u", seconds, rtc_wake_count);
+    LOG_INFO("Entering deep sleep for %u seconds. Wake count: %u", seconds, g_rtc_state.wake_count);
     Logger::getInstance().flush();
     #endif
     
@@ -135,51 +143,122 @@ void go_deep_sleep_with_tracking(uint32_t seconds) {
     esp_sleep_enable_timer_wakeup(seconds * 1000000ULL);
     
     // Increment wake count for next boot
-    rtc_wake_count++;
+    g_rtc_state.wake_count++;
+
+    // Nothing may touch RTC state past this point
+    rtc_state_seal();
     
     // Enter deep sleep
     esp_deep_sleep_start();
 }
 
 // NVS cache operations
+// Write-back: stores land in g_nvs_cache and the outermost nvs_end_cache()
+// writes only the keys whose value changed, then commits once. Encodings
+// match Preferences (floats as 4-byte blobs) so existing keys still load.
+static bool nvs_read_bits(const char* key, NvsCacheType type, uint32_t& bits) {
+    if (g_nvs_depth == 0) return false;
+    switch (type) {
+        case NVS_CACHE_FLOAT: {
+            size_t len = sizeof(bits);
+            return nvs_get_blob(g_nvs, key, &bits, &len) == ESP_OK && len == sizeof(bits);
+        }
+        case NVS_CACHE_U32:
+            return nvs_get_u32(g_nvs, key, &bits) == ESP_OK;
+        case NVS_CACHE_U16: {
+            uint16_t v;
+            if (nvs_get_u16(g_nvs, key, &v) != ESP_OK) return false;
+            bits = v;
+            return true;
+        }
+        case NVS_CACHE_U8: {
+            uint8_t v;
+            if (nvs_get_u8(g_nvs, key, &v) != ESP_OK) return false;
+            bits = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool nvs_write_bits(const char* key, NvsCacheType type, uint32_t bits) {
+    switch (type) {
+        case NVS_CACHE_FLOAT: return nvs_set_blob(g_nvs, key, &bits, sizeof(bits)) == ESP_OK;
+        case NVS_CACHE_U32: return nvs_set_u32(g_nvs, key, bits) == ESP_OK;
+        case NVS_CACHE_U16: return nvs_set_u16(g_nvs, key, (uint16_t)bits) == ESP_OK;
+        case NVS_CACHE_U8: return nvs_set_u8(g_nvs, key, (uint8_t)bits) == ESP_OK;
+    }
+    return false;
+}
+
+static uint32_t nvs_load_bits(const char* key, NvsCacheType type, uint32_t default_bits) {
+    uint32_t bits = 0;
+    if (g_nvs_cache.lookup(key, type, bits)) return bits;
+    if (g_nvs_cache.known(key, type)) return default_bits;   // Known absent
+    bool found = nvs_read_bits(key, type, bits);
+    if (g_nvs_depth > 0) g_nvs_cache.noteLoaded(key, type, bits, found);
+    return found ? bits : default_bits;
+}
+
+static void nvs_store_bits(const char* key, NvsCacheType type, uint32_t bits) {
+    // Learn the flash value first so an unchanged store is recognized
+    if (g_nvs_depth > 0 && !g_nvs_cache.known(key, type)) {
+        uint32_t flash_bits = 0;
+        bool found = nvs_read_bits(key, type, flash_bits);
+        g_nvs_cache.noteLoaded(key, type, flash_bits, found);
+    }
+    if (!g_nvs_cache.store(key, type, bits) && g_nvs_depth > 0) {
+        // Table full: write through
+        if (nvs_write_bits(key, type, bits)) nvs_commit(g_nvs);
+    }
+}
+
+// Nests: only the outermost begin opens the namespace
 void nvs_begin_cache() {
-    g_prefs.begin("cache", false);
+    if (g_nvs_depth++ > 0) return;
+    if (nvs_open("cache", NVS_READWRITE, &g_nvs) != ESP_OK) {
+        g_nvs_depth = 0;
+    }
 }
 
+// Only the outermost end writes changed keys back (one commit) and closes
 void nvs_end_cache() {
-    g_prefs.end();
+    if (g_nvs_depth == 0 || --g_nvs_depth > 0) return;
+    size_t written = g_nvs_cache.flush(nvs_write_bits);
+    if (written > 0) nvs_commit(g_nvs);
+    nvs_close(g_nvs);
 }
 
 void nvs_store_float(const char* key, float value) {
-    g_prefs.putFloat(key, value);
+    nvs_store_bits(key, NVS_CACHE_FLOAT, nvs_float_bits(value));
 }
 
 void nvs_store_uint(const char* key, uint32_t value) {
-    g_prefs.putUInt(key, value);
+    nvs_store_bits(key, NVS_CACHE_U32, value);
 }
 
 void nvs_store_ushort(const char* key, uint16_t value) {
-    g_prefs.putUShort(key, value);
+    nvs_store_bits(key, NVS_CACHE_U16, value);
 }
 
 void nvs_store_uchar(const char* key, uint8_t value) {
-    g_prefs.putUChar(key, value);
+    nvs_store_bits(key, NVS_CACHE_U8, value);
 }
 
 float nvs_load_float(const char* key, float defaultValue) {
-    return g_prefs.getFloat(key, defaultValue);
+    return nvs_bits_float(nvs_load_bits(key, NVS_CACHE_FLOAT, nvs_float_bits(defaultValue)));
 }
 
 uint32_t nvs_load_uint(const char* key, uint32_t defaultValue) {
-    return g_prefs.getUInt(key, defaultValue);
+    return nvs_load_bits(key, NVS_CACHE_U32, defaultValue);
 }
 
 uint16_t nvs_load_ushort(const char* key, uint16_t defaultValue) {
-    return g_prefs.getUShort(key, defaultValue);
+    return (uint16_t)nvs_load_bits(key, NVS_CACHE_U16, defaultValue);
 }
 
 uint8_t nvs_load_uchar(const char* key, uint8_t defaultValue) {
-    return g_prefs.getUChar(key, defaultValue);
+    return (uint8_t)nvs_load_bits(key, NVS_CACHE_U8, defaultValue);
 }
 
 // Get/set display deadline
@@ -264,20 +343,19 @@ void handle_serial_command_line(const String& line) {
     Serial.println(F("Unknown command. Try 'log help' for logging commands"));
 }
 
-// CRC32 calculation utility
-uint32_t fast_crc32(const uint8_t* data, size_t len) {
-    // Tiny CRC32 (polynomial 0xEDB88320),
-    // suitable for short status strings
-    uint32_t crc = 0xFFFFFFFFu;
-    for (size_t i = 0; i < len; ++i) {
-        uint32_t byte = data[i];
-        crc ^= byte;
-        for (int k = 0; k < 8; ++k) {
-            uint32_t mask = -(crc & 1u);
-            crc = (crc >> 1) ^ (0xEDB88320u & mask);
-        }
-    }
-    return ~crc;
+// CRC32 calculation utility (CRC32_IMPL in config.h)
+HOT_PATH uint32_t fast_crc32_update(uint32_t crc, const uint8_t* data, size_t len) {
+#if CRC32_IMPL == CRC32_IMPL_ROM
+    return esp_rom_crc32_le(crc, data, (uint32_t)len);
+#elif CRC32_IMPL == CRC32_IMPL_TABLE
+    return crc32_table_update(crc, data, len);
+#else
+    return crc32_bitwise_update(crc, data, len);
+#endif
+}
+
+HOT_PATH uint32_t fast_crc32(const uint8_t* data, size_t len) {
+    return fast_crc32_update(0, data, len);
 }
 
 // Template implementations for conditional redraws
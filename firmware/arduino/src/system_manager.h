@@ -61,6 +61,9 @@ inline uint32_t elapsed_since_ms(uint32_t start_ms) {
 
 // CRC and validation utilities
 uint32_t fast_crc32(const uint8_t* data, size_t len);
+// Streaming form: start from 0 and feed chunks; the result after the last
+// chunk equals fast_crc32() over the concatenation
+uint32_t fast_crc32_update(uint32_t crc, const uint8_t* data, size_t len);
 
 // Helper templates for conditional redraws
 template <typename DrawFn>
@@ -0,0 +1,126 @@
+#pragma once
+
+// Compact binary telemetry frame
+// One fixed-layout, little-endian frame with the wake's readings, battery,
+// RSSI, wake count and boot timeline, published on espsensor/<id>/telemetry
+// alongside the text topics. 21 bytes versus ~150 bytes of per-topic text.
+//
+// Usage:
+//   TelemetryValues v = {...};
+//   uint8_t frame[TELEMETRY_FRAME_LEN];
+//   size_t n = telemetry_encode(v, frame, sizeof(frame));
+//   client->publish(topic_get(TOPIC_TELEMETRY), frame, n, false);
+//   telemetry_decode(frame, n, &v);                 // ESP-NOW gateway side
+//
+// Layout (v1), decoded by scripts/mqtt_topics.py:decode_telemetry_frame:
+//   off size field
+//    0   1   version (1)
+//    1   2   temp_cC      int16  (INT16_MIN = missing)
+//    3   2   rh_cPct      uint16 (0xFFFF = missing)
+//    5   2   press_dHPa   uint16 (0xFFFF = missing)
+//    7   2   battery_mV   uint16 (0xFFFF = missing)
+//    9   1   battery_pct  uint8  (0xFF = missing)
+//   10   1   rssi_dBm     int8   (0 = missing)
+//   11   4   wake_count   uint32
+//   15   2   sensor_ms    uint16 } ms since reset of the SENSOR_READY,
+//   17   2   wifi_ms      uint16 } WIFI_ASSOCIATED and MQTT_CONNECTED
+//   19   2   mqtt_ms      uint16 } milestones (0 = not reached)
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+static constexpr uint8_t TELEMETRY_FRAME_VERSION = 1;
+static constexpr size_t TELEMETRY_FRAME_LEN = 21;
+
+struct TelemetryValues {
+  float tempC;            // NAN = missing
+  float rhPct;
+  float pressHPa;
+  float batteryV;
+  int batteryPct;         // < 0 = missing
+  int rssiDbm;            // 0 = missing
+  uint32_t wakeCount;
+  uint32_t sensorMs;      // Milestones, ms since reset (0 = not reached)
+  uint32_t wifiMs;
+  uint32_t mqttMs;
+};
+
+// Scale a value to a fixed-point integer, or return the sentinel if missing
+// or outside [lo, hi]
+inline int32_t telemetry_scale(float v, float scale, int32_t lo, int32_t hi, int32_t missing) {
+  if (!std::isfinite(v)) return missing;
+  float s = std::round(v * scale);
+  if (s < (float)lo || s > (float)hi) return missing;
+  return (int32_t)s;
+}
+
+inline uint16_t telemetry_ms16(uint32_t ms) {
+  return ms > 0xFFFFu ? 0xFFFFu : (uint16_t)ms;
+}
+
+inline void telemetry_put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)(v >> 8);
+}
+
+inline void telemetry_put32(uint8_t* p, uint32_t v) {
+  telemetry_put16(p, (uint16_t)(v & 0xFFFF));
+  telemetry_put16(p + 2, (uint16_t)(v >> 16));
+}
+
+// Encode a v1 frame; returns the frame length, or 0 if out is too small
+inline size_t telemetry_encode(const TelemetryValues& v, uint8_t* out, size_t out_size) {
+  if (!out || out_size < TELEMETRY_FRAME_LEN) return 0;
+
+  int32_t temp = telemetry_scale(v.tempC, 100.0f, -32767, 32767, INT16_MIN);
+  int32_t rh = telemetry_scale(v.rhPct, 100.0f, 0, 10000, 0xFFFF);
+  int32_t press = telemetry_scale(v.pressHPa, 10.0f, 0, 0xFFFE, 0xFFFF);
+  int32_t mv = telemetry_scale(v.batteryV, 1000.0f, 0, 0xFFFE, 0xFFFF);
+  uint8_t pct = (v.batteryPct < 0 || v.batteryPct > 100) ? 0xFF : (uint8_t)v.batteryPct;
+  int8_t rssi = (v.rssiDbm < -127 || v.rssiDbm >= 0) ? 0 : (int8_t)v.rssiDbm;
+
+  out[0] = TELEMETRY_FRAME_VERSION;
+  telemetry_put16(out + 1, (uint16_t)(int16_t)temp);
+  telemetry_put16(out + 3, (uint16_t)rh);
+  telemetry_put16(out + 5, (uint16_t)press);
+  telemetry_put16(out + 7, (uint16_t)mv);
+  out[9] = pct;
+  out[10] = (uint8_t)rssi;
+  telemetry_put32(out + 11, v.wakeCount);
+  telemetry_put16(out + 15, telemetry_ms16(v.sensorMs));
+  telemetry_put16(out + 17, telemetry_ms16(v.wifiMs));
+  telemetry_put16(out + 19, telemetry_ms16(v.mqttMs));
+  return TELEMETRY_FRAME_LEN;
+}
+
+inline uint16_t telemetry_get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t telemetry_get32(const uint8_t* p) {
+  return (uint32_t)telemetry_get16(p) | ((uint32_t)telemetry_get16(p + 2) << 16);
+}
+
+// Decode a v1 frame back into values (sentinels become NAN / -1 / 0);
+// false for a wrong length or version
+inline bool telemetry_decode(const uint8_t* in, size_t len, TelemetryValues* v) {
+  if (!in || !v || len != TELEMETRY_FRAME_LEN || in[0] != TELEMETRY_FRAME_VERSION) return false;
+
+  int16_t temp = (int16_t)telemetry_get16(in + 1);
+  uint16_t rh = telemetry_get16(in + 3);
+  uint16_t press = telemetry_get16(in + 5);
+  uint16_t mv = telemetry_get16(in + 7);
+
+  v->tempC = temp == INT16_MIN ? NAN : temp / 100.0f;
+  v->rhPct = rh == 0xFFFF ? NAN : rh / 100.0f;
+  v->pressHPa = press == 0xFFFF ? NAN : press / 10.0f;
+  v->batteryV = mv == 0xFFFF ? NAN : mv / 1000.0f;
+  v->batteryPct = in[9] == 0xFF ? -1 : in[9];
+  v->rssiDbm = (int8_t)in[10];
+  v->wakeCount = telemetry_get32(in + 11);
+  v->sensorMs = telemetry_get16(in + 15);
+  v->wifiMs = telemetry_get16(in + 17);
+  v->mqttMs = telemetry_get16(in + 19);
+  return true;
+}
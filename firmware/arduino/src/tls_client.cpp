@@ -0,0 +1,320 @@
+#include "config.h"
+
+#if MQTT_TLS
+
+#include "tls_client.h"
+#include "tls_session_cache.h"
+#include "wake_timeline.h"
+#include <lwip/sockets.h>
+#include <mbedtls/error.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/version.h>
+#include <time.h>
+
+// Session fields became private in mbedTLS 3
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+  #define TLS_FIELD(f) MBEDTLS_PRIVATE(f)
+#else
+  #define TLS_FIELD(f) f
+#endif
+
+static constexpr size_t TLS_MASTER_BYTES = 48;
+
+// RTC memory - persists across deep sleep, lost on power-up
+RTC_DATA_ATTR static TlsSessionCache<TLS_SESSION_CACHE_BYTES> rtc_tls_session;
+
+// Master secret of the session offered this connect: the handshake was
+// abbreviated exactly when the negotiated session still has it
+static uint8_t g_offered_master[TLS_MASTER_BYTES];
+
+static uint32_t now_sec() {
+    time_t t = time(nullptr);
+    return t > 0 ? (uint32_t)t : 0;
+}
+
+void TlsClient::clearSession() {
+    rtc_tls_session.clear();
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+int TlsClient::connect(const char* host, uint16_t port) {
+    stop();
+    if (!host || !host[0]) return 0;
+
+    if (!transport_.connect(host, port)) {
+        Serial.printf("[TLS] TCP connect to %s:%u failed\n", host, port);
+        return 0;
+    }
+    WAKE_MARK(TCP_CONNECTED);
+
+    if (!setup(host)) {
+        stop();
+        return 0;
+    }
+
+    uint32_t peer = tls_session_peer_id(host, port);
+    bool offered = offerSession(peer);
+
+    uint32_t start = millis();
+    int ret;
+    while ((ret = mbedtls_ssl_handshake(&ssl_)) != 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            char err[96];
+            mbedtls_strerror(ret, err, sizeof(err));
+            Serial.printf("[TLS] Handshake failed (-0x%04x): %s\n", (unsigned)-ret, err);
+            if (offered) clearSession();    // Do not offer it again
+            stop();
+            return 0;
+        }
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= handshake_timeout_ms_) {
+            Serial.printf("[TLS] Handshake timed out after %lu ms\n", (unsigned long)elapsed);
+            stop();
+            return 0;
+        }
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ) {
+            uint32_t left = handshake_timeout_ms_ - elapsed;
+            waitReadable(left < 50 ? left : 50);
+        }
+    }
+    handshake_ms_ = millis() - start;
+    connected_ = true;
+
+    const mbedtls_ssl_session* s = ssl_.TLS_FIELD(session);
+    resumed_ = offered && s &&
+               memcmp(s->TLS_FIELD(master), g_offered_master, TLS_MASTER_BYTES) == 0;
+    WAKE_MARK(TLS_ESTABLISHED);
+    #if FEATURE_WAKE_TIMELINE
+    if (resumed_) WakeTimeline::getInstance().setFlag(WakeTimeline::FLAG_TLS_RESUMED);
+    #endif
+
+    // A resumed handshake may still bring a fresh ticket, so always re-save
+    saveSession(peer);
+    Serial.printf("[TLS] %s handshake in %lu ms (%s)\n", resumed_ ? "Resumed" : "Full",
+                  (unsigned long)handshake_ms_, mbedtls_ssl_get_ciphersuite(&ssl_));
+    return 1;
+}
+
+bool TlsClient::setup(const char* host) {
+    mbedtls_ssl_init(&ssl_);
+    mbedtls_ssl_config_init(&conf_);
+    mbedtls_ctr_drbg_init(&drbg_);
+    mbedtls_entropy_init(&entropy_);
+    mbedtls_x509_crt_init(&ca_);
+    ready_ = true;
+
+    static const char kPers[] = "espsensor-mqtt";
+    int ret = mbedtls_ctr_drbg_seed(&drbg_, mbedtls_entropy_func, &entropy_,
+                                    (const unsigned char*)kPers, sizeof(kPers) - 1);
+    if (ret == 0) {
+        ret = mbedtls_ssl_config_defaults(&conf_, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+    }
+    if (ret == 0 && ca_pem_) {
+        // PEM parsing needs the terminating NUL in the length
+        ret = mbedtls_x509_crt_parse(&ca_, (const unsigned char*)ca_pem_, strlen(ca_pem_) + 1);
+        if (ret == 0) {
+            mbedtls_ssl_conf_ca_chain(&conf_, &ca_, nullptr);
+            mbedtls_ssl_conf_authmode(&conf_, MBEDTLS_SSL_VERIFY_REQUIRED);
+        }
+    } else if (ret == 0) {
+        mbedtls_ssl_conf_authmode(&conf_, MBEDTLS_SSL_VERIFY_NONE);
+    }
+    if (ret != 0) {
+        Serial.printf("[TLS] Setup failed (-0x%04x)\n", (unsigned)-ret);
+        return false;
+    }
+
+    mbedtls_ssl_conf_rng(&conf_, mbedtls_ctr_drbg_random, &drbg_);
+    #if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&conf_, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+    #endif
+
+    ret = mbedtls_ssl_setup(&ssl_, &conf_);
+    if (ret == 0) ret = mbedtls_ssl_set_hostname(&ssl_, host);
+    if (ret != 0) {
+        Serial.printf("[TLS] Setup failed (-0x%04x)\n", (unsigned)-ret);
+        return false;
+    }
+    mbedtls_ssl_set_bio(&ssl_, this, bioSend, bioRecv, nullptr);
+    return true;
+}
+
+void TlsClient::release() {
+    if (!ready_) return;
+    mbedtls_ssl_free(&ssl_);
+    mbedtls_ssl_config_free(&conf_);
+    mbedtls_ctr_drbg_free(&drbg_);
+    mbedtls_entropy_free(&entropy_);
+    mbedtls_x509_crt_free(&ca_);
+    ready_ = false;
+}
+
+// Hand the cached session to mbedTLS; false means a full handshake
+bool TlsClient::offerSession(uint32_t peer) {
+    if (!rtc_tls_session.usable(peer, now_sec(), TLS_SESSION_MAX_AGE_SEC)) return false;
+
+    mbedtls_ssl_session s;
+    mbedtls_ssl_session_init(&s);
+    bool ok = mbedtls_ssl_session_load(&s, rtc_tls_session.data, rtc_tls_session.length) == 0 &&
+              mbedtls_ssl_set_session(&ssl_, &s) == 0;
+    if (ok) memcpy(g_offered_master, s.TLS_FIELD(master), TLS_MASTER_BYTES);
+    mbedtls_ssl_session_free(&s);
+
+    if (!ok) {
+        // Saved by a build with another mbedTLS configuration
+        Serial.println("[TLS] Cached session unusable, discarding");
+        clearSession();
+    }
+    return ok;
+}
+
+void TlsClient::saveSession(uint32_t peer) {
+    uint16_t resumes = rtc_tls_session.valid() ? rtc_tls_session.resumes : 0;
+
+    mbedtls_ssl_session s;
+    mbedtls_ssl_session_init(&s);
+    uint8_t* blob = (uint8_t*)malloc(TLS_SESSION_CACHE_BYTES);
+    size_t len = 0;
+    int ret = -1;
+    if (blob && mbedtls_ssl_get_session(&ssl_, &s) == 0) {
+        ret = mbedtls_ssl_session_save(&s, blob, TLS_SESSION_CACHE_BYTES, &len);
+    }
+    uint32_t lifetime = 0;
+    #if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    if (ret == 0) lifetime = s.TLS_FIELD(ticket_lifetime);
+    #endif
+    mbedtls_ssl_session_free(&s);
+
+    if (ret == 0 && rtc_tls_session.store(peer, now_sec(), lifetime, blob, len)) {
+        if (resumed_) {
+            rtc_tls_session.resumes = resumes;
+            rtc_tls_session.noteResumed();
+        }
+    } else if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+        Serial.printf("[TLS] Session needs %u bytes > TLS_SESSION_CACHE_BYTES; not cached\n",
+                      (unsigned)len);
+        clearSession();
+    } else {
+        clearSession();
+    }
+    free(blob);
+}
+
+bool TlsClient::waitReadable(uint32_t timeout_ms) {
+    if (transport_.available() > 0) return true;
+    int fd = transport_.fd();
+    if (fd < 0) {
+        delay(timeout_ms);
+        return false;
+    }
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    return select(fd + 1, &rfds, nullptr, nullptr, &tv) > 0;
+}
+
+int TlsClient::bioSend(void* ctx, const unsigned char* buf, size_t len) {
+    TlsClient* self = static_cast<TlsClient*>(ctx);
+    if (!self->transport_.connected()) return MBEDTLS_ERR_NET_CONN_RESET;
+    size_t n = self->transport_.write(buf, len);
+    return n > 0 ? (int)n : MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+// Non-blocking: the handshake loop and available() wait on the socket
+int TlsClient::bioRecv(void* ctx, unsigned char* buf, size_t len) {
+    TlsClient* self = static_cast<TlsClient*>(ctx);
+    if (self->transport_.available() <= 0) {
+        return self->transport_.connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    }
+    int n = self->transport_.read(buf, len);
+    return n > 0 ? n : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+size_t TlsClient::write(const uint8_t* buf, size_t size) {
+    if (!connected_) return 0;
+    size_t done = 0;
+    uint32_t start = millis();
+    while (done < size) {
+        int ret = mbedtls_ssl_write(&ssl_, buf + done, size - done);
+        if (ret > 0) {
+            done += (size_t)ret;
+        } else if (ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_WANT_READ) {
+            if (millis() - start > handshake_timeout_ms_) break;
+            delay(1);
+        } else {
+            connected_ = false;
+            break;
+        }
+    }
+    return done;
+}
+
+int TlsClient::available() {
+    if (!connected_) return 0;
+    int n = (int)mbedtls_ssl_get_bytes_avail(&ssl_);
+    if (n == 0) {
+        // Zero-length read: decrypt a record that has arrived, if any
+        int ret = mbedtls_ssl_read(&ssl_, nullptr, 0);
+        n = (int)mbedtls_ssl_get_bytes_avail(&ssl_);
+        if (n == 0 && ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            connected_ = false;
+        }
+    }
+    return n + (peek_ >= 0 ? 1 : 0);
+}
+
+int TlsClient::read(uint8_t* buf, size_t size) {
+    if (!buf || size == 0) return 0;
+    size_t off = 0;
+    if (peek_ >= 0) {
+        buf[0] = (uint8_t)peek_;
+        peek_ = -1;
+        off = 1;
+        if (size == 1) return 1;
+    }
+    if (!connected_) return off ? (int)off : -1;
+    int ret = mbedtls_ssl_read(&ssl_, buf + off, size - off);
+    if (ret > 0) return ret + (int)off;
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        connected_ = false;    // Close notify (0) or an error
+    }
+    return off ? (int)off : -1;
+}
+
+int TlsClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int TlsClient::peek() {
+    if (peek_ < 0 && connected_) {
+        uint8_t b;
+        if (mbedtls_ssl_read(&ssl_, &b, 1) == 1) peek_ = b;
+    }
+    return peek_;
+}
+
+void TlsClient::stop() {
+    if (connected_) mbedtls_ssl_close_notify(&ssl_);
+    connected_ = false;
+    peek_ = -1;
+    release();
+    transport_.stop();
+}
+
+uint8_t TlsClient::connected() {
+    if (!connected_) return 0;
+    if (!transport_.connected() && mbedtls_ssl_get_bytes_avail(&ssl_) == 0 && peek_ < 0) {
+        connected_ = false;
+    }
+    return connected_;
+}
+
+#endif // MQTT_TLS
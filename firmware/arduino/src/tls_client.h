@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+#include <WiFiClient.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/x509_crt.h>
+
+// MQTT over TLS with session resumption across deep sleep (MQTT_TLS)
+// WiFiClientSecure runs the whole handshake inside connect() and gives no
+// way to offer a saved session, so every wake would pay a full handshake
+// (certificate chain, key exchange: most of a second at 80-240 MHz). This
+// client drives mbedTLS directly over a WiFiClient. After a full handshake
+// the session (ticket or session id plus master secret) is serialized into
+// RTC memory (tls_session_cache.h); later wakes set it before the handshake
+// and the broker answers with an abbreviated one. A broker that no longer
+// knows the session just falls back to a full handshake, whose new session
+// replaces the cached one.
+//
+// The TCP connect and handshake end are stamped in the wake timeline (tcp,
+// tls) with the resumed flag, so the saving shows per wake.
+//
+// Usage:
+//   static WiFiClient tcp;
+//   static TlsClient tls(tcp);
+//   tls.setCACert(MQTT_TLS_CA_CERT);
+//   PubSubClient mqtt(tls);
+
+class TlsClient : public Client {
+public:
+    explicit TlsClient(WiFiClient& transport) : transport_(transport) {}
+    ~TlsClient() override { stop(); }
+
+    // PEM trust anchor; nullptr skips server verification (test brokers only)
+    void setCACert(const char* pem) { ca_pem_ = pem; }
+    void setHandshakeTimeout(uint32_t ms) { handshake_timeout_ms_ = ms; }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    // Socket for select() (mqtt_wait_for_data); decrypted bytes already
+    // buffered are reported by available()
+    int fd() const { return transport_.fd(); }
+
+    // Last handshake: duration and whether the cached session was accepted
+    uint32_t handshakeMs() const { return handshake_ms_; }
+    bool resumed() const { return resumed_; }
+
+    // Forget the cached session (next connect does a full handshake)
+    static void clearSession();
+
+private:
+    WiFiClient& transport_;
+    const char* ca_pem_ = nullptr;
+    uint32_t handshake_timeout_ms_ = 5000;
+    uint32_t handshake_ms_ = 0;
+    bool resumed_ = false;
+    bool ready_ = false;          // Contexts initialised
+    bool connected_ = false;
+    int peek_ = -1;
+
+    mbedtls_ssl_context ssl_;
+    mbedtls_ssl_config conf_;
+    mbedtls_ctr_drbg_context drbg_;
+    mbedtls_entropy_context entropy_;
+    mbedtls_x509_crt ca_;
+
+    bool setup(const char* host);
+    void release();
+    bool offerSession(uint32_t peer);
+    void saveSession(uint32_t peer);
+    bool waitReadable(uint32_t timeout_ms);
+
+    static int bioSend(void* ctx, const unsigned char* buf, size_t len);
+    static int bioRecv(void* ctx, unsigned char* buf, size_t len);
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+// TLS session cache record for RTC memory (tls_client.cpp)
+// Holds one serialized mbedTLS session (mbedtls_ssl_session_save: master
+// secret, cipher suite and the server's session ticket) for one broker, so
+// the next wake can offer it and get an abbreviated handshake instead of a
+// full one. The record is plain data, so it can sit in RTC_DATA_ATTR memory
+// and survive deep sleep; a CRC over the blob rejects it after a power loss.
+//
+// Usage:
+//   RTC_DATA_ATTR static TlsSessionCache<1536> cache;
+//   uint32_t peer = tls_session_peer_id(host, port);
+//   if (cache.usable(peer, now, TLS_SESSION_MAX_AGE_SEC)) load(cache.data, cache.length);
+//   ...after the handshake...
+//   cache.store(peer, now, lifetime, blob, blob_len);
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "crc32.h"
+
+static constexpr uint32_t TLS_SESSION_CACHE_MAGIC = 0x544C5331;   // "TLS1"
+
+// FNV-1a of "host:port"; a ticket is only offered to the broker that issued it
+inline uint32_t tls_session_peer_id(const char* host, uint16_t port) {
+    uint32_t h = 2166136261u;
+    for (const char* p = host ? host : ""; *p; p++) {
+        h ^= (uint8_t)*p;
+        h *= 16777619u;
+    }
+    h ^= ':';
+    h *= 16777619u;
+    h ^= (uint8_t)(port & 0xFF);
+    h *= 16777619u;
+    h ^= (uint8_t)(port >> 8);
+    h *= 16777619u;
+    return h;
+}
+
+template <size_t N>
+struct TlsSessionCache {
+    uint32_t magic;
+    uint32_t peer;          // tls_session_peer_id of the issuing broker
+    uint32_t saved_at;      // Epoch seconds of the handshake
+    uint32_t lifetime;      // Server's ticket lifetime hint, 0 = none given
+    uint16_t length;        // Bytes of data in use
+    uint16_t resumes;       // Abbreviated handshakes with this session
+    uint32_t crc;           // CRC-32 of the header fields above and data
+    uint8_t data[N];
+
+    uint32_t checksum() const {
+        uint32_t c = crc32_bitwise_update(0, (const uint8_t*)this, offsetof(TlsSessionCache, crc));
+        return crc32_bitwise_update(c, data, length <= N ? length : N);
+    }
+
+    void clear() {
+        memset(this, 0, offsetof(TlsSessionCache, data));
+    }
+
+    // False (and cleared) when the blob does not fit
+    bool store(uint32_t peer_id, uint32_t now, uint32_t lifetime_sec, const uint8_t* blob, size_t len) {
+        clear();
+        if (!blob || len == 0 || len > N || len > 0xFFFF) return false;
+        memcpy(data, blob, len);
+        magic = TLS_SESSION_CACHE_MAGIC;
+        peer = peer_id;
+        saved_at = now;
+        lifetime = lifetime_sec;
+        length = (uint16_t)len;
+        crc = checksum();
+        return true;
+    }
+
+    bool valid() const {
+        return magic == TLS_SESSION_CACHE_MAGIC && length > 0 && length <= N && crc == checksum();
+    }
+
+    // A session worth offering: same broker, intact, and not past the
+    // ticket lifetime (or max_age when the server gave none)
+    bool usable(uint32_t peer_id, uint32_t now, uint32_t max_age) const {
+        if (!valid() || peer != peer_id) return false;
+        if (now < saved_at) return false;       // Clock stepped back: age unknown
+        uint32_t limit = (lifetime && lifetime < max_age) ? lifetime : max_age;
+        return now - saved_at < limit;
+    }
+
+    // Count a resumption without touching the blob
+    void noteResumed() {
+        if (!valid()) return;
+        if (resumes < 0xFFFF) resumes++;
+        crc = checksum();
+    }
+};
@@ -0,0 +1,109 @@
+// MQTT topic table implementation
+#include "topic_table.h"
+
+// Budget: every topic with the longest (39-char) client id; a MAC-based id
+// uses about half of this
+static constexpr size_t TOPIC_TABLE_BYTES = 2560;
+
+// Suffixes relative to the device prefix, indexed by TopicId
+static const char* const kTopicSuffixes[TOPIC_COUNT] = {
+  "availability",
+  "status",
+  "diagnostic_mode",
+  "state",
+  "telemetry",
+  "inside/temperature",
+  "inside/humidity",
+  "inside/pressure",
+  "inside/stats",
+  "battery/voltage",
+  "battery/percent",
+  "wifi/rssi",
+  "debug/json",
+  "debug/last_crash",
+  "debug/probe",
+  "debug/diagnostics",
+  "debug/boot_reason",
+  "debug/boot_count",
+  "debug/crash_count",
+  "debug/uptime",
+  "debug/wake_count",
+  "debug/memory",
+  "debug/publish_latency_ms",
+  "debug/retained_fetch_ms",
+  "debug/errors/truncations",
+  "debug/errors/rtc_corruptions",
+  "debug/errors/sensor_failures",
+  "debug/errors/wifi_disconnects",
+  "debug/errors/mqtt_failures",
+  "debug/errors/phase_overruns",
+  "cmd/+",
+  "config",
+  "ota",
+  "ota/data",
+  "ota/req",
+  "ota/status",
+  nullptr,  // TOPIC_DISCOVERY is built separately
+};
+
+// Offset 0 holds "", the slot an entry that did not fit points at
+static constexpr uint16_t EMPTY_TOPIC_OFF = 0;
+
+static char g_topic_buf[TOPIC_TABLE_BYTES];
+static uint16_t g_topic_off[TOPIC_COUNT];
+static uint16_t g_prefix_off = EMPTY_TOPIC_OFF;
+static size_t g_prefix_len = 0;
+static bool g_topic_built = false;
+
+// Append a NUL-terminated string; returns its offset or EMPTY_TOPIC_OFF
+static uint16_t append_topic(size_t& pos, const char* a, const char* b, const char* c) {
+  int n = snprintf(g_topic_buf + pos, TOPIC_TABLE_BYTES - pos, "%s%s%s", a, b, c);
+  if (n < 0 || pos + (size_t)n + 1 > TOPIC_TABLE_BYTES) {
+    Serial.println("[Topics] Table full - topic dropped");
+    g_topic_buf[pos] = '\0';   // Keep the tail free for the next, shorter one
+    return EMPTY_TOPIC_OFF;
+  }
+  uint16_t off = (uint16_t)pos;
+  pos += (size_t)n + 1;
+  return off;
+}
+
+void topic_table_build(const char* client_id) {
+  const char* id = (client_id && client_id[0]) ? client_id : "unknown";
+  g_topic_buf[EMPTY_TOPIC_OFF] = '\0';
+  size_t pos = EMPTY_TOPIC_OFF + 1;
+
+  // Device prefix next, so topic_device_prefix() is one lookup
+  g_prefix_off = append_topic(pos, "espsensor/", id, "/");
+  g_prefix_len = strlen(g_topic_buf + g_prefix_off);
+
+  for (uint8_t i = 0; i < TOPIC_COUNT; i++) {
+    if (kTopicSuffixes[i]) {
+      g_topic_off[i] = append_topic(pos, g_topic_buf + g_prefix_off, kTopicSuffixes[i], "");
+    }
+  }
+  g_topic_off[TOPIC_DISCOVERY] = append_topic(pos, "espsensor/discovery/", id, "");
+
+  g_topic_built = true;
+}
+
+const char* topic_get(TopicId id) {
+  if (!g_topic_built) topic_table_build(nullptr);
+  if (id >= TOPIC_COUNT) return "";
+  return g_topic_buf + g_topic_off[id];
+}
+
+const char* topic_suffix(TopicId id) {
+  if (id >= TOPIC_COUNT || !kTopicSuffixes[id]) return "";
+  return kTopicSuffixes[id];
+}
+
+const char* topic_device_prefix() {
+  if (!g_topic_built) topic_table_build(nullptr);
+  return g_topic_buf + g_prefix_off;
+}
+
+size_t topic_device_prefix_len() {
+  if (!g_topic_built) topic_table_build(nullptr);
+  return g_prefix_len;
+}
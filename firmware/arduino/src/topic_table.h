@@ -0,0 +1,73 @@
+#pragma once
+
+// MQTT topic table
+// Every per-device topic (espsensor/<id>/...) is formatted once, when the
+// client id is set, into one static buffer. Publishers look topics up by id
+// instead of rebuilding them with snprintf on every call.
+//
+// Usage:
+//   topic_table_build(client_id);                      // From mqtt_set_client_id()
+//   g_mqtt.publish(topic_get(TOPIC_INSIDE_TEMPERATURE), payload, true);
+
+#include <Arduino.h>
+
+enum TopicId : uint8_t {
+  // Availability / status
+  TOPIC_AVAILABILITY = 0,
+  TOPIC_STATUS,
+  TOPIC_DIAGNOSTIC_MODE,
+  TOPIC_STATE,                     // Packed batch document
+  TOPIC_TELEMETRY,                 // Binary telemetry frame
+  // Readings
+  TOPIC_INSIDE_TEMPERATURE,
+  TOPIC_INSIDE_HUMIDITY,
+  TOPIC_INSIDE_PRESSURE,
+  TOPIC_INSIDE_STATS,              // Rolling 1 h / 24 h aggregates (inside_stats.h)
+  TOPIC_BATTERY_VOLTAGE,
+  TOPIC_BATTERY_PERCENT,
+  TOPIC_WIFI_RSSI,
+  // Debug / diagnostics
+  TOPIC_DEBUG_JSON,
+  TOPIC_DEBUG_LAST_CRASH,
+  TOPIC_DEBUG_PROBE,
+  TOPIC_DEBUG_DIAGNOSTICS,         // Retained document (diag_document.h)
+  TOPIC_DEBUG_BOOT_REASON,
+  TOPIC_DEBUG_BOOT_COUNT,
+  TOPIC_DEBUG_CRASH_COUNT,
+  TOPIC_DEBUG_UPTIME,
+  TOPIC_DEBUG_WAKE_COUNT,
+  TOPIC_DEBUG_MEMORY,
+  TOPIC_DEBUG_PUBLISH_LATENCY_MS,
+  TOPIC_DEBUG_RETAINED_FETCH_MS,
+  TOPIC_DEBUG_ERR_TRUNCATIONS,
+  TOPIC_DEBUG_ERR_RTC_CORRUPTIONS,
+  TOPIC_DEBUG_ERR_SENSOR_FAILURES,
+  TOPIC_DEBUG_ERR_WIFI_DISCONNECTS,
+  TOPIC_DEBUG_ERR_MQTT_FAILURES,
+  TOPIC_DEBUG_ERR_PHASE_OVERRUNS,
+  // Subscriptions
+  TOPIC_CMD_WILDCARD,              // cmd/+
+  TOPIC_CONFIG,                    // Retained fleet config (remote_config.h)
+  // Delta OTA (ota_update.h)
+  TOPIC_OTA,                       // Retained manifest
+  TOPIC_OTA_DATA,                  // Patch chunks
+  TOPIC_OTA_REQUEST,
+  TOPIC_OTA_STATUS,
+  // Not under the device prefix
+  TOPIC_DISCOVERY,                 // espsensor/discovery/<id>
+  TOPIC_COUNT
+};
+
+// Format all topics for this client id (call again if the id changes)
+void topic_table_build(const char* client_id);
+
+// Look up a topic; builds the table with the "unknown" id if not built yet.
+// A topic that did not fit the table reads as "".
+const char* topic_get(TopicId id);
+
+// Suffix of a topic relative to the device prefix (e.g. "inside/temperature")
+const char* topic_suffix(TopicId id);
+
+// "espsensor/<id>/" and its length
+const char* topic_device_prefix();
+size_t topic_device_prefix_len();
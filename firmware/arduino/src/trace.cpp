@@ -0,0 +1,54 @@
+#include "trace.h"
+
+#if FEATURE_TRACE
+
+#include <PubSubClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::record(const char* name, TracePhase phase) {
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    uint8_t tid = buffer_.taskId((uintptr_t)task, pcTaskGetTaskName(task));
+    buffer_.record(name, phase, tid, (uint32_t)esp_timer_get_time());
+}
+
+int Tracer::publish(PubSubClient* client, const char* client_id) {
+    if (!client || !client->connected() || !client_id || !client_id[0]) return -1;
+
+    buffer_.pause();
+
+    // Count chunks first so the metadata can announce them up front
+    char chunk[CHUNK_BYTES];
+    int chunks = 0;
+    size_t cursor = 0;
+    while (buffer_.formatChunk(cursor, chunk, sizeof(chunk))) chunks++;
+
+    char tasks[200];
+    buffer_.formatTasks(tasks, sizeof(tasks));
+    char meta[320];
+    snprintf(meta, sizeof(meta),
+             "{\"events\":%u,\"overwritten\":%lu,\"skipped\":%lu,\"chunks\":%d,\"now_us\":%lu,\"tasks\":%s}",
+             (unsigned)buffer_.size(), (unsigned long)buffer_.overwritten(),
+             (unsigned long)buffer_.skipped(), chunks, (unsigned long)esp_timer_get_time(), tasks);
+
+    char topic[96];
+    snprintf(topic, sizeof(topic), "espsensor/%s%s/meta", client_id, TOPIC_SUFFIX);
+    bool ok = client->publish(topic, meta, false);
+
+    cursor = 0;
+    for (int n = 0; ok && n < chunks; n++) {
+        buffer_.formatChunk(cursor, chunk, sizeof(chunk));
+        snprintf(topic, sizeof(topic), "espsensor/%s%s/data/%d", client_id, TOPIC_SUFFIX, n);
+        ok = client->publish(topic, chunk, false);
+    }
+
+    buffer_.resume();
+    return ok ? chunks : -1;
+}
+
+#endif  // FEATURE_TRACE
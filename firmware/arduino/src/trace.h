@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "feature_flags.h"
+
+// Hot-path tracing
+// Records begin/end events with esp_timer timestamps and the calling task
+// into a RAM ring (trace_buffer.h). Every PROFILE_SCOPE is traced as well,
+// so the existing WiFi, MQTT, sensor and display scopes show up on a
+// timeline without extra instrumentation. The "trace" debug command
+// publishes the ring; the device manager serves it as Chrome trace JSON.
+//
+// Usage:
+//   void my_function() {
+//       TRACE_SCOPE("my_function");     // Traced, but no profiling stats
+//       // ...
+//   }
+//   Tracer::getInstance().publish(client, client_id);
+//
+// Topics (espsensor/<id>/debug/trace/...):
+//   meta     {"events":N,"overwritten":N,"skipped":N,"chunks":N,"now_us":T,
+//             "tasks":[[tid,"name"],...]}
+//   data/<n> [[ts,"B",tid,"name"],[ts,"E",tid],...]
+//
+// Configuration:
+//   FEATURE_TRACE (from feature_flags.h) - Enable tracing
+//   TRACE_BUFFER_EVENTS - Ring size, a power of two (12 bytes per event)
+
+#ifndef TRACE_BUFFER_EVENTS
+  #define TRACE_BUFFER_EVENTS 256
+#endif
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#if FEATURE_TRACE
+
+#include "trace_buffer.h"
+
+class PubSubClient;
+
+class Tracer {
+public:
+    static constexpr const char* TOPIC_SUFFIX = "/debug/trace";
+
+    // Data chunks stay well inside MQTT_MAX_PACKET_SIZE with the topic
+    static constexpr size_t CHUNK_BYTES = 384;
+
+    static Tracer& getInstance();
+
+    void begin(const char* name) { record(name, TRACE_BEGIN); }
+    void end(const char* name) { record(name, TRACE_END); }
+
+    // Publish meta then every data chunk; the ring is frozen meanwhile.
+    // Returns the number of chunks sent, or -1 if a publish failed.
+    int publish(PubSubClient* client, const char* client_id);
+
+    void clear() { buffer_.clear(); }
+
+private:
+    Tracer() = default;
+    ~Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    void record(const char* name, TracePhase phase);
+
+    TraceBuffer<TRACE_BUFFER_EVENTS> buffer_;
+};
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name) : name_(name) { Tracer::getInstance().begin(name_); }
+    ~ScopedTrace() { Tracer::getInstance().end(name_); }
+
+private:
+    const char* name_;
+};
+
+#define TRACE_SCOPE(name) ScopedTrace TRACE_CONCAT(_trace_, __LINE__)(name)
+
+#else  // FEATURE_TRACE == 0
+
+#define TRACE_SCOPE(name)
+
+#endif  // FEATURE_TRACE
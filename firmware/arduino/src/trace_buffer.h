@@ -0,0 +1,172 @@
+#pragma once
+
+// Hot-path trace ring
+// A fixed ring of begin/end events (microsecond timestamp, small task id,
+// static name pointer) for seeing how WiFi, MQTT, sensor and display work
+// overlap or serialize within a wake. Recording claims a slot with one
+// atomic add and never locks; once the ring wraps, the oldest events are
+// overwritten. Dumps are compact JSON arrays that fit in one MQTT packet
+// each; the device manager expands them into Chrome trace_event JSON
+// (scripts/device_manager/trace_handler.py).
+//
+// Usage:
+//   TraceBuffer<256> trace;
+//   uint8_t tid = trace.taskId((uintptr_t)task_handle, "loopTask");
+//   trace.record("wifi_connect", TRACE_BEGIN, tid, now_us);
+//   ...
+//   trace.pause();                         // Freeze the ring while dumping
+//   size_t cursor = 0;
+//   while (trace.formatChunk(cursor, out, sizeof(out))) publish(out);
+//   trace.resume();
+//
+// Chunk format: [[ts,"B",tid,"name"],[ts,"E",tid],...]; an end event closes
+// the innermost open begin on its task, so it carries no name.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+enum TracePhase : uint8_t {
+    TRACE_BEGIN = 'B',
+    TRACE_END = 'E'
+};
+
+static constexpr size_t TRACE_MAX_TASKS = 8;
+static constexpr size_t TRACE_TASK_NAME_LEN = 16;
+static constexpr uint8_t TRACE_TASK_OTHER = TRACE_MAX_TASKS;   // Shared id once the table is full
+
+struct TraceEvent {
+    const char* name;       // Static lifetime; nullptr = slot never written
+    uint32_t ts_us;
+    uint8_t phase;          // TracePhase
+    uint8_t tid;
+};
+
+struct TraceTask {
+    uintptr_t key;          // Owner's handle, 0 = slot not filled yet
+    char name[TRACE_TASK_NAME_LEN];
+};
+
+template <size_t N>
+class TraceBuffer {
+public:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "TraceBuffer size must be a power of two");
+
+    // Name must have static lifetime (string literal); it must not contain quotes
+    void record(const char* name, TracePhase phase, uint8_t tid, uint32_t ts_us) {
+        if (__atomic_load_n(&paused_, __ATOMIC_RELAXED)) {
+            __atomic_fetch_add(&skipped_, 1u, __ATOMIC_RELAXED);
+            return;
+        }
+        uint32_t i = __atomic_fetch_add(&next_, 1u, __ATOMIC_RELAXED);
+        TraceEvent& e = events_[i & (N - 1)];
+        e.ts_us = ts_us;
+        e.phase = phase;
+        e.tid = tid;
+        __atomic_store_n(&e.name, name, __ATOMIC_RELEASE);
+    }
+
+    // Small id for a task, registering it (with a copy of its name) on first
+    // use; tasks past TRACE_MAX_TASKS share TRACE_TASK_OTHER
+    uint8_t taskId(uintptr_t key, const char* name) {
+        size_t n = __atomic_load_n(&task_count_, __ATOMIC_ACQUIRE);
+        if (n > TRACE_MAX_TASKS) n = TRACE_MAX_TASKS;
+        for (size_t i = 0; i < n; i++) {
+            if (__atomic_load_n(&tasks_[i].key, __ATOMIC_ACQUIRE) == key) return (uint8_t)i;
+        }
+        if (n >= TRACE_MAX_TASKS) return TRACE_TASK_OTHER;
+
+        size_t i = __atomic_fetch_add(&task_count_, (size_t)1, __ATOMIC_ACQ_REL);
+        if (i >= TRACE_MAX_TASKS) return TRACE_TASK_OTHER;
+        TraceTask& t = tasks_[i];
+        strncpy(t.name, name ? name : "?", TRACE_TASK_NAME_LEN - 1);
+        t.name[TRACE_TASK_NAME_LEN - 1] = '\0';
+        __atomic_store_n(&t.key, key, __ATOMIC_RELEASE);
+        return (uint8_t)i;
+    }
+
+    // While paused, record() only counts skipped events, so a dump sees a
+    // stable ring
+    void pause() { __atomic_store_n(&paused_, true, __ATOMIC_RELAXED); }
+    void resume() { __atomic_store_n(&paused_, false, __ATOMIC_RELAXED); }
+
+    void clear() {
+        __atomic_store_n(&next_, 0u, __ATOMIC_RELAXED);
+        __atomic_store_n(&skipped_, 0u, __ATOMIC_RELAXED);
+        for (size_t i = 0; i < N; i++) events_[i].name = nullptr;
+    }
+
+    uint32_t recorded() const { return __atomic_load_n(&next_, __ATOMIC_RELAXED); }
+    size_t size() const { return recorded() < N ? recorded() : N; }
+    uint32_t overwritten() const { return recorded() > N ? recorded() - (uint32_t)N : 0; }
+    uint32_t skipped() const { return __atomic_load_n(&skipped_, __ATOMIC_RELAXED); }
+    size_t capacity() const { return N; }
+
+    size_t taskCount() const {
+        size_t n = __atomic_load_n(&task_count_, __ATOMIC_ACQUIRE);
+        return n < TRACE_MAX_TASKS ? n : TRACE_MAX_TASKS;
+    }
+
+    // Write events oldest first from cursor (0 .. size()) as one JSON array
+    // of whole events and advance cursor; returns the number of events
+    // written, 0 once the ring is exhausted or out cannot hold one event
+    size_t formatChunk(size_t& cursor, char* out, size_t out_size) const {
+        if (!out || out_size < 3) return 0;
+        size_t count = size();
+        uint32_t first = recorded() - (uint32_t)count;
+        size_t pos = 1;
+        size_t written = 0;
+        out[0] = '[';
+        while (cursor < count) {
+            const TraceEvent& e = events_[(first + cursor) & (N - 1)];
+            const char* name = __atomic_load_n(&e.name, __ATOMIC_ACQUIRE);
+            if (!name) {
+                cursor++;
+                continue;
+            }
+            size_t remaining = out_size - pos;
+            int n;
+            if (e.phase == TRACE_BEGIN) {
+                n = snprintf(out + pos, remaining, "%s[%lu,\"B\",%u,\"%s\"]", written ? "," : "",
+                             (unsigned long)e.ts_us, (unsigned)e.tid, name);
+            } else {
+                n = snprintf(out + pos, remaining, "%s[%lu,\"E\",%u]", written ? "," : "",
+                             (unsigned long)e.ts_us, (unsigned)e.tid);
+            }
+            // Keep room for the closing "]"
+            if (n < 0 || (size_t)n + 1 >= remaining) break;
+            pos += (size_t)n;
+            written++;
+            cursor++;
+        }
+        out[pos++] = ']';
+        out[pos] = '\0';
+        return written;
+    }
+
+    // Task table as a JSON array: [[tid,"name"],...]
+    void formatTasks(char* out, size_t out_size) const {
+        if (!out || out_size < 3) return;
+        size_t pos = 1;
+        out[0] = '[';
+        for (size_t i = 0; i < taskCount(); i++) {
+            if (__atomic_load_n(&tasks_[i].key, __ATOMIC_ACQUIRE) == 0) continue;
+            size_t remaining = out_size - pos;
+            int n = snprintf(out + pos, remaining, "%s[%u,\"%s\"]", pos > 1 ? "," : "",
+                             (unsigned)i, tasks_[i].name);
+            if (n < 0 || (size_t)n + 1 >= remaining) break;
+            pos += (size_t)n;
+        }
+        out[pos++] = ']';
+        out[pos] = '\0';
+    }
+
+private:
+    TraceEvent events_[N] = {};
+    TraceTask tasks_[TRACE_MAX_TASKS] = {};
+    uint32_t next_ = 0;             // Total events claimed; slot = next_ % N
+    uint32_t skipped_ = 0;          // Dropped while paused
+    size_t task_count_ = 0;
+    bool paused_ = false;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+// Temperature trend model for adaptive sleep
+// A short RTC-resident history of (time, temperature) samples, one per wake,
+// feeds two slope estimates: a least-squares fit over the held samples and an
+// EWMA of the wake-to-wake slope. The planner takes the steeper of the two
+// and sleeps until that rate would move the reading by the publish deadband,
+// clamped to the caller's bounds: a real transient is sampled densely within
+// a wake or two, a flat night stretches to the ceiling.
+//
+// Time is a private clock advanced by the gap the caller reports with each
+// sample (the planned sleep plus the time awake), so it needs neither NTP
+// nor a valid RTC. An early wake (button, ULP) overstates one gap; the slope
+// only comes out slightly flatter.
+//
+// Usage:
+//   trend_push(h, h.next_dt_sec, tempC);                     // Once per wake
+//   uint32_t sec = trend_plan_interval(trend_rate(h), 0.2f, 60, 1800, 300);
+//   h.next_dt_sec = sec + awake_sec;
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+static constexpr size_t TREND_SAMPLES = 8;
+static constexpr float TREND_EWMA_ALPHA = 0.5f;   // Weight of the newest step
+
+struct TrendHistory {
+  uint32_t t_sec[TREND_SAMPLES];    // Trend clock at each sample
+  float tempC[TREND_SAMPLES];
+  float slope_ewma;                 // degC/s, valid once count >= 2
+  uint32_t clock_sec;               // Trend clock of the newest sample
+  uint32_t next_dt_sec;             // Gap the next sample will report
+  uint8_t head;                     // Next slot to write
+  uint8_t count;
+  uint8_t reserved[2];
+};
+
+static_assert(sizeof(TrendHistory) % 4 == 0, "TrendHistory must not leave tail padding");
+
+inline void trend_reset(TrendHistory& h) {
+  h = TrendHistory();
+}
+
+// Held sample i, 0 = oldest
+inline size_t trend_index(const TrendHistory& h, size_t i) {
+  return (h.head + TREND_SAMPLES - h.count + i) % TREND_SAMPLES;
+}
+
+// Append a sample dt_sec after the previous one; NaN readings are dropped
+inline void trend_push(TrendHistory& h, uint32_t dt_sec, float tempC) {
+  if (!std::isfinite(tempC)) return;
+  if (h.count > TREND_SAMPLES || h.head >= TREND_SAMPLES) trend_reset(h);
+  if (h.count > 0) {
+    if (dt_sec == 0) dt_sec = 1;
+    size_t prev = trend_index(h, h.count - 1);
+    float step = (tempC - h.tempC[prev]) / (float)dt_sec;
+    h.slope_ewma = h.count == 1 ? step
+                                : TREND_EWMA_ALPHA * step + (1.0f - TREND_EWMA_ALPHA) * h.slope_ewma;
+    h.clock_sec += dt_sec;
+  }
+  h.t_sec[h.head] = h.clock_sec;
+  h.tempC[h.head] = tempC;
+  h.head = (uint8_t)((h.head + 1) % TREND_SAMPLES);
+  if (h.count < TREND_SAMPLES) h.count++;
+}
+
+// Least-squares slope in degC/s over the held samples; false with fewer
+// than two samples
+inline bool trend_slope(const TrendHistory& h, float& slope) {
+  if (h.count < 2) return false;
+  // Times relative to the oldest sample keep the sums small
+  uint32_t t0 = h.t_sec[trend_index(h, 0)];
+  double st = 0, sv = 0, stt = 0, stv = 0;
+  for (size_t i = 0; i < h.count; i++) {
+    size_t k = trend_index(h, i);
+    double t = (double)(h.t_sec[k] - t0);
+    st += t;
+    sv += h.tempC[k];
+    stt += t * t;
+    stv += t * h.tempC[k];
+  }
+  double n = h.count;
+  double den = n * stt - st * st;
+  if (den <= 0) return false;
+  slope = (float)((n * stv - st * sv) / den);
+  return true;
+}
+
+// Expected |degC/s| for planning; NaN when there is no history yet
+inline float trend_rate(const TrendHistory& h) {
+  float ls;
+  if (!trend_slope(h, ls)) return NAN;
+  return std::fmax(std::fabs(ls), std::fabs(h.slope_ewma));
+}
+
+// Seconds until rate would move the reading by deadband, within [min, max];
+// no history plans default_sec (also clamped)
+inline uint32_t trend_plan_interval(float rate, float deadband, uint32_t min_sec,
+                                    uint32_t max_sec, uint32_t default_sec) {
+  if (max_sec < min_sec) max_sec = min_sec;
+  uint32_t sec = default_sec;
+  if (std::isfinite(rate)) {
+    float t = rate > 0 ? deadband / rate : (float)max_sec;
+    sec = t >= (float)max_sec ? max_sec : (uint32_t)t;
+  }
+  if (sec < min_sec) sec = min_sec;
+  if (sec > max_sec) sec = max_sec;
+  return sec;
+}
@@ -9,6 +9,9 @@ struct SpecInfo { int canvas_w; int canvas_h; };
 static constexpr SpecInfo SPEC{ 250, 122 };
 enum VariantId {
     UIVAR_V2 = 0,
+    UIVAR_COMPACT = 1,
+    UIVAR_LARGE_DIGIT = 2,
+    UIVAR_LOW_BATTERY = 3,
 };
 }
 
@@ -5,58 +5,192 @@
 
 namespace ui {
 
+const int kRectGeometry[RECT__COUNT][4] = {
+    {   6,  85, 118, 12 },  // FOOTER_BATTERY
+    {   6, 107, 120, 14 },  // FOOTER_IP
+    { 168,  90,  76, 32 },  // FOOTER_WEATHER
+    {   6,   2,  90, 14 },  // HEADER_NAME
+    { 100,   2,  50, 14 },  // HEADER_TIME_CENTER
+    { 172,   2,  72, 14 },  // HEADER_VERSION
+    {  66,  20,  58, 12 },  // INSIDE_HILO
+    {   6,  60, 118, 10 },  // INSIDE_HUMIDITY
+    {   6,  18,  60, 14 },  // INSIDE_LABEL
+    {   6,  70, 118, 10 },  // INSIDE_PRESSURE
+    {   6,  34, 118, 26 },  // INSIDE_TEMP
+    { 129,  18,  70, 14 },  // OUTSIDE_LABEL
+    { 131,  78,  44, 12 },  // OUT_HUMIDITY
+    { 177,  68,  64, 12 },  // OUT_PRESSURE
+    { 129,  36,  94, 28 },  // OUT_TEMP
+    { 177,  80,  44, 10 },  // OUT_WIND
+    { 168,  90,  30, 32 },  // WEATHER_ICON
+};
+
+static const UiTextSeg kSegs_header_centered_1[] = {
+    { "", FIELD_ROOM_NAME, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_header_centered_2[] = {
+    { "", FIELD_TIME_HHMM, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_header_centered_3[] = {
+    { "v", FIELD_FW_VERSION, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_inside_1[] = {
+    { "H", FIELD_INSIDE_HI_F, CONV_NONE, 0 },
+    { " L", FIELD_INSIDE_LO_F, CONV_NONE, 0 },
+};
+static const UiTextSeg kSegs_inside_3[] = {
+    { "", FIELD_INSIDE_HUM_PCT, CONV_NONE, -1 },
+    { "% RH", FIELD_NONE, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_inside_4[] = {
+    { "", FIELD_PRESSURE_HPA, CONV_NONE, 1 },
+    { " hPa", FIELD_NONE, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_outside_3[] = {
+    { "", FIELD_OUTSIDE_PRESSURE_HPA, CONV_NONE, 0 },
+    { " hPa", FIELD_NONE, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_outside_4[] = {
+    { "", FIELD_OUTSIDE_HUM_PCT, CONV_NONE, -1 },
+    { "% RH", FIELD_NONE, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_outside_5[] = {
+    { "", FIELD_WIND_MPS, CONV_MPS_TO_MPH, 1 },
+    { " mph", FIELD_NONE, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_footer_split_1[] = {
+    { "", FIELD_BATTERY_VOLTAGE, CONV_NONE, 2 },
+    { "V ", FIELD_BATTERY_PERCENT, CONV_NONE, -1 },
+    { "% ~", FIELD_DAYS, CONV_NONE, -1 },
+    { "d", FIELD_NONE, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_footer_split_2[] = {
+    { "IP ", FIELD_IP, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_footer_split_3[] = {
+    { "", FIELD_WEATHER, CONV_NONE, -1 },
+};
+static const UiTextSeg kSegs_footer_battery_1[] = {
+    { "", FIELD_BATTERY_PERCENT, CONV_NONE, -1 },
+    { "% LOW", FIELD_NONE, CONV_NONE, -1 },
+};
+
+const UiOpHeader kOps_frame_v2[] = {
+    { OP_LINE, 255, 0, 0, 0, 0, 250, 1, 0, 0, 249, 0, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 0, 121, 250, 1, 0, 121, 249, 121, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 0, 0, 1, 122, 0, 0, 0, 121, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 249, 0, 1, 122, 249, 0, 249, 121, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 1, 18, 248, 1, 1, 18, 248, 18, NULL, NULL, FIELD_NONE, 0, NULL },
+};
+const int kOps_frame_v2_count = sizeof(kOps_frame_v2)/sizeof(kOps_frame_v2[0]);
+
 const UiOpHeader kOps_chrome[] = {
-    { OP_LINE, 255, 0, 0, 0, 0, 249, 0, NULL, NULL },
-    { OP_LINE, 255, 0, 0, 0, 121, 249, 121, NULL, NULL },
-    { OP_LINE, 255, 0, 0, 0, 0, 0, 121, NULL, NULL },
-    { OP_LINE, 255, 0, 0, 249, 0, 249, 121, NULL, NULL },
-    { OP_LINE, 255, 0, 0, 125, 14, 125, 121, NULL, NULL },
-    { OP_LINE, 255, 0, 0, 1, 84, 249, 84, NULL, NULL },
+    { OP_LINE, 255, 0, 0, 125, 14, 1, 108, 125, 14, 125, 121, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 1, 84, 249, 1, 1, 84, 249, 84, NULL, NULL, FIELD_NONE, 0, NULL },
 };
 const int kOps_chrome_count = sizeof(kOps_chrome)/sizeof(kOps_chrome[0]);
 
 const UiOpHeader kOps_header_centered[] = {
-    { OP_LINE, 255, 0, 0, 1, 14, 249, 14, NULL, NULL },
-    { OP_TEXT, 3, 1, 0, 0, 0, 0, 0, "{room_name}", NULL },
-    { OP_TEXTCENTEREDIN, 4, 3, 2, 1, 0, 0, 0, "{time_hhmm}", NULL },
-    { OP_TEXT, 5, 3, 1, 0, 0, 0, 0, "v{fw_version}", NULL },
+    { OP_LINE, 255, 0, 0, 1, 14, 249, 1, 1, 14, 249, 14, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_TEXT, 3, 1, 0, 7, 3, 0, 0, 0, 0, 0, 0, "{room_name}", NULL, FIELD_NONE, 1, kSegs_header_centered_1 },
+    { OP_TEXTCENTEREDIN, 4, 3, 2, 100, 3, 50, 0, 1, 0, 0, 0, "{time_hhmm}", NULL, FIELD_NONE, 1, kSegs_header_centered_2 },
+    { OP_TEXT, 5, 3, 1, 242, 3, 0, 0, 0, 0, 0, 0, "v{fw_version}", NULL, FIELD_NONE, 1, kSegs_header_centered_3 },
 };
 const int kOps_header_centered_count = sizeof(kOps_header_centered)/sizeof(kOps_header_centered[0]);
 
-const UiOpHeader kOps_header[] = {
-    { OP_LINE, 255, 0, 0, 1, 14, 249, 14, NULL, NULL },
-    { OP_TEXT, 3, 1, 0, 0, 0, 0, 0, "{room_name}", NULL },
-    { OP_TIMERIGHT, 5, 3, 1, 0, 0, 0, 0, "time_hhmm", NULL },
-};
-const int kOps_header_count = sizeof(kOps_header)/sizeof(kOps_header[0]);
-
 const UiOpHeader kOps_inside[] = {
-    { OP_TEXT, 7, 1, 2, 0, 0, 0, 0, "INSIDE", NULL },
-    { OP_TEMPGROUPCENTERED, 9, 0, 2, 0, 0, 0, 0, "inside_temp_f", NULL },
-    { OP_TEXT, 6, 2, 0, 0, 0, 0, 0, "{inside_hum_pct}% RH", NULL },
-    { OP_TEXT, 8, 2, 0, 0, 0, 0, 0, "{pressure_hpa:.1f} hPa", NULL },
+    { OP_TEXT, 8, 1, 0, 18, 19, 0, 0, 0, 0, 0, 0, "INSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEXT, 6, 2, 1, 122, 21, 0, 0, 0, 0, 0, 0, "H{inside_hi_f:.0f} L{inside_lo_f:.0f}", NULL, FIELD_NONE, 2, kSegs_inside_1 },
+    { OP_TEMPGROUPCENTERED, 10, 0, 2, 6, 39, 118, 0, 2, -1, 0, 0, "inside_temp_f", NULL, FIELD_INSIDE_TEMP_F, 0, NULL },
+    { OP_TEXT, 7, 2, 0, 7, 61, 0, 0, 0, 0, 0, 0, "{inside_hum_pct}% RH", NULL, FIELD_NONE, 2, kSegs_inside_3 },
+    { OP_TEXT, 9, 2, 0, 7, 71, 0, 0, 0, 0, 0, 0, "{pressure_hpa:.1f} hPa", NULL, FIELD_NONE, 2, kSegs_inside_4 },
 };
 const int kOps_inside_count = sizeof(kOps_inside)/sizeof(kOps_inside[0]);
 
 const UiOpHeader kOps_outside[] = {
-    { OP_TEXT, 10, 1, 2, 0, 0, 0, 0, "OUTSIDE", NULL },
-    { OP_TEMPGROUPCENTERED, 13, 0, 2, 0, 0, 0, 0, "outside_temp_f", NULL },
-    { OP_ICONIN, 15, 0, 0, 0, 0, 0, 0, "weather", NULL },
-    { OP_TEXT, 12, 2, 0, 0, 3, 0, 0, "{outside_pressure_hpa:.0f} hPa", NULL },
-    { OP_TEXT, 11, 2, 0, 0, 0, 0, 0, "{outside_hum_pct}% RH", NULL },
-    { OP_TEXT, 14, 2, 0, 0, 0, 0, 0, "{wind_mps->mph:.1f} mph", NULL },
+    { OP_TEXT, 11, 1, 0, 143, 19, 0, 0, 0, 0, 0, 0, "OUTSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEMPGROUPCENTERED, 14, 0, 2, 129, 42, 94, 0, 2, -1, 0, 0, "outside_temp_f", NULL, FIELD_OUTSIDE_TEMP_F, 0, NULL },
+    { OP_ICONIN, 16, 0, 0, 168, 90, 30, 32, 0, 0, 0, 0, "weather", NULL, FIELD_WEATHER, 0, NULL },
+    { OP_TEXT, 13, 2, 0, 178, 71, 0, 0, 0, 3, 0, 0, "{outside_pressure_hpa:.0f} hPa", NULL, FIELD_NONE, 2, kSegs_outside_3 },
+    { OP_TEXT, 12, 2, 0, 132, 79, 0, 0, 0, 0, 0, 0, "{outside_hum_pct}% RH", NULL, FIELD_NONE, 2, kSegs_outside_4 },
+    { OP_TEXT, 15, 2, 0, 178, 81, 0, 0, 0, 0, 0, 0, "{wind_mps->mph:.1f} mph", NULL, FIELD_NONE, 2, kSegs_outside_5 },
 };
 const int kOps_outside_count = sizeof(kOps_outside)/sizeof(kOps_outside[0]);
 
 const UiOpHeader kOps_footer_split[] = {
-    { OP_BATTERYGLYPH, 0, 0, 0, 0, 0, 0, 0, "battery_percent", NULL },
-    { OP_TEXT, 0, 2, 1, 0, 0, 0, 0, "{battery_voltage:.2f}V {battery_percent}% ~{days}d", NULL },
-    { OP_TEXT, 1, 2, 2, 0, 0, 0, 0, "IP {ip}", NULL },
-    { OP_TEXTCENTEREDIN, 2, 2, 2, 10, 0, 0, 0, "{weather}", NULL },
+    { OP_BATTERYGLYPH, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, "battery_percent", NULL, FIELD_BATTERY_PERCENT, 0, NULL },
+    { OP_TEXT, 0, 2, 1, 122, 86, 0, 0, 0, 0, 0, 0, "{battery_voltage:.2f}V {battery_percent}% ~{days}d", NULL, FIELD_NONE, 4, kSegs_footer_split_1 },
+    { OP_TEXT, 1, 2, 2, 6, 108, 120, 0, 0, 0, 0, 0, "IP {ip}", NULL, FIELD_NONE, 1, kSegs_footer_split_2 },
+    { OP_TEXTCENTEREDIN, 2, 2, 2, 168, 100, 76, 0, 10, 0, 0, 0, "{weather}", NULL, FIELD_NONE, 1, kSegs_footer_split_3 },
 };
 const int kOps_footer_split_count = sizeof(kOps_footer_split)/sizeof(kOps_footer_split[0]);
 
+const UiOpHeader kOps_header[] = {
+    { OP_LINE, 255, 0, 0, 1, 14, 249, 1, 1, 14, 249, 14, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_TEXT, 3, 1, 0, 7, 3, 0, 0, 0, 0, 0, 0, "{room_name}", NULL, FIELD_NONE, 1, kSegs_header_centered_1 },
+    { OP_TIMERIGHT, 5, 3, 1, 242, 14, 0, 0, 0, 0, 0, 0, "time_hhmm", NULL, FIELD_TIME_HHMM, 0, NULL },
+};
+const int kOps_header_count = sizeof(kOps_header)/sizeof(kOps_header[0]);
+
+const UiOpHeader kOps_inside_compact[] = {
+    { OP_TEXT, 8, 1, 0, 18, 19, 0, 0, 0, 0, 0, 0, "INSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEMPGROUPCENTERED, 10, 0, 2, 6, 39, 118, 0, 2, -1, 0, 0, "inside_temp_f", NULL, FIELD_INSIDE_TEMP_F, 0, NULL },
+    { OP_TEXT, 7, 2, 0, 7, 61, 0, 0, 0, 0, 0, 0, "{inside_hum_pct}% RH", NULL, FIELD_NONE, 2, kSegs_inside_3 },
+};
+const int kOps_inside_compact_count = sizeof(kOps_inside_compact)/sizeof(kOps_inside_compact[0]);
+
+const UiOpHeader kOps_outside_compact[] = {
+    { OP_TEXT, 11, 1, 0, 143, 19, 0, 0, 0, 0, 0, 0, "OUTSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEMPGROUPCENTERED, 14, 0, 2, 129, 42, 94, 0, 2, -1, 0, 0, "outside_temp_f", NULL, FIELD_OUTSIDE_TEMP_F, 0, NULL },
+    { OP_ICONIN, 16, 0, 0, 168, 90, 30, 32, 0, 0, 0, 0, "weather", NULL, FIELD_WEATHER, 0, NULL },
+    { OP_TEXT, 12, 2, 0, 132, 79, 0, 0, 0, 0, 0, 0, "{outside_hum_pct}% RH", NULL, FIELD_NONE, 2, kSegs_outside_4 },
+};
+const int kOps_outside_compact_count = sizeof(kOps_outside_compact)/sizeof(kOps_outside_compact[0]);
+
+const UiOpHeader kOps_inside_large[] = {
+    { OP_TEXT, 8, 1, 0, 18, 19, 0, 0, 0, 0, 0, 0, "INSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEMPGROUPCENTERED, 10, 0, 2, 6, 35, 118, 0, 3, 0, 0, 0, "inside_temp_f:.0f", NULL, FIELD_INSIDE_TEMP_F, 0, NULL },
+    { OP_TEXT, 7, 2, 0, 7, 61, 0, 0, 0, 0, 0, 0, "{inside_hum_pct}% RH", NULL, FIELD_NONE, 2, kSegs_inside_3 },
+};
+const int kOps_inside_large_count = sizeof(kOps_inside_large)/sizeof(kOps_inside_large[0]);
+
+const UiOpHeader kOps_outside_large[] = {
+    { OP_TEXT, 11, 1, 0, 143, 19, 0, 0, 0, 0, 0, 0, "OUTSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEMPGROUPCENTERED, 14, 0, 2, 129, 38, 94, 0, 3, 0, 0, 0, "outside_temp_f:.0f", NULL, FIELD_OUTSIDE_TEMP_F, 0, NULL },
+    { OP_ICONIN, 16, 0, 0, 168, 90, 30, 32, 0, 0, 0, 0, "weather", NULL, FIELD_WEATHER, 0, NULL },
+};
+const int kOps_outside_large_count = sizeof(kOps_outside_large)/sizeof(kOps_outside_large[0]);
+
+const UiOpHeader kOps_frame_low_battery[] = {
+    { OP_LINE, 255, 0, 0, 0, 0, 250, 1, 0, 0, 249, 0, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 0, 121, 250, 1, 0, 121, 249, 121, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 0, 0, 1, 122, 0, 0, 0, 121, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 249, 0, 1, 122, 249, 0, 249, 121, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 1, 18, 248, 1, 1, 18, 248, 18, NULL, NULL, FIELD_NONE, 0, NULL },
+    { OP_LINE, 255, 0, 0, 125, 18, 1, 103, 125, 18, 125, 120, NULL, NULL, FIELD_NONE, 0, NULL },
+};
+const int kOps_frame_low_battery_count = sizeof(kOps_frame_low_battery)/sizeof(kOps_frame_low_battery[0]);
+
+const UiOpHeader kOps_inside_minimal[] = {
+    { OP_TEXT, 8, 1, 0, 18, 19, 0, 0, 0, 0, 0, 0, "INSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEMPGROUPCENTERED, 10, 0, 2, 6, 39, 118, 0, 2, -1, 0, 0, "inside_temp_f", NULL, FIELD_INSIDE_TEMP_F, 0, NULL },
+};
+const int kOps_inside_minimal_count = sizeof(kOps_inside_minimal)/sizeof(kOps_inside_minimal[0]);
+
+const UiOpHeader kOps_outside_minimal[] = {
+    { OP_TEXT, 11, 1, 0, 143, 19, 0, 0, 0, 0, 0, 0, "OUTSIDE", NULL, FIELD_NONE, 0, NULL },
+    { OP_TEMPGROUPCENTERED, 14, 0, 2, 129, 42, 94, 0, 2, -1, 0, 0, "outside_temp_f", NULL, FIELD_OUTSIDE_TEMP_F, 0, NULL },
+};
+const int kOps_outside_minimal_count = sizeof(kOps_outside_minimal)/sizeof(kOps_outside_minimal[0]);
+
+const UiOpHeader kOps_footer_battery[] = {
+    { OP_BATTERYGLYPH, 0, 0, 0, 8, 87, 13, 7, 8, 87, 13, 7, "battery_percent", NULL, FIELD_BATTERY_PERCENT, 0, NULL },
+    { OP_TEXT, 0, 2, 1, 122, 86, 0, 0, 0, 0, 0, 0, "{battery_percent}% LOW", NULL, FIELD_NONE, 2, kSegs_footer_battery_1 },
+};
+const int kOps_footer_battery_count = sizeof(kOps_footer_battery)/sizeof(kOps_footer_battery[0]);
+
 const ComponentOps kVariant_v2_ops[] = {
+    { kOps_frame_v2, kOps_frame_v2_count, "frame" },
     { kOps_chrome, kOps_chrome_count, "chrome" },
     { kOps_header_centered, kOps_header_centered_count, "header_centered" },
     { kOps_inside, kOps_inside_count, "inside" },
@@ -65,9 +199,51 @@ const ComponentOps kVariant_v2_ops[] = {
 };
 const int kVariant_v2_ops_count = sizeof(kVariant_v2_ops)/sizeof(kVariant_v2_ops[0]);
 
+const ComponentOps kVariant_compact_ops[] = {
+    { kOps_frame_v2, kOps_frame_v2_count, "frame" },
+    { kOps_chrome, kOps_chrome_count, "chrome" },
+    { kOps_header, kOps_header_count, "header" },
+    { kOps_inside_compact, kOps_inside_compact_count, "inside_compact" },
+    { kOps_outside_compact, kOps_outside_compact_count, "outside_compact" },
+    { kOps_footer_split, kOps_footer_split_count, "footer_split" },
+};
+const int kVariant_compact_ops_count = sizeof(kVariant_compact_ops)/sizeof(kVariant_compact_ops[0]);
+
+const ComponentOps kVariant_large_digit_ops[] = {
+    { kOps_frame_v2, kOps_frame_v2_count, "frame" },
+    { kOps_chrome, kOps_chrome_count, "chrome" },
+    { kOps_header, kOps_header_count, "header" },
+    { kOps_inside_large, kOps_inside_large_count, "inside_large" },
+    { kOps_outside_large, kOps_outside_large_count, "outside_large" },
+    { kOps_footer_split, kOps_footer_split_count, "footer_split" },
+};
+const int kVariant_large_digit_ops_count = sizeof(kVariant_large_digit_ops)/sizeof(kVariant_large_digit_ops[0]);
+
+const ComponentOps kVariant_low_battery_ops[] = {
+    { kOps_frame_low_battery, kOps_frame_low_battery_count, "frame" },
+    { kOps_inside_minimal, kOps_inside_minimal_count, "inside_minimal" },
+    { kOps_outside_minimal, kOps_outside_minimal_count, "outside_minimal" },
+    { kOps_footer_battery, kOps_footer_battery_count, "footer_battery" },
+};
+const int kVariant_low_battery_ops_count = sizeof(kVariant_low_battery_ops)/sizeof(kVariant_low_battery_ops[0]);
+
+static const ComponentOps* const kVariantOps[kVariantCount] = {
+    kVariant_v2_ops,
+    kVariant_compact_ops,
+    kVariant_large_digit_ops,
+    kVariant_low_battery_ops,
+};
+static const int kVariantOpsCount[kVariantCount] = {
+    kVariant_v2_ops_count,
+    kVariant_compact_ops_count,
+    kVariant_large_digit_ops_count,
+    kVariant_low_battery_ops_count,
+};
+
 const ComponentOps* get_variant_ops(uint8_t variantId, int* outCount){
-  if (variantId == 0) { if(outCount) *outCount = kVariant_v2_ops_count; return kVariant_v2_ops; }
-  if(outCount) *outCount = 0; return nullptr;
+  if (variantId >= kVariantCount) { if(outCount) *outCount = 0; return nullptr; }
+  if(outCount) *outCount = kVariantOpsCount[variantId];
+  return kVariantOps[variantId];
 }
 
 } // namespace ui
@@ -12,6 +12,7 @@ enum RectId {
     RECT_HEADER_NAME,
     RECT_HEADER_TIME_CENTER,
     RECT_HEADER_VERSION,
+    RECT_INSIDE_HILO,
     RECT_INSIDE_HUMIDITY,
     RECT_INSIDE_LABEL,
     RECT_INSIDE_PRESSURE,
@@ -45,11 +46,53 @@ enum UiOpKind {
     OP_TIMERIGHT,
 };
 
-struct UiOpHeader { uint8_t kind; uint8_t rect; uint8_t font; uint8_t align; int16_t p0; int16_t p1; int16_t p2; int16_t p3; const char* s0; const char* s1; };
+enum FieldId {
+    FIELD_BATTERY_PERCENT,
+    FIELD_BATTERY_VOLTAGE,
+    FIELD_DAYS,
+    FIELD_FW_VERSION,
+    FIELD_INSIDE_HI_F,
+    FIELD_INSIDE_HUM_PCT,
+    FIELD_INSIDE_LO_F,
+    FIELD_INSIDE_TEMP_F,
+    FIELD_IP,
+    FIELD_OUTSIDE_HUM_PCT,
+    FIELD_OUTSIDE_PRESSURE_HPA,
+    FIELD_OUTSIDE_TEMP_F,
+    FIELD_PRESSURE_HPA,
+    FIELD_ROOM_NAME,
+    FIELD_TIME_HHMM,
+    FIELD_WEATHER,
+    FIELD_WIND_MPS,
+    FIELD__COUNT,
+};
+static constexpr uint8_t FIELD_NONE = 255;
+
+enum FieldConv { CONV_NONE=0, CONV_MPS_TO_MPH=1 };
+
+struct UiTextSeg { const char* lit; uint8_t field; uint8_t conv; int8_t decimals; };
+
+// x, y, w, h are resolved from the rects, so drawing does no layout work:
+//   line             x, y = top-left, w x h = 1 x len or len x 1
+//   text, time       x, y = text cursor; ALIGN_RIGHT ends the text at x,
+//   textCenteredIn   ALIGN_CENTER centers it across w from x (literal
+//                    text is placed here, so it is ALIGN_LEFT)
+//   tempGroupCentered  x, w = rect span, y = glyph top; p0 = text size,
+//                    p1 = decimals (-1 = field default)
+//   iconIn           x, y, w, h = rect
+//   batteryGlyph     x, y, w, h = glyph outline
+struct UiOpHeader { uint8_t kind; uint8_t rect; uint8_t font; uint8_t align; int16_t x; int16_t y; int16_t w; int16_t h; int16_t p0; int16_t p1; int16_t p2; int16_t p3; const char* s0; const char* s1; uint8_t field; uint8_t seg_count; const UiTextSeg* segs; };
+
+// RectId -> {x, y, w, h}
+extern const int kRectGeometry[RECT__COUNT][4];
 
 static constexpr const char* kVariantNames[] = {
     "v2",
+    "compact",
+    "large_digit",
+    "low_battery",
 };
+static constexpr uint8_t kVariantCount = 4;
 
 static constexpr const char* kVariant_v2_components[] = {
     "chrome",
@@ -58,18 +101,54 @@ static constexpr const char* kVariant_v2_components[] = {
     "outside",
     "footer_split",
 };
+static constexpr const char* kVariant_compact_components[] = {
+    "chrome",
+    "header",
+    "inside_compact",
+    "outside_compact",
+    "footer_split",
+};
+static constexpr const char* kVariant_large_digit_components[] = {
+    "chrome",
+    "header",
+    "inside_large",
+    "outside_large",
+    "footer_split",
+};
+static constexpr const char* kVariant_low_battery_components[] = {
+    "inside_minimal",
+    "outside_minimal",
+    "footer_battery",
+};
 
 static constexpr int kComponent_chrome_opcount = 6;
 static constexpr int kComponent_header_centered_opcount = 4;
 static constexpr int kComponent_header_opcount = 3;
-static constexpr int kComponent_inside_opcount = 4;
+static constexpr int kComponent_inside_opcount = 5;
 static constexpr int kComponent_outside_opcount = 6;
 static constexpr int kComponent_footer_split_opcount = 4;
-static constexpr int kTotalOpCount = 27;
+static constexpr int kComponent_inside_compact_opcount = 3;
+static constexpr int kComponent_outside_compact_opcount = 4;
+static constexpr int kComponent_inside_large_opcount = 3;
+static constexpr int kComponent_outside_large_opcount = 3;
+static constexpr int kComponent_inside_minimal_opcount = 2;
+static constexpr int kComponent_outside_minimal_opcount = 2;
+static constexpr int kComponent_footer_battery_opcount = 2;
+static constexpr int kTotalOpCount = 47;
+static constexpr int kVariant_v2_opcount = 26;
+static constexpr int kVariant_compact_opcount = 21;
+static constexpr int kVariant_large_digit_opcount = 20;
+static constexpr int kVariant_low_battery_opcount = 12;
 
 struct ComponentOps { const UiOpHeader* ops; int count; const char* name; };
 extern const ComponentOps kVariant_v2_ops[];
 extern const int kVariant_v2_ops_count;
+extern const ComponentOps kVariant_compact_ops[];
+extern const int kVariant_compact_ops_count;
+extern const ComponentOps kVariant_large_digit_ops[];
+extern const int kVariant_large_digit_ops_count;
+extern const ComponentOps kVariant_low_battery_ops[];
+extern const int kVariant_low_battery_ops_count;
 extern const ComponentOps* get_variant_ops(uint8_t variantId, int* outCount);
 
 } // namespace ui
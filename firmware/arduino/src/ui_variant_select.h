@@ -0,0 +1,41 @@
+#pragma once
+
+// Layout variant from the battery level (ui_spec.json "variants")
+// The base layout while the battery is healthy, a compact one (fewer ops,
+// fewer rects that can go dirty) once it runs low and the minimal
+// low-battery layout near empty. Leaving a layout takes a climb of
+// hysteresis_pct above its threshold, so a reading that wobbles around a
+// threshold does not flip the layout, and force a full refresh, every
+// wake. An unknown level (no gauge, USB power) keeps the base layout.
+//
+// Usage:
+//   UiVariantPolicy p = { ui::UIVAR_V2, ui::UIVAR_COMPACT, ui::UIVAR_LOW_BATTERY, 30, 15, 5 };
+//   uint8_t v = ui_variant_select(g_rtc_state.ui_variant, battery_pct, p);
+//   bool full = v != g_rtc_state.ui_variant;   // Another layout: redraw it all
+
+#include <cstdint>
+
+struct UiVariantPolicy {
+  uint8_t base;               // VariantId while healthy
+  uint8_t compact;
+  uint8_t low;
+  uint8_t compact_below_pct;  // 0 = never compact
+  uint8_t low_below_pct;      // 0 = never the low-battery layout
+  uint8_t hysteresis_pct;
+};
+
+// Variant for battery_pct (< 0 = unknown) given the one on the panel
+inline uint8_t ui_variant_select(uint8_t current, int battery_pct, const UiVariantPolicy& p) {
+  if (battery_pct < 0) return p.base;
+  if (battery_pct < p.low_below_pct) return p.low;
+  if (current == p.low && p.low_below_pct > 0 &&
+      battery_pct < p.low_below_pct + p.hysteresis_pct) {
+    return p.low;
+  }
+  if (battery_pct < p.compact_below_pct) return p.compact;
+  if ((current == p.compact || current == p.low) && p.compact_below_pct > 0 &&
+      battery_pct < p.compact_below_pct + p.hysteresis_pct) {
+    return p.compact;
+  }
+  return p.base;
+}
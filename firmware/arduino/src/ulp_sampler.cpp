@@ -0,0 +1,176 @@
+// ULP sampler implementation
+// Needs an ESP-IDF build of the ULP program: with framework = arduino, espidf
+// the component CMakeLists adds ulp_embed_binary(ulp_main "../ulp/main.c" ...)
+// and sdkconfig sets CONFIG_ESP32S2_ULP_COPROC_ENABLED / _RISCV. The plain
+// Arduino build has no ULP toolchain, hence the flag defaults off.
+
+#include "ulp_sampler.h"
+#include "feature_flags.h"
+
+#if FEATURE_ULP_SAMPLING
+#include "config.h"
+#include "generated_config.h"
+#include "rtc_state.h"
+#include "state_manager.h"
+#include "power.h"
+#include "offline_queue.h"
+#include "ulp_series.h"
+#include <Wire.h>
+#include <string.h>
+#include <time.h>
+#include <driver/gpio.h>
+#include <driver/rtc_io.h>
+#include <esp_sleep.h>
+#include <esp32s2/ulp.h>
+#include <esp32s2/ulp_riscv.h>
+#include <soc/rtc_cntl_reg.h>
+#include "ulp_main.h"   // Generated by ulp_embed_binary: ulp_shared
+
+#if !CONFIG_ESP32S2_ULP_COPROC_RISCV
+#error "FEATURE_ULP_SAMPLING needs an ESP-IDF build with CONFIG_ESP32S2_ULP_COPROC_RISCV"
+#endif
+#if !(USE_BME280 && BME280_DIRECT)
+#error "FEATURE_ULP_SAMPLING needs the direct BME280 driver (BME280_DIRECT)"
+#endif
+#if !defined(SDA) || !defined(SCL)
+#error "FEATURE_ULP_SAMPLING needs the board's SDA/SCL pins"
+#endif
+
+extern const uint8_t ulp_main_bin_start[] asm("_binary_ulp_main_bin_start");
+extern const uint8_t ulp_main_bin_end[] asm("_binary_ulp_main_bin_end");
+
+// Both sides are 32-bit little-endian with the same alignment rules
+static_assert(sizeof(UlpShared) == 308, "UlpShared layout must match the ULP build");
+
+// ULP clock is ~8.5 MHz; round up so the conversion is never read early
+static constexpr uint32_t ULP_CYCLES_PER_US = 9;
+// Longest a sample already in progress can take (bus + 9.3 ms conversion)
+static constexpr uint32_t ULP_BUSY_WAIT_MS = 20;
+
+static UlpShared g_snapshot;
+static bool g_have_snapshot = false;
+
+static UlpShared* ulp_block() {
+  return reinterpret_cast<UlpShared*>(&ulp_shared);
+}
+
+void ulp_sampler_wake() {
+  // Stop the ULP timer so no sample starts while the main cores own the bus,
+  // and let one already running finish
+  CLEAR_PERI_REG_MASK(RTC_CNTL_ULP_CP_TIMER_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+
+  // RTC slow memory only holds a valid block after a deep sleep
+  if (esp_reset_reason() != ESP_RST_DEEPSLEEP) return;
+
+  UlpShared* b = ulp_block();
+  uint32_t start = millis();
+  while (__atomic_load_n(&b->busy, __ATOMIC_ACQUIRE) && millis() - start < ULP_BUSY_WAIT_MS) {
+    delay(1);
+  }
+  rtc_gpio_deinit((gpio_num_t)SDA);
+  rtc_gpio_deinit((gpio_num_t)SCL);
+  #ifdef PIN_I2C_POWER
+  gpio_hold_dis((gpio_num_t)PIN_I2C_POWER);
+  #endif
+
+  memcpy(&g_snapshot, b, sizeof(g_snapshot));
+  b->magic = 0;
+  b->samples = 0;     // An unarmed sleep must not replay this series
+  g_have_snapshot = ulp_sample_count(&g_snapshot) > 0;
+  if (g_have_snapshot) {
+    Serial.printf("[ULP] %u samples during sleep, wake reason %u, %u bus errors\n",
+                  (unsigned)g_snapshot.samples, (unsigned)g_snapshot.wake_reason,
+                  (unsigned)g_snapshot.errors);
+  }
+}
+
+// A bus error or sensor reset leaves no trustworthy newest sample
+bool ulp_sampler_pending() {
+  return g_have_snapshot && g_rtc_state.bme280.addr != 0 &&
+         g_snapshot.wake_reason != ULP_WAKE_BUS_ERROR &&
+         g_snapshot.wake_reason != ULP_WAKE_SENSOR_RESET;
+}
+
+static Bme280Reading decode(uint32_t i) {
+  return bme280_compensate(g_rtc_state.bme280.calib, ulp_sample_at(&g_snapshot, i)->data);
+}
+
+bool ulp_sampler_take(InsideReadings& latest) {
+  if (!g_have_snapshot || g_rtc_state.bme280.addr == 0) return false;
+  bool pending = ulp_sampler_pending();
+  g_have_snapshot = false;
+
+  uint32_t n = ulp_sample_count(&g_snapshot);
+  #if FEATURE_OFFLINE_QUEUE
+  // Everything but the newest sample, which is this wake's own reading
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    Bme280Reading r = decode(i);
+    if (!isfinite(r.temperatureC)) continue;
+    uint32_t ts = ulp_sample_time(g_snapshot.armed_epoch, g_snapshot.period_sec,
+                                  ulp_sample_seq(&g_snapshot, i));
+    OfflineSample s = { ts, r.temperatureC, r.humidityPct, r.pressureHPa, true,
+                        isfinite(r.humidityPct), isfinite(r.pressureHPa) };
+    OfflineQueue::getInstance().push(s);
+  }
+  #endif
+  if (g_snapshot.wake_reason == ULP_WAKE_SENSOR_RESET) {
+    g_rtc_state.bme280.addr = 0;    // begin() reconfigures it
+  }
+  if (!pending) return false;
+
+  Bme280Reading r = decode(n - 1);
+  if (!isfinite(r.temperatureC)) return false;
+  latest.temperatureC = r.temperatureC;
+  latest.humidityPct = r.humidityPct;
+  latest.pressureHPa = r.pressureHPa;
+  return true;
+}
+
+bool ulp_sampler_arm() {
+  const Bme280Cache& cache = g_rtc_state.bme280;
+  if (cache.addr == 0) return false;
+  // Without a transmitted baseline every wake publishes anyway
+  float base_t = get_last_tx_inside_tempC();
+  if (!isfinite(base_t)) return false;
+
+  if (ulp_riscv_load_binary(ulp_main_bin_start, ulp_main_bin_end - ulp_main_bin_start) != ESP_OK) {
+    Serial.println("[ULP] Failed to load program");
+    return false;
+  }
+
+  UlpShared s;
+  memset(&s, 0, sizeof(s));
+  s.conversion_cycles = bme280_measure_time_us(BME280_OSRS_T, BME280_OSRS_P, BME280_OSRS_H) *
+                        ULP_CYCLES_PER_US;
+  s.armed_epoch = (uint32_t)time(nullptr);
+  s.period_sec = ULP_SAMPLE_PERIOD_SEC;
+  PublishPolicy policy = get_publish_policy();
+  ulp_set_windows(cache.calib, base_t, policy.temp_deadband_c,
+                  get_last_tx_inside_rh(), policy.rh_deadband_pct, s);
+  s.addr = cache.addr;
+  s.ctrl_meas = cache.ctrl_meas;
+  s.sda_pin = SDA;
+  s.scl_pin = SCL;
+  s.magic = ULP_SHARED_MAGIC;
+  memcpy(ulp_block(), &s, sizeof(s));
+
+  // Bus pins to the RTC domain for the ULP; sensor power held through sleep
+  Wire.end();
+  rtc_gpio_init((gpio_num_t)SDA);
+  rtc_gpio_init((gpio_num_t)SCL);
+  #ifdef PIN_I2C_POWER
+  gpio_hold_en((gpio_num_t)PIN_I2C_POWER);
+  gpio_deep_sleep_hold_en();
+  #endif
+
+  ulp_set_wakeup_period(0, ULP_SAMPLE_PERIOD_SEC * 1000000UL);
+  if (ulp_riscv_run() != ESP_OK) {
+    Serial.println("[ULP] Failed to start program");
+    return false;
+  }
+  esp_sleep_enable_ulp_wakeup();
+  Serial.printf("[ULP] Sampling every %u s until the next wake\n", (unsigned)ULP_SAMPLE_PERIOD_SEC);
+  return true;
+}
+
+#endif
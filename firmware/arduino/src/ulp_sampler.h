@@ -0,0 +1,31 @@
+#pragma once
+// ULP coprocessor sampling during deep sleep (FEATURE_ULP_SAMPLING)
+// The ULP RISC-V program in ulp/main.c reads the BME280 on its own timer
+// while the main cores sleep and wakes them only when a reading leaves the
+// skip-network deadband around the last transmitted values; the main timer
+// wake stays as the heartbeat. On the next wake the sensor phase takes the
+// ULP's newest sample instead of a fresh conversion and queues the older ones
+// in the offline history.
+//
+// Usage:
+//   ulp_sampler_wake();                  // Early in setup, before I2C is used
+//   InsideReadings r;
+//   if (!ulp_sampler_take(r)) r = read_sensors_with_timeout(...);
+//   ...
+//   ulp_sampler_arm();                   // Last thing before deep sleep
+
+#include "sensors.h"
+
+// Stop the ULP, hand the I2C pins back and keep what it sampled
+void ulp_sampler_wake();
+
+// True when ulp_sampler_take() has a reading for this wake
+bool ulp_sampler_pending();
+
+// Newest ULP sample as this wake's reading (at most once per wake); older
+// samples go to the offline history. False: take a fresh reading instead.
+bool ulp_sampler_take(InsideReadings& latest);
+
+// Load and start the ULP program for the coming sleep; false leaves the
+// main timer as the only wake source (no sensor setup or no baseline yet)
+bool ulp_sampler_arm();
@@ -0,0 +1,90 @@
+#pragma once
+
+// Main-core side of the ULP sampler
+// The ULP cannot afford floating point or the full compensation formulas, so
+// the deadbands are translated into raw BME280 ADC windows before sleep: the
+// range of adc_T whose compensated temperature stays within the temperature
+// deadband of the baseline, and the range of adc_H whose humidity (at the
+// baseline temperature) stays within the humidity deadband. Both formulas are
+// monotonic in the ADC value, so each bound is a binary search. Humidity is
+// judged at the baseline temperature; a temperature change large enough to
+// skew that wakes the main cores through the temperature window anyway.
+// Pressure has no window: it changes too slowly indoors to need a wake
+// before the heartbeat.
+//
+// Usage:
+//   UlpShared s = {};
+//   ulp_set_windows(cache.calib, 21.5f, 0.2f, 45.0f, 1.0f, s);
+//   ...
+//   uint32_t ts = ulp_sample_time(armed_epoch, 300, ulp_sample_seq(&s, i));
+
+#include <cmath>
+#include <cstdint>
+#include "bme280_core.h"
+#include "ulp_shared.h"
+
+static constexpr int32_t ULP_ADC_T_MAX = 0xFFFFF;
+static constexpr int32_t ULP_ADC_H_MAX = 0xFFFF;
+
+// First x in [lo, hi] with pred(x) true (pred monotonic false -> true);
+// hi + 1 when there is none
+template <typename Pred>
+inline int32_t ulp_lower_bound(int32_t lo, int32_t hi, Pred pred) {
+    int32_t first = lo;
+    int32_t count = hi - lo + 1;
+    while (count > 0) {
+        int32_t step = count / 2;
+        if (!pred(first + step)) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+// Compensated temperature in 0.01 degC
+inline int32_t ulp_temp_centi(const Bme280Calib& c, int32_t adc_t) {
+    return (bme280_t_fine(c, adc_t) * 5 + 128) >> 8;
+}
+
+// adc_T range whose temperature is within band of tempC (|delta| < band)
+inline void ulp_temp_window(const Bme280Calib& c, float tempC, float band,
+                            int32_t& adc_min, int32_t& adc_max) {
+    int32_t lo = (int32_t)lroundf((tempC - band) * 100.0f);
+    int32_t hi = (int32_t)lroundf((tempC + band) * 100.0f);
+    adc_min = ulp_lower_bound(0, ULP_ADC_T_MAX, [&](int32_t a) { return ulp_temp_centi(c, a) > lo; });
+    adc_max = ulp_lower_bound(0, ULP_ADC_T_MAX, [&](int32_t a) { return ulp_temp_centi(c, a) >= hi; }) - 1;
+}
+
+// adc_H range whose humidity at tempC is within band of rhPct
+inline void ulp_rh_window(const Bme280Calib& c, float tempC, float rhPct, float band,
+                          int32_t& adc_min, int32_t& adc_max) {
+    int32_t centi = (int32_t)lroundf(tempC * 100.0f);
+    int32_t adc_t = ulp_lower_bound(0, ULP_ADC_T_MAX, [&](int32_t a) { return ulp_temp_centi(c, a) >= centi; });
+    int32_t t_fine = bme280_t_fine(c, adc_t);
+    int32_t lo = (int32_t)lroundf((rhPct - band) * 1024.0f);
+    int32_t hi = (int32_t)lroundf((rhPct + band) * 1024.0f);
+    auto rh = [&](int32_t a) { return (int32_t)bme280_humidity_q22_10(c, a, t_fine); };
+    adc_min = ulp_lower_bound(0, ULP_ADC_H_MAX, [&](int32_t a) { return rh(a) > lo; });
+    adc_max = ulp_lower_bound(0, ULP_ADC_H_MAX, [&](int32_t a) { return rh(a) >= hi; }) - 1;
+}
+
+// Fill both windows; a NaN baseline leaves that window off (min > max)
+inline void ulp_set_windows(const Bme280Calib& c, float tempC, float temp_band,
+                            float rhPct, float rh_band, UlpShared& s) {
+    s.adc_t_min = 1;
+    s.adc_t_max = 0;
+    s.adc_h_min = 1;
+    s.adc_h_max = 0;
+    if (!std::isfinite(tempC)) return;
+    ulp_temp_window(c, tempC, temp_band, s.adc_t_min, s.adc_t_max);
+    if (std::isfinite(rhPct)) ulp_rh_window(c, tempC, rhPct, rh_band, s.adc_h_min, s.adc_h_max);
+}
+
+// The ULP timer fires once per period after arming; sample seq n is taken
+// about (n + 1) periods after armed_epoch
+inline uint32_t ulp_sample_time(uint32_t armed_epoch, uint32_t period_sec, uint32_t seq) {
+    return armed_epoch + (seq + 1) * period_sec;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+/* ULP sampler shared memory
+ * Layout of the block the ULP RISC-V program (ulp/main.c) and the main cores
+ * (ulp_sampler.cpp) share in RTC slow memory, plus the few helpers both sides
+ * need. The main cores fill the top half before deep sleep: the BME280
+ * address and ctrl_meas value, the conversion wait, and raw-ADC windows that
+ * correspond to the skip-network deadbands around the last transmitted
+ * reading (ulp_series.h). The ULP appends each raw 8-byte burst read to the
+ * ring and wakes the main cores when a sample leaves a window or the sensor
+ * stops answering; the main timer wake remains the heartbeat.
+ *
+ * Usage (ULP side):
+ *   ulp_push_sample(&shared, data);
+ *   if (ulp_check_sample(&shared, data) != ULP_WAKE_NONE) wake_main();
+ *
+ * Usage (main side):
+ *   for (uint32_t i = 0; i < ulp_sample_count(s); i++)
+ *     decode(ulp_sample_at(s, i)->data);                 // Oldest first
+ *
+ * Plain C so the ULP toolchain can build it.
+ */
+
+#include <stdint.h>
+
+#define ULP_SHARED_MAGIC 0x31504C55u  /* "ULP1": main cores armed the block */
+#define ULP_SAMPLE_SLOTS 32
+#define ULP_SAMPLE_BYTES 8            /* BME280 registers 0xF7..0xFE */
+
+/* Why the ULP woke the main cores */
+enum {
+  ULP_WAKE_NONE = 0,
+  ULP_WAKE_TEMP,            /* Temperature left its window */
+  ULP_WAKE_RH,              /* Humidity left its window */
+  ULP_WAKE_BUS_ERROR,       /* No ACK from the sensor */
+  ULP_WAKE_SENSOR_RESET     /* Channel read back as skipped: sensor lost its setup */
+};
+
+typedef struct {
+  uint8_t data[ULP_SAMPLE_BYTES];
+} UlpSample;
+
+typedef struct {
+  /* Written by the main cores before sleep */
+  uint32_t magic;
+  uint32_t conversion_cycles;   /* ULP cycles to wait after the trigger */
+  uint32_t armed_epoch;         /* time() when the ULP was started */
+  uint32_t period_sec;          /* ULP timer period */
+  int32_t adc_t_min;            /* A window with min > max is not checked */
+  int32_t adc_t_max;
+  int32_t adc_h_min;
+  int32_t adc_h_max;
+  uint8_t addr;
+  uint8_t ctrl_meas;            /* Oversampling bits; the ULP sets forced mode */
+  uint8_t sda_pin;              /* RTC GPIOs */
+  uint8_t scl_pin;
+  /* Written by the ULP */
+  uint32_t busy;                /* Set while a sample is in progress */
+  uint32_t samples;             /* Taken since arming; the ring keeps the last 32 */
+  uint32_t errors;
+  uint32_t wake_reason;
+  UlpSample ring[ULP_SAMPLE_SLOTS];
+} UlpShared;
+
+static inline int32_t ulp_adc_t(const uint8_t* d) {
+  return ((int32_t)d[3] << 12) | ((int32_t)d[4] << 4) | (d[5] >> 4);
+}
+
+static inline int32_t ulp_adc_h(const uint8_t* d) {
+  return ((int32_t)d[6] << 8) | d[7];
+}
+
+static inline int ulp_window_on(int32_t min, int32_t max) {
+  return min <= max;
+}
+
+/* ULP_WAKE_* for one burst read against the armed windows */
+static inline uint32_t ulp_check_sample(const UlpShared* s, const uint8_t* d) {
+  int32_t t = ulp_adc_t(d);
+  int32_t h = ulp_adc_h(d);
+  int h_on = ulp_window_on(s->adc_h_min, s->adc_h_max);
+  if (t == 0x80000 || (h_on && h == 0x8000)) return ULP_WAKE_SENSOR_RESET;
+  if (ulp_window_on(s->adc_t_min, s->adc_t_max) && (t < s->adc_t_min || t > s->adc_t_max))
+    return ULP_WAKE_TEMP;
+  if (h_on && (h < s->adc_h_min || h > s->adc_h_max)) return ULP_WAKE_RH;
+  return ULP_WAKE_NONE;
+}
+
+static inline void ulp_push_sample(UlpShared* s, const uint8_t* d) {
+  UlpSample* slot = &s->ring[s->samples % ULP_SAMPLE_SLOTS];
+  for (int i = 0; i < ULP_SAMPLE_BYTES; i++) slot->data[i] = d[i];
+  s->samples++;
+}
+
+/* Samples still held in the ring */
+static inline uint32_t ulp_sample_count(const UlpShared* s) {
+  return s->samples < ULP_SAMPLE_SLOTS ? s->samples : ULP_SAMPLE_SLOTS;
+}
+
+/* i = 0 is the oldest held sample, ulp_sample_count() - 1 the newest */
+static inline const UlpSample* ulp_sample_at(const UlpShared* s, uint32_t i) {
+  uint32_t first = s->samples - ulp_sample_count(s);
+  return &s->ring[(first + i) % ULP_SAMPLE_SLOTS];
+}
+
+/* Sequence number (0 = first sample after arming) of held sample i */
+static inline uint32_t ulp_sample_seq(const UlpShared* s, uint32_t i) {
+  return s->samples - ulp_sample_count(s) + i;
+}
@@ -0,0 +1,87 @@
+#include "wake_arena.h"
+#include "config.h"
+#include <cstdlib>
+
+// RTC memory - persists across deep sleep
+RTC_DATA_ATTR uint32_t WakeArena::peak_max_ = 0;
+
+alignas(BumpArena::ALIGN) static uint8_t s_storage[WAKE_ARENA_BYTES];
+
+namespace {
+
+class WakeJsonAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override {
+        return WakeArena::getInstance().allocate(size);
+    }
+    void deallocate(void* ptr) override {
+        WakeArena::getInstance().deallocate(ptr);
+    }
+    void* reallocate(void* ptr, size_t new_size) override {
+        return WakeArena::getInstance().reallocate(ptr, new_size);
+    }
+};
+
+WakeJsonAllocator s_json_allocator;
+
+}  // namespace
+
+WakeArena& WakeArena::getInstance() {
+    static WakeArena instance;
+    return instance;
+}
+
+WakeArena::WakeArena() : arena_(s_storage, sizeof(s_storage)) {}
+
+ArduinoJson::Allocator* WakeArena::jsonAllocator() {
+    return &s_json_allocator;
+}
+
+void* WakeArena::allocate(size_t size) {
+    void* p = arena_.allocate(size);
+    if (p) return p;
+    heap_fallbacks_++;
+    return malloc(size);
+}
+
+void WakeArena::deallocate(void* ptr) {
+    if (!ptr) return;
+    if (arena_.owns(ptr)) {
+        arena_.deallocate(ptr);
+    } else {
+        free(ptr);
+    }
+}
+
+void* WakeArena::reallocate(void* ptr, size_t new_size) {
+    if (!ptr) return allocate(new_size);
+    if (!arena_.owns(ptr)) return realloc(ptr, new_size);
+
+    void* p = arena_.reallocate(ptr, new_size);
+    if (p) return p;
+
+    // Arena exhausted: move the block to the heap
+    heap_fallbacks_++;
+    p = malloc(new_size);
+    if (p) {
+        size_t old_max = arena_.extent(ptr);
+        memcpy(p, ptr, old_max < new_size ? old_max : new_size);
+        arena_.deallocate(ptr);
+    }
+    return p;
+}
+
+void WakeArena::reset() {
+    if (arena_.peak() > peak_max_) peak_max_ = (uint32_t)arena_.peak();
+    arena_.reset();
+}
+
+void WakeArena::formatJson(char* out, size_t out_size) const {
+    uint32_t peak_max = peak_max_ > arena_.peak() ? peak_max_ : (uint32_t)arena_.peak();
+    snprintf(out, out_size,
+             "{\"capacity\":%u,\"used\":%u,\"peak\":%u,\"peak_max\":%lu,\"allocs\":%lu,"
+             "\"full\":%lu,\"heap_fallbacks\":%lu}",
+             (unsigned)arena_.capacity(), (unsigned)arena_.used(), (unsigned)arena_.peak(),
+             (unsigned long)peak_max, (unsigned long)arena_.allocations(),
+             (unsigned long)arena_.failures(), (unsigned long)heap_fallbacks_);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "bump_arena.h"
+
+// Per-wake scratch arena
+// One WAKE_ARENA_BYTES bump arena (config.h) for transient formatting and
+// JSON documents. Allocation is a pointer increment, nothing fragments, and
+// run_sleep_phase() resets it in one step. When the arena is full, requests
+// fall back to the heap and are counted, so a bad sizing shows up in stats
+// instead of failures. The largest peak of recent wakes is kept in RTC memory.
+//
+// Usage:
+//   WakeArena::Scope scratch;                  // Rewound on scope exit
+//   JsonDocument doc(WakeArena::jsonAllocator());
+//   char* buf = (char*)WakeArena::getInstance().allocate(200);
+//
+// Declare the Scope before anything allocated from it. Single task only
+// (loopTask); do not use from ISRs or other tasks.
+
+class WakeArena {
+public:
+    static WakeArena& getInstance();
+
+    // Arena memory, or heap memory once the arena is full (nullptr if both fail)
+    void* allocate(size_t size);
+    void deallocate(void* ptr);
+    void* reallocate(void* ptr, size_t new_size);
+
+    // End of wake: drop everything and fold this wake's peak into RTC stats
+    void reset();
+
+    // ArduinoJson adapter over this arena (JsonDocument doc(jsonAllocator()))
+    static ArduinoJson::Allocator* jsonAllocator();
+
+    // Scratch region released when the scope ends
+    class Scope {
+    public:
+        Scope() : mark_(WakeArena::getInstance().arena_.mark()) {}
+        ~Scope() { WakeArena::getInstance().arena_.rewind(mark_); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        size_t mark_;
+    };
+
+    const BumpArena& arena() const { return arena_; }
+    uint32_t heapFallbacks() const { return heap_fallbacks_; }
+
+    // {"capacity":4096,"used":0,"peak":812,"peak_max":1204,"allocs":9,"full":0,"heap_fallbacks":0}
+    void formatJson(char* out, size_t out_size) const;
+
+private:
+    WakeArena();
+    ~WakeArena() = default;
+    WakeArena(const WakeArena&) = delete;
+    WakeArena& operator=(const WakeArena&) = delete;
+
+    BumpArena arena_;
+    uint32_t heap_fallbacks_ = 0;
+
+    // RTC memory storage (persists across deep sleep)
+    RTC_DATA_ATTR static uint32_t peak_max_;
+};
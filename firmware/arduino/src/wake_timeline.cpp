@@ -0,0 +1,182 @@
+#include "wake_timeline.h"
+#include "cpu_freq.h"
+#include "mqtt_stream.h"
+
+// RTC memory - persists across deep sleep
+RTC_DATA_ATTR WakeTimeline::Ring WakeTimeline::ring_ = {};
+
+WakeTimeline& WakeTimeline::getInstance() {
+    static WakeTimeline instance;
+    return instance;
+}
+
+void WakeTimeline::begin() {
+    if (initialized_) return;
+
+    validateRing();
+
+    memset(&current_, 0, sizeof(current_));
+    current_.wake_index = ring_.next_wake_index++;
+    current_.t_us[BOOT] = (uint32_t)esp_timer_get_time();
+    if (current_.t_us[BOOT] == 0) current_.t_us[BOOT] = 1;
+
+    committed_ = false;
+    initialized_ = true;
+}
+
+void WakeTimeline::mark(Milestone m) {
+    if (!initialized_ || m >= MILESTONE_COUNT) return;
+    if (current_.t_us[m] != 0) return;
+
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    current_.t_us[m] = now ? now : 1;
+}
+
+void WakeTimeline::setFlag(Flag f) {
+    if (!initialized_) return;
+    current_.flags |= f;
+}
+
+void WakeTimeline::commit() {
+    if (!initialized_ || committed_) return;
+
+    mark(SLEEP_ENTERED);
+    #if FEATURE_CPU_FREQ_SCALING
+    current_.low_clock_us = cpu_freq_low_clock_us();
+    #endif
+
+    ring_.records[ring_.head] = current_;
+    ring_.head = (ring_.head + 1) % MAX_RECORDS;
+    if (ring_.count < MAX_RECORDS) ring_.count++;
+    if (ring_.pending < MAX_RECORDS) ring_.pending++;
+
+    committed_ = true;
+}
+
+size_t WakeTimeline::getPendingCount() const {
+    return ring_.magic == TIMELINE_MAGIC ? ring_.pending : 0;
+}
+
+bool WakeTimeline::publishPending(PubSubClient* client, const char* client_id) {
+    if (getPendingCount() == 0) return true;
+    if (!client || !client->connected() || !client_id || !client_id[0]) return false;
+
+    char topic[96];
+    snprintf(topic, sizeof(topic), "espsensor/%s%s", client_id, TOPIC_SUFFIX);
+
+    // Streamed: eight records with every milestone outgrow a fixed buffer
+    bool sent = mqtt_publish_json_stream(client, topic, false, [this](JsonStream& j) {
+        j.beginObject();
+        writeJson(j, true);
+        j.endObject();
+    });
+    if (!sent) {
+        Serial.println("[Timeline] Publish failed, keeping records for next wake");
+        return false;
+    }
+
+    ring_.pending = 0;
+    return true;
+}
+
+void WakeTimeline::writeJson(JsonStream& j, bool pending_only) const {
+    j.field("v", 3).beginArray("ms");
+    for (uint8_t m = 0; m < MILESTONE_COUNT; m++) j.field(nullptr, milestoneName((Milestone)m));
+    j.endArray().beginArray("w");
+
+    size_t n = 0;
+    if (ring_.magic == TIMELINE_MAGIC) {
+        n = pending_only ? ring_.pending : ring_.count;
+    }
+    size_t start = (ring_.head + MAX_RECORDS - n) % MAX_RECORDS;
+
+    for (size_t i = 0; i < n; i++) {
+        const Record& r = ring_.records[(start + i) % MAX_RECORDS];
+        j.beginArray().field(nullptr, r.wake_index);
+        for (uint8_t m = 0; m < MILESTONE_COUNT; m++) j.field(nullptr, r.t_us[m]);
+        j.field(nullptr, r.low_clock_us).field(nullptr, r.flags).endArray();
+    }
+    j.endArray();
+}
+
+void WakeTimeline::formatJson(char* out, size_t out_size, bool pending_only) const {
+    if (!out || out_size == 0) return;
+
+    int written = snprintf(out, out_size, "{\"v\":3,\"ms\":[");
+    if (written < 0 || (size_t)written >= out_size) { out[0] = '\0'; return; }
+    size_t pos = (size_t)written;
+
+    for (uint8_t m = 0; m < MILESTONE_COUNT; m++) {
+        written = snprintf(out + pos, out_size - pos, "%s\"%s\"",
+                           m ? "," : "", milestoneName((Milestone)m));
+        if (written < 0 || (size_t)written >= out_size - pos) break;
+        pos += (size_t)written;
+    }
+
+    written = snprintf(out + pos, out_size - pos, "],\"w\":[");
+    if (written > 0 && (size_t)written < out_size - pos) pos += (size_t)written;
+
+    size_t n = 0;
+    if (ring_.magic == TIMELINE_MAGIC) {
+        n = pending_only ? ring_.pending : ring_.count;
+    }
+    size_t start = (ring_.head + MAX_RECORDS - n) % MAX_RECORDS;
+
+    for (size_t i = 0; i < n; i++) {
+        const Record& r = ring_.records[(start + i) % MAX_RECORDS];
+
+        // Reserve room for this record plus the closing "]}"
+        char rec[160];
+        int len = snprintf(rec, sizeof(rec), "%s[%u", i ? "," : "", r.wake_index);
+        for (uint8_t m = 0; m < MILESTONE_COUNT && len > 0 && (size_t)len < sizeof(rec); m++) {
+            len += snprintf(rec + len, sizeof(rec) - len, ",%u", r.t_us[m]);
+        }
+        if (len > 0 && (size_t)len < sizeof(rec)) {
+            len += snprintf(rec + len, sizeof(rec) - len, ",%u,%u", r.low_clock_us, r.flags);
+        }
+        if (len < 0 || (size_t)len >= sizeof(rec) - 1) break;
+        rec[len++] = ']';
+        rec[len] = '\0';
+
+        if (pos + (size_t)len + 3 > out_size) break;  // Keep JSON valid if truncated
+        memcpy(out + pos, rec, (size_t)len + 1);
+        pos += (size_t)len;
+    }
+
+    if (pos + 3 <= out_size) {
+        memcpy(out + pos, "]}", 3);
+    } else if (out_size >= 3) {
+        out[out_size - 3] = ']';
+        out[out_size - 2] = '}';
+        out[out_size - 1] = '\0';
+    }
+}
+
+const char* WakeTimeline::milestoneName(Milestone m) {
+    switch (m) {
+        case BOOT:            return "boot";
+        case SENSOR_READY:    return "sensor";
+        case WIFI_ASSOCIATED: return "wifi";
+        case TCP_CONNECTED:   return "tcp";
+        case TLS_ESTABLISHED: return "tls";
+        case MQTT_CONNECTED:  return "mqtt";
+        case BATCH_FLUSHED:   return "flush";
+        case DISPLAY_DONE:    return "display";
+        case LOGS_COMMITTED:  return "logs";
+        case SLEEP_ENTERED:   return "sleep";
+        default:              return "?";
+    }
+}
+
+void WakeTimeline::validateRing() {
+    if (ring_.magic == TIMELINE_MAGIC &&
+        ring_.head < MAX_RECORDS &&
+        ring_.count <= MAX_RECORDS &&
+        ring_.pending <= ring_.count) {
+        return;
+    }
+
+    // First boot or corrupted RTC memory - start clean
+    memset(&ring_, 0, sizeof(ring_));
+    ring_.magic = TIMELINE_MAGIC;
+}
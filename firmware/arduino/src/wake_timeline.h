@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "feature_flags.h"
+#include "json_stream.h"
+
+// Wake-cycle timeline recorder
+// Records microsecond timestamps for each milestone of a wake cycle and keeps
+// the last few cycles in RTC memory so they survive deep sleep. Completed
+// records are published as one compact JSON payload on the next wake.
+//
+// Usage:
+//   WakeTimeline::getInstance().begin();                      // First thing in setup
+//   WakeTimeline::getInstance().mark(WakeTimeline::SENSOR_READY);
+//   ...
+//   WakeTimeline::getInstance().publishPending(client, client_id);
+//   WakeTimeline::getInstance().commit();                     // Just before deep sleep
+//
+// Payload (espsensor/<id>/debug/timeline):
+//   {"v":3,"ms":["boot","sensor","wifi","tcp","tls","mqtt","flush","display","logs","sleep"],
+//    "w":[[wake,t0,t1,...,t9,lc,fl],...]}
+//   Each t is microseconds since reset; 0 means the milestone was not reached
+//   (tcp and tls only with MQTT_TLS: tls - tcp is the handshake).
+//   lc is the microseconds the wake ran below CPU_FREQ_COMPUTE_MHZ (cpu_freq.h).
+//   fl is a bit set of Flag values (1 = TLS session resumed).
+
+class PubSubClient;
+
+class WakeTimeline {
+public:
+    enum Milestone : uint8_t {
+        BOOT = 0,
+        SENSOR_READY,
+        WIFI_ASSOCIATED,
+        TCP_CONNECTED,       // Broker socket open (MQTT_TLS)
+        TLS_ESTABLISHED,     // Handshake done (MQTT_TLS)
+        MQTT_CONNECTED,
+        BATCH_FLUSHED,
+        DISPLAY_DONE,
+        LOGS_COMMITTED,      // NVS log blob written (commit cost = logs - display)
+        SLEEP_ENTERED,
+        MILESTONE_COUNT
+    };
+
+    enum Flag : uint32_t {
+        FLAG_TLS_RESUMED = 1u << 0,     // Abbreviated handshake from the RTC session
+    };
+
+    static constexpr size_t MAX_RECORDS = 8;
+    static constexpr uint32_t TIMELINE_MAGIC = 0x574B5434;  // "WKT4" (bump when Record changes)
+    static constexpr const char* TOPIC_SUFFIX = "/debug/timeline";
+
+    struct Record {
+        uint32_t wake_index;                 // Monotonic wake counter
+        uint32_t t_us[MILESTONE_COUNT];      // Microseconds since reset, 0 = not reached
+        uint32_t low_clock_us;               // Time spent at the reduced CPU clock
+        uint32_t flags;                      // Flag bits
+    };
+
+    static WakeTimeline& getInstance();
+
+    // Start a new record for this wake (stamps BOOT)
+    void begin();
+
+    // Stamp a milestone for the current wake (first stamp wins)
+    void mark(Milestone m);
+
+    // Set a Flag bit on the current wake's record
+    void setFlag(Flag f);
+
+    // Stamp SLEEP_ENTERED and store the current record in the RTC ring
+    void commit();
+
+    // Publish records from earlier wakes that have not been sent yet
+    // Returns true if there was nothing to send or the publish succeeded
+    bool publishPending(PubSubClient* client, const char* client_id);
+
+    // Number of stored records not yet published
+    size_t getPendingCount() const;
+
+    // Access the in-progress record for this wake
+    const Record& getCurrent() const { return current_; }
+
+    // Format stored records (oldest first) as the compact payload
+    // If pending_only is true, only unpublished records are included
+    void formatJson(char* out, size_t out_size, bool pending_only) const;
+
+    // Same payload streamed, members only (into an open object), every record
+    void writeJson(JsonStream& j, bool pending_only) const;
+
+    static const char* milestoneName(Milestone m);
+
+private:
+    WakeTimeline() = default;
+    ~WakeTimeline() = default;
+    WakeTimeline(const WakeTimeline&) = delete;
+    WakeTimeline& operator=(const WakeTimeline&) = delete;
+
+    struct Ring {
+        uint32_t magic;
+        uint32_t next_wake_index;
+        uint8_t head;        // Next slot to write
+        uint8_t count;       // Valid records
+        uint8_t pending;     // Records not yet published (newest ones)
+        Record records[MAX_RECORDS];
+    };
+
+    // RTC memory storage (persists across deep sleep)
+    RTC_DATA_ATTR static Ring ring_;
+
+    Record current_ = {};
+    bool initialized_ = false;
+    bool committed_ = false;
+
+    void validateRing();
+};
+
+#if FEATURE_WAKE_TIMELINE
+  #define WAKE_MARK(m) WakeTimeline::getInstance().mark(WakeTimeline::m)
+#else
+  #define WAKE_MARK(m) ((void)0)
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+// Weather-condition classification
+// Collapses a condition string (Home Assistant state, MDI icon name,
+// OpenWeather icon code or free-form text) into a WeatherKind once, when the
+// value arrives over MQTT, so the renderers and the render-model hash work
+// on a one-byte enum instead of re-scanning the text every wake.
+//
+// Usage:
+//   o.weatherKind = weather_classify(o.weather);
+//   IconId icon = weather_kind_icon((WeatherKind)o.weatherKind);  // display_renderer.h
+//
+// Exact values go through the perfect-hash table generated by
+// scripts/gen_weather_table.py (one hash, one slot read, one strcmp); only
+// unknown text falls back to the keyword heuristics.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "weather_table_generated.h"
+
+// FNV-1a with the generated seed; must match scripts/gen_weather_table.py
+inline uint32_t weather_table_hash(const char* s) {
+  uint32_t h = WEATHER_TABLE_SEED;
+  for (; *s; ++s) h = (h ^ (uint8_t)*s) * 16777619u;
+  return h;
+}
+
+// Exact lookup of an already lower-cased key; WEATHER_KIND_UNKNOWN on a miss
+inline WeatherKind weather_table_lookup(const char* key) {
+  uint8_t idx = kWeatherTableSlots[weather_table_hash(key) >> WEATHER_TABLE_SHIFT];
+  if (idx == WEATHER_TABLE_EMPTY) return WEATHER_KIND_UNKNOWN;
+  const WeatherTableKey& k = kWeatherTableKeys[idx];
+  return strcmp(k.key, key) == 0 ? k.kind : WEATHER_KIND_UNKNOWN;
+}
+
+// OpenWeather icon/condition code prefix ("10n", "801"), or UNKNOWN
+inline WeatherKind weather_classify_code(const char* s) {
+  if (!(s[0] >= '0' && s[0] <= '9' && s[1] >= '0' && s[1] <= '9')) return WEATHER_KIND_UNKNOWN;
+  bool night = strchr(s, 'n') != nullptr;
+  switch ((s[0] - '0') * 10 + (s[1] - '0')) {
+    case 1: return night ? WEATHER_KIND_NIGHT : WEATHER_KIND_SUNNY;
+    case 2: return night ? WEATHER_KIND_NIGHT_PARTLY_CLOUDY : WEATHER_KIND_PARTLY_CLOUDY;
+    case 3:
+    case 4: return WEATHER_KIND_CLOUDY;
+    case 9: return WEATHER_KIND_DRIZZLE;    // showers/drizzle
+    case 10: return WEATHER_KIND_POURING;   // rain
+    case 11: return WEATHER_KIND_LIGHTNING;
+    case 13: return WEATHER_KIND_SNOWY;
+    case 50: return WEATHER_KIND_FOG;       // atmosphere group
+    case 51:
+    case 53:
+    case 61: return WEATHER_KIND_DRIZZLE;   // drizzle variants, light rain
+    case 80: return WEATHER_KIND_POURING;   // shower rain
+    default: return WEATHER_KIND_UNKNOWN;
+  }
+}
+
+// Classify a condition string; WEATHER_KIND_UNKNOWN only for null/empty text
+inline WeatherKind weather_classify(const char* text) {
+  if (!text || !text[0]) return WEATHER_KIND_UNKNOWN;
+
+  // Lower-case once into a stack buffer (no String allocation)
+  char s[64];
+  size_t n = 0;
+  for (; text[n] && n < sizeof(s) - 1; ++n) {
+    char c = text[n];
+    s[n] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+  }
+  s[n] = '\0';
+
+  WeatherKind k = weather_table_lookup(s);
+  if (k != WEATHER_KIND_UNKNOWN) return k;
+  k = weather_classify_code(s);
+  if (k != WEATHER_KIND_UNKNOWN) return k;
+
+  // Free-form text: keyword heuristics, most specific first
+  if (strstr(s, "tornado")) return WEATHER_KIND_TORNADO;
+  if (strstr(s, "hurricane")) return WEATHER_KIND_HURRICANE;
+  if (strstr(s, "drizzle")) return WEATHER_KIND_DRIZZLE;
+  if (strstr(s, "storm") || strstr(s, "thunder") || strstr(s, "lightning"))
+    return WEATHER_KIND_LIGHTNING;
+  if (strstr(s, "pour") || strstr(s, "rain") || strstr(s, "shower"))
+    return WEATHER_KIND_POURING;
+  if (strstr(s, "snow")) return WEATHER_KIND_SNOWY;
+  if (strstr(s, "fog") || strstr(s, "mist") || strstr(s, "haze")) return WEATHER_KIND_FOG;
+  if (strstr(s, "part")) return WEATHER_KIND_PARTLY_CLOUDY;
+  if (strstr(s, "cloud") || strstr(s, "overcast")) return WEATHER_KIND_CLOUDY;
+  if (strstr(s, "night")) return WEATHER_KIND_NIGHT;
+  return WEATHER_KIND_SUNNY;
+}
@@ -0,0 +1,89 @@
+// AUTO-GENERATED by scripts/gen_weather_table.py — DO NOT EDIT
+#pragma once
+
+#include <stdint.h>
+
+enum WeatherKind : uint8_t {
+    WEATHER_KIND_UNKNOWN,
+    WEATHER_KIND_SUNNY,
+    WEATHER_KIND_PARTLY_CLOUDY,
+    WEATHER_KIND_CLOUDY,
+    WEATHER_KIND_FOG,
+    WEATHER_KIND_POURING,
+    WEATHER_KIND_DRIZZLE,
+    WEATHER_KIND_SNOWY,
+    WEATHER_KIND_LIGHTNING,
+    WEATHER_KIND_HURRICANE,
+    WEATHER_KIND_TORNADO,
+    WEATHER_KIND_NIGHT,
+    WEATHER_KIND_NIGHT_PARTLY_CLOUDY,
+    WEATHER_KIND__COUNT,
+};
+
+static constexpr uint32_t WEATHER_TABLE_SEED = 0x811EEFACu;
+static constexpr uint8_t WEATHER_TABLE_SLOTS = 128;
+static constexpr uint8_t WEATHER_TABLE_SHIFT = 25;  // slot = hash >> shift
+static constexpr uint8_t WEATHER_TABLE_EMPTY = 0xFF;
+
+struct WeatherTableKey {
+    const char* key;
+    WeatherKind kind;
+};
+
+static const WeatherTableKey kWeatherTableKeys[43] = {
+    {"clear-night", WEATHER_KIND_NIGHT},
+    {"cloudy", WEATHER_KIND_CLOUDY},
+    {"exceptional", WEATHER_KIND_CLOUDY},
+    {"fog", WEATHER_KIND_FOG},
+    {"hail", WEATHER_KIND_SNOWY},
+    {"lightning", WEATHER_KIND_LIGHTNING},
+    {"lightning-rainy", WEATHER_KIND_LIGHTNING},
+    {"partlycloudy", WEATHER_KIND_PARTLY_CLOUDY},
+    {"pouring", WEATHER_KIND_POURING},
+    {"rainy", WEATHER_KIND_POURING},
+    {"snowy", WEATHER_KIND_SNOWY},
+    {"snowy-rainy", WEATHER_KIND_SNOWY},
+    {"sunny", WEATHER_KIND_SUNNY},
+    {"windy", WEATHER_KIND_CLOUDY},
+    {"windy-variant", WEATHER_KIND_CLOUDY},
+    {"weather-sunny", WEATHER_KIND_SUNNY},
+    {"weather-partly-cloudy", WEATHER_KIND_PARTLY_CLOUDY},
+    {"weather-cloudy", WEATHER_KIND_CLOUDY},
+    {"weather-fog", WEATHER_KIND_FOG},
+    {"weather-pouring", WEATHER_KIND_POURING},
+    {"weather-rainy", WEATHER_KIND_POURING},
+    {"weather-snowy", WEATHER_KIND_SNOWY},
+    {"weather-lightning", WEATHER_KIND_LIGHTNING},
+    {"weather-night", WEATHER_KIND_NIGHT},
+    {"weather-night-partly-cloudy", WEATHER_KIND_NIGHT_PARTLY_CLOUDY},
+    {"01d", WEATHER_KIND_SUNNY},
+    {"01n", WEATHER_KIND_NIGHT},
+    {"02d", WEATHER_KIND_PARTLY_CLOUDY},
+    {"02n", WEATHER_KIND_NIGHT_PARTLY_CLOUDY},
+    {"03d", WEATHER_KIND_CLOUDY},
+    {"03n", WEATHER_KIND_CLOUDY},
+    {"04d", WEATHER_KIND_CLOUDY},
+    {"04n", WEATHER_KIND_CLOUDY},
+    {"09d", WEATHER_KIND_DRIZZLE},
+    {"09n", WEATHER_KIND_DRIZZLE},
+    {"10d", WEATHER_KIND_POURING},
+    {"10n", WEATHER_KIND_POURING},
+    {"11d", WEATHER_KIND_LIGHTNING},
+    {"11n", WEATHER_KIND_LIGHTNING},
+    {"13d", WEATHER_KIND_SNOWY},
+    {"13n", WEATHER_KIND_SNOWY},
+    {"50d", WEATHER_KIND_FOG},
+    {"50n", WEATHER_KIND_FOG},
+};
+
+// Slot -> index into kWeatherTableKeys (WEATHER_TABLE_EMPTY = no key)
+static const uint8_t kWeatherTableSlots[WEATHER_TABLE_SLOTS] = {
+      5, 255, 255, 255, 255, 255, 255, 255, 255,  27, 255,  33,  28,  26,  34, 255,
+    255, 255,  25, 255, 255, 255, 255, 255, 255, 255,  24,  15, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255,  14, 255, 255,   2, 255, 255, 255, 255,  22, 255,
+     37, 255,  12,  38, 255, 255,  18, 255, 255,  19, 255, 255, 255, 255, 255,  35,
+    255,   3, 255,  40,  36, 255,  39,  21, 255, 255, 255, 255, 255, 255, 255,  23,
+     17,   4,   1, 255, 255, 255, 255, 255,  11,   6, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255,   7,  41, 255, 255,  13, 255,  42, 255,   9, 255, 255, 255,
+    255,   8, 255, 255, 255, 255,  16,  31,  29,  10, 255, 255,  32,  30,  20,   0,
+};
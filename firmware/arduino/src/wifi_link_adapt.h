@@ -0,0 +1,131 @@
+#pragma once
+
+// Per-device WiFi link tuning from the last few wakes (FEATURE_WIFI_LINK_ADAPT)
+// Every connect records the RSSI it associated at and how many attempts it
+// took (or that it failed) in a small ring kept in the RTC state block. The
+// next wake derives its link settings from that ring:
+//   - TX power: a device whose weakest recent RSSI is well above the target
+//     lowers its transmit power by the margin (the path is about symmetric,
+//     so the AP still hears it near the target). Any retry or failure in
+//     the window puts it back at full power.
+//   - Protocol: near devices use 11g/n only, so the rate never falls back
+//     to 11b airtime; everyone else keeps 11b for its range.
+//   - Listen interval: near devices sleep across more beacons while idle.
+//   - Backoff: reliable devices try fewer times and sooner (a failure is
+//     the AP being down), flaky ones more times with longer waits.
+//
+// Usage:
+//   WifiLinkPolicy p = { 78, 34, -67, -55, 3, 1000 };
+//   WifiLinkTuning t = wifi_link_tune(g_rtc_state.wifi_link, p);
+//   esp_wifi_set_max_tx_power(t.tx_qdbm);
+//   esp_wifi_set_protocol(WIFI_IF_STA, t.protocol);
+//   ...
+//   wifi_link_record(g_rtc_state.wifi_link, WiFi.RSSI(), attempts, connected);
+
+#include <cstddef>
+#include <cstdint>
+
+// Same bits as WIFI_PROTOCOL_11B / _11G / _11N (esp_wifi_types.h)
+static constexpr uint8_t WIFI_LINK_PROTO_11B = 0x1;
+static constexpr uint8_t WIFI_LINK_PROTO_11G = 0x2;
+static constexpr uint8_t WIFI_LINK_PROTO_11N = 0x4;
+
+static constexpr size_t WIFI_LINK_HISTORY = 8;          // Wakes in the window
+static constexpr uint8_t WIFI_LINK_MIN_SAMPLES = 3;     // Before power is lowered
+static constexpr uint8_t WIFI_LINK_LISTEN_DEFAULT = 3;  // Beacons (driver default)
+static constexpr uint8_t WIFI_LINK_LISTEN_NEAR = 10;
+static constexpr uint8_t WIFI_LINK_MAX_ATTEMPTS = 5;
+
+struct WifiLinkSample {
+  int8_t rssi_dbm;            // At association, 0 when the connect failed
+  uint8_t attempts;           // Connect attempts this wake
+  uint8_t ok;
+  uint8_t reserved;
+};
+
+// Kept in RTC memory between wakes
+struct WifiLinkHistory {
+  WifiLinkSample samples[WIFI_LINK_HISTORY];
+  uint8_t head;               // Next slot to write
+  uint8_t count;
+  uint8_t reserved[2];
+};
+
+struct WifiLinkPolicy {
+  int8_t max_tx_qdbm;         // esp_wifi_set_max_tx_power units (0.25 dBm)
+  int8_t min_tx_qdbm;
+  int8_t rssi_target_dbm;     // Weakest RSSI the link is sized for
+  int8_t rssi_near_dbm;       // At or above: near device
+  uint8_t base_attempts;      // The caller's backoff parameters
+  uint16_t base_delay_ms;
+};
+
+struct WifiLinkTuning {
+  int8_t tx_qdbm;
+  uint8_t protocol;           // WIFI_LINK_PROTO_* bits
+  uint8_t listen_interval;
+  uint8_t max_attempts;
+  uint16_t initial_delay_ms;
+};
+
+inline void wifi_link_record(WifiLinkHistory& h, int rssi_dbm, uint32_t attempts, bool ok) {
+  if (h.head >= WIFI_LINK_HISTORY) h.head = 0;
+  if (rssi_dbm < -127) rssi_dbm = -127;
+  if (rssi_dbm > 0) rssi_dbm = 0;
+  WifiLinkSample& s = h.samples[h.head];
+  s.rssi_dbm = ok ? (int8_t)rssi_dbm : 0;
+  s.attempts = (uint8_t)(attempts > 255 ? 255 : attempts);
+  s.ok = ok ? 1 : 0;
+  s.reserved = 0;
+  h.head = (uint8_t)((h.head + 1) % WIFI_LINK_HISTORY);
+  if (h.count < WIFI_LINK_HISTORY) h.count++;
+}
+
+inline WifiLinkTuning wifi_link_tune(const WifiLinkHistory& h, const WifiLinkPolicy& p) {
+  WifiLinkTuning t;
+  t.tx_qdbm = p.max_tx_qdbm;
+  t.protocol = WIFI_LINK_PROTO_11B | WIFI_LINK_PROTO_11G | WIFI_LINK_PROTO_11N;
+  t.listen_interval = WIFI_LINK_LISTEN_DEFAULT;
+  t.max_attempts = p.base_attempts;
+  t.initial_delay_ms = p.base_delay_ms;
+
+  uint8_t count = h.count > WIFI_LINK_HISTORY ? (uint8_t)WIFI_LINK_HISTORY : h.count;
+  if (count == 0) return t;
+
+  uint32_t ok = 0, retries = 0;
+  int weakest = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    const WifiLinkSample& s = h.samples[i];
+    if (!s.ok) continue;
+    if (ok == 0 || s.rssi_dbm < weakest) weakest = s.rssi_dbm;
+    ok++;
+    if (s.attempts > 1) retries += s.attempts - 1u;
+  }
+  uint32_t failures = count - ok;
+  bool reliable = ok > 0 && failures == 0 && retries == 0;
+
+  if (reliable && ok >= WIFI_LINK_MIN_SAMPLES) {
+    int margin_db = weakest - p.rssi_target_dbm;
+    if (margin_db > 0) {
+      int q = p.max_tx_qdbm - margin_db * 4;
+      if (q < p.min_tx_qdbm) q = p.min_tx_qdbm;
+      t.tx_qdbm = (int8_t)q;
+    }
+    if (weakest >= p.rssi_near_dbm) {
+      t.protocol = WIFI_LINK_PROTO_11G | WIFI_LINK_PROTO_11N;
+      t.listen_interval = WIFI_LINK_LISTEN_NEAR;
+    }
+  }
+
+  if (reliable) {
+    // Retrying rarely helps a link that never needs it
+    if (t.max_attempts > 1) t.max_attempts--;
+    t.initial_delay_ms = (uint16_t)(p.base_delay_ms / 2);
+  } else if (failures * 4 >= count || retries >= count) {
+    // A quarter of the wakes failed, or one retry per wake on average
+    if (t.max_attempts < WIFI_LINK_MAX_ATTEMPTS) t.max_attempts++;
+    uint32_t d = (uint32_t)p.base_delay_ms * 2;
+    t.initial_delay_ms = (uint16_t)(d > 0xFFFF ? 0xFFFF : d);
+  }
+  return t;
+}
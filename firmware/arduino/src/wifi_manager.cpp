@@ -3,19 +3,37 @@
 #include "generated_config.h"
 #include "config.h"
 #include "profiling.h"
+#include "feature_flags.h"
+#include "net_events.h"
+#include "energy_meter.h"
+#include "rtc_state.h"
+#include "wifi_link_adapt.h"
 #include <time.h>
 #include <sys/time.h>
 
 // Static storage for provisioning
 static Preferences g_wifi_prefs;
 
-// Track if time has been synced (persists in RTC during deep sleep)
-RTC_DATA_ATTR static bool g_time_synced = false;
-RTC_DATA_ATTR static uint32_t g_last_ntp_sync_timestamp = 0;
-
 // WiFi connection state tracking
 static WiFiConnectionState g_wifi_state = WIFI_STATE_IDLE;
 
+// Fast reconnect cache: last good AP and DHCP lease (persists in RTC during deep sleep)
+struct WiFiFastConnectCache {
+  uint32_t magic;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns1;
+  uint32_t dns2;
+  uint32_t saved_at;   // time(nullptr) when the lease was cached
+};
+
+static constexpr uint32_t WIFI_CACHE_MAGIC = 0x57494643;  // "WIFC"
+RTC_DATA_ATTR static WiFiFastConnectCache g_wifi_cache = {};
+static bool g_last_connect_fast = false;
+
 bool parse_bssid(const char* str, uint8_t out[6]) {
   if (!str)
     return false;
@@ -35,11 +53,141 @@ bool is_all_zero_bssid(const uint8_t b[6]) {
   return true;
 }
 
+static bool cache_is_usable() {
+  if (g_wifi_cache.magic != WIFI_CACHE_MAGIC) return false;
+  if (g_wifi_cache.channel == 0 || g_wifi_cache.channel > 14) return false;
+  if (g_wifi_cache.ip == 0 || is_all_zero_bssid(g_wifi_cache.bssid)) return false;
+
+  // Don't keep reusing a lease the DHCP server may have handed to someone else
+  time_t now = time(nullptr);
+  if (now > 1700000000 && g_wifi_cache.saved_at > 1700000000 &&
+      (uint32_t)now - g_wifi_cache.saved_at > WIFI_FAST_CONNECT_MAX_AGE_SEC) {
+    return false;
+  }
+  return true;
+}
+
+static void save_fast_connect_cache() {
+  const uint8_t* bssid = WiFi.BSSID();
+  if (!bssid) return;
+
+  memcpy(g_wifi_cache.bssid, bssid, 6);
+  g_wifi_cache.channel = static_cast<uint8_t>(WiFi.channel());
+  g_wifi_cache.ip = static_cast<uint32_t>(WiFi.localIP());
+  g_wifi_cache.gateway = static_cast<uint32_t>(WiFi.gatewayIP());
+  g_wifi_cache.subnet = static_cast<uint32_t>(WiFi.subnetMask());
+  g_wifi_cache.dns1 = static_cast<uint32_t>(WiFi.dnsIP(0));
+  g_wifi_cache.dns2 = static_cast<uint32_t>(WiFi.dnsIP(1));
+
+  // Only refresh the lease timestamp when it came from DHCP, so the age
+  // limit still forces a renewal eventually
+  if (!g_last_connect_fast || g_wifi_cache.saved_at == 0) {
+    time_t now = time(nullptr);
+    g_wifi_cache.saved_at = now > 1700000000 ? static_cast<uint32_t>(now) : 0;
+  }
+  g_wifi_cache.magic = WIFI_CACHE_MAGIC;
+}
+
+bool wifi_has_fast_connect_cache() {
+  return cache_is_usable();
+}
+
+void wifi_invalidate_fast_connect_cache() {
+  g_wifi_cache.magic = 0;
+}
+
+uint8_t wifi_cached_channel() {
+  if (g_wifi_cache.magic != WIFI_CACHE_MAGIC) return 0;
+  if (g_wifi_cache.channel == 0 || g_wifi_cache.channel > 14) return 0;
+  return g_wifi_cache.channel;
+}
+
+bool wifi_last_connect_was_fast() {
+  return g_last_connect_fast;
+}
+
+#if FEATURE_WIFI_LINK_ADAPT
+// This device's link settings, derived from its recent connects
+static WifiLinkTuning link_tuning(uint32_t base_attempts, uint32_t base_delay_ms) {
+  WifiLinkPolicy p;
+  p.max_tx_qdbm = WIFI_TX_POWER_MAX_QDBM;
+  p.min_tx_qdbm = WIFI_TX_POWER_MIN_QDBM;
+  p.rssi_target_dbm = WIFI_LINK_RSSI_TARGET_DBM;
+  p.rssi_near_dbm = WIFI_LINK_RSSI_NEAR_DBM;
+  p.base_attempts = (uint8_t)min(base_attempts, (uint32_t)255);
+  p.base_delay_ms = (uint16_t)min(base_delay_ms, (uint32_t)0xFFFF);
+  return wifi_link_tune(g_rtc_state.wifi_link, p);
+}
+
+// TX power and protocol set before association (the driver is started)
+static void apply_link_tuning() {
+  WifiLinkTuning t = link_tuning(1, 0);
+  esp_wifi_set_protocol(WIFI_IF_STA, t.protocol);
+  esp_wifi_set_max_tx_power(t.tx_qdbm);
+  if (t.tx_qdbm != WIFI_TX_POWER_MAX_QDBM || !(t.protocol & WIFI_PROTOCOL_11B)) {
+    Serial.printf("[WiFi] Link tuning: TX %.2f dBm, %s\n", t.tx_qdbm / 4.0f,
+                  (t.protocol & WIFI_PROTOCOL_11B) ? "11b/g/n" : "11g/n");
+  }
+}
+#endif
+
+// Channel-locked association with static config from the RTC cache
+// Skips the scan and the DHCP exchange; returns false (and leaves
+// DHCP re-enabled) if the AP does not accept us within the timeout
+static bool wifi_try_fast_connect(uint32_t timeout_ms) {
+  PROFILE_SCOPE("wifi_fast_connect");
+
+  IPAddress ip(g_wifi_cache.ip);
+  IPAddress gateway(g_wifi_cache.gateway);
+  IPAddress subnet(g_wifi_cache.subnet);
+  IPAddress dns1(g_wifi_cache.dns1);
+  IPAddress dns2(g_wifi_cache.dns2);
+
+  WiFi.config(ip, gateway, subnet, dns1, dns2);
+  Serial.printf("[WiFi] Fast connect to %s (ch %u, cached lease %s)\n",
+                WIFI_SSID, g_wifi_cache.channel, ip.toString().c_str());
+  net_events_clear(NET_EVT_WIFI_GOT_IP | NET_EVT_WIFI_DISCONNECTED);
+  WiFi.begin(WIFI_SSID, WIFI_PASS, g_wifi_cache.channel, g_wifi_cache.bssid);
+
+  // One disconnect is tolerated while the driver retries the association;
+  // a second one means the cached AP really rejected us, so fail fast
+  uint32_t start = millis();
+  uint8_t disconnects = 0;
+  uint32_t elapsed = 0;
+  while (elapsed < timeout_ms) {
+    uint32_t bits = net_events_wait(NET_EVT_WIFI_GOT_IP | NET_EVT_WIFI_DISCONNECTED,
+                                    timeout_ms - elapsed);
+    if ((bits & NET_EVT_WIFI_GOT_IP) || WiFi.isConnected()) {
+      return true;
+    }
+    if (!(bits & NET_EVT_WIFI_DISCONNECTED) || ++disconnects > 1) {
+      break;
+    }
+    Serial.println("[WiFi] Fast connect disconnected, waiting for the driver to retry");
+    net_events_clear(NET_EVT_WIFI_DISCONNECTED);
+    elapsed = millis() - start;
+  }
+
+  Serial.printf("[WiFi] Fast connect failed after %ums, falling back to full connect\n",
+                (unsigned)(millis() - start));
+  wifi_invalidate_fast_connect_cache();
+  WiFi.disconnect();
+  // All-zero config re-enables DHCP for the fallback attempt
+  WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+  return false;
+}
+
 bool wifi_connect_with_timeout(uint32_t timeout_ms) {
   g_wifi_state = WIFI_STATE_CONNECTING;
+  g_last_connect_fast = false;
+  net_events_begin();
   
   // Try to connect with configured credentials
   WiFi.mode(WIFI_STA);
+  ENERGY_RAIL_ON(ENERGY_RADIO_RX);  // Radio stays up until deep sleep
+#if FEATURE_WIFI_LINK_ADAPT
+  apply_link_tuning();
+#endif
   
   // Parse BSSID if configured
   uint8_t bssid_bytes[6] = {0};
@@ -54,9 +202,19 @@ bool wifi_connect_with_timeout(uint32_t timeout_ms) {
 
   // Set hostname before connecting
   WiFi.setHostname(ROOM_NAME);
+
+#if FEATURE_WIFI_FAST_RECONNECT
+  if (cache_is_usable() &&
+      wifi_try_fast_connect(min(timeout_ms, (uint32_t)WIFI_FAST_CONNECT_TIMEOUT_MS))) {
+    g_last_connect_fast = true;
+  }
+#endif
   
   // Connect with or without BSSID
-  if (has_bssid) {
+  net_events_clear(NET_EVT_WIFI_GOT_IP | NET_EVT_WIFI_DISCONNECTED);
+  if (g_last_connect_fast) {
+    // Already associated via the cached AP/lease
+  } else if (has_bssid) {
     Serial.printf("[WiFi] Connecting to %s with BSSID\n", WIFI_SSID);
     WiFi.begin(WIFI_SSID, WIFI_PASS, 0, bssid_bytes);
   } else {
@@ -64,18 +222,24 @@ bool wifi_connect_with_timeout(uint32_t timeout_ms) {
     WiFi.begin(WIFI_SSID, WIFI_PASS);
   }
   
-  // Wait for connection with timeout
-  uint32_t start = millis();
-  while (!WiFi.isConnected() && (millis() - start < timeout_ms)) {
-    delay(100);
+  // Block until the station gets an IP (event-driven, no poll interval)
+  // Disconnect events during association are expected while the driver
+  // retries, so only GOT_IP or the timeout ends the wait
+  if (!g_last_connect_fast) {
+    net_events_wait(NET_EVT_WIFI_GOT_IP, timeout_ms);
   }
   
   if (WiFi.isConnected()) {
     g_wifi_state = WIFI_STATE_CONNECTED;
-    Serial.printf("[WiFi] Connected! IP: %s, RSSI: %d\n", 
+    Serial.printf("[WiFi] Connected%s! IP: %s, RSSI: %d\n",
+                  g_last_connect_fast ? " (fast)" : "",
                   WiFi.localIP().toString().c_str(), WiFi.RSSI());
+
+#if FEATURE_WIFI_FAST_RECONNECT
+    save_fast_connect_cache();
+#endif
     
-    // Sync time via NTP (only if not already synced this session)
+    // Sync time via NTP (only once the kept clock's estimated error is too large)
     wifi_sync_time_ntp();
     
     return true;
@@ -86,19 +250,46 @@ bool wifi_connect_with_timeout(uint32_t timeout_ms) {
   }
 }
 
-bool wifi_connect_with_exponential_backoff(uint32_t max_attempts, uint32_t initial_delay_ms) {
+bool wifi_connect_with_exponential_backoff(uint32_t max_attempts, uint32_t initial_delay_ms,
+                                           uint32_t budget_ms) {
   PROFILE_SCOPE("wifi_connect_backoff");
+#if FEATURE_WIFI_LINK_ADAPT
+  // Success rate of the recent wakes scales the caller's backoff
+  WifiLinkTuning tuning = link_tuning(max_attempts, initial_delay_ms);
+  max_attempts = tuning.max_attempts;
+  initial_delay_ms = tuning.initial_delay_ms;
+#endif
   uint32_t retry_delay_ms = initial_delay_ms;
+  uint32_t start = millis();
+  uint32_t attempts_made = 0;
 
   for (uint32_t attempt = 0; attempt < max_attempts; attempt++) {
+    uint32_t timeout_ms = WIFI_CONNECT_TIMEOUT_MS;
+    if (budget_ms) {
+      uint32_t elapsed = millis() - start;
+      if (elapsed >= budget_ms) {
+        Serial.printf("[WiFi] Connect budget of %lums spent\n", (unsigned long)budget_ms);
+        break;
+      }
+      timeout_ms = min(timeout_ms, budget_ms - elapsed);
+    }
     Serial.printf("[WiFi] Connection attempt %d/%d\n", attempt + 1, max_attempts);
+    attempts_made++;
     
-    if (wifi_connect_with_timeout(WIFI_CONNECT_TIMEOUT_MS)) {
+    if (wifi_connect_with_timeout(timeout_ms)) {
+#if FEATURE_WIFI_LINK_ADAPT
+      wifi_link_record(g_rtc_state.wifi_link, WiFi.RSSI(), attempts_made, true);
+#endif
       return true;
     }
     
     // Don't delay after the last attempt
     if (attempt < max_attempts - 1) {
+      // No point waiting out a retry the budget would not leave time for
+      if (budget_ms && millis() - start + retry_delay_ms >= budget_ms) {
+        Serial.printf("[WiFi] Connect budget of %lums spent\n", (unsigned long)budget_ms);
+        break;
+      }
       Serial.printf("[WiFi] Waiting %dms before retry...\n", retry_delay_ms);
       delay(retry_delay_ms);
       
@@ -107,7 +298,10 @@ bool wifi_connect_with_exponential_backoff(uint32_t max_attempts, uint32_t initi
     }
   }
   
-  Serial.printf("[WiFi] Failed to connect after %d attempts\n", max_attempts);
+  Serial.printf("[WiFi] Failed to connect after %d attempts\n", attempts_made);
+#if FEATURE_WIFI_LINK_ADAPT
+  wifi_link_record(g_rtc_state.wifi_link, 0, attempts_made, false);
+#endif
   g_wifi_state = WIFI_STATE_FAILED;
   return false;
 }
@@ -128,7 +322,13 @@ void wifi_get_ip_cstr(char* out, size_t out_size) {
     return;
   
   if (!WiFi.isConnected()) {
-    snprintf(out, out_size, "0.0.0.0");
+    // Before association, show the lease the fast reconnect will reuse
+    if (cache_is_usable()) {
+      IPAddress cached(g_wifi_cache.ip);
+      snprintf(out, out_size, "%d.%d.%d.%d", cached[0], cached[1], cached[2], cached[3]);
+    } else {
+      snprintf(out, out_size, "0.0.0.0");
+    }
     return;
   }
   
@@ -149,6 +349,21 @@ void wifi_set_hostname(const char* hostname) {
 
 void wifi_configure_power_save(bool enable) {
   if (enable) {
+#if FEATURE_WIFI_LINK_ADAPT
+    // A near device can sleep across several beacons; the AP buffers for
+    // the listen interval, which the driver only honours in max modem sleep
+    WifiLinkTuning t = link_tuning(1, 0);
+    if (t.listen_interval > WIFI_LINK_LISTEN_DEFAULT) {
+      wifi_config_t conf;
+      if (esp_wifi_get_config(WIFI_IF_STA, &conf) == ESP_OK) {
+        conf.sta.listen_interval = t.listen_interval;
+        if (esp_wifi_set_config(WIFI_IF_STA, &conf) == ESP_OK) {
+          WiFi.setSleep(WIFI_PS_MAX_MODEM);
+          return;
+        }
+      }
+    }
+#endif
     WiFi.setSleep(WIFI_PS_MIN_MODEM);
   } else {
     WiFi.setSleep(WIFI_PS_NONE);
@@ -289,50 +504,86 @@ void wifi_set_time_from_compile() {
   Serial.printf("[Time] Set to compile time: %s", asctime(&compile_tm));
 }
 
+static double timeval_sec(const struct timeval& tv) {
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+}
+
+void wifi_time_restore() {
+  // TZ lives in RAM, so every wake has to set it again for localtime()
+  setenv("TZ", NTP_TIMEZONE, 1);
+  tzset();
+
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  int64_t us = ntp_take_correction_us(g_rtc_state.ntp, (uint32_t)tv.tv_sec);
+  if (us == 0) return;
+  int64_t t = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec + us;
+  tv.tv_sec = (time_t)(t / 1000000);
+  tv.tv_usec = (suseconds_t)(t % 1000000);
+  settimeofday(&tv, nullptr);
+}
+
 void wifi_sync_time_ntp() {
-  // Skip if already synced this boot cycle and time looks valid
-  time_t now = time(nullptr);
-  struct tm tm_check;
-  localtime_r(&now, &tm_check);
-  
-  if (g_time_synced && tm_check.tm_year >= 124) {
-    Serial.println("[Time] Already synced via NTP this session");
+  NtpSchedule& sched = g_rtc_state.ntp;
+  struct timeval before;
+  gettimeofday(&before, nullptr);
+  uint32_t now = (uint32_t)before.tv_sec;
+
+  if (!ntp_sync_due(sched, now, NTP_MAX_ERROR_MS, NTP_MAX_INTERVAL_SEC)) {
+    Serial.printf("[Time] NTP not due (est. error %u ms, drift %.1f ppm, last sync %u s ago)\n",
+                  (unsigned)ntp_error_ms(sched, now), sched.drift_ppm,
+                  (unsigned)(now - sched.last_sync_epoch));
     return;
   }
-  
+
   Serial.println("[Time] Syncing via NTP...");
   
-  // Configure timezone (EST/EDT - adjust for your location)
+  // Configure timezone (EST/EDT - adjust NTP_TIMEZONE for your location)
   // Format: "STD+offset" or "STD+offset DST" 
   // EST5EDT = Eastern Standard Time, 5 hours behind UTC, with DST
-  configTzTime("EST5EDT,M3.2.0,M11.1.0", "pool.ntp.org", "time.nist.gov", "time.google.com");
+  net_events_clear(NET_EVT_TIME_SYNCED);
+  uint32_t start = millis();
+  configTzTime(NTP_TIMEZONE, "pool.ntp.org", "time.nist.gov", "time.google.com");
   
   // Wait for time sync (max 5 seconds to not delay boot too much)
-  uint32_t start = millis();
+  // The SNTP notification wakes us as soon as the first reply lands; the
+  // clock is usually valid already, so only the notification counts
   const uint32_t NTP_TIMEOUT_MS = 5000;
+  bool synced = false;
   
-  while (time(nullptr) < 1700000000 && (millis() - start) < NTP_TIMEOUT_MS) {
-    delay(100);
+  while (!synced && (millis() - start) < NTP_TIMEOUT_MS) {
+    uint32_t remaining = NTP_TIMEOUT_MS - (millis() - start);
+    if (net_events_wait(NET_EVT_TIME_SYNCED, remaining) & NET_EVT_TIME_SYNCED) {
+      net_events_clear(NET_EVT_TIME_SYNCED);
+      synced = true;
+    } else if (!ntp_time_valid(now) && ntp_time_valid((uint32_t)time(nullptr))) {
+      synced = true;   // No event group: a clock that became valid was set
+    }
   }
   
-  now = time(nullptr);
-  if (now > 1700000000) {  // After Nov 2023 = valid
-    g_time_synced = true;
-    g_last_ntp_sync_timestamp = static_cast<uint32_t>(now);
+  if (synced) {
+    // What the kept clock would read now, against what NTP set it to
+    struct timeval after;
+    gettimeofday(&after, nullptr);
+    double local = timeval_sec(before) + (double)(millis() - start) / 1000.0;
+    double offset_ms = (local - timeval_sec(after)) * 1000.0;
+    ntp_on_sync(sched, local, timeval_sec(after));
     
     struct tm tm_now;
-    localtime_r(&now, &tm_now);
-    Serial.printf("[Time] NTP sync successful: %02d:%02d:%02d\n", 
-                  tm_now.tm_hour, tm_now.tm_min, tm_now.tm_sec);
+    time_t t = after.tv_sec;
+    localtime_r(&t, &tm_now);
+    Serial.printf("[Time] NTP sync successful: %02d:%02d:%02d (offset %.0f ms, drift %.1f ppm)\n", 
+                  tm_now.tm_hour, tm_now.tm_min, tm_now.tm_sec,
+                  ntp_time_valid(now) ? offset_ms : 0.0, sched.drift_ppm);
   } else {
     Serial.println("[Time] NTP sync failed, using existing time");
   }
 }
 
 bool wifi_is_time_synced() {
-  return g_time_synced;
+  return g_rtc_state.ntp.last_sync_epoch != 0;
 }
 
 uint32_t wifi_get_last_ntp_sync() {
-  return g_last_ntp_sync_timestamp;
+  return g_rtc_state.ntp.last_sync_epoch;
 }
\ No newline at end of file
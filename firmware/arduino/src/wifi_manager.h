@@ -26,10 +26,36 @@
 #define WIFI_CONNECT_TIMEOUT_MS 6000
 #endif
 
+// Fast reconnect: channel-locked association with the last good BSSID and
+// DHCP lease cached in RTC memory (falls back to a full connect on failure)
+#ifndef WIFI_FAST_CONNECT_TIMEOUT_MS
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 2000
+#endif
+
+// Maximum age of the cached lease before we go back to DHCP (seconds)
+#ifndef WIFI_FAST_CONNECT_MAX_AGE_SEC
+#define WIFI_FAST_CONNECT_MAX_AGE_SEC 43200
+#endif
+
 #ifndef WIFI_RSSI_THRESHOLD
 #define WIFI_RSSI_THRESHOLD -75
 #endif
 
+// Link adaptation (wifi_link_adapt.h): TX power range in 0.25 dBm steps,
+// the weakest RSSI the link is sized for, and the RSSI of a near device
+#ifndef WIFI_TX_POWER_MAX_QDBM
+#define WIFI_TX_POWER_MAX_QDBM 78     // 19.5 dBm, the driver default
+#endif
+#ifndef WIFI_TX_POWER_MIN_QDBM
+#define WIFI_TX_POWER_MIN_QDBM 34     // 8.5 dBm
+#endif
+#ifndef WIFI_LINK_RSSI_TARGET_DBM
+#define WIFI_LINK_RSSI_TARGET_DBM -67
+#endif
+#ifndef WIFI_LINK_RSSI_NEAR_DBM
+#define WIFI_LINK_RSSI_NEAR_DBM -55
+#endif
+
 #ifndef WIFI_AUTHMODE_THRESHOLD
 #define WIFI_AUTHMODE_THRESHOLD WIFI_AUTH_WPA_PSK
 #endif
@@ -45,7 +71,9 @@ enum WiFiConnectionState {
 
 // WiFi management functions
 bool wifi_connect_with_timeout(uint32_t timeout_ms);
-bool wifi_connect_with_exponential_backoff(uint32_t max_attempts = 5, uint32_t initial_delay_ms = 1000);
+// budget_ms caps all attempts and waits together (0 = no cap)
+bool wifi_connect_with_exponential_backoff(uint32_t max_attempts = 5, uint32_t initial_delay_ms = 1000,
+                                           uint32_t budget_ms = 0);
 bool wifi_is_connected();
 String wifi_get_ip();
 void wifi_get_ip_cstr(char* out, size_t out_size);
@@ -56,6 +84,13 @@ bool wifi_is_provisioning_active();
 WiFiConnectionState wifi_get_state();
 const char* wifi_state_to_string(WiFiConnectionState state);
 
+// Fast reconnect cache (RTC memory)
+bool wifi_has_fast_connect_cache();
+void wifi_invalidate_fast_connect_cache();
+bool wifi_last_connect_was_fast();
+// AP channel of the last association, 0 if unknown (ESP-NOW sends on it)
+uint8_t wifi_cached_channel();
+
 // BSSID utilities
 bool parse_bssid(const char* str, uint8_t out[6]);
 bool is_all_zero_bssid(const uint8_t b[6]);
@@ -65,9 +100,13 @@ void wifi_set_hostname(const char* hostname);
 void wifi_configure_power_save(bool enable);
 
 // Time sync functions
-// - wifi_sync_time_ntp(): Syncs time via NTP when WiFi connected (automatic)
+// - wifi_time_restore(): Once per wake; sets TZ and takes the measured drift
+//   out of the clock kept through deep sleep (ntp_schedule.h)
+// - wifi_sync_time_ntp(): Syncs time via NTP when WiFi connected (automatic),
+//   only once the clock's estimated error passes NTP_MAX_ERROR_MS or
+//   NTP_MAX_INTERVAL_SEC has elapsed
 // - wifi_set_time_from_compile(): Uses compile timestamp as fallback when no WiFi
-// - Time persists in RTC during deep sleep, only needs initial sync
+void wifi_time_restore();
 void wifi_sync_time_ntp();
 void wifi_set_time_from_compile();
 bool wifi_is_time_synced();
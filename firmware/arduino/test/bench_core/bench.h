@@ -0,0 +1,223 @@
+#pragma once
+
+// Minimal Google-Benchmark-style harness for the host benchmarks
+// BENCHMARK(fn) registers void fn(BenchState&). The body sets up its input,
+// then runs the code under test inside `for (auto _ : state)`. Each
+// benchmark is run with a growing iteration count until one run takes at
+// least BENCH_MIN_TIME seconds (default 0.2), and the last run is reported.
+//
+// Results go to stdout as a table and, when BENCH_OUT names a file, as
+// Google Benchmark JSON ({"context": ..., "benchmarks": [...]}), so two runs
+// can be diffed with scripts/bench_compare.py or Google's compare.py.
+// BENCH_FILTER=<substring> runs a subset.
+//
+// Usage:
+//   static void BM_crc32(BenchState& state) {
+//       uint8_t buf[256] = {};
+//       for (auto _ : state) bench_do_not_optimize(crc32_table_update(0, buf, sizeof(buf)));
+//       state.setBytesProcessed(state.iterations() * sizeof(buf));
+//   }
+//   BENCHMARK(BM_crc32);
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+// Keep a value (and the work producing it) from being optimized away
+template <typename T>
+inline void bench_do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Force pending stores to memory before the next iteration
+inline void bench_clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+class BenchState {
+public:
+    explicit BenchState(uint64_t iterations) : iterations_(iterations) {}
+
+    // Non-trivial so `for (auto _ : state)` does not warn as unused
+    struct Value {
+        ~Value() {}
+    };
+
+    class Iterator {
+    public:
+        Iterator(BenchState* state, uint64_t left) : state_(state), left_(left) {}
+        bool operator!=(const Iterator&) {
+            if (left_ != 0) return true;
+            state_->stopTiming();
+            return false;
+        }
+        void operator++() { --left_; }
+        Value operator*() const { return Value(); }
+
+    private:
+        BenchState* state_;
+        uint64_t left_;
+    };
+
+    Iterator begin() {
+        startTiming();
+        return Iterator(this, iterations_);
+    }
+    Iterator end() { return Iterator(this, 0); }
+
+    uint64_t iterations() const { return iterations_; }
+    void setBytesProcessed(uint64_t bytes) { bytes_ = bytes; }
+    void setItemsProcessed(uint64_t items) { items_ = items; }
+
+    double realSeconds() const { return real_sec_; }
+    double cpuSeconds() const { return cpu_sec_; }
+    uint64_t bytesProcessed() const { return bytes_; }
+    uint64_t itemsProcessed() const { return items_; }
+
+private:
+    void startTiming() {
+        cpu_start_ = std::clock();
+        real_start_ = std::chrono::steady_clock::now();
+    }
+    void stopTiming() {
+        real_sec_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start_).count();
+        cpu_sec_ = (double)(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+    }
+
+    uint64_t iterations_;
+    uint64_t bytes_ = 0;
+    uint64_t items_ = 0;
+    std::chrono::steady_clock::time_point real_start_;
+    std::clock_t cpu_start_ = 0;
+    double real_sec_ = 0;
+    double cpu_sec_ = 0;
+};
+
+typedef void (*BenchFn)(BenchState&);
+
+struct BenchEntry {
+    const char* name;
+    BenchFn fn;
+};
+
+inline std::vector<BenchEntry>& bench_registry() {
+    static std::vector<BenchEntry> entries;
+    return entries;
+}
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFn fn) { bench_registry().push_back({name, fn}); }
+};
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+#define BENCHMARK(fn) static BenchRegistrar BENCH_CONCAT(bench_registrar_, __LINE__)(#fn, fn)
+
+struct BenchResult {
+    const char* name;
+    uint64_t iterations;
+    double real_ns;             // Per iteration
+    double cpu_ns;
+    double bytes_per_second;    // 0 = not reported
+    double items_per_second;
+};
+
+inline double bench_min_time() {
+    const char* s = getenv("BENCH_MIN_TIME");
+    double t = s ? atof(s) : 0.0;
+    return t > 0 ? t : 0.2;
+}
+
+// Grow the iteration count until a run lasts min_time, like Google Benchmark
+inline BenchResult bench_run(const BenchEntry& e, double min_time) {
+    static constexpr uint64_t MAX_ITERATIONS = 1000000000ull;
+    uint64_t n = 1;
+    for (;;) {
+        BenchState state(n);
+        e.fn(state);
+        double t = state.realSeconds();
+        if (t >= min_time || n >= MAX_ITERATIONS) {
+            BenchResult r;
+            r.name = e.name;
+            r.iterations = n;
+            r.real_ns = t * 1e9 / n;
+            r.cpu_ns = state.cpuSeconds() * 1e9 / n;
+            r.bytes_per_second = (state.bytesProcessed() && t > 0) ? state.bytesProcessed() / t : 0;
+            r.items_per_second = (state.itemsProcessed() && t > 0) ? state.itemsProcessed() / t : 0;
+            return r;
+        }
+        // Aim 40% past min_time, growing at most 100x per step
+        double scale = t > 0 ? min_time * 1.4 / t : 100.0;
+        if (scale > 100.0) scale = 100.0;
+        uint64_t next = (uint64_t)(n * scale);
+        n = next > n ? next : n + 1;
+        if (n > MAX_ITERATIONS) n = MAX_ITERATIONS;
+    }
+}
+
+inline void bench_write_json(FILE* f, const std::vector<BenchResult>& results,
+                             const char* executable = "bench_core") {
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+    fprintf(f, "{\n  \"context\": {\n");
+    fprintf(f, "    \"date\": \"%s\",\n", date);
+    fprintf(f, "    \"executable\": \"%s\",\n", executable);
+    fprintf(f, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+#ifdef __OPTIMIZE__
+    fprintf(f, "    \"library_build_type\": \"release\"\n");
+#else
+    fprintf(f, "    \"library_build_type\": \"debug\"\n");
+#endif
+    fprintf(f, "  },\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(f, "    {\n");
+        fprintf(f, "      \"name\": \"%s\",\n      \"run_name\": \"%s\",\n", r.name, r.name);
+        fprintf(f, "      \"run_type\": \"iteration\",\n      \"repetitions\": 1,\n");
+        fprintf(f, "      \"repetition_index\": 0,\n      \"threads\": 1,\n");
+        fprintf(f, "      \"iterations\": %llu,\n", (unsigned long long)r.iterations);
+        fprintf(f, "      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n", r.real_ns, r.cpu_ns);
+        if (r.bytes_per_second > 0) fprintf(f, "      \"bytes_per_second\": %.1f,\n", r.bytes_per_second);
+        if (r.items_per_second > 0) fprintf(f, "      \"items_per_second\": %.1f,\n", r.items_per_second);
+        fprintf(f, "      \"time_unit\": \"ns\"\n    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+// Run every registered benchmark matching BENCH_FILTER; returns the results
+inline std::vector<BenchResult> bench_run_all() {
+    const char* filter = getenv("BENCH_FILTER");
+    double min_time = bench_min_time();
+    std::vector<BenchResult> results;
+
+    printf("%-40s %14s %14s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+    for (const BenchEntry& e : bench_registry()) {
+        if (filter && *filter && !strstr(e.name, filter)) continue;
+        BenchResult r = bench_run(e, min_time);
+        results.push_back(r);
+        printf("%-40s %14.1f %14.1f %12llu", r.name, r.real_ns, r.cpu_ns,
+               (unsigned long long)r.iterations);
+        if (r.bytes_per_second > 0) printf("  %.1f MB/s", r.bytes_per_second / 1e6);
+        if (r.items_per_second > 0) printf("  %.2f M items/s", r.items_per_second / 1e6);
+        printf("\n");
+    }
+
+    const char* out = getenv("BENCH_OUT");
+    if (out && *out) {
+        FILE* f = fopen(out, "w");
+        if (f) {
+            bench_write_json(f, results);
+            fclose(f);
+            printf("Results written to %s\n", out);
+        } else {
+            printf("Cannot write %s\n", out);
+        }
+    }
+    return results;
+}
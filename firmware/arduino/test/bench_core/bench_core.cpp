@@ -0,0 +1,346 @@
+// Host microbenchmarks of the hardware-independent hot paths
+// Builds the real sources (build_src_filter in env:native_bench) against the
+// stand-ins in test/host, checks each path gives the expected result, then
+// times it. See bench.h for the output format.
+
+#include <unity.h>
+#include <cmath>
+#include <cstdarg>
+#include <cstring>
+#include "bench.h"
+#include "../../src/base64_codec.h"
+#include "../../src/buffer_pool_core.h"
+#include "../../src/crc32.h"
+#include "../../src/display_smart_refresh.h"
+#include "../../src/feature_flags.h"
+#include "../../src/logging/log_deferred.h"
+#include "../../src/mqtt_batcher.h"
+#include "../../src/render_model.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint8_t g_frame[32 * 122];   // Screenshot canvas size
+
+static void fill_frame() {
+    // Mostly white with some text-like structure, as the canvas is
+    for (size_t i = 0; i < sizeof(g_frame); i++) {
+        g_frame[i] = (i % 32 < 14 && (i / 32) % 12 < 7) ? (uint8_t)(i * 131) : 0xFF;
+    }
+}
+
+// --- CRC-32 (fast_crc32 software paths) ---
+
+static void BM_crc32_bitwise_256(BenchState& state) {
+    for (auto _ : state) bench_do_not_optimize(crc32_bitwise_update(0, g_frame, 256));
+    state.setBytesProcessed(state.iterations() * 256);
+}
+BENCHMARK(BM_crc32_bitwise_256);
+
+static void BM_crc32_table_256(BenchState& state) {
+    TEST_ASSERT_EQUAL_HEX32(crc32_bitwise_update(0, g_frame, 256), crc32_table_update(0, g_frame, 256));
+    for (auto _ : state) bench_do_not_optimize(crc32_table_update(0, g_frame, 256));
+    state.setBytesProcessed(state.iterations() * 256);
+}
+BENCHMARK(BM_crc32_table_256);
+
+static void BM_crc32_table_frame(BenchState& state) {
+    for (auto _ : state) bench_do_not_optimize(crc32_table_update(0, g_frame, sizeof(g_frame)));
+    state.setBytesProcessed(state.iterations() * sizeof(g_frame));
+}
+BENCHMARK(BM_crc32_table_frame);
+
+// --- Base64 (screenshot streaming) ---
+
+static void BM_base64_block_48(BenchState& state) {
+    char out[BASE64_ENCODED_LEN(48)];
+    for (auto _ : state) {
+        bench_do_not_optimize(base64_encode_block(g_frame, 48, out));
+        bench_clobber_memory();
+    }
+    state.setBytesProcessed(state.iterations() * 48);
+}
+BENCHMARK(BM_base64_block_48);
+
+static void BM_base64_frame(BenchState& state) {
+    static char out[BASE64_ENCODED_LEN(sizeof(g_frame))];
+    for (auto _ : state) {
+        bench_do_not_optimize(base64_encode_block(g_frame, sizeof(g_frame), out));
+        bench_clobber_memory();
+    }
+    state.setBytesProcessed(state.iterations() * sizeof(g_frame));
+}
+BENCHMARK(BM_base64_frame);
+
+// --- BufferPool core ---
+
+static char g_pool_storage[BUFFER_POOL_SMALL_SIZE * BUFFER_POOL_SMALL_COUNT +
+                           BUFFER_POOL_MEDIUM_SIZE * BUFFER_POOL_MEDIUM_COUNT +
+                           BUFFER_POOL_LARGE_SIZE * BUFFER_POOL_LARGE_COUNT];
+static PoolClass g_pool_classes[3];
+static PoolCore g_pool;
+
+static void init_pool() {
+    memset(&g_pool, 0, sizeof(g_pool));
+    char* p = g_pool_storage;
+    pool_class_init(g_pool_classes[0], p, BUFFER_POOL_SMALL_SIZE, BUFFER_POOL_SMALL_COUNT);
+    p += BUFFER_POOL_SMALL_SIZE * BUFFER_POOL_SMALL_COUNT;
+    pool_class_init(g_pool_classes[1], p, BUFFER_POOL_MEDIUM_SIZE, BUFFER_POOL_MEDIUM_COUNT);
+    p += BUFFER_POOL_MEDIUM_SIZE * BUFFER_POOL_MEDIUM_COUNT;
+    pool_class_init(g_pool_classes[2], p, BUFFER_POOL_LARGE_SIZE, BUFFER_POOL_LARGE_COUNT);
+    g_pool.classes = g_pool_classes;
+    g_pool.class_count = 3;
+}
+
+static void BM_pool_acquire_release(BenchState& state) {
+    init_pool();
+    for (auto _ : state) {
+        char* b = pool_acquire(g_pool, 48, nullptr, "bench");
+        bench_do_not_optimize(b);
+        pool_release(g_pool, b);
+    }
+    TEST_ASSERT_EQUAL(0, g_pool.failures);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_pool_acquire_release);
+
+static void BM_pool_fallback(BenchState& state) {
+    init_pool();
+    char* held[BUFFER_POOL_SMALL_COUNT];
+    for (size_t i = 0; i < BUFFER_POOL_SMALL_COUNT; i++) held[i] = pool_acquire(g_pool, 48);
+    for (auto _ : state) {
+        char* b = pool_acquire(g_pool, 48, nullptr, "bench");   // Small class full
+        bench_do_not_optimize(b);
+        pool_release(g_pool, b);
+    }
+    for (size_t i = 0; i < BUFFER_POOL_SMALL_COUNT; i++) pool_release(g_pool, held[i]);
+    TEST_ASSERT_EQUAL(0, g_pool.failures);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_pool_fallback);
+
+// --- SmartRefresh ---
+
+static void BM_smart_refresh_hash_string(BenchState& state) {
+    const char* text = "4.12V 87% ~143d";
+    for (auto _ : state) bench_do_not_optimize(SmartRefresh::hashString(text));
+    state.setBytesProcessed(state.iterations() * strlen(text));
+}
+BENCHMARK(BM_smart_refresh_hash_string);
+
+static void BM_smart_refresh_check_rects(BenchState& state) {
+    SmartRefresh& sr = SmartRefresh::getInstance();
+    for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) sr.registerRegion(rid);
+    uint32_t hashes[ui::RECT__COUNT];
+    for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) hashes[rid] = 0x1000u + rid;
+    for (auto _ : state) {
+        for (uint8_t rid = 0; rid < ui::RECT__COUNT; ++rid) sr.hasHashChanged(rid, hashes[rid]);
+        bench_do_not_optimize(sr.getDirtyMask());
+    }
+    state.setItemsProcessed(state.iterations() * ui::RECT__COUNT);
+}
+BENCHMARK(BM_smart_refresh_check_rects);
+
+// --- UI spec ops over the render model ---
+
+static RenderModel g_model;
+
+// What render_model_snapshot() fills on a typical wake
+static void fill_model() {
+    for (int f = 0; f < ui::FIELD__COUNT; ++f) {
+        g_model.value[f] = NAN;
+        g_model.decimals[f] = 0;
+        g_model.text[f] = nullptr;
+    }
+    strcpy(g_model.ip, "192.168.1.57");
+    strcpy(g_model.time_hhmm, "14:05");
+    strcpy(g_model.weather, "partly-cloudy");
+    g_model.text[ui::FIELD_ROOM_NAME] = "Office";
+    g_model.text[ui::FIELD_FW_VERSION] = "1.0.0";
+    g_model.text[ui::FIELD_IP] = g_model.ip;
+    g_model.text[ui::FIELD_TIME_HHMM] = g_model.time_hhmm;
+    g_model.text[ui::FIELD_WEATHER] = g_model.weather;
+    g_model.value[ui::FIELD_INSIDE_TEMP_F] = 71.6f;
+    g_model.value[ui::FIELD_INSIDE_HUM_PCT] = 41.0f;
+    g_model.value[ui::FIELD_PRESSURE_HPA] = 1013.2f;
+    g_model.decimals[ui::FIELD_PRESSURE_HPA] = 1;
+    g_model.value[ui::FIELD_OUTSIDE_TEMP_F] = 55.4f;
+    g_model.value[ui::FIELD_OUTSIDE_HUM_PCT] = 68.0f;
+    g_model.value[ui::FIELD_WIND_MPS] = 3.4f;
+    g_model.decimals[ui::FIELD_WIND_MPS] = 1;
+    g_model.value[ui::FIELD_BATTERY_VOLTAGE] = 4.12f;
+    g_model.decimals[ui::FIELD_BATTERY_VOLTAGE] = 2;
+    g_model.value[ui::FIELD_BATTERY_PERCENT] = 87.0f;
+    g_model.value[ui::FIELD_DAYS] = 143.0f;
+    g_model.battery_pct = 87;
+    g_model.has_icon = true;
+    g_model.icon = IconId();
+    for (int f = 0; f < ui::FIELD__COUNT; ++f) {
+        float v = g_model.value[f];
+        if (g_model.text[f] || !std::isfinite(v)) {
+            strcpy(g_model.formatted[f], "--");
+        } else {
+            snprintf(g_model.formatted[f], RENDER_MODEL_VALUE_LEN, "%.*f", g_model.decimals[f], v);
+        }
+    }
+}
+
+static void BM_ui_rect_hashes(BenchState& state) {
+    uint32_t hashes[ui::RECT__COUNT];
+    for (auto _ : state) {
+        render_model_rect_hashes(0, g_model, hashes, ui::RECT__COUNT);
+        bench_do_not_optimize(hashes[0]);
+    }
+    state.setItemsProcessed(state.iterations() * ui::kVariant_v2_opcount);
+}
+BENCHMARK(BM_ui_rect_hashes);
+
+static void BM_ui_expand_footer(BenchState& state) {
+    int comp_count = 0;
+    const ui::ComponentOps* comps = ui::get_variant_ops(0, &comp_count);
+    const ui::UiOpHeader* op = nullptr;
+    for (int ci = 0; ci < comp_count && !op; ++ci) {
+        for (int i = 0; i < comps[ci].count; ++i) {
+            if (comps[ci].ops[i].rect == ui::RECT_FOOTER_BATTERY && comps[ci].ops[i].segs) {
+                op = &comps[ci].ops[i];
+                break;
+            }
+        }
+    }
+    TEST_ASSERT_NOT_NULL(op);
+
+    char out[64];
+    render_model_op_text(*op, g_model, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("4.12V 87% ~143d", out);
+    for (auto _ : state) bench_do_not_optimize(render_model_op_text(*op, g_model, out, sizeof(out)));
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ui_expand_footer);
+
+static void BM_ui_model_hash(BenchState& state) {
+    for (auto _ : state) bench_do_not_optimize(render_model_hash(g_model));
+}
+BENCHMARK(BM_ui_model_hash);
+
+// --- MQTTBatcher: one wake's publish burst ---
+
+static PubSubClient g_client;
+
+static void queue_wake(MQTTBatcher& b) {
+    b.queue("espsensor/office/inside/temperature", "21.8", true);
+    b.queue("espsensor/office/inside/humidity", "41", true);
+    b.queue("espsensor/office/inside/pressure", "1013.2", true);
+    b.queue("espsensor/office/battery/voltage", "4.12", true);
+    b.queue("espsensor/office/battery/percent", "87", true);
+    b.queueJson("espsensor/office/inside/stats",
+                "{\"1h\":{\"t\":[21.4,21.9,21.66],\"n\":6}}", true);
+    b.queue("espsensor/office/debug/wake_count", "1234", false);
+    b.queue("espsensor/office/debug/uptime", "3", false);
+}
+
+static void BM_batcher_packed_wake(BenchState& state) {
+    MQTTBatcher& b = MQTTBatcher::getInstance();
+    b.clear();
+    b.setTopicPrefix("espsensor/office/");
+    b.setPackedMode(true);
+    queue_wake(b);
+    TEST_ASSERT_EQUAL(8, b.flush(&g_client));
+    for (auto _ : state) {
+        queue_wake(b);
+        bench_do_not_optimize(b.flush(&g_client));
+    }
+    state.setItemsProcessed(state.iterations() * 8);
+}
+BENCHMARK(BM_batcher_packed_wake);
+
+static void BM_batcher_per_topic_wake(BenchState& state) {
+    MQTTBatcher& b = MQTTBatcher::getInstance();
+    b.clear();
+    b.setTopicPrefix("espsensor/office/");
+    b.setPackedMode(false);
+    for (auto _ : state) {
+        queue_wake(b);
+        bench_do_not_optimize(b.flush(&g_client));
+    }
+    state.setItemsProcessed(state.iterations() * 8);
+}
+BENCHMARK(BM_batcher_per_topic_wake);
+
+// Same document the on-device "bench" debug command times as batch_format
+static void BM_batcher_format_packed(BenchState& state) {
+    MQTTBatcher& b = MQTTBatcher::getInstance();
+    b.clear();
+    b.setTopicPrefix("espsensor/office/");
+    queue_wake(b);
+    char doc[MQTTBatcher::PACKED_PAYLOAD_LEN];
+    TEST_ASSERT_TRUE(b.formatPacked(doc, sizeof(doc)) > 0);
+    TEST_ASSERT_EQUAL('{', doc[0]);
+    for (auto _ : state) bench_do_not_optimize(b.formatPacked(doc, sizeof(doc)));
+    b.clear();
+    state.setItemsProcessed(state.iterations() * 8);
+}
+BENCHMARK(BM_batcher_format_packed);
+
+// --- Log formatting: eager vsnprintf vs deferred capture ---
+
+static const char* const kLogFormat = "Published %u messages in %lu ms (rssi %d, %.1f C)";
+
+static void eager(char* out, size_t out_size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(out, out_size, format, args);
+    va_end(args);
+}
+
+static bool capture(LogEntry& e, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool ok = log_defer_capture(e, format, args);
+    va_end(args);
+    return ok;
+}
+
+static void BM_log_vsnprintf(BenchState& state) {
+    char out[LOG_ENTRY_PAYLOAD];
+    for (auto _ : state) {
+        eager(out, sizeof(out), kLogFormat, 8u, 412ul, -67, 21.8);
+        bench_clobber_memory();
+    }
+}
+BENCHMARK(BM_log_vsnprintf);
+
+static void BM_log_defer_capture(BenchState& state) {
+    LogEntry e = {};
+    TEST_ASSERT_TRUE(capture(e, kLogFormat, 8u, 412ul, -67, 21.8));
+    char text[128];
+    log_entry_format(e, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("Published 8 messages in 412 ms (rssi -67, 21.8 C)", text);
+    for (auto _ : state) {
+        bench_do_not_optimize(capture(e, kLogFormat, 8u, 412ul, -67, 21.8));
+        bench_clobber_memory();
+    }
+}
+BENCHMARK(BM_log_defer_capture);
+
+static void BM_log_entry_format(BenchState& state) {
+    LogEntry e = {};
+    capture(e, kLogFormat, 8u, 412ul, -67, 21.8);
+    char text[128];
+    for (auto _ : state) bench_do_not_optimize(log_entry_format(e, text, sizeof(text)));
+}
+BENCHMARK(BM_log_entry_format);
+
+void test_benchmarks() {
+    fill_frame();
+    fill_model();
+    std::vector<BenchResult> results = bench_run_all();
+    for (const BenchResult& r : results) {
+        TEST_ASSERT_TRUE_MESSAGE(r.iterations > 0, r.name);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_benchmarks);
+    return UNITY_END();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Host stand-in for the Arduino core, covering only what the host builds
+// (test/bench_core, test/render_golden) use: their src modules and the
+// Adafruit GFX library. Serial output is discarded so it does not skew
+// timings.
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Print.h"
+#include "WString.h"
+#include "pgmspace.h"
+
+class __FlashStringHelper;  // F() strings; never built on the host
+
+inline uint32_t micros() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+struct HostSerial {
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        (void)format;
+        return 0;
+    }
+    size_t print(const char*) { return 0; }
+    size_t println(const char* = "") { return 0; }
+    void flush() {}
+};
+
+inline HostSerial Serial;
+
+struct HostEsp {
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getMinFreeHeap() { return 0; }
+    uint32_t getMaxAllocHeap() { return 0; }
+};
+
+inline HostEsp ESP;
+
+template <typename T>
+inline T min(T a, T b) { return b < a ? b : a; }
+template <typename T>
+inline T max(T a, T b) { return a < b ? b : a; }
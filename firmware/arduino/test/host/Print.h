@@ -0,0 +1,53 @@
+#pragma once
+
+// Host stand-in for the Arduino Print base class: Adafruit_GFX derives from
+// it and renders text one write(uint8_t) per character
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* str) {
+        return str ? write((const uint8_t*)str, strlen(str)) : 0;
+    }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(long n, int base = DEC) {
+        if (base == DEC && n < 0) return write('-') + printNumber(0ul - (unsigned long)n, base);
+        return printNumber((unsigned long)n, base);
+    }
+    size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+
+    size_t println(const char* s = "") { return print(s) + write("\r\n"); }
+
+private:
+    size_t printNumber(unsigned long n, int base) {
+        if (base < 2) base = DEC;
+        char buf[8 * sizeof(long) + 1];
+        char* p = &buf[sizeof(buf) - 1];
+        *p = '\0';
+        do {
+            unsigned digit = (unsigned)(n % (unsigned)base);
+            *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+            n /= (unsigned)base;
+        } while (n);
+        return write(p);
+    }
+};
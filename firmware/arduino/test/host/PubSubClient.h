@@ -0,0 +1,29 @@
+#pragma once
+
+// Host stand-in for PubSubClient: an always-connected client that counts
+// what it would have sent
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class PubSubClient {
+public:
+    bool connected() { return true; }
+
+    bool publish(const char* topic, const char* payload, bool retained = false) {
+        (void)retained;
+        return publish(topic, (const uint8_t*)payload, strlen(payload), retained);
+    }
+
+    bool publish(const char* topic, const uint8_t* payload, unsigned int len, bool retained = false) {
+        (void)payload;
+        (void)retained;
+        messages++;
+        bytes += strlen(topic) + len;
+        return true;
+    }
+
+    size_t messages = 0;
+    size_t bytes = 0;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the Arduino String, only as far as the GFX wrappers
+// take one
+
+#include <cstddef>
+#include <string>
+
+class String {
+public:
+    String(const char* s = "") : s_(s ? s : "") {}
+    const char* c_str() const { return s_.c_str(); }
+    size_t length() const { return s_.size(); }
+
+private:
+    std::string s_;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF sleep/reset types named in power.h
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_DEEPSLEEP,
+} esp_reset_reason_t;
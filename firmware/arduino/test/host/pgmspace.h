@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in: flash and RAM share one address space
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
@@ -0,0 +1,362 @@
+// Golden-frame regression for the spec renderer
+// Builds the real op interpreter (spec_draw.cpp), DualGFX and glyph cache
+// against the Adafruit GFX library (build_src_filter and lib_deps in
+// env:native_render_golden), renders fixed RenderModels into the 250x122
+// screenshot canvas and compares each frame, bit for bit, with a PBM under
+// golden/. On a mismatch the frame and a diff (set = pixel differs) are
+// written next to the golden as <name>.actual.pbm / <name>.diff.pbm; with
+// no golden yet the frame is written as <name>.actual.pbm and the test is
+// ignored, or fails under CI so the job cannot pass without comparing.
+//
+// Environment:
+//   GOLDEN_UPDATE=1   Rewrite the goldens from this build instead of comparing
+//   GOLDEN_DIR=<dir>  Golden directory (default test/render_golden/golden)
+//   CI=true           A missing golden fails the test (set by GitHub Actions)
+//   BENCH_OUT=<file>  Per-op and per-frame times as Google Benchmark JSON,
+//                     for scripts/bench_compare.py
+
+#include <unity.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include "../bench_core/bench.h"
+#include "../../src/spec_draw.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static constexpr int16_t FRAME_W = EINK_WIDTH;
+static constexpr int16_t FRAME_H = EINK_HEIGHT;
+static constexpr size_t FRAME_STRIDE = (FRAME_W + 7) / 8;
+static constexpr size_t FRAME_BYTES = FRAME_STRIDE * FRAME_H;
+static constexpr uint32_t ALL_RECTS = 0xFFFFFFFFu;
+
+static RenderModel g_model;
+static GFXcanvas1 g_canvas(FRAME_W, FRAME_H);
+
+// --- Fixtures ---
+
+static void clear_model(RenderModel& m) {
+    for (int f = 0; f < ui::FIELD__COUNT; ++f) {
+        m.value[f] = NAN;
+        m.decimals[f] = 0;
+        m.text[f] = nullptr;
+    }
+    m.short_condition[0] = '\0';
+    m.battery = BatteryStatus();
+}
+
+// formatted[] as render_model_snapshot leaves it
+static void format_model(RenderModel& m) {
+    for (int f = 0; f < ui::FIELD__COUNT; ++f) {
+        float v = m.value[f];
+        if (m.text[f] || !std::isfinite(v)) {
+            strcpy(m.formatted[f], "--");
+        } else {
+            snprintf(m.formatted[f], RENDER_MODEL_VALUE_LEN, "%.*f", m.decimals[f], v);
+        }
+    }
+}
+
+static void set_value(RenderModel& m, int field, float v, int8_t decimals = 0) {
+    m.value[field] = v;
+    m.decimals[field] = decimals;
+}
+
+static void set_texts(RenderModel& m, const char* room, const char* ip, const char* hhmm,
+                      const char* weather) {
+    strcpy(m.ip, ip);
+    strcpy(m.time_hhmm, hhmm);
+    strcpy(m.weather, weather);
+    m.text[ui::FIELD_ROOM_NAME] = room;
+    m.text[ui::FIELD_FW_VERSION] = "1.0.0";
+    m.text[ui::FIELD_IP] = m.ip;
+    m.text[ui::FIELD_TIME_HHMM] = m.time_hhmm;
+    m.text[ui::FIELD_WEATHER] = m.weather;
+}
+
+// A typical wake: every reading present
+static void fixture_default(RenderModel& m) {
+    clear_model(m);
+    set_texts(m, "Office", "192.168.1.57", "14:05", "partly-cloudy");
+    set_value(m, ui::FIELD_INSIDE_TEMP_F, 71.6f, 1);
+    set_value(m, ui::FIELD_INSIDE_HI_F, 73.0f);
+    set_value(m, ui::FIELD_INSIDE_LO_F, 68.0f);
+    set_value(m, ui::FIELD_INSIDE_HUM_PCT, 41.0f);
+    set_value(m, ui::FIELD_PRESSURE_HPA, 1013.2f, 1);
+    set_value(m, ui::FIELD_OUTSIDE_TEMP_F, 55.4f, 1);
+    set_value(m, ui::FIELD_OUTSIDE_HUM_PCT, 68.0f);
+    set_value(m, ui::FIELD_OUTSIDE_PRESSURE_HPA, 1011.0f);
+    set_value(m, ui::FIELD_WIND_MPS, 3.4f, 1);
+    set_value(m, ui::FIELD_BATTERY_VOLTAGE, 4.12f, 2);
+    set_value(m, ui::FIELD_BATTERY_PERCENT, 87.0f);
+    set_value(m, ui::FIELD_DAYS, 143.0f);
+    m.battery_pct = 87;
+    m.has_icon = true;
+    m.icon = ICON_WEATHER_PARTLY_CLOUDY;
+    format_model(m);
+}
+
+// First wake without sensors, network or clock: every value is "--"
+static void fixture_missing(RenderModel& m) {
+    clear_model(m);
+    set_texts(m, "Office", "--", "--:--", "");
+    m.battery_pct = 0;
+    m.has_icon = false;
+    format_model(m);
+}
+
+// Widest values the layout has to hold
+static void fixture_extremes(RenderModel& m) {
+    clear_model(m);
+    set_texts(m, "Workshop Annex", "255.255.255.255", "23:59", "thunderstorm");
+    set_value(m, ui::FIELD_INSIDE_TEMP_F, -40.0f, 1);
+    set_value(m, ui::FIELD_INSIDE_HI_F, 104.0f);
+    set_value(m, ui::FIELD_INSIDE_LO_F, -40.0f);
+    set_value(m, ui::FIELD_INSIDE_HUM_PCT, 100.0f);
+    set_value(m, ui::FIELD_PRESSURE_HPA, 1084.8f, 1);
+    set_value(m, ui::FIELD_OUTSIDE_TEMP_F, 118.9f, 1);
+    set_value(m, ui::FIELD_OUTSIDE_HUM_PCT, 0.0f);
+    set_value(m, ui::FIELD_OUTSIDE_PRESSURE_HPA, 870.0f);
+    set_value(m, ui::FIELD_WIND_MPS, 44.7f, 1);
+    set_value(m, ui::FIELD_BATTERY_VOLTAGE, 3.30f, 2);
+    set_value(m, ui::FIELD_BATTERY_PERCENT, 100.0f);
+    set_value(m, ui::FIELD_DAYS, 999.0f);
+    m.battery_pct = 100;
+    m.has_icon = true;
+    m.icon = ICON_WEATHER_LIGHTNING;
+    format_model(m);
+}
+
+struct Fixture {
+    const char* name;
+    void (*fill)(RenderModel& m);
+};
+
+static const Fixture kFixtures[] = {
+    {"default", fixture_default},
+    {"missing", fixture_missing},
+    {"extremes", fixture_extremes},
+};
+
+// --- Rendering ---
+
+static void render_full(const RenderModel& m, const SpecOpProbe* probe = nullptr) {
+    g_canvas.fillScreen(0);
+    DualGFX solo(&g_canvas, nullptr, true);
+    spec_draw_ops(solo, 0, m, ALL_RECTS, probe);
+}
+
+// --- PBM (P4: MSB first, rows padded to bytes, 1 = black, as the canvas) ---
+
+static bool read_pbm(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    int w = 0, h = 0;
+    bool ok = fscanf(f, "P4 %d %d", &w, &h) == 2 && w == FRAME_W && h == FRAME_H &&
+              fgetc(f) != EOF;   // Single whitespace before the raster
+    out.assign(FRAME_BYTES, 0);
+    ok = ok && fread(out.data(), 1, FRAME_BYTES, f) == FRAME_BYTES;
+    fclose(f);
+    return ok;
+}
+
+static bool write_pbm(const std::string& path, const uint8_t* bits) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    fprintf(f, "P4\n%d %d\n", FRAME_W, FRAME_H);
+    bool ok = fwrite(bits, 1, FRAME_BYTES, f) == FRAME_BYTES;
+    return fclose(f) == 0 && ok;
+}
+
+static std::string golden_dir() {
+    const char* dir = getenv("GOLDEN_DIR");
+    return (dir && *dir) ? dir : "test/render_golden/golden";
+}
+
+static bool golden_update() {
+    const char* s = getenv("GOLDEN_UPDATE");
+    return s && *s && strcmp(s, "0") != 0;
+}
+
+static bool golden_required() {
+    const char* s = getenv("CI");
+    return s && *s && strcmp(s, "0") != 0 && strcmp(s, "false") != 0;
+}
+
+struct FrameDiff {
+    uint32_t pixels;
+    int16_t x0, y0, x1, y1;   // Bounding box of the differing pixels
+};
+
+// Writes the XOR of a and b (the diff image) into diff
+static FrameDiff diff_frames(const uint8_t* a, const uint8_t* b, uint8_t* diff) {
+    FrameDiff d = {0, FRAME_W, FRAME_H, -1, -1};
+    for (int16_t y = 0; y < FRAME_H; ++y) {
+        for (size_t i = 0; i < FRAME_STRIDE; ++i) {
+            size_t at = y * FRAME_STRIDE + i;
+            uint8_t x = a[at] ^ b[at];
+            diff[at] = x;
+            for (int bit = 0; x && bit < 8; ++bit) {
+                if (!(x & (0x80 >> bit))) continue;
+                int16_t px = static_cast<int16_t>(i * 8 + bit);
+                if (px >= FRAME_W) break;   // Row padding
+                d.pixels++;
+                if (px < d.x0) d.x0 = px;
+                if (px > d.x1) d.x1 = px;
+                if (y < d.y0) d.y0 = y;
+                if (y > d.y1) d.y1 = y;
+            }
+        }
+    }
+    return d;
+}
+
+static void check_golden(const Fixture& fx) {
+    fx.fill(g_model);
+    render_full(g_model);
+    const uint8_t* frame = g_canvas.getBuffer();
+    std::string base = golden_dir() + "/" + fx.name;
+    char msg[160];
+
+    if (golden_update()) {
+        snprintf(msg, sizeof(msg), "cannot write %s.pbm", base.c_str());
+        TEST_ASSERT_TRUE_MESSAGE(write_pbm(base + ".pbm", frame), msg);
+        printf("Golden written: %s.pbm\n", base.c_str());
+        return;
+    }
+
+    std::vector<uint8_t> golden;
+    if (!read_pbm(base + ".pbm", golden)) {
+        write_pbm(base + ".actual.pbm", frame);   // Candidate to review and commit
+        snprintf(msg, sizeof(msg), "no golden %s.pbm; record it with GOLDEN_UPDATE=1",
+                 base.c_str());
+        if (golden_required()) TEST_FAIL_MESSAGE(msg);
+        TEST_IGNORE_MESSAGE(msg);
+    }
+
+    std::vector<uint8_t> diff(FRAME_BYTES);
+    FrameDiff d = diff_frames(golden.data(), frame, diff.data());
+    if (d.pixels == 0) return;
+    write_pbm(base + ".actual.pbm", frame);
+    write_pbm(base + ".diff.pbm", diff.data());
+    snprintf(msg, sizeof(msg), "%s: %u pixels differ in x %d-%d, y %d-%d (see %s.diff.pbm)",
+             fx.name, (unsigned)d.pixels, d.x0, d.x1, d.y0, d.y1, base.c_str());
+    TEST_FAIL_MESSAGE(msg);
+}
+
+static void test_golden_default() { check_golden(kFixtures[0]); }
+static void test_golden_missing() { check_golden(kFixtures[1]); }
+static void test_golden_extremes() { check_golden(kFixtures[2]); }
+
+// --- Timing ---
+
+typedef std::chrono::steady_clock Clock;
+
+struct OpTimes {
+    std::vector<int> first;          // Slot of op 0 per component
+    std::vector<double> ns;          // Accumulated per op slot
+    Clock::time_point started;
+};
+
+static void probe_begin(void* ctx, int, int, const ui::UiOpHeader&) {
+    static_cast<OpTimes*>(ctx)->started = Clock::now();
+}
+
+static void probe_end(void* ctx, int component, int index, const ui::UiOpHeader&) {
+    OpTimes* t = static_cast<OpTimes*>(ctx);
+    t->ns[t->first[component] + index] +=
+        std::chrono::duration<double, std::nano>(Clock::now() - t->started).count();
+}
+
+static const char* op_kind_name(uint8_t kind) {
+    switch (kind) {
+        case ui::OP_BATTERYGLYPH: return "battery_glyph";
+        case ui::OP_ICONIN: return "icon_in";
+        case ui::OP_LINE: return "line";
+        case ui::OP_TEMPGROUPCENTERED: return "temp_group";
+        case ui::OP_TEXT: return "text";
+        case ui::OP_TEXTCENTEREDIN: return "text_centered";
+        case ui::OP_TIMERIGHT: return "time_right";
+        default: return "op";
+    }
+}
+
+static std::deque<std::string> g_names;   // Stable storage for BenchResult::name
+
+static BenchResult result(const std::string& name, uint64_t runs, double total_ns) {
+    g_names.push_back(name);
+    BenchResult r = {};
+    r.name = g_names.back().c_str();
+    r.iterations = runs;
+    r.real_ns = runs ? total_ns / runs : 0;
+    r.cpu_ns = r.real_ns;
+    return r;
+}
+
+// Frames are timed without the probe; ops with it, over a second set of runs
+static void time_fixture(const Fixture& fx, std::vector<BenchResult>& out) {
+    fx.fill(g_model);
+    const double min_ns = bench_min_time() * 1e9;
+
+    uint64_t frames = 0;
+    double frame_ns = 0;
+    while (frames < 10 || frame_ns < min_ns) {
+        Clock::time_point start = Clock::now();
+        render_full(g_model);
+        frame_ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        frames++;
+    }
+    out.push_back(result(std::string("frame/") + fx.name, frames, frame_ns));
+
+    int comp_count = 0;
+    const ui::ComponentOps* comps = ui::get_variant_ops(0, &comp_count);
+    OpTimes times;
+    for (int ci = 0; ci < comp_count; ++ci) {
+        times.first.push_back(static_cast<int>(times.ns.size()));
+        times.ns.resize(times.ns.size() + comps[ci].count, 0.0);
+    }
+    SpecOpProbe probe = {probe_begin, probe_end, &times};
+    for (uint64_t i = 0; i < frames; ++i) render_full(g_model, &probe);
+
+    for (int ci = 0; ci < comp_count; ++ci) {
+        for (int i = 0; i < comps[ci].count; ++i) {
+            char name[96];
+            snprintf(name, sizeof(name), "op/%s/%s/%d:%s", fx.name, comps[ci].name, i,
+                     op_kind_name(comps[ci].ops[i].kind));
+            out.push_back(result(name, frames, times.ns[times.first[ci] + i]));
+        }
+    }
+}
+
+static void test_render_timing() {
+    std::vector<BenchResult> results;
+    for (const Fixture& fx : kFixtures) time_fixture(fx, results);
+
+    printf("%-48s %14s %12s\n", "Render", "Time (ns)", "Frames");
+    for (const BenchResult& r : results) {
+        printf("%-48s %14.1f %12llu\n", r.name, r.real_ns, (unsigned long long)r.iterations);
+    }
+    const char* out = getenv("BENCH_OUT");
+    if (out && *out) {
+        FILE* f = fopen(out, "w");
+        TEST_ASSERT_NOT_NULL_MESSAGE(f, out);
+        bench_write_json(f, results, "render_golden");
+        fclose(f);
+        printf("Results written to %s\n", out);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_golden_default);
+    RUN_TEST(test_golden_missing);
+    RUN_TEST(test_golden_extremes);
+    RUN_TEST(test_render_timing);
+    return UNITY_END();
+}
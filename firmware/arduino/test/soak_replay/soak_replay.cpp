@@ -0,0 +1,432 @@
+// Soak replay of the wake cycle on the host
+// Runs thousands of simulated timer wakes per scenario through the same
+// policy cores the device uses (publish_policy.h, sleep_policy.h,
+// trend_model.h, energy_model.h) with RTC state carried from one wake to the
+// next. WiFi association, MQTT connect, publish delivery, retained fetch and
+// the I2C conversion are drawn from per-scenario latency and loss figures;
+// the phase sequence and timeouts mirror app_setup(). Each scenario reports
+// the awake-time distribution, how many wakes used the radio, skipped it or
+// failed to deliver, and the modelled average current.
+//
+// app_setup() itself is bound to the SDK (WiFi, PubSubClient, esp_sleep), so
+// it is not built here: a change to its phase order or timeouts must be
+// mirrored in run_wake() below.
+//
+// Environment:
+//   SOAK_WAKES=<n>    Wakes per scenario (default 5000)
+//   SOAK_SEED=<n>     RNG seed (default 1); runs are reproducible per seed
+//   SOAK_OUT=<file>   Per-scenario results as JSON
+
+#include <unity.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "../../src/config.h"
+#include "../../src/energy_model.h"
+#include "../../src/publish_policy.h"
+#include "../../src/sleep_policy.h"
+#include "../../src/trend_model.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Timeouts and fixed phase costs of the device build. The first three live in
+// SDK-bound headers (wifi_manager.h, mqtt_client.h, app_controller.cpp).
+static constexpr uint32_t WIFI_TIMEOUT_MS = 6000;      // WIFI_CONNECT_TIMEOUT_MS
+static constexpr uint32_t WIFI_ATTEMPTS = 3;           // wifi_connect_with_exponential_backoff(3, 1000)
+static constexpr uint32_t WIFI_RETRY_DELAY_MS = 1000;  // Doubles per attempt, 16 s cap
+static constexpr uint32_t MQTT_TIMEOUT_MS = 4000;      // MQTT_CONNECT_TIMEOUT_MS
+static constexpr uint32_t BOOT_MS = 120;               // Reset to app_setup(), RTC restore
+static constexpr uint32_t PANEL_MS = 900;              // Partial refresh, BUSY asserted
+static constexpr uint32_t PUBLISH_MS = 40;             // Batched publish + flush
+static constexpr uint32_t DEFERRED_MS = 30;            // Deferred publish phase
+
+// Same table as the device (config.h ENERGY_*)
+static const EnergyCurrents kCurrents = {
+    {ENERGY_MA_CPU, ENERGY_MA_RADIO_RX, ENERGY_MA_RADIO_TX, ENERGY_MA_PANEL, ENERGY_MA_SLEEP},
+    ENERGY_RADIO_TX_SHARE};
+
+static const SleepConfig kSleep = {300, 600, 1800, 60, 20, 5, SLEEP_MAX_INTERVAL_SEC};
+
+// Latencies are log-normal: the median, and sigma of the log (0 = fixed)
+struct Latency {
+    uint32_t median_ms;
+    float sigma;
+};
+
+struct Scenario {
+    const char* name;
+    Latency wifi;             // Association + DHCP, per attempt
+    float wifi_fail;          // Attempt runs into WIFI_TIMEOUT_MS
+    Latency mqtt;             // TCP + CONNECT/CONNACK
+    float mqtt_fail;          // Connect runs into MQTT_TIMEOUT_MS
+    float publish_loss;       // Connected, but the batch is not delivered
+    Latency retained;         // Retained outdoor topics after SUBSCRIBE
+    float retained_missing;   // Topic never arrives; waits the full fetch timeout
+    Latency i2c;              // Forced-mode conversion + read
+    float i2c_fail;           // Sensor runs into SENSOR_PHASE_TIMEOUT_MS, NaN readings
+    float diurnal_c;          // Amplitude of the daily temperature swing
+    float noise_c;            // Reading noise (1 sigma)
+    float step_per_wake;      // Chance of a sudden temperature step (door, heater)
+    float step_c;
+    int battery_pct;          // -1 = no gauge
+    float rtc_loss;           // Chance a wake starts from a cold boot (RTC lost)
+    uint32_t store_forward;   // STORE_FORWARD_WAKES for this scenario
+};
+
+static const Scenario kScenarios[] = {
+    // name          wifi         fail   mqtt        fail   loss   retained    miss   i2c        fail    diur  noise  step    stepC bat rtc     sf
+    {"ideal",        {900, 0.2f},  0.0f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {12, 0.1f}, 0.0f,  1.5f, 0.02f, 0.0f,  0.0f, 80, 0.0f,  1},
+    {"flat_night",   {900, 0.2f},  0.0f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {12, 0.1f}, 0.0f,  0.2f, 0.02f, 0.0f,  0.0f, 80, 0.0f,  1},
+    {"busy_room",    {900, 0.2f},  0.0f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {12, 0.1f}, 0.0f,  3.0f, 0.08f, 0.05f, 1.0f, 80, 0.0f,  1},
+    {"weak_ap",      {2500, 0.6f}, 0.15f, {400, 0.6f}, 0.05f, 0.02f, {300, 0.6f}, 0.0f, {12, 0.1f}, 0.0f,  1.5f, 0.02f, 0.0f,  0.0f, 80, 0.0f,  1},
+    {"ap_down",      {900, 0.2f},  0.9f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {12, 0.1f}, 0.0f,  1.5f, 0.02f, 0.0f,  0.0f, 80, 0.0f,  1},
+    {"broker_slow",  {900, 0.2f},  0.0f, {1200, 0.5f}, 0.1f, 0.05f, {600, 0.5f}, 0.2f, {12, 0.1f}, 0.0f,  1.5f, 0.02f, 0.0f,  0.0f, 80, 0.0f,  1},
+    {"flaky_i2c",    {900, 0.2f},  0.0f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {40, 0.5f}, 0.05f, 1.5f, 0.02f, 0.0f,  0.0f, 80, 0.0f,  1},
+    {"low_battery",  {900, 0.2f},  0.0f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {12, 0.1f}, 0.0f,  1.5f, 0.02f, 0.0f,  0.0f, 15, 0.0f,  1},
+    {"brownouts",    {900, 0.2f},  0.0f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {12, 0.1f}, 0.0f,  1.5f, 0.02f, 0.0f,  0.0f, 80, 0.02f, 1},
+    {"store_fwd_4",  {900, 0.2f},  0.0f, {150, 0.2f}, 0.0f,  0.0f,  {80, 0.3f},  0.0f, {12, 0.1f}, 0.0f,  1.5f, 0.02f, 0.0f,  0.0f, 80, 0.0f,  4},
+};
+
+// xorshift64*: the same sequence on every host, unlike <random> distributions
+class SoakRng {
+public:
+    explicit SoakRng(uint64_t seed) : s_(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+    uint64_t next() {
+        s_ ^= s_ >> 12;
+        s_ ^= s_ << 25;
+        s_ ^= s_ >> 27;
+        return s_ * 0x2545F4914F6CDD1Dull;
+    }
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+    bool chance(float p) { return uniform() < p; }
+    double gauss() {
+        double u1 = uniform();
+        double u2 = uniform();
+        if (u1 < 1e-12) u1 = 1e-12;
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+    uint32_t latency(const Latency& l) {
+        return (uint32_t)(l.median_ms * std::exp(l.sigma * gauss()) + 0.5);
+    }
+
+private:
+    uint64_t s_;
+};
+
+// What survives deep sleep (rtc_state.h fields the policies read)
+struct SoakRtc {
+    PublishSnapshot last_tx;
+    uint32_t sec_since_tx;
+    uint16_t wakes_since_tx;
+    TrendHistory trend;
+};
+
+static void soak_rtc_reset(SoakRtc& rtc) {
+    rtc.last_tx = {NAN, NAN, NAN};
+    rtc.sec_since_tx = 0;
+    rtc.wakes_since_tx = 0;
+    trend_reset(rtc.trend);
+}
+
+struct SoakWake {
+    uint32_t awake_ms;
+    uint32_t radio_ms;
+    uint32_t sleep_sec;
+    bool network;             // Radio came up
+    bool delivered;           // New baseline transmitted
+};
+
+// The room the sensor sits in
+struct SoakRoom {
+    double t_sec;
+    float offset_c;           // Sum of the steps so far
+
+    PublishSnapshot read(const Scenario& sc, SoakRng& rng) {
+        double day = std::sin(6.283185307179586 * t_sec / 86400.0);
+        PublishSnapshot s;
+        s.tempC = (float)(21.0 + sc.diurnal_c * day + offset_c + sc.noise_c * rng.gauss());
+        s.rhPct = (float)(45.0 - 2.0 * day + 0.1 * rng.gauss());
+        s.pressHPa = (float)(1013.0 + 0.3 * std::sin(6.283185307179586 * t_sec / 259200.0) +
+                             0.02 * rng.gauss());
+        return s;
+    }
+};
+
+// One timer wake, in app_setup() order
+static SoakWake run_wake(const Scenario& sc, SoakRng& rng, SoakRtc& rtc, SoakRoom& room) {
+    SoakWake w = {};
+    uint32_t ms = BOOT_MS;
+
+    if (rng.chance(sc.rtc_loss)) soak_rtc_reset(rtc);
+    if (sc.step_per_wake > 0 && rng.chance(sc.step_per_wake)) {
+        room.offset_c += rng.chance(0.5f) ? sc.step_c : -sc.step_c;
+    }
+
+    // Sensor phase (read_sensors_with_timeout)
+    PublishSnapshot now;
+    if (rng.chance(sc.i2c_fail)) {
+        ms += SENSOR_PHASE_TIMEOUT_MS;
+        now = {NAN, NAN, NAN};
+    } else {
+        ms += std::min(rng.latency(sc.i2c), (uint32_t)SENSOR_PHASE_TIMEOUT_MS);
+        now = room.read(sc, rng);
+    }
+
+    // Skip check (evaluate_skip_network)
+    PublishDecision d = evaluate_publish_policy(default_publish_policy(), rtc.last_tx, now,
+                                                rtc.sec_since_tx);
+    bool skip = sc.store_forward > 1
+                    ? store_forward_skip(d, (uint32_t)rtc.wakes_since_tx + 1, sc.store_forward)
+                    : d == PublishDecision::SKIP;
+
+    if (!skip) {
+        w.network = true;
+        uint32_t radio_start = ms;
+
+        bool wifi = false;
+        uint32_t delay_ms = WIFI_RETRY_DELAY_MS;
+        for (uint32_t attempt = 0; attempt < WIFI_ATTEMPTS && !wifi; attempt++) {
+            uint32_t t = rng.latency(sc.wifi);
+            if (rng.chance(sc.wifi_fail) || t >= WIFI_TIMEOUT_MS) {
+                ms += WIFI_TIMEOUT_MS;
+                if (attempt + 1 < WIFI_ATTEMPTS) {
+                    ms += delay_ms;
+                    delay_ms = std::min(delay_ms * 2, (uint32_t)16000);
+                }
+            } else {
+                ms += t;
+                wifi = true;
+            }
+        }
+
+        bool mqtt = false;
+        if (wifi) {
+            uint32_t t = rng.latency(sc.mqtt);
+            if (rng.chance(sc.mqtt_fail) || t >= MQTT_TIMEOUT_MS) {
+                ms += MQTT_TIMEOUT_MS;
+            } else {
+                ms += t;
+                mqtt = true;
+            }
+        }
+
+        if (mqtt) {
+            // Network phase: publish, then wait for the retained outdoor topics
+            ms += PUBLISH_MS;
+            if (!rng.chance(sc.publish_loss) && std::isfinite(now.tempC)) {
+                rtc.last_tx = now;
+                rtc.sec_since_tx = 0;
+                rtc.wakes_since_tx = 0;
+                w.delivered = true;
+            }
+            uint32_t t = rng.latency(sc.retained);
+            ms += rng.chance(sc.retained_missing) ? (uint32_t)FETCH_RETAINED_TIMEOUT_MS
+                                                  : std::min(t, (uint32_t)FETCH_RETAINED_TIMEOUT_MS);
+        }
+        ms += DEFERRED_MS;
+        w.radio_ms = ms - radio_start;
+    }
+
+    // Display phase runs on every wake; the radio is already off by then
+    ms += PANEL_MS;
+    w.awake_ms = ms;
+
+    // Sleep phase: trend sample, planned interval, staleness for the next wake
+    uint32_t awake_sec = ms / 1000;
+    trend_push(rtc.trend, rtc.trend.next_dt_sec, now.tempC);
+    w.sleep_sec = sleep_plan_interval(kSleep, sc.battery_pct, trend_rate(rtc.trend),
+                                      default_publish_policy().temp_deadband_c);
+    rtc.trend.next_dt_sec = w.sleep_sec + awake_sec;
+    uint32_t add = w.sleep_sec + awake_sec;
+    rtc.sec_since_tx = rtc.sec_since_tx > UINT32_MAX - add ? UINT32_MAX : rtc.sec_since_tx + add;
+    if (rtc.wakes_since_tx < UINT16_MAX) rtc.wakes_since_tx++;
+
+    room.t_sec += w.sleep_sec + ms / 1000.0;
+    return w;
+}
+
+struct SoakResult {
+    const char* name;
+    uint32_t wakes;
+    uint32_t p50_ms, p90_ms, p99_ms, max_ms;
+    double mean_ms;
+    double network_pct, skip_pct, failed_pct;
+    double mean_sleep_sec;
+    double max_gap_sec;       // Longest time between delivered baselines
+    double avg_ma;
+};
+
+static uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+    if (rank == 0) rank = 1;
+    return sorted[rank - 1];
+}
+
+static SoakResult run_scenario(const Scenario& sc, uint32_t wakes, uint64_t seed) {
+    SoakRng rng(seed);
+    SoakRtc rtc;
+    soak_rtc_reset(rtc);
+    SoakRoom room = {0.0, 0.0f};
+
+    std::vector<uint32_t> awake;
+    awake.reserve(wakes);
+    uint32_t network = 0, failed = 0;
+    double sleep_sum = 0, uah_sum = 0, sec_sum = 0;
+    double last_delivery = -1, max_gap = 0;
+
+    for (uint32_t i = 0; i < wakes; i++) {
+        double wake_at = room.t_sec;
+        SoakWake w = run_wake(sc, rng, rtc, room);
+        awake.push_back(w.awake_ms);
+        if (w.network) network++;
+        if (w.network && !w.delivered) failed++;
+        sleep_sum += w.sleep_sec;
+
+        if (w.delivered) {
+            if (last_delivery >= 0) max_gap = std::max(max_gap, wake_at - last_delivery);
+            last_delivery = wake_at;
+        }
+
+        EnergyPhaseUs t = {};
+        t.us[ENERGY_CPU] = (uint64_t)w.awake_ms * 1000;
+        energy_split_radio(t, (uint64_t)w.radio_ms * 1000, kCurrents.tx_share);
+        t.us[ENERGY_PANEL] = (uint64_t)PANEL_MS * 1000;
+        t.us[ENERGY_SLEEP] = (uint64_t)w.sleep_sec * 1000000;
+        uah_sum += energy_wake_charge(t, kCurrents).total_uah;
+        sec_sum += w.sleep_sec + w.awake_ms / 1000.0;
+    }
+
+    SoakResult r = {};
+    r.name = sc.name;
+    r.wakes = wakes;
+    double total_ms = 0;
+    for (uint32_t a : awake) total_ms += a;
+    std::sort(awake.begin(), awake.end());
+    r.p50_ms = percentile(awake, 50);
+    r.p90_ms = percentile(awake, 90);
+    r.p99_ms = percentile(awake, 99);
+    r.max_ms = awake.empty() ? 0 : awake.back();
+    r.mean_ms = wakes ? total_ms / wakes : 0;
+    r.network_pct = wakes ? 100.0 * network / wakes : 0;
+    r.skip_pct = wakes ? 100.0 * (wakes - network) / wakes : 0;
+    r.failed_pct = wakes ? 100.0 * failed / wakes : 0;
+    r.mean_sleep_sec = wakes ? sleep_sum / wakes : 0;
+    r.max_gap_sec = max_gap;
+    r.avg_ma = sec_sum > 0 ? uah_sum / 1000.0 / (sec_sum / 3600.0) : 0;
+    return r;
+}
+
+// Longest wake the phase timeouts allow: every WiFi attempt times out but
+// the last, then MQTT connects just inside its timeout and the retained
+// fetch waits its full timeout
+static uint32_t worst_case_awake_ms() {
+    uint32_t wifi = 0, delay_ms = WIFI_RETRY_DELAY_MS;
+    for (uint32_t a = 0; a < WIFI_ATTEMPTS; a++) {
+        wifi += WIFI_TIMEOUT_MS;
+        if (a + 1 < WIFI_ATTEMPTS) {
+            wifi += delay_ms;
+            delay_ms = std::min(delay_ms * 2, (uint32_t)16000);
+        }
+    }
+    return BOOT_MS + SENSOR_PHASE_TIMEOUT_MS + wifi + MQTT_TIMEOUT_MS + PUBLISH_MS +
+           FETCH_RETAINED_TIMEOUT_MS + DEFERRED_MS + PANEL_MS;
+}
+
+// Longest a reachable broker may go without a new baseline: the heartbeat
+// fires on the first wake past it, which may have slept the full ceiling
+static double max_staleness_sec(const Scenario& sc) {
+    double wake = SLEEP_MAX_INTERVAL_SEC + worst_case_awake_ms() / 1000.0;
+    if (sc.store_forward > 1) return sc.store_forward * wake;
+    return SKIP_NET_HEARTBEAT_SEC + wake;
+}
+
+static uint32_t env_u32(const char* name, uint32_t def) {
+    const char* s = getenv(name);
+    if (!s || !*s) return def;
+    return (uint32_t)strtoul(s, nullptr, 10);
+}
+
+static void write_json(const char* path, const std::vector<SoakResult>& results, uint64_t seed) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "soak_replay: cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "{\n  \"context\": {\"executable\": \"soak_replay\", \"seed\": %llu},\n",
+            (unsigned long long)seed);
+    fprintf(f, "  \"scenarios\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const SoakResult& r = results[i];
+        fprintf(f,
+                "    {\"name\": \"%s\", \"wakes\": %u, \"awake_ms\": {\"p50\": %u, \"p90\": %u, "
+                "\"p99\": %u, \"max\": %u, \"mean\": %.1f}, \"network_pct\": %.2f, "
+                "\"skip_pct\": %.2f, \"failed_pct\": %.2f, \"mean_sleep_sec\": %.1f, "
+                "\"max_gap_sec\": %.0f, \"avg_ma\": %.4f}%s\n",
+                r.name, r.wakes, r.p50_ms, r.p90_ms, r.p99_ms, r.max_ms, r.mean_ms,
+                r.network_pct, r.skip_pct, r.failed_pct, r.mean_sleep_sec, r.max_gap_sec,
+                r.avg_ma, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+static const SoakResult& find(const std::vector<SoakResult>& results, const char* name) {
+    for (const SoakResult& r : results) {
+        if (strcmp(r.name, name) == 0) return r;
+    }
+    return results.front();   // Names come from kScenarios
+}
+
+static void test_soak_replay() {
+    uint32_t wakes = env_u32("SOAK_WAKES", 5000);
+    uint64_t seed = env_u32("SOAK_SEED", 1);
+    uint32_t bound_ms = worst_case_awake_ms();
+
+    std::vector<SoakResult> results;
+    printf("\n%-12s %7s %6s %6s %6s %6s %6s %6s %6s %7s %8s\n", "scenario", "wakes", "p50",
+           "p90", "p99", "max", "net%", "skip%", "fail%", "sleep_s", "avg_mA");
+    for (size_t i = 0; i < sizeof(kScenarios) / sizeof(kScenarios[0]); i++) {
+        const Scenario& sc = kScenarios[i];
+        SoakResult r = run_scenario(sc, wakes, seed + i);
+        results.push_back(r);
+        printf("%-12s %7u %6u %6u %6u %6u %6.1f %6.1f %6.1f %7.0f %8.4f\n", r.name, r.wakes,
+               r.p50_ms, r.p90_ms, r.p99_ms, r.max_ms, r.network_pct, r.skip_pct, r.failed_pct,
+               r.mean_sleep_sec, r.avg_ma);
+
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s: a wake outlasted the phase timeouts", sc.name);
+        TEST_ASSERT_TRUE_MESSAGE(r.max_ms <= bound_ms, msg);
+        snprintf(msg, sizeof(msg), "%s: sleep outside the planner bounds", sc.name);
+        TEST_ASSERT_TRUE_MESSAGE(r.mean_sleep_sec >= kSleep.rapid_update_interval_sec &&
+                                     r.mean_sleep_sec <= kSleep.critical_interval_sec,
+                                 msg);
+        // Only meaningful where every connect succeeds and every reading is valid
+        if (sc.wifi_fail == 0 && sc.mqtt_fail == 0 && sc.publish_loss == 0 && sc.i2c_fail == 0) {
+            snprintf(msg, sizeof(msg), "%s: baseline older than the heartbeat allows", sc.name);
+            TEST_ASSERT_TRUE_MESSAGE(r.max_gap_sec <= max_staleness_sec(sc), msg);
+        }
+    }
+
+    // A changing room wakes sooner than a flat one, store-and-forward keeps
+    // the radio off more often, a lost AP must not pretend to deliver
+    TEST_ASSERT_TRUE(find(results, "busy_room").mean_sleep_sec <
+                     find(results, "flat_night").mean_sleep_sec);
+    TEST_ASSERT_TRUE(find(results, "store_fwd_4").skip_pct > find(results, "ideal").skip_pct);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, (float)find(results, "ideal").failed_pct);
+    TEST_ASSERT_TRUE(find(results, "ap_down").failed_pct > find(results, "weak_ap").failed_pct);
+
+    const char* out = getenv("SOAK_OUT");
+    if (out && *out) write_json(out, results, seed);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_soak_replay);
+    return UNITY_END();
+}
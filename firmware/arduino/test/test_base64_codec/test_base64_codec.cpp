@@ -0,0 +1,62 @@
+// Unit tests for the screenshot base64 encoder
+// RFC 4648 test vectors plus block-wise streaming
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/base64_codec.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void assert_encodes(const char* in, const char* expected) {
+    char out[64];
+    size_t n = base64_encode_block((const uint8_t*)in, strlen(in), out);
+    TEST_ASSERT_EQUAL(BASE64_ENCODED_LEN(strlen(in)), n);
+    out[n] = '\0';
+    TEST_ASSERT_EQUAL_STRING(expected, out);
+}
+
+void test_rfc4648_vectors() {
+    assert_encodes("", "");
+    assert_encodes("f", "Zg==");
+    assert_encodes("fo", "Zm8=");
+    assert_encodes("foo", "Zm9v");
+    assert_encodes("foob", "Zm9vYg==");
+    assert_encodes("fooba", "Zm9vYmE=");
+    assert_encodes("foobar", "Zm9vYmFy");
+}
+
+void test_high_bytes_use_plus_and_slash() {
+    const uint8_t in[3] = {0xFB, 0xFF, 0xBF};
+    char out[4];
+    TEST_ASSERT_EQUAL(4, base64_encode_block(in, sizeof(in), out));
+    TEST_ASSERT_EQUAL_MEMORY("+/+/", out, 4);
+}
+
+void test_aligned_blocks_concatenate() {
+    uint8_t in[100];
+    for (size_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)(i * 37 + 11);
+
+    char whole[BASE64_ENCODED_LEN(sizeof(in))];
+    size_t whole_len = base64_encode_block(in, sizeof(in), whole);
+
+    // 48-byte blocks, as display_capture streams them, then the tail
+    char streamed[sizeof(whole)];
+    size_t pos = 0;
+    size_t out = 0;
+    while (pos < sizeof(in)) {
+        size_t n = sizeof(in) - pos < 48 ? sizeof(in) - pos : 48;
+        out += base64_encode_block(in + pos, n, streamed + out);
+        pos += n;
+    }
+    TEST_ASSERT_EQUAL(whole_len, out);
+    TEST_ASSERT_EQUAL_MEMORY(whole, streamed, whole_len);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rfc4648_vectors);
+    RUN_TEST(test_high_bytes_use_plus_and_slash);
+    RUN_TEST(test_aligned_blocks_concatenate);
+    return UNITY_END();
+}
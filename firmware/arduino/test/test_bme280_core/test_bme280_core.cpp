@@ -0,0 +1,112 @@
+// Unit tests for the BME280 register helpers: register packing, conversion
+// time, calibration parsing and compensation against the datasheet example
+
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+#include "../../src/bme280_core.h"
+
+// Bosch example calibration (BMP280 datasheet section 8.2 / 3.11.3)
+static Bme280Calib example_calib() {
+    Bme280Calib c;
+    memset(&c, 0, sizeof(c));
+    c.t1 = 27504; c.t2 = 26435; c.t3 = -1000;
+    c.p1 = 36477; c.p2 = -10685; c.p3 = 3024; c.p4 = 2855; c.p5 = 140;
+    c.p6 = -7; c.p7 = 15500; c.p8 = -14600; c.p9 = 6000;
+    c.h1 = 75; c.h2 = 362; c.h3 = 0; c.h4 = 313; c.h5 = 50; c.h6 = 30;
+    return c;
+}
+
+// Pack 20-bit adc_p / adc_t and 16-bit adc_h as registers 0xF7..0xFE
+static void pack(uint8_t* d, int32_t adc_p, int32_t adc_t, int32_t adc_h) {
+    d[0] = (uint8_t)(adc_p >> 12); d[1] = (uint8_t)(adc_p >> 4); d[2] = (uint8_t)((adc_p & 0xF) << 4);
+    d[3] = (uint8_t)(adc_t >> 12); d[4] = (uint8_t)(adc_t >> 4); d[5] = (uint8_t)((adc_t & 0xF) << 4);
+    d[6] = (uint8_t)(adc_h >> 8);  d[7] = (uint8_t)adc_h;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_register_values() {
+    TEST_ASSERT_EQUAL_HEX8(0x25, bme280_ctrl_meas(1, 1, BME280_MODE_FORCED));
+    TEST_ASSERT_EQUAL_HEX8(0x54, bme280_ctrl_meas(2, 16, BME280_MODE_SLEEP));
+    TEST_ASSERT_EQUAL_HEX8(0x00, bme280_ctrl_meas(0, 0, BME280_MODE_SLEEP));
+    TEST_ASSERT_EQUAL_HEX8(0x03, bme280_ctrl_hum(4));
+    TEST_ASSERT_EQUAL_HEX8(0x00, bme280_config_reg(0));
+    TEST_ASSERT_EQUAL_HEX8(0x08, bme280_config_reg(4));
+    TEST_ASSERT_EQUAL_HEX8(0x10, bme280_config_reg(16));
+    TEST_ASSERT_EQUAL_UINT8(3, bme280_osrs_code(5));    // Rounds down to x4
+}
+
+void test_measure_time() {
+    TEST_ASSERT_EQUAL_UINT32(9300, bme280_measure_time_us(1, 1, 1));
+    TEST_ASSERT_EQUAL_UINT32(3550, bme280_measure_time_us(1, 0, 0));
+    TEST_ASSERT_EQUAL_UINT32(1250 + 2300 * 2 + 2300 * 16 + 575 + 2300 + 575,
+                             bme280_measure_time_us(2, 16, 1));
+}
+
+void test_parse_calib_nibbles() {
+    uint8_t tp[BME280_CALIB_TP_LEN] = {};
+    uint8_t h[BME280_CALIB_H_LEN] = {};
+    tp[0] = 0x70; tp[1] = 0x6B;             // t1 = 27504
+    tp[2] = 0x43; tp[3] = 0x67;             // t2 = 26435
+    tp[4] = 0x18; tp[5] = 0xFC;             // t3 = -1000
+    tp[25] = 75;                            // h1 at 0xA1
+    h[0] = 0x6A; h[1] = 0x01;               // h2 = 362
+    h[2] = 0;                               // h3
+    h[3] = 0x13; h[4] = 0x29; h[5] = 0xFE;  // h4 = 0x139, h5 = 0xFE2 (-30)
+    h[6] = 0xE2;                            // h6 = -30
+    Bme280Calib c;
+    bme280_parse_calib(tp, h, c);
+    TEST_ASSERT_EQUAL_UINT16(27504, c.t1);
+    TEST_ASSERT_EQUAL_INT16(26435, c.t2);
+    TEST_ASSERT_EQUAL_INT16(-1000, c.t3);
+    TEST_ASSERT_EQUAL_UINT8(75, c.h1);
+    TEST_ASSERT_EQUAL_INT16(362, c.h2);
+    TEST_ASSERT_EQUAL_INT16(313, c.h4);
+    TEST_ASSERT_EQUAL_INT16(-30, c.h5);
+    TEST_ASSERT_EQUAL_INT8(-30, c.h6);
+}
+
+void test_compensate_datasheet_example() {
+    Bme280Calib c = example_calib();
+    TEST_ASSERT_EQUAL_INT32(128422, bme280_t_fine(c, 519888));
+    uint8_t d[BME280_DATA_LEN];
+    pack(d, 415148, 519888, 30000);
+    Bme280Reading r = bme280_compensate(c, d);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 25.08f, r.temperatureC);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1006.53f, r.pressureHPa);
+    TEST_ASSERT_TRUE(r.humidityPct >= 0.0f && r.humidityPct <= 100.0f);
+}
+
+void test_skipped_channels_are_nan() {
+    Bme280Calib c = example_calib();
+    uint8_t d[BME280_DATA_LEN];
+    pack(d, 0x80000, 519888, 0x8000);
+    Bme280Reading r = bme280_compensate(c, d);
+    TEST_ASSERT_FALSE(std::isnan(r.temperatureC));
+    TEST_ASSERT_TRUE(std::isnan(r.pressureHPa));
+    TEST_ASSERT_TRUE(std::isnan(r.humidityPct));
+    pack(d, 415148, 0x80000, 30000);
+    r = bme280_compensate(c, d);
+    TEST_ASSERT_TRUE(std::isnan(r.temperatureC));
+    TEST_ASSERT_TRUE(std::isnan(r.pressureHPa));
+}
+
+void test_humidity_clamped() {
+    Bme280Calib c = example_calib();
+    int32_t t_fine = bme280_t_fine(c, 519888);
+    TEST_ASSERT_EQUAL_UINT32(0, bme280_humidity_q22_10(c, 0, t_fine));
+    TEST_ASSERT_EQUAL_UINT32(100u * 1024u, bme280_humidity_q22_10(c, 0xFFFF, t_fine));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_register_values);
+    RUN_TEST(test_measure_time);
+    RUN_TEST(test_parse_calib_nibbles);
+    RUN_TEST(test_compensate_datasheet_example);
+    RUN_TEST(test_skipped_channels_are_nan);
+    RUN_TEST(test_humidity_clamped);
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+// Unit tests for the lock-free size-class pool core: class selection,
+// fallback to larger classes, high-water marks, release checks and caller tags
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/buffer_pool_core.h"
+
+static char storage[4 * 64 + 2 * 128 + 1 * 256];
+static PoolClass classes[3];
+static PoolCore pool;
+
+void setUp(void) {
+    memset(&pool, 0, sizeof(pool));
+    pool_class_init(classes[0], storage, 64, 4);
+    pool_class_init(classes[1], storage + 4 * 64, 128, 2);
+    pool_class_init(classes[2], storage + 4 * 64 + 2 * 128, 256, 1);
+    pool.classes = classes;
+    pool.class_count = 3;
+}
+void tearDown(void) {}
+
+void test_smallest_fitting_class() {
+    size_t got = 0;
+    char* a = pool_acquire(pool, 10, &got);
+    TEST_ASSERT_EQUAL_PTR(storage, a);
+    TEST_ASSERT_EQUAL(64, got);
+    char* b = pool_acquire(pool, 100, &got);
+    TEST_ASSERT_EQUAL_PTR(storage + 4 * 64, b);
+    TEST_ASSERT_EQUAL(128, got);
+    TEST_ASSERT_NULL(pool_acquire(pool, 300, &got));
+    TEST_ASSERT_EQUAL(0, got);
+    TEST_ASSERT_EQUAL(1, pool.failures);
+}
+
+void test_full_class_falls_back_to_larger() {
+    for (int i = 0; i < 4; i++) TEST_ASSERT_NOT_NULL(pool_acquire(pool, 64));
+    size_t got = 0;
+    char* m = pool_acquire(pool, 64, &got);
+    TEST_ASSERT_EQUAL(128, got);
+    TEST_ASSERT_EQUAL(0, pool_find(pool, storage));
+    TEST_ASSERT_EQUAL(1, pool_find(pool, m));
+    TEST_ASSERT_EQUAL(1, classes[1].fallbacks);
+
+    pool_acquire(pool, 64);     // Last medium slot
+    pool_acquire(pool, 64);     // Large
+    TEST_ASSERT_NULL(pool_acquire(pool, 1));
+    TEST_ASSERT_EQUAL(1, pool.failures);
+}
+
+void test_release_and_high_water() {
+    char* a = pool_acquire(pool, 8);
+    char* b = pool_acquire(pool, 8);
+    char* c = pool_acquire(pool, 8);
+    TEST_ASSERT_TRUE(pool_release(pool, b));
+    TEST_ASSERT_EQUAL(2, pool_in_use(classes[0]));
+    TEST_ASSERT_EQUAL(3, classes[0].high_water);
+
+    // Freed slot is reused first
+    TEST_ASSERT_EQUAL_PTR(b, pool_acquire(pool, 8));
+    pool_release(pool, a);
+    pool_release(pool, b);
+    pool_release(pool, c);
+    TEST_ASSERT_EQUAL(0, pool_in_use(classes[0]));
+    TEST_ASSERT_EQUAL(3, classes[0].high_water);
+    TEST_ASSERT_EQUAL(4, classes[0].acquired);
+    TEST_ASSERT_EQUAL(4, classes[0].released);
+
+    pool_reset_stats(pool);
+    TEST_ASSERT_EQUAL(0, classes[0].high_water);
+    TEST_ASSERT_EQUAL(0, classes[0].acquired);
+}
+
+void test_invalid_releases_are_counted() {
+    char local[8];
+    char* a = pool_acquire(pool, 8);
+    TEST_ASSERT_TRUE(pool_release(pool, a));
+    TEST_ASSERT_FALSE(pool_release(pool, a));       // Double release
+    TEST_ASSERT_FALSE(pool_release(pool, local));   // Foreign pointer
+    TEST_ASSERT_FALSE(pool_release(pool, storage + 3));  // Inside a slot
+    TEST_ASSERT_EQUAL(3, pool.invalid_releases);
+    TEST_ASSERT_EQUAL(1, classes[0].released);
+}
+
+void test_caller_tags() {
+    static const char* const kTopic = "topic";
+    static const char* const kJson = "json";
+    for (int i = 0; i < 4; i++) pool_acquire(pool, 8, nullptr, kTopic);
+    pool_acquire(pool, 8, nullptr, kTopic);     // Falls back to medium
+    pool_acquire(pool, 200, nullptr, kJson);
+    pool_acquire(pool, 200, nullptr, kJson);    // Large is taken
+    TEST_ASSERT_EQUAL(5, pool.callers[0].acquired);
+    TEST_ASSERT_EQUAL(1, pool.callers[0].fallbacks);
+    TEST_ASSERT_EQUAL(1, pool.callers[1].acquired);
+    TEST_ASSERT_EQUAL(1, pool.callers[1].failures);
+
+    char out[256];
+    pool_format_callers_json(pool, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("{\"callers\":[{\"tag\":\"topic\",\"acq\":5,\"fb\":1,\"fail\":0},"
+                             "{\"tag\":\"json\",\"acq\":1,\"fb\":0,\"fail\":1}]}", out);
+}
+
+void test_stats_json_fits_packet_and_truncates_safely() {
+    char out[512];
+    pool_acquire(pool, 8);
+    pool_format_json(pool, out, sizeof(out));
+    TEST_ASSERT_TRUE(strlen(out) < 384);
+    TEST_ASSERT_NOT_NULL(strstr(out, "{\"size\":64,\"count\":4,\"in_use\":1,\"hw\":1,\"acq\":1,\"rel\":0,\"fb\":0}"));
+
+    char tiny[20];
+    pool_format_json(pool, tiny, sizeof(tiny));
+    TEST_ASSERT_EQUAL(sizeof(tiny) - 1, strlen(tiny));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_smallest_fitting_class);
+    RUN_TEST(test_full_class_falls_back_to_larger);
+    RUN_TEST(test_release_and_high_water);
+    RUN_TEST(test_invalid_releases_are_counted);
+    RUN_TEST(test_caller_tags);
+    RUN_TEST(test_stats_json_fits_packet_and_truncates_safely);
+    return UNITY_END();
+}
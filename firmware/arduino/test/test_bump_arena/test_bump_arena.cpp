@@ -0,0 +1,82 @@
+// Unit tests for the per-wake bump arena: alignment, exhaustion, in-place
+// growth of the last block, scoped rewind and peak tracking
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/bump_arena.h"
+
+alignas(8) static uint8_t storage[256];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_allocations_are_aligned_and_bounded() {
+    BumpArena a(storage, sizeof(storage));
+    uint8_t* p = (uint8_t*)a.allocate(3);
+    uint8_t* q = (uint8_t*)a.allocate(5);
+    TEST_ASSERT_EQUAL_PTR(storage, p);
+    TEST_ASSERT_EQUAL_PTR(storage + 8, q);
+    TEST_ASSERT_EQUAL(13, a.used());
+    TEST_ASSERT_NULL(a.allocate(250));
+    TEST_ASSERT_EQUAL(1, a.failures());
+    TEST_ASSERT_NOT_NULL(a.allocate(256 - 16));
+    TEST_ASSERT_NULL(a.allocate(1));
+}
+
+void test_last_block_frees_and_grows_in_place() {
+    BumpArena a(storage, sizeof(storage));
+    a.allocate(16);
+    char* s = (char*)a.allocate(8);
+    strcpy(s, "abc");
+    TEST_ASSERT_EQUAL_PTR(s, a.reallocate(s, 64));
+    TEST_ASSERT_EQUAL(16 + 64, a.used());
+    TEST_ASSERT_EQUAL_PTR(s, a.reallocate(s, 4));   // Shrink to fit
+    TEST_ASSERT_EQUAL(20, a.used());
+    TEST_ASSERT_EQUAL_STRING("abc", s);
+    a.deallocate(s);
+    TEST_ASSERT_EQUAL(16, a.used());
+    a.deallocate(s);                                // Already popped
+    TEST_ASSERT_EQUAL(16, a.used());
+}
+
+void test_older_block_is_copied_on_grow() {
+    BumpArena a(storage, sizeof(storage));
+    char* s = (char*)a.allocate(8);
+    strcpy(s, "hello");
+    a.allocate(8);
+    char* t = (char*)a.reallocate(s, 32);
+    TEST_ASSERT_TRUE(t != s);
+    TEST_ASSERT_EQUAL_STRING("hello", t);
+    a.deallocate(s);                                // Not the last block: no-op
+    TEST_ASSERT_EQUAL(16 + 32, a.used());
+    int local = 0;
+    TEST_ASSERT_NULL(a.reallocate(&local, 8));      // Foreign pointer
+}
+
+void test_scope_rewind_and_peak() {
+    BumpArena a(storage, sizeof(storage));
+    a.allocate(32);
+    size_t mark = a.mark();
+    a.allocate(100);
+    a.allocate(50);
+    TEST_ASSERT_EQUAL(32 + 104 + 50, a.used());
+    a.rewind(mark);
+    TEST_ASSERT_EQUAL(32, a.used());
+    TEST_ASSERT_EQUAL(186, a.peak());
+
+    a.reset();
+    TEST_ASSERT_EQUAL(0, a.used());
+    TEST_ASSERT_EQUAL(186, a.peak());               // Peak survives resets
+    TEST_ASSERT_EQUAL(1, a.resets());
+    a.resetPeak();
+    TEST_ASSERT_EQUAL(0, a.peak());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_allocations_are_aligned_and_bounded);
+    RUN_TEST(test_last_block_frees_and_grows_in_place);
+    RUN_TEST(test_older_block_is_copied_on_grow);
+    RUN_TEST(test_scope_rewind_and_peak);
+    return UNITY_END();
+}
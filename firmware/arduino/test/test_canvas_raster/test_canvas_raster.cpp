@@ -0,0 +1,164 @@
+// Unit tests for canvas span/rect rasterization
+// Each primitive is checked against a per-pixel reference on a 250x122
+// buffer (the screenshot canvas geometry), including clipping at every edge
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/canvas_raster.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static constexpr int16_t W = 250;
+static constexpr int16_t H = 122;
+static constexpr uint16_t STRIDE = (W + 7) / 8;
+
+static uint8_t g_fast[STRIDE * H];
+static uint8_t g_ref[STRIDE * H];
+static const RasterTarget FAST = {g_fast, W, H, STRIDE};
+static const RasterTarget REF = {g_ref, W, H, STRIDE};
+
+static void reset(uint8_t fill) {
+    memset(g_fast, fill, sizeof(g_fast));
+    memset(g_ref, fill, sizeof(g_ref));
+}
+
+static void assert_same() {
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(g_ref, g_fast, sizeof(g_fast));
+}
+
+void test_hspan_matches_pixels() {
+    const int16_t cases[][2] = {{0, 1}, {3, 2}, {5, 11}, {8, 8}, {7, 250},
+                                {-5, 20}, {240, 30}, {-10, 5}, {249, 1}};
+    for (int s = 0; s < 2; ++s) {
+        bool set = s == 0;
+        for (const auto& c : cases) {
+            reset(set ? 0x00 : 0xFF);
+            raster_hspan(FAST, c[0], 18, c[1], set);
+            for (int16_t i = 0; i < c[1]; ++i) raster_pixel(REF, c[0] + i, 18, set);
+            assert_same();
+        }
+    }
+}
+
+void test_vspan_matches_pixels() {
+    reset(0);
+    raster_vspan(FAST, 125, -4, 200, true);
+    for (int16_t y = -4; y < 196; ++y) raster_pixel(REF, 125, y, true);
+    raster_vspan(FAST, 0, 10, 5, true);
+    for (int16_t y = 10; y < 15; ++y) raster_pixel(REF, 0, y, true);
+    raster_vspan(FAST, 250, 0, 10, true);   // Off the right edge: no-op
+    assert_same();
+}
+
+void test_fill_rect_matches_pixels() {
+    reset(0);
+    raster_fill_rect(FAST, 13, 20, 37, 9, true);
+    raster_fill_rect(FAST, 200, 100, 80, 40, true);
+    raster_fill_rect(FAST, 15, 22, 3, 3, false);
+    for (int16_t y = 20; y < 29; ++y)
+        for (int16_t x = 13; x < 50; ++x) raster_pixel(REF, x, y, true);
+    for (int16_t y = 100; y < 140; ++y)
+        for (int16_t x = 200; x < 280; ++x) raster_pixel(REF, x, y, true);
+    for (int16_t y = 22; y < 25; ++y)
+        for (int16_t x = 15; x < 18; ++x) raster_pixel(REF, x, y, false);
+    assert_same();
+}
+
+void test_clipping_keeps_row_padding_clear() {
+    reset(0);
+    raster_hspan(FAST, 0, 0, 400, true);
+    raster_fill_rect(FAST, 240, 5, 50, 5, true);
+    for (int16_t y = 0; y < 10; ++y) {
+        // Bits for x = 250..255 in the last byte of each row stay clear
+        TEST_ASSERT_EQUAL_HEX8(0, g_fast[y * STRIDE + STRIDE - 1] & 0x3F);
+    }
+}
+
+// 10x3 XBM (2 bytes per row, LSB first)
+static const uint8_t kXbm[] = {
+    0x01, 0x02,   // x=0, x=9
+    0xFF, 0x03,   // x=0..9
+    0xA5, 0x01,   // x=0,2,5,7,8
+};
+
+static void ref_xbm(int16_t x, int16_t y) {
+    for (int16_t r = 0; r < 3; ++r)
+        for (int16_t c = 0; c < 10; ++c)
+            if (kXbm[r * 2 + c / 8] & (1 << (c & 7))) raster_pixel(REF, x + c, y + r, true);
+}
+
+void test_xbm_matches_pixels_at_any_offset() {
+    const int16_t xs[] = {0, 1, 3, 7, 8, 100, 245, -3, -9};
+    for (int16_t x : xs) {
+        reset(0);
+        raster_xbm(FAST, x, 50, kXbm, 10, 3, true);
+        ref_xbm(x, 50);
+        assert_same();
+    }
+    reset(0);
+    raster_xbm(FAST, 20, -1, kXbm, 10, 3, true);
+    raster_xbm(FAST, 20, 120, kXbm, 10, 3, true);
+    ref_xbm(20, -1);
+    ref_xbm(20, 120);
+    assert_same();
+}
+
+void test_xbm_leaves_background_untouched() {
+    reset(0xFF);
+    uint8_t blank[6] = {0};
+    raster_xbm(FAST, 4, 4, blank, 10, 3, true);
+    assert_same();
+}
+
+void test_bitmap_msb_first_matches_pixels() {
+    // 10x2, MSB first: x=0,9 then x=1..8
+    static const uint8_t bmp[] = {0x80, 0x40, 0x7F, 0x80};
+    const int16_t xs[] = {0, 5, 244, -2};
+    for (int16_t x : xs) {
+        reset(0);
+        raster_bitmap(FAST, x, 7, bmp, 10, 2, true);
+        for (int16_t r = 0; r < 2; ++r)
+            for (int16_t c = 0; c < 10; ++c)
+                if (bmp[r * 2 + c / 8] & (0x80 >> (c & 7))) raster_pixel(REF, x + c, 7 + r, true);
+        assert_same();
+    }
+}
+
+// 24x3 icon-atlas rows, MSB first
+static const uint8_t kIcon[] = {
+    0x80, 0x00, 0x01,   // x=0, x=23
+    0xFF, 0xFF, 0xFF,   // x=0..23
+    0x5A, 0x3C, 0xC3,
+};
+
+void test_bitmap_24_wide_matches_pixels_at_every_offset() {
+    for (int16_t x = -24; x <= W; ++x) {
+        reset(0);
+        raster_bitmap(FAST, x, 60, kIcon, 24, 3, true);
+        for (int16_t r = 0; r < 3; ++r)
+            for (int16_t c = 0; c < 24; ++c)
+                if (kIcon[r * 3 + c / 8] & (0x80 >> (c & 7))) raster_pixel(REF, x + c, 60 + r, true);
+        assert_same();
+    }
+    // Clear (white-on-black) keeps the surrounding bits
+    reset(0xFF);
+    raster_bitmap(FAST, 13, 0, kIcon, 24, 3, false);
+    for (int16_t r = 0; r < 3; ++r)
+        for (int16_t c = 0; c < 24; ++c)
+            if (kIcon[r * 3 + c / 8] & (0x80 >> (c & 7))) raster_pixel(REF, 13 + c, r, false);
+    assert_same();
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hspan_matches_pixels);
+    RUN_TEST(test_vspan_matches_pixels);
+    RUN_TEST(test_fill_rect_matches_pixels);
+    RUN_TEST(test_clipping_keeps_row_padding_clear);
+    RUN_TEST(test_xbm_matches_pixels_at_any_offset);
+    RUN_TEST(test_xbm_leaves_background_untouched);
+    RUN_TEST(test_bitmap_msb_first_matches_pixels);
+    RUN_TEST(test_bitmap_24_wide_matches_pixels_at_every_offset);
+    return UNITY_END();
+}
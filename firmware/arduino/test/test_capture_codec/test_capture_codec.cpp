@@ -0,0 +1,91 @@
+// Unit tests for screenshot PackBits/delta coding
+// Frames use the screenshot canvas size (3904 bytes)
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/capture_codec.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static constexpr size_t FRAME = 32 * 122;
+
+static std::vector<uint8_t> encode(const uint8_t* frame, const uint8_t* base, size_t len) {
+    std::vector<uint8_t> out;
+    auto src = [&](size_t i) { return (uint8_t)(frame[i] ^ (base ? base[i] : 0)); };
+    size_t n = packbits_encode(src, len, [&](uint8_t b) { out.push_back(b); });
+    TEST_ASSERT_EQUAL(out.size(), n);
+    return out;
+}
+
+static void assert_roundtrip(const uint8_t* frame, size_t len) {
+    std::vector<uint8_t> enc = encode(frame, nullptr, len);
+    std::vector<uint8_t> dec(len);
+    TEST_ASSERT_TRUE(packbits_decode(enc.data(), enc.size(), dec.data(), len));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, dec.data(), len);
+}
+
+void test_blank_frame_compresses_to_run_packets() {
+    static uint8_t frame[FRAME];
+    memset(frame, 0, sizeof(frame));
+    std::vector<uint8_t> enc = encode(frame, nullptr, FRAME);
+    // 3904 / 128 = 30.5 -> 31 repeat packets of 2 bytes
+    TEST_ASSERT_EQUAL(62, enc.size());
+    assert_roundtrip(frame, FRAME);
+}
+
+void test_literals_runs_and_boundaries_roundtrip() {
+    static const uint8_t a[] = {1};
+    static const uint8_t b[] = {1, 2};
+    static const uint8_t c[] = {7, 7};
+    static const uint8_t d[] = {7, 7, 7};
+    static const uint8_t e[] = {1, 2, 3, 3, 3, 4, 5, 5, 6};
+    assert_roundtrip(a, sizeof(a));
+    assert_roundtrip(b, sizeof(b));
+    assert_roundtrip(c, sizeof(c));
+    assert_roundtrip(d, sizeof(d));
+    assert_roundtrip(e, sizeof(e));
+
+    // 300 distinct-ish bytes force several full literal packets
+    static uint8_t lit[300];
+    for (size_t i = 0; i < sizeof(lit); ++i) lit[i] = (uint8_t)(i * 37 + 11);
+    assert_roundtrip(lit, sizeof(lit));
+    std::vector<uint8_t> enc = encode(lit, nullptr, sizeof(lit));
+    TEST_ASSERT_EQUAL(300 + 3, enc.size());
+}
+
+void test_delta_of_small_change_is_tiny() {
+    static uint8_t base[FRAME], frame[FRAME];
+    for (size_t i = 0; i < FRAME; ++i) base[i] = (uint8_t)((i % 32) < 4 ? 0xFF : 0x00);
+    memcpy(frame, base, FRAME);
+    frame[1000] ^= 0x3C;   // One changed digit stroke
+    frame[1032] ^= 0x3C;
+
+    std::vector<uint8_t> enc = encode(frame, base, FRAME);
+    TEST_ASSERT_TRUE(enc.size() < 80);
+
+    std::vector<uint8_t> dec(FRAME);
+    TEST_ASSERT_TRUE(packbits_decode(enc.data(), enc.size(), dec.data(), FRAME));
+    for (size_t i = 0; i < FRAME; ++i) dec[i] ^= base[i];
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, dec.data(), FRAME);
+}
+
+void test_decode_rejects_truncated_or_overlong() {
+    uint8_t out[4];
+    const uint8_t trunc[] = {0x03, 1, 2};          // Literal of 4, only 2 bytes
+    const uint8_t too_long[] = {0xFB, 9};          // Run of 6 into 4 bytes
+    const uint8_t short_run[] = {0xFF, 9};         // Run of 2, 4 expected
+    TEST_ASSERT_FALSE(packbits_decode(trunc, sizeof(trunc), out, sizeof(out)));
+    TEST_ASSERT_FALSE(packbits_decode(too_long, sizeof(too_long), out, sizeof(out)));
+    TEST_ASSERT_FALSE(packbits_decode(short_run, sizeof(short_run), out, sizeof(out)));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_blank_frame_compresses_to_run_packets);
+    RUN_TEST(test_literals_runs_and_boundaries_roundtrip);
+    RUN_TEST(test_delta_of_small_change_is_tiny);
+    RUN_TEST(test_decode_rejects_truncated_or_overlong);
+    return UNITY_END();
+}
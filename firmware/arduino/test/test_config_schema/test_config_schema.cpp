@@ -0,0 +1,80 @@
+// Unit tests for the config schema helpers: key hash, range and length
+// checks, hash table consistency and lookup
+
+#include <unity.h>
+#include "../../src/config_schema.h"
+
+static constexpr ConfigRange ranges[] = {
+    {"wake_interval", 0xB358EFE3u, 7200, 60, 86400, 3600, CONFIG_STRICT},
+    {"active_seconds", 0x8FC196CDu, 400, 5, 300, 10, CONFIG_ADVISORY},
+};
+static constexpr ConfigString strings[] = {
+    {"wifi.ssid", 0xF34CF2BDu, "", sizeof("") - 1, 1, 32},
+    {"mqtt.host", 0x826FE8F9u, "broker", sizeof("broker") - 1, 1, 63},
+};
+
+// The generated header relies on these being usable in static_assert
+static_assert(config_key_hash("wake_interval") == 0xB358EFE3u, "hash differs from generator");
+static_assert(config_hashes_match(ranges, 2) && config_hashes_match(strings, 2), "hash mismatch");
+static_assert(config_hashes_unique(ranges, 2), "hash collision");
+static_assert(config_range_ok(ranges[0]) && !config_range_ok(ranges[1]), "range check");
+static_assert(config_string_fits(strings[0]) && !config_string_ok(strings[0]), "length check");
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_key_hash_is_fnv1a() {
+    TEST_ASSERT_EQUAL_HEX32(0x811C9DC5u, config_key_hash(""));
+    TEST_ASSERT_EQUAL_HEX32(0xE40C292Cu, config_key_hash("a"));
+    TEST_ASSERT_EQUAL_HEX32(0xF34CF2BDu, config_key_hash("wifi.ssid"));
+}
+
+void test_range_bounds_are_inclusive() {
+    ConfigRange r = {"x", 0, 60, 60, 100, 80, CONFIG_STRICT};
+    TEST_ASSERT_TRUE(config_range_ok(r));
+    r.value = 100;
+    TEST_ASSERT_TRUE(config_range_ok(r));
+    r.value = 59.5f;
+    TEST_ASSERT_FALSE(config_range_ok(r));
+    r.value = 100.5f;
+    TEST_ASSERT_FALSE(config_range_ok(r));
+}
+
+void test_string_lengths() {
+    ConfigString s = {"x", 0, "abcd", 4, 1, 4};
+    TEST_ASSERT_TRUE(config_string_ok(s));
+    s.length = 5;
+    TEST_ASSERT_FALSE(config_string_fits(s));
+    TEST_ASSERT_FALSE(config_string_ok(s));
+    s.length = 0;
+    TEST_ASSERT_TRUE(config_string_fits(s));
+    TEST_ASSERT_FALSE(config_string_ok(s));
+}
+
+void test_duplicate_hashes_detected() {
+    static constexpr ConfigRange dup[] = {
+        {"a", 1, 0, 0, 1, 0, CONFIG_STRICT},
+        {"b", 2, 0, 0, 1, 0, CONFIG_STRICT},
+        {"c", 1, 0, 0, 1, 0, CONFIG_STRICT},
+    };
+    TEST_ASSERT_FALSE(config_hashes_unique(dup, 3));
+    TEST_ASSERT_TRUE(config_hashes_unique(dup, 2));
+    TEST_ASSERT_FALSE(config_hashes_match(dup, 3));
+}
+
+void test_find_by_hash() {
+    const ConfigString* s = config_find(strings, 2, config_key_hash("mqtt.host"));
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_EQUAL_STRING("broker", s->value);
+    TEST_ASSERT_NULL(config_find(strings, 2, config_key_hash("mqtt.port")));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_key_hash_is_fnv1a);
+    RUN_TEST(test_range_bounds_are_inclusive);
+    RUN_TEST(test_string_lengths);
+    RUN_TEST(test_duplicate_hashes_detected);
+    RUN_TEST(test_find_by_hash);
+    return UNITY_END();
+}
@@ -0,0 +1,48 @@
+// Unit tests for the per-phase CPU frequency policy
+// Tests phase defaults, rounding to supported clocks and the WiFi floor
+
+#include <unity.h>
+#include "../../src/cpu_freq_policy.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_defaults_split_io_and_compute() {
+    CpuFreqPolicy p = default_cpu_freq_policy();
+    TEST_ASSERT_EQUAL_UINT16(CPU_FREQ_IO_MHZ, cpu_freq_for_phase(p, CpuPhase::CONNECT, true));
+    TEST_ASSERT_EQUAL_UINT16(CPU_FREQ_IO_MHZ, cpu_freq_for_phase(p, CpuPhase::PUBLISH, true));
+    TEST_ASSERT_EQUAL_UINT16(CPU_FREQ_IO_MHZ, cpu_freq_for_phase(p, CpuPhase::WAIT, false));
+    TEST_ASSERT_EQUAL_UINT16(CPU_FREQ_COMPUTE_MHZ, cpu_freq_for_phase(p, CpuPhase::RENDER, true));
+}
+
+void test_rounds_up_to_supported_clock() {
+    TEST_ASSERT_EQUAL_UINT16(240, cpu_freq_supported(200));
+    TEST_ASSERT_EQUAL_UINT16(160, cpu_freq_supported(160));
+    TEST_ASSERT_EQUAL_UINT16(160, cpu_freq_supported(100));
+    TEST_ASSERT_EQUAL_UINT16(80, cpu_freq_supported(80));
+    TEST_ASSERT_EQUAL_UINT16(40, cpu_freq_supported(30));
+    TEST_ASSERT_EQUAL_UINT16(10, cpu_freq_supported(0));
+    TEST_ASSERT_EQUAL_UINT16(240, cpu_freq_supported(1000));
+}
+
+void test_radio_keeps_80_mhz_floor() {
+    CpuFreqPolicy p = default_cpu_freq_policy();
+    p.mhz[(uint8_t)CpuPhase::WAIT] = 20;
+    TEST_ASSERT_EQUAL_UINT16(20, cpu_freq_for_phase(p, CpuPhase::WAIT, false));
+    TEST_ASSERT_EQUAL_UINT16(80, cpu_freq_for_phase(p, CpuPhase::WAIT, true));
+}
+
+void test_unknown_phase_runs_at_compute_clock() {
+    CpuFreqPolicy p = default_cpu_freq_policy();
+    TEST_ASSERT_EQUAL_UINT16(CPU_FREQ_COMPUTE_MHZ, cpu_freq_for_phase(p, CpuPhase::COUNT, false));
+    TEST_ASSERT_EQUAL_STRING("render", cpu_phase_name(CpuPhase::RENDER));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_defaults_split_io_and_compute);
+    RUN_TEST(test_rounds_up_to_supported_clock);
+    RUN_TEST(test_radio_keeps_80_mhz_floor);
+    RUN_TEST(test_unknown_phase_runs_at_compute_clock);
+    return UNITY_END();
+}
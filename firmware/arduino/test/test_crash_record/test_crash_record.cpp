@@ -0,0 +1,68 @@
+// Unit tests for crash record helpers: compile-time breadcrumb ids, the
+// breadcrumb ring and the compact hex lists published after a crash
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/crash_record.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_site_id_is_compile_time_fnv() {
+    // FNV-1a reference values
+    static_assert(crash_fnv1a("") == 2166136261u, "FNV offset basis");
+    static_assert(crash_fnv1a("a") == 0xe40c292cu, "FNV-1a of \"a\"");
+    constexpr uint16_t id = CRASH_SITE_ID("run_network_phase");
+    TEST_ASSERT_EQUAL_UINT32(crash_site_id("run_network_phase"), id);
+    TEST_ASSERT_EQUAL_UINT32(0xe40cu ^ 0x292cu, crash_site_id("a"));
+    TEST_ASSERT_TRUE(crash_site_id("run_sensor_phase") != crash_site_id("run_sleep_phase"));
+    TEST_ASSERT_TRUE(crash_fold16(0x12341234u) != 0);
+}
+
+void test_ring_copies_oldest_first() {
+    CrashBreadcrumbs r;
+    memset(&r, 0, sizeof(r));
+    uint16_t out[CRASH_BREADCRUMB_SLOTS];
+    TEST_ASSERT_EQUAL_UINT32(0, crash_breadcrumb_copy(r, out));
+    crash_breadcrumb_push(r, 7);
+    crash_breadcrumb_push(r, 8);
+    TEST_ASSERT_EQUAL_UINT32(2, crash_breadcrumb_copy(r, out));
+    TEST_ASSERT_EQUAL_UINT32(7, out[0]);
+    TEST_ASSERT_EQUAL_UINT32(8, out[1]);
+
+    for (uint16_t i = 0; i < CRASH_BREADCRUMB_SLOTS + 3; i++) crash_breadcrumb_push(r, 100 + i);
+    TEST_ASSERT_EQUAL_UINT32(CRASH_BREADCRUMB_SLOTS, crash_breadcrumb_copy(r, out));
+    TEST_ASSERT_EQUAL_UINT32(103, out[0]);
+    TEST_ASSERT_EQUAL_UINT32(100 + CRASH_BREADCRUMB_SLOTS + 2, out[CRASH_BREADCRUMB_SLOTS - 1]);
+}
+
+void test_hex_list_format() {
+    const uint32_t pcs[] = { 0x400d1234u, 0x4008a1b2u, 0x3fu };
+    char out[64];
+    size_t n = crash_format_hex_list(out, sizeof(out), pcs, 3, 8);
+    TEST_ASSERT_EQUAL_STRING("400d1234,4008a1b2,0000003f", out);
+    TEST_ASSERT_EQUAL_UINT32(strlen(out), n);
+
+    const uint16_t ids[] = { 0x91c0, 0x3f2a };
+    crash_format_hex_list(out, sizeof(out), ids, 2, 4);
+    TEST_ASSERT_EQUAL_STRING("91c0,3f2a", out);
+
+    crash_format_hex_list(out, sizeof(out), ids, 0, 4);
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+void test_hex_list_stops_before_overflow() {
+    const uint32_t pcs[] = { 0x400d1234u, 0x4008a1b2u };
+    char out[17];   // The second entry needs 9 more chars plus the NUL
+    crash_format_hex_list(out, sizeof(out), pcs, 2, 8);
+    TEST_ASSERT_EQUAL_STRING("400d1234", out);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_site_id_is_compile_time_fnv);
+    RUN_TEST(test_ring_copies_oldest_first);
+    RUN_TEST(test_hex_list_format);
+    RUN_TEST(test_hex_list_stops_before_overflow);
+    return UNITY_END();
+}
@@ -0,0 +1,55 @@
+// Unit tests for the software CRC-32 variants: check value, agreement
+// between bitwise and slicing-by-4, unaligned input and streaming
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/crc32.h"
+
+static uint8_t frame[3904 + 8];
+
+void setUp(void) {
+    uint32_t x = 12345;
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        x = x * 1103515245u + 12345u;
+        frame[i] = (uint8_t)(x >> 16);
+    }
+}
+void tearDown(void) {}
+
+void test_check_value() {
+    const uint8_t* s = (const uint8_t*)"123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, crc32_bitwise_update(0, s, 9));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, crc32_table_update(0, s, 9));
+    TEST_ASSERT_EQUAL_HEX32(0, crc32_table_update(0, s, 0));
+}
+
+void test_table_matches_bitwise_any_alignment() {
+    for (size_t offset = 0; offset < 4; offset++) {
+        for (size_t len = 0; len < 64; len++) {
+            TEST_ASSERT_EQUAL_HEX32(crc32_bitwise_update(0, frame + offset, len),
+                                    crc32_table_update(0, frame + offset, len));
+        }
+    }
+    TEST_ASSERT_EQUAL_HEX32(crc32_bitwise_update(0, frame, 3904),
+                            crc32_table_update(0, frame, 3904));
+}
+
+void test_streaming_equals_single_pass() {
+    uint32_t whole = crc32_table_update(0, frame, 3904);
+    uint32_t crc = 0;
+    for (size_t pos = 0; pos < 3904; pos += 61) {
+        size_t n = 3904 - pos < 61 ? 3904 - pos : 61;
+        crc = crc32_table_update(crc, frame + pos, n);
+    }
+    TEST_ASSERT_EQUAL_HEX32(whole, crc);
+    TEST_ASSERT_EQUAL_HEX32(whole, crc32_bitwise_update(crc32_bitwise_update(0, frame, 100),
+                                                        frame + 100, 3804));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_check_value);
+    RUN_TEST(test_table_matches_bitwise_any_alignment);
+    RUN_TEST(test_streaming_equals_single_pass);
+    return UNITY_END();
+}
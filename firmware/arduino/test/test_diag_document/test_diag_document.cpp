@@ -0,0 +1,75 @@
+// Unit tests for the retained diagnostics document (format, change and heartbeat gating)
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/diag_document.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const DiagDocument kDoc = {"deepsleep", 2, 3, "0x1234ABCD", "1.4.0"};
+
+void test_format_is_one_json_document() {
+    char buf[192];
+    size_t n = diag_document_format(kDoc, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"reset_reason\":\"deepsleep\",\"crash_count\":2,\"layout_version\":3,"
+        "\"layout_crc\":\"0x1234ABCD\",\"fw\":\"1.4.0\"}", buf);
+    TEST_ASSERT_EQUAL_UINT32(strlen(buf), n);
+}
+
+void test_format_refuses_truncation() {
+    char buf[24];
+    TEST_ASSERT_EQUAL_UINT32(0, diag_document_format(kDoc, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+}
+
+void test_first_wake_publishes() {
+    DiagDocState s = {0, 0};
+    TEST_ASSERT_EQUAL(DiagDocDecision::FIRST, diag_document_decide(s, 0xAAAA, 24));
+}
+
+void test_unchanged_document_is_skipped_until_heartbeat() {
+    DiagDocState s = {0, 0};
+    diag_document_note_wake(s, DiagDocDecision::FIRST, 0xAAAA, true);
+    for (uint32_t i = 0; i < 23; i++) {
+        DiagDocDecision d = diag_document_decide(s, 0xAAAA, 24);
+        TEST_ASSERT_EQUAL(DiagDocDecision::SKIP, d);
+        diag_document_note_wake(s, d, 0xAAAA, true);
+    }
+    DiagDocDecision d = diag_document_decide(s, 0xAAAA, 24);
+    TEST_ASSERT_EQUAL(DiagDocDecision::HEARTBEAT, d);
+    diag_document_note_wake(s, d, 0xAAAA, true);
+    TEST_ASSERT_EQUAL_UINT32(0, s.wakes_since);
+}
+
+void test_changed_field_publishes_at_once() {
+    DiagDocState s = {0xAAAA, 3};
+    TEST_ASSERT_EQUAL(DiagDocDecision::CHANGED, diag_document_decide(s, 0xBBBB, 24));
+}
+
+void test_failed_delivery_retries_next_wake() {
+    DiagDocState s = {0xAAAA, 0};
+    diag_document_note_wake(s, DiagDocDecision::CHANGED, 0xBBBB, false);
+    TEST_ASSERT_EQUAL_UINT32(0xAAAA, s.last_crc);
+    TEST_ASSERT_EQUAL(DiagDocDecision::CHANGED, diag_document_decide(s, 0xBBBB, 24));
+}
+
+void test_zero_crc_still_counts_as_delivered() {
+    DiagDocState s = {0, 0};
+    diag_document_note_wake(s, DiagDocDecision::FIRST, 0, true);
+    TEST_ASSERT_EQUAL_UINT32(1, s.last_crc);
+    TEST_ASSERT_EQUAL(DiagDocDecision::SKIP, diag_document_decide(s, 0, 24));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_format_is_one_json_document);
+    RUN_TEST(test_format_refuses_truncation);
+    RUN_TEST(test_first_wake_publishes);
+    RUN_TEST(test_unchanged_document_is_skipped_until_heartbeat);
+    RUN_TEST(test_changed_field_publishes_at_once);
+    RUN_TEST(test_failed_delivery_retries_next_wake);
+    RUN_TEST(test_zero_crc_still_counts_as_delivered);
+    return UNITY_END();
+}
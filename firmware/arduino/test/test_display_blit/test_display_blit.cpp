@@ -0,0 +1,118 @@
+// Unit tests for the canvas -> native panel blit
+// Checked against a per-pixel reference of GxEPD2's rotation 3 mapping
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/display_blit.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint8_t g_canvas[BLIT_CANVAS_STRIDE * BLIT_CANVAS_HEIGHT];
+static uint8_t g_native[PANEL_NATIVE_BUFFER_SIZE];
+
+static void canvas_set(uint16_t x, uint16_t y) {
+    g_canvas[y * BLIT_CANVAS_STRIDE + x / 8] |= (uint8_t)(0x80 >> (x % 8));
+}
+
+static bool canvas_black(uint16_t x, uint16_t y) {
+    return g_canvas[y * BLIT_CANVAS_STRIDE + x / 8] & (0x80 >> (x % 8));
+}
+
+// 1 = white in the native buffer
+static bool native_white(uint16_t nx, uint16_t ny) {
+    return g_native[ny * PANEL_NATIVE_STRIDE + nx / 8] & (0x80 >> (nx % 8));
+}
+
+static void assert_matches_reference() {
+    blit_canvas_rot3_to_native(g_canvas, g_native);
+    for (uint16_t ny = 0; ny < PANEL_NATIVE_HEIGHT; ny++) {
+        for (uint16_t nx = 0; nx < PANEL_NATIVE_WIDTH; nx++) {
+            // GxEPD2 rotation 3: native (x, y) = (ly, HEIGHT - 1 - lx)
+            uint16_t lx = PANEL_NATIVE_HEIGHT - 1 - ny;
+            uint16_t ly = nx;
+            bool white = ly >= BLIT_CANVAS_HEIGHT || !canvas_black(lx, ly);
+            if (native_white(nx, ny) != white) {
+                TEST_ASSERT_EQUAL(white, native_white(nx, ny));
+                return;
+            }
+        }
+    }
+}
+
+void test_transpose8_identity_diagonal() {
+    uint8_t in[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+    uint8_t out[8];
+    blit_transpose8(in, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, out, 8);
+}
+
+void test_transpose8_row_becomes_column() {
+    uint8_t in[8] = {0xFF, 0, 0, 0, 0, 0, 0, 0};
+    uint8_t out[8];
+    blit_transpose8(in, out);
+    for (int c = 0; c < 8; c++) TEST_ASSERT_EQUAL_HEX8(0x80, out[c]);
+}
+
+void test_blank_canvas_is_all_white() {
+    memset(g_canvas, 0, sizeof(g_canvas));
+    blit_canvas_rot3_to_native(g_canvas, g_native);
+    for (size_t i = 0; i < sizeof(g_native); i++) TEST_ASSERT_EQUAL_HEX8(0xFF, g_native[i]);
+}
+
+void test_corners_and_pattern_match_reference() {
+    memset(g_canvas, 0, sizeof(g_canvas));
+    canvas_set(0, 0);
+    canvas_set(249, 0);
+    canvas_set(0, 121);
+    canvas_set(249, 121);
+    // Border and a diagonal, like the UI chrome plus text strokes
+    for (uint16_t x = 0; x < BLIT_CANVAS_WIDTH; x++) {
+        canvas_set(x, 18);
+        canvas_set(x, (x * 7) % BLIT_CANVAS_HEIGHT);
+    }
+    for (uint16_t y = 0; y < BLIT_CANVAS_HEIGHT; y++) canvas_set(125, y);
+    assert_matches_reference();
+}
+
+void test_pseudorandom_canvas_matches_reference() {
+    uint32_t s = 0x12345678u;
+    for (size_t i = 0; i < sizeof(g_canvas); i++) {
+        s = s * 1103515245u + 12345u;
+        g_canvas[i] = (uint8_t)(s >> 16);
+    }
+    assert_matches_reference();
+}
+
+void test_window_maps_to_native_and_clips() {
+    // Header strip: landscape (0,0) 250x18 -> native columns 0..17, all rows
+    PanelWindow nw = blit_window_rot3_to_native(PanelWindow{0, 0, 250, 18});
+    TEST_ASSERT_EQUAL_INT16(0, nw.x);
+    TEST_ASSERT_EQUAL_INT16(0, nw.y);
+    TEST_ASSERT_EQUAL_INT16(18, nw.w);
+    TEST_ASSERT_EQUAL_INT16(250, nw.h);
+
+    // Byte-aligned window running past the right edge is clipped
+    nw = blit_window_rot3_to_native(PanelWindow{240, 20, 16, 30});
+    TEST_ASSERT_EQUAL_INT16(20, nw.x);
+    TEST_ASSERT_EQUAL_INT16(0, nw.y);
+    TEST_ASSERT_EQUAL_INT16(30, nw.w);
+    TEST_ASSERT_EQUAL_INT16(10, nw.h);
+
+    nw = blit_window_rot3_to_native(PanelWindow{8, 120, 16, 10});
+    TEST_ASSERT_EQUAL_INT16(120, nw.x);
+    TEST_ASSERT_EQUAL_INT16(226, nw.y);
+    TEST_ASSERT_EQUAL_INT16(2, nw.w);
+    TEST_ASSERT_EQUAL_INT16(16, nw.h);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_transpose8_identity_diagonal);
+    RUN_TEST(test_transpose8_row_becomes_column);
+    RUN_TEST(test_blank_canvas_is_all_white);
+    RUN_TEST(test_corners_and_pattern_match_reference);
+    RUN_TEST(test_pseudorandom_canvas_matches_reference);
+    RUN_TEST(test_window_maps_to_native_and_clips);
+    return UNITY_END();
+}
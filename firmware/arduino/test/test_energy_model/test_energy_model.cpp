@@ -0,0 +1,112 @@
+// Unit tests for the per-wake charge model and the cross-wake average
+
+#include <unity.h>
+#include "../../src/energy_model.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static EnergyCurrents bench_currents() {
+    EnergyCurrents c = {{30.0f, 40.0f, 150.0f, 4.0f, 0.1f}, 0.1f};
+    return c;
+}
+
+void test_uah_conversion() {
+    // 1 mA for one hour is 1000 uAh
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f, energy_uah(3600000000ULL, 1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, energy_uah(0, 150.0f));
+}
+
+void test_radio_split_clamps_share() {
+    EnergyPhaseUs t = {};
+    energy_split_radio(t, 1000000, 0.25f);
+    TEST_ASSERT_EQUAL(250000u, t.us[ENERGY_RADIO_TX]);
+    TEST_ASSERT_EQUAL(750000u, t.us[ENERGY_RADIO_RX]);
+    energy_split_radio(t, 1000000, 2.0f);
+    TEST_ASSERT_EQUAL(1000000u, t.us[ENERGY_RADIO_TX]);
+    TEST_ASSERT_EQUAL(0u, t.us[ENERGY_RADIO_RX]);
+    energy_split_radio(t, 1000000, -1.0f);
+    TEST_ASSERT_EQUAL(0u, t.us[ENERGY_RADIO_TX]);
+}
+
+void test_wake_charge_sums_phases() {
+    EnergyCurrents c = bench_currents();
+    EnergyPhaseUs t = {};
+    t.us[ENERGY_CPU] = 3000000;                 // 3 s awake
+    energy_split_radio(t, 2000000, c.tx_share);  // 2 s radio
+    t.us[ENERGY_PANEL] = 1500000;
+    t.us[ENERGY_SLEEP] = 300000000ULL;          // 5 min
+    EnergyWakeCharge w = energy_wake_charge(t, c);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, w.uah[ENERGY_CPU]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, w.uah[ENERGY_RADIO_RX]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 8.33f, w.uah[ENERGY_RADIO_TX]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.67f, w.uah[ENERGY_PANEL]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 8.33f, w.uah[ENERGY_SLEEP]);
+    float sum = 0.0f;
+    for (size_t p = 0; p < ENERGY_PHASE_COUNT; p++) sum += w.uah[p];
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, sum, w.total_uah);
+}
+
+void test_history_average_and_decay() {
+    EnergyHistory h;
+    memset(&h, 0xA5, sizeof(h));
+    energy_history_validate(h);
+    TEST_ASSERT_EQUAL(ENERGY_HISTORY_MAGIC, h.magic);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, energy_history_avg_ma(h));
+
+    // 100 uAh every 360 s is 1 mA
+    for (int i = 0; i < 10; i++) energy_history_add(h, 100.0f, 360);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, energy_model_avg_ma(h));
+
+    // Past the window the sums halve, keeping the ratio and staying bounded
+    for (int i = 0; i < 1000; i++) energy_history_add(h, 100.0f, 360);
+    TEST_ASSERT_TRUE(h.sum_sec <= ENERGY_HISTORY_WINDOW_SEC);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, energy_model_avg_ma(h));
+
+    // Heavier wakes pull the average up
+    for (int i = 0; i < 240; i++) energy_history_add(h, 300.0f, 360);
+    TEST_ASSERT_TRUE(energy_model_avg_ma(h) > 2.0f);
+}
+
+void test_gauge_overrides_model_after_long_drop() {
+    EnergyHistory h;
+    energy_history_reset(h);
+    energy_history_add(h, 100.0f, 360);          // Model says 1 mA
+
+    // 80% -> 79% over 2 h: too coarse to trust yet
+    energy_gauge_update(h, 80, 0, 3000.0f);
+    energy_gauge_update(h, 79, 7200, 3000.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, h.gauge_ma);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, energy_history_avg_ma(h));
+
+    // 80% -> 77% over 10 h: 90 mAh / 10 h = 9 mA
+    energy_gauge_update(h, 77, 28800, 3000.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 9.0f, h.gauge_ma);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 9.0f, energy_history_avg_ma(h));
+    TEST_ASSERT_EQUAL(77, h.anchor_pct);
+    TEST_ASSERT_EQUAL(0u, h.anchor_sec);
+}
+
+void test_gauge_restarts_on_charge_or_missing() {
+    EnergyHistory h;
+    energy_history_reset(h);
+    energy_gauge_update(h, 60, 0, 3000.0f);
+    energy_gauge_update(h, 59, 7200, 3000.0f);
+    energy_gauge_update(h, 70, 300, 3000.0f);    // Charging
+    TEST_ASSERT_EQUAL(70, h.anchor_pct);
+    TEST_ASSERT_EQUAL(0u, h.anchor_sec);
+    energy_gauge_update(h, -1, 300, 3000.0f);    // No gauge
+    TEST_ASSERT_EQUAL(-1, h.anchor_pct);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_uah_conversion);
+    RUN_TEST(test_radio_split_clamps_share);
+    RUN_TEST(test_wake_charge_sums_phases);
+    RUN_TEST(test_history_average_and_decay);
+    RUN_TEST(test_gauge_overrides_model_after_long_drop);
+    RUN_TEST(test_gauge_restarts_on_charge_or_missing);
+    return UNITY_END();
+}
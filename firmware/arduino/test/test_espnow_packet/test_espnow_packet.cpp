@@ -0,0 +1,75 @@
+#include <unity.h>
+#include "../../src/espnow_packet.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t kMacA[6] = {0x7c, 0xdf, 0xa1, 0x00, 0x00, 0x01};
+static const uint8_t kMacB[6] = {0x7c, 0xdf, 0xa1, 0x00, 0x00, 0x02};
+static const uint8_t kMacC[6] = {0x7c, 0xdf, 0xa1, 0x00, 0x00, 0x03};
+
+void test_encode_decode_round_trip(void) {
+    const uint8_t payload[] = {0x01, 0x22, 0x33};
+    uint8_t pkt[ESPNOW_PACKET_MAX];
+    size_t n = espnow_packet_encode(ESPNOW_KIND_TELEMETRY, 0xBEEF, payload, sizeof(payload), pkt, sizeof(pkt));
+    TEST_ASSERT_EQUAL(ESPNOW_PACKET_HEADER + sizeof(payload), n);
+    TEST_ASSERT_EQUAL_HEX8(ESPNOW_PACKET_MAGIC, pkt[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xEF, pkt[2]);    // Little-endian seq
+    TEST_ASSERT_EQUAL_HEX8(0xBE, pkt[3]);
+
+    EspNowPacket p;
+    TEST_ASSERT_TRUE(espnow_packet_decode(pkt, n, &p));
+    TEST_ASSERT_EQUAL_UINT8(ESPNOW_KIND_TELEMETRY, p.kind);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, p.seq);
+    TEST_ASSERT_EQUAL(sizeof(payload), p.payload_len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, p.payload, sizeof(payload));
+}
+
+void test_oversize_payload_rejected(void) {
+    static uint8_t payload[ESPNOW_PACKET_MAX];
+    uint8_t pkt[ESPNOW_PACKET_MAX + 8];
+    TEST_ASSERT_EQUAL(0, espnow_packet_encode(1, 0, payload, ESPNOW_PACKET_MAX - ESPNOW_PACKET_HEADER + 1,
+                                              pkt, sizeof(pkt)));
+    TEST_ASSERT_EQUAL(0, espnow_packet_encode(1, 0, payload, 8, pkt, 8));
+}
+
+void test_foreign_or_short_packets_rejected(void) {
+    uint8_t pkt[8] = {0x00, 1, 0, 0, 1, 2, 3, 4};
+    EspNowPacket p;
+    TEST_ASSERT_FALSE(espnow_packet_decode(pkt, sizeof(pkt), &p));
+    pkt[0] = ESPNOW_PACKET_MAGIC;
+    TEST_ASSERT_FALSE(espnow_packet_decode(pkt, ESPNOW_PACKET_HEADER - 1, &p));
+    TEST_ASSERT_TRUE(espnow_packet_decode(pkt, ESPNOW_PACKET_HEADER, &p));
+    TEST_ASSERT_EQUAL(0, p.payload_len);
+}
+
+void test_seq_table_drops_retries(void) {
+    EspNowSeqTable<4> t;
+    t.clear();
+    TEST_ASSERT_TRUE(t.accept(kMacA, 10));
+    TEST_ASSERT_FALSE(t.accept(kMacA, 10));   // Retry after a lost ack
+    TEST_ASSERT_TRUE(t.accept(kMacB, 10));    // Same seq, other sensor
+    TEST_ASSERT_TRUE(t.accept(kMacA, 11));
+    TEST_ASSERT_FALSE(t.accept(kMacA, 11));
+}
+
+void test_seq_table_evicts_when_full(void) {
+    EspNowSeqTable<2> t;
+    t.clear();
+    TEST_ASSERT_TRUE(t.accept(kMacA, 1));
+    TEST_ASSERT_TRUE(t.accept(kMacB, 1));
+    TEST_ASSERT_TRUE(t.accept(kMacC, 1));     // Evicts A
+    TEST_ASSERT_EQUAL(2, t.used);
+    TEST_ASSERT_TRUE(t.accept(kMacA, 1));     // A forgotten, accepted again
+    TEST_ASSERT_FALSE(t.accept(kMacA, 1));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_encode_decode_round_trip);
+    RUN_TEST(test_oversize_payload_rejected);
+    RUN_TEST(test_foreign_or_short_packets_rejected);
+    RUN_TEST(test_seq_table_drops_retries);
+    RUN_TEST(test_seq_table_evicts_when_full);
+    return UNITY_END();
+}
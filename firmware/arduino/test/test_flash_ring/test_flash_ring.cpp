@@ -0,0 +1,142 @@
+// Unit tests for the append-only flash log ring
+// Runs against a RAM-backed NOR emulation: erase sets 0xFF, program can only
+// clear bits
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/logging/flash_ring.h"
+
+static constexpr uint32_t kSectors = 4;
+static uint8_t g_flash[kSectors * FLASH_RING_SECTOR];
+static uint32_t g_erases[kSectors];
+static size_t g_write_limit;  // Bytes programmed before a simulated reset
+
+static bool ram_write(void*, uint32_t off, const void* data, size_t len) {
+    const uint8_t* src = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        if (g_write_limit == 0) return false;
+        g_write_limit--;
+        g_flash[off + i] &= src[i];
+    }
+    return true;
+}
+
+static bool ram_erase(void*, uint32_t off, size_t len) {
+    memset(g_flash + off, 0xFF, len);
+    g_erases[off / FLASH_RING_SECTOR]++;
+    return true;
+}
+
+static FlashRingIo ram_io() {
+    return FlashRingIo{nullptr, ram_write, ram_erase, g_flash, sizeof(g_flash)};
+}
+
+static std::vector<uint32_t> collect(const FlashRing& ring) {
+    std::vector<uint32_t> out;
+    ring.forEach([&](const uint8_t* p, uint16_t len) {
+        uint32_t v;
+        TEST_ASSERT_EQUAL(sizeof(v), len);
+        memcpy(&v, p, sizeof(v));
+        out.push_back(v);
+        return true;
+    });
+    return out;
+}
+
+void setUp(void) {
+    memset(g_flash, 0xFF, sizeof(g_flash));
+    memset(g_erases, 0, sizeof(g_erases));
+    g_write_limit = SIZE_MAX;
+}
+void tearDown(void) {}
+
+void test_blank_partition_is_formatted() {
+    FlashRing ring;
+    TEST_ASSERT_TRUE(ring.begin(ram_io()));
+    TEST_ASSERT_EQUAL(0, ring.count());
+    TEST_ASSERT_EQUAL(1, g_erases[0]);
+}
+
+void test_records_survive_reopen_in_order() {
+    FlashRing ring;
+    ring.begin(ram_io());
+    for (uint32_t i = 0; i < 10; i++) TEST_ASSERT_TRUE(ring.append(&i, sizeof(i)));
+
+    FlashRing reopened;
+    TEST_ASSERT_TRUE(reopened.begin(ram_io()));
+    uint32_t next = 10;
+    TEST_ASSERT_TRUE(reopened.append(&next, sizeof(next)));
+    std::vector<uint32_t> got = collect(reopened);
+    TEST_ASSERT_EQUAL(11, got.size());
+    for (uint32_t i = 0; i < got.size(); i++) TEST_ASSERT_EQUAL(i, got[i]);
+}
+
+void test_rotation_drops_oldest_sector_and_levels_wear() {
+    FlashRing ring;
+    ring.begin(ram_io());
+    uint32_t per_sector = (FLASH_RING_SECTOR - sizeof(FlashRingSectorHeader)) / flash_ring_record_size(4);
+    uint32_t total = per_sector * kSectors * 3;
+    for (uint32_t i = 0; i < total; i++) ring.append(&i, sizeof(i));
+
+    std::vector<uint32_t> got = collect(ring);
+    TEST_ASSERT_TRUE(got.size() > per_sector * (kSectors - 1));
+    TEST_ASSERT_EQUAL(total - 1, got.back());
+    for (size_t i = 1; i < got.size(); i++) TEST_ASSERT_EQUAL(got[i - 1] + 1, got[i]);
+    for (uint32_t s = 1; s < kSectors; s++) {
+        int diff = (int)g_erases[s] - (int)g_erases[0];
+        TEST_ASSERT_TRUE(diff >= -1 && diff <= 1);
+    }
+}
+
+void test_torn_record_is_skipped() {
+    FlashRing ring;
+    ring.begin(ram_io());
+    uint32_t a = 1, b = 2, c = 3;
+    ring.append(&a, sizeof(a));
+    g_write_limit = sizeof(FlashRingRecordHeader) + 2;  // Reset mid-payload
+    ring.append(&b, sizeof(b));
+    g_write_limit = SIZE_MAX;
+
+    FlashRing reopened;
+    reopened.begin(ram_io());
+    reopened.append(&c, sizeof(c));
+    std::vector<uint32_t> got = collect(reopened);
+    TEST_ASSERT_EQUAL(2, got.size());
+    TEST_ASSERT_EQUAL(1, got[0]);
+    TEST_ASSERT_EQUAL(3, got[1]);
+}
+
+void test_clear_hides_older_records() {
+    FlashRing ring;
+    ring.begin(ram_io());
+    for (uint32_t i = 0; i < 5; i++) ring.append(&i, sizeof(i));
+    TEST_ASSERT_TRUE(ring.clear());
+    TEST_ASSERT_EQUAL(0, ring.count());
+    uint32_t v = 42;
+    ring.append(&v, sizeof(v));
+
+    FlashRing reopened;
+    reopened.begin(ram_io());
+    std::vector<uint32_t> got = collect(reopened);
+    TEST_ASSERT_EQUAL(1, got.size());
+    TEST_ASSERT_EQUAL(42, got[0]);
+}
+
+void test_oversized_payload_rejected() {
+    FlashRing ring;
+    ring.begin(ram_io());
+    uint8_t big[FLASH_RING_MAX_PAYLOAD + 1] = {};
+    TEST_ASSERT_FALSE(ring.append(big, sizeof(big)));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_blank_partition_is_formatted);
+    RUN_TEST(test_records_survive_reopen_in_order);
+    RUN_TEST(test_rotation_drops_oldest_sector_and_levels_wear);
+    RUN_TEST(test_torn_record_is_skipped);
+    RUN_TEST(test_clear_hides_older_records);
+    RUN_TEST(test_oversized_payload_rejected);
+    return UNITY_END();
+}
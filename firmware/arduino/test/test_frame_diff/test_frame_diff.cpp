@@ -0,0 +1,91 @@
+// Unit tests for the word-wise frame diff (changed rows and columns as windows)
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/frame_diff.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static constexpr uint16_t W = 250;
+static constexpr uint16_t H = 122;
+static constexpr uint16_t STRIDE = 32;
+
+static uint8_t g_prev[STRIDE * H];
+static uint8_t g_next[STRIDE * H];
+
+static void reset_frames() {
+    memset(g_prev, 0, sizeof(g_prev));
+    memset(g_next, 0, sizeof(g_next));
+}
+
+static void set_pixel(uint8_t* f, uint16_t x, uint16_t y) {
+    f[(size_t)y * STRIDE + x / 8] |= (uint8_t)(0x80 >> (x % 8));
+}
+
+void test_identical_frames_have_no_windows() {
+    reset_frames();
+    set_pixel(g_prev, 10, 10);
+    set_pixel(g_next, 10, 10);
+    PanelWindow wins[4];
+    TEST_ASSERT_EQUAL_UINT32(0, frame_diff_windows(g_prev, g_next, STRIDE, W, H, wins, 4));
+}
+
+void test_single_pixel_is_a_one_pixel_window() {
+    reset_frames();
+    set_pixel(g_next, 77, 40);
+    PanelWindow wins[4];
+    TEST_ASSERT_EQUAL_UINT32(1, frame_diff_windows(g_prev, g_next, STRIDE, W, H, wins, 4));
+    TEST_ASSERT_EQUAL_INT16(77, wins[0].x);
+    TEST_ASSERT_EQUAL_INT16(40, wins[0].y);
+    TEST_ASSERT_EQUAL_INT16(1, wins[0].w);
+    TEST_ASSERT_EQUAL_INT16(1, wins[0].h);
+}
+
+void test_row_runs_become_separate_windows() {
+    reset_frames();
+    for (uint16_t y = 5; y < 9; y++) set_pixel(g_next, 20 + y, y);   // Rows 5..8, x 25..28
+    set_pixel(g_next, 200, 100);                                      // Row 100
+    set_pixel(g_next, 249, 121);                                      // Last pixel
+    PanelWindow wins[4];
+    TEST_ASSERT_EQUAL_UINT32(3, frame_diff_windows(g_prev, g_next, STRIDE, W, H, wins, 4));
+    TEST_ASSERT_EQUAL_INT16(25, wins[0].x);
+    TEST_ASSERT_EQUAL_INT16(5, wins[0].y);
+    TEST_ASSERT_EQUAL_INT16(4, wins[0].w);
+    TEST_ASSERT_EQUAL_INT16(4, wins[0].h);
+    TEST_ASSERT_EQUAL_INT16(200, wins[1].x);
+    TEST_ASSERT_EQUAL_INT16(100, wins[1].y);
+    TEST_ASSERT_EQUAL_INT16(249, wins[2].x);
+    TEST_ASSERT_EQUAL_INT16(121, wins[2].y);
+    TEST_ASSERT_EQUAL_INT16(1, wins[2].h);
+}
+
+void test_padding_bits_are_ignored() {
+    reset_frames();
+    g_next[(size_t)3 * STRIDE + STRIDE - 1] = 0x03;   // x 254..255, past the width
+    PanelWindow wins[4];
+    TEST_ASSERT_EQUAL_UINT32(0, frame_diff_windows(g_prev, g_next, STRIDE, W, H, wins, 4));
+}
+
+void test_extra_runs_fold_into_the_last_window() {
+    reset_frames();
+    set_pixel(g_next, 8, 0);
+    set_pixel(g_next, 16, 10);
+    set_pixel(g_next, 100, 20);
+    PanelWindow wins[2];
+    TEST_ASSERT_EQUAL_UINT32(2, frame_diff_windows(g_prev, g_next, STRIDE, W, H, wins, 2));
+    TEST_ASSERT_EQUAL_INT16(16, wins[1].x);
+    TEST_ASSERT_EQUAL_INT16(10, wins[1].y);
+    TEST_ASSERT_EQUAL_INT16(85, wins[1].w);
+    TEST_ASSERT_EQUAL_INT16(11, wins[1].h);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_identical_frames_have_no_windows);
+    RUN_TEST(test_single_pixel_is_a_one_pixel_window);
+    RUN_TEST(test_row_runs_become_separate_windows);
+    RUN_TEST(test_padding_bits_are_ignored);
+    RUN_TEST(test_extra_runs_fold_into_the_last_window);
+    return UNITY_END();
+}
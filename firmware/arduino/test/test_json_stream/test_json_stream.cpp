@@ -0,0 +1,128 @@
+// Unit tests for the streaming JSON writer: separators and nesting, escaping,
+// counting vs writing passes, and the limit used for MQTT streamed publishes
+
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include "../../src/json_stream.h"
+
+struct Capture {
+    std::string data;
+    size_t calls = 0;
+    size_t max_chunk = 0;
+};
+
+static size_t capture_sink(void* ctx, const char* data, size_t len) {
+    Capture* c = static_cast<Capture*>(ctx);
+    c->data.append(data, len);
+    c->calls++;
+    if (len > c->max_chunk) c->max_chunk = len;
+    return len;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void emit_sample(JsonStream& j) {
+    j.beginObject()
+     .field("cmd", "perf")
+     .field("count", 3u)
+     .field("neg", -2)
+     .field("ok", true)
+     .beginArray("list");
+    j.field(nullptr, 1).field(nullptr, 2);
+    j.beginObject().field("a", 1).endObject();
+    j.beginArray().endArray();
+    j.endArray().endObject();
+}
+
+void test_commas_and_nesting() {
+    Capture c;
+    JsonStream j(capture_sink, &c);
+    emit_sample(j);
+    j.finish();
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"cmd\":\"perf\",\"count\":3,\"neg\":-2,\"ok\":true,\"list\":[1,2,{\"a\":1},[]]}",
+        c.data.c_str());
+}
+
+void test_strings_are_escaped() {
+    Capture c;
+    JsonStream j(capture_sink, &c);
+    j.beginObject().field("s", "a\"b\\c\nd").field("n", (const char*)nullptr).endObject().finish();
+    TEST_ASSERT_EQUAL_STRING("{\"s\":\"a\\\"b\\\\c\\u000ad\",\"n\":null}", c.data.c_str());
+}
+
+void test_doubles_and_non_finite() {
+    Capture c;
+    JsonStream j(capture_sink, &c);
+    j.beginObject().field("t", 21.25, 2).field("h", 40.0).field("x", (double)NAN).endObject().finish();
+    TEST_ASSERT_EQUAL_STRING("{\"t\":21.25,\"h\":40.0,\"x\":null}", c.data.c_str());
+}
+
+void test_members_splice_formatted_object() {
+    Capture c;
+    JsonStream j(capture_sink, &c);
+    j.beginObject().field("cmd", "memory").members("{\"free\":100,\"min\":50}").endObject();
+    j.finish();
+    TEST_ASSERT_EQUAL_STRING("{\"cmd\":\"memory\",\"free\":100,\"min\":50}", c.data.c_str());
+
+    Capture e;
+    JsonStream k(capture_sink, &e);
+    k.beginObject().field("cmd", "x").members("{}").endObject().finish();
+    TEST_ASSERT_EQUAL_STRING("{\"cmd\":\"x\"}", e.data.c_str());
+}
+
+void test_counting_pass_matches_write_pass() {
+    JsonStream counter;
+    emit_sample(counter);
+    Capture c;
+    JsonStream j(capture_sink, &c, counter.length());
+    emit_sample(j);
+    TEST_ASSERT_EQUAL_UINT32(counter.length(), j.finish());
+    TEST_ASSERT_EQUAL_UINT32(counter.length(), c.data.size());
+    TEST_ASSERT_EQUAL_UINT32(counter.length(), j.written());
+    TEST_ASSERT_FALSE(j.overflowed());
+}
+
+void test_limit_pads_and_cuts() {
+    Capture pad;
+    JsonStream a(capture_sink, &pad, 12);
+    a.beginObject().field("a", 1).endObject();
+    TEST_ASSERT_EQUAL_UINT32(12, a.finish());
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1}     ", pad.data.c_str());
+    TEST_ASSERT_FALSE(a.overflowed());
+
+    Capture cut;
+    JsonStream b(capture_sink, &cut, 4);
+    b.beginObject().field("abc", 1).endObject();
+    TEST_ASSERT_EQUAL_UINT32(4, b.finish());
+    TEST_ASSERT_EQUAL_UINT32(4, cut.data.size());
+    TEST_ASSERT_TRUE(b.overflowed());
+}
+
+void test_large_document_flushes_in_chunks() {
+    Capture c;
+    JsonStream j(capture_sink, &c);
+    j.beginArray();
+    for (int i = 0; i < 200; i++) j.field(nullptr, "0123456789");   // 12 chars + comma
+    j.endArray();
+    size_t len = j.finish();
+    TEST_ASSERT_EQUAL_UINT32(2 + 200 * 13 - 1, len);
+    TEST_ASSERT_EQUAL_UINT32(len, c.data.size());
+    TEST_ASSERT_TRUE(c.calls > 1);
+    TEST_ASSERT_EQUAL_UINT32(JsonStream::CHUNK, c.max_chunk);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_commas_and_nesting);
+    RUN_TEST(test_strings_are_escaped);
+    RUN_TEST(test_doubles_and_non_finite);
+    RUN_TEST(test_members_splice_formatted_object);
+    RUN_TEST(test_counting_pass_matches_write_pass);
+    RUN_TEST(test_limit_pads_and_cuts);
+    RUN_TEST(test_large_document_flushes_in_chunks);
+    return UNITY_END();
+}
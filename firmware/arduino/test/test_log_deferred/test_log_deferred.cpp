@@ -0,0 +1,104 @@
+// Unit tests for deferred log formatting
+// A captured entry must format to exactly what vsnprintf would have produced
+
+#include <unity.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include "../../src/logging/log_deferred.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static bool capture(LogEntry& e, const char* format, ...) {
+    memset(&e, 0, sizeof(e));
+    va_list args;
+    va_start(args, format);
+    bool ok = log_defer_capture(e, format, args);
+    va_end(args);
+    return ok;
+}
+
+static void expect_same(const char* expected, const LogEntry& e) {
+    char text[128];
+    log_entry_format(e, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING(expected, text);
+}
+
+void test_integers_and_floats_round_trip() {
+    LogEntry e;
+    TEST_ASSERT_TRUE(capture(e, "Entering deep sleep for %u seconds. Wake count: %u", 300u, 42u));
+    TEST_ASSERT_TRUE(e.flags & LOG_ENTRY_DEFERRED);
+    expect_same("Entering deep sleep for 300 seconds. Wake count: 42", e);
+
+    TEST_ASSERT_TRUE(capture(e, "SLOW: %s took %u us (%.2f ms)", "mqtt_connect", 12345u, 12.345f));
+    expect_same("SLOW: mqtt_connect took 12345 us (12.35 ms)", e);
+
+    TEST_ASSERT_TRUE(capture(e, "%ld %lld %zu %x %c %%", -7L, 1LL << 40, (size_t)9, 0xBEEFu, 'k'));
+    expect_same("-7 1099511627776 9 beef k %", e);
+}
+
+void test_string_is_copied_not_referenced() {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "wifi");
+    LogEntry e;
+    TEST_ASSERT_TRUE(capture(e, "Connecting to %s: %s", buf, (const char*)nullptr));
+    snprintf(buf, sizeof(buf), "gone");
+    expect_same("Connecting to wifi: (null)", e);
+}
+
+void test_star_width_and_precision() {
+    LogEntry e;
+    TEST_ASSERT_TRUE(capture(e, "[%*d] [%-*d] [%.*s]", 5, 42, 4, 7, 3, "abcdef"));
+    expect_same("[   42] [7   ] [abc]", e);
+}
+
+void test_unsupported_or_oversized_falls_back() {
+    LogEntry e;
+    int n = 0;
+    TEST_ASSERT_FALSE(capture(e, "count%n", &n));
+    TEST_ASSERT_FALSE(capture(e, "%Lf", (long double)1.0));
+    TEST_ASSERT_FALSE(capture(e, "%f %f %f %f %f %f", 1.0, 2.0, 3.0, 4.0, 5.0, 6.0));
+}
+
+void test_long_string_is_truncated_in_place() {
+    LogEntry e;
+    char big[100];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    TEST_ASSERT_TRUE(capture(e, "%s!", big));
+    char text[128];
+    size_t n = log_entry_format(e, text, sizeof(text));
+    TEST_ASSERT_EQUAL(LOG_ENTRY_ARG_BYTES, n);  // Copy truncated to ARG_BYTES - 1, then "!"
+    TEST_ASSERT_EQUAL('!', text[n - 1]);
+}
+
+void test_format_respects_output_size() {
+    LogEntry e;
+    TEST_ASSERT_TRUE(capture(e, "value=%d and more text", 123456));
+    char text[8];
+    size_t n = log_entry_format(e, text, sizeof(text));
+    TEST_ASSERT_EQUAL(7, n);
+    TEST_ASSERT_EQUAL_STRING("value=1", text);
+}
+
+void test_materialize_produces_eager_entry() {
+    LogEntry e;
+    TEST_ASSERT_TRUE(capture(e, "Test INFO message with number: %d", 42));
+    log_entry_materialize(e);
+    TEST_ASSERT_FALSE(e.flags & LOG_ENTRY_DEFERRED);
+    TEST_ASSERT_EQUAL_STRING("Test INFO message with number: 42", e.message);
+    expect_same("Test INFO message with number: 42", e);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_integers_and_floats_round_trip);
+    RUN_TEST(test_string_is_copied_not_referenced);
+    RUN_TEST(test_star_width_and_precision);
+    RUN_TEST(test_unsupported_or_oversized_falls_back);
+    RUN_TEST(test_long_string_is_truncated_in_place);
+    RUN_TEST(test_format_respects_output_size);
+    RUN_TEST(test_materialize_produces_eager_entry);
+    return UNITY_END();
+}
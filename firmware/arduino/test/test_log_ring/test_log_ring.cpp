@@ -0,0 +1,93 @@
+// Unit tests for the lock-free log ring behind LogBuffer
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/logging/log_ring.h"
+
+static LogRing<8> ring;
+
+void setUp(void) { log_ring_reset(ring); }
+void tearDown(void) {}
+
+static LogEntry make_entry(uint16_t seq) {
+    LogEntry e;
+    memset(&e, 0, sizeof(e));
+    e.sequence = seq;
+    return e;
+}
+
+void test_push_pop_in_order() {
+    for (uint16_t i = 0; i < 5; i++) TEST_ASSERT_FALSE(log_ring_push(ring, make_entry(i)));
+    TEST_ASSERT_EQUAL(5, log_ring_count(ring));
+    LogEntry e;
+    for (uint16_t i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(log_ring_pop(ring, e));
+        TEST_ASSERT_EQUAL(i, e.sequence);
+    }
+    TEST_ASSERT_FALSE(log_ring_pop(ring, e));
+    TEST_ASSERT_EQUAL(0, log_ring_count(ring));
+}
+
+void test_full_ring_overwrites_oldest() {
+    for (uint16_t i = 0; i < 8; i++) TEST_ASSERT_FALSE(log_ring_push(ring, make_entry(i)));
+    TEST_ASSERT_TRUE(log_ring_push(ring, make_entry(8)));
+    TEST_ASSERT_TRUE(log_ring_push(ring, make_entry(9)));
+    TEST_ASSERT_EQUAL(2, ring.overflow);
+    TEST_ASSERT_EQUAL(8, log_ring_count(ring));
+
+    LogEntry e;
+    uint32_t oldest = log_ring_oldest(ring);
+    TEST_ASSERT_TRUE(log_ring_read(ring, oldest, e));
+    TEST_ASSERT_EQUAL(2, e.sequence);
+    TEST_ASSERT_FALSE(log_ring_read(ring, oldest - 1, e));  // Overwritten ticket
+    TEST_ASSERT_TRUE(log_ring_pop(ring, e));
+    TEST_ASSERT_EQUAL(2, e.sequence);
+}
+
+void test_in_flight_slot_is_not_skipped() {
+    log_ring_push(ring, make_entry(0));
+    // Simulate a producer that claimed ticket 1 but has not committed yet
+    uint32_t ticket = __atomic_fetch_add(&ring.head, 1, __ATOMIC_RELAXED);
+    LogEntry e;
+    TEST_ASSERT_TRUE(log_ring_pop(ring, e));
+    TEST_ASSERT_FALSE(log_ring_pop(ring, e));
+    TEST_ASSERT_EQUAL(1, log_ring_count(ring));
+
+    // Commit it; the consumer now sees it
+    ring.slots[ticket & 7] = make_entry(1);
+    ring.stamp[ticket & 7] = log_ring_stamp(ticket);
+    TEST_ASSERT_TRUE(log_ring_pop(ring, e));
+    TEST_ASSERT_EQUAL(1, e.sequence);
+}
+
+void test_discard_empties_without_losing_later_pushes() {
+    for (uint16_t i = 0; i < 3; i++) log_ring_push(ring, make_entry(i));
+    log_ring_discard(ring);
+    TEST_ASSERT_EQUAL(0, log_ring_count(ring));
+    log_ring_push(ring, make_entry(7));
+    LogEntry e;
+    TEST_ASSERT_TRUE(log_ring_pop(ring, e));
+    TEST_ASSERT_EQUAL(7, e.sequence);
+}
+
+void test_tickets_survive_wraparound() {
+    ring.head = ring.tail = 0xFFFFFFFCu;  // Ticket 0xFFFFFFFF is in the middle
+    for (uint16_t i = 0; i < 8; i++) log_ring_push(ring, make_entry(i));
+    TEST_ASSERT_EQUAL(8, log_ring_count(ring));
+    TEST_ASSERT_EQUAL(0, ring.overflow);
+    LogEntry e;
+    for (uint16_t i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(log_ring_pop(ring, e));
+        TEST_ASSERT_EQUAL(i, e.sequence);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_push_pop_in_order);
+    RUN_TEST(test_full_ring_overwrites_oldest);
+    RUN_TEST(test_in_flight_slot_is_not_skipped);
+    RUN_TEST(test_discard_empties_without_losing_later_pushes);
+    RUN_TEST(test_tickets_survive_wraparound);
+    return UNITY_END();
+}
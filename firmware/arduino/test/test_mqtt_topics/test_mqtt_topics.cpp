@@ -142,6 +142,7 @@ void test_all_standard_topic_suffixes() {
         "inside/temperature",
         "inside/humidity",
         "inside/pressure",
+        "inside/stats",
         "battery/voltage",
         "battery/percent",
         "wifi/rssi",
@@ -158,7 +159,12 @@ void test_all_standard_topic_suffixes() {
         "debug/memory",
         "diagnostic_mode",
         "debug/publish_latency_ms",
-        "cmd/+"
+        "cmd/+",
+        "config",
+        "ota",
+        "ota/data",
+        "ota/req",
+        "ota/status"
     };
 
     for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++) {
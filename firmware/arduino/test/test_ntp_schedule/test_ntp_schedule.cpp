@@ -0,0 +1,101 @@
+// Unit tests for NTP sync scheduling: drift learning from successive syncs,
+// the per-wake clock correction and the error-bound due check
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/ntp_schedule.h"
+
+static const uint32_t T0 = 1760000000u;
+
+static NtpSchedule fresh() {
+    NtpSchedule s;
+    memset(&s, 0, sizeof(s));
+    return s;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_never_synced_is_due() {
+    NtpSchedule s = fresh();
+    TEST_ASSERT_TRUE(ntp_sync_due(s, T0, 10000, 86400));
+    TEST_ASSERT_TRUE(ntp_sync_due(s, 1000, 10000, 86400));   // Clock not set
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)ntp_take_correction_us(s, T0));
+}
+
+void test_first_sync_uses_unknown_drift_bound() {
+    NtpSchedule s = fresh();
+    ntp_on_sync(s, 1000.0, (double)T0);
+    TEST_ASSERT_EQUAL_UINT32(T0, s.last_sync_epoch);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.drift_ppm);
+    // 10 s at 500 ppm: 20000 s
+    TEST_ASSERT_FALSE(ntp_sync_due(s, T0 + 19000, 10000, 86400));
+    TEST_ASSERT_TRUE(ntp_sync_due(s, T0 + 21000, 10000, 86400));
+}
+
+void test_second_sync_learns_drift() {
+    NtpSchedule s = fresh();
+    ntp_on_sync(s, 1000.0, (double)T0);
+    // Clock ran 2 s fast over 20000 s: +100 ppm
+    ntp_on_sync(s, (double)T0 + 20002.0, (double)T0 + 20000.0);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, s.drift_ppm);
+    TEST_ASSERT_EQUAL_UINT16(2, s.sync_count);
+    // 100 ppm residual: 10 s after 100000 s
+    TEST_ASSERT_FALSE(ntp_sync_due(s, T0 + 20000 + 90000, 10000, 200000));
+    TEST_ASSERT_TRUE(ntp_sync_due(s, T0 + 20000 + 110000, 10000, 200000));
+}
+
+void test_correction_takes_drift_out() {
+    NtpSchedule s = fresh();
+    ntp_on_sync(s, 1000.0, (double)T0);
+    ntp_on_sync(s, (double)T0 + 20002.0, (double)T0 + 20000.0);
+    // 300 s at +100 ppm: clock is 30 ms ahead
+    TEST_ASSERT_EQUAL_INT32(-30000, (int32_t)ntp_take_correction_us(s, T0 + 20300));
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)ntp_take_correction_us(s, T0 + 20300));
+    TEST_ASSERT_EQUAL_INT32(-60000, (int32_t)ntp_take_correction_us(s, T0 + 20900));
+}
+
+void test_residual_refines_drift() {
+    NtpSchedule s = fresh();
+    ntp_on_sync(s, 1000.0, (double)T0);
+    ntp_on_sync(s, (double)T0 + 20002.0, (double)T0 + 20000.0);
+    // Corrected clock still 0.4 s fast after another 20000 s: +20 ppm more
+    ntp_on_sync(s, (double)T0 + 40000.4, (double)T0 + 40000.0);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 120.0f, s.drift_ppm);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, s.uncertainty_ppm);
+    // Floor of 20 ppm: the interval ceiling decides
+    TEST_ASSERT_FALSE(ntp_sync_due(s, T0 + 40000 + 86399, 10000, 86400));
+    TEST_ASSERT_TRUE(ntp_sync_due(s, T0 + 40000 + 86400, 10000, 86400));
+}
+
+void test_short_span_and_steps_ignored() {
+    NtpSchedule s = fresh();
+    ntp_on_sync(s, 1000.0, (double)T0);
+    // Under an hour apart: latency noise, no rate measured
+    ntp_on_sync(s, (double)T0 + 600.5, (double)T0 + 600.0);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.drift_ppm);
+    TEST_ASSERT_EQUAL_UINT16(1, s.sync_count);
+    // A 20 min step over 10 h is not drift
+    ntp_on_sync(s, (double)T0 + 36600.0 + 1200.0, (double)T0 + 36600.0);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.drift_ppm);
+    TEST_ASSERT_EQUAL_UINT32(T0 + 36600, s.last_sync_epoch);
+}
+
+void test_clock_backwards_is_due() {
+    NtpSchedule s = fresh();
+    ntp_on_sync(s, 1000.0, (double)T0);
+    TEST_ASSERT_TRUE(ntp_sync_due(s, T0 - 10, 10000, 86400));
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)ntp_take_correction_us(s, T0 - 10));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_never_synced_is_due);
+    RUN_TEST(test_first_sync_uses_unknown_drift_bound);
+    RUN_TEST(test_second_sync_learns_drift);
+    RUN_TEST(test_correction_takes_drift_out);
+    RUN_TEST(test_residual_refines_drift);
+    RUN_TEST(test_short_span_and_steps_ignored);
+    RUN_TEST(test_clock_backwards_is_due);
+    return UNITY_END();
+}
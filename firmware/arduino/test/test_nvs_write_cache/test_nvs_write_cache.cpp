@@ -0,0 +1,97 @@
+// Unit tests for the NVS write-back cache: unchanged stores are skipped,
+// changed and new keys are written once, lookups see pending values
+
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+#include "../../src/nvs_write_cache.h"
+
+struct Write {
+    char key[NVS_CACHE_KEY_LEN];
+    uint32_t bits;
+};
+
+static Write writes[8];
+static size_t write_count;
+
+static bool record_write(const char* key, NvsCacheType, uint32_t bits) {
+    strncpy(writes[write_count].key, key, NVS_CACHE_KEY_LEN);
+    writes[write_count].bits = bits;
+    write_count++;
+    return true;
+}
+
+void setUp(void) { write_count = 0; }
+void tearDown(void) {}
+
+void test_unchanged_store_is_not_written() {
+    NvsWriteCache<4> c;
+    c.noteLoaded("ha_crc", NVS_CACHE_U32, 1234, true);
+    c.store("ha_crc", NVS_CACHE_U32, 1234);
+    TEST_ASSERT_EQUAL(0, c.dirtyCount());
+    TEST_ASSERT_EQUAL(0, c.flush(record_write));
+    TEST_ASSERT_EQUAL(0, write_count);
+    TEST_ASSERT_EQUAL(1, c.skipped());
+}
+
+void test_changed_and_new_keys_are_written_once() {
+    NvsWriteCache<4> c;
+    c.noteLoaded("a", NVS_CACHE_U32, 1, true);
+    c.noteLoaded("b", NVS_CACHE_U16, 0, false);
+    c.store("a", NVS_CACHE_U32, 2);
+    c.store("a", NVS_CACHE_U32, 3);             // Coalesced
+    c.store("b", NVS_CACHE_U16, 0);             // Absent in flash: must write
+    TEST_ASSERT_EQUAL(2, c.dirtyCount());
+    TEST_ASSERT_EQUAL(2, c.flush(record_write));
+    TEST_ASSERT_EQUAL_STRING("a", writes[0].key);
+    TEST_ASSERT_EQUAL(3, writes[0].bits);
+    TEST_ASSERT_EQUAL_STRING("b", writes[1].key);
+
+    // Flushed values are now what flash holds
+    c.store("a", NVS_CACHE_U32, 3);
+    TEST_ASSERT_EQUAL(0, c.flush(record_write));
+    TEST_ASSERT_EQUAL(2, write_count);
+}
+
+void test_lookup_sees_pending_and_absent_values() {
+    NvsWriteCache<4> c;
+    uint32_t bits = 0;
+    TEST_ASSERT_FALSE(c.lookup("x", NVS_CACHE_U8, bits));
+    c.noteLoaded("x", NVS_CACHE_U8, 0, false);
+    TEST_ASSERT_TRUE(c.known("x", NVS_CACHE_U8));
+    TEST_ASSERT_FALSE(c.lookup("x", NVS_CACHE_U8, bits));   // Known absent
+    c.store("x", NVS_CACHE_U8, 7);
+    TEST_ASSERT_TRUE(c.lookup("x", NVS_CACHE_U8, bits));
+    TEST_ASSERT_EQUAL(7, bits);
+    TEST_ASSERT_FALSE(c.known("x", NVS_CACHE_U32));         // Types are distinct
+}
+
+void test_nan_round_trip_is_unchanged() {
+    NvsWriteCache<4> c;
+    uint32_t nan_bits = nvs_float_bits(NAN);
+    c.noteLoaded("li_f", NVS_CACHE_FLOAT, nan_bits, true);
+    c.store("li_f", NVS_CACHE_FLOAT, nvs_float_bits(NAN));
+    TEST_ASSERT_EQUAL(0, c.flush(record_write));
+    TEST_ASSERT_TRUE(std::isnan(nvs_bits_float(nan_bits)));
+}
+
+void test_full_table_and_long_keys_overflow() {
+    NvsWriteCache<2> c;
+    TEST_ASSERT_TRUE(c.store("k1", NVS_CACHE_U32, 1));
+    TEST_ASSERT_TRUE(c.store("k2", NVS_CACHE_U32, 2));
+    TEST_ASSERT_FALSE(c.store("k3", NVS_CACHE_U32, 3));
+    TEST_ASSERT_FALSE(c.store("k1", NVS_CACHE_U16, 1));
+    NvsWriteCache<2> d;
+    TEST_ASSERT_FALSE(d.store("this_key_is_too_long", NVS_CACHE_U32, 1));
+    TEST_ASSERT_EQUAL(2, c.overflows());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unchanged_store_is_not_written);
+    RUN_TEST(test_changed_and_new_keys_are_written_once);
+    RUN_TEST(test_lookup_sees_pending_and_absent_values);
+    RUN_TEST(test_nan_round_trip_is_unchanged);
+    RUN_TEST(test_full_table_and_long_keys_overflow);
+    return UNITY_END();
+}
@@ -0,0 +1,239 @@
+// Unit tests for the delta OTA decoder: each op, patches fed in pieces of
+// any size, output budgets that pause mid-op, and malformed patches
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "../../src/ota_delta.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+typedef std::vector<uint8_t> Bytes;
+
+static Bytes g_src;
+static Bytes g_out;
+
+static void put_varint(Bytes& p, uint32_t v) {
+    while (v >= 0x80) {
+        p.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    p.push_back((uint8_t)v);
+}
+
+static void op_copy(Bytes& p, uint32_t src, uint32_t len) {
+    p.push_back(OTA_DELTA_OP_COPY);
+    put_varint(p, src);
+    put_varint(p, len);
+}
+
+static void op_data(Bytes& p, const char* s) {
+    p.push_back(OTA_DELTA_OP_DATA);
+    put_varint(p, (uint32_t)strlen(s));
+    p.insert(p.end(), s, s + strlen(s));
+}
+
+static bool read_src(uint32_t off, uint8_t* buf, size_t n) {
+    if (off + n > g_src.size()) return false;
+    memcpy(buf, g_src.data() + off, n);
+    return true;
+}
+
+static bool write_out(uint32_t off, const uint8_t* buf, size_t n) {
+    if (off != g_out.size()) return false;   // Strictly in order
+    g_out.insert(g_out.end(), buf, buf + n);
+    return true;
+}
+
+// Feeds the patch piece bytes at a time; every unconsumed byte is fed again
+static OtaDeltaResult run(const Bytes& patch, uint32_t dst_size, size_t piece,
+                          uint32_t budget, int* calls = nullptr) {
+    OtaDeltaState st;
+    ota_delta_init(st);
+    OtaDeltaLimits lim = { (uint32_t)g_src.size(), dst_size };
+    g_out.clear();
+    size_t pos = 0;
+    int n = 0;
+    OtaDeltaResult r = OTA_DELTA_MORE;
+    while (r == OTA_DELTA_MORE && n < 100000) {
+        size_t len = patch.size() - pos < piece ? patch.size() - pos : piece;
+        size_t used = 0;
+        r = ota_delta_feed(st, lim, patch.data() + pos, len, budget, used, read_src, write_out);
+        pos += used;
+        n++;
+        if (r == OTA_DELTA_MORE && len == 0 && used == 0 && st.out_pos == dst_size) break;
+    }
+    if (calls) *calls = n;
+    return r;
+}
+
+static void make_source() {
+    g_src.clear();
+    for (int i = 0; i < 1000; i++) g_src.push_back((uint8_t)(i * 7 + 3));
+}
+
+static Bytes mixed_patch(Bytes& expected) {
+    Bytes p;
+    expected.clear();
+    op_copy(p, 100, 300);
+    expected.insert(expected.end(), g_src.begin() + 100, g_src.begin() + 400);
+    op_data(p, "hello");
+    expected.insert(expected.end(), "hello", "hello" + 5);
+    // ADD 200 bytes from 500: skip 10, +1 on 3 bytes, skip the rest
+    p.push_back(OTA_DELTA_OP_ADD);
+    put_varint(p, 500);
+    put_varint(p, 200);
+    put_varint(p, 10);
+    put_varint(p, 3);
+    p.push_back(1); p.push_back(0xFF); p.push_back(2);
+    put_varint(p, 187);
+    expected.insert(expected.end(), g_src.begin() + 500, g_src.begin() + 700);
+    expected[305 + 10] += 1;
+    expected[305 + 11] += 0xFF;
+    expected[305 + 12] += 2;
+    p.push_back(OTA_DELTA_OP_END);
+    return p;
+}
+
+void test_copy_data_add_rebuild_image() {
+    make_source();
+    Bytes expected;
+    Bytes p = mixed_patch(expected);
+    TEST_ASSERT_EQUAL(OTA_DELTA_DONE, run(p, (uint32_t)expected.size(), p.size(), 1 << 20));
+    TEST_ASSERT_EQUAL(expected.size(), g_out.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), g_out.data(), expected.size());
+}
+
+void test_any_split_gives_same_image() {
+    make_source();
+    Bytes expected;
+    Bytes p = mixed_patch(expected);
+    for (size_t piece = 1; piece <= p.size(); piece++) {
+        TEST_ASSERT_EQUAL(OTA_DELTA_DONE, run(p, (uint32_t)expected.size(), piece, 1 << 20));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), g_out.data(), expected.size());
+    }
+}
+
+void test_budget_pauses_and_resumes_without_input() {
+    make_source();
+    Bytes expected;
+    Bytes p = mixed_patch(expected);
+    int calls = 0;
+    TEST_ASSERT_EQUAL(OTA_DELTA_DONE, run(p, (uint32_t)expected.size(), p.size(), 16, &calls));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), g_out.data(), expected.size());
+    TEST_ASSERT_TRUE(calls >= (int)(expected.size() / 16));
+
+    // A COPY paused by the budget continues on a call with no patch bytes
+    OtaDeltaState st;
+    ota_delta_init(st);
+    OtaDeltaLimits lim = { (uint32_t)g_src.size(), 300 };
+    g_out.clear();
+    Bytes c;
+    op_copy(c, 0, 300);
+    size_t used = 0;
+    TEST_ASSERT_EQUAL(OTA_DELTA_MORE,
+                      ota_delta_feed(st, lim, c.data(), c.size(), 100, used, read_src, write_out));
+    TEST_ASSERT_EQUAL(c.size(), used);
+    TEST_ASSERT_EQUAL_UINT32(100, st.out_pos);
+    TEST_ASSERT_EQUAL(OTA_DELTA_MORE,
+                      ota_delta_feed(st, lim, nullptr, 0, 1000, used, read_src, write_out));
+    TEST_ASSERT_EQUAL_UINT32(300, st.out_pos);
+    uint8_t end = OTA_DELTA_OP_END;
+    TEST_ASSERT_EQUAL(OTA_DELTA_DONE,
+                      ota_delta_feed(st, lim, &end, 1, 1000, used, read_src, write_out));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(g_src.data(), g_out.data(), 300);
+}
+
+void test_state_survives_a_copy_between_feeds() {
+    // The state is a POD restored from RTC/NVS: a byte copy must resume
+    make_source();
+    Bytes expected;
+    Bytes p = mixed_patch(expected);
+    OtaDeltaState st;
+    ota_delta_init(st);
+    OtaDeltaLimits lim = { (uint32_t)g_src.size(), (uint32_t)expected.size() };
+    g_out.clear();
+    size_t pos = 0;
+    OtaDeltaResult r = OTA_DELTA_MORE;
+    while (r == OTA_DELTA_MORE) {
+        OtaDeltaState saved;
+        memcpy(&saved, &st, sizeof(st));
+        size_t len = p.size() - pos < 7 ? p.size() - pos : 7;
+        size_t used = 0;
+        r = ota_delta_feed(saved, lim, p.data() + pos, len, 50, used, read_src, write_out);
+        memcpy(&st, &saved, sizeof(st));
+        pos += used;
+    }
+    TEST_ASSERT_EQUAL(OTA_DELTA_DONE, r);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), g_out.data(), expected.size());
+}
+
+void test_malformed_patches_fail() {
+    make_source();
+    Bytes p;
+
+    op_copy(p, 900, 200);                  // Past the end of the source
+    p.push_back(OTA_DELTA_OP_END);
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR, run(p, 200, p.size(), 1 << 20));
+
+    p.clear();
+    op_data(p, "abc");                     // Longer than the image
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR, run(p, 2, p.size(), 1 << 20));
+
+    p.clear();
+    op_data(p, "abc");
+    p.push_back(OTA_DELTA_OP_END);         // END before the image is complete
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR, run(p, 4, p.size(), 1 << 20));
+
+    p.clear();
+    p.push_back(0x7E);                     // Unknown op
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR, run(p, 4, p.size(), 1 << 20));
+
+    p.clear();
+    p.push_back(OTA_DELTA_OP_COPY);        // Varint longer than 32 bits
+    for (int i = 0; i < 5; i++) p.push_back(0xFF);
+    p.push_back(0x01);
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR, run(p, 4, p.size(), 1 << 20));
+
+    p.clear();
+    p.push_back(OTA_DELTA_OP_ADD);         // Segment longer than the op
+    put_varint(p, 0);
+    put_varint(p, 4);
+    put_varint(p, 2);
+    put_varint(p, 5);
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR, run(p, 4, p.size(), 1 << 20));
+
+    p.clear();
+    op_data(p, "ab");
+    p.push_back(OTA_DELTA_OP_END);
+    p.push_back(OTA_DELTA_OP_END);         // Trailing bytes after END
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR, run(p, 2, p.size(), 1 << 20));
+}
+
+void test_failed_state_stays_failed() {
+    make_source();
+    OtaDeltaState st;
+    ota_delta_init(st);
+    OtaDeltaLimits lim = { (uint32_t)g_src.size(), 10 };
+    uint8_t bad = 0x55;
+    size_t used = 0;
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR,
+                      ota_delta_feed(st, lim, &bad, 1, 100, used, read_src, write_out));
+    Bytes p;
+    op_data(p, "0123456789");
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERROR,
+                      ota_delta_feed(st, lim, p.data(), p.size(), 100, used, read_src, write_out));
+    TEST_ASSERT_EQUAL(0, used);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_copy_data_add_rebuild_image);
+    RUN_TEST(test_any_split_gives_same_image);
+    RUN_TEST(test_budget_pauses_and_resumes_without_input);
+    RUN_TEST(test_state_survives_a_copy_between_feeds);
+    RUN_TEST(test_malformed_patches_fail);
+    RUN_TEST(test_failed_state_stays_failed);
+    return UNITY_END();
+}
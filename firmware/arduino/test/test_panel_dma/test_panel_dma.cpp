@@ -0,0 +1,71 @@
+// Unit tests for the panel DMA write planning (eligibility, chunks, RAM window)
+
+#include <unity.h>
+#include "../../src/panel_dma_core.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static constexpr uint16_t W = 128;
+static constexpr uint16_t H = 250;
+
+void test_full_frame_and_full_row_pages_are_eligible() {
+    TEST_ASSERT_TRUE(panel_dma_eligible(0, 0, W, H, W, H, false, false, false));
+    TEST_ASSERT_TRUE(panel_dma_eligible(0, 200, W, 50, W, H, false, false, false));
+}
+
+void test_other_writes_keep_the_byte_loop() {
+    TEST_ASSERT_FALSE(panel_dma_eligible(8, 0, 64, H, W, H, false, false, false));   // Narrow
+    TEST_ASSERT_FALSE(panel_dma_eligible(0, 0, W, H, W, H, true, false, false));     // Inverted
+    TEST_ASSERT_FALSE(panel_dma_eligible(0, 0, W, H, W, H, false, true, false));     // Mirrored
+    TEST_ASSERT_FALSE(panel_dma_eligible(0, 0, W, H, W, H, false, false, true));     // PROGMEM
+    TEST_ASSERT_FALSE(panel_dma_eligible(0, 240, W, 20, W, H, false, false, false)); // Past the end
+    TEST_ASSERT_FALSE(panel_dma_eligible(0, -1, W, 20, W, H, false, false, false));
+    // 8 rows = 128 bytes, under the hand-over cost
+    TEST_ASSERT_FALSE(panel_dma_eligible(0, 0, W, 8, W, H, false, false, false));
+    TEST_ASSERT_TRUE(panel_dma_eligible(0, 0, W, 8, W, H, false, false, false, 64));
+}
+
+void test_chunk_count() {
+    TEST_ASSERT_EQUAL_UINT32(0, panel_dma_chunk_count(0, PANEL_DMA_MAX_CHUNK));
+    TEST_ASSERT_EQUAL_UINT32(1, panel_dma_chunk_count(4000, PANEL_DMA_MAX_CHUNK));
+    TEST_ASSERT_EQUAL_UINT32(1, panel_dma_chunk_count(PANEL_DMA_MAX_CHUNK, PANEL_DMA_MAX_CHUNK));
+    TEST_ASSERT_EQUAL_UINT32(2, panel_dma_chunk_count(PANEL_DMA_MAX_CHUNK + 1, PANEL_DMA_MAX_CHUNK));
+    TEST_ASSERT_EQUAL_UINT32(0, PANEL_DMA_MAX_CHUNK % 4);
+}
+
+// The sequence GxEPD2's SSD1680 drivers send for a full 128x250 window
+void test_ram_area_matches_gxepd2_full_window() {
+    PanelCtrlByte seq[PANEL_RAM_AREA_LEN];
+    TEST_ASSERT_EQUAL_UINT32(PANEL_RAM_AREA_LEN, ssd1680_ram_area(0, 0, W, H, seq));
+    const int expected[PANEL_RAM_AREA_LEN] = {
+        0x111, 0x03,
+        0x144, 0x00, 0x0F,
+        0x145, 0x00, 0x00, 0xF9, 0x00,
+        0x14E, 0x00,
+        0x14F, 0x00, 0x00,
+    };
+    for (size_t i = 0; i < PANEL_RAM_AREA_LEN; i++) {
+        int got = (seq[i].command ? 0x100 : 0) | seq[i].value;
+        TEST_ASSERT_EQUAL_HEX16(expected[i], got);
+    }
+}
+
+void test_ram_area_of_a_lower_page() {
+    PanelCtrlByte seq[PANEL_RAM_AREA_LEN];
+    ssd1680_ram_area(0, 200, W, 50, seq);
+    TEST_ASSERT_EQUAL_UINT8(200, seq[6].value);    // Y start, low
+    TEST_ASSERT_EQUAL_UINT8(0, seq[7].value);
+    TEST_ASSERT_EQUAL_UINT8(249, seq[8].value);    // Y end, low
+    TEST_ASSERT_EQUAL_UINT8(200, seq[13].value);   // Y counter starts at the window
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_frame_and_full_row_pages_are_eligible);
+    RUN_TEST(test_other_writes_keep_the_byte_loop);
+    RUN_TEST(test_chunk_count);
+    RUN_TEST(test_ram_area_matches_gxepd2_full_window);
+    RUN_TEST(test_ram_area_of_a_lower_page);
+    return UNITY_END();
+}
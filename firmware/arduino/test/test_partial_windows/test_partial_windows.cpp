@@ -0,0 +1,73 @@
+// Unit tests for partial-window planning (dirty rect coalescing)
+// Rects below are taken from display_layout.h
+
+#include <unity.h>
+#include "../../src/partial_windows.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void assert_window(const PanelWindow& w, int16_t x, int16_t y, int16_t ww, int16_t h) {
+    TEST_ASSERT_EQUAL_INT16(x, w.x);
+    TEST_ASSERT_EQUAL_INT16(y, w.y);
+    TEST_ASSERT_EQUAL_INT16(ww, w.w);
+    TEST_ASSERT_EQUAL_INT16(h, w.h);
+}
+
+void test_aligned_window_widens_to_byte_boundaries() {
+    assert_window(panel_window_aligned(6, 34, 118, 26), 0, 34, 128, 26);    // INSIDE_TEMP
+    assert_window(panel_window_aligned(100, 2, 50, 14), 96, 2, 56, 14);     // HEADER_TIME_CENTER
+    assert_window(panel_window_aligned(168, 90, 30, 32), 168, 90, 32, 32);  // WEATHER_ICON
+}
+
+void test_adjacent_rects_merge_without_limit_pressure() {
+    // Inside temp, inside RH and the clock: temp and RH share an edge
+    PanelWindow wins[3] = {
+        panel_window_aligned(6, 34, 118, 26),
+        panel_window_aligned(6, 60, 118, 10),
+        panel_window_aligned(100, 2, 50, 14),
+    };
+    size_t n = panel_windows_coalesce(wins, 3, 2);
+    TEST_ASSERT_EQUAL(2, n);
+    assert_window(wins[0], 0, 34, 128, 36);
+    assert_window(wins[1], 96, 2, 56, 14);
+}
+
+void test_limit_merges_cheapest_pair() {
+    PanelWindow wins[3] = { {0, 0, 8, 8}, {16, 0, 8, 8}, {200, 100, 8, 8} };
+    size_t n = panel_windows_coalesce(wins, 3, 2);
+    TEST_ASSERT_EQUAL(2, n);
+    assert_window(wins[0], 0, 0, 24, 8);
+    assert_window(wins[1], 200, 100, 8, 8);
+}
+
+void test_forced_merge_absorbs_newly_touching_window() {
+    // Merging the cheapest pair creates a window adjacent to the third
+    PanelWindow wins[3] = { {0, 0, 8, 8}, {32, 0, 8, 8}, {16, 8, 8, 8} };
+    size_t n = panel_windows_coalesce(wins, 3, 2);
+    TEST_ASSERT_EQUAL(1, n);
+    assert_window(wins[0], 0, 0, 40, 16);
+}
+
+void test_single_window_limit_gives_bounding_box() {
+    PanelWindow wins[2] = { {0, 0, 8, 8}, {240, 112, 8, 8} };
+    size_t n = panel_windows_coalesce(wins, 2, 1);
+    TEST_ASSERT_EQUAL(1, n);
+    assert_window(wins[0], 0, 0, 248, 120);
+}
+
+void test_no_windows() {
+    PanelWindow wins[1];
+    TEST_ASSERT_EQUAL(0, panel_windows_coalesce(wins, 0, 2));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_aligned_window_widens_to_byte_boundaries);
+    RUN_TEST(test_adjacent_rects_merge_without_limit_pressure);
+    RUN_TEST(test_limit_merges_cheapest_pair);
+    RUN_TEST(test_forced_merge_absorbs_newly_touching_window);
+    RUN_TEST(test_single_window_limit_gives_bounding_box);
+    RUN_TEST(test_no_windows);
+    return UNITY_END();
+}
@@ -0,0 +1,156 @@
+// Unit tests for profiling stats: histogram buckets, percentiles, registry
+// and the cross-wake RTC aggregate
+
+#include <unity.h>
+#include <cstdio>
+#include "../../src/perf_stats.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_buckets_are_monotonic_and_bounded() {
+    size_t prev = 0;
+    for (uint32_t us = 0; us < 100000; us++) {
+        size_t b = perf_hist_bucket(us);
+        TEST_ASSERT_TRUE(b >= prev);
+        TEST_ASSERT_TRUE(b < PERF_HIST_BUCKETS);
+        TEST_ASSERT_TRUE(us >= perf_hist_lower(b));
+        TEST_ASSERT_TRUE(us < perf_hist_lower(b) + perf_hist_width(b));
+        prev = b;
+    }
+    TEST_ASSERT_EQUAL(PERF_HIST_BUCKETS - 1, perf_hist_bucket(UINT32_MAX));
+}
+
+void test_bucket_relative_error() {
+    for (uint32_t us = 8; us < PERF_HIST_MAX_US; us = us * 3 / 2 + 1) {
+        size_t b = perf_hist_bucket(us);
+        // Width is at most a quarter of the bucket's lower bound
+        TEST_ASSERT_TRUE(perf_hist_width(b) * PERF_HIST_SUB <= perf_hist_lower(b));
+    }
+}
+
+void test_percentiles_expose_tail() {
+    static PerfStats s;
+    s.name = "wifi";
+    s.reset();
+    // 98 fast wakes around 1.2 s, two at 8 s
+    for (int i = 0; i < 98; i++) s.record(1200000);
+    s.record(8000000);
+    s.record(8000000);
+
+    TEST_ASSERT_EQUAL(100, s.count);
+    uint32_t p50 = s.percentile(50);
+    uint32_t p99 = s.percentile(99);
+    TEST_ASSERT_TRUE(p50 > 1000000 && p50 < 1400000);
+    TEST_ASSERT_TRUE(p99 > 7000000 && p99 <= 8000000);
+    TEST_ASSERT_EQUAL(8000000, s.percentile(100));
+    TEST_ASSERT_EQUAL(1200000, s.min_us);
+}
+
+void test_percentile_empty_and_single() {
+    static PerfStats s;
+    s.reset();
+    TEST_ASSERT_EQUAL(0, s.percentile(50));
+    s.record(3);
+    TEST_ASSERT_EQUAL(3, s.percentile(1));
+    TEST_ASSERT_EQUAL(3, s.percentile(99));
+}
+
+void test_registry_reuses_slot_by_content() {
+    static PerfRegistry<8> reg;
+    reg.clear();
+    char dynamic_name[] = "mqtt_connect";
+    PerfStats* a = reg.get("mqtt_connect");
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_EQUAL_PTR(a, reg.get("mqtt_connect"));
+    TEST_ASSERT_EQUAL_PTR(a, reg.get(dynamic_name));
+    TEST_ASSERT_EQUAL(1, reg.size());
+}
+
+void test_registry_full_returns_null() {
+    static PerfRegistry<4> reg;
+    static const char* names[] = {"a", "b", "c", "d", "e"};
+    reg.clear();
+    for (int i = 0; i < 4; i++) TEST_ASSERT_NOT_NULL(reg.get(names[i]));
+    TEST_ASSERT_NULL(reg.get(names[4]));
+    for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_STRING(names[i], reg.get(names[i])->name);
+}
+
+void test_registry_reset_keeps_names() {
+    static PerfRegistry<4> reg;
+    reg.clear();
+    PerfStats* s = reg.get("display");
+    s->record(500);
+    reg.reset();
+    TEST_ASSERT_EQUAL(0, s->count);
+    TEST_ASSERT_EQUAL_STRING("display", s->name);
+    TEST_ASSERT_EQUAL_PTR(s, reg.get("display"));
+}
+
+void test_rtc_merge_accumulates_across_wakes() {
+    static PerfRtcTable<4> history;
+    memset(&history, 0, sizeof(history));
+    perf_rtc_validate(history);
+    TEST_ASSERT_EQUAL_UINT32(PERF_RTC_MAGIC, history.magic);
+
+    static PerfStats wake;
+    wake.name = "wifi_connect_backoff";
+    // 99 wakes at ~1.5 s, one at 8 s
+    for (int w = 0; w < 100; w++) {
+        wake.reset();
+        wake.record(w == 57 ? 8000000 : 1500000);
+        TEST_ASSERT_TRUE(perf_rtc_merge(history, wake));
+    }
+
+    const PerfRtcStat& s = history.stats[0];
+    TEST_ASSERT_EQUAL(100, s.count);
+    TEST_ASSERT_EQUAL_STRING("wifi_connect_backof", s.name);  // Truncated copy
+    TEST_ASSERT_EQUAL(1500000, s.min_us);
+    TEST_ASSERT_EQUAL(8000000, s.max_us);
+    TEST_ASSERT_TRUE(s.total_us == 99ull * 1500000 + 8000000);
+    uint32_t p50 = perf_rtc_percentile(s, 50);
+    TEST_ASSERT_TRUE(p50 >= 1048576 && p50 < 2097152);
+    TEST_ASSERT_TRUE(perf_rtc_percentile(s, 100) == 8000000);
+    TEST_ASSERT_EQUAL(0, history.stats[1].hash);
+}
+
+void test_rtc_table_full_counts_drops() {
+    static PerfRtcTable<2> history;
+    perf_rtc_reset(history);
+    static const char* names[] = {"a", "b", "c"};
+    static PerfStats s;
+    for (int i = 0; i < 3; i++) {
+        s.name = names[i];
+        s.reset();
+        s.record(10);
+        perf_rtc_merge(history, s);
+    }
+    TEST_ASSERT_EQUAL(1, history.dropped);
+    // Stats with no samples this wake are skipped, not counted as drops
+    s.reset();
+    TEST_ASSERT_TRUE(perf_rtc_merge(history, s));
+    TEST_ASSERT_EQUAL(1, history.dropped);
+}
+
+void test_rtc_compact_buckets_cover_fine_buckets() {
+    for (size_t b = 0; b < PERF_HIST_BUCKETS; b++) {
+        size_t c = b / PERF_HIST_SUB;
+        TEST_ASSERT_TRUE(perf_hist_lower(b) >= perf_rtc_lower(c));
+        TEST_ASSERT_TRUE(perf_hist_lower(b) + perf_hist_width(b) <= perf_rtc_lower(c + 1));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_buckets_are_monotonic_and_bounded);
+    RUN_TEST(test_bucket_relative_error);
+    RUN_TEST(test_percentiles_expose_tail);
+    RUN_TEST(test_percentile_empty_and_single);
+    RUN_TEST(test_registry_reuses_slot_by_content);
+    RUN_TEST(test_registry_full_returns_null);
+    RUN_TEST(test_registry_reset_keeps_names);
+    RUN_TEST(test_rtc_merge_accumulates_across_wakes);
+    RUN_TEST(test_rtc_table_full_counts_drops);
+    RUN_TEST(test_rtc_compact_buckets_cover_fine_buckets);
+    return UNITY_END();
+}
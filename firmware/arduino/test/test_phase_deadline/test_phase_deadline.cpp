@@ -0,0 +1,81 @@
+// Unit tests for the per-phase deadline supervisor (budgets, clamping, degrade)
+
+#include <unity.h>
+#include "../../src/phase_deadline.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_phase_within_budget_is_not_an_overrun() {
+    PhaseDeadline d;
+    phase_deadline_begin(d, 1000, 20000);
+    phase_deadline_enter(d, WakePhase::CONNECT, 10000, 1200);
+    TEST_ASSERT_EQUAL_UINT32(6000, phase_deadline_remaining(d, 5200));
+    TEST_ASSERT_FALSE(phase_deadline_check(d, 5200));
+    TEST_ASSERT_FALSE(phase_deadline_degraded(d));
+}
+
+void test_phase_overrun_degrades_and_counts_once() {
+    PhaseDeadline d;
+    phase_deadline_begin(d, 0, 20000);
+    phase_deadline_enter(d, WakePhase::CONNECT, 10000, 300);
+    TEST_ASSERT_TRUE(phase_deadline_check(d, 10300));
+    TEST_ASSERT_TRUE(phase_deadline_degraded(d));
+    TEST_ASSERT_FALSE(phase_deadline_check(d, 10500));   // Same phase, already counted
+    TEST_ASSERT_EQUAL_UINT8(1u << (uint8_t)WakePhase::CONNECT, d.overrun_mask);
+}
+
+void test_wake_budget_caps_a_phase() {
+    PhaseDeadline d;
+    phase_deadline_begin(d, 0, 12000);
+    phase_deadline_enter(d, WakePhase::DISPLAY, 8000, 9000);
+    TEST_ASSERT_EQUAL_UINT32(3000, phase_deadline_remaining(d, 9000));
+    TEST_ASSERT_TRUE(phase_deadline_check(d, 12000));
+}
+
+void test_clamp_cuts_waits_to_the_deadline() {
+    PhaseDeadline d;
+    phase_deadline_begin(d, 0, 20000);
+    phase_deadline_enter(d, WakePhase::NETWORK, 4000, 1000);
+    TEST_ASSERT_EQUAL_UINT32(2000, phase_deadline_clamp(d, 2000, 1500));
+    TEST_ASSERT_EQUAL_UINT32(500, phase_deadline_clamp(d, 2000, 4500));
+    TEST_ASSERT_EQUAL_UINT32(0, phase_deadline_clamp(d, 2000, 6000));
+}
+
+void test_zero_budgets_are_unbounded() {
+    PhaseDeadline d;
+    phase_deadline_begin(d, 0, 0);
+    phase_deadline_enter(d, WakePhase::DEFERRED, 0, 0);
+    TEST_ASSERT_EQUAL_UINT32(PHASE_DEADLINE_UNBOUNDED, phase_deadline_remaining(d, 600000));
+    TEST_ASSERT_FALSE(phase_deadline_check(d, 600000));
+}
+
+void test_millis_wrap_is_handled() {
+    PhaseDeadline d;
+    phase_deadline_begin(d, 0xFFFFF000u, 20000);
+    phase_deadline_enter(d, WakePhase::SENSOR, 300, 0xFFFFFF00u);
+    TEST_ASSERT_EQUAL_UINT32(44, phase_deadline_remaining(d, 0x00000000u));
+    TEST_ASSERT_TRUE(phase_deadline_check(d, 0x00000100u));
+}
+
+void test_each_phase_counts_its_own_overrun() {
+    PhaseDeadline d;
+    phase_deadline_begin(d, 0, 5000);
+    phase_deadline_enter(d, WakePhase::NETWORK, 1000, 0);
+    TEST_ASSERT_TRUE(phase_deadline_check(d, 6000));
+    phase_deadline_enter(d, WakePhase::DEFERRED, 1000, 6000);
+    TEST_ASSERT_TRUE(phase_deadline_check(d, 6000));     // Wake budget already spent
+    TEST_ASSERT_EQUAL_STRING("deferred", wake_phase_name(d.phase));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_phase_within_budget_is_not_an_overrun);
+    RUN_TEST(test_phase_overrun_degrades_and_counts_once);
+    RUN_TEST(test_wake_budget_caps_a_phase);
+    RUN_TEST(test_clamp_cuts_waits_to_the_deadline);
+    RUN_TEST(test_zero_budgets_are_unbounded);
+    RUN_TEST(test_millis_wrap_is_handled);
+    RUN_TEST(test_each_phase_counts_its_own_overrun);
+    return UNITY_END();
+}
@@ -0,0 +1,91 @@
+// Unit tests for the skip-network publish policy
+// Tests deadband, heartbeat and validity-change decisions
+
+#include <unity.h>
+#include <cmath>
+#include "../../src/publish_policy.h"
+
+static PublishPolicy make_policy() {
+    PublishPolicy p;
+    p.temp_deadband_c = 0.2f;
+    p.rh_deadband_pct = 1.0f;
+    p.press_deadband_hpa = 0.5f;
+    p.heartbeat_sec = 1800;
+    return p;
+}
+
+static const PublishSnapshot kBase = { 21.0f, 45.0f, 1013.0f };
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_no_baseline_publishes() {
+    PublishSnapshot none = { NAN, NAN, NAN };
+    TEST_ASSERT_EQUAL(PublishDecision::NO_BASELINE,
+                      evaluate_publish_policy(make_policy(), none, kBase, 0));
+}
+
+void test_within_deadband_skips() {
+    PublishSnapshot now = { 21.1f, 45.5f, 1013.3f };
+    TEST_ASSERT_EQUAL(PublishDecision::SKIP,
+                      evaluate_publish_policy(make_policy(), kBase, now, 600));
+}
+
+void test_temperature_change_publishes() {
+    PublishSnapshot now = { 20.7f, 45.0f, 1013.0f };
+    TEST_ASSERT_EQUAL(PublishDecision::CHANGED,
+                      evaluate_publish_policy(make_policy(), kBase, now, 600));
+}
+
+void test_humidity_change_publishes() {
+    PublishSnapshot now = { 21.0f, 46.5f, 1013.0f };
+    TEST_ASSERT_EQUAL(PublishDecision::CHANGED,
+                      evaluate_publish_policy(make_policy(), kBase, now, 600));
+}
+
+void test_pressure_change_publishes() {
+    PublishSnapshot now = { 21.0f, 45.0f, 1012.0f };
+    TEST_ASSERT_EQUAL(PublishDecision::CHANGED,
+                      evaluate_publish_policy(make_policy(), kBase, now, 600));
+}
+
+void test_heartbeat_forces_publish() {
+    TEST_ASSERT_EQUAL(PublishDecision::HEARTBEAT,
+                      evaluate_publish_policy(make_policy(), kBase, kBase, 1800));
+}
+
+void test_sensor_dropout_publishes() {
+    PublishSnapshot now = { 21.0f, 45.0f, NAN };
+    TEST_ASSERT_EQUAL(PublishDecision::CHANGED,
+                      evaluate_publish_policy(make_policy(), kBase, now, 600));
+}
+
+void test_both_invalid_metric_ignored() {
+    PublishSnapshot last = { 21.0f, 45.0f, NAN };
+    PublishSnapshot now = { 21.0f, 45.0f, NAN };
+    TEST_ASSERT_EQUAL(PublishDecision::SKIP,
+                      evaluate_publish_policy(make_policy(), last, now, 600));
+}
+
+void test_store_forward_waits_for_nth_wake() {
+    TEST_ASSERT_TRUE(store_forward_skip(PublishDecision::SKIP, 1, 4));
+    TEST_ASSERT_TRUE(store_forward_skip(PublishDecision::HEARTBEAT, 3, 4));
+    TEST_ASSERT_FALSE(store_forward_skip(PublishDecision::SKIP, 4, 4));
+    // Leaving the deadband (or losing the baseline) brings the radio up early
+    TEST_ASSERT_FALSE(store_forward_skip(PublishDecision::CHANGED, 1, 4));
+    TEST_ASSERT_FALSE(store_forward_skip(PublishDecision::NO_BASELINE, 1, 4));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_baseline_publishes);
+    RUN_TEST(test_within_deadband_skips);
+    RUN_TEST(test_temperature_change_publishes);
+    RUN_TEST(test_humidity_change_publishes);
+    RUN_TEST(test_pressure_change_publishes);
+    RUN_TEST(test_heartbeat_forces_publish);
+    RUN_TEST(test_sensor_dropout_publishes);
+    RUN_TEST(test_both_invalid_metric_ignored);
+    RUN_TEST(test_store_forward_waits_for_nth_wake);
+    return UNITY_END();
+}
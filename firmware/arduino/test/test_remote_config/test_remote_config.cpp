@@ -0,0 +1,138 @@
+// Unit tests for the retained fleet config: the cheap version peek that
+// decides whether to parse, field sanitising and how overrides fall back to
+// the firmware defaults
+
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+#include "../../src/remote_config.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static bool peek(const char* s, uint32_t& v) {
+    return remote_config_peek_version(s, strlen(s), v);
+}
+
+static RemoteConfig empty_config() {
+    RemoteConfig c;
+    memset(&c, 0, sizeof(c));
+    return c;
+}
+
+void test_peek_finds_top_level_version() {
+    uint32_t v = 0;
+    TEST_ASSERT_TRUE(peek("{\"v\":7,\"sleep\":{\"normal\":300}}", v));
+    TEST_ASSERT_EQUAL_UINT32(7, v);
+    TEST_ASSERT_TRUE(peek("{ \"sleep\" : {\"v\":1}, \"v\" : 42 }", v));
+    TEST_ASSERT_EQUAL_UINT32(42, v);
+    TEST_ASSERT_TRUE(peek("{\"name\":\"v\",\"note\":\"\\\"v\\\":3\",\"v\":9}", v));
+    TEST_ASSERT_EQUAL_UINT32(9, v);
+}
+
+void test_peek_rejects_missing_or_bad_version() {
+    uint32_t v = 0;
+    TEST_ASSERT_FALSE(peek("{\"sleep\":{\"v\":3}}", v));
+    TEST_ASSERT_FALSE(peek("{\"v\":0}", v));
+    TEST_ASSERT_FALSE(peek("{\"v\":-1}", v));
+    TEST_ASSERT_FALSE(peek("{\"v\":1.5}", v));
+    TEST_ASSERT_FALSE(peek("{\"v\":\"3\"}", v));
+    TEST_ASSERT_FALSE(peek("{\"v\":99999999999}", v));
+    TEST_ASSERT_FALSE(peek("", v));
+}
+
+void test_sanitize_drops_out_of_range_fields() {
+    RemoteConfig c = empty_config();
+    c.normal_interval_sec = 30;          // Below the floor
+    c.max_interval_sec = 7200;
+    c.heartbeat_sec = 100000;            // Above a day
+    c.temp_deadband_c = -1.0f;
+    c.rh_deadband_pct = NAN;
+    c.press_deadband_hpa = 0.8f;
+    c.low_battery_threshold = 10;
+    c.critical_battery_threshold = 15;   // Would hide the low tier
+    c.features_set = RCFG_FEATURE_ULP;
+    c.features_on = RCFG_FEATURE_ULP | RCFG_FEATURE_PARTIAL_REFRESH;
+    remote_config_sanitize(c);
+
+    TEST_ASSERT_EQUAL_UINT32(0, c.normal_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(7200, c.max_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(0, c.heartbeat_sec);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.temp_deadband_c);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.rh_deadband_pct);
+    TEST_ASSERT_EQUAL_FLOAT(0.8f, c.press_deadband_hpa);
+    TEST_ASSERT_EQUAL_UINT32(0, c.low_battery_threshold);
+    TEST_ASSERT_EQUAL_UINT32(0, c.critical_battery_threshold);
+    TEST_ASSERT_EQUAL_UINT32(RCFG_FEATURE_ULP, c.features_on);
+}
+
+void test_sanitize_drops_unordered_interval_pairs() {
+    RemoteConfig c = empty_config();
+    c.normal_interval_sec = 900;
+    c.max_interval_sec = 600;            // Below normal
+    c.low_battery_interval_sec = 1200;
+    remote_config_sanitize(c);
+    TEST_ASSERT_EQUAL_UINT32(0, c.normal_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(0, c.max_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(1200, c.low_battery_interval_sec);
+
+    c = empty_config();
+    c.rapid_update_interval_sec = 600;   // Above normal
+    c.normal_interval_sec = 300;
+    c.max_interval_sec = 3600;
+    remote_config_sanitize(c);
+    TEST_ASSERT_EQUAL_UINT32(0, c.rapid_update_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(0, c.normal_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(3600, c.max_interval_sec);
+
+    c = empty_config();
+    c.rapid_update_interval_sec = 60;
+    c.normal_interval_sec = 300;
+    c.critical_interval_sec = 1800;
+    c.max_interval_sec = 3600;
+    remote_config_sanitize(c);
+    TEST_ASSERT_EQUAL_UINT32(60, c.rapid_update_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(300, c.normal_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(1800, c.critical_interval_sec);
+    TEST_ASSERT_EQUAL_UINT32(3600, c.max_interval_sec);
+}
+
+void test_policy_overrides_fall_back_to_defaults() {
+    PublishPolicy p = default_publish_policy();
+    RemoteConfig c = empty_config();
+    remote_config_apply_policy(c, p);
+    TEST_ASSERT_EQUAL_FLOAT(SKIP_NET_TEMP_DEADBAND_C, p.temp_deadband_c);
+    TEST_ASSERT_EQUAL_UINT32(SKIP_NET_HEARTBEAT_SEC, p.heartbeat_sec);
+
+    c.temp_deadband_c = 0.5f;
+    c.heartbeat_sec = 1800;
+    remote_config_apply_policy(c, p);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, p.temp_deadband_c);
+    TEST_ASSERT_EQUAL_FLOAT(SKIP_NET_RH_DEADBAND_PCT, p.rh_deadband_pct);
+    TEST_ASSERT_EQUAL_UINT32(1800, p.heartbeat_sec);
+    TEST_ASSERT_EQUAL_UINT32(600, remote_config_u32(0, 600));
+}
+
+void test_feature_toggles_only_switch_compiled_features() {
+    RemoteConfig c = empty_config();
+    TEST_ASSERT_TRUE(remote_config_feature(c, RCFG_FEATURE_ULP, true));
+    TEST_ASSERT_FALSE(remote_config_feature(c, RCFG_FEATURE_ULP, false));
+
+    c.features_set = RCFG_FEATURE_ULP | RCFG_FEATURE_PARTIAL_REFRESH;
+    c.features_on = RCFG_FEATURE_PARTIAL_REFRESH;
+    TEST_ASSERT_FALSE(remote_config_feature(c, RCFG_FEATURE_ULP, true));
+    TEST_ASSERT_TRUE(remote_config_feature(c, RCFG_FEATURE_PARTIAL_REFRESH, true));
+    TEST_ASSERT_FALSE(remote_config_feature(c, RCFG_FEATURE_PARTIAL_REFRESH, false));
+    TEST_ASSERT_TRUE(remote_config_feature(c, RCFG_FEATURE_COMPACT_TELEMETRY, true));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_peek_finds_top_level_version);
+    RUN_TEST(test_peek_rejects_missing_or_bad_version);
+    RUN_TEST(test_sanitize_drops_out_of_range_fields);
+    RUN_TEST(test_sanitize_drops_unordered_interval_pairs);
+    RUN_TEST(test_policy_overrides_fall_back_to_defaults);
+    RUN_TEST(test_feature_toggles_only_switch_compiled_features);
+    return UNITY_END();
+}
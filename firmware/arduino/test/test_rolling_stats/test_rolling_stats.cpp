@@ -0,0 +1,129 @@
+#include <unity.h>
+#include <cmath>
+#include "../../src/rolling_stats.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint32_t kT0 = 1730000000;   // Slot-aligned below
+static const uint32_t kSpan = 600;
+
+static uint32_t aligned(uint32_t t) { return t - t % kSpan; }
+
+void test_empty_window_has_no_summary(void) {
+    RollingWindow<ROLLING_SHORT_BUCKETS> w;
+    rolling_reset(w, kSpan);
+    RollingSummary s;
+    TEST_ASSERT_FALSE(rolling_summary(w, kT0, ROLL_TEMP, s));
+}
+
+void test_min_max_mean_within_one_bucket(void) {
+    RollingWindow<ROLLING_SHORT_BUCKETS> w;
+    rolling_reset(w, kSpan);
+    uint32_t t = aligned(kT0);
+    rolling_push(w, t, kSpan, 20.0f, 40.0f, 1010.0f);
+    rolling_push(w, t + 60, kSpan, 22.0f, 44.0f, 1012.0f);
+    rolling_push(w, t + 120, kSpan, 21.0f, 42.0f, NAN);
+    RollingSummary s;
+    TEST_ASSERT_TRUE(rolling_summary(w, t + 180, ROLL_TEMP, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, s.lo);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 22.0f, s.hi);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 21.0f, s.mean);
+    TEST_ASSERT_EQUAL_UINT16(3, s.n);
+    TEST_ASSERT_TRUE(rolling_summary(w, t + 180, ROLL_PRESS, s));
+    TEST_ASSERT_EQUAL_UINT16(2, s.n);          // NaN pressure skipped
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1011.0f, s.mean);
+}
+
+void test_old_buckets_leave_the_window(void) {
+    RollingWindow<ROLLING_SHORT_BUCKETS> w;
+    rolling_reset(w, kSpan);
+    uint32_t t = aligned(kT0);
+    rolling_push(w, t, kSpan, 30.0f, 50.0f, 1000.0f);               // Slot 0
+    rolling_push(w, t + 3 * kSpan, kSpan, 20.0f, 50.0f, 1000.0f);   // Slot 3
+    RollingSummary s;
+    TEST_ASSERT_TRUE(rolling_summary(w, t + 3 * kSpan, ROLL_TEMP, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, s.hi);
+    // Six slots later the first sample is out, the second still in
+    TEST_ASSERT_TRUE(rolling_summary(w, t + 6 * kSpan, ROLL_TEMP, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, s.hi);
+    TEST_ASSERT_EQUAL_UINT16(1, s.n);
+    // Asked long after the last sample: nothing left
+    TEST_ASSERT_FALSE(rolling_summary(w, t + 9 * kSpan, ROLL_TEMP, s));
+}
+
+void test_skipped_buckets_are_cleared_on_wrap(void) {
+    RollingWindow<ROLLING_SHORT_BUCKETS> w;
+    rolling_reset(w, kSpan);
+    uint32_t t = aligned(kT0);
+    for (uint32_t i = 0; i < ROLLING_SHORT_BUCKETS; i++) {
+        rolling_push(w, t + i * kSpan, kSpan, 10.0f + i, 50.0f, 1000.0f);
+    }
+    // Jump two slots past the end: the two oldest buckets are reused
+    uint32_t t2 = t + (ROLLING_SHORT_BUCKETS + 1) * kSpan;
+    rolling_push(w, t2, kSpan, 5.0f, 50.0f, 1000.0f);
+    RollingSummary s;
+    TEST_ASSERT_TRUE(rolling_summary(w, t2, ROLL_TEMP, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, s.lo);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, s.hi);
+    TEST_ASSERT_EQUAL_UINT16(ROLLING_SHORT_BUCKETS - 2 + 1, s.n);   // Slots 2..5 and the new one
+}
+
+void test_gap_longer_than_window_restarts(void) {
+    RollingWindow<ROLLING_SHORT_BUCKETS> w;
+    rolling_reset(w, kSpan);
+    uint32_t t = aligned(kT0);
+    rolling_push(w, t, kSpan, 30.0f, 50.0f, 1000.0f);
+    uint32_t t2 = t + 100 * kSpan;
+    rolling_push(w, t2, kSpan, 20.0f, 50.0f, 1000.0f);
+    RollingSummary s;
+    TEST_ASSERT_TRUE(rolling_summary(w, t2, ROLL_TEMP, s));
+    TEST_ASSERT_EQUAL_UINT16(1, s.n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, s.hi);
+}
+
+void test_clock_step_back_lands_in_older_bucket(void) {
+    RollingWindow<ROLLING_SHORT_BUCKETS> w;
+    rolling_reset(w, kSpan);
+    uint32_t t = aligned(kT0);
+    rolling_push(w, t + 2 * kSpan, kSpan, 20.0f, 50.0f, 1000.0f);
+    rolling_push(w, t + kSpan, kSpan, 25.0f, 50.0f, 1000.0f);        // One slot back
+    rolling_push(w, t - 10 * kSpan, kSpan, 99.0f, 50.0f, 1000.0f);   // Beyond the window: dropped
+    RollingSummary s;
+    TEST_ASSERT_TRUE(rolling_summary(w, t + 2 * kSpan, ROLL_TEMP, s));
+    TEST_ASSERT_EQUAL_UINT16(2, s.n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, s.hi);
+}
+
+void test_span_change_restarts(void) {
+    RollingWindow<ROLLING_LONG_BUCKETS> w;
+    rolling_reset(w, 3600);
+    rolling_push(w, kT0, 3600, 20.0f, 50.0f, 1000.0f);
+    rolling_push(w, kT0 + 1, 1800, 21.0f, 50.0f, 1000.0f);
+    RollingSummary s;
+    TEST_ASSERT_TRUE(rolling_summary(w, kT0 + 1, ROLL_TEMP, s));
+    TEST_ASSERT_EQUAL_UINT16(1, s.n);
+    TEST_ASSERT_EQUAL_UINT32(1800, w.span_sec);
+}
+
+void test_out_of_range_values_skipped(void) {
+    RollingWindow<ROLLING_SHORT_BUCKETS> w;
+    rolling_reset(w, kSpan);
+    rolling_push(w, kT0, kSpan, 400.0f, 50.0f, 1000.0f);   // 40000 centi-degrees: no int16
+    RollingSummary s;
+    TEST_ASSERT_FALSE(rolling_summary(w, kT0, ROLL_TEMP, s));
+    TEST_ASSERT_TRUE(rolling_summary(w, kT0, ROLL_RH, s));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_window_has_no_summary);
+    RUN_TEST(test_min_max_mean_within_one_bucket);
+    RUN_TEST(test_old_buckets_leave_the_window);
+    RUN_TEST(test_skipped_buckets_are_cleared_on_wrap);
+    RUN_TEST(test_gap_longer_than_window_restarts);
+    RUN_TEST(test_clock_step_back_lands_in_older_bucket);
+    RUN_TEST(test_span_change_restarts);
+    RUN_TEST(test_out_of_range_values_skipped);
+    return UNITY_END();
+}
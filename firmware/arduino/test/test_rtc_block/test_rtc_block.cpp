@@ -0,0 +1,72 @@
+// Unit tests for the sealed RTC block: seal/check round trip, corruption,
+// layout and firmware-change invalidation, warm resets
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/rtc_block.h"
+
+struct TestState {
+    RtcBlockHeader header;
+    uint32_t wake_count;
+    float last_temp;
+};
+
+static uint32_t test_crc(const uint8_t* data, size_t len) {
+    uint32_t h = 2166136261u;                       // FNV-1a
+    for (size_t i = 0; i < len; i++) h = (h ^ data[i]) * 16777619u;
+    return h;
+}
+
+static TestState s;
+
+static RtcBlockStatus check(bool deep_sleep, uint16_t version = 1, uint32_t image = 0xABCD) {
+    return rtc_block_check(s.header, &s, sizeof(s), version, image, deep_sleep, test_crc);
+}
+
+void setUp(void) {
+    memset(&s, 0, sizeof(s));
+    rtc_block_init(s.header, sizeof(s), 1, 0xABCD);
+    s.wake_count = 7;
+    s.last_temp = 21.5f;
+    rtc_block_seal(s.header, &s, sizeof(s), test_crc);
+}
+void tearDown(void) {}
+
+void test_sealed_block_is_valid() {
+    TEST_ASSERT_EQUAL(RTC_BLOCK_VALID, check(true));
+    TEST_ASSERT_TRUE(rtc_block_usable(check(true)));
+}
+
+void test_body_change_after_seal_is_corrupt() {
+    s.wake_count++;
+    TEST_ASSERT_EQUAL(RTC_BLOCK_CORRUPT, check(true));
+    TEST_ASSERT_FALSE(rtc_block_usable(RTC_BLOCK_CORRUPT));
+    rtc_block_seal(s.header, &s, sizeof(s), test_crc);
+    TEST_ASSERT_EQUAL(RTC_BLOCK_VALID, check(true));
+}
+
+void test_warm_reset_skips_crc() {
+    s.wake_count++;                                 // Mid-wake, not sealed
+    TEST_ASSERT_EQUAL(RTC_BLOCK_UNSEALED, check(false));
+    TEST_ASSERT_TRUE(rtc_block_usable(RTC_BLOCK_UNSEALED));
+}
+
+void test_header_mismatches() {
+    TEST_ASSERT_EQUAL(RTC_BLOCK_LAYOUT, check(true, 2));
+    TEST_ASSERT_EQUAL(RTC_BLOCK_IMAGE, check(true, 1, 0x1234));
+    TEST_ASSERT_EQUAL(RTC_BLOCK_IMAGE, check(false, 1, 0x1234));  // Warm reset into new firmware
+    s.header.size = 4;
+    TEST_ASSERT_EQUAL(RTC_BLOCK_LAYOUT, check(true));
+    memset(&s, 0, sizeof(s));
+    TEST_ASSERT_EQUAL(RTC_BLOCK_EMPTY, check(true));
+    TEST_ASSERT_EQUAL_STRING("empty", rtc_block_status_name(RTC_BLOCK_EMPTY));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sealed_block_is_valid);
+    RUN_TEST(test_body_change_after_seal_is_corrupt);
+    RUN_TEST(test_warm_reset_skips_crc);
+    RUN_TEST(test_header_mismatches);
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+// Unit tests for the parallel sensor scheduler: all conversions start
+// together, results are collected earliest-due first, slow conversions stay
+// pending across collects, and failures send a driver back through begin()
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/sensor_scheduler.h"
+
+class FakeDriver : public SensorDriver {
+public:
+    FakeDriver(const char* name, uint32_t conv_us, float temp)
+        : name_(name), conv_us_(conv_us), temp_(temp) {}
+
+    const char* name() const override { return name_; }
+    bool begin() override { begins++; return present; }
+    bool startConversion() override { starts++; return start_ok; }
+    uint32_t conversionTimeUs() const override { return conv_us_; }
+    bool readResult(InsideReadings& out) override {
+        reads++;
+        if (!read_ok) return false;
+        out.temperatureC = temp_;
+        return true;
+    }
+
+    bool present = true;
+    bool start_ok = true;
+    bool read_ok = true;
+    int begins = 0;
+    int starts = 0;
+    int reads = 0;
+
+private:
+    const char* name_;
+    uint32_t conv_us_;
+    float temp_;
+};
+
+static const char* order[8];
+static uint32_t elapsed[8];
+static int reported = 0;
+
+static void report(const char* name, uint32_t us, bool ok) {
+    (void)ok;
+    order[reported] = name;
+    elapsed[reported] = us;
+    reported++;
+}
+
+void setUp(void) { reported = 0; }
+void tearDown(void) {}
+
+void test_collects_in_due_order() {
+    FakeDriver slow("slow", 9000, 1.0f), fast("fast", 2000, 2.0f);
+    SensorScheduler s;
+    s.add(&slow);
+    s.add(&fast);
+    TEST_ASSERT_EQUAL_UINT32(2, s.beginAll());
+    TEST_ASSERT_EQUAL_UINT32(2, s.startAll(1000));
+    uint32_t due = 0;
+    TEST_ASSERT_TRUE(s.nextDue(due));
+    TEST_ASSERT_EQUAL_UINT32(3000, due);
+
+    InsideReadings r;
+    TEST_ASSERT_EQUAL_UINT32(0, s.collect(2999, r, report));
+    TEST_ASSERT_EQUAL_UINT32(2, s.collect(20000, r, report));
+    TEST_ASSERT_EQUAL_STRING("fast", order[0]);
+    TEST_ASSERT_EQUAL_STRING("slow", order[1]);
+    TEST_ASSERT_EQUAL_UINT32(19000, elapsed[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, r.temperatureC);   // Last one read wins
+    TEST_ASSERT_FALSE(s.nextDue(due));
+}
+
+void test_slow_conversion_stays_pending() {
+    FakeDriver bme("bme", 10000, 21.0f), co2("co2", 5000000, 0.0f);
+    SensorScheduler s;
+    s.add(&bme);
+    s.add(&co2);
+    s.beginAll();
+    s.startAll(0);
+    InsideReadings r;
+    TEST_ASSERT_EQUAL_UINT32(1, s.collect(10000, r, report));
+    TEST_ASSERT_EQUAL_UINT32(1, s.pending());
+
+    // Next phase: only the idle driver restarts
+    TEST_ASSERT_EQUAL_UINT32(1, s.startAll(20000));
+    TEST_ASSERT_EQUAL_INT(1, co2.starts);
+    TEST_ASSERT_EQUAL_INT(2, bme.starts);
+    TEST_ASSERT_EQUAL_UINT32(2, s.collect(5000000, r, report));
+    TEST_ASSERT_EQUAL_STRING("co2", order[2]);
+    TEST_ASSERT_EQUAL_UINT32(5000000, elapsed[2]);
+}
+
+void test_failure_requires_begin_again() {
+    FakeDriver a("a", 100, 1.0f), b("b", 100, 2.0f);
+    SensorScheduler s;
+    s.add(&a);
+    s.add(&b);
+    b.present = false;
+    TEST_ASSERT_EQUAL_UINT32(1, s.beginAll());
+    TEST_ASSERT_EQUAL_UINT32(1, s.startAll(0));
+
+    a.read_ok = false;
+    InsideReadings r;
+    s.collect(100, r, report);
+    TEST_ASSERT_EQUAL_UINT32(0, s.ready());
+    TEST_ASSERT_EQUAL_UINT32(0, s.startAll(200));
+
+    a.read_ok = true;
+    b.present = true;
+    TEST_ASSERT_EQUAL_UINT32(2, s.beginAll());
+    TEST_ASSERT_EQUAL_INT(2, a.begins);
+    a.start_ok = false;
+    TEST_ASSERT_EQUAL_UINT32(1, s.startAll(300));
+    TEST_ASSERT_EQUAL_UINT32(1, s.ready());
+}
+
+void test_due_times_wrap() {
+    FakeDriver a("a", 2000, 1.0f);
+    SensorScheduler s;
+    s.add(&a);
+    s.beginAll();
+    s.startAll(0xFFFFFC00u);                // Due after the clock wraps
+    InsideReadings r;
+    TEST_ASSERT_EQUAL_UINT32(0, s.collect(0xFFFFFFF0u, r, report));
+    TEST_ASSERT_EQUAL_UINT32(1, s.collect(0x00000400u, r, report));
+    TEST_ASSERT_EQUAL_UINT32(2048, elapsed[0]);
+}
+
+void test_capacity() {
+    FakeDriver d("d", 0, 0.0f);
+    SensorScheduler s;
+    for (size_t i = 0; i < SENSOR_MAX_DRIVERS; i++) TEST_ASSERT_TRUE(s.add(&d));
+    TEST_ASSERT_FALSE(s.add(&d));
+    TEST_ASSERT_FALSE(s.add(nullptr));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_collects_in_due_order);
+    RUN_TEST(test_slow_conversion_stays_pending);
+    RUN_TEST(test_failure_requires_begin_again);
+    RUN_TEST(test_due_times_wrap);
+    RUN_TEST(test_capacity);
+    return UNITY_END();
+}
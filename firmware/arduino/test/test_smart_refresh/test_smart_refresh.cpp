@@ -26,14 +26,13 @@ public:
     static constexpr size_t MAX_REGIONS = 16;
 
     struct RegionState {
-        uint8_t region_id;
         uint32_t content_hash;
         uint32_t last_update_ms;
-        bool dirty;
     };
 
     void reset() {
-        region_count_ = 0;
+        registered_mask_ = 0;
+        dirty_mask_ = 0;
         stats_ = {};
         for (size_t i = 0; i < MAX_REGIONS; i++) {
             regions_[i] = {};
@@ -41,32 +40,38 @@ public:
     }
 
     void registerRegion(uint8_t region_id) {
-        if (findRegion(region_id)) return;
-        if (region_count_ >= MAX_REGIONS) return;
-
-        regions_[region_count_].region_id = region_id;
-        regions_[region_count_].content_hash = 0;
-        regions_[region_count_].last_update_ms = 0;
-        regions_[region_count_].dirty = true;
-        region_count_++;
+        if (region_id >= MAX_REGIONS || isRegistered(region_id)) return;
+
+        regions_[region_id] = {};
+        registered_mask_ |= bit(region_id);
+        dirty_mask_ |= bit(region_id);
     }
 
     bool hasContentChanged(uint8_t region_id, const char* content) {
+        return hasHashChanged(region_id, SmartRefresh::hashString(content));
+    }
+
+    bool hasContentChanged(uint8_t region_id, int32_t value) {
+        return hasHashChanged(region_id, SmartRefresh::hashInt(value));
+    }
+
+    bool hasContentChanged(uint8_t region_id, float value, int decimals = 1) {
+        return hasHashChanged(region_id, SmartRefresh::hashFixed(value, decimals));
+    }
+
+    bool hasHashChanged(uint8_t region_id, uint32_t new_hash) {
         stats_.total_checks++;
 
-        RegionState* region = findRegion(region_id);
-        if (!region) {
+        if (!isRegistered(region_id)) {
             stats_.actual_updates++;
             return true;
         }
 
-        size_t len = content ? strlen(content) : 0;
-        uint32_t new_hash = computeHash(content, len);
-
-        if (new_hash != region->content_hash || region->dirty) {
-            region->content_hash = new_hash;
-            region->last_update_ms = millis();
-            region->dirty = true;
+        RegionState& region = regions_[region_id];
+        if (new_hash != region.content_hash || (dirty_mask_ & bit(region_id))) {
+            region.content_hash = new_hash;
+            region.last_update_ms = millis();
+            dirty_mask_ |= bit(region_id);
             stats_.actual_updates++;
             return true;
         }
@@ -75,53 +80,39 @@ public:
         return false;
     }
 
-    bool hasContentChanged(uint8_t region_id, int32_t value) {
-        char buf[16];
-        snprintf(buf, sizeof(buf), "%ld", (long)value);
-        return hasContentChanged(region_id, buf);
+    void snapshot(SmartRefresh::Snapshot& out) const {
+        out.valid_mask = registered_mask_ & ~dirty_mask_;
+        for (size_t i = 0; i < SmartRefresh::MAX_REGIONS; i++) {
+            out.hash[i] = (i < MAX_REGIONS && (out.valid_mask & (1u << i))) ? regions_[i].content_hash : 0;
+        }
     }
 
-    bool hasContentChanged(uint8_t region_id, float value, int decimals = 1) {
-        char buf[16];
-        snprintf(buf, sizeof(buf), "%.*f", decimals, value);
-        return hasContentChanged(region_id, buf);
+    void restore(const SmartRefresh::Snapshot& in) {
+        uint32_t load = in.valid_mask & registered_mask_;
+        for (size_t i = 0; i < MAX_REGIONS; i++) {
+            if (load & (1u << i)) regions_[i].content_hash = in.hash[i];
+        }
+        dirty_mask_ = registered_mask_ & ~load;
     }
 
     void markDirty(uint8_t region_id) {
-        RegionState* region = findRegion(region_id);
-        if (region) {
-            region->dirty = true;
-        }
+        if (isRegistered(region_id)) dirty_mask_ |= bit(region_id);
     }
 
     void markAllDirty() {
-        for (size_t i = 0; i < region_count_; i++) {
-            regions_[i].dirty = true;
-        }
+        dirty_mask_ = registered_mask_;
     }
 
     void markClean(uint8_t region_id) {
-        RegionState* region = findRegion(region_id);
-        if (region) {
-            region->dirty = false;
-        }
+        if (isRegistered(region_id)) dirty_mask_ &= ~bit(region_id);
     }
 
     bool hasAnyDirty() const {
-        for (size_t i = 0; i < region_count_; i++) {
-            if (regions_[i].dirty) return true;
-        }
-        return false;
+        return dirty_mask_ != 0;
     }
 
     uint16_t getDirtyMask() const {
-        uint16_t mask = 0;
-        for (size_t i = 0; i < region_count_; i++) {
-            if (regions_[i].dirty) {
-                mask |= (1 << regions_[i].region_id);
-            }
-        }
-        return mask;
+        return (uint16_t)dirty_mask_;
     }
 
     struct Stats {
@@ -132,33 +123,25 @@ public:
 
     const Stats& getStats() const { return stats_; }
     void resetStats() { stats_ = {}; }
-    size_t getRegionCount() const { return region_count_; }
+    size_t getRegionCount() const { return (size_t)__builtin_popcount(registered_mask_); }
 
 private:
     RegionState regions_[MAX_REGIONS];
-    size_t region_count_ = 0;
+    uint32_t registered_mask_ = 0;
+    uint32_t dirty_mask_ = 0;
     Stats stats_ = {};
 
-    uint32_t computeHash(const char* data, size_t len) {
-        // FNV-1a hash
-        uint32_t hash = 2166136261u;
-        for (size_t i = 0; i < len; i++) {
-            hash ^= (uint8_t)data[i];
-            hash *= 16777619u;
-        }
-        return hash;
-    }
-
-    RegionState* findRegion(uint8_t region_id) {
-        for (size_t i = 0; i < region_count_; i++) {
-            if (regions_[i].region_id == region_id) {
-                return &regions_[i];
-            }
-        }
-        return nullptr;
+    static uint32_t bit(uint8_t region_id) { return 1u << region_id; }
+    bool isRegistered(uint8_t region_id) const {
+        return region_id < MAX_REGIONS && (registered_mask_ & bit(region_id));
     }
 };
 
+// hashString lives in display_smart_refresh.cpp, which this test does not link
+uint32_t SmartRefresh::hashString(const char* s, uint32_t seed) {
+    return hashBytes(s, s ? strlen(s) : 0, seed);
+}
+
 // Global test instance
 static TestableSmartRefresh g_refresh;
 
@@ -374,6 +357,9 @@ void test_hash_collision_resistance() {
     size_t num_strings = sizeof(strings) / sizeof(strings[0]);
 
     for (size_t i = 0; i < num_strings; i++) {
+        // Start from content outside the list (the inner loop leaves the
+        // last string behind, which may be strings[i])
+        g_refresh.hasContentChanged(1, "#");
         g_refresh.markClean(1);
         TEST_ASSERT_TRUE_MESSAGE(g_refresh.hasContentChanged(1, strings[i]),
                                   "First check should always detect change");
@@ -438,6 +424,53 @@ void test_rapid_updates() {
     TEST_ASSERT_TRUE(g_refresh.hasContentChanged(1, "d"));
 }
 
+// Test: Numbers hash from their quantized value, as the display prints them
+void test_numeric_hash_is_quantized() {
+    // 72.46 and 72.54 both print "72.5"
+    TEST_ASSERT_EQUAL_UINT32(SmartRefresh::hashFixed(72.46f, 1), SmartRefresh::hashFixed(72.54f, 1));
+    TEST_ASSERT_NOT_EQUAL(SmartRefresh::hashFixed(72.5f, 1), SmartRefresh::hashFixed(72.6f, 1));
+    // Same value, different precision is different text
+    TEST_ASSERT_NOT_EQUAL(SmartRefresh::hashFixed(72.5f, 1), SmartRefresh::hashFixed(72.5f, 2));
+    // "-0.0" and "0.0"
+    TEST_ASSERT_NOT_EQUAL(SmartRefresh::hashFixed(-0.04f, 1), SmartRefresh::hashFixed(0.04f, 1));
+    TEST_ASSERT_EQUAL_UINT32(SmartRefresh::hashFixed(NAN, 1), SmartRefresh::hashFixed(-NAN, 1));
+    TEST_ASSERT_NOT_EQUAL(SmartRefresh::hashFixed(INFINITY, 1), SmartRefresh::hashFixed(-INFINITY, 1));
+    TEST_ASSERT_NOT_EQUAL(SmartRefresh::hashInt(42), SmartRefresh::hashInt(43));
+}
+
+// Test: The table survives a snapshot/restore, as across deep sleep
+void test_snapshot_restore() {
+    for (uint8_t r = 0; r < 4; r++) {
+        g_refresh.registerRegion(r);
+        g_refresh.hasContentChanged(r, (int32_t)(100 + r));
+        g_refresh.markClean(r);
+    }
+    g_refresh.markDirty(3);   // Never made it to the panel
+    SmartRefresh::Snapshot snap;
+    g_refresh.snapshot(snap);
+    TEST_ASSERT_EQUAL_HEX32(0x7, snap.valid_mask);
+
+    // Next wake: fresh table, restored from the snapshot
+    g_refresh.reset();
+    for (uint8_t r = 0; r < 4; r++) g_refresh.registerRegion(r);
+    g_refresh.restore(snap);
+    TEST_ASSERT_EQUAL_HEX16(0x8, g_refresh.getDirtyMask());
+
+    TEST_ASSERT_FALSE(g_refresh.hasContentChanged(0, (int32_t)100));
+    TEST_ASSERT_TRUE(g_refresh.hasContentChanged(1, (int32_t)999));
+    TEST_ASSERT_FALSE(g_refresh.hasContentChanged(2, (int32_t)102));
+    TEST_ASSERT_EQUAL_HEX16(0xA, g_refresh.getDirtyMask());
+}
+
+// Test: An empty snapshot (RTC state reset) leaves every region dirty
+void test_restore_empty_snapshot() {
+    g_refresh.registerRegion(0);
+    g_refresh.registerRegion(5);
+    SmartRefresh::Snapshot snap = {};
+    g_refresh.restore(snap);
+    TEST_ASSERT_EQUAL_HEX16(0x21, g_refresh.getDirtyMask());
+}
+
 int main(int argc, char** argv) {
     UNITY_BEGIN();
 
@@ -456,6 +489,9 @@ int main(int argc, char** argv) {
     RUN_TEST(test_hash_collision_resistance);
     RUN_TEST(test_temperature_scenarios);
     RUN_TEST(test_rapid_updates);
+    RUN_TEST(test_numeric_hash_is_quantized);
+    RUN_TEST(test_snapshot_restore);
+    RUN_TEST(test_restore_empty_snapshot);
 
     return UNITY_END();
 }
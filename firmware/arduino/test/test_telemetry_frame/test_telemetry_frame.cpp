@@ -0,0 +1,95 @@
+// Unit tests for the compact binary telemetry frame
+// Golden vectors are shared with tests/test_mqtt_telemetry_frame.py
+
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+#include "../../src/telemetry_frame.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t kGoldenFull[TELEMETRY_FRAME_LEN] = {
+    0x01, 0x59, 0x08, 0xc6, 0x11, 0x94, 0x27, 0x48, 0x0f, 0x57, 0xbd,
+    0xd2, 0x04, 0x00, 0x00, 0x2c, 0x03, 0xaa, 0x05, 0xa6, 0x06,
+};
+
+void test_encode_full_frame_matches_golden() {
+    TelemetryValues v = { 21.37f, 45.5f, 1013.2f, 3.912f, 87, -67, 1234, 812, 1450, 1702 };
+    uint8_t frame[TELEMETRY_FRAME_LEN];
+    TEST_ASSERT_EQUAL(TELEMETRY_FRAME_LEN, telemetry_encode(v, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(kGoldenFull, frame, TELEMETRY_FRAME_LEN);
+}
+
+void test_missing_values_use_sentinels() {
+    TelemetryValues v = { NAN, NAN, NAN, NAN, -1, 0, 7, 0, 0, 0 };
+    uint8_t frame[TELEMETRY_FRAME_LEN];
+    telemetry_encode(v, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[1]);   // INT16_MIN, little-endian
+    TEST_ASSERT_EQUAL_HEX8(0x80, frame[2]);
+    for (int i = 3; i <= 9; i++) TEST_ASSERT_EQUAL_HEX8(0xFF, frame[i]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[10]);
+    TEST_ASSERT_EQUAL_HEX8(0x07, frame[11]);
+}
+
+void test_out_of_range_becomes_missing() {
+    TelemetryValues v = { 400.0f, 120.0f, 1013.0f, 3.9f, 150, 5, 0, 70000, 0, 0 };
+    uint8_t frame[TELEMETRY_FRAME_LEN];
+    telemetry_encode(v, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_HEX8(0x80, frame[2]);   // Temperature overflows int16 centi-degrees
+    TEST_ASSERT_EQUAL_HEX8(0xFF, frame[3]);   // RH above 100%
+    TEST_ASSERT_EQUAL_HEX8(0xFF, frame[9]);   // Battery percent above 100
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[10]);  // Positive RSSI is not a valid reading
+    TEST_ASSERT_EQUAL_HEX8(0xFF, frame[15]);  // Milestone saturates at 65535 ms
+    TEST_ASSERT_EQUAL_HEX8(0xFF, frame[16]);
+}
+
+void test_short_buffer_rejected() {
+    TelemetryValues v = { 21.0f, 45.0f, 1013.0f, 3.9f, 80, -60, 1, 0, 0, 0 };
+    uint8_t frame[TELEMETRY_FRAME_LEN - 1];
+    TEST_ASSERT_EQUAL(0, telemetry_encode(v, frame, sizeof(frame)));
+}
+
+void test_decode_round_trips_golden() {
+    TelemetryValues v;
+    TEST_ASSERT_TRUE(telemetry_decode(kGoldenFull, sizeof(kGoldenFull), &v));
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 21.37f, v.tempC);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 45.5f, v.rhPct);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1013.2f, v.pressHPa);
+    TEST_ASSERT_FLOAT_WITHIN(0.0005f, 3.912f, v.batteryV);
+    TEST_ASSERT_EQUAL(87, v.batteryPct);
+    TEST_ASSERT_EQUAL(-67, v.rssiDbm);
+    TEST_ASSERT_EQUAL_UINT32(1234, v.wakeCount);
+    TEST_ASSERT_EQUAL_UINT32(812, v.sensorMs);
+    TEST_ASSERT_EQUAL_UINT32(1450, v.wifiMs);
+    TEST_ASSERT_EQUAL_UINT32(1702, v.mqttMs);
+}
+
+void test_decode_sentinels_and_bad_frames() {
+    TelemetryValues in = { NAN, NAN, NAN, NAN, -1, 0, 7, 0, 0, 0 };
+    uint8_t frame[TELEMETRY_FRAME_LEN];
+    telemetry_encode(in, frame, sizeof(frame));
+    TelemetryValues v;
+    TEST_ASSERT_TRUE(telemetry_decode(frame, sizeof(frame), &v));
+    TEST_ASSERT_TRUE(std::isnan(v.tempC));
+    TEST_ASSERT_TRUE(std::isnan(v.rhPct));
+    TEST_ASSERT_TRUE(std::isnan(v.pressHPa));
+    TEST_ASSERT_TRUE(std::isnan(v.batteryV));
+    TEST_ASSERT_EQUAL(-1, v.batteryPct);
+    TEST_ASSERT_EQUAL(0, v.rssiDbm);
+
+    TEST_ASSERT_FALSE(telemetry_decode(frame, sizeof(frame) - 1, &v));
+    frame[0] = 2;
+    TEST_ASSERT_FALSE(telemetry_decode(frame, sizeof(frame), &v));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_encode_full_frame_matches_golden);
+    RUN_TEST(test_missing_values_use_sentinels);
+    RUN_TEST(test_out_of_range_becomes_missing);
+    RUN_TEST(test_short_buffer_rejected);
+    RUN_TEST(test_decode_round_trips_golden);
+    RUN_TEST(test_decode_sentinels_and_bad_frames);
+    return UNITY_END();
+}
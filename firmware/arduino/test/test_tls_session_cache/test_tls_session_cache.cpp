@@ -0,0 +1,92 @@
+#include <unity.h>
+#include "../../src/tls_session_cache.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t kBlob[] = {0x01, 0x02, 0x03, 0x04, 0xA5, 0x5A};
+
+void test_store_then_usable(void) {
+    TlsSessionCache<64> c;
+    c.clear();
+    TEST_ASSERT_FALSE(c.valid());
+    uint32_t peer = tls_session_peer_id("broker.local", 8883);
+    TEST_ASSERT_TRUE(c.store(peer, 1000, 0, kBlob, sizeof(kBlob)));
+    TEST_ASSERT_TRUE(c.valid());
+    TEST_ASSERT_EQUAL_UINT16(sizeof(kBlob), c.length);
+    TEST_ASSERT_EQUAL_MEMORY(kBlob, c.data, sizeof(kBlob));
+    TEST_ASSERT_TRUE(c.usable(peer, 1500, 86400));
+}
+
+void test_other_peer_not_usable(void) {
+    TlsSessionCache<64> c;
+    c.store(tls_session_peer_id("broker.local", 8883), 1000, 0, kBlob, sizeof(kBlob));
+    TEST_ASSERT_FALSE(c.usable(tls_session_peer_id("broker.local", 1883), 1001, 86400));
+    TEST_ASSERT_FALSE(c.usable(tls_session_peer_id("other.local", 8883), 1001, 86400));
+}
+
+void test_expires_by_max_age_without_lifetime(void) {
+    TlsSessionCache<64> c;
+    c.store(7, 1000, 0, kBlob, sizeof(kBlob));
+    TEST_ASSERT_TRUE(c.usable(7, 1000 + 99, 100));
+    TEST_ASSERT_FALSE(c.usable(7, 1000 + 100, 100));
+}
+
+void test_shorter_ticket_lifetime_wins(void) {
+    TlsSessionCache<64> c;
+    c.store(7, 1000, 300, kBlob, sizeof(kBlob));
+    TEST_ASSERT_TRUE(c.usable(7, 1299, 86400));
+    TEST_ASSERT_FALSE(c.usable(7, 1300, 86400));
+    // A longer lifetime does not extend past max_age
+    c.store(7, 1000, 100000, kBlob, sizeof(kBlob));
+    TEST_ASSERT_FALSE(c.usable(7, 1000 + 86400, 86400));
+}
+
+void test_clock_behind_save_not_usable(void) {
+    TlsSessionCache<64> c;
+    c.store(7, 1000, 0, kBlob, sizeof(kBlob));
+    TEST_ASSERT_FALSE(c.usable(7, 999, 86400));
+}
+
+void test_too_large_blob_rejected(void) {
+    TlsSessionCache<4> c;
+    TEST_ASSERT_FALSE(c.store(7, 1000, 0, kBlob, sizeof(kBlob)));
+    TEST_ASSERT_FALSE(c.valid());
+    TEST_ASSERT_FALSE(c.store(7, 1000, 0, nullptr, 0));
+}
+
+void test_corruption_detected(void) {
+    TlsSessionCache<64> c;
+    c.store(7, 1000, 0, kBlob, sizeof(kBlob));
+    c.data[2] ^= 0xFF;
+    TEST_ASSERT_FALSE(c.valid());
+    c.data[2] ^= 0xFF;
+    TEST_ASSERT_TRUE(c.valid());
+    c.saved_at++;
+    TEST_ASSERT_FALSE(c.usable(7, 2000, 86400));
+}
+
+void test_note_resumed_keeps_record_valid(void) {
+    TlsSessionCache<64> c;
+    c.store(7, 1000, 0, kBlob, sizeof(kBlob));
+    c.noteResumed();
+    c.noteResumed();
+    TEST_ASSERT_EQUAL_UINT16(2, c.resumes);
+    TEST_ASSERT_TRUE(c.valid());
+    // Storing a fresh session restarts the count
+    c.store(7, 2000, 0, kBlob, sizeof(kBlob));
+    TEST_ASSERT_EQUAL_UINT16(0, c.resumes);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_store_then_usable);
+    RUN_TEST(test_other_peer_not_usable);
+    RUN_TEST(test_expires_by_max_age_without_lifetime);
+    RUN_TEST(test_shorter_ticket_lifetime_wins);
+    RUN_TEST(test_clock_behind_save_not_usable);
+    RUN_TEST(test_too_large_blob_rejected);
+    RUN_TEST(test_corruption_detected);
+    RUN_TEST(test_note_resumed_keeps_record_valid);
+    return UNITY_END();
+}
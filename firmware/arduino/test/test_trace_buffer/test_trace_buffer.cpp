@@ -0,0 +1,103 @@
+// Unit tests for the trace ring: wraparound, task ids, chunked dumps
+
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include "../../src/trace_buffer.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_records_in_order_and_formats() {
+    static TraceBuffer<8> t;
+    t.clear();
+    uint8_t tid = t.taskId(0x1000, "loopTask");
+    t.record("wifi", TRACE_BEGIN, tid, 100);
+    t.record("wifi", TRACE_END, tid, 250);
+    TEST_ASSERT_EQUAL(2u, t.size());
+
+    char out[128];
+    size_t cursor = 0;
+    TEST_ASSERT_EQUAL(2u, t.formatChunk(cursor, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("[[100,\"B\",0,\"wifi\"],[250,\"E\",0]]", out);
+    TEST_ASSERT_EQUAL(0u, t.formatChunk(cursor, out, sizeof(out)));
+}
+
+void test_wrap_keeps_newest() {
+    static TraceBuffer<4> t;
+    t.clear();
+    for (uint32_t i = 0; i < 10; i++) t.record("x", TRACE_BEGIN, 0, i);
+    TEST_ASSERT_EQUAL(4u, t.size());
+    TEST_ASSERT_EQUAL(6u, t.overwritten());
+
+    char out[256];
+    size_t cursor = 0;
+    t.formatChunk(cursor, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("[[6,\"B\",0,\"x\"],[7,\"B\",0,\"x\"],[8,\"B\",0,\"x\"],[9,\"B\",0,\"x\"]]", out);
+}
+
+void test_chunks_hold_whole_events() {
+    static TraceBuffer<64> t;
+    t.clear();
+    for (uint32_t i = 0; i < 40; i++) {
+        t.record("mqtt_publish", (i & 1) ? TRACE_END : TRACE_BEGIN, 1, 1000000 + i);
+    }
+    char out[96];
+    size_t cursor = 0;
+    size_t total = 0;
+    int chunks = 0;
+    size_t n;
+    while ((n = t.formatChunk(cursor, out, sizeof(out))) != 0) {
+        total += n;
+        chunks++;
+        size_t len = strlen(out);
+        TEST_ASSERT_TRUE(len < sizeof(out));
+        TEST_ASSERT_EQUAL('[', out[0]);
+        TEST_ASSERT_EQUAL(']', out[len - 1]);
+        TEST_ASSERT_TRUE(out[len - 2] == ']');
+    }
+    TEST_ASSERT_EQUAL(40u, total);
+    TEST_ASSERT_TRUE(chunks > 1);
+
+    // A buffer too small for one event ends the dump instead of spinning
+    cursor = 0;
+    TEST_ASSERT_EQUAL(0u, t.formatChunk(cursor, out, 8));
+}
+
+void test_task_ids_are_stable_and_bounded() {
+    static TraceBuffer<8> t;
+    uint8_t a = t.taskId(0xA0, "loopTask");
+    uint8_t b = t.taskId(0xB0, "panel_refresh");
+    TEST_ASSERT_TRUE(a != b);
+    TEST_ASSERT_EQUAL(a, t.taskId(0xA0, "loopTask"));
+    for (uintptr_t k = 1; k <= 20; k++) t.taskId(0x1000 + k, "worker");
+    TEST_ASSERT_EQUAL(TRACE_MAX_TASKS, t.taskCount());
+    TEST_ASSERT_EQUAL(TRACE_TASK_OTHER, t.taskId(0x9999, "late"));
+    TEST_ASSERT_EQUAL(b, t.taskId(0xB0, "panel_refresh"));
+
+    char out[256];
+    t.formatTasks(out, sizeof(out));
+    TEST_ASSERT_TRUE(strncmp(out, "[[0,\"loopTask\"],[1,\"panel_refresh\"],", 35) == 0);
+}
+
+void test_pause_skips_records() {
+    static TraceBuffer<8> t;
+    t.clear();
+    t.record("a", TRACE_BEGIN, 0, 1);
+    t.pause();
+    t.record("b", TRACE_BEGIN, 0, 2);
+    t.resume();
+    t.record("a", TRACE_END, 0, 3);
+    TEST_ASSERT_EQUAL(2u, t.size());
+    TEST_ASSERT_EQUAL(1u, t.skipped());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_records_in_order_and_formats);
+    RUN_TEST(test_wrap_keeps_newest);
+    RUN_TEST(test_chunks_hold_whole_events);
+    RUN_TEST(test_task_ids_are_stable_and_bounded);
+    RUN_TEST(test_pause_skips_records);
+    return UNITY_END();
+}
@@ -0,0 +1,104 @@
+// Unit tests for the adaptive-sleep temperature trend model
+// Tests the history ring, slope estimates and interval planning bounds
+
+#include <unity.h>
+#include <cmath>
+#include "../../src/sleep_policy.h"
+#include "../../src/trend_model.h"
+
+static TrendHistory h;
+
+void setUp(void) { trend_reset(h); }
+void tearDown(void) {}
+
+void test_no_history_plans_default() {
+    TEST_ASSERT_TRUE(std::isnan(trend_rate(h)));
+    trend_push(h, 0, 21.0f);
+    TEST_ASSERT_TRUE(std::isnan(trend_rate(h)));
+    TEST_ASSERT_EQUAL_UINT32(300, trend_plan_interval(trend_rate(h), 0.2f, 60, 1800, 300));
+}
+
+void test_nan_reading_is_dropped() {
+    trend_push(h, 0, 21.0f);
+    trend_push(h, 300, NAN);
+    TEST_ASSERT_EQUAL_UINT8(1, h.count);
+}
+
+void test_linear_ramp_slope() {
+    // 0.6 degC per hour = 1/6000 degC/s
+    for (int i = 0; i < 5; i++) trend_push(h, 600, 20.0f + 0.1f * i);
+    float slope = 0;
+    TEST_ASSERT_TRUE(trend_slope(h, slope));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f / 600.0f, slope);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f / 600.0f, h.slope_ewma);
+    // 0.2 degC deadband at 1/6000 degC/s: 1200 s
+    uint32_t sec = trend_plan_interval(trend_rate(h), 0.2f, 60, 1800, 300);
+    TEST_ASSERT_UINT32_WITHIN(2, 1200, sec);
+}
+
+void test_transient_shortens_interval() {
+    for (int i = 0; i < 6; i++) trend_push(h, 1800, 19.0f);
+    TEST_ASSERT_EQUAL_UINT32(1800, trend_plan_interval(trend_rate(h), 0.2f, 60, 1800, 300));
+    // Heating comes on: +1 degC in 5 minutes; the EWMA takes half the step
+    // on the first wake (1/600 degC/s), enough to replan 1800 s down to 120 s
+    trend_push(h, 300, 20.0f);
+    TEST_ASSERT_UINT32_WITHIN(1, 120, trend_plan_interval(trend_rate(h), 0.2f, 60, 1800, 300));
+    // Still climbing: the estimate steepens and sampling gets denser
+    trend_push(h, 120, 20.5f);
+    TEST_ASSERT_UINT32_WITHIN(5, 69, trend_plan_interval(trend_rate(h), 0.2f, 60, 1800, 300));
+}
+
+void test_flat_night_reaches_ceiling() {
+    for (int i = 0; i < 8; i++) trend_push(h, 1800, 18.5f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, trend_rate(h));
+    TEST_ASSERT_EQUAL_UINT32(1800, trend_plan_interval(trend_rate(h), 0.2f, 60, 1800, 300));
+}
+
+void test_ring_keeps_newest_samples() {
+    for (int i = 0; i < 12; i++) trend_push(h, 60, (float)i);
+    TEST_ASSERT_EQUAL_UINT8(TREND_SAMPLES, h.count);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, h.tempC[trend_index(h, 0)]);
+    TEST_ASSERT_EQUAL_FLOAT(11.0f, h.tempC[trend_index(h, TREND_SAMPLES - 1)]);
+    TEST_ASSERT_EQUAL_UINT32(11 * 60, h.clock_sec);
+}
+
+void test_plan_respects_tier_bounds() {
+    // Low battery raises the floor above the planned value
+    TEST_ASSERT_EQUAL_UINT32(600, trend_plan_interval(0.01f, 0.2f, 600, 1800, 300));
+    // A floor above the ceiling wins
+    TEST_ASSERT_EQUAL_UINT32(2400, trend_plan_interval(0.0f, 0.2f, 2400, 1800, 300));
+    TEST_ASSERT_EQUAL_UINT32(600, trend_plan_interval(NAN, 0.2f, 600, 1800, 300));
+}
+
+void test_corrupt_ring_resets() {
+    h.count = 200;
+    trend_push(h, 60, 21.0f);
+    TEST_ASSERT_EQUAL_UINT8(1, h.count);
+}
+
+void test_sleep_policy_battery_tiers() {
+    SleepConfig c = {300, 600, 1800, 60, 20, 5, 1800};
+    TEST_ASSERT_EQUAL(SleepTier::NORMAL, sleep_tier(c, -1));
+    TEST_ASSERT_EQUAL(SleepTier::NORMAL, sleep_tier(c, 20));
+    TEST_ASSERT_EQUAL(SleepTier::LOW_BATTERY, sleep_tier(c, 19));
+    TEST_ASSERT_EQUAL(SleepTier::CRITICAL, sleep_tier(c, 4));
+    // Critical ignores the trend; low battery never goes below its interval
+    TEST_ASSERT_EQUAL_UINT32(1800, sleep_plan_interval(c, 4, 0.01f, 0.2f));
+    TEST_ASSERT_EQUAL_UINT32(600, sleep_plan_interval(c, 15, 0.01f, 0.2f));
+    TEST_ASSERT_EQUAL_UINT32(60, sleep_plan_interval(c, 80, 0.01f, 0.2f));
+    TEST_ASSERT_EQUAL_UINT32(300, sleep_plan_interval(c, -1, NAN, 0.2f));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_history_plans_default);
+    RUN_TEST(test_nan_reading_is_dropped);
+    RUN_TEST(test_linear_ramp_slope);
+    RUN_TEST(test_transient_shortens_interval);
+    RUN_TEST(test_flat_night_reaches_ceiling);
+    RUN_TEST(test_ring_keeps_newest_samples);
+    RUN_TEST(test_plan_respects_tier_bounds);
+    RUN_TEST(test_corrupt_ring_resets);
+    RUN_TEST(test_sleep_policy_battery_tiers);
+    return UNITY_END();
+}
@@ -0,0 +1,58 @@
+// Unit tests for the battery-driven layout variant choice (thresholds, hysteresis)
+
+#include <unity.h>
+#include "../../src/ui_variant_select.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static constexpr uint8_t BASE = 0;
+static constexpr uint8_t COMPACT = 1;
+static constexpr uint8_t LARGE = 2;
+static constexpr uint8_t LOW = 3;
+
+static const UiVariantPolicy kPolicy = { BASE, COMPACT, LOW, 30, 15, 5 };
+
+void test_healthy_battery_uses_the_base_layout() {
+    TEST_ASSERT_EQUAL_UINT8(BASE, ui_variant_select(BASE, 87, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(BASE, ui_variant_select(BASE, 30, kPolicy));
+}
+
+void test_thresholds_step_down_through_compact_to_low() {
+    TEST_ASSERT_EQUAL_UINT8(COMPACT, ui_variant_select(BASE, 29, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(COMPACT, ui_variant_select(COMPACT, 15, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(LOW, ui_variant_select(COMPACT, 14, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(LOW, ui_variant_select(BASE, 3, kPolicy));    // Straight down
+}
+
+void test_hysteresis_holds_a_layout_near_its_threshold() {
+    TEST_ASSERT_EQUAL_UINT8(LOW, ui_variant_select(LOW, 19, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(COMPACT, ui_variant_select(LOW, 20, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(COMPACT, ui_variant_select(COMPACT, 34, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(BASE, ui_variant_select(COMPACT, 35, kPolicy));
+    TEST_ASSERT_EQUAL_UINT8(COMPACT, ui_variant_select(LOW, 33, kPolicy));  // Charged a bit
+    TEST_ASSERT_EQUAL_UINT8(BASE, ui_variant_select(LOW, 90, kPolicy));     // Charged
+}
+
+void test_unknown_level_keeps_the_base_layout() {
+    TEST_ASSERT_EQUAL_UINT8(BASE, ui_variant_select(LOW, -1, kPolicy));
+}
+
+void test_configured_base_and_disabled_tiers() {
+    UiVariantPolicy p = { LARGE, COMPACT, LOW, 0, 10, 5 };
+    TEST_ASSERT_EQUAL_UINT8(LARGE, ui_variant_select(BASE, 20, p));         // No compact tier
+    TEST_ASSERT_EQUAL_UINT8(LOW, ui_variant_select(LARGE, 9, p));
+    TEST_ASSERT_EQUAL_UINT8(LARGE, ui_variant_select(LOW, 15, p));
+    p.low_below_pct = 0;
+    TEST_ASSERT_EQUAL_UINT8(LARGE, ui_variant_select(LOW, 0, p));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_battery_uses_the_base_layout);
+    RUN_TEST(test_thresholds_step_down_through_compact_to_low);
+    RUN_TEST(test_hysteresis_holds_a_layout_near_its_threshold);
+    RUN_TEST(test_unknown_level_keeps_the_base_layout);
+    RUN_TEST(test_configured_base_and_disabled_tiers);
+    return UNITY_END();
+}
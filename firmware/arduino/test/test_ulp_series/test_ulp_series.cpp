@@ -0,0 +1,119 @@
+// Unit tests for the ULP sampler shared block: ring order, window checks and
+// the deadband -> raw ADC window translation done before sleep
+
+#include <unity.h>
+#include <cmath>
+#include <cstring>
+#include "../../src/ulp_series.h"
+
+// Bosch example calibration (BMP280 datasheet section 8.2 / 3.11.3)
+static Bme280Calib example_calib() {
+    Bme280Calib c;
+    memset(&c, 0, sizeof(c));
+    c.t1 = 27504; c.t2 = 26435; c.t3 = -1000;
+    c.p1 = 36477; c.p2 = -10685; c.p3 = 3024; c.p4 = 2855; c.p5 = 140;
+    c.p6 = -7; c.p7 = 15500; c.p8 = -14600; c.p9 = 6000;
+    c.h1 = 75; c.h2 = 362; c.h3 = 0; c.h4 = 313; c.h5 = 50; c.h6 = 30;
+    return c;
+}
+
+static void pack(uint8_t* d, int32_t adc_p, int32_t adc_t, int32_t adc_h) {
+    d[0] = (uint8_t)(adc_p >> 12); d[1] = (uint8_t)(adc_p >> 4); d[2] = (uint8_t)((adc_p & 0xF) << 4);
+    d[3] = (uint8_t)(adc_t >> 12); d[4] = (uint8_t)(adc_t >> 4); d[5] = (uint8_t)((adc_t & 0xF) << 4);
+    d[6] = (uint8_t)(adc_h >> 8);  d[7] = (uint8_t)adc_h;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_ring_keeps_newest_in_order() {
+    UlpShared s;
+    memset(&s, 0, sizeof(s));
+    uint8_t d[ULP_SAMPLE_BYTES];
+    for (uint32_t i = 0; i < ULP_SAMPLE_SLOTS + 5; i++) {
+        pack(d, 415148, 519888 + (int32_t)i, 30000);
+        ulp_push_sample(&s, d);
+    }
+    TEST_ASSERT_EQUAL_UINT32(ULP_SAMPLE_SLOTS, ulp_sample_count(&s));
+    TEST_ASSERT_EQUAL_INT32(519888 + 5, ulp_adc_t(ulp_sample_at(&s, 0)->data));
+    TEST_ASSERT_EQUAL_INT32(519888 + ULP_SAMPLE_SLOTS + 4,
+                            ulp_adc_t(ulp_sample_at(&s, ULP_SAMPLE_SLOTS - 1)->data));
+    TEST_ASSERT_EQUAL_UINT32(5, ulp_sample_seq(&s, 0));
+    TEST_ASSERT_EQUAL_UINT32(30000, (uint32_t)ulp_adc_h(ulp_sample_at(&s, 0)->data));
+}
+
+void test_check_sample_windows() {
+    UlpShared s;
+    memset(&s, 0, sizeof(s));
+    s.adc_t_min = 500000; s.adc_t_max = 520000;
+    s.adc_h_min = 1; s.adc_h_max = 0;       // Humidity off
+    uint8_t d[ULP_SAMPLE_BYTES];
+    pack(d, 415148, 510000, 0x8000);
+    TEST_ASSERT_EQUAL_UINT32(ULP_WAKE_NONE, ulp_check_sample(&s, d));
+    pack(d, 415148, 520001, 0x8000);
+    TEST_ASSERT_EQUAL_UINT32(ULP_WAKE_TEMP, ulp_check_sample(&s, d));
+    pack(d, 415148, 0x80000, 0x8000);
+    TEST_ASSERT_EQUAL_UINT32(ULP_WAKE_SENSOR_RESET, ulp_check_sample(&s, d));
+
+    s.adc_h_min = 29000; s.adc_h_max = 31000;
+    pack(d, 415148, 510000, 0x8000);
+    TEST_ASSERT_EQUAL_UINT32(ULP_WAKE_SENSOR_RESET, ulp_check_sample(&s, d));
+    pack(d, 415148, 510000, 28999);
+    TEST_ASSERT_EQUAL_UINT32(ULP_WAKE_RH, ulp_check_sample(&s, d));
+    pack(d, 415148, 510000, 31000);
+    TEST_ASSERT_EQUAL_UINT32(ULP_WAKE_NONE, ulp_check_sample(&s, d));
+}
+
+void test_temp_window_matches_deadband() {
+    Bme280Calib c = example_calib();
+    int32_t lo, hi;
+    ulp_temp_window(c, 25.08f, 0.2f, lo, hi);
+    TEST_ASSERT_TRUE(lo < 519888 && 519888 < hi);
+    // Inside: |delta| < 0.2 degC; one count further: >= 0.2 degC
+    TEST_ASSERT_TRUE(ulp_temp_centi(c, lo) > 2488);
+    TEST_ASSERT_TRUE(ulp_temp_centi(c, lo - 1) <= 2488);
+    TEST_ASSERT_TRUE(ulp_temp_centi(c, hi) < 2528);
+    TEST_ASSERT_TRUE(ulp_temp_centi(c, hi + 1) >= 2528);
+}
+
+void test_rh_window_matches_deadband() {
+    Bme280Calib c = example_calib();
+    int32_t lo, hi;
+    ulp_rh_window(c, 25.08f, 45.0f, 1.0f, lo, hi);
+    TEST_ASSERT_TRUE(lo < hi);
+    // Judged at the first adc_T that reads 25.08 degC
+    int32_t adc_t = ulp_lower_bound(0, ULP_ADC_T_MAX, [&](int32_t a) { return ulp_temp_centi(c, a) >= 2508; });
+    int32_t t_fine = bme280_t_fine(c, adc_t);
+    TEST_ASSERT_TRUE(bme280_humidity_q22_10(c, lo, t_fine) > 44 * 1024);
+    TEST_ASSERT_TRUE(bme280_humidity_q22_10(c, lo - 1, t_fine) <= 44 * 1024);
+    TEST_ASSERT_TRUE(bme280_humidity_q22_10(c, hi, t_fine) < 46 * 1024);
+    TEST_ASSERT_TRUE(bme280_humidity_q22_10(c, hi + 1, t_fine) >= 46 * 1024);
+}
+
+void test_nan_baseline_disables_windows() {
+    Bme280Calib c = example_calib();
+    UlpShared s;
+    memset(&s, 0, sizeof(s));
+    ulp_set_windows(c, 25.0f, 0.2f, NAN, 1.0f, s);
+    TEST_ASSERT_TRUE(ulp_window_on(s.adc_t_min, s.adc_t_max));
+    TEST_ASSERT_FALSE(ulp_window_on(s.adc_h_min, s.adc_h_max));
+    ulp_set_windows(c, NAN, 0.2f, 45.0f, 1.0f, s);
+    TEST_ASSERT_FALSE(ulp_window_on(s.adc_t_min, s.adc_t_max));
+    TEST_ASSERT_FALSE(ulp_window_on(s.adc_h_min, s.adc_h_max));
+}
+
+void test_sample_time() {
+    TEST_ASSERT_EQUAL_UINT32(1700000060u, ulp_sample_time(1700000000u, 60, 0));
+    TEST_ASSERT_EQUAL_UINT32(1700000000u + 60 * 33, ulp_sample_time(1700000000u, 60, 32));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_keeps_newest_in_order);
+    RUN_TEST(test_check_sample_windows);
+    RUN_TEST(test_temp_window_matches_deadband);
+    RUN_TEST(test_rh_window_matches_deadband);
+    RUN_TEST(test_nan_baseline_disables_windows);
+    RUN_TEST(test_sample_time);
+    return UNITY_END();
+}
@@ -0,0 +1,77 @@
+// Unit tests for weather-condition classification
+// Every generated key must resolve through the perfect-hash table; free-form
+// text falls back to the keyword heuristics
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/weather_classify.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_every_table_key_maps_to_its_kind() {
+    for (const WeatherTableKey& k : kWeatherTableKeys) {
+        TEST_ASSERT_EQUAL_MESSAGE(k.kind, weather_table_lookup(k.key), k.key);
+        TEST_ASSERT_EQUAL_MESSAGE(k.kind, weather_classify(k.key), k.key);
+    }
+}
+
+void test_slot_table_is_perfect() {
+    // Each key owns exactly one slot and every non-empty slot points at a key
+    size_t used = 0;
+    for (uint8_t idx : kWeatherTableSlots) {
+        if (idx == WEATHER_TABLE_EMPTY) continue;
+        TEST_ASSERT_LESS_THAN(sizeof(kWeatherTableKeys) / sizeof(kWeatherTableKeys[0]), idx);
+        used++;
+    }
+    TEST_ASSERT_EQUAL(sizeof(kWeatherTableKeys) / sizeof(kWeatherTableKeys[0]), used);
+}
+
+void test_lookup_is_case_insensitive() {
+    TEST_ASSERT_EQUAL(WEATHER_KIND_PARTLY_CLOUDY, weather_classify("PartlyCloudy"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_NIGHT, weather_classify("Clear-Night"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_NIGHT_PARTLY_CLOUDY, weather_classify("02N"));
+}
+
+void test_non_keys_miss_the_table() {
+    TEST_ASSERT_EQUAL(WEATHER_KIND_UNKNOWN, weather_table_lookup("light rain"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_UNKNOWN, weather_table_lookup("sunnyx"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_UNKNOWN, weather_table_lookup(""));
+}
+
+void test_openweather_code_prefixes() {
+    TEST_ASSERT_EQUAL(WEATHER_KIND_DRIZZLE, weather_classify("51d"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_DRIZZLE, weather_classify("61n"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_POURING, weather_classify("80d"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_POURING, weather_classify("10n@2x"));
+}
+
+void test_free_form_heuristics() {
+    TEST_ASSERT_EQUAL(WEATHER_KIND_TORNADO, weather_classify("Tornado warning"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_HURRICANE, weather_classify("hurricane"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_DRIZZLE, weather_classify("light drizzle"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_LIGHTNING, weather_classify("Thunderstorm with rain"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_POURING, weather_classify("light rain"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_SNOWY, weather_classify("heavy snow"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_FOG, weather_classify("Mist"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_PARTLY_CLOUDY, weather_classify("partly sunny"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_CLOUDY, weather_classify("overcast clouds"));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_SUNNY, weather_classify("clear sky"));
+}
+
+void test_empty_is_unknown() {
+    TEST_ASSERT_EQUAL(WEATHER_KIND_UNKNOWN, weather_classify(nullptr));
+    TEST_ASSERT_EQUAL(WEATHER_KIND_UNKNOWN, weather_classify(""));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_table_key_maps_to_its_kind);
+    RUN_TEST(test_slot_table_is_perfect);
+    RUN_TEST(test_lookup_is_case_insensitive);
+    RUN_TEST(test_non_keys_miss_the_table);
+    RUN_TEST(test_openweather_code_prefixes);
+    RUN_TEST(test_free_form_heuristics);
+    RUN_TEST(test_empty_is_unknown);
+    return UNITY_END();
+}
@@ -0,0 +1,89 @@
+// Unit tests for the RSSI-adaptive WiFi link tuning (TX power, protocol, backoff)
+
+#include <unity.h>
+#include <cstring>
+#include "../../src/wifi_link_adapt.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const WifiLinkPolicy kPolicy = { 78, 34, -67, -55, 3, 1000 };
+
+static WifiLinkHistory history_of(int rssi, uint32_t attempts, bool ok, int wakes) {
+    WifiLinkHistory h;
+    memset(&h, 0, sizeof(h));
+    for (int i = 0; i < wakes; i++) wifi_link_record(h, rssi, attempts, ok);
+    return h;
+}
+
+void test_no_history_uses_full_power_and_caller_backoff() {
+    WifiLinkHistory h;
+    memset(&h, 0, sizeof(h));
+    WifiLinkTuning t = wifi_link_tune(h, kPolicy);
+    TEST_ASSERT_EQUAL_INT8(78, t.tx_qdbm);
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_PROTO_11B | WIFI_LINK_PROTO_11G | WIFI_LINK_PROTO_11N, t.protocol);
+    TEST_ASSERT_EQUAL_UINT8(3, t.max_attempts);
+    TEST_ASSERT_EQUAL_UINT16(1000, t.initial_delay_ms);
+}
+
+void test_near_device_lowers_power_and_drops_11b() {
+    WifiLinkHistory h = history_of(-50, 1, true, 4);
+    WifiLinkTuning t = wifi_link_tune(h, kPolicy);
+    TEST_ASSERT_EQUAL_INT8(34, t.tx_qdbm);                    // 17 dB margin, clamped to min
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_PROTO_11G | WIFI_LINK_PROTO_11N, t.protocol);
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_LISTEN_NEAR, t.listen_interval);
+    TEST_ASSERT_EQUAL_UINT8(2, t.max_attempts);
+    TEST_ASSERT_EQUAL_UINT16(500, t.initial_delay_ms);
+}
+
+void test_power_follows_the_weakest_recent_rssi() {
+    WifiLinkHistory h = history_of(-58, 1, true, 3);
+    wifi_link_record(h, -62, 1, true);
+    WifiLinkTuning t = wifi_link_tune(h, kPolicy);
+    TEST_ASSERT_EQUAL_INT8(78 - 5 * 4, t.tx_qdbm);            // -62 is 5 dB above -67
+    TEST_ASSERT_TRUE(t.protocol & WIFI_LINK_PROTO_11B);       // Not near
+}
+
+void test_too_few_samples_keep_full_power() {
+    WifiLinkHistory h = history_of(-45, 1, true, 2);
+    TEST_ASSERT_EQUAL_INT8(78, wifi_link_tune(h, kPolicy).tx_qdbm);
+}
+
+void test_a_retry_restores_full_power() {
+    WifiLinkHistory h = history_of(-50, 1, true, 6);
+    wifi_link_record(h, -52, 2, true);
+    WifiLinkTuning t = wifi_link_tune(h, kPolicy);
+    TEST_ASSERT_EQUAL_INT8(78, t.tx_qdbm);
+    TEST_ASSERT_EQUAL_UINT8(3, t.max_attempts);               // Neither reliable nor flaky
+}
+
+void test_edge_device_retries_more_and_waits_longer() {
+    WifiLinkHistory h = history_of(-84, 2, true, 5);
+    wifi_link_record(h, 0, 3, false);
+    wifi_link_record(h, 0, 3, false);
+    WifiLinkTuning t = wifi_link_tune(h, kPolicy);
+    TEST_ASSERT_EQUAL_INT8(78, t.tx_qdbm);
+    TEST_ASSERT_EQUAL_UINT8(4, t.max_attempts);
+    TEST_ASSERT_EQUAL_UINT16(2000, t.initial_delay_ms);
+}
+
+void test_ring_keeps_only_the_last_wakes() {
+    WifiLinkHistory h = history_of(0, 3, false, 4);           // Old failures
+    for (size_t i = 0; i < WIFI_LINK_HISTORY; i++) wifi_link_record(h, -60, 1, true);
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_HISTORY, h.count);
+    WifiLinkTuning t = wifi_link_tune(h, kPolicy);
+    TEST_ASSERT_EQUAL_INT8(78 - 7 * 4, t.tx_qdbm);
+    TEST_ASSERT_EQUAL_UINT8(2, t.max_attempts);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_history_uses_full_power_and_caller_backoff);
+    RUN_TEST(test_near_device_lowers_power_and_drops_11b);
+    RUN_TEST(test_power_follows_the_weakest_recent_rssi);
+    RUN_TEST(test_too_few_samples_keep_full_power);
+    RUN_TEST(test_a_retry_restores_full_power);
+    RUN_TEST(test_edge_device_retries_more_and_waits_longer);
+    RUN_TEST(test_ring_keeps_only_the_last_wakes);
+    return UNITY_END();
+}
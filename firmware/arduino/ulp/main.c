@@ -0,0 +1,161 @@
+/* ULP RISC-V BME280 sampler (ESP32-S2)
+ * Runs on the ULP timer while the main cores are in deep sleep: triggers one
+ * forced conversion over bit-banged I2C on the RTC GPIOs, appends the raw
+ * burst read to the ring in ulp_shared.h and wakes the main cores only when a
+ * reading leaves the window they armed or the sensor stops answering. The
+ * main cores keep their own timer wake as the heartbeat.
+ *
+ * Built with the ESP-IDF ulp component (ulp_embed_binary); the main-core
+ * side is ulp_sampler.cpp, enabled with FEATURE_ULP_SAMPLING.
+ */
+
+#include <stdint.h>
+#include "ulp_riscv/ulp_riscv.h"
+#include "ulp_riscv/ulp_riscv_utils.h"
+#include "ulp_riscv/ulp_riscv_gpio.h"
+#include "../src/ulp_shared.h"
+
+/* Visible to the main cores as ulp_shared */
+UlpShared shared;
+
+/* ~5 us at the ~8.5 MHz ULP clock: ~100 kHz SCL */
+#define I2C_HALF_PERIOD_CYCLES 40
+
+#define BME280_REG_CTRL_MEAS 0xF4
+#define BME280_REG_DATA 0xF7
+#define BME280_MODE_FORCED 0x01
+
+static gpio_num_t sda;
+static gpio_num_t scl;
+
+static void half_period(void) {
+  ulp_riscv_delay_cycles(I2C_HALF_PERIOD_CYCLES);
+}
+
+/* Open drain by hand: drive low, or release to the bus pull-up */
+static void line_set(gpio_num_t pin, int high) {
+  if (high) {
+    ulp_riscv_gpio_output_disable(pin);
+  } else {
+    ulp_riscv_gpio_output_level(pin, 0);
+    ulp_riscv_gpio_output_enable(pin);
+  }
+}
+
+static void pins_init(void) {
+  ulp_riscv_gpio_init(sda);
+  ulp_riscv_gpio_init(scl);
+  ulp_riscv_gpio_input_enable(sda);
+  ulp_riscv_gpio_input_enable(scl);
+  line_set(sda, 1);
+  line_set(scl, 1);
+}
+
+static void i2c_start(void) {
+  line_set(sda, 1);
+  line_set(scl, 1);
+  half_period();
+  line_set(sda, 0);
+  half_period();
+  line_set(scl, 0);
+}
+
+static void i2c_stop(void) {
+  line_set(sda, 0);
+  half_period();
+  line_set(scl, 1);
+  half_period();
+  line_set(sda, 1);
+  half_period();
+}
+
+/* 1 when the byte was acknowledged */
+static int i2c_write(uint8_t b) {
+  for (int i = 7; i >= 0; i--) {
+    line_set(sda, (b >> i) & 1);
+    half_period();
+    line_set(scl, 1);
+    half_period();
+    line_set(scl, 0);
+  }
+  line_set(sda, 1);
+  half_period();
+  line_set(scl, 1);
+  half_period();
+  int ack = !ulp_riscv_gpio_get_level(sda);
+  line_set(scl, 0);
+  return ack;
+}
+
+static uint8_t i2c_read(int ack) {
+  uint8_t b = 0;
+  line_set(sda, 1);
+  for (int i = 0; i < 8; i++) {
+    half_period();
+    line_set(scl, 1);
+    half_period();
+    b = (uint8_t)((b << 1) | (ulp_riscv_gpio_get_level(sda) & 1));
+    line_set(scl, 0);
+  }
+  line_set(sda, !ack);
+  half_period();
+  line_set(scl, 1);
+  half_period();
+  line_set(scl, 0);
+  line_set(sda, 1);
+  return b;
+}
+
+static int reg_write(uint8_t addr, uint8_t reg, uint8_t value) {
+  i2c_start();
+  int ok = i2c_write((uint8_t)(addr << 1)) && i2c_write(reg) && i2c_write(value);
+  i2c_stop();
+  return ok;
+}
+
+/* Register pointer write + repeated-start burst read */
+static int reg_read(uint8_t addr, uint8_t reg, uint8_t* out, int len) {
+  i2c_start();
+  int ok = i2c_write((uint8_t)(addr << 1)) && i2c_write(reg);
+  if (ok) {
+    i2c_start();
+    ok = i2c_write((uint8_t)((addr << 1) | 1));
+  }
+  for (int i = 0; ok && i < len; i++) {
+    out[i] = i2c_read(i < len - 1);
+  }
+  i2c_stop();
+  return ok;
+}
+
+int main(void) {
+  if (shared.magic != ULP_SHARED_MAGIC) return 0;
+  shared.busy = 1;
+  sda = (gpio_num_t)shared.sda_pin;
+  scl = (gpio_num_t)shared.scl_pin;
+  pins_init();
+
+  uint8_t data[ULP_SAMPLE_BYTES];
+  uint32_t wake = ULP_WAKE_NONE;
+  int ok = reg_write(shared.addr, BME280_REG_CTRL_MEAS, shared.ctrl_meas | BME280_MODE_FORCED);
+  if (ok) {
+    ulp_riscv_delay_cycles(shared.conversion_cycles);
+    ok = reg_read(shared.addr, BME280_REG_DATA, data, ULP_SAMPLE_BYTES);
+  }
+  if (ok) {
+    ulp_push_sample(&shared, data);
+    wake = ulp_check_sample(&shared, data);
+  } else {
+    shared.errors++;
+    wake = ULP_WAKE_BUS_ERROR;
+  }
+  shared.busy = 0;
+
+  /* One wake per sleep: stop sampling until the main cores re-arm */
+  if (wake != ULP_WAKE_NONE) {
+    shared.wake_reason = wake;
+    shared.magic = 0;
+    ulp_riscv_wakeup_main_processor();
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Compare two host benchmark runs (firmware/arduino/test/bench_core).
+
+Both files are Google Benchmark JSON as written with BENCH_OUT:
+  cd firmware/arduino
+  BENCH_OUT=base.json pio test -e native_bench     # On the base commit
+  BENCH_OUT=new.json pio test -e native_bench      # With the change
+  python3 scripts/bench_compare.py base.json new.json --threshold 10
+
+Prints the per-benchmark change in cpu_time and exits 1 when any benchmark
+present in both runs got slower by more than --threshold percent.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import sys
+from dataclasses import dataclass
+from typing import Dict, List, Optional
+
+
+@dataclass
+class Delta:
+    name: str
+    base_ns: Optional[float]
+    new_ns: Optional[float]
+
+    @property
+    def change_pct(self) -> Optional[float]:
+        if not self.base_ns or self.new_ns is None:
+            return None
+        return (self.new_ns - self.base_ns) * 100.0 / self.base_ns
+
+
+def load_times(doc: dict, field: str = "cpu_time") -> Dict[str, float]:
+    """Map benchmark name -> time in ns, skipping aggregate rows."""
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+    out: Dict[str, float] = {}
+    for b in doc.get("benchmarks", []):
+        if b.get("run_type", "iteration") != "iteration":
+            continue
+        out[b["name"]] = float(b[field]) * scale.get(b.get("time_unit", "ns"), 1.0)
+    return out
+
+
+def compare(base: dict, new: dict, field: str = "cpu_time") -> List[Delta]:
+    a = load_times(base, field)
+    b = load_times(new, field)
+    names = list(a) + [n for n in b if n not in a]
+    return [Delta(n, a.get(n), b.get(n)) for n in names]
+
+
+def regressions(deltas: List[Delta], threshold_pct: float) -> List[Delta]:
+    return [d for d in deltas if d.change_pct is not None and d.change_pct > threshold_pct]
+
+
+def _fmt(ns: Optional[float]) -> str:
+    return "-" if ns is None else f"{ns:.1f}"
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description="Compare two native_bench JSON runs")
+    ap.add_argument("base")
+    ap.add_argument("new")
+    ap.add_argument("--threshold", type=float, default=10.0,
+                    help="Slowdown in percent that counts as a regression")
+    ap.add_argument("--field", choices=["cpu_time", "real_time"], default="cpu_time")
+    args = ap.parse_args()
+
+    with open(args.base) as f:
+        base = json.load(f)
+    with open(args.new) as f:
+        new = json.load(f)
+
+    deltas = compare(base, new, args.field)
+    print(f"{'Benchmark':<40} {'Base (ns)':>12} {'New (ns)':>12} {'Change':>8}")
+    for d in deltas:
+        pct = d.change_pct
+        change = "-" if pct is None else f"{pct:+.1f}%"
+        print(f"{d.name:<40} {_fmt(d.base_ns):>12} {_fmt(d.new_ns):>12} {change:>8}")
+
+    slow = regressions(deltas, args.threshold)
+    if slow:
+        print(f"{len(slow)} benchmark(s) slower than {args.threshold:g}%: "
+              + ", ".join(d.name for d in slow))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,7 +1,9 @@
 #!/usr/bin/env python3
 """
 Convert SVG weather/moon icons to 24x24 1-bit bitmaps and emit a C header
-with PROGMEM arrays suitable for Adafruit GFX drawXBitmap.
+with PROGMEM arrays suitable for Adafruit GFX drawXBitmap, plus one
+contiguous atlas of every icon in the canvas framebuffer's bit order
+(MSB first, row-aligned) for direct blits.
 
 Quality improvements:
 - Oversample SVG rasterization (default 4×) for crisp edges
@@ -154,6 +156,46 @@ def pack_xbm_bits(img_1bit: Image.Image) -> bytes:
     return bytes(out)
 
 
+def xbm_to_msb_rows(xbm: bytes) -> bytes:
+    """Reverse the bits of every byte: XBM LSB-first rows to MSB-first rows."""
+    return bytes(int(f"{b:08b}"[::-1], 2) for b in xbm)
+
+
+def atlas_lines(names: list[str], rows: dict[str, bytes]) -> list[str]:
+    """Emit the icon atlas: every icon in IconId order, one source row per line."""
+    row_bytes = (WIDTH + 7) // 8
+    stride = row_bytes * HEIGHT
+    lines: list[str] = []
+    lines.append(f"#define ICON_COUNT {len(names)}")
+    lines.append(f"#define ICON_ROW_BYTES {row_bytes}")
+    lines.append("#define ICON_ATLAS_STRIDE (ICON_ROW_BYTES * ICON_H)")
+    lines.append("")
+    lines.append("// Every icon in IconId order, ICON_ATLAS_STRIDE bytes apart; rows are")
+    lines.append("// MSB first with 1 = ink, the canvas framebuffer's bit order")
+    lines.append("static const uint8_t icon_atlas[ICON_COUNT * ICON_ATLAS_STRIDE] PROGMEM = {")
+    for name in names:
+        data = rows.get(name, bytes(stride))  # Missing SVG: blank slot keeps ids aligned
+        lines.append(f"    // {name}")
+        for r in range(HEIGHT):
+            row = data[r * row_bytes:(r + 1) * row_bytes]
+            lines.append("    " + " ".join(f"0x{b:02X}," for b in row))
+    lines.append("};")
+    lines.append("")
+    lines.append("inline const uint8_t* icon_atlas_bits(IconId id) {")
+    lines.append("    return (unsigned)id < ICON_COUNT")
+    lines.append("        ? icon_atlas + (size_t)id * ICON_ATLAS_STRIDE : nullptr;")
+    lines.append("}")
+    lines.append("")
+    lines.append("template<typename GFX>")
+    lines.append("inline void draw_icon_atlas(GFX& d, int16_t x, int16_t y,")
+    lines.append("    IconId id, uint16_t color) {")
+    lines.append("    const uint8_t* bits = icon_atlas_bits(id);")
+    lines.append("    if (bits) d.drawBitmap(x, y, bits, ICON_W, ICON_H, color);")
+    lines.append("}")
+    lines.append("")
+    return lines
+
+
 def c_array_name(name: str) -> str:
     return name.replace("-", "_") + "_24x24_bits"
 
@@ -189,6 +231,7 @@ def main() -> None:
     header_lines: list[str] = []
     header_lines.append("#pragma once")
     header_lines.append("// Copyright 2024 Justin")
+    header_lines.append("#include <stddef.h>")
     header_lines.append("#include <stdint.h>")
     header_lines.append("#include <pgmspace.h>")
     header_lines.append("")
@@ -216,6 +259,7 @@ def main() -> None:
     header_lines.append("")
 
     previews: list[tuple[str, Image.Image]] = []
+    atlas_rows: dict[str, bytes] = {}
     for name in ICON_NAMES:
         svg_path = os.path.join(SRC_DIR, f"{name}.svg")
         if not os.path.exists(svg_path):
@@ -231,6 +275,7 @@ def main() -> None:
         )
         previews.append((name, img))
         bits = pack_xbm_bits(img)
+        atlas_rows[name] = xbm_to_msb_rows(bits)
         arr_name = c_array_name(name)
         header_lines.append(f"static const uint8_t {arr_name}[] PROGMEM = {{")
         # format bytes as 0x.., and wrap to keep lines <= 80 chars
@@ -249,6 +294,8 @@ def main() -> None:
         header_lines.append("};")
         header_lines.append("")
 
+    header_lines.extend(atlas_lines(ICON_NAMES, atlas_rows))
+
     # draw helper
     header_lines.append("template<typename GFX>")
     header_lines.append("inline void draw_icon_xbm(GFX& d, int16_t x, int16_t y,")
@@ -33,6 +33,11 @@ class ManagerConfig:
     display_width: int = 250
     display_height: int = 122
 
+    # WebSocket fan-out (websocket_hub.py / fanout.py)
+    ws_max_rate_hz: float = 10.0          # Frames per second to each browser
+    ws_max_log_lines: int = 200           # Serial lines per frame; older are dropped
+    ws_screenshot_interval_sec: float = 1.0  # Per device
+
     @classmethod
     def from_args(cls, args) -> 'ManagerConfig':
         """Create config from command line arguments"""
@@ -0,0 +1,123 @@
+"""Coalescing buffer for WebSocket fan-out (see WebSocketHub.publish)
+
+With a fleet of sensors reporting, relaying each MQTT message and serial
+line to the browsers on its own floods the UI. Events are collected here
+between flushes and sent as one batch:
+
+- ``mqtt`` messages are state: only the newest per topic and direction is
+  kept, and a payload identical to the one last sent for that topic is not
+  sent again, so each flush carries only what changed.
+- ``screenshot`` frames: newest per device, at most one per
+  ``screenshot_interval`` seconds; a newer frame replaces one held back.
+- ``serial`` lines keep their order, capped at ``max_log_lines`` per flush
+  (the oldest are dropped and counted).
+- Everything else (status, mode changes) keeps its order and is never
+  dropped.
+
+Kept free of FastAPI and paho imports so it can be tested on its own.
+"""
+import itertools
+import threading
+import time
+from collections import OrderedDict, deque
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+
+def screenshot_device(message: Dict[str, Any]) -> str:
+    """Device a screenshot frame belongs to ('' when not known)"""
+    return str(message.get('device_id') or '')
+
+
+class FanoutBuffer:
+    """Events pending for the next flush; thread-safe"""
+
+    def __init__(self, max_log_lines: int = 200, screenshot_interval: float = 1.0,
+                 clock: Callable[[], float] = time.monotonic):
+        self.max_log_lines = max_log_lines
+        self.screenshot_interval = screenshot_interval
+        self._clock = clock
+        self._lock = threading.Lock()
+        # Insertion order is send order; coalesced keys keep their first slot
+        self._pending: 'OrderedDict[Tuple, Dict[str, Any]]' = OrderedDict()
+        self._log_keys: deque = deque()
+        self._seq = itertools.count()
+        self._last_payload: Dict[Tuple[str, str], Any] = {}
+        self._last_screenshot: Dict[str, float] = {}
+        self._active = False
+        self.coalesced = 0        # Replaced before they were sent
+        self.dropped = 0          # Log lines over the per-flush cap
+        self.unchanged = 0        # State identical to what browsers already have
+
+    def _key(self, message: Dict[str, Any]) -> Tuple:
+        msg_type = message.get('type')
+        if msg_type == 'mqtt' and 'topic' in message:
+            return ('mqtt', message.get('direction', 'in'), message['topic'])
+        if msg_type == 'screenshot':
+            return ('screenshot', screenshot_device(message))
+        return (msg_type, next(self._seq))
+
+    def add(self, message: Dict[str, Any]) -> bool:
+        """Queue a message; True when the buffer was idle and needs a flush"""
+        with self._lock:
+            key = self._key(message)
+            if key in self._pending:
+                self.coalesced += 1
+            elif message.get('type') == 'serial':
+                self._log_keys.append(key)
+                if len(self._log_keys) > self.max_log_lines:
+                    self._pending.pop(self._log_keys.popleft(), None)
+                    self.dropped += 1
+            self._pending[key] = message
+            was_idle = not self._active
+            self._active = True
+            return was_idle
+
+    def drain(self) -> List[Dict[str, Any]]:
+        """Messages to send now, in arrival order.
+
+        Screenshots still inside their device's interval stay queued. The
+        buffer goes idle once nothing is left, and the next add() then
+        reports that a flush is needed.
+        """
+        now = self._clock()
+        out: List[Dict[str, Any]] = []
+        with self._lock:
+            held: 'OrderedDict[Tuple, Dict[str, Any]]' = OrderedDict()
+            for key, message in self._pending.items():
+                kind = key[0]
+                if kind == 'mqtt':
+                    topic = (key[1], key[2])
+                    payload = message.get('payload')
+                    if self._last_payload.get(topic) == payload:
+                        self.unchanged += 1
+                        continue
+                    self._last_payload[topic] = payload
+                elif kind == 'screenshot':
+                    last = self._last_screenshot.get(key[1])
+                    if last is not None and now - last < self.screenshot_interval:
+                        held[key] = message
+                        continue
+                    self._last_screenshot[key[1]] = now
+                out.append(message)
+            self._pending = held
+            self._log_keys.clear()
+            self._active = bool(held)
+        return out
+
+    def next_due(self) -> Optional[float]:
+        """Seconds until a held screenshot may go out; None if none is held"""
+        now = self._clock()
+        with self._lock:
+            waits = [self._last_screenshot.get(key[1], now) + self.screenshot_interval - now
+                     for key in self._pending if key[0] == 'screenshot']
+        return max(0.0, min(waits)) if waits else None
+
+    def forget(self):
+        """Drop the sent-state memory (a new browser needs everything again)"""
+        with self._lock:
+            self._last_payload.clear()
+
+    def stats(self) -> Dict[str, int]:
+        with self._lock:
+            return {'pending': len(self._pending), 'coalesced': self.coalesced,
+                    'dropped': self.dropped, 'unchanged': self.unchanged}
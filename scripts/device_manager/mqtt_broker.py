@@ -2,10 +2,16 @@
 import asyncio
 import logging
 import time
+from concurrent.futures import ThreadPoolExecutor
 from typing import Dict, Any, List, Optional, Callable
 from collections import deque
 import paho.mqtt.client as mqtt
 
+try:
+    from ..mqtt_topics import TELEMETRY_TOPIC_SUFFIX, decode_telemetry_frame
+except ImportError:  # Imported as a top-level package with scripts/ on sys.path
+    from mqtt_topics import TELEMETRY_TOPIC_SUFFIX, decode_telemetry_frame
+
 logger = logging.getLogger(__name__)
 
 # Check paho-mqtt version for API compatibility
@@ -35,13 +41,22 @@ class MQTTMessage:
         except UnicodeDecodeError:
             payload_str = self.payload.hex()
 
-        return {
+        result = {
             'topic': self.topic,
             'payload': payload_str,
             'direction': self.direction,
             'timestamp': self.timestamp
         }
 
+        # Binary telemetry frames are also shown decoded
+        if self.topic.endswith('/' + TELEMETRY_TOPIC_SUFFIX):
+            try:
+                result['decoded'] = decode_telemetry_frame(bytes(self.payload))
+            except ValueError as e:
+                logger.debug(f"Undecodable telemetry frame on {self.topic}: {e}")
+
+        return result
+
 
 class SimpleMQTTBroker:
     """
@@ -61,6 +76,10 @@ class SimpleMQTTBroker:
         self.subscriptions: Dict[str, int] = {}  # topic -> qos
         self.message_callbacks: List[Callable] = []
         self._loop: Optional[asyncio.AbstractEventLoop] = None  # Store event loop reference
+        # Decoding (telemetry frames, screenshot reassembly and PNG conversion)
+        # runs on one worker so the paho network thread keeps draining the
+        # socket under a burst; one worker keeps each topic in order
+        self._decoder: Optional[ThreadPoolExecutor] = None
     
     def _schedule_async(self, coro):
         """Schedule an async coroutine from a sync callback (thread-safe)"""
@@ -78,6 +97,7 @@ class SimpleMQTTBroker:
 
         # Store event loop reference for thread-safe async scheduling
         self._loop = asyncio.get_running_loop()
+        self._decoder = ThreadPoolExecutor(max_workers=1, thread_name_prefix="mqtt-decode")
 
         try:
             # Create MQTT client (compatible with paho-mqtt v1 and v2)
@@ -131,6 +151,10 @@ class SimpleMQTTBroker:
             self.client.disconnect()
             self.client = None
 
+        if self._decoder:
+            self._decoder.shutdown(wait=False)
+            self._decoder = None
+
     def _on_connect(self, client, userdata, flags, rc):
         """Callback when connected to MQTT broker"""
         if rc == 0:
@@ -173,18 +197,29 @@ class SimpleMQTTBroker:
         # Add to log
         self.message_log.append(mqtt_msg)
 
-        # Call registered callbacks
+        decoder = self._decoder
+        if decoder:
+            try:
+                decoder.submit(self._dispatch, mqtt_msg)
+                return
+            except RuntimeError:
+                pass  # Shutting down
+        self._dispatch(mqtt_msg)
+
+    def _dispatch(self, mqtt_msg: MQTTMessage):
+        """Run the registered callbacks and queue the message for the web UI"""
         for callback in self.message_callbacks:
             try:
                 callback(mqtt_msg)
             except Exception as e:
                 logger.error(f"Error in message callback: {e}")
 
-        # Broadcast to WebSocket clients (thread-safe)
-        self._schedule_async(self.hub.broadcast({
-            'type': 'mqtt',
-            **mqtt_msg.to_dict()
-        }))
+        # Coalesced and batched by the hub (thread-safe)
+        if self.hub:
+            self.hub.publish({
+                'type': 'mqtt',
+                **mqtt_msg.to_dict()
+            })
 
     def _on_publish(self, client, userdata, mid):
         """Callback when message is published"""
@@ -214,11 +249,12 @@ class SimpleMQTTBroker:
             )
             self.message_log.append(mqtt_msg)
 
-            # Broadcast to WebSocket clients (thread-safe)
-            self._schedule_async(self.hub.broadcast({
-                'type': 'mqtt',
-                **mqtt_msg.to_dict()
-            }))
+            # Coalesced and batched by the hub (thread-safe)
+            if self.hub:
+                self.hub.publish({
+                    'type': 'mqtt',
+                    **mqtt_msg.to_dict()
+                })
 
             logger.debug(f"Published to {topic}: {payload_bytes[:100]}")
             return True
@@ -1,14 +1,61 @@
 """Screenshot handler for ESP32 display capture"""
 import base64
 import logging
+import zlib
 from typing import Optional, Dict, Any
 from io import BytesIO
 from PIL import Image
-import asyncio
 
 logger = logging.getLogger(__name__)
 
 
+def decode_packbits(data: bytes, expected: int) -> bytes:
+    """Decode a PackBits stream (firmware/arduino/src/capture_codec.h).
+
+    Header h < 128: h + 1 literal bytes follow; h > 128: the next byte
+    repeats 257 - h times; h == 128 is a no-op.
+
+    Raises:
+        ValueError: if the stream is truncated or does not decode to exactly
+            ``expected`` bytes
+    """
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        h = data[i]
+        i += 1
+        if h < 128:
+            count = h + 1
+            if i + count > n:
+                raise ValueError("truncated literal packet")
+            out += data[i:i + count]
+            i += count
+        elif h > 128:
+            if i >= n:
+                raise ValueError("truncated run packet")
+            out += bytes([data[i]]) * (257 - h)
+            i += 1
+        if len(out) > expected:
+            raise ValueError(f"stream decodes past {expected} bytes")
+    if len(out) != expected:
+        raise ValueError(f"stream decodes to {len(out)} bytes, expected {expected}")
+    return bytes(out)
+
+
+def device_from_topic(topic: str) -> str:
+    """Device id of an ``espsensor/<device>/...`` topic ('' otherwise)"""
+    parts = topic.split('/')
+    return parts[1] if len(parts) > 2 and parts[0] == 'espsensor' else ''
+
+
+def apply_delta(delta: bytes, base: bytes) -> bytes:
+    """XOR a decoded delta frame back onto its base frame."""
+    if len(delta) != len(base):
+        raise ValueError("delta and base frame sizes differ")
+    return bytes(a ^ b for a, b in zip(delta, base))
+
+
 class ScreenshotHandler:
     """Handles screenshot requests and conversions from ESP32 devices"""
 
@@ -21,6 +68,11 @@ class ScreenshotHandler:
         self.latest_screenshot: Optional[bytes] = None
         self.latest_metadata: Optional[Dict[str, Any]] = None
 
+        # Chunks of the screenshot in flight, keyed by chunk index
+        self._chunks: Dict[int, bytes] = {}
+        # Last decoded compressed frame; base for the device's next delta
+        self._last_frame: Optional[bytes] = None
+
         # Display dimensions
         self.display_width = config.display_width if config else 250
         self.display_height = config.display_height if config else 122
@@ -47,34 +99,47 @@ class ScreenshotHandler:
             import json
             metadata = json.loads(message.payload.decode('utf-8'))
             self.latest_metadata = metadata
+            self._chunks = {}
             logger.info(f"Received screenshot metadata: {metadata}")
 
-            # Broadcast metadata
+            # Broadcast metadata (thread-safe; batched by the hub)
             if self.hub:
-                asyncio.create_task(self.hub.broadcast({
+                self.hub.publish({
                     'type': 'screenshot_meta',
+                    'device_id': device_from_topic(message.topic),
                     'metadata': metadata
-                }))
+                })
 
         except Exception as e:
             logger.error(f"Error parsing screenshot metadata: {e}")
 
     def _handle_screenshot_data(self, message):
-        """Handle screenshot data message"""
+        """Handle screenshot data message (one chunk or the whole frame)"""
         try:
-            # Decode base64 data
-            data_b64 = message.payload.decode('utf-8')
-            data_bytes = base64.b64decode(data_b64)
+            meta = self.latest_metadata or {}
+            suffix = message.topic.rsplit('/debug/screenshot/data', 1)[-1]
+            index = int(suffix[1:]) if suffix.startswith('/') and suffix[1:].isdigit() else 0
+            self._chunks[index] = bytes(message.payload)
+
+            if meta.get('format') == 'packbits':
+                if len(self._chunks) < int(meta.get('chunks', 1)):
+                    return
+                data_bytes = self._decode_compressed(meta)
+                if data_bytes is None:
+                    return
+            else:
+                # Legacy base64: wait until every chunk announced by data_size is in
+                data_b64 = b''.join(self._chunks[i] for i in sorted(self._chunks))
+                if len(data_b64) < int(meta.get('data_size', 0)):
+                    return
+                data_bytes = base64.b64decode(data_b64)
+            self._chunks = {}
 
             logger.info(f"Received screenshot data: {len(data_bytes)} bytes")
 
             # Use metadata if available, otherwise use defaults
-            width = self.display_width
-            height = self.display_height
-
-            if self.latest_metadata:
-                width = self.latest_metadata.get('width', width)
-                height = self.latest_metadata.get('height', height)
+            width = meta.get('width', self.display_width)
+            height = meta.get('height', self.display_height)
 
             # Convert to PNG
             png_data = self._convert_1bit_to_png(data_bytes, width, height)
@@ -85,21 +150,48 @@ class ScreenshotHandler:
                 # Convert to base64 for transmission
                 png_b64 = base64.b64encode(png_data).decode('utf-8')
 
-                # Broadcast screenshot
+                # Broadcast screenshot; the hub sends at most one frame per
+                # device per screenshot interval, the newest
                 if self.hub:
-                    asyncio.create_task(self.hub.broadcast({
+                    self.hub.publish({
                         'type': 'screenshot',
+                        'device_id': device_from_topic(message.topic),
                         'data': png_b64,
                         'width': width,
                         'height': height,
                         'format': 'png'
-                    }))
+                    })
 
                 logger.info(f"Screenshot converted and broadcasted: {width}x{height}")
 
         except Exception as e:
             logger.error(f"Error handling screenshot data: {e}")
 
+    def _decode_compressed(self, meta: Dict[str, Any]) -> Optional[bytes]:
+        """Reassemble, decode and (for deltas) apply a PackBits screenshot"""
+        stream = b''.join(self._chunks[i] for i in sorted(self._chunks))
+        self._chunks = {}
+        frame = decode_packbits(stream, int(meta['buffer_size']))
+
+        if meta.get('delta'):
+            base = self._last_frame
+            if base is None or zlib.crc32(base) != int(meta.get('base_crc', -1)):
+                # Next request asks for a keyframe
+                logger.warning("Screenshot delta does not match the last frame; dropped")
+                self._last_frame = None
+                return None
+            frame = apply_delta(frame, base)
+
+        if 'crc' in meta and zlib.crc32(frame) != int(meta['crc']):
+            logger.warning("Screenshot CRC mismatch; dropped")
+            self._last_frame = None
+            return None
+
+        self._last_frame = frame
+        logger.info(f"Decoded {'delta' if meta.get('delta') else 'keyframe'} screenshot "
+                    f"from {len(stream)} bytes")
+        return frame
+
     def _convert_1bit_to_png(self, data: bytes, width: int, height: int) -> Optional[bytes]:
         """
         Convert 1-bit packed display buffer to PNG.
@@ -117,8 +209,9 @@ class ScreenshotHandler:
             PNG image as bytes
         """
         try:
-            # Calculate expected data size
-            expected_bytes = (width * height + 7) // 8  # Round up to nearest byte
+            # Rows are padded to whole bytes (GFXcanvas1 layout)
+            stride = (width + 7) // 8
+            expected_bytes = stride * height
 
             if len(data) < expected_bytes:
                 logger.warning(
@@ -131,22 +224,18 @@ class ScreenshotHandler:
             img = Image.new('1', (width, height), 1)  # Start with white
 
             # Unpack bits and set pixels
-            bit_index = 0
             for y in range(height):
                 for x in range(width):
                     # Calculate byte and bit position
-                    byte_index = bit_index // 8
-                    bit_position = 7 - (bit_index % 8)  # MSB first
-
-                    if byte_index < len(data):
-                        # Extract bit
-                        byte_val = data[byte_index]
-                        pixel_val = (byte_val >> bit_position) & 1
+                    byte_index = y * stride + x // 8
+                    bit_position = 7 - (x % 8)  # MSB first
 
-                        # Set pixel (1 = black, 0 = white for e-ink)
-                        img.putpixel((x, y), pixel_val)
+                    # Extract bit
+                    byte_val = data[byte_index]
+                    pixel_val = (byte_val >> bit_position) & 1
 
-                    bit_index += 1
+                    # Set pixel (1 = black, 0 = white for e-ink)
+                    img.putpixel((x, y), pixel_val)
 
             # Convert to RGB for better compatibility
             img_rgb = img.convert('RGB')
@@ -170,9 +259,11 @@ class ScreenshotHandler:
             return False
 
         try:
-            # Publish screenshot request command
+            # Publish screenshot request command; compressed, and a delta
+            # once there is a frame to apply it to
             topic = f"espsensor/{device_id}/cmd/screenshot"
-            self.mqtt_broker.publish(topic, "capture", retain=False)
+            mode = "delta" if self._last_frame is not None else "rle"
+            self.mqtt_broker.publish(topic, mode, retain=False)
 
             logger.info(f"Screenshot requested for device: {device_id}")
             return True
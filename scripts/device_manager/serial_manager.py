@@ -177,7 +177,8 @@ class SerialManager:
         except json.JSONDecodeError:
             pass
 
-        # Broadcast to WebSocket clients
+        # Broadcast to WebSocket clients (from the reader thread; the hub
+        # batches bursts and caps the lines per frame)
         if self.hub:
             message = {
                 'type': 'serial',
@@ -188,7 +189,7 @@ class SerialManager:
             if structured_data:
                 message['structured'] = structured_data
 
-            asyncio.create_task(self.hub.broadcast(message))
+            self.hub.publish(message)
 
     def get_status(self) -> Dict[str, Any]:
         """Get current serial connection status"""
@@ -16,6 +16,7 @@ from .flash_manager import FlashManager
 from .mqtt_broker import SimpleMQTTBroker
 from .mqtt_simulator import MqttSimulator
 from .screenshot_handler import ScreenshotHandler
+from .trace_handler import TraceHandler
 from .mdns_discovery import get_discovery, MDNSDiscovery
 from .device_tracker import get_tracker, DeviceTracker, DeviceMode, SLEEP_PRESETS
 from .config import ManagerConfig
@@ -41,12 +42,14 @@ app.add_middleware(
 
 # Global instances
 config = ManagerConfig()
-hub = WebSocketHub()
+hub = WebSocketHub(max_rate_hz=config.ws_max_rate_hz, max_log_lines=config.ws_max_log_lines,
+                   screenshot_interval=config.ws_screenshot_interval_sec)
 serial_manager = SerialManager(websocket_hub=hub)
 flash_manager = FlashManager(websocket_hub=hub, config=config)
 mqtt_broker = SimpleMQTTBroker(websocket_hub=hub, port=config.mqtt_broker_port)
 mqtt_simulator = MqttSimulator(broker=mqtt_broker, config=config)
 screenshot_handler = ScreenshotHandler(mqtt_broker=mqtt_broker, websocket_hub=hub, config=config)
+trace_handler = TraceHandler(mqtt_broker=mqtt_broker, websocket_hub=hub)
 
 # mDNS discovery for finding devices on the network
 mdns_discovery = get_discovery()
@@ -171,7 +174,8 @@ async def health_check():
                 "broker_port": mqtt_status.get("port", config.mqtt_broker_port)
             },
             "websocket": {
-                "active_connections": len(hub.clients) if hub else 0
+                "active_connections": len(hub.clients) if hub else 0,
+                "fanout": hub.get_stats() if hub else {}
             },
             "discovery": {
                 "available": mdns_discovery.available if mdns_discovery else False,
@@ -511,6 +515,30 @@ async def get_test_screenshot():
         raise HTTPException(status_code=500, detail=str(e))
 
 
+@app.post("/api/device/trace")
+async def request_trace(device_id: str = "office"):
+    """Ask the device to dump its trace ring"""
+    try:
+        success = trace_handler.request_trace(device_id)
+        if success:
+            return {"status": "requested", "device_id": device_id}
+        else:
+            raise HTTPException(status_code=500, detail="Failed to request trace")
+    except Exception as e:
+        logger.error(f"Error requesting trace: {e}")
+        raise HTTPException(status_code=500, detail=str(e))
+
+
+@app.get("/api/device/trace/latest")
+async def get_latest_trace():
+    """Latest trace as Chrome trace_event JSON (load in Perfetto or chrome://tracing)"""
+    trace = trace_handler.get_latest_trace()
+    if not trace:
+        return {"traceEvents": [], "message": "No trace available"}
+    return JSONResponse(content=trace,
+                        headers={"Content-Disposition": 'inline; filename="trace.json"'})
+
+
 @app.post("/api/device/command")
 async def send_device_command(request: DeviceCommandRequest):
     """Send command to device via MQTT"""
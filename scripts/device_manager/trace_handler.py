@@ -0,0 +1,139 @@
+"""Trace handler for the firmware's hot-path trace ring (firmware/arduino/src/trace.h)"""
+import json
+import logging
+from typing import Optional, Dict, Any, List
+
+logger = logging.getLogger(__name__)
+
+# All events come from one device, so one process id
+TRACE_PID = 1
+
+
+def build_chrome_trace(meta: Dict[str, Any], chunks: List[List[list]],
+                       device_id: str = "") -> Dict[str, Any]:
+    """Expand compact firmware trace chunks into Chrome trace_event JSON.
+
+    Chunk events are ``[ts, "B", tid, name]`` or ``[ts, "E", tid]``. An end
+    event with no open begin on its task lost its begin to ring wraparound
+    and is dropped; begins still open at dump time are left open, which
+    trace viewers draw as unfinished slices.
+    """
+    events: List[Dict[str, Any]] = [
+        {"name": "process_name", "ph": "M", "pid": TRACE_PID, "tid": 0,
+         "args": {"name": device_id or "device"}},
+    ]
+    for tid, name in meta.get("tasks", []):
+        events.append({"name": "thread_name", "ph": "M", "pid": TRACE_PID, "tid": int(tid),
+                       "args": {"name": name}})
+
+    depth: Dict[int, int] = {}
+    dropped = 0
+    for chunk in chunks:
+        for ev in chunk:
+            ts, ph, tid = int(ev[0]), ev[1], int(ev[2])
+            if ph == "B":
+                depth[tid] = depth.get(tid, 0) + 1
+                events.append({"name": ev[3], "ph": "B", "ts": ts, "pid": TRACE_PID, "tid": tid})
+            elif ph == "E":
+                if depth.get(tid, 0) == 0:
+                    dropped += 1
+                    continue
+                depth[tid] -= 1
+                events.append({"ph": "E", "ts": ts, "pid": TRACE_PID, "tid": tid})
+
+    return {
+        "traceEvents": events,
+        "displayTimeUnit": "ms",
+        "otherData": {
+            "device_id": device_id,
+            "events": meta.get("events", 0),
+            "overwritten": meta.get("overwritten", 0),
+            "skipped": meta.get("skipped", 0),
+            "orphan_ends": dropped,
+            "now_us": meta.get("now_us", 0),
+        },
+    }
+
+
+class TraceHandler:
+    """Collects trace dumps from devices and keeps the latest as Chrome JSON"""
+
+    def __init__(self, mqtt_broker=None, websocket_hub=None):
+        self.mqtt_broker = mqtt_broker
+        self.hub = websocket_hub
+
+        self.latest_trace: Optional[Dict[str, Any]] = None
+
+        # Dump in flight
+        self._meta: Optional[Dict[str, Any]] = None
+        self._device_id = ""
+        self._chunks: Dict[int, List[list]] = {}
+
+        if self.mqtt_broker:
+            self.mqtt_broker.add_message_callback(self._on_mqtt_message)
+
+    def _on_mqtt_message(self, message):
+        """Handle incoming MQTT messages"""
+        topic = message.topic
+        if '/debug/trace/meta' in topic:
+            self._handle_meta(message)
+        elif '/debug/trace/data/' in topic:
+            self._handle_data(message)
+
+    def _handle_meta(self, message):
+        try:
+            self._meta = json.loads(message.payload.decode('utf-8'))
+            parts = message.topic.split('/')
+            self._device_id = parts[1] if len(parts) > 1 else ""
+            self._chunks = {}
+            logger.info(f"Receiving trace: {self._meta.get('events', 0)} events "
+                        f"in {self._meta.get('chunks', 0)} chunks")
+            if int(self._meta.get('chunks', 0)) == 0:
+                self._complete()
+        except Exception as e:
+            logger.error(f"Error parsing trace metadata: {e}")
+
+    def _handle_data(self, message):
+        try:
+            if self._meta is None:
+                return
+            suffix = message.topic.rsplit('/debug/trace/data/', 1)[-1]
+            if not suffix.isdigit():
+                return
+            self._chunks[int(suffix)] = json.loads(message.payload.decode('utf-8'))
+            if len(self._chunks) >= int(self._meta.get('chunks', 0)):
+                self._complete()
+        except Exception as e:
+            logger.error(f"Error handling trace data: {e}")
+
+    def _complete(self):
+        chunks = [self._chunks[i] for i in sorted(self._chunks)]
+        self.latest_trace = build_chrome_trace(self._meta or {}, chunks, self._device_id)
+        self._meta = None
+        self._chunks = {}
+        logger.info(f"Trace assembled: {len(self.latest_trace['traceEvents'])} events")
+
+        if self.hub:
+            self.hub.publish({
+                'type': 'trace',
+                'device_id': self._device_id,
+                'events': len(self.latest_trace['traceEvents']),
+            })
+
+    def request_trace(self, device_id: str = "office") -> bool:
+        """Ask the device to publish its trace ring"""
+        if not self.mqtt_broker:
+            logger.warning("MQTT broker not available")
+            return False
+        try:
+            topic = f"espsensor/{device_id}/cmd/debug"
+            self.mqtt_broker.publish(topic, json.dumps({"cmd": "trace"}), retain=False)
+            logger.info(f"Trace requested for device: {device_id}")
+            return True
+        except Exception as e:
+            logger.error(f"Error requesting trace: {e}")
+            return False
+
+    def get_latest_trace(self) -> Optional[Dict[str, Any]]:
+        """Latest trace in Chrome trace_event format, or None"""
+        return self.latest_trace
@@ -1,25 +1,47 @@
 """WebSocket Hub for broadcasting messages to all connected clients"""
 import json
 import asyncio
-from typing import Set, Dict, Any
+import time
+from typing import Set, Dict, Any, List, Optional
 from fastapi import WebSocket
 import logging
 
+from .fanout import FanoutBuffer
+
 logger = logging.getLogger(__name__)
 
+# A client that takes longer than this to accept a frame is dropped
+SEND_TIMEOUT_SEC = 5.0
+
 
 class WebSocketHub:
-    """Manages WebSocket connections and broadcasts messages"""
+    """Manages WebSocket connections and broadcasts messages
+
+    broadcast() sends one message right away. publish() is for device
+    traffic (MQTT, serial, screenshots): it may be called from any thread,
+    and messages are coalesced (fanout.py) and sent at most max_rate_hz
+    times a second, several to a frame as {'type': 'batch', 'messages': [...]}.
+    """
 
-    def __init__(self):
+    def __init__(self, max_rate_hz: float = 10.0, max_log_lines: int = 200,
+                 screenshot_interval: float = 1.0):
         self.clients: Set[WebSocket] = set()
         self._lock = asyncio.Lock()
+        self.min_flush_interval = 1.0 / max_rate_hz if max_rate_hz > 0 else 0.0
+        self._buffer = FanoutBuffer(max_log_lines=max_log_lines,
+                                    screenshot_interval=screenshot_interval)
+        self._loop: Optional[asyncio.AbstractEventLoop] = None
+        self._last_flush = 0.0
+        self.frames_sent = 0
 
     async def connect(self, websocket: WebSocket):
         """Accept a new WebSocket connection"""
         await websocket.accept()
+        self._loop = asyncio.get_running_loop()
         async with self._lock:
             self.clients.add(websocket)
+        # The newcomer has none of the state sent so far
+        self._buffer.forget()
         logger.info(f"WebSocket client connected. Total clients: {len(self.clients)}")
 
     async def disconnect(self, websocket: WebSocket):
@@ -28,25 +50,65 @@ class WebSocketHub:
             self.clients.discard(websocket)
         logger.info(f"WebSocket client disconnected. Total clients: {len(self.clients)}")
 
+    async def _send_all(self, data: str):
+        """Send one frame to every client; clients that fail are removed"""
+        async with self._lock:
+            clients = list(self.clients)
+            results = await asyncio.gather(
+                *[asyncio.wait_for(client.send_text(data), SEND_TIMEOUT_SEC) for client in clients],
+                return_exceptions=True)
+            for client, result in zip(clients, results):
+                if isinstance(result, BaseException):
+                    logger.warning(f"Error broadcasting to client: {result}")
+                    self.clients.discard(client)
+
     async def broadcast(self, message: Dict[str, Any]):
         """Send message to all connected clients"""
         if not self.clients:
             return
+        await self._send_all(json.dumps(message))
 
-        data = json.dumps(message)
-        disconnected = set()
+    def publish(self, message: Dict[str, Any]):
+        """Queue device traffic for the next batched frame (thread-safe)"""
+        loop = self._loop
+        if not self.clients or loop is None or loop.is_closed():
+            return
+        if self._buffer.add(message):
+            try:
+                loop.call_soon_threadsafe(self._start_flush)
+            except RuntimeError:
+                pass  # Loop is shutting down
 
-        async with self._lock:
-            for client in self.clients:
-                try:
-                    await client.send_text(data)
-                except Exception as e:
-                    logger.warning(f"Error broadcasting to client: {e}")
-                    disconnected.add(client)
-
-            # Remove disconnected clients
-            for client in disconnected:
-                self.clients.discard(client)
+    def _start_flush(self):
+        asyncio.ensure_future(self._flush_loop())
+
+    async def _flush_loop(self):
+        """Send batches at the capped rate until the buffer is idle"""
+        while True:
+            wait = self._last_flush + self.min_flush_interval - time.monotonic()
+            if wait > 0:
+                await asyncio.sleep(wait)
+            messages = self._buffer.drain()
+            self._last_flush = time.monotonic()
+            if messages and self.clients:
+                await self._send_frame(messages)
+            due = self._buffer.next_due()
+            if due is None:
+                return  # Idle; the next publish() starts a new loop
+            await asyncio.sleep(due)
+
+    async def _send_frame(self, messages: List[Dict[str, Any]]):
+        if len(messages) == 1:
+            frame = messages[0]
+        else:
+            frame = {'type': 'batch', 'messages': messages}
+        self.frames_sent += 1
+        await self._send_all(json.dumps(frame))
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Fan-out counters for the health endpoint"""
+        return {'clients': len(self.clients), 'frames_sent': self.frames_sent,
+                **self._buffer.stats()}
 
     async def handle_message(self, websocket: WebSocket, message: Dict[str, Any]):
         """Handle incoming message from client"""
@@ -1,4 +1,5 @@
 #!/usr/bin/env python3
+import json
 import os
 import subprocess
 import sys
@@ -62,6 +63,95 @@ def c_string(s: str) -> str:
     return '"' + str(s).replace("\\", r"\\").replace('"', r"\"") + '"'
 
 
+def ha_device_json_tail(room_name: str, fw_version: str) -> str:
+    # Constant part of the Home Assistant "device" block; the firmware
+    # prepends {"identifiers":["<id>"], at runtime
+    return (
+        '"name":' + json.dumps(f"{room_name} Sensor") + ","
+        '"model":"ESP32 Environmental Sensor",'
+        '"manufacturer":"DIY",'
+        '"sw_version":' + json.dumps(fw_version) + "}"
+    )
+
+
+# Settings checked against firmware/arduino/src/config_schema.h. Strict rows
+# fail the build when out of range; advisory rows are only logged at boot.
+# (device.yaml key, macro, min, max, fallback, strict)
+CONFIG_RANGES = [
+    ("wake_interval", "WAKE_INTERVAL_SEC", 60, 86400, 3600, True),
+    ("full_refresh_every", "FULL_REFRESH_EVERY", 1, 100, 10, True),
+    ("mqtt.port", "MQTT_PORT", 1, 65535, 1883, True),
+    ("active_seconds", "ACTIVE_SECONDS", 5, 300, 10, False),
+    ("thresholds.temp_degC", "THRESH_TEMP_C", 0.01, 10, 0.1, False),
+    ("thresholds.rh_pct", "THRESH_RH_PCT", 0.1, 20, 1.0, False),
+]
+
+# (device.yaml key, macro, min length, max length); the maximum is checked at
+# compile time, the minimum at boot so unconfigured builds still compile
+CONFIG_STRINGS = [
+    ("room_name", "ROOM_NAME", 1, 63),
+    ("wifi.ssid", "WIFI_SSID", 1, 32),
+    ("wifi.password", "WIFI_PASS", 1, 64),
+    ("mqtt.host", "MQTT_HOST", 1, 63),
+]
+
+
+def key_hash(key: str) -> int:
+    # FNV-1a, matching config_key_hash() in config_schema.h
+    h = 0x811C9DC5
+    for b in key.encode("utf-8"):
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def config_schema_block() -> str:
+    hashes = [key_hash(row[0]) for row in CONFIG_RANGES + CONFIG_STRINGS]
+    if len(set(hashes)) != len(hashes):
+        raise SystemExit("config schema key hashes collide; rename a key")
+    lines = [
+        "",
+        "// Validation tables (see config_schema.h)",
+        "#ifdef __cplusplus",
+        '#include "config_schema.h"',
+        "",
+        "static constexpr ConfigRange CONFIG_RANGES[] = {",
+    ]
+    for key, macro, lo, hi, fallback, strict in CONFIG_RANGES:
+        severity = "CONFIG_STRICT" if strict else "CONFIG_ADVISORY"
+        lines.append(
+            f"  {{{c_string(key)}, 0x{key_hash(key):08X}u, {macro}, {lo}, {hi}, {fallback}, {severity}}},"
+        )
+    lines.append("};")
+    lines.append("static constexpr ConfigString CONFIG_STRINGS[] = {")
+    for key, macro, lo, hi in CONFIG_STRINGS:
+        lines.append(
+            f"  {{{c_string(key)}, 0x{key_hash(key):08X}u, {macro}, sizeof({macro}) - 1, {lo}, {hi}}},"
+        )
+    lines.append("};")
+    lines.append("static constexpr size_t CONFIG_RANGE_COUNT = sizeof(CONFIG_RANGES) / sizeof(CONFIG_RANGES[0]);")
+    lines.append("static constexpr size_t CONFIG_STRING_COUNT = sizeof(CONFIG_STRINGS) / sizeof(CONFIG_STRINGS[0]);")
+    lines.append("")
+    lines.append("static_assert(config_hashes_match(CONFIG_RANGES, CONFIG_RANGE_COUNT) &&")
+    lines.append("              config_hashes_match(CONFIG_STRINGS, CONFIG_STRING_COUNT),")
+    lines.append('              "config key hashes out of sync with config_schema.h");')
+    lines.append("static_assert(config_hashes_unique(CONFIG_RANGES, CONFIG_RANGE_COUNT) &&")
+    lines.append("              config_hashes_unique(CONFIG_STRINGS, CONFIG_STRING_COUNT),")
+    lines.append('              "config key hashes collide");')
+    for i, (key, _macro, lo, hi, _fallback, strict) in enumerate(CONFIG_RANGES):
+        if strict:
+            lines.append(
+                f"static_assert(config_range_ok(CONFIG_RANGES[{i}]), "
+                f"{c_string(f'{key} must be {lo}..{hi} (config/device.yaml)')});"
+            )
+    for i, (key, _macro, _lo, hi) in enumerate(CONFIG_STRINGS):
+        lines.append(
+            f"static_assert(config_string_fits(CONFIG_STRINGS[{i}]), "
+            f"{c_string(f'{key} longer than {hi} characters (config/device.yaml)')});"
+        )
+    lines.append("#endif")
+    return "\n".join(lines) + "\n"
+
+
 def main():
     prj = os.path.abspath(os.path.join(os.path.dirname(__file__), os.pardir))
     cfg_dir = os.path.join(prj, "config")
@@ -119,9 +209,9 @@ def main():
     low_pct = int(battery.get("low_pct", 20) or 20)
     # thresholds for redraw skipping
     thresholds = data.get("thresholds", {})
-    # Optional firmware version: allow explicit config/env, else fallback to
-    # git
-    fw_version = str(data.get("fw_version", "") or os.environ.get("FW_VERSION", "") or "")
+    # Optional firmware version: FW_VERSION env (release builds set it from
+    # the tag) overrides config, else fallback to git
+    fw_version = str(os.environ.get("FW_VERSION", "") or data.get("fw_version", "") or "")
     if not fw_version:
         try:
             fw_version = (
@@ -212,6 +302,10 @@ def main():
         f.write(f"#define BATTERY_LOW_PCT {low_pct}\n")
         f.write(f"#define THRESH_TEMP_C {thresh_temp_c}\n")
         f.write(f"#define THRESH_RH_PCT {thresh_rh_pct}\n")
+        # Home Assistant discovery templates, already JSON-escaped
+        f.write(f"#define HA_ROOM_NAME_JSON {c_string(json.dumps(room_name)[1:-1])}\n")
+        f.write(f"#define HA_DEVICE_JSON_TAIL {c_string(ha_device_json_tail(room_name, fw_version))}\n")
+        f.write(config_schema_block())
     print(f"Wrote {out_path}")
 
 
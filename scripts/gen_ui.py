@@ -121,22 +121,21 @@ def load_ui_spec() -> Dict[str, Any]:
     return data
 
 
-def emit_fw_header(spec: Dict[str, Any]) -> str:
-    canvas = spec.get("canvas", {})
-    w = int(canvas.get("w", 250))
-    h = int(canvas.get("h", 122))
-    # Build explicit variant ordering: MINIMAL=0 if present, then V1, V2 if present
+def variant_order(spec: Dict[str, Any]) -> list[str]:
+    """VariantId order: minimal, v1, v2 when present, then the rest sorted."""
     variants = spec.get("variants", {})
-    order: list[str] = []
-    if "minimal" in variants:
-        order.append("minimal")
-    for name in ["v1", "v2"]:
-        if name in variants:
-            order.append(name)
-    # Fallback: append any others not already listed in sorted order
+    order = [name for name in ("minimal", "v1", "v2") if name in variants]
     for name in sorted(variants.keys()):
         if name not in order:
             order.append(name)
+    return order
+
+
+def emit_fw_header(spec: Dict[str, Any]) -> str:
+    canvas = spec.get("canvas", {})
+    w = int(canvas.get("w", 250))
+    h = int(canvas.get("h", 122))
+    order = variant_order(spec)
     lines: list[str] = []
     lines.append("// AUTO-GENERATED by scripts/gen_ui.py — DO NOT EDIT")
     lines.append(f"// source: {UI_SPEC_PATH.as_posix()}")
@@ -363,16 +362,7 @@ def emit_fw_ops_header(spec: Dict[str, Any]) -> str:
     components = spec.get("components", {})
     rects = spec.get("rects", {})
     fonts_tokens = (spec.get("fonts") or {}).get("tokens") or {}
-    # Stable variant order
-    order: list[str] = []
-    if "minimal" in variants:
-        order.append("minimal")
-    for name in ["v1", "v2"]:
-        if name in variants and name not in order:
-            order.append(name)
-    for name in sorted(variants.keys()):
-        if name not in order:
-            order.append(name)
+    order = variant_order(spec)
     lines: list[str] = []
     lines.append("// AUTO-GENERATED by scripts/gen_ui.py — DO NOT EDIT")
     lines.append(f"// source: {UI_SPEC_PATH.as_posix()}")
@@ -420,21 +410,60 @@ def emit_fw_ops_header(spec: Dict[str, Any]) -> str:
         lines.append(f"    {enum_name},")
     lines.append("};")
     lines.append("")
-    # Simple op header (future: multiple op payload shapes)
+    # FieldId enum: every {field} bound by a template or op source
+    lines.append("enum FieldId {")
+    for name in collect_fields(spec):
+        lines.append(f"    FIELD_{name.upper()},")
+    lines.append("    FIELD__COUNT,")
+    lines.append("};")
+    lines.append("static constexpr uint8_t FIELD_NONE = 255;")
+    lines.append("")
+    lines.append("enum FieldConv { " + ", ".join(
+        ["CONV_NONE=0"] + [f"{c}={i + 1}" for i, c in enumerate(FIELD_CONVERSIONS.values())]
+    ) + " };")
+    lines.append("")
+    # Pre-parsed text template: literal, then a field (FIELD_NONE = literal only)
+    lines.append(
+        (
+            "struct UiTextSeg { "
+            "const char* lit; uint8_t field; uint8_t conv; int8_t decimals; };"
+        )
+    )
+    lines.append("")
+    # Op header with its geometry resolved at generation time
+    lines.extend(
+        [
+            "// x, y, w, h are resolved from the rects, so drawing does no layout work:",
+            "//   line             x, y = top-left, w x h = 1 x len or len x 1",
+            "//   text, time       x, y = text cursor; ALIGN_RIGHT ends the text at x,",
+            "//   textCenteredIn   ALIGN_CENTER centers it across w from x (literal",
+            "//                    text is placed here, so it is ALIGN_LEFT)",
+            "//   tempGroupCentered  x, w = rect span, y = glyph top; p0 = text size,",
+            "//                    p1 = decimals (-1 = field default)",
+            "//   iconIn           x, y, w, h = rect",
+            "//   batteryGlyph     x, y, w, h = glyph outline",
+        ]
+    )
     lines.append(
         (
             "struct UiOpHeader { "
             "uint8_t kind; uint8_t rect; uint8_t font; uint8_t align; "
+            "int16_t x; int16_t y; int16_t w; int16_t h; "
             "int16_t p0; int16_t p1; int16_t p2; int16_t p3; "
-            "const char* s0; const char* s1; };"
+            "const char* s0; const char* s1; "
+            "uint8_t field; uint8_t seg_count; const UiTextSeg* segs; };"
         )
     )
     lines.append("")
+    lines.append("// RectId -> {x, y, w, h}")
+    lines.append("extern const int kRectGeometry[RECT__COUNT][4];")
+    lines.append("")
     # Variant names
     lines.append("static constexpr const char* kVariantNames[] = {")
     for name in order:
         lines.append(f'    "{name}",')
     lines.append("};")
+    lines.append(f"static constexpr uint8_t kVariantCount = {len(order)};")
     lines.append("")
     # Component name lists per variant (by string for now)
     for name in order:
@@ -451,6 +480,11 @@ def emit_fw_ops_header(spec: Dict[str, Any]) -> str:
     # Total counts
     total_ops = sum(len(v) for v in components.values())
     lines.append(f"static constexpr int kTotalOpCount = {total_ops};")
+    # Ops each variant actually draws: frame included, dead ops dropped
+    resolved = resolve_variants(spec)
+    for name in order:
+        drawn = sum(len(rows) for _, rows in resolved[name])
+        lines.append(f"static constexpr int kVariant_{name}_opcount = {drawn};")
     lines.append("")
     # ComponentOps mapping per variant
     lines.append("struct ComponentOps { const UiOpHeader* ops; int count; const char* name; };")
@@ -467,44 +501,263 @@ def _cxx_string_literal(s: str) -> str:
     return '"' + s.replace("\\", r"\\").replace('"', r"\"") + '"'
 
 
-def emit_fw_ops_cpp(spec: Dict[str, Any]) -> str:
-    variants = spec.get("variants", {})
-    components = spec.get("components", {})
-    rects = spec.get("rects", {})
-    fonts_tokens = (spec.get("fonts") or {}).get("tokens") or {}
+# Unit conversions allowed in a field reference ({wind_mps->mph})
+FIELD_CONVERSIONS = {"mph": "CONV_MPS_TO_MPH"}
+
+_FIELD_REF_RE = re.compile(r"^([a-z0-9_]+)(?:->([a-z0-9_]+))?(?::\.(\d+)f)?$")
+
+# Ops whose s0 names a single bound field rather than a text template
+_SOURCE_KEYS = {
+    "timeRight": "source",
+    "tempGroupCentered": "value",
+    "iconIn": "iconFromWeather",
+    "batteryGlyph": "percent",
+}
+
+
+def _parse_field_ref(ref: str) -> tuple[str, str, int]:
+    """Split "name->unit:.Nf" into (name, conversion enum, decimals or -1)."""
+    m = _FIELD_REF_RE.match(ref.strip())
+    if not m:
+        _fail(f"bad field reference: {{{ref}}}")
+    name, unit, dec = m.group(1), m.group(2), m.group(3)
+    conv = "CONV_NONE"
+    if unit:
+        if unit not in FIELD_CONVERSIONS:
+            _fail(f"unknown unit conversion in {{{ref}}}")
+        conv = FIELD_CONVERSIONS[unit]
+    return name, conv, int(dec) if dec is not None else -1
+
+
+def parse_text_template(text: str) -> list[tuple[str, tuple[str, str, int] | None]]:
+    """Split a template into (literal, field ref or None) segments.
+
+    "{battery_voltage:.2f}V ~{days}d" ->
+    [("", ("battery_voltage", "CONV_NONE", 2)), ("V ~", ("days", "CONV_NONE", -1)),
+     ("d", None)]
+    """
+    segs: list[tuple[str, tuple[str, str, int] | None]] = []
+    pos = 0
+    for m in re.finditer(r"\{([^{}]*)\}", text):
+        segs.append((text[pos : m.start()], _parse_field_ref(m.group(1))))
+        pos = m.end()
+    if pos < len(text) or not segs:
+        segs.append((text[pos:], None))
+    return segs
+
+
+def _op_template(op: Dict[str, Any]) -> str | None:
+    kind = str(op.get("op", "")).strip()
+    if kind in ("text", "textCenteredIn", "labelCentered"):
+        return str(op.get("text", ""))
+    return None
+
+
+def _op_source_field(op: Dict[str, Any]) -> str | None:
+    key = _SOURCE_KEYS.get(str(op.get("op", "")).strip())
+    if not key:
+        return None
+    src = str(op.get(key, "")).strip().strip("{}")
+    return _parse_field_ref(src)[0] if src else None
+
+
+def collect_fields(spec: Dict[str, Any]) -> list[str]:
+    """Every field name bound by any op, sorted (FieldId order)."""
+    names: set[str] = set()
+    for ops in (spec.get("components") or {}).values():
+        for op in ops:
+            templ = _op_template(op)
+            if templ is not None:
+                for _, ref in parse_text_template(templ):
+                    if ref:
+                        names.add(ref[0])
+            src = _op_source_field(op)
+            if src:
+                names.add(src)
+    return sorted(names)
 
-    # Rect ids map
-    rect_names = sorted(rects.keys())
-    rect_to_id = {name: idx for idx, name in enumerate(rect_names)}
-    # Font ids map
-    font_order: list[str] = []
-    for n in ["big", "label", "small", "time"]:
-        if n in fonts_tokens and n not in font_order:
-            font_order.append(n)
+
+# Built-in font metrics at text size 1 (glyph_cache.h); text ops draw at size 1
+GLYPH_ADVANCE = 6
+GLYPH_HEIGHT = 8
+
+_ALIGN = {"left": 0, "right": 1, "center": 2}
+ALIGN_LEFT, ALIGN_RIGHT, ALIGN_CENTER = 0, 1, 2
+
+
+def _cdiv(a: int, b: int) -> int:
+    """Integer division truncating toward zero, as C++ does."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b > 0) else -q
+
+
+def _font_order(spec: Dict[str, Any]) -> list[str]:
+    fonts_tokens = (spec.get("fonts") or {}).get("tokens") or {}
+    order = [n for n in ("big", "label", "small", "time") if n in fonts_tokens]
     for n in sorted(fonts_tokens.keys()):
-        if n not in font_order:
-            font_order.append(n)
-    font_to_id = {name: idx for idx, name in enumerate(font_order)}
-
-    def align_code(a: str | None) -> int:
-        if not a:
-            return 0
-        a2 = str(a).lower()
-        if a2 == "right":
-            return 1
-        if a2 == "center":
-            return 2
-        return 0
-
-    def rect_id(name: str | None) -> int:
-        if not name:
-            return 255
-        return int(rect_to_id.get(name, 255))
-
-    def font_id(name: str | None) -> int:
-        if not name:
-            return 0
-        return int(font_to_id.get(name, 0))
+        if n not in order:
+            order.append(n)
+    return order
+
+
+def _int(op: Dict[str, Any], key: str, default: int = 0) -> int:
+    try:
+        return int(op.get(key, default))
+    except Exception:
+        return default
+
+
+def resolve_op(spec: Dict[str, Any], op: Dict[str, Any]) -> Dict[str, Any] | None:
+    """One spec op as a UiOpHeader row with its geometry resolved.
+
+    Returns None for an op that can never draw anything (a rect op without a
+    rect, a diagonal line, empty literal text). Line coverage is left to
+    resolve_variants, since it depends on the rest of the variant.
+    """
+    rects = spec.get("rects", {})
+    rect_ids = {name: idx for idx, name in enumerate(sorted(rects.keys()))}
+    font_ids = {name: idx for idx, name in enumerate(_font_order(spec))}
+
+    kind = str(op.get("op", "")).strip()
+    rname = op.get("rect")
+    r = rects.get(rname) if isinstance(rname, str) else None
+    row: Dict[str, Any] = {
+        "kind": "OP_" + kind.upper(),
+        "rect": rect_ids.get(rname, 255) if isinstance(rname, str) else 255,
+        "font": font_ids.get(str(op.get("font")), 0),
+        "align": _ALIGN.get(str(op.get("align")).lower(), ALIGN_LEFT),
+        "x": 0, "y": 0, "w": 0, "h": 0,
+        "p": [0, 0, 0, 0],
+        "s0": None,
+        "field": _op_source_field(op),
+        "template": _op_template(op),
+    }
+
+    def place_text(x: int, y: int, w: int, align: int) -> None:
+        # Literal text has a known width, so its cursor is final
+        segs = parse_text_template(row["template"] or "")
+        literal = "".join(lit for lit, _ in segs) if all(ref is None for _, ref in segs) else None
+        if literal is not None and align != ALIGN_LEFT:
+            tw = GLYPH_ADVANCE * len(literal.encode("utf-8"))
+            x = x - tw if align == ALIGN_RIGHT else x + _cdiv(w - tw, 2)
+            align, w = ALIGN_LEFT, 0
+        row.update(x=x, y=y, w=w if align == ALIGN_CENTER else 0, align=align)
+
+    if kind == "line":
+        frm = op.get("from") or [0, 0]
+        to = op.get("to") or [0, 0]
+        x0, y0, x1, y1 = int(frm[0]), int(frm[1]), int(to[0]), int(to[1])
+        if x0 != x1 and y0 != y1:
+            return None
+        row["p"] = [x0, y0, x1, y1]
+        row.update(x=min(x0, x1), y=min(y0, y1), w=abs(x1 - x0) + 1, h=abs(y1 - y0) + 1)
+    elif kind == "text":
+        if row["template"] == "":
+            return None
+        row["s0"] = row["template"]
+        px, py = _int(op, "x"), _int(op, "y")
+        row["p"] = [px, py, 0, 0]
+        if r and px == 0:
+            if row["align"] == ALIGN_LEFT:
+                ax = r[0] + 1
+            elif row["align"] == ALIGN_RIGHT:
+                ax = r[0] + r[2] - 2
+            else:
+                ax = r[0]
+            place_text(ax, r[1] + (py if py != 0 else 1), r[2], row["align"])
+        else:
+            row.update(x=px, y=py, align=ALIGN_LEFT)
+    elif kind == "textCenteredIn":
+        if not r:
+            return None
+        y_off = _int(op, "yOffset")
+        row["s0"] = row["template"]
+        row["p"] = [y_off, 0, 0, 0]
+        place_text(r[0], r[1] + y_off, r[2], ALIGN_CENTER)
+    elif kind == "timeRight":
+        if not r:
+            return None
+        row["s0"] = str(op.get("source", "")).strip().strip("{}")
+        row.update(x=r[0] + r[2] - 2, y=r[1] + r[3] - 2, align=ALIGN_RIGHT)
+    elif kind == "tempGroupCentered":
+        if not r:
+            return None
+        val = str(op.get("value", "")).strip().strip("{}")
+        size = _int(op, "scale", 2)
+        row["s0"] = val
+        row["p"] = [size, _parse_field_ref(val)[2] if val else -1, 0, 0]
+        row.update(x=r[0], y=r[1] + _cdiv(r[3] - GLYPH_HEIGHT * size, 2), w=r[2],
+                   align=ALIGN_CENTER)
+    elif kind == "iconIn":
+        if not r:
+            return None
+        row["s0"] = str(op.get("iconFromWeather", "")).strip().strip("{}")
+        row.update(x=r[0], y=r[1], w=r[2], h=r[3])
+    elif kind == "batteryGlyph":
+        row["p"] = [_int(op, "x"), _int(op, "y"), _int(op, "w"), _int(op, "h")]
+        row["s0"] = str(op.get("percent", "")).strip().strip("{}")
+        row.update(x=row["p"][0], y=row["p"][1], w=row["p"][2], h=row["p"][3])
+    return row
+
+
+def _covers(a: Dict[str, Any], b: Dict[str, Any]) -> bool:
+    return (
+        a["x"] <= b["x"]
+        and a["y"] <= b["y"]
+        and b["x"] + b["w"] <= a["x"] + a["w"]
+        and b["y"] + b["h"] <= a["y"] + a["h"]
+    )
+
+
+def resolve_variants(spec: Dict[str, Any]) -> Dict[str, list[tuple[str, list[Dict[str, Any]]]]]:
+    """Per variant, the (component, rows) it draws, in draw order.
+
+    The frame comes first in every variant. Dead ops are dropped: those
+    resolve_op rejects, and lines another line of the same variant already
+    draws (same pixels or a longer run; all ops draw black only, so order
+    does not matter and the first of two equal lines stays). Components left
+    without ops are omitted.
+    """
+    components = spec.get("components", {})
+    variants = spec.get("variants", {})
+    out: Dict[str, list[tuple[str, list[Dict[str, Any]]]]] = {}
+    for vname in variant_order(spec):
+        comp_names = (["frame"] if spec.get("frame") else []) + list(variants.get(vname, []))
+        resolved: list[tuple[str, list[tuple[int, Dict[str, Any]]]]] = []
+        for cname in comp_names:
+            ops = spec["frame"] if cname == "frame" else components.get(cname, [])
+            rows = []
+            for idx, op in enumerate(ops):
+                row = resolve_op(spec, op)
+                if row is not None:
+                    row["component"], row["index"] = cname, idx
+                    rows.append((idx, row))
+            resolved.append((cname, rows))
+        lines = [row for _, rows in resolved for _, row in rows if row["kind"] == "OP_LINE"]
+        rank = {id(row): n for n, row in enumerate(lines)}
+
+        def dead(row: Dict[str, Any]) -> bool:
+            for other in lines:
+                if other is row or not _covers(other, row):
+                    continue
+                same = _covers(row, other)
+                if not same or rank[id(other)] < rank[id(row)]:
+                    return True
+            return False
+
+        kept = []
+        for cname, rows in resolved:
+            live = [row for _, row in rows if not (row["kind"] == "OP_LINE" and dead(row))]
+            if live:
+                kept.append((cname, live))
+        out[vname] = kept
+    return out
+
+
+def emit_fw_ops_cpp(spec: Dict[str, Any]) -> str:
+    rects = spec.get("rects", {})
+    order = variant_order(spec)
+    resolved = resolve_variants(spec)
 
     lines: list[str] = []
     lines.append("// AUTO-GENERATED by scripts/gen_ui.py — DO NOT EDIT")
@@ -514,91 +767,92 @@ def emit_fw_ops_cpp(spec: Dict[str, Any]) -> str:
     lines.append("")
     lines.append("namespace ui {")
     lines.append("")
-    # Emit ops per component
-    for cname, ops in components.items():
-        arr_name = f"kOps_{cname}"
-        lines.append(f"const UiOpHeader {arr_name}[] = {{")
-        for op in ops:
-            kind = str(op.get("op", "")).strip()
-            kind_enum = "OP_" + kind.upper()
-            rname = op.get("rect")
-            rid = rect_id(rname) if isinstance(rname, str) else 255
-            f = font_id(str(op.get("font")))
-            align = align_code(str(op.get("align")))
-            p0 = p1 = p2 = p3 = 0
-            s0 = s1 = "NULL"
-            if kind == "line":
-                frm = op.get("from") or [0, 0]
-                to = op.get("to") or [0, 0]
-                p0, p1 = int(frm[0]), int(frm[1])
-                p2, p3 = int(to[0]), int(to[1])
-            elif kind == "text":
-                # Pass template through; device interprets placeholders like {ip}, {fw_version}
-                txt = str(op.get("text", ""))
-                s0 = _cxx_string_literal(txt)
-                try:
-                    p0 = int(op.get("x", 0))
-                    p1 = int(op.get("y", 0))
-                except Exception:
-                    p0 = p1 = 0
-            elif kind == "timeRight":
-                src = str(op.get("source", "")).strip().strip("{}")
-                s0 = _cxx_string_literal(src)
-                align = 1
-            elif kind == "labelCentered":
-                # Use aboveRect as rect; stash y in p0 and text in s0
-                rid = rect_id(str(op.get("aboveRect")))
-                try:
-                    p0 = int(op.get("y", 0))
-                except Exception:
-                    p0 = 0
-                s0 = _cxx_string_literal(str(op.get("text", "")))
-                align = 2
-            elif kind == "tempGroupCentered":
-                val = str(op.get("value", "")).strip().strip("{}")
-                s0 = _cxx_string_literal(val)
-                align = 2
-            elif kind == "textCenteredIn":
-                try:
-                    p0 = int(op.get("yOffset", 0))
-                except Exception:
-                    p0 = 0
-                s0 = _cxx_string_literal(str(op.get("text", "")))
-                align = 2
-            elif kind == "iconIn":
-                src = str(op.get("iconFromWeather", "")).strip().strip("{}")
-                s0 = _cxx_string_literal(src)
-            elif kind == "shortCondition":
-                try:
-                    p0 = int(op.get("xOffset", 0))
-                except Exception:
-                    p0 = 0
-            elif kind == "batteryGlyph":
-                try:
-                    p0 = int(op.get("x", 0))
-                    p1 = int(op.get("y", 0))
-                    p2 = int(op.get("w", 0))
-                    p3 = int(op.get("h", 0))
-                except Exception:
-                    p0 = p1 = p2 = p3 = 0
-                src = str(op.get("percent", "")).strip().strip("{}")
-                s0 = _cxx_string_literal(src)
-            # Emit row
-            lines.append(
-                f"    {{ {kind_enum}, {rid}, {f}, {align}, {p0}, {p1}, {p2}, {p3}, {s0}, {s1} }},"
-            )
-        lines.append("};")
-        lines.append(f"const int kOps_{cname}_count = sizeof({arr_name})/sizeof({arr_name}[0]);")
+    def field_enum(name: str | None) -> str:
+        return f"FIELD_{name.upper()}" if name else "FIELD_NONE"
+
+    # RectId order is the sorted rect names
+    lines.append("const int kRectGeometry[RECT__COUNT][4] = {")
+    for name in sorted(rects.keys()):
+        x, y, rw, rh = [int(v) for v in rects[name]]
+        lines.append(f"    {{ {x:3d}, {y:3d}, {rw:3d}, {rh:2d} }},  // {name}")
+    lines.append("};")
+    lines.append("")
+
+    # Pre-parsed text templates for the templated ops some variant draws;
+    # literal text needs none (s0 is printed as is), equal templates share one
+    seg_arrays: dict[tuple[str, int], tuple[str, int]] = {}
+    by_template: dict[str, tuple[str, int]] = {}
+    for vname in order:
+        for cname, rows in resolved[vname]:
+            for row in rows:
+                templ = row["template"]
+                key = (cname, row["index"])
+                if templ is None or key in seg_arrays:
+                    continue
+                segs = parse_text_template(templ)
+                if all(ref is None for _, ref in segs):
+                    continue
+                if templ not in by_template:
+                    arr = f"kSegs_{cname}_{row['index']}"
+                    by_template[templ] = (arr, len(segs))
+                    lines.append(f"static const UiTextSeg {arr}[] = {{")
+                    for lit, ref in segs:
+                        if ref:
+                            name, conv, dec = ref
+                            lines.append(
+                                f"    {{ {_cxx_string_literal(lit)}, {field_enum(name)}, "
+                                f"{conv}, {dec} }},"
+                            )
+                        else:
+                            lines.append(
+                                f"    {{ {_cxx_string_literal(lit)}, FIELD_NONE, CONV_NONE, -1 }},"
+                            )
+                    lines.append("};")
+                seg_arrays[key] = by_template[templ]
+    if seg_arrays:
         lines.append("")
 
-    # Emit variant to component mapping arrays
-    def ops_arr_name(cn: str) -> str:
-        return f"kOps_{cn}"
+    def row_text(row: Dict[str, Any]) -> str:
+        p0, p1, p2, p3 = row["p"]
+        s0 = _cxx_string_literal(row["s0"]) if row["s0"] is not None else "NULL"
+        segs_name, seg_count = seg_arrays.get((row["component"], row["index"]), ("NULL", 0))
+        return (
+            f"    {{ {row['kind']}, {row['rect']}, {row['font']}, {row['align']}, "
+            f"{row['x']}, {row['y']}, {row['w']}, {row['h']}, "
+            f"{p0}, {p1}, {p2}, {p3}, {s0}, NULL, "
+            f"{field_enum(row['field'])}, {seg_count}, {segs_name} }},"
+        )
+
+    # One op array per distinct resolved component; variants that resolve a
+    # component the same way share it
+    arrays: dict[tuple[str, tuple[str, ...]], str] = {}
+    variant_arrays: dict[str, list[tuple[str, str]]] = {}
+    for vname in order:
+        for cname, rows in resolved[vname]:
+            body = tuple(row_text(row) for row in rows)
+            if (cname, body) not in arrays:
+                shapes = {
+                    tuple(row_text(r) for r in rs)
+                    for vn in order
+                    for cn, rs in resolved[vn]
+                    if cn == cname
+                }
+                arr_name = f"kOps_{cname}" if len(shapes) == 1 else f"kOps_{cname}_{vname}"
+                arrays[(cname, body)] = arr_name
+                lines.append(f"const UiOpHeader {arr_name}[] = {{")
+                lines.extend(body)
+                lines.append("};")
+                lines.append(
+                    f"const int {arr_name}_count = sizeof({arr_name})/sizeof({arr_name}[0]);"
+                )
+                lines.append("")
+            variant_arrays.setdefault(vname, []).append((cname, arrays[(cname, body)]))
 
-    for vname, comp_list in variants.items():
+    # Emit variant to component mapping arrays
+    for vname in order:
         lines.append(f"const ComponentOps kVariant_{vname}_ops[] = {{")
-        for cn in comp_list:
-            lines.append(f'    {{ {ops_arr_name(cn)}, kOps_{cn}_count, "{cn}" }},')
+        for cn, arr_name in variant_arrays.get(vname, []):
+            lines.append(f'    {{ {arr_name}, {arr_name}_count, "{cn}" }},')
         lines.append("};")
         lines.append(
             (
@@ -607,28 +861,20 @@ def emit_fw_ops_cpp(spec: Dict[str, Any]) -> str:
             )
         )
         lines.append("")
-    # Provide a simple id->array lookup using the same id order as header
-    # (minimal, v1, v2, then others)
-    # Build the same order
-    order: list[str] = []
-    if "minimal" in variants:
-        order.append("minimal")
-    for n in ["v1", "v2"]:
-        if n in variants and n not in order:
-            order.append(n)
-    for n in sorted(variants.keys()):
-        if n not in order:
-            order.append(n)
+    # VariantId indexes straight into the tables (same order as the header)
+    lines.append("static const ComponentOps* const kVariantOps[kVariantCount] = {")
+    for vn in order:
+        lines.append(f"    kVariant_{vn}_ops,")
+    lines.append("};")
+    lines.append("static const int kVariantOpsCount[kVariantCount] = {")
+    for vn in order:
+        lines.append(f"    kVariant_{vn}_ops_count,")
+    lines.append("};")
+    lines.append("")
     lines.append("const ComponentOps* get_variant_ops(uint8_t variantId, int* outCount){")
-    for idx, vn in enumerate(order):
-        prefix = "  if" if idx == 0 else "  else if"
-        lines.append(
-            (
-                f"{prefix} (variantId == {idx}) {{ if(outCount) *outCount = "
-                f"kVariant_{vn}_ops_count; return kVariant_{vn}_ops; }}"
-            )
-        )
-    lines.append("  if(outCount) *outCount = 0; return nullptr;")
+    lines.append("  if (variantId >= kVariantCount) { if(outCount) *outCount = 0; return nullptr; }")
+    lines.append("  if(outCount) *outCount = kVariantOpsCount[variantId];")
+    lines.append("  return kVariantOps[variantId];")
     lines.append("}")
     lines.append("")
     lines.append("} // namespace ui")
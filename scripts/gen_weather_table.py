@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Generate the weather-condition perfect-hash table for the firmware.
+
+Every exact condition value the device understands (Home Assistant states,
+MDI icon names and OpenWeather icon codes) is classified into a compact
+WeatherKind. The emitted header holds a seed and a slot table such that the
+top bits of FNV-1a(seed, key) are distinct for every key, so a lookup is one
+hash, one slot read and one strcmp. (The low bits of FNV-1a depend only on
+the low bits of the seed, so they cannot be searched over.)
+
+Usage:
+  python3 scripts/gen_weather_table.py
+"""
+import pathlib
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+OUT_H = ROOT / "firmware" / "arduino" / "src" / "weather_table_generated.h"
+
+# Order defines the enum values; UNKNOWN (no condition) must stay first
+KINDS: list[str] = [
+    "UNKNOWN",
+    "SUNNY",
+    "PARTLY_CLOUDY",
+    "CLOUDY",
+    "FOG",
+    "POURING",
+    "DRIZZLE",
+    "SNOWY",
+    "LIGHTNING",
+    "HURRICANE",
+    "TORNADO",
+    "NIGHT",
+    "NIGHT_PARTLY_CLOUDY",
+]
+
+# Lower-case key -> kind
+KEYS: dict[str, str] = {
+    # Home Assistant recommended values
+    # https://developers.home-assistant.io/docs/core/entity/weather/#recommended-values-for-state-and-condition
+    "clear-night": "NIGHT",
+    "cloudy": "CLOUDY",
+    "exceptional": "CLOUDY",  # generic fallback
+    "fog": "FOG",
+    "hail": "SNOWY",  # approximate
+    "lightning": "LIGHTNING",
+    "lightning-rainy": "LIGHTNING",  # prefer lightning cue
+    "partlycloudy": "PARTLY_CLOUDY",
+    "pouring": "POURING",
+    "rainy": "POURING",
+    "snowy": "SNOWY",
+    "snowy-rainy": "SNOWY",  # approximate
+    "sunny": "SUNNY",
+    "windy": "CLOUDY",  # approximate
+    "windy-variant": "CLOUDY",
+    # MDI icon names passed through
+    "weather-sunny": "SUNNY",
+    "weather-partly-cloudy": "PARTLY_CLOUDY",
+    "weather-cloudy": "CLOUDY",
+    "weather-fog": "FOG",
+    "weather-pouring": "POURING",
+    "weather-rainy": "POURING",
+    "weather-snowy": "SNOWY",
+    "weather-lightning": "LIGHTNING",
+    "weather-night": "NIGHT",
+    "weather-night-partly-cloudy": "NIGHT_PARTLY_CLOUDY",
+    # OpenWeather icon codes (d = day, n = night)
+    "01d": "SUNNY",
+    "01n": "NIGHT",
+    "02d": "PARTLY_CLOUDY",
+    "02n": "NIGHT_PARTLY_CLOUDY",
+    "03d": "CLOUDY",
+    "03n": "CLOUDY",
+    "04d": "CLOUDY",
+    "04n": "CLOUDY",
+    "09d": "DRIZZLE",  # showers/drizzle
+    "09n": "DRIZZLE",
+    "10d": "POURING",  # rain
+    "10n": "POURING",
+    "11d": "LIGHTNING",
+    "11n": "LIGHTNING",
+    "13d": "SNOWY",
+    "13n": "SNOWY",
+    "50d": "FOG",  # atmosphere group
+    "50n": "FOG",
+}
+
+SLOTS = 128  # Power of two; roomy enough that a perfect seed is found quickly
+SLOT_SHIFT = 32 - (SLOTS.bit_length() - 1)
+EMPTY = 0xFF
+
+
+def fnv1a(key: str, seed: int) -> int:
+    h = seed
+    for b in key.encode("ascii"):
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def find_seed(keys: list[str]) -> tuple[int, list[int]]:
+    seed = 2166136261  # FNV offset basis, then walk upward
+    while True:
+        slots = [EMPTY] * SLOTS
+        for i, key in enumerate(keys):
+            s = fnv1a(key, seed) >> SLOT_SHIFT
+            if slots[s] != EMPTY:
+                break
+            slots[s] = i
+        else:
+            return seed, slots
+        seed = (seed + 1) & 0xFFFFFFFF
+
+
+def render(seed: int, slots: list[int], keys: list[str]) -> str:
+    lines: list[str] = []
+    lines.append("// AUTO-GENERATED by scripts/gen_weather_table.py — DO NOT EDIT")
+    lines.append("#pragma once")
+    lines.append("")
+    lines.append("#include <stdint.h>")
+    lines.append("")
+    lines.append("enum WeatherKind : uint8_t {")
+    for k in KINDS:
+        lines.append(f"    WEATHER_KIND_{k},")
+    lines.append("    WEATHER_KIND__COUNT,")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static constexpr uint32_t WEATHER_TABLE_SEED = 0x{seed:08X}u;")
+    lines.append(f"static constexpr uint8_t WEATHER_TABLE_SLOTS = {SLOTS};")
+    lines.append(f"static constexpr uint8_t WEATHER_TABLE_SHIFT = {SLOT_SHIFT};  // slot = hash >> shift")
+    lines.append(f"static constexpr uint8_t WEATHER_TABLE_EMPTY = 0x{EMPTY:02X};")
+    lines.append("")
+    lines.append("struct WeatherTableKey {")
+    lines.append("    const char* key;")
+    lines.append("    WeatherKind kind;")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static const WeatherTableKey kWeatherTableKeys[{len(keys)}] = {{")
+    for key in keys:
+        lines.append(f'    {{"{key}", WEATHER_KIND_{KEYS[key]}}},')
+    lines.append("};")
+    lines.append("")
+    lines.append("// Slot -> index into kWeatherTableKeys (WEATHER_TABLE_EMPTY = no key)")
+    lines.append("static const uint8_t kWeatherTableSlots[WEATHER_TABLE_SLOTS] = {")
+    for row in range(0, SLOTS, 16):
+        cells = ", ".join(f"{v:3d}" for v in slots[row:row + 16])
+        lines.append(f"    {cells},")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main() -> None:
+    keys = list(KEYS.keys())
+    assert len(keys) < EMPTY, "Key index must fit below the empty marker"
+    for k in keys:
+        assert k == k.lower(), f"Keys are matched lower-case: {k}"
+    seed, slots = find_seed(keys)
+    OUT_H.write_text(render(seed, slots, keys))
+    print(f"wrote {OUT_H} ({len(keys)} keys, seed 0x{seed:08X})")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Memory footprint of a firmware build from its GNU ld map file.
+
+PlatformIO's Arduino builder links with -Wl,-Map, leaving
+.pio/build/<env>/firmware.map next to firmware.elf. Every input section in
+the "Linker script and memory map" part of the file is attributed to the
+module it came from and to one of four regions:
+
+  flash  bytes in the app image: code and rodata run from flash, plus the
+         initial contents of IRAM, DRAM .data and RTC sections, which the
+         bootloader copies out of the image on every boot
+  dram   static data (.dram0.data, .dram0.bss, .noinit); the heap is the rest
+  iram   code in internal RAM (.iram0.*)
+  rtc    RTC fast and slow memory (RTC_DATA_ATTR / RTC_NOINIT_ATTR, rtc code)
+
+A module is a source file of the project (src/main.cpp), or a library or
+framework archive (Adafruit GFX Library, FrameworkArduino, esp_wifi).
+
+  python3 scripts/map_footprint.py firmware/arduino/.pio/build/feather_esp32s2_headless/firmware.map
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import re
+import sys
+from dataclasses import dataclass, field
+from typing import Dict, Iterable, List, Optional, Tuple
+
+REGIONS = ("flash", "dram", "iram", "rtc")
+
+_OUT_SECTION_RE = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?\s*$")
+_IN_SECTION_RE = re.compile(r"^ (\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+))?\s*$")
+_CONT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+?)\s*$")
+_ARCHIVE_RE = re.compile(r"^(.*?)([^/]+)\.a\(([^)]+)\)$")
+
+
+def section_regions(name: str) -> Tuple[Optional[str], bool]:
+    """(runtime region, also stored in the flash image) of an output section.
+
+    Dummy sections (the linker's placeholders for address ranges another
+    section occupies), external RAM and debug info count towards nothing.
+    """
+    if "dummy" in name or name.startswith(".ext_ram"):
+        return None, False
+    no_load = "bss" in name or "noinit" in name or "noload" in name
+    if name.startswith(".rtc"):
+        return "rtc", not no_load
+    if name.startswith(".iram0"):
+        return "iram", not no_load
+    if name.startswith(".dram0") or name.startswith(".noinit"):
+        return "dram", not no_load
+    if name.startswith(".flash"):
+        return (None, False) if no_load else ("flash", False)
+    return None, False
+
+
+def module_name(obj: str) -> str:
+    """Module an object file belongs to: src/<file> or the archive's name."""
+    path = obj.replace("\\", "/").strip()
+    m = _ARCHIVE_RE.match(path)
+    if m:
+        lib = m.group(2)
+        return lib[3:] if lib.startswith("lib") and len(lib) > 3 else lib
+    if "/src/" in path:
+        rel = path.rsplit("/src/", 1)[1]
+        for suffix in (".obj", ".o"):
+            if rel.endswith(suffix):
+                rel = rel[: -len(suffix)]
+                break
+        return "src/" + rel
+    return os.path.basename(path)
+
+
+@dataclass
+class Footprint:
+    """Bytes per region, in total and per module."""
+
+    totals: Dict[str, int] = field(default_factory=lambda: {r: 0 for r in REGIONS})
+    modules: Dict[str, Dict[str, int]] = field(default_factory=dict)
+
+    def add(self, module: str, region: str, size: int):
+        self.totals[region] += size
+        per = self.modules.setdefault(module, {r: 0 for r in REGIONS})
+        per[region] += size
+
+    def to_dict(self) -> dict:
+        return {"totals": dict(self.totals), "modules": {k: dict(v) for k, v in self.modules.items()}}
+
+    @classmethod
+    def from_dict(cls, doc: dict) -> "Footprint":
+        fp = cls()
+        fp.totals.update(doc.get("totals", {}))
+        fp.modules = {k: {r: int(v.get(r, 0)) for r in REGIONS} for k, v in doc.get("modules", {}).items()}
+        return fp
+
+
+def parse_map(lines: Iterable[str]) -> Footprint:
+    """Attribute every input section of a GNU ld map to a module and region."""
+    fp = Footprint()
+    in_map = False
+    region: Optional[str] = None
+    loaded = False
+    pending_out: Optional[str] = None   # Output section name wrapped onto its own line
+    pending_in = False                  # Input section name wrapped onto its own line
+
+    def account(obj: str, size: int):
+        if size == 0 or region is None:
+            return
+        mod = module_name(obj)
+        fp.add(mod, region, size)
+        if loaded:
+            fp.add(mod, "flash", size)
+
+    for raw in lines:
+        line = raw.rstrip("\n")
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+        if line.startswith("OUTPUT(") or line.startswith("/DISCARD/"):
+            region, loaded = None, False
+            continue
+
+        if pending_out is not None:
+            m = _CONT_RE.match(line)
+            region, loaded = section_regions(pending_out)
+            pending_out = None
+            if m or not line.strip():
+                continue
+        if pending_in:
+            pending_in = False
+            m = _CONT_RE.match(line)
+            if m:
+                account(m.group(3), int(m.group(2), 16))
+                continue
+
+        if line.startswith("."):
+            m = _OUT_SECTION_RE.match(line)
+            if m:
+                if m.group(2) is None:
+                    pending_out = m.group(1)
+                else:
+                    region, loaded = section_regions(m.group(1))
+            continue
+        if line.startswith(" *fill*"):
+            parts = line.split()
+            if len(parts) >= 3:
+                account("(fill)", int(parts[2], 16))
+            continue
+        if line.startswith(" *") or not line.startswith(" ") or line.startswith("  "):
+            continue   # Input patterns, symbols, assignments
+        m = _IN_SECTION_RE.match(line)
+        if not m:
+            continue
+        if m.group(2) is None:
+            pending_in = True
+        else:
+            account(m.group(4), int(m.group(3), 16))
+    return fp
+
+
+def load_map(path: str) -> Footprint:
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        return parse_map(f)
+
+
+def diff(base: Footprint, new: Footprint) -> Footprint:
+    """new - base, per region and module (modules only in one side included)."""
+    out = Footprint()
+    for r in REGIONS:
+        out.totals[r] = new.totals.get(r, 0) - base.totals.get(r, 0)
+    for mod in set(base.modules) | set(new.modules):
+        a = base.modules.get(mod, {})
+        b = new.modules.get(mod, {})
+        d = {r: b.get(r, 0) - a.get(r, 0) for r in REGIONS}
+        if any(d.values()):
+            out.modules[mod] = d
+    return out
+
+
+def top_modules(fp: Footprint, region: str = "flash", n: int = 10) -> List[Tuple[str, Dict[str, int]]]:
+    """Largest modules by |bytes| in region."""
+    rows = sorted(fp.modules.items(), key=lambda kv: abs(kv[1].get(region, 0)), reverse=True)
+    return [kv for kv in rows[:n] if kv[1].get(region, 0)]
+
+
+def check_budget(totals: Dict[str, int], limits: Dict[str, int], what: str) -> List[str]:
+    """One message per region over its limit."""
+    return [f"{what}: {r} {totals.get(r, 0)} B exceeds budget {int(limits[r])} B"
+            for r in REGIONS if r in limits and totals.get(r, 0) > int(limits[r])]
+
+
+def env_limits(budget: dict, env: str) -> Dict[str, int]:
+    """Region limits for env: the defaults overlaid with the env's own."""
+    limits = dict(budget.get("default", {}))
+    limits.update(budget.get("environments", {}).get(env, {}))
+    return {k: int(v) for k, v in limits.items() if k in REGIONS}
+
+
+def format_table(rows: List[Tuple[str, Dict[str, int]]], signed: bool = False) -> str:
+    fmt = "{:+d}" if signed else "{:d}"
+    width = max([len(name) for name, _ in rows] + [6])
+    out = [f"{'module':<{width}} " + " ".join(f"{r:>9}" for r in REGIONS)]
+    for name, sizes in rows:
+        out.append(f"{name:<{width}} " + " ".join(f"{fmt.format(sizes.get(r, 0)):>9}" for r in REGIONS))
+    return "\n".join(out)
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    ap = argparse.ArgumentParser(description="Report flash/DRAM/IRAM/RTC use from a linker map")
+    ap.add_argument("map", help="firmware.map from the build directory")
+    ap.add_argument("--base", help="Second map to compare against (prints new - base)")
+    ap.add_argument("--top", type=int, default=15, help="Modules to list")
+    ap.add_argument("--sort", choices=REGIONS, default="flash")
+    ap.add_argument("--json", action="store_true", help="Print the full footprint as JSON")
+    args = ap.parse_args(argv)
+
+    fp = load_map(args.map)
+    if args.base:
+        fp = diff(load_map(args.base), fp)
+    if args.json:
+        json.dump(fp.to_dict(), sys.stdout, indent=2, sort_keys=True)
+        print()
+        return 0
+    signed = bool(args.base)
+    print(format_table([("TOTAL", fp.totals)], signed))
+    print()
+    print(format_table(top_modules(fp, args.sort, args.top), signed))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -7,6 +7,7 @@ Single source of truth matching firmware implementation.
 import json
 import os
 import re
+import struct
 from math import isfinite
 
 
@@ -205,6 +206,45 @@ def format_sensor_value(value: float, sensor_type: str) -> str:
         return str(value)
 
 
+# Binary telemetry frame (firmware/arduino/src/telemetry_frame.h), published on
+# espsensor/<id>/telemetry when MQTT_COMPACT_TELEMETRY is enabled
+TELEMETRY_TOPIC_SUFFIX = "telemetry"
+_TELEMETRY_V1 = struct.Struct("<BhHHHBbIHHH")
+
+
+def decode_telemetry_frame(frame: bytes) -> dict:
+    """
+    Decode a compact telemetry frame into a dict of readings.
+
+    Missing values decode as None. Raises ValueError for an unknown version
+    or a frame of the wrong length.
+    """
+    if len(frame) < 1:
+        raise ValueError("empty telemetry frame")
+    if frame[0] != 1:
+        raise ValueError(f"unsupported telemetry frame version {frame[0]}")
+    if len(frame) != _TELEMETRY_V1.size:
+        raise ValueError(f"telemetry v1 frame must be {_TELEMETRY_V1.size} bytes, got {len(frame)}")
+
+    (version, temp_cc, rh_cpct, press_dhpa, batt_mv, batt_pct, rssi,
+     wake_count, sensor_ms, wifi_ms, mqtt_ms) = _TELEMETRY_V1.unpack(frame)
+    return {
+        "version": version,
+        "temp_c": None if temp_cc == -32768 else temp_cc / 100.0,
+        "rh_pct": None if rh_cpct == 0xFFFF else rh_cpct / 100.0,
+        "pressure_hpa": None if press_dhpa == 0xFFFF else press_dhpa / 10.0,
+        "battery_v": None if batt_mv == 0xFFFF else batt_mv / 1000.0,
+        "battery_pct": None if batt_pct == 0xFF else batt_pct,
+        "rssi_dbm": None if rssi == 0 else rssi,
+        "wake_count": wake_count,
+        "timeline_ms": {
+            "sensor": sensor_ms or None,
+            "wifi": wifi_ms or None,
+            "mqtt": mqtt_ms or None,
+        },
+    }
+
+
 # Retention rules matching firmware
 RETAINED_TOPICS = {
     "discovery": True,    # HA discovery configs
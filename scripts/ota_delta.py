@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+"""Build and serve delta OTA patches for firmware/arduino (ota_update.cpp).
+
+A patch turns the image a device is running into a new one with COPY, DATA
+and ADD ops (format in firmware/arduino/src/ota_delta.h). ADD carries the
+bytewise difference against a source region, which stays mostly zero when
+code only moved, so a rebuild with a small change is a few tens of KB.
+
+  ota_delta.py make old.bin new.bin -o update.patch   # Also writes update.patch.json
+  ota_delta.py apply old.bin update.patch -o check.bin
+  ota_delta.py serve --host broker --device <id> update.patch
+
+The source must be byte-identical to the device's running partition (the
+manifest carries its SHA-256 and the device refuses a mismatch). esptool may
+rewrite the header of a USB-flashed image, so read that one back first:
+  esptool.py read_flash 0x10000 <size of firmware.bin> old.bin
+
+serve publishes the retained manifest on espsensor/<id>/ota and answers the
+device's espsensor/<id>/ota/req requests with binary chunks on
+espsensor/<id>/ota/data (8-byte little-endian id, offset header).
+"""
+from __future__ import annotations
+
+import argparse
+import hashlib
+import json
+import struct
+import sys
+import zlib
+from typing import Dict, List, Optional
+
+OP_END = 0x00
+OP_COPY = 0x01
+OP_DATA = 0x02
+OP_ADD = 0x03
+
+KEY_LEN = 16          # Exact bytes needed to start a match
+WINDOW = 32           # Approximate match: sliding window ...
+WINDOW_MIN_SAME = 12  # ... must keep at least this many equal bytes
+MAX_ZERO_GAP = 2      # Zero deltas folded into an ADD literal run
+CHUNK_HEADER = struct.Struct("<II")
+
+
+def varint(v: int) -> bytes:
+    out = bytearray()
+    while True:
+        b = v & 0x7F
+        v >>= 7
+        if v:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def _read_varint(p: bytes, i: int):
+    v = 0
+    shift = 0
+    while True:
+        b = p[i]
+        i += 1
+        v |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return v, i
+
+
+def _encode_add(src_off: int, delta: bytes) -> bytes:
+    out = bytearray([OP_ADD])
+    out += varint(src_off) + varint(len(delta))
+    i = 0
+    n = len(delta)
+    while i < n:
+        skip = 0
+        while i + skip < n and delta[i + skip] == 0:
+            skip += 1
+        out += varint(skip)
+        i += skip
+        if i >= n:
+            break
+        # Literal run; short zero gaps are cheaper inside it than as segments
+        j = i
+        while j < n:
+            if delta[j] != 0:
+                j += 1
+                continue
+            gap = 0
+            while j + gap < n and delta[j + gap] == 0:
+                gap += 1
+            if gap > MAX_ZERO_GAP or j + gap >= n:
+                break
+            j += gap
+        out += varint(j - i) + delta[i:j]
+        i = j
+    return bytes(out)
+
+
+def _index(src: bytes) -> Dict[bytes, int]:
+    idx: Dict[bytes, int] = {}
+    for i in range(0, len(src) - KEY_LEN + 1):
+        idx.setdefault(src[i:i + KEY_LEN], i)
+    return idx
+
+
+def _extend(src: bytes, dst: bytes, s: int, t: int) -> int:
+    """Length of the approximate match of dst[t:] against src[s:]."""
+    n = min(len(src) - s, len(dst) - t)
+    same = 0
+    last_equal = 0
+    hist = bytearray(n)
+    k = 0
+    while k < n:
+        eq = src[s + k] == dst[t + k]
+        hist[k] = eq
+        same += eq
+        if k >= WINDOW:
+            same -= hist[k - WINDOW]
+            if same < WINDOW_MIN_SAME:
+                break
+        if eq:
+            last_equal = k + 1
+        k += 1
+    return last_equal
+
+
+def make_patch(src: bytes, dst: bytes) -> bytes:
+    idx = _index(src)
+    out = bytearray()
+    lit = bytearray()
+    t = 0
+    align = 0           # src - dst offset of the last match
+    n = len(dst)
+
+    def flush_lit():
+        if lit:
+            out.extend(bytes([OP_DATA]) + varint(len(lit)) + bytes(lit))
+            lit.clear()
+
+    while t < n:
+        key = dst[t:t + KEY_LEN]
+        s: Optional[int] = None
+        # Same alignment as the last match first: shifted code keeps it
+        p = t + align
+        if len(key) == KEY_LEN and 0 <= p <= len(src) - KEY_LEN and src[p:p + KEY_LEN] == key:
+            s = p
+        elif len(key) == KEY_LEN:
+            s = idx.get(key)
+        if s is None:
+            lit.append(dst[t])
+            t += 1
+            continue
+        m = _extend(src, dst, s, t)
+        flush_lit()
+        delta = bytes((dst[t + k] - src[s + k]) & 0xFF for k in range(m))
+        if delta.count(0) == m:
+            out.extend(bytes([OP_COPY]) + varint(s) + varint(m))
+        else:
+            out.extend(_encode_add(s, delta))
+        align = s - t
+        t += m
+    flush_lit()
+    out.append(OP_END)
+    return bytes(out)
+
+
+def apply_patch(src: bytes, patch: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+    while True:
+        op = patch[i]
+        i += 1
+        if op == OP_END:
+            if i != len(patch):
+                raise ValueError("bytes after END")
+            return bytes(out)
+        if op == OP_DATA:
+            ln, i = _read_varint(patch, i)
+            out += patch[i:i + ln]
+            i += ln
+        elif op == OP_COPY:
+            s, i = _read_varint(patch, i)
+            ln, i = _read_varint(patch, i)
+            out += src[s:s + ln]
+        elif op == OP_ADD:
+            s, i = _read_varint(patch, i)
+            ln, i = _read_varint(patch, i)
+            done = 0
+            while done < ln:
+                skip, i = _read_varint(patch, i)
+                out += src[s + done:s + done + skip]
+                done += skip
+                if done >= ln:
+                    break
+                cnt, i = _read_varint(patch, i)
+                for k in range(cnt):
+                    out.append((src[s + done + k] + patch[i + k]) & 0xFF)
+                i += cnt
+                done += cnt
+        else:
+            raise ValueError("bad op 0x%02x at %d" % (op, i - 1))
+
+
+def manifest(src: bytes, dst: bytes, patch: bytes) -> dict:
+    """Retained ota document; id changes whenever the patch does."""
+    return {
+        "id": zlib.crc32(patch) or 1,
+        "size": len(patch),
+        "src_size": len(src),
+        "src": hashlib.sha256(src).hexdigest(),
+        "dst_size": len(dst),
+        "dst": hashlib.sha256(dst).hexdigest(),
+    }
+
+
+def chunks(patch: bytes, job_id: int, off: int, length: int, chunk: int) -> List[bytes]:
+    """Data messages answering one request."""
+    out = []
+    end = min(len(patch), off + length)
+    while off < end:
+        piece = patch[off:min(end, off + chunk)]
+        out.append(CHUNK_HEADER.pack(job_id, off) + piece)
+        off += len(piece)
+    return out
+
+
+def _read(path: str) -> bytes:
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def cmd_make(args) -> int:
+    src = _read(args.source)
+    dst = _read(args.target)
+    patch = make_patch(src, dst)
+    if apply_patch(src, patch) != dst:
+        print("ERR: patch does not rebuild the target", file=sys.stderr)
+        return 1
+    with open(args.output, "wb") as f:
+        f.write(patch)
+    with open(args.output + ".json", "w") as f:
+        json.dump(manifest(src, dst, patch), f)
+    print("%s: %d bytes (%.1f%% of %d)" % (args.output, len(patch),
+                                           100.0 * len(patch) / max(1, len(dst)), len(dst)))
+    return 0
+
+
+def cmd_apply(args) -> int:
+    out = apply_patch(_read(args.source), _read(args.patch))
+    with open(args.output, "wb") as f:
+        f.write(out)
+    print("%s: %d bytes sha256 %s" % (args.output, len(out), hashlib.sha256(out).hexdigest()))
+    return 0
+
+
+def cmd_serve(args) -> int:
+    try:
+        import paho.mqtt.client as mqtt
+    except Exception as e:  # pragma: no cover - dependency not installed
+        print(f"paho-mqtt missing: {e}")
+        return 2
+
+    patch = _read(args.patch)
+    with open(args.patch + ".json") as f:
+        doc = json.load(f)
+    base = "espsensor/%s/ota" % args.device
+
+    if hasattr(mqtt, "CallbackAPIVersion"):
+        try:
+            client = mqtt.Client(
+                callback_api_version=mqtt.CallbackAPIVersion.VERSION1,
+                protocol=mqtt.MQTTv311,
+            )
+        except TypeError:
+            client = mqtt.Client(protocol=mqtt.MQTTv311)
+    else:
+        client = mqtt.Client(protocol=mqtt.MQTTv311)
+    if args.user:
+        client.username_pw_set(args.user, args.password or None)
+
+    def on_connect(c, _u, _f, rc):
+        print(f"connected rc={rc}; offering id {doc['id']} ({len(patch)} bytes)", flush=True)
+        c.publish(base, json.dumps(doc), retain=True)
+        c.subscribe(base + "/req")
+        c.subscribe(base + "/status")
+
+    def on_message(c, _u, msg):
+        if msg.topic.endswith("/status"):
+            print("status: %s" % msg.payload.decode("utf-8", "ignore"), flush=True)
+            return
+        try:
+            req = json.loads(msg.payload)
+        except ValueError:
+            return
+        if req.get("id") != doc["id"]:
+            return
+        for m in chunks(patch, doc["id"], int(req.get("off", 0)), int(req.get("len", 4096)),
+                        int(req.get("chunk", 768))):
+            c.publish(base + "/data", m)
+
+    client.on_connect = on_connect
+    client.on_message = on_message
+    client.connect(args.host, args.port, keepalive=30)
+    try:
+        client.loop_forever()
+    except KeyboardInterrupt:
+        if args.clear:
+            client.publish(base, b"", retain=True)
+    return 0
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description="Delta OTA patches over MQTT")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    m = sub.add_parser("make", help="Build a patch and its manifest")
+    m.add_argument("source", help="Image the device runs (firmware.bin)")
+    m.add_argument("target", help="New image")
+    m.add_argument("-o", "--output", required=True)
+    m.set_defaults(func=cmd_make)
+
+    a = sub.add_parser("apply", help="Rebuild the target from a patch (check)")
+    a.add_argument("source")
+    a.add_argument("patch")
+    a.add_argument("-o", "--output", required=True)
+    a.set_defaults(func=cmd_apply)
+
+    s = sub.add_parser("serve", help="Offer a patch to one device")
+    s.add_argument("patch", help="Patch from make (its .json manifest alongside)")
+    s.add_argument("--device", required=True, help="Device id (espsensor/<id>/...)")
+    s.add_argument("--host", required=True)
+    s.add_argument("--port", type=int, default=1883)
+    s.add_argument("--user", default="")
+    s.add_argument("--password", default="")
+    s.add_argument("--clear", action="store_true", help="Remove the manifest on exit")
+    s.set_defaults(func=cmd_serve)
+
+    args = ap.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
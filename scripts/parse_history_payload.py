@@ -3,7 +3,7 @@ from __future__ import annotations
 
 from dataclasses import dataclass
 import json
-from typing import Optional
+from typing import List, Optional
 
 
 @dataclass
@@ -24,6 +24,50 @@ def parse_history_payload(s: str) -> Optional[HistoryRecord]:
         return None
 
 
+@dataclass
+class BatchSample:
+    ts: int
+    tempC: Optional[float]
+    rh: Optional[float]
+    pressureHPa: Optional[float]
+
+
+def _scaled(value, scale: float) -> Optional[float]:
+    return None if value is None else float(value) / scale
+
+
+def parse_history_batch(s: str) -> Optional[List[BatchSample]]:
+    """Decode an espsensor/<id>/history batch (offline queue/store-and-forward).
+
+    Format v1: {"v":1,"t0":<epoch>,"s":[[dt,t_cC,rh_cPct,p_dHPa],...]}
+    where dt is seconds since the previous row (0 for the first) and null
+    marks a metric that was not measured.
+    """
+    try:
+        obj = json.loads(s)
+        if int(obj["v"]) != 1:
+            return None
+        ts = int(obj["t0"])
+        out: List[BatchSample] = []
+        for i, row in enumerate(obj["s"]):
+            dt, t, rh, p = row
+            if i > 0:
+                ts += int(dt)
+            out.append(
+                BatchSample(
+                    ts=ts,
+                    tempC=_scaled(t, 100.0),
+                    rh=_scaled(rh, 100.0),
+                    pressureHPa=_scaled(p, 10.0),
+                )
+            )
+        return out
+    except Exception:
+        return None
+
+
 if __name__ == "__main__":
     sample = '{"ts":1710000000,"tempF":72.5,"rh":47}'
     print(parse_history_payload(sample))
+    batch = '{"v":1,"t0":1710000000,"s":[[0,2150,4512,10132],[300,2148,null,10131]]}'
+    print(parse_history_batch(batch))
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Group cold code at the start of .flash.text (PlatformIO post: script).
+
+COLD_PATH (firmware/arduino/src/code_placement.h) marks rarely run code
+__attribute__((cold)), which GCC emits as .text.unlikely.<fn>. The Arduino
+framework links with a prebuilt sections.ld and takes no ESP-IDF linker
+fragments, so this script stands in for one. It copies the framework's
+sections.ld into the build directory, adds one input rule at the top of
+.flash.text that collects every .text.unlikely / .literal.unlikely section,
+and links with the copy. The code every wake runs then sits together
+behind it, without cold functions in between, and shares fewer cache
+lines with them.
+
+IRAM placement (HOT_PATH, .iram1.*) needs nothing here: the stock script
+already puts those sections in .iram0.text. Output sections earlier in the
+script keep what they match, so IRAM-only libraries are unaffected.
+
+When the framework's script is not found or has no .flash.text block, the
+build goes on with the stock script and a warning.
+
+  extra_scripts = post:../../scripts/place_cold_text.py
+"""
+from __future__ import annotations
+
+import os
+import re
+from typing import List, Optional, Tuple
+
+COLD_RULE = "*(.text.unlikely .text.unlikely.* .literal.unlikely .literal.unlikely.*)"
+MARKER = "/* place_cold_text.py */"
+
+_FLASH_TEXT_RE = re.compile(r"^\s*\.flash\.text\s*:[^\n]*\n(?:\s*\{[^\n]*\n)?", re.M)
+_TEXT_START_RE = re.compile(r"^(\s*)_text_start\s*=\s*ABSOLUTE\(\.\);[^\n]*\n", re.M)
+
+
+def patch_sections_ld(text: str) -> Tuple[str, bool]:
+    """(script, changed) with COLD_RULE first in .flash.text.
+
+    The rule goes after _text_start so the text symbols still bound the
+    whole block. A script already patched is returned unchanged.
+    """
+    if MARKER in text:
+        return text, False
+    block = _FLASH_TEXT_RE.search(text)
+    if not block or "{" not in block.group(0):
+        return text, False
+    pos = block.end()
+    indent = "    "
+    start = _TEXT_START_RE.search(text, pos)
+    # Only the _text_start of this block, not one further down the script
+    if start and "}" not in text[pos:start.start()]:
+        pos = start.end()
+        indent = start.group(1)
+    rule = f"{indent}{MARKER}\n{indent}{COLD_RULE}\n"
+    return text[:pos] + rule + text[pos:], True
+
+
+def find_script(linkflags: List[str], name: str = "sections.ld") -> Optional[int]:
+    """Index of the -T argument that names the script (either "-T", name or "-Tname")."""
+    for i, flag in enumerate(linkflags):
+        if flag == "-T" and i + 1 < len(linkflags) and os.path.basename(linkflags[i + 1]) == name:
+            return i + 1
+        if flag.startswith("-T") and os.path.basename(flag[2:]) == name:
+            return i
+    return None
+
+
+def replace_script(linkflags: List[str], path: str, name: str = "sections.ld") -> List[str]:
+    """linkflags with the -T script name replaced by path (unchanged if absent)."""
+    out = list(linkflags)
+    i = find_script(out, name)
+    if i is not None:
+        out[i] = "-T" + path if out[i].startswith("-T") else path
+    return out
+
+
+def _configure(env):
+    flags = [str(f) for f in env.Flatten(env.get("LINKFLAGS", []))]
+    i = find_script(flags)
+    if i is None:
+        print("place_cold_text: no -T sections.ld in LINKFLAGS, leaving placement as is")
+        return
+    name = flags[i][2:] if flags[i].startswith("-T") else flags[i]
+    candidates = [name] if os.path.isabs(name) else \
+        [os.path.join(env.subst(str(d)), name) for d in env.Flatten(env.get("LIBPATH", []))]
+    source = next((c for c in candidates if os.path.isfile(c)), None)
+    if source is None:
+        print(f"place_cold_text: {name} not found on LIBPATH, leaving placement as is")
+        return
+
+    with open(source, "r", encoding="utf-8") as f:
+        patched, changed = patch_sections_ld(f.read())
+    if not changed:
+        print(f"place_cold_text: no .flash.text block in {source}, leaving placement as is")
+        return
+    out_dir = os.path.join(env.subst("$BUILD_DIR"), "ld")
+    os.makedirs(out_dir, exist_ok=True)
+    target = os.path.join(out_dir, os.path.basename(name))
+    with open(target, "w", encoding="utf-8") as f:
+        f.write(patched)
+    env.Replace(LINKFLAGS=replace_script(flags, target))
+    env.Depends("$BUILD_DIR/${PROGNAME}.elf", target)
+
+
+try:
+    Import("env")  # noqa: F821 - provided by SCons when run as an extra script
+except NameError:
+    env = None
+
+if env is not None:
+    _configure(env)
@@ -0,0 +1,29 @@
+#!/bin/bash
+# Record the render_golden goldens with the renderer of an earlier revision,
+# so the current tree can be checked against it frame for frame
+#
+# Usage: scripts/record_goldens_from.sh <rev> [golden_dir]
+#   then: GOLDEN_DIR=<golden_dir> pio test -e native_render_golden
+# golden_dir defaults to firmware/arduino/test/render_golden/golden of this
+# checkout. <rev> must already have test/render_golden.
+
+set -e  # Exit on error
+
+if [ -z "$1" ]; then
+    echo "Usage: $0 <rev> [golden_dir]"
+    exit 1
+fi
+
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+REV="$1"
+GOLDEN_DIR="${2:-$ROOT/firmware/arduino/test/render_golden/golden}"
+mkdir -p "$GOLDEN_DIR"
+GOLDEN_DIR="$(cd "$GOLDEN_DIR" && pwd)"
+
+WORKTREE="$(mktemp -d)"
+git -C "$ROOT" worktree add --detach "$WORKTREE" "$REV" >/dev/null
+trap 'git -C "$ROOT" worktree remove --force "$WORKTREE"' EXIT
+
+echo "=== Recording goldens from $REV into $GOLDEN_DIR ==="
+cd "$WORKTREE/firmware/arduino"
+GOLDEN_UPDATE=1 GOLDEN_DIR="$GOLDEN_DIR" pio test -e native_render_golden
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Symbolise a compact crash report from espsensor/<id>/debug/last_crash.
+
+The firmware publishes {"v":1,"reason":..,"pc":"4008a1b2","bt":"..,..",
+"bc":"91c0,3f2a",...}: backtrace PCs as hex and breadcrumbs as 16-bit ids
+hashed from the CRASH_BREADCRUMB("...") literals (crash_record.h). PCs go
+through addr2line against the matching firmware.elf; breadcrumb ids are
+matched by hashing every literal found in the firmware sources.
+"""
+from __future__ import annotations
+
+import argparse
+from dataclasses import dataclass, field
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+from typing import Dict, List, Optional
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_SRC = os.path.join(ROOT, "firmware", "arduino", "src")
+ADDR2LINE = "xtensa-esp32s2-elf-addr2line"
+
+BT_CORRUPT = 1 << 0
+BT_TRUNCATED = 1 << 1
+
+_BREADCRUMB_RE = re.compile(r'CRASH_BREADCRUMB\(\s*"([^"]*)"\s*\)')
+
+
+@dataclass
+class CrashReport:
+    reason: str
+    crash_count: int
+    heap: int
+    pc: int
+    backtrace: List[int] = field(default_factory=list)
+    bt_flags: int = 0
+    breadcrumbs: List[int] = field(default_factory=list)
+
+
+def fnv1a32(s: str) -> int:
+    h = 2166136261
+    for b in s.encode("utf-8"):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def site_id(name: str) -> int:
+    """Same fold as crash_site_id(): 16 bits, 0 reserved for empty slots."""
+    h = fnv1a32(name)
+    folded = (h >> 16) ^ (h & 0xFFFF)
+    return folded or 1
+
+
+def _hex_list(s: str) -> List[int]:
+    return [int(x, 16) for x in s.split(",") if x]
+
+
+def parse_report(payload: str) -> Optional[CrashReport]:
+    try:
+        obj = json.loads(payload)
+        if int(obj["v"]) != 1:
+            return None
+        return CrashReport(
+            reason=str(obj.get("reason", "UNKNOWN")),
+            crash_count=int(obj.get("n", 0)),
+            heap=int(obj.get("heap", 0)),
+            pc=int(obj.get("pc", "0"), 16),
+            backtrace=_hex_list(obj.get("bt", "")),
+            bt_flags=int(obj.get("bt_flags", 0)),
+            breadcrumbs=_hex_list(obj.get("bc", "")),
+        )
+    except Exception:
+        return None
+
+
+def breadcrumb_table(src_dir: str = DEFAULT_SRC) -> Dict[int, List[str]]:
+    """Map site id -> literal(s) for every CRASH_BREADCRUMB in src_dir."""
+    table: Dict[int, List[str]] = {}
+    for dirpath, _dirs, files in os.walk(src_dir):
+        for fn in files:
+            if not fn.endswith((".cpp", ".h", ".ino")):
+                continue
+            with open(os.path.join(dirpath, fn), encoding="utf-8", errors="replace") as f:
+                for name in _BREADCRUMB_RE.findall(f.read()):
+                    names = table.setdefault(site_id(name), [])
+                    if name not in names:
+                        names.append(name)
+    return table
+
+
+def symbolize_pcs(elf: str, pcs: List[int], addr2line: str = ADDR2LINE) -> List[str]:
+    if not pcs:
+        return []
+    cmd = [addr2line, "-pfiaC", "-e", elf] + ["0x%08x" % pc for pc in pcs]
+    out = subprocess.run(cmd, check=True, capture_output=True, text=True).stdout
+    return [line for line in out.splitlines() if line.strip()]
+
+
+def render(report: CrashReport, table: Dict[int, List[str]],
+           symbols: Optional[List[str]] = None) -> str:
+    lines = [
+        "reason=%s crashes=%d heap_at_crash=%d" % (report.reason, report.crash_count, report.heap),
+        "pc 0x%08x" % report.pc,
+    ]
+    flags = []
+    if report.bt_flags & BT_CORRUPT:
+        flags.append("corrupt")
+    if report.bt_flags & BT_TRUNCATED:
+        flags.append("truncated")
+    lines.append("backtrace%s:" % (" (%s)" % ", ".join(flags) if flags else ""))
+    if symbols:
+        lines.extend("  " + s for s in symbols)
+    else:
+        lines.extend("  0x%08x" % pc for pc in report.backtrace)
+    lines.append("breadcrumbs (oldest first):")
+    for bid in report.breadcrumbs:
+        names = table.get(bid)
+        lines.append("  %04x %s" % (bid, " | ".join(names) if names else "?"))
+    return "\n".join(lines)
+
+
+def main() -> None:
+    ap = argparse.ArgumentParser(description="Symbolise a compact last_crash report")
+    ap.add_argument("payload", nargs="?", help="Report JSON (default: stdin)")
+    ap.add_argument("--elf", help="firmware.elf of the crashing build")
+    ap.add_argument("--src", default=DEFAULT_SRC, help="Firmware sources for breadcrumb names")
+    ap.add_argument("--addr2line", default=ADDR2LINE)
+    args = ap.parse_args()
+
+    payload = args.payload if args.payload is not None else sys.stdin.read()
+    report = parse_report(payload.strip())
+    if not report:
+        print("ERR: not a v1 crash report")
+        raise SystemExit(1)
+
+    symbols = None
+    if args.elf:
+        if not shutil.which(args.addr2line):
+            print("WARN: %s not found, printing raw PCs" % args.addr2line, file=sys.stderr)
+        else:
+            symbols = symbolize_pcs(args.elf, report.backtrace or [report.pc], args.addr2line)
+    print(render(report, breadcrumb_table(args.src), symbols))
+
+
+if __name__ == "__main__":
+    main()
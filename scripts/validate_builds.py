@@ -1,22 +1,143 @@
 #!/usr/bin/env python3
+"""Validate PlatformIO builds for all envs.
+
+With --footprint, also measure what each feature flag costs: every env is
+built once with its defaults and once per flag with that flag overridden
+(-DFEATURE_X=0 unless given as FEATURE_X=<value>), each variant in its own
+build directory under --work-dir so repeat runs stay incremental. The
+linker maps are read with map_footprint.py; the report lists flash, DRAM,
+IRAM and RTC use per env and module, and the cost of each flag
+(defaults minus the variant). Exits 3 when a build, or a flag's cost, is
+over its budget in --budget (firmware/arduino/footprint_budget.json).
+
+  python3 scripts/validate_builds.py --footprint                  # Every FEATURE_* flag
+  python3 scripts/validate_builds.py --footprint --features       # Budgets only, no variants
+  python3 scripts/validate_builds.py --footprint --features FEATURE_PROFILING FEATURE_ULP_SAMPLING=1
+"""
 from __future__ import annotations
 
 import argparse
+import json
 import os
+import re
 import subprocess
 import sys
 
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from map_footprint import (  # noqa: E402
+    Footprint,
+    check_budget,
+    diff,
+    env_limits,
+    format_table,
+    load_map,
+    top_modules,
+)
+
+_FLAG_RE = re.compile(r"^\s*#\s*ifndef\s+(FEATURE_[A-Z0-9_]+)\s*$", re.M)
+
 
-def run(cmd: list[str], cwd: str | None = None) -> int:
+def run(cmd: list[str], cwd: str | None = None, env: dict | None = None) -> int:
     print("$", " ".join(cmd))
     try:
-        p = subprocess.run(cmd, cwd=cwd, check=False)
+        p = subprocess.run(cmd, cwd=cwd, check=False, env=env)
         return p.returncode
     except Exception as e:
         print(f"ERROR: {e}", file=sys.stderr)
         return 127
 
 
+def feature_flags(proj: str) -> list[str]:
+    """Every overridable FEATURE_* flag in src/feature_flags.h, in file order."""
+    with open(os.path.join(proj, "src", "feature_flags.h"), encoding="utf-8") as f:
+        names = _FLAG_RE.findall(f.read())
+    return list(dict.fromkeys(names))
+
+
+def parse_override(spec: str) -> tuple[str, str]:
+    name, _, value = spec.partition("=")
+    return name, value or "0"
+
+
+def build_variant(proj: str, env_name: str, build_dir: str | None, defines: list[str]) -> Footprint | None:
+    """Build env with extra -D defines; footprint of its link map, None if it failed."""
+    env = dict(os.environ)
+    extra = " ".join(f"-D{d}" for d in defines)
+    if extra:
+        env["EXTRA_FLAGS"] = (env.get("EXTRA_FLAGS", "") + " " + extra).strip()
+    if build_dir:
+        env["PLATFORMIO_BUILD_DIR"] = build_dir
+    if run(["pio", "run", "-e", env_name], cwd=proj, env=env) != 0:
+        print(f"Build failed for env {env_name} {extra}", file=sys.stderr)
+        return None
+    out = os.path.join(build_dir or os.path.join(proj, ".pio", "build"), env_name)
+    map_path = os.path.join(out, "firmware.map")
+    if not os.path.exists(map_path):
+        maps = [f for f in os.listdir(out) if f.endswith(".map")] if os.path.isdir(out) else []
+        if not maps:
+            print(f"No linker map in {out}", file=sys.stderr)
+            return None
+        map_path = os.path.join(out, maps[0])
+    return load_map(map_path)
+
+
+def footprint(proj: str, envs: list[str], overrides: list[str], budget_path: str,
+              work_dir: str, report_path: str | None, top: int) -> int:
+    budget: dict = {}
+    if os.path.exists(budget_path):
+        with open(budget_path, encoding="utf-8") as f:
+            budget = json.load(f)
+    else:
+        print(f"WARN: no budget file at {budget_path}; reporting only", file=sys.stderr)
+    feature_limits = budget.get("features", {})
+
+    report: dict = {"environments": {}}
+    failures: list[str] = []
+    rc = 0
+    for env_name in envs:
+        # Defaults reuse the normal build directory (what `pio run` left behind)
+        base = build_variant(proj, env_name, None, [])
+        if base is None:
+            rc = 1
+            continue
+        entry: dict = {"footprint": base.to_dict(), "features": {}}
+        failures += check_budget(base.totals, env_limits(budget, env_name), env_name)
+
+        print(f"\n== {env_name}")
+        print(format_table([("TOTAL", base.totals)]))
+        print()
+        print(format_table(top_modules(base, "flash", top)))
+
+        costs = []
+        for spec in overrides:
+            name, value = parse_override(spec)
+            variant_dir = os.path.join(work_dir, f"{name}={value}")
+            fp = build_variant(proj, env_name, variant_dir, [f"{name}={value}"])
+            if fp is None:
+                rc = 1
+                continue
+            # Cost of the flag's default: what the override takes away
+            cost = diff(fp, base)
+            entry["features"][f"{name}={value}"] = cost.to_dict()
+            costs.append((f"{name}={value}", cost.totals))
+            failures += check_budget(cost.totals, {k: int(v) for k, v in feature_limits.get(name, {}).items()},
+                                     f"{env_name} {name}")
+        if costs:
+            print(f"\nCost of each default (defaults - override), {env_name}:")
+            print(format_table(costs, signed=True))
+        report["environments"][env_name] = entry
+
+    report["budget_failures"] = failures
+    if report_path:
+        with open(report_path, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=2, sort_keys=True)
+    for msg in failures:
+        print(f"OVER BUDGET: {msg}", file=sys.stderr)
+    if failures and rc == 0:
+        rc = 3
+    return rc
+
+
 def main() -> int:
     ap = argparse.ArgumentParser(description="Validate PlatformIO builds for all envs")
     ap.add_argument(
@@ -31,6 +152,14 @@ def main() -> int:
             "feather_esp32s2_headless",
         ],
     )
+    ap.add_argument("--footprint", action="store_true",
+                    help="Report flash/DRAM/IRAM/RTC use per module and feature flag, check budgets")
+    ap.add_argument("--features", nargs="*", default=None, metavar="FEATURE_X[=V]",
+                    help="Flags to override for --footprint (default: every FEATURE_* set to 0)")
+    ap.add_argument("--budget", default=None, help="Budget JSON (default: <project>/footprint_budget.json)")
+    ap.add_argument("--work-dir", default=None, help="Variant build root (default: <project>/.pio/footprint)")
+    ap.add_argument("--report", default=None, help="Write the footprint report as JSON")
+    ap.add_argument("--top", type=int, default=15, help="Modules listed per env")
     args = ap.parse_args()
 
     proj = os.path.abspath(args.project_dir)
@@ -53,6 +182,12 @@ def main() -> int:
     except Exception as e:
         # Non-fatal locally; still proceed with builds
         print(f"WARN: header up-to-date check skipped: {e}", file=sys.stderr)
+    if args.footprint:
+        overrides = feature_flags(proj) if args.features is None else args.features
+        return footprint(proj, args.environments, overrides,
+                         args.budget or os.path.join(proj, "footprint_budget.json"),
+                         args.work_dir or os.path.join(proj, ".pio", "footprint"),
+                         args.report, args.top)
     for env in args.environments:
         rc = run(["pio", "run", "-e", env], cwd=proj)
         if rc != 0:
@@ -0,0 +1,41 @@
+from scripts.bench_compare import compare, load_times, regressions
+
+
+def _run(**times):
+    return {
+        "context": {"executable": "bench_core"},
+        "benchmarks": [
+            {"name": n, "run_type": "iteration", "cpu_time": t, "real_time": t, "time_unit": "ns"}
+            for n, t in times.items()
+        ],
+    }
+
+
+def test_load_times_scales_units_and_skips_aggregates():
+    doc = {
+        "benchmarks": [
+            {"name": "a", "run_type": "iteration", "cpu_time": 2.0, "time_unit": "us"},
+            {"name": "a_mean", "run_type": "aggregate", "cpu_time": 9.0, "time_unit": "ns"},
+        ]
+    }
+    assert load_times(doc) == {"a": 2000.0}
+
+
+def test_compare_reports_percent_change():
+    deltas = compare(_run(crc=100.0, base64=50.0), _run(crc=120.0, base64=45.0))
+    by_name = {d.name: d for d in deltas}
+    assert by_name["crc"].change_pct == 20.0
+    assert by_name["base64"].change_pct == -10.0
+
+
+def test_regressions_use_threshold():
+    deltas = compare(_run(crc=100.0, base64=50.0), _run(crc=120.0, base64=52.0))
+    assert [d.name for d in regressions(deltas, 10.0)] == ["crc"]
+    assert regressions(deltas, 25.0) == []
+
+
+def test_added_or_removed_benchmark_is_not_a_regression():
+    deltas = compare(_run(old=10.0), _run(new=10.0))
+    assert [d.name for d in deltas] == ["old", "new"]
+    assert all(d.change_pct is None for d in deltas)
+    assert regressions(deltas, 0.0) == []
@@ -87,6 +87,50 @@ def test_mqtt_subscribe_base_matches_device_yaml():
     assert sub_base_c == sub_base_yaml
 
 
+def test_ha_device_json_tail_is_valid_json():
+    # The firmware prepends {"identifiers":[...], to HA_DEVICE_JSON_TAIL, so the
+    # generated C literal must decode to the rest of a valid JSON object
+    import ast
+    import json
+
+    hdr = _gen_device_header_with_env({"FW_VERSION": 'v1.2-"rc"'})
+    tail_c = _extract_define(hdr, "HA_DEVICE_JSON_TAIL")
+    room_c = _extract_define(hdr, "HA_ROOM_NAME_JSON")
+    assert tail_c is not None and room_c is not None
+
+    tail = ast.literal_eval(tail_c)
+    device = json.loads('{"identifiers":["abc"],' + tail)
+    assert device["identifiers"] == ["abc"]
+    assert device["sw_version"] == 'v1.2-"rc"'
+    assert device["name"].endswith(" Sensor")
+
+    # Room name is spliced into "name":"<room> Temperature" string literals
+    room = ast.literal_eval(room_c)
+    assert json.loads('"' + room + '"') + " Sensor" == device["name"]
+
+
+def test_config_schema_tables_emitted_with_static_asserts():
+    # Strict ranges and string lengths are lowered to static_asserts over
+    # constexpr tables, each row tagged with the FNV-1a hash of its yaml key
+    import sys
+
+    sys.path.insert(0, os.path.join(ROOT, "scripts"))
+    import gen_device_header as gdh  # type: ignore
+
+    hdr = _gen_device_header_with_env({"WAKE_INTERVAL": "1h"})
+    assert "static constexpr ConfigRange CONFIG_RANGES[] = {" in hdr
+    assert "static constexpr ConfigString CONFIG_STRINGS[] = {" in hdr
+    assert gdh.key_hash("wifi.ssid") == 0xF34CF2BD
+    for key, macro, lo, hi, _fallback, strict in gdh.CONFIG_RANGES:
+        assert f'{{"{key}", 0x{gdh.key_hash(key):08X}u, {macro}, {lo}, {hi},' in hdr
+        assert (f'"{key} must be {lo}..{hi} (config/device.yaml)"' in hdr) == strict
+    for key, macro, _lo, hi in gdh.CONFIG_STRINGS:
+        assert f"sizeof({macro}) - 1" in hdr
+        assert f'"{key} longer than {hi} characters (config/device.yaml)"' in hdr
+    hashes = [gdh.key_hash(r[0]) for r in gdh.CONFIG_RANGES + gdh.CONFIG_STRINGS]
+    assert len(set(hashes)) == len(hashes)
+
+
 def test_flash_mode_always_sets_no_sleep_flag(tmp_path):
     # Create a small harness that patches flash.run() to print env and exit without running pio
     harness = tmp_path / "capture_env.py"
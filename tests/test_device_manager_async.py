@@ -437,6 +437,59 @@ class TestIntegration:
             assert received["type"] == original["type"]
 
 
+class TestBatchedFanout:
+    """Tests for WebSocketHub.publish (coalesced, rate-capped device traffic)."""
+
+    @pytest.mark.asyncio
+    async def test_burst_from_thread_arrives_as_one_batch(self):
+        """A burst published off the event loop is coalesced into one frame."""
+        hub = WebSocketHub(max_rate_hz=20.0)
+        ws = MockWebSocket()
+        await hub.connect(ws)
+
+        def burst():
+            for i in range(50):
+                hub.publish({"type": "mqtt", "topic": f"espsensor/d{i % 5}/inside/temperature",
+                             "payload": str(20 + i), "direction": "in"})
+                hub.publish({"type": "serial", "data": f"line {i}"})
+
+        await asyncio.get_running_loop().run_in_executor(None, burst)
+        await asyncio.sleep(0.2)
+
+        frames = [json.loads(m) for m in ws.messages]
+        items = [m for f in frames for m in (f["messages"] if f["type"] == "batch" else [f])]
+        temps = [m for m in items if m["type"] == "mqtt"]
+        lines = [m["data"] for m in items if m["type"] == "serial"]
+        assert len(frames) < 10
+        # Newest reading per device, every log line in order
+        newest = {m["topic"]: m["payload"] for m in temps}
+        assert sorted(newest.values()) == ["65", "66", "67", "68", "69"]
+        assert lines == [f"line {i}" for i in range(50)]
+
+    @pytest.mark.asyncio
+    async def test_publish_without_clients_is_dropped(self):
+        """Nothing is buffered while no browser is connected."""
+        hub = WebSocketHub()
+        hub.publish({"type": "serial", "data": "x"})
+        assert hub.get_stats()["pending"] == 0
+
+    @pytest.mark.asyncio
+    async def test_frame_rate_is_capped(self):
+        """Frames to a client are spaced by the rate cap."""
+        hub = WebSocketHub(max_rate_hz=10.0)
+        ws = MockWebSocket()
+        await hub.connect(ws)
+
+        start = asyncio.get_running_loop().time()
+        for i in range(3):
+            hub.publish({"type": "serial", "data": f"a{i}"})
+            await asyncio.sleep(0.01)
+        await asyncio.sleep(0.25)
+
+        assert len(ws.messages) >= 2
+        assert asyncio.get_running_loop().time() - start >= 0.1
+
+
 class TestEdgeCases:
     """Edge case tests for async components."""
 
@@ -0,0 +1,110 @@
+"""
+Tests for the device manager's coalescing WebSocket fan-out buffer.
+
+Covers per-topic coalescing, unchanged-state suppression, the per-device
+screenshot throttle and the serial line cap (scripts/device_manager/fanout.py).
+"""
+
+import os
+import sys
+
+# Add scripts to path
+ROOT = os.path.dirname(os.path.dirname(__file__))
+sys.path.insert(0, os.path.join(ROOT, "scripts"))
+
+from device_manager.fanout import FanoutBuffer
+
+
+class FakeClock:
+    def __init__(self):
+        self.now = 100.0
+
+    def __call__(self):
+        return self.now
+
+
+def mqtt(topic, payload, direction="in"):
+    return {"type": "mqtt", "topic": topic, "payload": payload, "direction": direction}
+
+
+def test_newest_state_per_topic_wins():
+    buf = FanoutBuffer()
+    assert buf.add(mqtt("espsensor/a/inside/temperature", "21.0"))
+    assert not buf.add(mqtt("espsensor/b/inside/temperature", "19.5"))
+    buf.add(mqtt("espsensor/a/inside/temperature", "21.4"))
+
+    out = buf.drain()
+    # First-arrival order, newest payload
+    assert [(m["topic"], m["payload"]) for m in out] == [
+        ("espsensor/a/inside/temperature", "21.4"),
+        ("espsensor/b/inside/temperature", "19.5"),
+    ]
+    assert buf.stats()["coalesced"] == 1
+
+
+def test_unchanged_state_is_not_resent():
+    buf = FanoutBuffer()
+    buf.add(mqtt("espsensor/a/inside/humidity", "41"))
+    assert len(buf.drain()) == 1
+    # Idle again, so the next add asks for a flush
+    assert buf.add(mqtt("espsensor/a/inside/humidity", "41"))
+    assert buf.drain() == []
+    buf.add(mqtt("espsensor/a/inside/humidity", "42"))
+    assert [m["payload"] for m in buf.drain()] == ["42"]
+    assert buf.stats()["unchanged"] == 1
+
+
+def test_forget_resends_state_to_new_clients():
+    buf = FanoutBuffer()
+    buf.add(mqtt("espsensor/a/status", "online"))
+    buf.drain()
+    buf.forget()
+    buf.add(mqtt("espsensor/a/status", "online"))
+    assert len(buf.drain()) == 1
+
+
+def test_directions_are_separate_state():
+    buf = FanoutBuffer()
+    buf.add(mqtt("espsensor/a/cmd/screenshot", "rle", direction="out"))
+    buf.add(mqtt("espsensor/a/cmd/screenshot", "rle", direction="in"))
+    assert len(buf.drain()) == 2
+
+
+def test_screenshots_throttled_per_device():
+    clock = FakeClock()
+    buf = FanoutBuffer(screenshot_interval=1.0, clock=clock)
+    buf.add({"type": "screenshot", "device_id": "a", "data": "f1"})
+    buf.add({"type": "screenshot", "device_id": "b", "data": "g1"})
+    assert [m["data"] for m in buf.drain()] == ["f1", "g1"]
+
+    clock.now += 0.3
+    buf.add({"type": "screenshot", "device_id": "a", "data": "f2"})
+    buf.add({"type": "screenshot", "device_id": "a", "data": "f3"})
+    assert buf.drain() == []
+    assert abs(buf.next_due() - 0.7) < 1e-9
+
+    # Held frame stays pending (no new flush request) and goes out once due
+    assert not buf.add({"type": "serial", "data": "x"})
+    assert [m["data"] for m in buf.drain()] == ["x"]
+    clock.now += 0.7
+    assert [m["data"] for m in buf.drain()] == ["f3"]
+    assert buf.next_due() is None
+
+
+def test_serial_lines_keep_order_with_cap():
+    buf = FanoutBuffer(max_log_lines=3)
+    for i in range(5):
+        buf.add({"type": "serial", "data": f"line {i}"})
+    assert [m["data"] for m in buf.drain()] == ["line 2", "line 3", "line 4"]
+    assert buf.stats()["dropped"] == 2
+
+
+def test_other_events_are_never_coalesced():
+    buf = FanoutBuffer()
+    buf.add({"type": "mqtt_status", "connected": False})
+    buf.add({"type": "mqtt_status", "connected": True})
+    buf.add(mqtt("espsensor/a/status", "online"))
+    buf.add({"type": "device_mode_changed", "device_id": "a"})
+    out = buf.drain()
+    assert [m["type"] for m in out] == ["mqtt_status", "mqtt_status", "mqtt", "device_mode_changed"]
+    assert buf.stats() == {"pending": 0, "coalesced": 0, "dropped": 0, "unchanged": 0}
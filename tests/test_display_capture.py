@@ -9,9 +9,15 @@ These tests verify:
 
 import base64
 import json
+import os
+import sys
+import zlib
 import pytest
 from unittest.mock import Mock, patch
 
+ROOT = os.path.dirname(os.path.dirname(__file__))
+sys.path.insert(0, os.path.join(ROOT, "scripts"))
+
 # Display dimensions matching firmware
 DISPLAY_WIDTH = 250
 DISPLAY_HEIGHT = 122
@@ -228,5 +234,95 @@ class TestMQTTTopics:
         assert topic == "espsensor/esp32-test/cmd/debug"
 
 
+
+def _packbits(data: bytes) -> bytes:
+    """Reference encoder mirroring capture_codec.h (runs of 3+ repeat)."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 3:
+            out += bytes([257 - run, data[i]])
+            i += run
+            continue
+        lit = 0
+        while i + lit < len(data) and lit < 128:
+            j = i + lit
+            if j + 2 < len(data) and data[j] == data[j + 1] == data[j + 2]:
+                break
+            lit += 1
+        out.append(lit - 1)
+        out += data[i:i + lit]
+        i += lit
+    return bytes(out)
+
+
+class _Msg:
+    def __init__(self, topic, payload):
+        self.topic = topic
+        self.payload = payload
+
+
+class TestCompressedScreenshot:
+    """PackBits/XOR-delta screenshots decoded by the device manager."""
+
+    @pytest.fixture
+    def handler_mod(self):
+        pytest.importorskip("PIL")
+        from device_manager import screenshot_handler
+        return screenshot_handler
+
+    def test_blank_frame_is_small(self, handler_mod):
+        stream = _packbits(bytes(BUFFER_SIZE))
+        assert len(stream) == 62
+        assert handler_mod.decode_packbits(stream, BUFFER_SIZE) == bytes(BUFFER_SIZE)
+
+    def test_decode_rejects_bad_streams(self, handler_mod):
+        with pytest.raises(ValueError):
+            handler_mod.decode_packbits(bytes([0x03, 1, 2]), 4)
+        with pytest.raises(ValueError):
+            handler_mod.decode_packbits(bytes([0xFF, 9]), 4)
+
+    def _send(self, handler, frame, base=None, chunk=512):
+        delta = bytes(a ^ b for a, b in zip(frame, base)) if base else frame
+        stream = _packbits(delta)
+        chunks = [stream[i:i + chunk] for i in range(0, len(stream), chunk)]
+        meta = {"width": DISPLAY_WIDTH, "height": DISPLAY_HEIGHT, "format": "packbits",
+                "delta": base is not None, "crc": zlib.crc32(frame),
+                "data_size": len(stream), "chunks": len(chunks),
+                "buffer_size": BUFFER_SIZE}
+        if base is not None:
+            meta["base_crc"] = zlib.crc32(base)
+        handler._handle_screenshot_meta(_Msg("espsensor/x/debug/screenshot/meta",
+                                             json.dumps(meta).encode()))
+        for n, c in enumerate(chunks):
+            handler._handle_screenshot_data(_Msg(f"espsensor/x/debug/screenshot/data/{n}", c))
+
+    def test_keyframe_then_delta(self, handler_mod):
+        handler = handler_mod.ScreenshotHandler()
+        key = bytearray(BUFFER_SIZE)
+        key[0:32] = b"\xFF" * 32                 # Top border
+        key = bytes(key)
+        self._send(handler, key)
+        assert handler._last_frame == key
+        assert handler.latest_screenshot is not None
+
+        changed = bytearray(key)
+        changed[1000] ^= 0x3C
+        changed = bytes(changed)
+        self._send(handler, changed, base=key)
+        assert handler._last_frame == changed
+
+    def test_delta_against_unknown_base_is_dropped(self, handler_mod):
+        handler = handler_mod.ScreenshotHandler()
+        base = bytes(BUFFER_SIZE)
+        frame = bytes([1]) + bytes(BUFFER_SIZE - 1)
+        self._send(handler, frame, base=base)
+        assert handler._last_frame is None
+        assert handler.latest_screenshot is None
+
+
 if __name__ == "__main__":
     pytest.main([__file__, "-v"])
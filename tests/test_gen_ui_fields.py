@@ -0,0 +1,50 @@
+import importlib.util
+import os
+
+import pytest
+
+ROOT = os.path.dirname(os.path.dirname(__file__))
+_module_path = os.path.join(ROOT, "scripts", "gen_ui.py")
+_spec = importlib.util.spec_from_file_location("gen_ui", _module_path)
+gen_ui = importlib.util.module_from_spec(_spec)  # type: ignore
+_spec.loader.exec_module(gen_ui)  # type: ignore
+
+
+def test_template_is_split_into_literal_and_field_segments():
+    segs = gen_ui.parse_text_template("{battery_voltage:.2f}V {battery_percent}% ~{days}d")
+    assert segs == [
+        ("", ("battery_voltage", "CONV_NONE", 2)),
+        ("V ", ("battery_percent", "CONV_NONE", -1)),
+        ("% ~", ("days", "CONV_NONE", -1)),
+        ("d", None),
+    ]
+
+
+def test_conversion_and_static_text():
+    assert gen_ui.parse_text_template("{wind_mps->mph:.1f} mph") == [
+        ("", ("wind_mps", "CONV_MPS_TO_MPH", 1)),
+        (" mph", None),
+    ]
+    assert gen_ui.parse_text_template("INSIDE") == [("INSIDE", None)]
+
+
+def test_unknown_conversion_is_rejected():
+    with pytest.raises(SystemExit):
+        gen_ui.parse_text_template("{wind_mps->knots}")
+
+
+def test_ops_bind_fields_by_enum():
+    spec = gen_ui.load_ui_spec()
+    fields = gen_ui.collect_fields(spec)
+    # Template fields and single-source ops (tempGroupCentered, iconIn, ...)
+    for name in ("room_name", "wind_mps", "inside_temp_f", "battery_percent"):
+        assert name in fields
+
+    header = gen_ui.emit_fw_ops_header(spec)
+    assert "enum FieldId {" in header
+    assert "FIELD__COUNT," in header
+    assert "struct UiTextSeg" in header
+
+    cpp = gen_ui.emit_fw_ops_cpp(spec)
+    assert '{ "", FIELD_WIND_MPS, CONV_MPS_TO_MPH, 1 },' in cpp
+    assert "FIELD_INSIDE_TEMP_F, 0, NULL }" in cpp
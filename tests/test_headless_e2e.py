@@ -123,8 +123,8 @@ def test_device_publishes_ui_debug_from_outdoor_aliases():
     assert msgs_val and msgs_val[0][1] is True, "debug_ui should be retained for new subscribers"
     val.disconnect()
 
-    # Also verify the device publishes a layout identity retained
-    msgs_layout = sub.subscribe_and_wait(f"{pub_base}/layout", expected_count=1, timeout_s=5.0)
+    # Also verify the layout identity, part of the retained diagnostics document
+    msgs_layout = sub.subscribe_and_wait(f"{pub_base}/debug/diagnostics", expected_count=1, timeout_s=5.0)
     assert msgs_layout and msgs_layout[0][1] is True
     layout_payload = msgs_layout[0][0]
     assert "layout_version" in layout_payload
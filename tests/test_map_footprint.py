@@ -0,0 +1,124 @@
+from scripts.map_footprint import (
+    check_budget,
+    diff,
+    env_limits,
+    module_name,
+    parse_map,
+    section_regions,
+    top_modules,
+)
+
+# Trimmed from an ESP32-S2 Arduino link map: wrapped names, fill, symbols,
+# input patterns, a dummy section and debug info
+MAP = """\
+Archive member included to satisfy reference by file (symbol)
+
+Memory Configuration
+
+Linker script and memory map
+
+LOAD /p/.pio/build/env/src/main.cpp.o
+.rtc.text       0x40070000        0x0
+ *(.rtc.literal .rtc.text .rtc.text.*)
+
+.rtc.data       0x50000000       0x20
+ *(.rtc.data)
+ .rtc.data      0x50000000       0x20 /p/.pio/build/env/src/rtc_state.cpp.o
+                0x50000000                g_rtc_state
+
+.rtc.bss        0x50000020      0x100
+ .rtc.bss       0x50000020      0x100 /p/.pio/build/env/src/logging/log_buffer.cpp.o
+
+.iram0.vectors  0x40022000      0x403
+ .exception_vectors.text
+                0x40022000      0x403 /home/u/.platformio/packages/framework-arduinoespressif32/tools/sdk/esp32s2/lib/libesp_system.a(cpu_start.c.obj)
+
+.iram0.text     0x40022403      0x40d
+ *fill*         0x40022403        0x1
+ .iram1.0       0x40022404      0x40c /p/.pio/build/env/src/power.cpp.o
+
+.dram0.dummy    0x3ffb0000     0x4000
+
+.dram0.data     0x3ffb4000       0x30
+ .data.g_cfg    0x3ffb4000       0x30 /p/.pio/build/env/src/main.cpp.o
+
+.dram0.bss      0x3ffb4030      0x200
+ .bss.g_pool    0x3ffb4030      0x200 /p/.pio/build/env/src/buffer_pool.cpp.o
+
+.flash.rodata   0x3f000020      0x500
+ .rodata._ZL5icons
+                0x3f000020      0x400 /p/.pio/build/env/src/main.cpp.o
+ .rodata        0x3f000420      0x100 /p/.pio/build/env/lib8b1/libAdafruit GFX Library.a(Adafruit_GFX.cpp.o)
+
+.flash.rodata_noload
+                0x3f000520        0x0
+
+.flash.text     0x40080020      0x800
+ .text.setup    0x40080020      0x200 /p/.pio/build/env/src/main.cpp.o
+                0x40080020                setup
+ .text.loop     0x40080220      0x600 /p/.pio/build/env/libFrameworkArduino.a(main.cpp.o)
+
+.debug_info     0x00000000    0x12345
+ .debug_info    0x00000000    0x12345 /p/.pio/build/env/src/main.cpp.o
+OUTPUT(/p/.pio/build/env/firmware.elf elf32-xtensa-le)
+"""
+
+
+def test_section_regions():
+    assert section_regions(".rtc.bss") == ("rtc", False)
+    assert section_regions(".rtc.data") == ("rtc", True)
+    assert section_regions(".rtc_noinit") == ("rtc", False)
+    assert section_regions(".iram0.text") == ("iram", True)
+    assert section_regions(".dram0.data") == ("dram", True)
+    assert section_regions(".dram0.bss") == ("dram", False)
+    assert section_regions(".dram0.dummy") == (None, False)
+    assert section_regions(".flash.text") == ("flash", False)
+    assert section_regions(".flash.rodata_noload") == (None, False)
+    assert section_regions(".debug_line") == (None, False)
+
+
+def test_module_names():
+    assert module_name("/p/.pio/build/env/src/main.cpp.o") == "src/main.cpp"
+    assert module_name("/p/.pio/build/env/src/logging/log_buffer.cpp.o") == "src/logging/log_buffer.cpp"
+    assert module_name("/x/lib/libesp_wifi.a(wifi_init.c.obj)") == "esp_wifi"
+    assert module_name("/p/.pio/build/env/lib8b1/libAdafruit GFX Library.a(Adafruit_GFX.cpp.o)") == \
+        "Adafruit GFX Library"
+    assert module_name("C:\\p\\.pio\\build\\env\\src\\net.cpp.o") == "src/net.cpp"
+
+
+def test_parse_map_totals_and_modules():
+    fp = parse_map(MAP.splitlines(True))
+    assert fp.totals["rtc"] == 0x120
+    assert fp.totals["iram"] == 0x403 + 0x40d
+    assert fp.totals["dram"] == 0x230
+    # Flash-resident code/rodata plus the loaded copies of .rtc.data, IRAM, .data
+    assert fp.totals["flash"] == 0x500 + 0x800 + 0x20 + 0x403 + 0x40d + 0x30
+
+    main = fp.modules["src/main.cpp"]
+    assert main == {"flash": 0x400 + 0x200 + 0x30, "dram": 0x30, "iram": 0, "rtc": 0}
+    assert fp.modules["src/logging/log_buffer.cpp"]["rtc"] == 0x100
+    assert fp.modules["src/logging/log_buffer.cpp"]["flash"] == 0
+    assert fp.modules["esp_system"]["iram"] == 0x403
+    assert fp.modules["(fill)"]["iram"] == 1
+    assert fp.modules["FrameworkArduino"]["flash"] == 0x600
+
+
+def test_diff_and_top_modules():
+    base = parse_map(MAP.splitlines(True))
+    smaller = parse_map(MAP.replace("0x200 /p/.pio/build/env/src/main.cpp.o",
+                                    "0x100 /p/.pio/build/env/src/main.cpp.o").splitlines(True))
+    d = diff(base, smaller)
+    assert d.totals["flash"] == -0x100
+    assert list(d.modules) == ["src/main.cpp"]
+    assert top_modules(base, "flash", 1)[0][0] == "src/main.cpp"
+
+
+def test_budgets():
+    budget = {"default": {"flash": 4000, "rtc": 512},
+              "environments": {"small": {"flash": 100}}}
+    assert env_limits(budget, "other") == {"flash": 4000, "rtc": 512}
+    assert env_limits(budget, "small") == {"flash": 100, "rtc": 512}
+    totals = {"flash": 3000, "dram": 0, "iram": 0, "rtc": 600}
+    msgs = check_budget(totals, env_limits(budget, "other"), "env")
+    assert msgs == ["env: rtc 600 B exceeds budget 512 B"]
+    assert len(check_budget(totals, env_limits(budget, "small"), "env")) == 2
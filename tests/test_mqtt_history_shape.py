@@ -1,4 +1,4 @@
-from scripts.parse_history_payload import parse_history_payload
+from scripts.parse_history_payload import parse_history_batch, parse_history_payload
 
 
 def test_history_payload_valid_minimal():
@@ -22,3 +22,26 @@ def test_history_payload_types_and_bounds():
         assert rec.ts >= 1_600_000_000
         assert -100.0 < rec.tempF < 200.0
         assert 0.0 <= rec.rh <= 100.0
+
+
+def test_history_batch_decodes_deltas_and_scales():
+    payload = '{"v":1,"t0":1710000000,"s":[[0,2150,4512,10132],[300,2148,null,10131],[300,-50,4490,null]]}'
+    recs = parse_history_batch(payload)
+    assert recs is not None
+    assert [r.ts for r in recs] == [1710000000, 1710000300, 1710000600]
+    assert abs(recs[0].tempC - 21.5) < 1e-6
+    assert abs(recs[0].rh - 45.12) < 1e-6
+    assert abs(recs[0].pressureHPa - 1013.2) < 1e-6
+    assert recs[1].rh is None
+    assert abs(recs[2].tempC + 0.5) < 1e-6
+    assert recs[2].pressureHPa is None
+
+
+def test_history_batch_rejects_malformed():
+    for p in [
+        "",
+        '{"v":2,"t0":1710000000,"s":[]}',
+        '{"v":1,"s":[[0,1,2,3]]}',
+        '{"v":1,"t0":1710000000,"s":[[0,1,2]]}',
+    ]:
+        assert parse_history_batch(p) is None
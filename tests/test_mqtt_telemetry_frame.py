@@ -0,0 +1,38 @@
+import pytest
+
+from scripts.mqtt_topics import decode_telemetry_frame
+
+# Same golden vectors as firmware/arduino/test/test_telemetry_frame
+GOLDEN_FULL = bytes.fromhex("015908c6119427480f57bdd20400002c03aa05a606")
+GOLDEN_MISSING = bytes.fromhex("010080ffffffffffffff0007000000000000000000")
+
+
+def test_telemetry_frame_decodes_golden_vector():
+    rec = decode_telemetry_frame(GOLDEN_FULL)
+    assert rec["version"] == 1
+    assert rec["temp_c"] == pytest.approx(21.37)
+    assert rec["rh_pct"] == pytest.approx(45.5)
+    assert rec["pressure_hpa"] == pytest.approx(1013.2)
+    assert rec["battery_v"] == pytest.approx(3.912)
+    assert rec["battery_pct"] == 87
+    assert rec["rssi_dbm"] == -67
+    assert rec["wake_count"] == 1234
+    assert rec["timeline_ms"] == {"sensor": 812, "wifi": 1450, "mqtt": 1702}
+
+
+def test_telemetry_frame_sentinels_decode_as_none():
+    rec = decode_telemetry_frame(GOLDEN_MISSING)
+    for key in ("temp_c", "rh_pct", "pressure_hpa", "battery_v", "battery_pct", "rssi_dbm"):
+        assert rec[key] is None
+    assert rec["wake_count"] == 7
+    assert rec["timeline_ms"] == {"sensor": None, "wifi": None, "mqtt": None}
+
+
+def test_telemetry_frame_rejects_bad_input():
+    assert len(GOLDEN_FULL) < 40
+    with pytest.raises(ValueError):
+        decode_telemetry_frame(b"")
+    with pytest.raises(ValueError):
+        decode_telemetry_frame(b"\x02" + GOLDEN_FULL[1:])
+    with pytest.raises(ValueError):
+        decode_telemetry_frame(GOLDEN_FULL[:-1])
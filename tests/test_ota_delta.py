@@ -0,0 +1,77 @@
+import hashlib
+import random
+import struct
+
+from scripts.ota_delta import (
+    OP_ADD,
+    OP_COPY,
+    OP_DATA,
+    OP_END,
+    apply_patch,
+    chunks,
+    make_patch,
+    manifest,
+    varint,
+)
+
+
+def _image(seed: int, size: int) -> bytes:
+    rng = random.Random(seed)
+    return bytes(rng.randrange(256) for _ in range(size))
+
+
+def test_varint_is_leb128():
+    assert varint(0) == b"\x00"
+    assert varint(127) == b"\x7f"
+    assert varint(128) == b"\x80\x01"
+    assert varint(300) == b"\xac\x02"
+
+
+def test_identical_image_is_one_copy():
+    src = _image(1, 4096)
+    patch = make_patch(src, src)
+    assert patch == bytes([OP_COPY]) + varint(0) + varint(4096) + bytes([OP_END])
+    assert apply_patch(src, patch) == src
+
+
+def test_shifted_and_relinked_image_stays_small():
+    src = _image(2, 40000)
+    dst = bytearray(src[:8000]) + b"inserted function" * 20 + bytearray(src[8000:])
+    # Relocated call targets: scattered one-byte changes
+    for i in range(0, len(dst), 509):
+        dst[i] = (dst[i] + 4) & 0xFF
+    dst = bytes(dst)
+    patch = make_patch(src, dst)
+    assert apply_patch(src, patch) == dst
+    assert len(patch) < len(dst) // 20
+    assert OP_ADD in patch
+
+
+def test_unrelated_image_falls_back_to_data():
+    src = _image(3, 2000)
+    dst = _image(4, 2000)
+    patch = make_patch(src, dst)
+    assert patch[0] == OP_DATA
+    assert apply_patch(src, patch) == dst
+
+
+def test_manifest_and_chunks():
+    src = _image(5, 3000)
+    dst = src[:1000] + b"x" * 50 + src[1000:]
+    patch = make_patch(src, dst)
+    doc = manifest(src, dst, patch)
+    assert doc["size"] == len(patch)
+    assert doc["src"] == hashlib.sha256(src).hexdigest()
+    assert doc["dst_size"] == len(dst)
+    assert doc["id"] != 0
+
+    msgs = chunks(patch, doc["id"], 0, len(patch), 8)
+    rebuilt = b""
+    for m in msgs:
+        job, off = struct.unpack_from("<II", m)
+        assert job == doc["id"]
+        assert off == len(rebuilt)
+        rebuilt += m[8:]
+    assert rebuilt == patch
+    # A request past the end answers nothing
+    assert chunks(patch, doc["id"], len(patch), 100, 8) == []
@@ -0,0 +1,75 @@
+from scripts.place_cold_text import (
+    COLD_RULE,
+    MARKER,
+    find_script,
+    patch_sections_ld,
+    replace_script,
+)
+
+# Trimmed from the ESP32-S2 sections.ld the Arduino framework links with
+SECTIONS = """\
+SECTIONS
+{
+  .iram0.text :
+  {
+    _iram_text_start = ABSOLUTE(.);
+    *libfreertos.a:(.literal .literal.* .text .text.*)
+    _iram_text_end = ABSOLUTE(.);
+  } > iram0_0_seg
+
+  .flash.text :
+  {
+    _stext = .;
+    _instruction_reserved_start = ABSOLUTE(.);
+    _text_start = ABSOLUTE(.);
+    *(EXCLUDE_FILE(*libfreertos.a) .literal EXCLUDE_FILE(*libfreertos.a) .literal.* .text .text.*)
+    _text_end = ABSOLUTE(.);
+  } >default_code_seg
+}
+"""
+
+
+def test_cold_rule_goes_first_in_flash_text():
+    out, changed = patch_sections_ld(SECTIONS)
+    assert changed
+    lines = out.splitlines()
+    start = lines.index("    _text_start = ABSOLUTE(.);")
+    assert lines[start + 1] == "    " + MARKER
+    assert lines[start + 2] == "    " + COLD_RULE
+    assert lines[start + 3].lstrip().startswith("*(EXCLUDE_FILE")
+    # IRAM rules are untouched and still come first
+    assert out.index(COLD_RULE) > out.index("*libfreertos.a:(.literal")
+    assert out.count(COLD_RULE) == 1
+
+
+def test_patch_is_idempotent():
+    once, _ = patch_sections_ld(SECTIONS)
+    twice, changed = patch_sections_ld(once)
+    assert not changed
+    assert twice == once
+
+
+def test_block_without_text_start_gets_rule_after_brace():
+    text = ".flash.text :\n{\n  *(.text .text.*)\n}\n.other :\n{\n  _text_start = ABSOLUTE(.);\n}\n"
+    out, changed = patch_sections_ld(text)
+    assert changed
+    assert out.splitlines()[2] == "    " + MARKER
+    assert out.splitlines()[3] == "    " + COLD_RULE
+
+
+def test_script_without_flash_text_is_left_alone():
+    text = "SECTIONS\n{\n  .text : { *(.text) }\n}\n"
+    assert patch_sections_ld(text) == (text, False)
+
+
+def test_linkflags_rewrite():
+    flags = ["-nostdlib", "-T", "memory.ld", "-T", "sections.ld", "-u", "app_main"]
+    assert find_script(flags) == 4
+    assert replace_script(flags, "/b/ld/sections.ld")[3:5] == ["-T", "/b/ld/sections.ld"]
+
+    joined = ["-Tesp32s2.rom.ld", "-Tsections.ld"]
+    assert find_script(joined) == 1
+    assert replace_script(joined, "/b/ld/sections.ld") == ["-Tesp32s2.rom.ld", "-T/b/ld/sections.ld"]
+
+    assert find_script(["-T", "memory.ld"]) is None
+    assert replace_script(["-T", "memory.ld"], "/x") == ["-T", "memory.ld"]
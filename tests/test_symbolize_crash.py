@@ -0,0 +1,46 @@
+from scripts.symbolize_crash import breadcrumb_table, parse_report, render, site_id
+
+
+def test_site_id_matches_firmware_hash():
+    # Values from crash_site_id() in firmware/arduino/src/crash_record.h
+    assert site_id("a") == 0xE40C ^ 0x292C
+    assert site_id("run_network_phase") == 0x7781
+    assert site_id("run_sleep_phase") == 0xC749
+
+
+def test_parse_compact_report():
+    payload = (
+        '{"v":1,"reason":"PANIC","n":3,"heap":81234,"pc":"4008a1b2",'
+        '"bt":"4008a1b2,400d1234","bt_flags":2,"bc":"7781,c749"}'
+    )
+    rep = parse_report(payload)
+    assert rep is not None
+    assert rep.reason == "PANIC"
+    assert rep.crash_count == 3
+    assert rep.pc == 0x4008A1B2
+    assert rep.backtrace == [0x4008A1B2, 0x400D1234]
+    assert rep.bt_flags == 2
+    assert rep.breadcrumbs == [0x7781, 0xC749]
+
+
+def test_parse_rejects_other_payloads():
+    assert parse_report("none") is None
+    assert parse_report('{"v":2}') is None
+
+
+def test_empty_lists_and_render(tmp_path):
+    src = tmp_path / "a.cpp"
+    src.write_text('void f() {\n  CRASH_BREADCRUMB("run_network_phase");\n}\n')
+    table = breadcrumb_table(str(tmp_path))
+    assert table == {0x7781: ["run_network_phase"]}
+
+    rep = parse_report('{"v":1,"reason":"BROWNOUT","pc":"00000000","bt":"","bc":"7781,0001"}')
+    assert rep is not None and rep.backtrace == []
+    text = render(rep, table)
+    assert "7781 run_network_phase" in text
+    assert "0001 ?" in text
+
+
+def test_firmware_sources_have_breadcrumbs():
+    table = breadcrumb_table()
+    assert site_id("run_sensor_phase") in table
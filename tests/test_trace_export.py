@@ -0,0 +1,75 @@
+"""
+Tests for the hot-path trace export: compact firmware chunks
+(firmware/arduino/src/trace_buffer.h) reassembled by the device manager into
+Chrome trace_event JSON.
+"""
+
+import json
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(__file__))
+sys.path.insert(0, os.path.join(ROOT, "scripts"))
+
+from device_manager.trace_handler import TraceHandler, build_chrome_trace
+
+
+class _Msg:
+    def __init__(self, topic, payload):
+        self.topic = topic
+        self.payload = payload
+
+
+META = {"events": 6, "overwritten": 0, "skipped": 0, "chunks": 2, "now_us": 5000,
+        "tasks": [[0, "loopTask"], [1, "panel_refresh"]]}
+CHUNKS = [
+    [[100, "B", 0, "wifi_connect"], [150, "B", 1, "panel"]],
+    [[900, "E", 0], [1200, "E", 1], [1300, "B", 0, "mqtt_connect"], [1400, "E", 0]],
+]
+
+
+def test_chrome_trace_shape():
+    trace = build_chrome_trace(META, CHUNKS, "office")
+    events = trace["traceEvents"]
+    threads = {e["tid"]: e["args"]["name"] for e in events if e.get("name") == "thread_name"}
+    assert threads == {0: "loopTask", 1: "panel_refresh"}
+
+    timed = [e for e in events if e["ph"] in ("B", "E")]
+    assert len(timed) == 6
+    assert all(e["pid"] == 1 and "ts" in e for e in timed)
+    begins = [e["name"] for e in timed if e["ph"] == "B"]
+    assert begins == ["wifi_connect", "panel", "mqtt_connect"]
+    assert trace["otherData"]["device_id"] == "office"
+    # Must round-trip as JSON for chrome://tracing / Perfetto
+    json.loads(json.dumps(trace))
+
+
+def test_orphan_ends_are_dropped():
+    # The begin of the first span was overwritten by ring wraparound
+    trace = build_chrome_trace({"tasks": [[0, "loopTask"]]},
+                               [[[10, "E", 0], [20, "B", 0, "x"], [30, "E", 0]]])
+    timed = [e for e in trace["traceEvents"] if e["ph"] in ("B", "E")]
+    assert [e["ph"] for e in timed] == ["B", "E"]
+    assert trace["otherData"]["orphan_ends"] == 1
+
+
+def test_handler_assembles_out_of_order_chunks():
+    handler = TraceHandler()
+    handler._on_mqtt_message(_Msg("espsensor/office/debug/trace/meta", json.dumps(META).encode()))
+    handler._on_mqtt_message(_Msg("espsensor/office/debug/trace/data/1", json.dumps(CHUNKS[1]).encode()))
+    assert handler.get_latest_trace() is None
+    handler._on_mqtt_message(_Msg("espsensor/office/debug/trace/data/0", json.dumps(CHUNKS[0]).encode()))
+
+    trace = handler.get_latest_trace()
+    assert trace is not None
+    timed = [e for e in trace["traceEvents"] if e["ph"] in ("B", "E")]
+    assert [e["ts"] for e in timed] == [100, 150, 900, 1200, 1300, 1400]
+
+
+def test_empty_dump_completes_on_meta():
+    handler = TraceHandler()
+    meta = dict(META, events=0, chunks=0)
+    handler._on_mqtt_message(_Msg("espsensor/office/debug/trace/meta", json.dumps(meta).encode()))
+    trace = handler.get_latest_trace()
+    assert trace is not None
+    assert not [e for e in trace["traceEvents"] if e["ph"] in ("B", "E")]
@@ -29,7 +29,9 @@ export function useWebSocket(url) {
     ws.onmessage = (event) => {
       try {
         const msg = JSON.parse(event.data);
-        setMessages(prev => [...prev.slice(-1000), msg]); // Keep last 1000 messages
+        // The hub batches device traffic; one state update per frame
+        const batch = msg.type === 'batch' ? msg.messages : [msg];
+        setMessages(prev => [...prev, ...batch].slice(-1000)); // Keep last 1000 messages
       } catch (err) {
         console.error('Error parsing WebSocket message:', err);
       }
@@ -1,6 +1,6 @@
 // AUTO-GENERATED by scripts/gen_ui.py - DO NOT EDIT
-window.UI_SPEC = {"schema":"ui-spec@1","canvas":{"w":250,"h":122},"fonts":{"tokens":{"big":{"px":22,"weight":"bold"},"label":{"px":11,"weight":"bold"},"small":{"px":10},"time":{"px":11}}},"rects":{"HEADER_NAME":[6,2,90,14],"HEADER_VERSION":[172,2,72,14],"HEADER_TIME_CENTER":[100,2,50,14],"INSIDE_LABEL":[6,18,60,14],"INSIDE_TEMP":[6,34,118,26],"INSIDE_HUMIDITY":[6,60,118,10],"INSIDE_PRESSURE":[6,70,118,10],"OUTSIDE_LABEL":[129,18,70,14],"OUT_TEMP":[129,36,94,28],"WEATHER_ICON":[168,90,30,32],"OUT_PRESSURE":[177,68,64,12],"OUT_HUMIDITY":[131,78,44,12],"OUT_WIND":[177,80,44,10],"FOOTER_BATTERY":[6,85,118,12],"FOOTER_IP":[6,107,120,14],"FOOTER_WEATHER":[168,90,76,32]},"iconMap":[{"match":["storm","thunder","lightning"],"icon":"weather-lightning"},{"match":["pour","rain","shower"],"icon":"weather-pouring"},{"match":["snow"],"icon":"weather-snowy"},{"match":["fog","mist","haze"],"icon":"weather-fog"},{"match":["part","partly","partly-cloudy"],"icon":"weather-partly-cloudy"},{"match":["cloud","overcast"],"icon":"weather-cloudy"},{"match":["night","clear-night"],"icon":"weather-night"},{"match":["wind"],"icon":"weather-windy-variant"},{"match":["hail"],"icon":"weather-snowy"},{"match":["exceptional"],"icon":"weather-cloudy"},{"match":["sunny","clear"],"icon":"weather-sunny"},{"default":true,"icon":"weather-sunny"}],"components":{"chrome":[{"op":"line","from":[0,0],"to":[249,0]},{"op":"line","from":[0,121],"to":[249,121]},{"op":"line","from":[0,0],"to":[0,121]},{"op":"line","from":[249,0],"to":[249,121]},{"op":"line","from":[125,14],"to":[125,121]},{"op":"line","from":[1,84],"to":[249,84]}],"header_centered":[{"op":"line","from":[1,14],"to":[249,14]},{"op":"text","rect":"HEADER_NAME","font":"label","align":"left","text":"{room_name}","truncate":"ellipsis"},{"op":"textCenteredIn","rect":"HEADER_TIME_CENTER","yOffset":1,"font":"time","text":"{time_hhmm}"},{"op":"text","rect":"HEADER_VERSION","font":"time","align":"right","text":"v{fw_version}"}],"header":[{"op":"line","from":[1,14],"to":[249,14]},{"op":"text","rect":"HEADER_NAME","font":"label","align":"left","text":"{room_name}","truncate":"ellipsis"},{"op":"timeRight","rect":"HEADER_VERSION","font":"time","source":"{time_hhmm}"}],"inside":[{"op":"text","rect":"INSIDE_LABEL","font":"label","align":"center","text":"INSIDE"},{"op":"tempGroupCentered","rect":"INSIDE_TEMP","value":"{inside_temp_f}"},{"op":"text","rect":"INSIDE_HUMIDITY","font":"small","align":"left","text":"{inside_hum_pct}% RH"},{"op":"text","rect":"INSIDE_PRESSURE","font":"small","align":"left","text":"{pressure_hpa:.1f} hPa","when":"has(pressure_hpa)"}],"outside":[{"op":"text","rect":"OUTSIDE_LABEL","font":"label","align":"center","text":"OUTSIDE"},{"op":"tempGroupCentered","rect":"OUT_TEMP","value":"{outside_temp_f}"},{"op":"iconIn","rect":"WEATHER_ICON","iconFromWeather":"{weather}"},{"op":"text","rect":"OUT_PRESSURE","font":"small","align":"left","y":3,"text":"{outside_pressure_hpa:.0f} hPa","when":"has(outside_pressure_hpa)"},{"op":"text","rect":"OUT_HUMIDITY","font":"small","align":"left","text":"{outside_hum_pct}% RH"},{"op":"text","rect":"OUT_WIND","font":"small","align":"left","text":"{wind_mps->mph:.1f} mph"}],"footer_split":[{"op":"batteryGlyph","rect":"FOOTER_BATTERY","percent":"{battery_percent}"},{"op":"text","rect":"FOOTER_BATTERY","font":"small","align":"right","text":"{battery_voltage:.2f}V {battery_percent}% ~{days}d"},{"op":"text","rect":"FOOTER_IP","font":"small","align":"center","text":"IP {ip}"},{"op":"textCenteredIn","rect":"FOOTER_WEATHER","yOffset":10,"font":"small","text":"{weather}"}]},"variants":{"v2":["chrome","header_centered","inside","outside","footer_split"]},"defaultVariant":"v2","regions":{"partial":{"INSIDE_LABEL":["text"],"INSIDE_TEMP":["tempGroupCentered"],"OUTSIDE_LABEL":["text"],"OUT_TEMP":["tempGroupCentered"],"WEATHER_ICON":["iconIn"],"OUT_PRESSURE":["text"],"OUT_HUMIDITY":["text"],"OUT_WIND":["text"],"HEADER_TIME_CENTER":["textCenteredIn"],"HEADER_VERSION":["text"],"FOOTER_BATTERY":["batteryGlyph","text"],"FOOTER_IP":["text"],"FOOTER_WEATHER":["textCenteredIn"]}}};
+window.UI_SPEC = {"schema":"ui-spec@1","layoutVersion":3,"canvas":{"w":250,"h":122},"fonts":{"tokens":{"big":{"px":22,"weight":"bold"},"label":{"px":11,"weight":"bold"},"small":{"px":10},"time":{"px":11}}},"rects":{"HEADER_NAME":[6,2,90,14],"HEADER_VERSION":[172,2,72,14],"HEADER_TIME_CENTER":[100,2,50,14],"INSIDE_LABEL":[6,18,60,14],"INSIDE_HILO":[66,20,58,12],"INSIDE_TEMP":[6,34,118,26],"INSIDE_HUMIDITY":[6,60,118,10],"INSIDE_PRESSURE":[6,70,118,10],"OUTSIDE_LABEL":[129,18,70,14],"OUT_TEMP":[129,36,94,28],"WEATHER_ICON":[168,90,30,32],"OUT_PRESSURE":[177,68,64,12],"OUT_HUMIDITY":[131,78,44,12],"OUT_WIND":[177,80,44,10],"FOOTER_BATTERY":[6,85,118,12],"FOOTER_IP":[6,107,120,14],"FOOTER_WEATHER":[168,90,76,32]},"iconMap":[{"match":["storm","thunder","lightning"],"icon":"weather-lightning"},{"match":["pour","rain","shower"],"icon":"weather-pouring"},{"match":["snow"],"icon":"weather-snowy"},{"match":["fog","mist","haze"],"icon":"weather-fog"},{"match":["part","partly","partly-cloudy"],"icon":"weather-partly-cloudy"},{"match":["cloud","overcast"],"icon":"weather-cloudy"},{"match":["night","clear-night"],"icon":"weather-night"},{"match":["wind"],"icon":"weather-windy-variant"},{"match":["hail"],"icon":"weather-snowy"},{"match":["exceptional"],"icon":"weather-cloudy"},{"match":["sunny","clear"],"icon":"weather-sunny"},{"default":true,"icon":"weather-sunny"}],"components":{"chrome":[{"op":"line","from":[0,0],"to":[249,0]},{"op":"line","from":[0,121],"to":[249,121]},{"op":"line","from":[0,0],"to":[0,121]},{"op":"line","from":[249,0],"to":[249,121]},{"op":"line","from":[125,14],"to":[125,121]},{"op":"line","from":[1,84],"to":[249,84]}],"header_centered":[{"op":"line","from":[1,14],"to":[249,14]},{"op":"text","rect":"HEADER_NAME","font":"label","align":"left","text":"{room_name}","truncate":"ellipsis"},{"op":"textCenteredIn","rect":"HEADER_TIME_CENTER","yOffset":1,"font":"time","text":"{time_hhmm}"},{"op":"text","rect":"HEADER_VERSION","font":"time","align":"right","text":"v{fw_version}"}],"header":[{"op":"line","from":[1,14],"to":[249,14]},{"op":"text","rect":"HEADER_NAME","font":"label","align":"left","text":"{room_name}","truncate":"ellipsis"},{"op":"timeRight","rect":"HEADER_VERSION","font":"time","source":"{time_hhmm}"}],"inside":[{"op":"text","rect":"INSIDE_LABEL","font":"label","align":"center","text":"INSIDE"},{"op":"text","rect":"INSIDE_HILO","font":"small","align":"right","text":"H{inside_hi_f:.0f} L{inside_lo_f:.0f}","when":"has(inside_hi_f)"},{"op":"tempGroupCentered","rect":"INSIDE_TEMP","value":"{inside_temp_f}"},{"op":"text","rect":"INSIDE_HUMIDITY","font":"small","align":"left","text":"{inside_hum_pct}% RH"},{"op":"text","rect":"INSIDE_PRESSURE","font":"small","align":"left","text":"{pressure_hpa:.1f} hPa","when":"has(pressure_hpa)"}],"outside":[{"op":"text","rect":"OUTSIDE_LABEL","font":"label","align":"center","text":"OUTSIDE"},{"op":"tempGroupCentered","rect":"OUT_TEMP","value":"{outside_temp_f}"},{"op":"iconIn","rect":"WEATHER_ICON","iconFromWeather":"{weather}"},{"op":"text","rect":"OUT_PRESSURE","font":"small","align":"left","y":3,"text":"{outside_pressure_hpa:.0f} hPa","when":"has(outside_pressure_hpa)"},{"op":"text","rect":"OUT_HUMIDITY","font":"small","align":"left","text":"{outside_hum_pct}% RH"},{"op":"text","rect":"OUT_WIND","font":"small","align":"left","text":"{wind_mps->mph:.1f} mph"}],"footer_split":[{"op":"batteryGlyph","rect":"FOOTER_BATTERY","percent":"{battery_percent}"},{"op":"text","rect":"FOOTER_BATTERY","font":"small","align":"right","text":"{battery_voltage:.2f}V {battery_percent}% ~{days}d"},{"op":"text","rect":"FOOTER_IP","font":"small","align":"center","text":"IP {ip}"},{"op":"textCenteredIn","rect":"FOOTER_WEATHER","yOffset":10,"font":"small","text":"{weather}"}],"inside_compact":[{"op":"text","rect":"INSIDE_LABEL","font":"label","align":"center","text":"INSIDE"},{"op":"tempGroupCentered","rect":"INSIDE_TEMP","value":"{inside_temp_f}"},{"op":"text","rect":"INSIDE_HUMIDITY","font":"small","align":"left","text":"{inside_hum_pct}% RH"}],"outside_compact":[{"op":"text","rect":"OUTSIDE_LABEL","font":"label","align":"center","text":"OUTSIDE"},{"op":"tempGroupCentered","rect":"OUT_TEMP","value":"{outside_temp_f}"},{"op":"iconIn","rect":"WEATHER_ICON","iconFromWeather":"{weather}"},{"op":"text","rect":"OUT_HUMIDITY","font":"small","align":"left","text":"{outside_hum_pct}% RH"}],"inside_large":[{"op":"text","rect":"INSIDE_LABEL","font":"label","align":"center","text":"INSIDE"},{"op":"tempGroupCentered","rect":"INSIDE_TEMP","value":"{inside_temp_f:.0f}","scale":3},{"op":"text","rect":"INSIDE_HUMIDITY","font":"small","align":"left","text":"{inside_hum_pct}% RH"}],"outside_large":[{"op":"text","rect":"OUTSIDE_LABEL","font":"label","align":"center","text":"OUTSIDE"},{"op":"tempGroupCentered","rect":"OUT_TEMP","value":"{outside_temp_f:.0f}","scale":3},{"op":"iconIn","rect":"WEATHER_ICON","iconFromWeather":"{weather}"}],"inside_minimal":[{"op":"text","rect":"INSIDE_LABEL","font":"label","align":"center","text":"INSIDE"},{"op":"tempGroupCentered","rect":"INSIDE_TEMP","value":"{inside_temp_f}"}],"outside_minimal":[{"op":"text","rect":"OUTSIDE_LABEL","font":"label","align":"center","text":"OUTSIDE"},{"op":"tempGroupCentered","rect":"OUT_TEMP","value":"{outside_temp_f}"}],"footer_battery":[{"op":"batteryGlyph","rect":"FOOTER_BATTERY","x":8,"y":87,"w":13,"h":7,"percent":"{battery_percent}"},{"op":"text","rect":"FOOTER_BATTERY","font":"small","align":"right","text":"{battery_percent}% LOW"}]},"frame":[{"op":"line","from":[0,0],"to":[249,0]},{"op":"line","from":[0,121],"to":[249,121]},{"op":"line","from":[0,0],"to":[0,121]},{"op":"line","from":[249,0],"to":[249,121]},{"op":"line","from":[1,18],"to":[248,18]},{"op":"line","from":[125,18],"to":[125,120]}],"variants":{"v2":["chrome","header_centered","inside","outside","footer_split"],"compact":["chrome","header","inside_compact","outside_compact","footer_split"],"large_digit":["chrome","header","inside_large","outside_large","footer_split"],"low_battery":["inside_minimal","outside_minimal","footer_battery"]},"defaultVariant":"v2","regions":{"partial":{"INSIDE_LABEL":["text"],"INSIDE_HILO":["text"],"INSIDE_TEMP":["tempGroupCentered"],"OUTSIDE_LABEL":["text"],"OUT_TEMP":["tempGroupCentered"],"WEATHER_ICON":["iconIn"],"OUT_PRESSURE":["text"],"OUT_HUMIDITY":["text"],"OUT_WIND":["text"],"HEADER_TIME_CENTER":["textCenteredIn"],"HEADER_VERSION":["text"],"FOOTER_BATTERY":["batteryGlyph","text"],"FOOTER_IP":["text"],"FOOTER_WEATHER":["textCenteredIn"]}}};
 window.UI_FW_VERSION = "1.03";
-window.UI_LAYOUT_VERSION = 1;
-window.UI_LAYOUT_CRC = "0xD601B413";
+window.UI_LAYOUT_VERSION = 3;
+window.UI_LAYOUT_CRC = "0x469141D8";
 (function(){ function _mapWeather(iconMap, weather){ var s=String(weather||'').toLowerCase(); if(!iconMap||!Array.isArray(iconMap)) return null; for(var i=0;i<iconMap.length;i++){ var rule=iconMap[i]; if(rule && Array.isArray(rule.match)){ for(var j=0;j<rule.match.length;j++){ var m=rule.match[j]; if(s.indexOf(String(m).toLowerCase())>=0) return rule.icon; } } else if(rule && rule.default){ return rule.icon; } } return null; } window.uiMapWeather = function(w){ var spec = window.UI_SPEC || {}; return _mapWeather(spec.iconMap, w); }; })();